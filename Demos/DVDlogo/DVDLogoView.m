@@ -11,6 +11,7 @@
 #import "ScreenSaverKit/SSKPreferenceBinder.h"
 #import "ScreenSaverKit/SSKParticleSystem.h"
 #import "ScreenSaverKit/SSKVectorMath.h"
+#import "ScreenSaverKit/Core/SSKReplay.h"
 
 #import "DVDLogoConfigurationBuilder.h"
 #import "DVDLogoPalettes.h"
@@ -85,6 +86,7 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
         _bounceParticlesEnabled = [defaults[DVDLogoPreferenceKeyBounceParticles] boolValue];
         _particleSystem = [[SSKParticleSystem alloc] initWithCapacity:256];
         _particleSystem.blendMode = SSKParticleBlendModeAdditive;
+        _particleSystem.emissionSeed = [self nextRandomSeed];
         [self loadLogoImage];
         [self resetInitialState];
         NSDictionary *prefs = [self currentPreferences];
@@ -94,6 +96,11 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
     return self;
 }
 
+- (void)reseedRandomWithSeed:(uint64_t)seed {
+    [super reseedRandomWithSeed:seed];
+    self.particleSystem.emissionSeed = [self nextRandomSeed];
+}
+
 - (void)setFrame:(NSRect)frame {
     [super setFrame:frame];
     [self clampPositionToBounds];
@@ -114,8 +121,8 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
     }
 
     if (self.randomStartPositionEnabled && safeBounds.size.width > 1.0 && safeBounds.size.height > 1.0) {
-        CGFloat randX = safeBounds.origin.x + ((CGFloat)arc4random() / UINT32_MAX) * safeBounds.size.width;
-        CGFloat randY = safeBounds.origin.y + ((CGFloat)arc4random() / UINT32_MAX) * safeBounds.size.height;
+        CGFloat randX = safeBounds.origin.x + [self randomUnit] * safeBounds.size.width;
+        CGFloat randY = safeBounds.origin.y + [self randomUnit] * safeBounds.size.height;
         self.position = NSMakePoint(randX, randY);
     } else {
         self.position = NSMakePoint(NSMidX(safeBounds), NSMidY(safeBounds));
@@ -123,7 +130,7 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
 
     CGFloat baseSpeed = 220.0;
     CGFloat angle = self.randomStartVelocityEnabled ?
-        (((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)M_PI * 2.0) :
+        ([self randomUnit] * (CGFloat)M_PI * 2.0) :
         (CGFloat)M_PI_4;
     self.velocity = NSMakePoint(cos(angle) * baseSpeed, sin(angle) * baseSpeed);
     self.colorPhase = 0.0;
@@ -165,7 +172,11 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
 }
 
 - (void)animateOneFrame {
-    NSTimeInterval dt = [self advanceAnimationClock];
+    [self stepSimulationWithDeltaTime:[self advanceAnimationClock]];
+    [self setNeedsDisplay:YES];
+}
+
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)dt {
     if (dt <= 0.0) {
         dt = 1.0 / 60.0;
     }
@@ -221,7 +232,11 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
 
     self.particleSystem.blendMode = (self.colorMode == DVDBrandColorModeSolid) ? SSKParticleBlendModeAlpha : SSKParticleBlendModeAdditive;
     [self.particleSystem advanceBy:dt];
-    [self setNeedsDisplay:YES];
+}
+
+- (uint64_t)simulationChecksum {
+    double state[5] = { self.position.x, self.position.y, self.velocity.x, self.velocity.y, self.colorPhase };
+    return [self.particleSystem stateChecksumWithHash:SSKReplayChecksum(0, state, sizeof state)];
 }
 
 - (void)drawRect:(NSRect)dirtyRect {
@@ -271,21 +286,18 @@ typedef NS_ENUM(NSUInteger, DVDBrandColorMode) {
 
 - (void)emitBounceParticlesAtPosition:(NSPoint)position {
     if (!self.particleSystem || !self.bounceParticlesEnabled) { return; }
-    NSColor *baseColor = [self currentTintColor];
-    NSUInteger count = 36;
-    SSKParticleSystem *system = self.particleSystem;
-    [system spawnParticles:count initializer:^(SSKParticle *particle) {
-        particle.position = position;
-        particle.maxLife = 0.35 + ((CGFloat)arc4random() / UINT32_MAX) * 0.2;
-        CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)(M_PI * 2.0);
-        CGFloat speed = 90.0 + ((CGFloat)arc4random() / UINT32_MAX) * 140.0;
-        particle.velocity = NSMakePoint(cos(angle) * speed, sin(angle) * speed);
-        particle.size = 3.0 + ((CGFloat)arc4random() / UINT32_MAX) * 4.0;
-        particle.sizeVelocity = 20.0;
-        particle.color = baseColor;
-        particle.damping = 0.45;
-        particle.rotationVelocity = (((CGFloat)arc4random() / UINT32_MAX) - 0.5f) * 3.0f;
-    }];
+    vector_float4 baseColor = SSKParticleColorVector([self currentTintColor]);
+    SSKParticleEmission burst = SSKParticleEmissionMake(position);
+    burst.maxLife = SSKScalarRangeMake(0.35, 0.55);
+    burst.angle = SSKScalarRangeMake(0.0, M_PI * 2.0);
+    burst.speed = SSKScalarRangeMake(90.0, 230.0);
+    burst.size = SSKScalarRangeMake(3.0, 7.0);
+    burst.sizeVelocity = SSKScalarRangeMake(20.0, 20.0);
+    burst.colorStart = baseColor;
+    burst.colorEnd = baseColor;
+    burst.damping = 0.45;
+    burst.rotationVelocity = SSKScalarRangeMake(-1.5, 1.5);
+    [self.particleSystem emitParticles:36 emission:burst];
 }
 
 - (NSColor *)currentTintColor {
@@ -9,10 +9,7 @@
 #import "ScreenSaverKit/SSKParticleSystem.h"
 #import "ScreenSaverKit/SSKMetalParticleRenderer.h"
 #import "ScreenSaverKit/SSKMetalRenderDiagnostics.h"
-
-static inline CGFloat SSKRandomUnit(void) {
-    return (CGFloat)arc4random() / (CGFloat)UINT32_MAX;
-}
+#import "ScreenSaverKit/Core/SSKReplay.h"
 
 static const NSUInteger kMetalParticleTestBuildNumber = 4;
 
@@ -46,12 +43,17 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
         _particleSystem.blendMode = SSKParticleBlendModeAdditive;
         _particleSystem.globalDamping = 0.92;
         _particleSystem.gravity = NSZeroPoint;
+        _particleSystem.emissionSeed = [self nextRandomSeed];
+        // Simulate at a fixed 60 Hz whatever the display does, so the particle
+        // count and motion look the same on a 120 Hz panel or in a hitchy preview.
+        self.animationClock.fixedTimestepEnabled = YES;
 
         _renderDiagnostics = [[SSKMetalRenderDiagnostics alloc] init];
         _renderDiagnostics.deviceStatus = @"Device: not requested";
         _renderDiagnostics.layerStatus = @"Layer: waiting for device";
         _renderDiagnostics.rendererStatus = @"Renderer: waiting for layer";
         _renderDiagnostics.drawableStatus = @"Drawable: not attempted";
+        _renderDiagnostics.profilingEnabled = YES;
         _cachedOverlayString = @"Metal Particle Test – awaiting status…";
 
         [SSKDiagnostics setEnabled:YES];
@@ -59,6 +61,11 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
     return self;
 }
 
+- (void)reseedRandomWithSeed:(uint64_t)seed {
+    [super reseedRandomWithSeed:seed];
+    self.particleSystem.emissionSeed = [self nextRandomSeed];
+}
+
 - (BOOL)isOpaque {
     return YES;
 }
@@ -91,13 +98,10 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
     [self ensureMetalRenderer];
     [self updateMetalGeometry];
 
-    NSTimeInterval dt = [self advanceAnimationClock];
-    if (dt <= 0.0) {
-        dt = 1.0 / 60.0;
-    }
-
-    [self spawnParticlesForDelta:dt];
-    [self.particleSystem advanceBy:dt];
+    [self advanceAnimationClock];
+    [self.animationClock runPendingStepsUsingBlock:^(NSTimeInterval dt) {
+        [self stepSimulationWithDeltaTime:dt];
+    }];
 
     BOOL attemptedMetalRender = NO;
     BOOL renderedWithMetal = NO;
@@ -290,6 +294,7 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
         return;
     }
 
+    renderer.diagnostics = self.renderDiagnostics;
     self.metalRenderer = renderer;
     self.renderDiagnostics.rendererStatus = @"Renderer: initialised";
 }
@@ -338,6 +343,17 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
 
 #pragma mark - Particles
 
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)dt {
+    SSK_PROFILE_SCOPE(self.renderDiagnostics.profiler, "simulation");
+    [self spawnParticlesForDelta:dt];
+    [self.particleSystem advanceBy:dt];
+}
+
+- (uint64_t)simulationChecksum {
+    double accumulator = self.spawnAccumulator;
+    return [self.particleSystem stateChecksumWithHash:SSKReplayChecksum(0, &accumulator, sizeof accumulator)];
+}
+
 - (void)spawnParticlesForDelta:(NSTimeInterval)dt {
     if (NSIsEmptyRect(self.bounds)) {
         return;
@@ -355,28 +371,28 @@ static const NSUInteger kMetalParticleTestBuildNumber = 4;
     CGFloat maxRadius = MIN(NSWidth(self.bounds), NSHeight(self.bounds)) * 0.5;
 
     [self.particleSystem spawnParticles:spawnCount initializer:^(SSKParticle *particle) {
-        CGFloat angle = SSKRandomUnit() * (CGFloat)M_PI * 2.0;
-        CGFloat speed = 80.0 + SSKRandomUnit() * 160.0;
+        CGFloat angle = [self randomUnit] * (CGFloat)M_PI * 2.0;
+        CGFloat speed = 80.0 + [self randomUnit] * 160.0;
         CGFloat radius = maxRadius * 0.12f;
-        CGFloat offsetAngle = angle + ((SSKRandomUnit() - 0.5f) * 0.45f);
+        CGFloat offsetAngle = angle + (([self randomUnit] - 0.5f) * 0.45f);
         particle.position = NSMakePoint(centre.x + cos(offsetAngle) * radius,
                                         centre.y + sin(offsetAngle) * radius);
         particle.velocity = NSMakePoint(cos(angle) * speed,
                                         sin(angle) * speed);
 
-        CGFloat hue = SSKRandomUnit();
+        CGFloat hue = [self randomUnit];
         particle.color = [NSColor colorWithCalibratedHue:hue
                                                saturation:0.75
                                                brightness:1.0
                                                     alpha:1.0];
-        particle.maxLife = 1.4 + SSKRandomUnit() * 0.8;
+        particle.maxLife = 1.4 + [self randomUnit] * 0.8;
         particle.life = 0.0;
-        particle.size = 8.0 + SSKRandomUnit() * 12.0;
+        particle.size = 8.0 + [self randomUnit] * 12.0;
         particle.baseSize = particle.size;
         particle.behaviorOptions = SSKParticleBehaviorOptionFadeAlpha | SSKParticleBehaviorOptionFadeSize;
         particle.sizeOverLifeRange = SSKScalarRangeMake(1.0, 0.1);
         particle.damping = 0.88;
-        particle.rotationVelocity = (SSKRandomUnit() - 0.5) * 2.0;
+        particle.rotationVelocity = ([self randomUnit] - 0.5) * 2.0;
     }];
 }
 
@@ -14,9 +14,10 @@
 #import "ScreenSaverKit/SSKLayerEffects.h"
 #import "ScreenSaverKit/SSKMetalRenderDiagnostics.h"
 #import "ScreenSaverKit/SSKPaletteManager.h"
-#import "ScreenSaverKit/SSKParticleSystem.h"
 #import "ScreenSaverKit/SSKPreferenceBinder.h"
 #import "ScreenSaverKit/SSKVectorMath.h"
+#import "ScreenSaverKit/Core/SSKReplay.h"
+#import "ScreenSaverKit/Core/SSKTrail.h"
 
 static NSString * const kPrefEmitterCount    = @"ribbonFlowEmitterCount";
 static NSString * const kPrefSpeed           = @"ribbonFlowSpeed";
@@ -31,6 +32,9 @@ static NSString * const kPrefBlurRadius      = @"ribbonFlowBlurRadius";
 static NSString * const kPrefBloomIntensity  = @"ribbonFlowBloomIntensity";
 static NSString * const kPrefBloomThreshold  = @"ribbonFlowBloomThreshold";
 
+/// Seconds of emitter history each ribbon shows.
+static const CGFloat kRibbonFlowTrailDuration = 1.4;
+
 typedef struct {
     NSPoint position;
     NSPoint velocity;
@@ -39,9 +43,25 @@ typedef struct {
     CGFloat intrinsicSpeed;
 } RibbonFlowEmitter;
 
+/// Caps the HSB brightness of a straight sRGB colour and lifts its
+/// saturation to at least `minSaturation`, keeping the hue. Greys stay grey.
+static SSKFloat4 RibbonFlowGradeColor(SSKFloat4 color, float maxBrightness, float minSaturation) {
+    float value = fmaxf(color.x, fmaxf(color.y, color.z));
+    if (value <= 0.0f) { return color; }
+    float saturation = (value - fminf(color.x, fminf(color.y, color.z))) / value;
+    // Each channel sits `value * saturation * k` below the brightest, with `k`
+    // fixed by the hue, so scaling that gap changes the saturation alone.
+    float gap = saturation > 0.0f ? fminf(fmaxf(saturation, minSaturation), 1.0f) / saturation : 1.0f;
+    float scale = fminf(value, maxBrightness) / value;
+    return SSKFloat4Make((value - (value - color.x) * gap) * scale,
+                         (value - (value - color.y) * gap) * scale,
+                         (value - (value - color.z) * gap) * scale,
+                         color.w);
+}
+
 @interface RibbonFlowView ()
 @property (nonatomic, strong) SSKConfigurationWindowController *configController;
-@property (nonatomic, strong) SSKParticleSystem *particleSystem;
+@property (nonatomic, assign) SSKTrailSet *ribbons;
 @property (nonatomic, strong) NSMutableArray<NSValue *> *emitters;
 @property (nonatomic) NSUInteger emitterCount;
 @property (nonatomic) CGFloat speedMultiplier;
@@ -59,11 +79,16 @@ typedef struct {
 @property (nonatomic) CGFloat blurRadius;
 @property (nonatomic) CGFloat bloomIntensity;
 @property (nonatomic) CGFloat bloomThreshold;
+@property (nonatomic, strong) NSMutableData *rasterVertices;
+@property (nonatomic, strong) NSMutableData *rasterIndices;
+@property (nonatomic, assign) CGContextRef rasterContext;
 @end
 
 @implementation RibbonFlowView
 
 - (void)dealloc {
+    SSKTrailSetDestroy(_ribbons);
+    CGContextRelease(_rasterContext);
     [SSKDiagnostics setEnabled:YES];
 }
 
@@ -90,8 +115,6 @@ typedef struct {
         self.animationTimeInterval = 1.0 / 30.0;
         RibbonFlowRegisterPalettes();
         _emitters = [NSMutableArray array];
-        _particleSystem = [[SSKParticleSystem alloc] initWithCapacity:2048];
-        self.particleSystem.metalSimulationEnabled = NO;
         self.metalRenderingActive = NO;
         self.diagnosticsEnabled = YES;
         self.softEdgesEnabled = YES;
@@ -109,8 +132,6 @@ typedef struct {
         self.metalStatusText = @"Metal: initialising";
         _cachedOverlayString = @"Ribbon Flow Demo – diagnostics pending";
 
-        [self configureParticleRenderHandler];
-
         NSDictionary *prefs = [self currentPreferences];
         NSSet *keys = [NSSet setWithArray:prefs.allKeys];
         [self applyPreferences:prefs changedKeys:keys];
@@ -123,6 +144,7 @@ typedef struct {
     [super setupMetalRenderer:renderer];
     renderer.clearColor = MTLClearColorMake(0.0, 0.0, 0.0, 1.0);
     renderer.bloomThreshold = self.bloomThreshold;
+    renderer.diagnostics = self.renderDiagnostics;
     [self.renderDiagnostics attachToMetalLayer:self.metalLayer];
     id<MTLDevice> device = renderer.device;
     if (device) {
@@ -161,7 +183,6 @@ typedef struct {
 - (void)setSoftEdgesEnabled:(BOOL)softEdgesEnabled {
     if (_softEdgesEnabled == softEdgesEnabled) { return; }
     _softEdgesEnabled = softEdgesEnabled;
-    [self configureParticleRenderHandler];
     [self setNeedsDisplay:YES];
 }
 
@@ -232,10 +253,32 @@ typedef struct {
         emitter.position = [self randomPointInRect:bounds];
         emitter.velocity = NSZeroPoint;
         emitter.target = [self randomPointInRect:bounds];
-        emitter.colorPhase = (CGFloat)arc4random() / (CGFloat)UINT32_MAX;
-        emitter.intrinsicSpeed = 0.6 + ((CGFloat)arc4random() / UINT32_MAX) * 0.9;
+        emitter.colorPhase = [self randomUnit];
+        emitter.intrinsicSpeed = 0.6 + [self randomUnit] * 0.9;
         [self.emitters addObject:[NSValue valueWithBytes:&emitter objCType:@encode(RibbonFlowEmitter)]];
     }
+    [self rebuildRibbons];
+}
+
+/// One ribbon per emitter, holding `kRibbonFlowTrailDuration` of positions
+/// sampled once a frame.
+- (void)rebuildRibbons {
+    SSKTrailSetDestroy(self.ribbons);
+    self.ribbons = NULL;
+    if (self.emitterCount == 0) { return; }
+    uint32_t capacity = (uint32_t)ceil(kRibbonFlowTrailDuration * MAX(self.targetFramesPerSecond, 1)) + 1;
+    self.ribbons = SSKTrailSetCreate((uint32_t)self.emitterCount, MAX(capacity, 2u));
+    if (!self.ribbons && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"RibbonFlowView: could not allocate %lu ribbons.", (unsigned long)self.emitterCount];
+    }
+}
+
+/// Mesh parameters shared by every ribbon: soft edges fade across most of
+/// the ribbon's width.
+- (SSKTrailMeshParams)ribbonMeshParams {
+    SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+    params.softness = self.softEdgesEnabled ? (float)(self.trailWidth * 5.5) : 0.0f;
+    return params;
 }
 
 - (void)clampEmittersToBounds {
@@ -250,20 +293,35 @@ typedef struct {
 }
 
 - (void)stepSimulationWithDeltaTime:(NSTimeInterval)dt {
+    SSK_PROFILE_SCOPE(self.renderDiagnostics.profiler, "simulation");
     NSTimeInterval clamped = (dt <= 0.0) ? (1.0 / MAX(self.targetFramesPerSecond, 1)) : dt;
     [self updateEmittersWithDelta:clamped];
-    self.particleSystem.blendMode = self.additiveBlend ? SSKParticleBlendModeAdditive : SSKParticleBlendModeAlpha;
-    [self.particleSystem advanceBy:clamped];
+}
+
+- (uint64_t)simulationChecksum {
+    uint64_t hash = 0;
+    for (NSValue *value in self.emitters) {
+        RibbonFlowEmitter emitter;
+        [value getValue:&emitter];
+        hash = SSKReplayChecksum(hash, &emitter, sizeof emitter);
+    }
+    return hash;
 }
 
 - (void)renderMetalFrame:(SSKMetalRenderer *)renderer deltaTime:(NSTimeInterval)dt {
     [self stepSimulationWithDeltaTime:dt];
 
     renderer.clearColor = MTLClearColorMake(0.0, 0.0, 0.0, 1.0);
-    NSArray<SSKParticle *> *particles = [self.particleSystem aliveParticlesSnapshot];
-    [renderer drawParticles:particles
-                  blendMode:self.particleSystem.blendMode
-               viewportSize:self.bounds.size];
+    if (self.ribbons) {
+        // Every ribbon goes out in one indexed draw.
+        SSKTrailMeshParams params = [self ribbonMeshParams];
+        [renderer drawTrails:self.ribbons
+                      params:&params
+                   blendMode:self.additiveBlend ? SSKParticleBlendModeAdditive : SSKParticleBlendModeAlpha
+                viewportSize:self.bounds.size];
+    } else {
+        [renderer clearWithColor:renderer.clearColor];
+    }
 
     CGFloat blurRadius = self.blurRadius;
     if (blurRadius > 0.01) {
@@ -329,10 +387,12 @@ typedef struct {
     if (!self.renderDiagnostics) { return; }
     if (!self.diagnosticsEnabled) {
         self.renderDiagnostics.overlayEnabled = NO;
+        self.renderDiagnostics.profilingEnabled = NO;
         self.cachedOverlayString = nil;
         return;
     }
     self.renderDiagnostics.overlayEnabled = YES;
+    self.renderDiagnostics.profilingEnabled = YES;
     if (self.metalLayer) {
         [self.renderDiagnostics attachToMetalLayer:self.metalLayer];
         CGSize drawableSize = self.metalLayer.drawableSize;
@@ -347,11 +407,15 @@ typedef struct {
         self.renderDiagnostics.layerStatus = @"Layer: fallback CALayer";
     }
     NSString *statusLine = self.metalStatusText.length ? self.metalStatusText : @"Metal: inactive";
-    NSString *particlesLine = [NSString stringWithFormat:@"Alive: %lu | Target FPS: %ld | Blend: %@",
-                               (unsigned long)self.particleSystem.aliveParticleCount,
-                               (long)self.targetFramesPerSecond,
-                               self.additiveBlend ? @"Additive" : @"Alpha"];
-    NSArray<NSString *> *extraLines = @[statusLine, particlesLine];
+    NSUInteger points = 0;
+    for (uint32_t i = 0; self.ribbons && i < self.ribbons->trailCount; i++) {
+        points += self.ribbons->length[i];
+    }
+    NSString *ribbonsLine = [NSString stringWithFormat:@"Ribbon points: %lu | Target FPS: %ld | Blend: %@",
+                             (unsigned long)points,
+                             (long)self.targetFramesPerSecond,
+                             self.additiveBlend ? @"Additive" : @"Alpha"];
+    NSArray<NSString *> *extraLines = @[statusLine, ribbonsLine];
     double fps = self.animationClock.framesPerSecond;
     NSString *title = @"Ribbon Flow Demo";
     self.cachedOverlayString = [self.renderDiagnostics overlayStringWithTitle:title
@@ -373,7 +437,7 @@ typedef struct {
     [[NSColor blackColor] setFill];
     NSRectFill(dirtyRect);
 
-    [self.particleSystem drawInContext:ctx];
+    [self rasterizeRibbonsInContext:ctx];
 
     if (self.diagnosticsEnabled && self.cachedOverlayString.length > 0) {
         NSArray<NSString *> *lines = [self.cachedOverlayString componentsSeparatedByString:@"\n"];
@@ -408,13 +472,8 @@ typedef struct {
 - (void)updateEmittersWithDelta:(NSTimeInterval)dt {
     if (self.emitters.count == 0) { return; }
     RibbonFlowRegisterPalettes();
-    SSKPaletteManager *manager = [SSKPaletteManager sharedManager];
-    NSString *module = RibbonFlowPaletteModuleIdentifier();
-    SSKColorPalette *palette = [manager paletteWithIdentifier:self.paletteIdentifier module:module];
-    if (!palette) {
-        NSString *fallback = RibbonFlowDefaultPaletteIdentifier();
-        palette = [manager paletteWithIdentifier:fallback module:module];
-    }
+    const SSKPaletteLUT *palette = [[self currentPalette] lookupTableForWrap:SSKPaletteWrapLoop
+                                                                    encoding:SSKPaletteEncodingSRGB];
 
     NSRect bounds = NSInsetRect(self.bounds, 40.0, 40.0);
     if (bounds.size.width <= 0 || bounds.size.height <= 0) {
@@ -455,151 +514,51 @@ typedef struct {
             emitter.target = [self randomPointInRect:bounds];
         }
 
-        [self emitParticlesForEmitter:&emitter palette:palette manager:manager module:module];
+        [self recordRibbon:(uint32_t)i forEmitter:&emitter palette:palette];
 
         self.emitters[i] = [NSValue valueWithBytes:&emitter objCType:@encode(RibbonFlowEmitter)];
     }
 }
 
-- (void)emitParticlesForEmitter:(RibbonFlowEmitter *)emitter
-                        palette:(SSKColorPalette *)palette
-                        manager:(SSKPaletteManager *)manager
-                         module:(NSString *)module {
-    if (!emitter) { return; }
-
-    NSUInteger spawnCount = 2;
-    NSPoint dir = emitter->velocity;
-    if (SSKVectorLength(dir) < 0.001) {
-        dir = [self randomUnitVector];
-    }
-    NSPoint unitDir = SSKVectorNormalize(dir);
-    CGFloat baseSpeed = SSKVectorLength(dir);
+/// Samples the emitter into its ribbon and restyles the ribbon from the
+/// palette: full width and opacity at the emitter, narrowing and fading out
+/// towards the oldest point.
+- (void)recordRibbon:(uint32_t)index
+          forEmitter:(RibbonFlowEmitter *)emitter
+             palette:(const SSKPaletteLUT *)palette {
+    SSKTrailSet *ribbons = self.ribbons;
+    if (!emitter || !ribbons || index >= ribbons->trailCount) { return; }
 
-    [self.particleSystem spawnParticles:spawnCount initializer:^(SSKParticle *particle) {
-        CGFloat variation = ((CGFloat)arc4random() / UINT32_MAX) * 0.06;
-        CGFloat progress = emitter->colorPhase + variation;
-    NSColor *paletteColor = palette ?
-        [manager colorForPalette:palette progress:progress interpolationMode:SSKPaletteInterpolationModeLoop] :
-        [NSColor whiteColor];
+    // Ribbons are stored y-down, as the Metal pass draws them.
+    CGFloat height = NSHeight(self.bounds);
+    SSKTrailSetPush(ribbons, index, SSKFloat2Make((float)emitter->position.x,
+                                                  (float)(height - emitter->position.y)));
 
-    NSColor *srgb = [paletteColor colorUsingColorSpace:[NSColorSpace sRGBColorSpace]] ?: paletteColor;
-    CGFloat hue = 0.0;
-    CGFloat saturation = 0.0;
-    CGFloat brightness = 0.0;
-    CGFloat alpha = 1.0;
-    if ([srgb colorSpace].colorSpaceModel == NSColorSpaceModelRGB) {
-        [srgb getHue:&hue saturation:&saturation brightness:&brightness alpha:&alpha];
-        // Reduce brightness more when additive to prevent bloom blowout
-        brightness = self.additiveBlend ? MIN(brightness, 0.65) : MIN(brightness, 0.82);
-        saturation = MIN(MAX(saturation, 0.45), 1.0);
-        srgb = [NSColor colorWithHue:hue saturation:saturation brightness:brightness alpha:1.0];
-    }
+    SSKFloat4 paletteColor = palette ? SSKPaletteLUTSample(palette, (float)emitter->colorPhase) :
+                                       SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+    // Reduce brightness more when additive to prevent bloom blowout
+    SSKFloat4 head = RibbonFlowGradeColor(paletteColor, self.additiveBlend ? 0.65f : 0.82f, 0.45f);
 
     CGFloat alphaScale = self.additiveBlend ? 0.4 : 1.0;
     CGFloat baseAlpha = MIN(1.0, MAX(0.02, self.trailOpacity) * alphaScale);
-    NSColor *color = [srgb colorWithAlphaComponent:baseAlpha];
-
-    particle.position = emitter->position;
-        particle.velocity = SSKVectorScale(unitDir, baseSpeed * 0.35);
-        particle.maxLife = 1.15 + ((CGFloat)arc4random() / UINT32_MAX) * 0.45;
-        particle.life = 0.0;
-        particle.color = color;
-        CGFloat sizeBase = self.trailWidth * (7.5 + ((CGFloat)arc4random() / UINT32_MAX) * 3.5);
-        particle.size = sizeBase;
-        particle.baseSize = sizeBase;
-        particle.userScalar = self.softEdgesEnabled ? 6.0 : 0.0;
-        particle.userVector = unitDir;
-        particle.sizeOverLifeRange = SSKScalarRangeMake(1.0, 0.35);
-        particle.behaviorOptions = (SSKParticleBehaviorOptionFadeAlpha | SSKParticleBehaviorOptionFadeSize);
-    }];
+    head.w = (float)baseAlpha;
+    SSKFloat4 tail = head;
+    tail.w = 0.0f;
+    float width = (float)(self.trailWidth * 9.25);
+    ribbons->styles[index] = (SSKTrailStyle){width, width * 0.35f, head, tail};
 }
 
 - (NSPoint)randomPointInRect:(NSRect)rect {
-    CGFloat x = rect.origin.x + ((CGFloat)arc4random() / UINT32_MAX) * rect.size.width;
-    CGFloat y = rect.origin.y + ((CGFloat)arc4random() / UINT32_MAX) * rect.size.height;
+    CGFloat x = rect.origin.x + [self randomUnit] * rect.size.width;
+    CGFloat y = rect.origin.y + [self randomUnit] * rect.size.height;
     return NSMakePoint(x, y);
 }
 
 - (NSPoint)randomUnitVector {
-    CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)(M_PI * 2.0);
+    CGFloat angle = [self randomUnit] * (CGFloat)(M_PI * 2.0);
     return NSMakePoint(cos(angle), sin(angle));
 }
 
-- (void)configureParticleRenderHandler {
-    __weak typeof(self) weakSelf = self;
-    self.particleSystem.renderHandler = ^(CGContextRef ctx, SSKParticle *particle) {
-        CGFloat t = particle.life / MAX(0.0001, particle.maxLife);
-        CGFloat fade = 1.0 - t;
-        CGFloat width = MAX(1.0, particle.size);
-        CGFloat length = width * (2.4 + 6.0 * fade);
-        NSPoint dir = particle.userVector;
-        if (SSKVectorLength(dir) < 0.0001) {
-            dir = [weakSelf randomUnitVector];
-        }
-        CGFloat angle = atan2(dir.y, dir.x);
-
-        NSColor *color = particle.color ?: [NSColor whiteColor];
-        CGFloat alpha = color.alphaComponent * fade;
-        NSColor *core = [color colorWithAlphaComponent:alpha];
-
-        if (weakSelf.softEdgesEnabled) {
-            CGContextSaveGState(ctx);
-            CGContextSetBlendMode(ctx, weakSelf.additiveBlend ? kCGBlendModePlusLighter : kCGBlendModeNormal);
-            NSColor *startColor = [core colorUsingColorSpace:[NSColorSpace deviceRGBColorSpace]] ?: core;
-            CGFloat startComponents[4] = {startColor.redComponent, startColor.greenComponent, startColor.blueComponent, startColor.alphaComponent};
-            CGFloat midComponents[4] = {startComponents[0], startComponents[1], startComponents[2], startComponents[3] * 0.45f};
-            CGFloat endComponents[4] = {startComponents[0], startComponents[1], startComponents[2], 0.0f};
-            CGFloat components[12] = {
-                startComponents[0], startComponents[1], startComponents[2], startComponents[3],
-                midComponents[0], midComponents[1], midComponents[2], midComponents[3],
-                endComponents[0], endComponents[1], endComponents[2], endComponents[3]
-            };
-            CGFloat locations[3] = {0.0, 0.55, 1.0};
-            CGColorSpaceRef space = CGColorSpaceCreateDeviceRGB();
-            if (space) {
-                CGGradientRef gradient = CGGradientCreateWithColorComponents(space, components, locations, 3);
-                if (gradient) {
-                    CGContextTranslateCTM(ctx, particle.position.x, particle.position.y);
-                    CGContextRotateCTM(ctx, angle);
-                    CGContextScaleCTM(ctx, length * 0.5, width * 0.5);
-                    CGContextDrawRadialGradient(ctx,
-                                                gradient,
-                                                CGPointZero,
-                                                0.0,
-                                                CGPointZero,
-                                                1.0,
-                                                kCGGradientDrawsAfterEndLocation);
-                    CGGradientRelease(gradient);
-                }
-                CGColorSpaceRelease(space);
-            }
-            CGContextRestoreGState(ctx);
-            return;
-        }
-
-        CGColorRef glow = CGColorCreateCopyWithAlpha(core.CGColor, alpha * 0.75);
-        CGContextSaveGState(ctx);
-        CGContextSetBlendMode(ctx, weakSelf.additiveBlend ? kCGBlendModePlusLighter : kCGBlendModeNormal);
-        CGContextTranslateCTM(ctx, particle.position.x, particle.position.y);
-        CGContextRotateCTM(ctx, angle);
-        if (glow) {
-            CGContextSetShadowWithColor(ctx, CGSizeZero, width * 0.9, glow);
-        }
-        CGRect rect = CGRectMake(-length * 0.5, -width * 0.5, length, width);
-        CGMutablePathRef path = CGPathCreateMutable();
-        CGPathAddRoundedRect(path, NULL, rect, width * 0.5, width * 0.5);
-        CGContextAddPath(ctx, path);
-        CGContextSetFillColorWithColor(ctx, core.CGColor);
-        CGContextFillPath(ctx);
-        CGPathRelease(path);
-        if (glow) {
-            CGContextSetShadowWithColor(ctx, CGSizeZero, 0.0, NULL);
-            CGColorRelease(glow);
-        }
-        CGContextRestoreGState(ctx);
-    };
-}
-
 - (void)ensureFallbackLayer {
     if (self.metalLayer) { return; }
     if (!self.layer) {
@@ -620,16 +579,89 @@ typedef struct {
 }
 
 - (void)updateLayerBlurFilter {
-    CGFloat radius = MAX(0.0, self.blurRadius);
+    // Metal blurs in its post-processing stage and the CPU path blurs the
+    // ribbon bitmap in drawRect:, so neither layer needs a filter.
     if (self.metalLayer) {
         [SSKLayerEffects applyGaussianBlurWithRadius:0.0 toLayer:self.metalLayer];
     }
     if (self.layer && self.layer != self.metalLayer) {
-        [SSKLayerEffects applyGaussianBlurWithRadius:radius toLayer:self.layer];
+        [SSKLayerEffects applyGaussianBlurWithRadius:0.0 toLayer:self.layer];
     }
 }
 
-// Placeholder methods removed - blur handled via layer filters now.
+/// CPU fallback: rasterises the same ribbon mesh the Metal path draws into
+/// a backing-scale bitmap, blurs it with the same kernel when a blur is set,
+/// and composites the result.
+- (void)rasterizeRibbonsInContext:(CGContextRef)ctx {
+    SSKTrailSet *ribbons = self.ribbons;
+    if (!ribbons) { return; }
+    NSRect bounds = self.bounds;
+    CGFloat scale = self.window ? self.window.backingScaleFactor : 1.0;
+    size_t width = (size_t)ceil(NSWidth(bounds) * scale);
+    size_t height = (size_t)ceil(NSHeight(bounds) * scale);
+    if (width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX) { return; }
+
+    // Mesh buffers only grow; the bitmap is rebuilt when the pixel size changes.
+    uint32_t maxVertices = SSKTrailSetMaxVertexCount(ribbons);
+    uint32_t maxIndices = SSKTrailSetMaxIndexCount(ribbons);
+    NSUInteger vertexLength = (NSUInteger)maxVertices * sizeof(SSKTrailVertex);
+    NSUInteger indexLength = (NSUInteger)maxIndices * sizeof(uint32_t);
+    if (!self.rasterVertices) {
+        self.rasterVertices = [NSMutableData dataWithLength:vertexLength];
+    } else if (self.rasterVertices.length < vertexLength) {
+        self.rasterVertices.length = vertexLength;
+    }
+    if (!self.rasterIndices) {
+        self.rasterIndices = [NSMutableData dataWithLength:indexLength];
+    } else if (self.rasterIndices.length < indexLength) {
+        self.rasterIndices.length = indexLength;
+    }
+    SSKTrailVertex *vertices = self.rasterVertices.mutableBytes;
+    uint32_t *indices = self.rasterIndices.mutableBytes;
+    SSKTrailMeshParams meshParams = [self ribbonMeshParams];
+    SSKTrailMeshCounts counts = SSKTrailSetTessellate(ribbons, &meshParams, vertices, maxVertices,
+                                                      indices, maxIndices);
+    if (counts.indexCount == 0) { return; }
+
+    CGContextRef bitmap = self.rasterContext;
+    if (!bitmap || CGBitmapContextGetWidth(bitmap) != width || CGBitmapContextGetHeight(bitmap) != height) {
+        CGContextRelease(bitmap);
+        self.rasterContext = NULL;
+        CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+        bitmap = colorSpace
+            ? CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace, kCGImageAlphaPremultipliedLast)
+            : NULL;
+        CGColorSpaceRelease(colorSpace);
+        if (!bitmap) { return; }
+        self.rasterContext = bitmap;
+    }
+
+    // Row 0 of the bitmap is its top edge, matching the y-down ribbons.
+    SSKRasterTarget target = {
+        CGBitmapContextGetData(bitmap), (uint32_t)width, (uint32_t)height,
+        CGBitmapContextGetBytesPerRow(bitmap), SSKRasterFormatRGBA8,
+    };
+    SSKParticleRasterParams params = {
+        SSKFloat2Make((float)NSMinX(bounds), 0.0f),
+        SSKFloat2Make((float)NSWidth(bounds), (float)NSHeight(bounds)),
+        self.additiveBlend ? SSKRasterBlendAdditive : SSKRasterBlendAlpha,
+    };
+    if (target.pixels) {
+        SSKRasterTargetClear(&target, (SSKFloat4){0.0f, 0.0f, 0.0f, 0.0f});
+        SSKTrailRasterize(&target, &params, &meshParams, vertices, indices, counts.indexCount);
+    }
+    if (self.blurRadius > 0.01) {
+        [SSKLayerEffects applyGaussianBlurWithRadius:self.blurRadius * scale toBitmapContext:bitmap];
+    }
+    CGImageRef image = CGBitmapContextCreateImage(bitmap);
+    if (image) {
+        CGContextSaveGState(ctx);
+        CGContextSetBlendMode(ctx, self.additiveBlend ? kCGBlendModePlusLighter : kCGBlendModeNormal);
+        CGContextDrawImage(ctx, bounds, image);
+        CGContextRestoreGState(ctx);
+        CGImageRelease(image);
+    }
+}
 
 - (BOOL)hasConfigureSheet {
     return YES;
@@ -860,7 +892,6 @@ typedef struct {
         [preferences[kPrefAdditiveBlend] boolValue] :
         [defaults[kPrefAdditiveBlend] boolValue];
     self.additiveBlend = additive;
-    self.particleSystem.globalDamping = additive ? 0.18 : 0.15;
 
     BOOL diagnostics = [preferences[kPrefDiagnostics] respondsToSelector:@selector(boolValue)] ?
         [preferences[kPrefDiagnostics] boolValue] :
@@ -891,15 +922,18 @@ typedef struct {
     }
     NSInteger fps = frameRateString.length ? frameRateString.integerValue : 30;
     if (fps != 60) { fps = 30; }
+    BOOL frameRateChanged = (fps != self.targetFramesPerSecond);
     self.targetFramesPerSecond = fps;
     self.animationTimeInterval = 1.0 / MAX(1, fps);
 
     if (newEmitterCount != self.emitterCount || (changedKeys && [changedKeys containsObject:kPrefEmitterCount])) {
         self.emitterCount = newEmitterCount;
         [self rebuildEmitters];
+    } else if (frameRateChanged) {
+        // Ribbons hold one point per frame, so their length follows the rate.
+        [self rebuildRibbons];
     }
 
-    [self configureParticleRenderHandler];
     [self updateLayerBlurFilter];
 }
 
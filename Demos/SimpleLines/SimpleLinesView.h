@@ -1,4 +1,4 @@
-#import "ScreenSaverKit/SSKScreenSaverView.h"
+#import "ScreenSaverKit/SSKMetalScreenSaverView.h"
 
-@interface SimpleLinesView : SSKScreenSaverView
+@interface SimpleLinesView : SSKMetalScreenSaverView
 @end
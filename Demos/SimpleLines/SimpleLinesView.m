@@ -2,9 +2,16 @@
 
 #import <AppKit/AppKit.h>
 
+#import <Metal/Metal.h>
+
 #import "ScreenSaverKit/SSKConfigurationWindowController.h"
 #import "ScreenSaverKit/SSKDiagnostics.h"
+#import "ScreenSaverKit/SSKMetalRenderDiagnostics.h"
+#import "ScreenSaverKit/SSKMetalRenderer.h"
+#import "ScreenSaverKit/SSKPaletteManager.h"
 #import "ScreenSaverKit/SSKPreferenceBinder.h"
+#import "ScreenSaverKit/Core/SSKReplay.h"
+#import "ScreenSaverKit/Core/SSKTrail.h"
 
 static NSString * const kPrefLineCount     = @"simpleLineCount";
 static NSString * const kPrefSpeed         = @"simpleLineSpeed";
@@ -12,6 +19,8 @@ static NSString * const kPrefPalette       = @"simpleLinePalette";
 static NSString * const kPrefColorRate     = @"simpleLineColorRate";
 static NSString * const kPrefTrailEnabled  = @"simpleLineTrails";
 
+static NSString * const kSimpleLinesPaletteModule = @"SimpleLines";
+
 typedef struct {
     NSPoint position;
     NSPoint velocity;
@@ -66,44 +75,52 @@ static NSArray<NSDictionary<NSString *, id> *> *SimpleLinesPaletteDefinitions(vo
     return palettes;
 }
 
-static NSArray<NSColor *> *SimpleLinesColorsForIdentifier(NSString *identifier) {
-    for (NSDictionary<NSString *, id> *palette in SimpleLinesPaletteDefinitions()) {
-        if ([palette[@"value"] isEqualToString:identifier]) {
-            return palette[@"colors"];
-        }
-    }
-    NSDictionary<NSString *, id> *fallback = SimpleLinesPaletteDefinitions().firstObject;
-    return fallback ? fallback[@"colors"] : @[ [NSColor whiteColor] ];
-}
-
 static NSString *SimpleLinesFallbackPaletteIdentifier(void) {
     NSDictionary<NSString *, id> *palette = SimpleLinesPaletteDefinitions().firstObject;
     return palette[@"value"] ?: @"neon";
 }
 
-static NSColor *SimpleLinesColorForProgress(NSArray<NSColor *> *colors, CGFloat progress) {
-    if (colors.count == 0) {
-        return [NSColor whiteColor];
-    }
-    if (colors.count == 1) {
-        return colors.firstObject;
-    }
-    CGFloat wrapped = progress - floor(progress);
-    CGFloat scaled = wrapped * (CGFloat)colors.count;
-    NSInteger index = (NSInteger)floor(scaled);
-    CGFloat blendFraction = scaled - (CGFloat)index;
-    NSColor *first = colors[(NSUInteger)index % colors.count];
-    NSColor *second = colors[(NSUInteger)(index + 1) % colors.count];
-    return [first blendedColorWithFraction:blendFraction ofColor:second];
+/// Registers the palette definitions with the shared manager, which compiles
+/// each into a lookup table the first time it is sampled.
+static void SimpleLinesRegisterPalettes(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray<SSKColorPalette *> *palettes = [NSMutableArray array];
+        for (NSDictionary<NSString *, id> *definition in SimpleLinesPaletteDefinitions()) {
+            [palettes addObject:[SSKColorPalette paletteWithIdentifier:definition[@"value"]
+                                                           displayName:definition[@"title"]
+                                                                colors:definition[@"colors"]]];
+        }
+        [[SSKPaletteManager sharedManager] registerPalettes:palettes forModule:kSimpleLinesPaletteModule];
+    });
+}
+
+static SSKColorPalette *SimpleLinesPaletteForIdentifier(NSString *identifier) {
+    SimpleLinesRegisterPalettes();
+    SSKPaletteManager *manager = [SSKPaletteManager sharedManager];
+    return [manager paletteWithIdentifier:identifier module:kSimpleLinesPaletteModule] ?:
+           [manager paletteWithIdentifier:SimpleLinesFallbackPaletteIdentifier() module:kSimpleLinesPaletteModule];
 }
 
+/// Points kept per trail; samples are spaced so the trail spans its length.
+static const uint32_t kSimpleLinesTrailCapacity = 24;
+
 @interface SimpleLinesView ()
-@property (nonatomic) NSMutableArray<NSValue *> *particles;
+@property (nonatomic, strong) NSMutableData *particleData;
+@property (nonatomic, assign) SSKTrailSet *trails;
+/// Per-line palette progress and sampled colour, refilled every frame.
+@property (nonatomic, strong) NSMutableData *paletteProgress;
+@property (nonatomic, strong) NSMutableData *paletteColors;
 @property (nonatomic) NSInteger lineCount;
 @property (nonatomic) CGFloat speedMultiplier;
 @property (nonatomic) CGFloat colorRate;
 @property (nonatomic) BOOL trailsEnabled;
 @property (nonatomic, copy) NSString *paletteIdentifier;
+@property (nonatomic) BOOL metalRenderingActive;
+@property (nonatomic, strong) SSKMetalRenderDiagnostics *renderDiagnostics;
+@property (nonatomic, strong) NSMutableData *rasterVertices;
+@property (nonatomic, strong) NSMutableData *rasterIndices;
+@property (nonatomic, strong) NSMutableData *rasterPixels;
 @property (nonatomic, strong) SSKConfigurationWindowController *configController;
 
 - (void)applyPreferences:(NSDictionary<NSString *, id> *)preferences
@@ -125,7 +142,9 @@ static NSColor *SimpleLinesColorForProgress(NSArray<NSColor *> *colors, CGFloat
 - (instancetype)initWithFrame:(NSRect)frame isPreview:(BOOL)isPreview {
     if ((self = [super initWithFrame:frame isPreview:isPreview])) {
         self.animationTimeInterval = 1.0 / 60.0;
-        _particles = [NSMutableArray array];
+        _particleData = [NSMutableData data];
+        _renderDiagnostics = [[SSKMetalRenderDiagnostics alloc] init];
+        _renderDiagnostics.overlayEnabled = [SSKDiagnostics isEnabled];
         NSDictionary *prefs = [self currentPreferences];
         NSSet *allKeys = [NSSet setWithArray:prefs.allKeys];
         [self applyPreferences:prefs changedKeys:allKeys];
@@ -134,6 +153,10 @@ static NSColor *SimpleLinesColorForProgress(NSArray<NSColor *> *colors, CGFloat
     return self;
 }
 
+- (void)dealloc {
+    SSKTrailSetDestroy(_trails);
+}
+
 - (BOOL)isOpaque {
     return YES;
 }
@@ -143,58 +166,176 @@ static NSColor *SimpleLinesColorForProgress(NSArray<NSColor *> *colors, CGFloat
     [self rebuildLines];
 }
 
-- (void)animateOneFrame {
-    NSTimeInterval dt = [self advanceAnimationClock];
-    if (dt <= 0) { dt = 1.0 / 60.0; }
-    [self updateLinesWithDelta:dt];
+#pragma mark - Rendering
+
+- (void)setupMetalRenderer:(SSKMetalRenderer *)renderer {
+    [super setupMetalRenderer:renderer];
+    renderer.clearColor = MTLClearColorMake(0.0, 0.0, 0.0, 1.0);
+    renderer.diagnostics = self.renderDiagnostics;
+    [self.renderDiagnostics attachToMetalLayer:self.metalLayer];
+}
+
+- (void)renderMetalFrame:(SSKMetalRenderer *)renderer deltaTime:(NSTimeInterval)dt {
+    [self stepSimulationWithDeltaTime:dt];
+
+    // Every line, dot and trail alike, is one strip of the set: one draw call.
+    if (self.trails) {
+        SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+        [renderer drawTrails:self.trails
+                      params:&params
+                   blendMode:SSKParticleBlendModeAlpha
+                viewportSize:self.bounds.size];
+    }
+
+    self.metalRenderingActive = YES;
+    [self.renderDiagnostics recordMetalAttemptWithSuccess:YES];
+    [self updateDiagnosticsOverlay];
+}
+
+- (void)renderCPUFrameWithDeltaTime:(NSTimeInterval)dt {
+    [self stepSimulationWithDeltaTime:dt];
+
+    self.metalRenderingActive = NO;
+    if (self.useMetalPipeline) {
+        [self.renderDiagnostics recordMetalAttemptWithSuccess:NO];
+    }
+    [self ensureFallbackLayer];
     [self setNeedsDisplay:YES];
 }
 
 - (void)drawRect:(NSRect)dirtyRect {
+    if (self.metalRenderingActive && self.metalRenderer) { return; }
+    [self ensureFallbackLayer];
+
     [[NSColor blackColor] setFill];
     NSRectFill(dirtyRect);
 
     CGContextRef ctx = [[NSGraphicsContext currentContext] CGContext];
     if (!ctx) { return; }
 
-    NSArray<NSColor *> *palette = SimpleLinesColorsForIdentifier(self.paletteIdentifier);
-    CGSize size = self.bounds.size;
-    CGFloat centerX = size.width * 0.5;
-    CGFloat centerY = size.height * 0.5;
-
-    CGContextSetLineCap(ctx, kCGLineCapRound);
+    [self rasterizeTrailsIntoContext:ctx];
 
-    for (NSValue *value in self.particles) {
-        SimpleLineParticle particle;
-        [value getValue:&particle];
-
-        CGFloat depthFactor = 1.0 / MAX(0.05, particle.depth);
-        CGFloat speedScale = depthFactor * self.speedMultiplier;
+    [SSKDiagnostics drawOverlayInView:self
+                                text:[@"Simple Lines Demo\n" stringByAppendingString:[self diagnosticsLine]]
+                     framesPerSecond:self.animationClock.framesPerSecond];
+}
 
-        CGFloat x = (particle.position.x - centerX) * depthFactor + centerX;
-        CGFloat y = (particle.position.y - centerY) * depthFactor + centerY;
-        CGFloat radius = 1.0 * depthFactor + 0.35;
+/// CPU fallback: tessellates the same strips the Metal path draws and
+/// rasterises them into a bitmap, rather than stroking each line with CG.
+- (void)rasterizeTrailsIntoContext:(CGContextRef)ctx {
+    SSKTrailSet *trails = self.trails;
+    if (!trails) { return; }
+    CGRect bounds = CGRectIntegral(CGContextGetClipBoundingBox(ctx));
+    if (CGRectIsEmpty(bounds) || CGRectIsInfinite(bounds)) { return; }
+    CGSize deviceUnit = CGContextConvertSizeToDeviceSpace(ctx, CGSizeMake(1.0, 1.0));
+    CGFloat scale = MAX(1.0, MAX(fabs(deviceUnit.width), fabs(deviceUnit.height)));
+    size_t width = (size_t)ceil(bounds.size.width * scale);
+    size_t height = (size_t)ceil(bounds.size.height * scale);
+    if (width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX) { return; }
+
+    uint32_t maxVertices = SSKTrailSetMaxVertexCount(trails);
+    uint32_t maxIndices = SSKTrailSetMaxIndexCount(trails);
+    NSUInteger vertexLength = (NSUInteger)maxVertices * sizeof(SSKTrailVertex);
+    NSUInteger indexLength = (NSUInteger)maxIndices * sizeof(uint32_t);
+    if (self.rasterVertices.length < vertexLength) {
+        self.rasterVertices = [NSMutableData dataWithLength:vertexLength];
+    }
+    if (self.rasterIndices.length < indexLength) {
+        self.rasterIndices = [NSMutableData dataWithLength:indexLength];
+    }
+    SSKTrailMeshParams meshParams = SSKTrailMeshParamsDefault();
+    SSKTrailMeshCounts counts = SSKTrailSetTessellate(trails, &meshParams, self.rasterVertices.mutableBytes,
+                                                      maxVertices, self.rasterIndices.mutableBytes, maxIndices);
+    if (counts.indexCount == 0) { return; }
+
+    size_t rowBytes = width * 4;
+    NSUInteger pixelLength = rowBytes * height;
+    if (!self.rasterPixels) {
+        self.rasterPixels = [NSMutableData dataWithLength:pixelLength];
+    } else if (self.rasterPixels.length < pixelLength) {
+        self.rasterPixels.length = pixelLength;
+    }
+    SSKRasterTarget target = {self.rasterPixels.mutableBytes, (uint32_t)width, (uint32_t)height, rowBytes, SSKRasterFormatRGBA8};
+    SSKRasterTargetClear(&target, (SSKFloat4){0.0f, 0.0f, 0.0f, 0.0f});
+    // Trails are stored y-down, so row 0 of the target is the top of `bounds`.
+    CGFloat viewHeight = NSHeight(self.bounds);
+    SSKParticleRasterParams params = {
+        SSKFloat2Make((float)bounds.origin.x, (float)(viewHeight - CGRectGetMaxY(bounds))),
+        SSKFloat2Make((float)bounds.size.width, (float)bounds.size.height),
+        SSKRasterBlendAlpha,
+    };
+    SSKTrailRasterize(&target, &params, &meshParams, self.rasterVertices.mutableBytes,
+                      self.rasterIndices.mutableBytes, counts.indexCount);
+
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    // The image gets its own copy: contexts that defer drawing (PDF, printing,
+    // asynchronous layers) can keep it past this call, and the next frame
+    // clears or reallocates the raster buffer.
+    NSData *pixels = [NSData dataWithBytes:target.pixels length:pixelLength];
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)pixels);
+    CGImageRef image = NULL;
+    if (colorSpace && provider) {
+        image = CGImageCreate(width, height, 8, 32, rowBytes, colorSpace,
+                              kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast,
+                              provider, NULL, false, kCGRenderingIntentDefault);
+    }
+    if (image) {
+        CGContextSaveGState(ctx);
+        CGContextSetInterpolationQuality(ctx, kCGInterpolationNone);
+        CGContextDrawImage(ctx, bounds, image);
+        CGContextRestoreGState(ctx);
+        CGImageRelease(image);
+    }
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
+}
 
-        NSColor *color = SimpleLinesColorForProgress(palette, particle.paletteProgress);
-        CGContextSetFillColorWithColor(ctx, color.CGColor);
-        CGContextFillEllipseInRect(ctx, CGRectMake(x - radius, y - radius, radius * 2.0, radius * 2.0));
-
-        CGFloat trailLength = particle.trail * speedScale * 0.45;
-        if (self.trailsEnabled && trailLength > 0.0) {
-            CGFloat tailX = x - particle.velocity.x * trailLength;
-            CGFloat tailY = y - particle.velocity.y * trailLength;
-            NSColor *tail = [color colorWithAlphaComponent:0.4];
-            CGContextSetStrokeColorWithColor(ctx, tail.CGColor);
-            CGContextSetLineWidth(ctx, MAX(0.6, radius * 0.6));
-            CGContextMoveToPoint(ctx, x, y);
-            CGContextAddLineToPoint(ctx, tailX, tailY);
-            CGContextStrokePath(ctx);
+- (void)ensureFallbackLayer {
+    if (self.metalLayer) { return; }
+    if (!self.layer) {
+        self.wantsLayer = YES;
+        CALayer *layer = [CALayer layer];
+        layer.backgroundColor = NSColor.blackColor.CGColor;
+        CGFloat scale = 1.0;
+        if (self.window) {
+            scale = self.window.backingScaleFactor;
+        } else if (NSScreen.mainScreen) {
+            scale = NSScreen.mainScreen.backingScaleFactor;
         }
+        layer.contentsScale = scale;
+        layer.frame = self.bounds;
+        self.layer = layer;
     }
+}
 
-    [SSKDiagnostics drawOverlayInView:self
-                                text:@"Simple Lines Demo"
-                     framesPerSecond:self.animationClock.framesPerSecond];
+- (NSString *)diagnosticsLine {
+    NSUInteger lines = self.trails ? self.trails->trailCount : 0;
+    return [NSString stringWithFormat:@"Lines: %lu | Trails: %@ | %@",
+            (unsigned long)lines,
+            self.trailsEnabled ? @"On" : @"Off",
+            self.metalRenderingActive ? @"Metal" : @"CPU"];
+}
+
+- (void)updateDiagnosticsOverlay {
+    self.renderDiagnostics.overlayEnabled = [SSKDiagnostics isEnabled];
+    self.renderDiagnostics.profilingEnabled = self.renderDiagnostics.overlayEnabled;
+    if (!self.renderDiagnostics.overlayEnabled) { return; }
+    [self.renderDiagnostics updateOverlayWithTitle:@"Simple Lines Demo"
+                                        extraLines:@[[self diagnosticsLine]]
+                                   framesPerSecond:self.animationClock.framesPerSecond];
+}
+
+#pragma mark - Simulation
+
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)dt {
+    SSK_PROFILE_SCOPE(self.renderDiagnostics.profiler, "simulation");
+    if (dt <= 0) { dt = 1.0 / 60.0; }
+    [self updateLinesWithDelta:dt];
+    [self updateTrails];
+}
+
+- (uint64_t)simulationChecksum {
+    return SSKReplayChecksum(0, self.particleData.bytes, self.particleData.length);
 }
 
 - (void)updateLinesWithDelta:(NSTimeInterval)dt {
@@ -203,60 +344,139 @@ static NSColor *SimpleLinesColorForProgress(NSArray<NSColor *> *colors, CGFloat
     CGFloat height = NSHeight(bounds);
     CGFloat centerX = NSMidX(bounds);
     CGFloat centerY = NSMidY(bounds);
+    SimpleLineParticle *particles = self.particleData.mutableBytes;
+    NSUInteger count = self.particleData.length / sizeof(SimpleLineParticle);
 
-    for (NSUInteger i = 0; i < self.particles.count; i++) {
-        SimpleLineParticle particle;
-        [self.particles[i] getValue:&particle];
+    for (NSUInteger i = 0; i < count; i++) {
+        SimpleLineParticle *particle = &particles[i];
 
-        CGFloat depthFactor = 1.0 / MAX(0.05, particle.depth);
+        CGFloat depthFactor = 1.0 / MAX(0.05, particle->depth);
         CGFloat speedScale = depthFactor * self.speedMultiplier;
 
-        particle.position.x += particle.velocity.x * speedScale * dt;
-        particle.position.y += particle.velocity.y * speedScale * dt;
-        particle.trail = MIN(140.0, particle.trail + dt * 90.0);
+        particle->position.x += particle->velocity.x * speedScale * dt;
+        particle->position.y += particle->velocity.y * speedScale * dt;
+        particle->trail = MIN(140.0, particle->trail + dt * 90.0);
 
         if (self.colorRate > 0.0) {
-            particle.paletteProgress += dt * self.colorRate * (0.6 + depthFactor * 0.4);
-            particle.paletteProgress -= floor(particle.paletteProgress);
+            particle->paletteProgress += dt * self.colorRate * (0.6 + depthFactor * 0.4);
+            particle->paletteProgress -= floor(particle->paletteProgress);
         }
 
-        BOOL needsReset = (particle.position.x < -width * 0.25) || (particle.position.x > width * 1.25) ||
-                          (particle.position.y < -height * 0.25) || (particle.position.y > height * 1.25);
+        BOOL needsReset = (particle->position.x < -width * 0.25) || (particle->position.x > width * 1.25) ||
+                          (particle->position.y < -height * 0.25) || (particle->position.y > height * 1.25);
         if (needsReset) {
-            particle.depth = ((CGFloat)arc4random() / UINT32_MAX) * 0.9 + 0.1;
-            particle.position = NSMakePoint(centerX + (((CGFloat)arc4random() / UINT32_MAX) - 0.5) * 80.0,
-                                            centerY + (((CGFloat)arc4random() / UINT32_MAX) - 0.5) * 80.0);
-            CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)M_PI * 2.0;
-            particle.velocity = NSMakePoint(cos(angle), sin(angle));
-            particle.trail = arc4random_uniform(60);
-            particle.paletteProgress = ((CGFloat)arc4random() / UINT32_MAX);
+            particle->depth = [self randomUnit] * 0.9 + 0.1;
+            particle->position = NSMakePoint(centerX + ([self randomUnit] - 0.5) * 80.0,
+                                             centerY + ([self randomUnit] - 0.5) * 80.0);
+            CGFloat angle = [self randomUnit] * (CGFloat)M_PI * 2.0;
+            particle->velocity = NSMakePoint(cos(angle), sin(angle));
+            particle->trail = [self randomIndexBelow:60];
+            particle->paletteProgress = [self randomUnit];
+            SSKTrailSetClear(self.trails, (uint32_t)i);
         }
+    }
+}
 
-        self.particles[i] = [NSValue valueWithBytes:&particle objCType:@encode(SimpleLineParticle)];
+/// Samples every line's projected head into its trail and restyles it. The
+/// newest point follows the head each frame; a new one is pushed once it is a
+/// sample spacing past the previous, so the history spans the trail length
+/// with a fixed number of points. Without trails each line is a short dash.
+- (void)updateTrails {
+    SSKTrailSet *trails = self.trails;
+    if (!trails) { return; }
+    CGSize size = self.bounds.size;
+    CGFloat centerX = size.width * 0.5;
+    CGFloat centerY = size.height * 0.5;
+    const SimpleLineParticle *particles = self.particleData.bytes;
+    uint32_t count = (uint32_t)MIN(self.particleData.length / sizeof(SimpleLineParticle), (NSUInteger)trails->trailCount);
+    count = (uint32_t)MIN((NSUInteger)count, self.paletteColors.length / sizeof(SSKFloat4));
+
+    float *progress = self.paletteProgress.mutableBytes;
+    SSKFloat4 *colors = self.paletteColors.mutableBytes;
+    for (uint32_t i = 0; i < count; i++) {
+        progress[i] = (float)particles[i].paletteProgress;
+    }
+    [[SSKPaletteManager sharedManager] sampleColorsForPalette:SimpleLinesPaletteForIdentifier(self.paletteIdentifier)
+                                                     progress:progress
+                                                        count:count
+                                            interpolationMode:SSKPaletteInterpolationModeLoop
+                                                       colors:colors];
+
+    for (uint32_t i = 0; i < count; i++) {
+        const SimpleLineParticle *particle = &particles[i];
+        CGFloat depthFactor = 1.0 / MAX(0.05, particle->depth);
+        CGFloat speedScale = depthFactor * self.speedMultiplier;
+        CGFloat x = (particle->position.x - centerX) * depthFactor + centerX;
+        CGFloat y = (particle->position.y - centerY) * depthFactor + centerY;
+        CGFloat radius = 1.0 * depthFactor + 0.35;
+        // Trails are stored y-down, as the Metal pass draws them.
+        SSKFloat2 head = SSKFloat2Make((float)x, (float)(size.height - y));
+
+        if (self.trailsEnabled) {
+            CGFloat trailLength = MAX(radius * 2.0, particle->trail * speedScale * 0.45);
+            CGFloat spacing = trailLength / (CGFloat)(kSimpleLinesTrailCapacity - 2);
+            uint32_t length = trails->length[i];
+            if (length < 2) {
+                SSKTrailSetPush(trails, i, head);
+            } else {
+                SSKFloat2 previous = SSKTrailSetPoint(trails, i, length - 2);
+                CGFloat dx = head.x - previous.x;
+                CGFloat dy = head.y - previous.y;
+                if (dx * dx + dy * dy < spacing * spacing) {
+                    SSKTrailSetMoveHead(trails, i, head);
+                } else {
+                    SSKTrailSetPush(trails, i, head);
+                }
+            }
+        } else {
+            // A dash one dot long, pointing along the motion.
+            SSKTrailSetClear(trails, i);
+            SSKTrailSetPush(trails, i, SSKFloat2Make(head.x - (float)(particle->velocity.x * radius * 2.0),
+                                                     head.y + (float)(particle->velocity.y * radius * 2.0)));
+            SSKTrailSetPush(trails, i, head);
+        }
+
+        SSKFloat4 headColor = colors[i];
+        headColor.w = 1.0f;
+        SSKFloat4 tailColor = headColor;
+        tailColor.w = self.trailsEnabled ? 0.0f : 1.0f;
+        trails->styles[i] = (SSKTrailStyle){
+            (float)(radius * 2.0),
+            (float)MAX(0.6, radius * 0.6),
+            headColor,
+            tailColor,
+        };
     }
 }
 
 - (void)rebuildLines {
-    if (!self.particles) {
-        self.particles = [NSMutableArray array];
-    } else {
-        [self.particles removeAllObjects];
-    }
     NSInteger count = MAX(50, self.lineCount);
+    if (!self.particleData) {
+        self.particleData = [NSMutableData data];
+    }
+    self.particleData.length = (NSUInteger)count * sizeof(SimpleLineParticle);
+    self.paletteProgress = [NSMutableData dataWithLength:(NSUInteger)count * sizeof(float)];
+    self.paletteColors = [NSMutableData dataWithLength:(NSUInteger)count * sizeof(SSKFloat4)];
+    SSKTrailSetDestroy(self.trails);
+    self.trails = SSKTrailSetCreate((uint32_t)count, kSimpleLinesTrailCapacity);
+    if (!self.trails && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SimpleLinesView: could not allocate %ld trails.", (long)count];
+    }
+
     NSRect bounds = self.bounds;
     CGFloat centerX = NSMidX(bounds);
     CGFloat centerY = NSMidY(bounds);
-
+    SimpleLineParticle *particles = self.particleData.mutableBytes;
     for (NSInteger i = 0; i < count; i++) {
         SimpleLineParticle particle;
-        particle.depth = ((CGFloat)arc4random() / UINT32_MAX) * 0.9 + 0.1;
-        particle.position = NSMakePoint(centerX + (((CGFloat)arc4random() / UINT32_MAX) - 0.5) * NSWidth(bounds),
-                                        centerY + (((CGFloat)arc4random() / UINT32_MAX) - 0.5) * NSHeight(bounds));
-        CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)M_PI * 2.0;
+        particle.depth = [self randomUnit] * 0.9 + 0.1;
+        particle.position = NSMakePoint(centerX + ([self randomUnit] - 0.5) * NSWidth(bounds),
+                                        centerY + ([self randomUnit] - 0.5) * NSHeight(bounds));
+        CGFloat angle = [self randomUnit] * (CGFloat)M_PI * 2.0;
         particle.velocity = NSMakePoint(cos(angle), sin(angle));
-        particle.paletteProgress = ((CGFloat)arc4random() / UINT32_MAX);
-        particle.trail = arc4random_uniform(60);
-        [self.particles addObject:[NSValue valueWithBytes:&particle objCType:@encode(SimpleLineParticle)]];
+        particle.paletteProgress = [self randomUnit];
+        particle.trail = [self randomIndexBelow:60];
+        particles[i] = particle;
     }
 }
 
@@ -1,4 +1,4 @@
-#import "ScreenSaverKit/SSKScreenSaverView.h"
+#import "ScreenSaverKit/SSKMetalScreenSaverView.h"
 
-@interface StarfieldView : SSKScreenSaverView
+@interface StarfieldView : SSKMetalScreenSaverView
 @end
@@ -1,10 +1,16 @@
 #import "StarfieldView.h"
 
 #import <AppKit/AppKit.h>
+#import <Metal/Metal.h>
 
 #import "ScreenSaverKit/SSKConfigurationWindowController.h"
 #import "ScreenSaverKit/SSKDiagnostics.h"
+#import "ScreenSaverKit/SSKMetalRenderDiagnostics.h"
+#import "ScreenSaverKit/SSKMetalRenderer.h"
 #import "ScreenSaverKit/SSKPreferenceBinder.h"
+#import "ScreenSaverKit/Core/SSKParticleRaster.h"
+#import "ScreenSaverKit/Core/SSKReplay.h"
+#import "ScreenSaverKit/Core/SSKStarfield.h"
 
 static NSString * const kPrefStarCount          = @"classicStarCount";
 static NSString * const kPrefSpeed              = @"classicStarSpeed";
@@ -14,61 +20,78 @@ static NSString * const kPrefBlurAmount         = @"classicStarBlurAmount";
 static NSString * const kPrefDirectionShifts    = @"classicStarDirectionShifts";
 static NSString * const kPrefStarSize           = @"classicStarSize";
 
-typedef struct {
-    float x;
-    float y;
-    float z;
-    float prevX;
-    float prevY;
-    float prevZ;
-} ClassicStar;
+/// Upper end of the star count slider.
+static const NSInteger kStarfieldMaxStars       = 150000;
+
+/// Indices into the preference snapshot, in the order `preferenceSchema`
+/// declares the keys; it asserts that each key lands on its index.
+typedef NS_ENUM(uint32_t, StarfieldPref) {
+    StarfieldPrefStarCount,
+    StarfieldPrefSpeed,
+    StarfieldPrefFieldOfView,
+    StarfieldPrefMotionBlur,
+    StarfieldPrefBlurAmount,
+    StarfieldPrefDirectionShifts,
+    StarfieldPrefStarSize,
+    StarfieldPrefCount,
+};
 
 @interface StarfieldView ()
-@property (nonatomic) NSMutableArray<NSValue *> *stars; // stores ClassicStar structs
-@property (nonatomic) NSInteger starCount;
-@property (nonatomic) CGFloat speedMultiplier;
-@property (nonatomic) CGFloat fieldOfView;
-@property (nonatomic) CGFloat blurAmount;
-@property (nonatomic) CGFloat starSize;
-@property (nonatomic) BOOL motionBlurEnabled;
-@property (nonatomic) BOOL directionShiftsEnabled;
+@property (nonatomic, assign) SSKStarfield *starfield;
+@property (nonatomic) SSKRandom directionRandom;
 @property (nonatomic) NSPoint directionVector;
 @property (nonatomic) NSPoint targetDirectionVector;
 @property (nonatomic) NSTimeInterval timeUntilNextDirectionShift;
+@property (nonatomic) BOOL metalRenderingActive;
+@property (nonatomic) NSUInteger lastQuadCount;
+@property (nonatomic, strong) SSKMetalRenderDiagnostics *renderDiagnostics;
+@property (nonatomic, assign) SSKParticleRasterizer *rasterizer;
+@property (nonatomic, strong) NSMutableData *rasterInstances;
+@property (nonatomic, strong) NSMutableData *rasterPixels;
 @property (nonatomic, strong) SSKConfigurationWindowController *configController;
-
-- (void)applyPreferences:(NSDictionary<NSString *, id> *)preferences
-             changedKeys:(nullable NSSet<NSString *> *)changedKeys;
 @end
 
 @implementation StarfieldView
 
-- (NSDictionary<NSString *,id> *)defaultPreferences {
-    return @{
-        kPrefStarCount: @(320),
-        kPrefSpeed: @(1.4),
-        kPrefFieldOfView: @(1.35),
-        kPrefMotionBlur: @(YES),
-        kPrefBlurAmount: @(0.65),
-        kPrefDirectionShifts: @(YES),
-        kPrefStarSize: @(0.25)
-    };
+- (SSKPreferenceSchema *)preferenceSchema {
+    // Ranges follow the sliders, widened to the lower bounds the simulation
+    // has always enforced (star count, speed, field of view).
+    SSKPreferenceSchema *schema = [SSKPreferenceSchema new];
+    NSUInteger declared[StarfieldPrefCount];
+    declared[StarfieldPrefStarCount] = [schema addIntegerKey:kPrefStarCount defaultValue:320 minimum:50 maximum:kStarfieldMaxStars];
+    declared[StarfieldPrefSpeed] = [schema addDoubleKey:kPrefSpeed defaultValue:1.4 minimum:0.05 maximum:4.0];
+    declared[StarfieldPrefFieldOfView] = [schema addDoubleKey:kPrefFieldOfView defaultValue:1.35 minimum:0.5 maximum:2.2];
+    declared[StarfieldPrefMotionBlur] = [schema addBoolKey:kPrefMotionBlur defaultValue:YES];
+    declared[StarfieldPrefBlurAmount] = [schema addDoubleKey:kPrefBlurAmount defaultValue:0.65 minimum:0.0 maximum:1.5];
+    declared[StarfieldPrefDirectionShifts] = [schema addBoolKey:kPrefDirectionShifts defaultValue:YES];
+    declared[StarfieldPrefStarSize] = [schema addDoubleKey:kPrefStarSize defaultValue:0.25 minimum:0.1 maximum:3.0];
+    for (uint32_t pref = 0; pref < StarfieldPrefCount; pref++) {
+        NSAssert(declared[pref] == pref, @"StarfieldPref %u was declared at snapshot index %lu",
+                 pref, (unsigned long)declared[pref]);
+    }
+    return schema;
 }
 
 - (instancetype)initWithFrame:(NSRect)frame isPreview:(BOOL)isPreview {
     if ((self = [super initWithFrame:frame isPreview:isPreview])) {
         self.animationTimeInterval = 1.0 / 60.0;
+        _directionRandom = SSKRandomMake([self nextRandomSeed]);
         _directionVector = NSZeroPoint;
         _targetDirectionVector = NSZeroPoint;
         _timeUntilNextDirectionShift = 0.0;
-        NSDictionary *prefs = [self currentPreferences];
-        NSSet *allKeys = [NSSet setWithArray:prefs.allKeys];
-        [self applyPreferences:prefs changedKeys:allKeys];
+        _renderDiagnostics = [[SSKMetalRenderDiagnostics alloc] init];
+        _renderDiagnostics.overlayEnabled = [SSKDiagnostics isEnabled];
         [self rebuildStars];
     }
     return self;
 }
 
+- (void)dealloc {
+    SSKStarfieldDestroy(_starfield);
+    SSKParticleRasterizerDestroy(_rasterizer);
+    free(_rasterizer);
+}
+
 - (BOOL)isOpaque {
     return YES;
 }
@@ -78,106 +101,243 @@ typedef struct {
     [self rebuildStars];
 }
 
-- (void)animateOneFrame {
-    NSTimeInterval dt = [self advanceAnimationClock];
-    if (dt <= 0) { dt = 1.0 / 60.0; }
+#pragma mark - Rendering
 
-    [self updateDirectionVectorWithDelta:dt];
-    [self updateStarsWithDelta:dt];
+- (void)setupMetalRenderer:(SSKMetalRenderer *)renderer {
+    [super setupMetalRenderer:renderer];
+    renderer.clearColor = MTLClearColorMake(0.0, 0.0, 0.0, 1.0);
+    renderer.diagnostics = self.renderDiagnostics;
+    [self.renderDiagnostics attachToMetalLayer:self.metalLayer];
+}
 
+- (void)renderMetalFrame:(SSKMetalRenderer *)renderer deltaTime:(NSTimeInterval)dt {
+    [self stepSimulationWithDeltaTime:dt];
+
+    // Metal draws particles y-down, so the field is flipped vertically.
+    SSKStarfield *starfield = self.starfield;
+    SSKStarfieldProjection projection = [self projectionFlipped:YES];
+    NSUInteger maxCount = starfield ? (NSUInteger)starfield->count * SSKStarfieldMaxInstancesPerStar : 0;
+    SSKProfiler *profiler = self.renderDiagnostics.profiler;
+    __block NSUInteger quadCount = 0;
+    [renderer drawInstancesWithMaxCount:maxCount
+                              blendMode:SSKParticleBlendModeAlpha
+                           viewportSize:self.bounds.size
+                                 writer:^NSUInteger(SSKParticleInstance *instances, NSUInteger capacity) {
+        SSK_PROFILE_SCOPE(profiler, "instances.pack");
+        quadCount = SSKStarfieldWriteInstances(starfield, &projection, instances, (uint32_t)capacity);
+        return quadCount;
+    }];
+    self.lastQuadCount = quadCount;
+
+    self.metalRenderingActive = YES;
+    [self.renderDiagnostics recordMetalAttemptWithSuccess:YES];
+    [self updateDiagnosticsOverlay];
+}
+
+- (void)renderCPUFrameWithDeltaTime:(NSTimeInterval)dt {
+    [self stepSimulationWithDeltaTime:dt];
+
+    self.metalRenderingActive = NO;
+    if (self.useMetalPipeline) {
+        [self.renderDiagnostics recordMetalAttemptWithSuccess:NO];
+    }
+    [self ensureFallbackLayer];
     [self setNeedsDisplay:YES];
 }
 
 - (void)drawRect:(NSRect)dirtyRect {
+    if (self.metalRenderingActive && self.metalRenderer) { return; }
+    [self ensureFallbackLayer];
+
     [[NSColor blackColor] setFill];
     NSRectFill(dirtyRect);
 
     CGContextRef ctx = [[NSGraphicsContext currentContext] CGContext];
     if (!ctx) { return; }
 
+    [self rasterizeStarsIntoContext:ctx];
+
+    [SSKDiagnostics drawOverlayInView:self
+                                text:[@"Starfield Demo\n" stringByAppendingString:[self diagnosticsLine]]
+                     framesPerSecond:self.animationClock.framesPerSecond];
+}
+
+/// CPU fallback: writes the same quads the Metal path draws and rasterises
+/// them into a bitmap, rather than issuing CG calls per star.
+- (void)rasterizeStarsIntoContext:(CGContextRef)ctx {
+    SSKStarfield *starfield = self.starfield;
+    if (!starfield) { return; }
+    CGRect bounds = CGRectIntegral(CGContextGetClipBoundingBox(ctx));
+    if (CGRectIsEmpty(bounds) || CGRectIsInfinite(bounds)) { return; }
+    CGSize deviceUnit = CGContextConvertSizeToDeviceSpace(ctx, CGSizeMake(1.0, 1.0));
+    CGFloat scale = MAX(1.0, MAX(fabs(deviceUnit.width), fabs(deviceUnit.height)));
+    size_t width = (size_t)ceil(bounds.size.width * scale);
+    size_t height = (size_t)ceil(bounds.size.height * scale);
+    if (width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX) { return; }
+
+    if (!self.rasterizer) {
+        SSKParticleRasterizer *rasterizer = calloc(1, sizeof(SSKParticleRasterizer));
+        if (!rasterizer) { return; }
+        SSKParticleRasterizerInit(rasterizer, 0);
+        self.rasterizer = rasterizer;
+    }
+
+    uint32_t maxCount = starfield->count * SSKStarfieldMaxInstancesPerStar;
+    NSUInteger instanceLength = (NSUInteger)maxCount * sizeof(SSKParticleInstance);
+    if (!self.rasterInstances) {
+        self.rasterInstances = [NSMutableData dataWithLength:instanceLength];
+    } else if (self.rasterInstances.length < instanceLength) {
+        self.rasterInstances.length = instanceLength;
+    }
+    SSKStarfieldProjection projection = [self projectionFlipped:NO];
+    SSKParticleInstance *instances = self.rasterInstances.mutableBytes;
+    uint32_t count = SSKStarfieldWriteInstances(starfield, &projection, instances, maxCount);
+    self.lastQuadCount = count;
+    if (count == 0) { return; }
+
+    size_t rowBytes = width * 4;
+    NSUInteger pixelLength = rowBytes * height;
+    if (!self.rasterPixels) {
+        self.rasterPixels = [NSMutableData dataWithLength:pixelLength];
+    } else if (self.rasterPixels.length < pixelLength) {
+        self.rasterPixels.length = pixelLength;
+    }
+    SSKRasterTarget target = {self.rasterPixels.mutableBytes, (uint32_t)width, (uint32_t)height, rowBytes, SSKRasterFormatRGBA8};
+    SSKRasterTargetClear(&target, (SSKFloat4){0.0f, 0.0f, 0.0f, 0.0f});
+    SSKParticleRasterParams params = {
+        SSKFloat2Make((float)bounds.origin.x, (float)bounds.origin.y),
+        SSKFloat2Make((float)bounds.size.width, (float)bounds.size.height),
+        SSKRasterBlendAlpha,
+    };
+    if (!SSKParticleRasterizerDraw(self.rasterizer, NULL, &target, &params, instances, count)) { return; }
+
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    // The image gets its own copy: contexts that defer drawing (PDF, printing,
+    // asynchronous layers) can keep it past this call, and the next frame
+    // clears or reallocates the raster buffer.
+    NSData *pixels = [NSData dataWithBytes:target.pixels length:pixelLength];
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)pixels);
+    CGImageRef image = NULL;
+    if (colorSpace && provider) {
+        image = CGImageCreate(width, height, 8, 32, rowBytes, colorSpace,
+                              kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast,
+                              provider, NULL, false, kCGRenderingIntentDefault);
+    }
+    if (image) {
+        CGContextSaveGState(ctx);
+        // Row 0 of the target maps to `bounds.origin.y`; flip so it is not drawn upside down.
+        CGContextTranslateCTM(ctx, 0.0, CGRectGetMinY(bounds) + CGRectGetMaxY(bounds));
+        CGContextScaleCTM(ctx, 1.0, -1.0);
+        CGContextSetInterpolationQuality(ctx, kCGInterpolationNone);
+        CGContextDrawImage(ctx, bounds, image);
+        CGContextRestoreGState(ctx);
+        CGImageRelease(image);
+    }
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
+}
+
+- (SSKStarfieldProjection)projectionFlipped:(BOOL)flipped {
     CGSize size = self.bounds.size;
     CGFloat centerX = size.width * 0.5;
     CGFloat centerY = size.height * 0.5;
     CGFloat aspect = (size.height == 0) ? 1.0 : (size.width / size.height);
-    CGFloat fov = MAX(0.5, self.fieldOfView);
+    const SSKPreferenceSnapshot *prefs = self.preferenceSnapshot;
+    CGFloat fov = SSKPreferenceSnapshotDouble(prefs, StarfieldPrefFieldOfView);
+
+    SSKStarfieldProjection projection;
+    projection.center = SSKFloat2Make((float)centerX, (float)centerY);
+    projection.scale = SSKFloat2Make((float)(fov * aspect * 0.5 * centerX),
+                                     (float)(fov * 0.5 * centerY * (flipped ? -1.0 : 1.0)));
+    projection.boundsMin = SSKFloat2Make(-50.0f, -50.0f);
+    projection.boundsMax = SSKFloat2Make((float)size.width + 50.0f, (float)size.height + 50.0f);
+    projection.baseRadius = self.isPreview ? 1.3f : 1.8f;
+    projection.sizeScale = (float)SSKPreferenceSnapshotDouble(prefs, StarfieldPrefStarSize);
+    double blurAmount = SSKPreferenceSnapshotDouble(prefs, StarfieldPrefBlurAmount);
+    BOOL motionBlur = SSKPreferenceSnapshotBool(prefs, StarfieldPrefMotionBlur);
+    projection.tail = (motionBlur && blurAmount > 0.01) ? (float)blurAmount : 0.0f;
+    return projection;
+}
 
-    CGContextSetLineCap(ctx, kCGLineCapRound);
+- (void)ensureFallbackLayer {
+    if (self.metalLayer) { return; }
+    if (!self.layer) {
+        self.wantsLayer = YES;
+        CALayer *layer = [CALayer layer];
+        layer.backgroundColor = NSColor.blackColor.CGColor;
+        CGFloat scale = 1.0;
+        if (self.window) {
+            scale = self.window.backingScaleFactor;
+        } else if (NSScreen.mainScreen) {
+            scale = NSScreen.mainScreen.backingScaleFactor;
+        }
+        layer.contentsScale = scale;
+        layer.frame = self.bounds;
+        self.layer = layer;
+    }
+}
 
-    for (NSValue *value in self.stars) {
-        ClassicStar star;
-        [value getValue:&star];
+- (NSString *)diagnosticsLine {
+    NSUInteger stars = self.starfield ? self.starfield->count : 0;
+    return [NSString stringWithFormat:@"Stars: %lu | Quads: %lu | %@",
+            (unsigned long)stars,
+            (unsigned long)self.lastQuadCount,
+            self.metalRenderingActive ? @"Metal" : @"CPU"];
+}
 
-        NSPoint prevPoint = [self projectStarWithX:star.prevX y:star.prevY z:star.prevZ centerX:centerX centerY:centerY aspect:aspect fov:fov];
-        NSPoint currentPoint = [self projectStarWithX:star.x y:star.y z:star.z centerX:centerX centerY:centerY aspect:aspect fov:fov];
+- (void)updateDiagnosticsOverlay {
+    self.renderDiagnostics.overlayEnabled = [SSKDiagnostics isEnabled];
+    self.renderDiagnostics.profilingEnabled = self.renderDiagnostics.overlayEnabled;
+    if (!self.renderDiagnostics.overlayEnabled) { return; }
+    [self.renderDiagnostics updateOverlayWithTitle:@"Starfield Demo"
+                                        extraLines:@[[self diagnosticsLine]]
+                                   framesPerSecond:self.animationClock.framesPerSecond];
+}
 
-        if (!NSPointInRect(currentPoint, NSInsetRect(self.bounds, -50.0, -50.0)) ||
-            star.z <= 0.02f) {
-            continue;
-        }
+#pragma mark - Simulation
 
-        CGFloat inverseDepth = 1.0 / MAX(0.2f, star.z);
-        CGFloat radius = (self.isPreview ? 1.3 : 1.8);
-        radius += inverseDepth * 7.0;
-        radius *= MAX(0.1, self.starSize);
-
-        CGFloat brightness = MIN(1.0, 0.25 + inverseDepth * 1.8);
-        NSColor *color = [NSColor colorWithCalibratedWhite:brightness alpha:1.0];
-        CGContextSetFillColorWithColor(ctx, color.CGColor);
-        CGContextFillEllipseInRect(ctx, CGRectMake(currentPoint.x - radius,
-                                                   currentPoint.y - radius,
-                                                   radius * 2.0,
-                                                   radius * 2.0));
-
-        if (self.motionBlurEnabled && self.blurAmount > 0.01) {
-            CGFloat blurFactor = MIN(1.5, MAX(0.0, self.blurAmount));
-            NSPoint tailPoint = NSMakePoint(currentPoint.x + (prevPoint.x - currentPoint.x) * blurFactor,
-                                            currentPoint.y + (prevPoint.y - currentPoint.y) * blurFactor);
-            NSColor *tailColor = [color colorWithAlphaComponent:0.55];
-            CGContextSetStrokeColorWithColor(ctx, tailColor.CGColor);
-            CGContextSetLineWidth(ctx, MAX(0.6, radius * 0.6));
-            CGContextMoveToPoint(ctx, currentPoint.x, currentPoint.y);
-            CGContextAddLineToPoint(ctx, tailPoint.x, tailPoint.y);
-            CGContextStrokePath(ctx);
-        }
+- (void)reseedRandomWithSeed:(uint64_t)seed {
+    [super reseedRandomWithSeed:seed];
+    self.directionRandom = SSKRandomMake([self nextRandomSeed]);
+    if (self.starfield) {
+        // Stars respawn from the field's own generator; start a new field.
+        SSKStarfieldDestroy(self.starfield);
+        self.starfield = NULL;
+        [self rebuildStars];
     }
+}
 
-    [SSKDiagnostics drawOverlayInView:self
-                                text:@"Starfield Demo"
-                     framesPerSecond:self.animationClock.framesPerSecond];
+- (uint64_t)simulationChecksum {
+    SSKStarfield *field = self.starfield;
+    double direction[2] = { self.directionVector.x, self.directionVector.y };
+    uint64_t hash = SSKReplayChecksum(0, direction, sizeof direction);
+    if (!field) { return hash; }
+    hash = SSKReplayChecksum(hash, field->x, field->count * sizeof(float));
+    hash = SSKReplayChecksum(hash, field->y, field->count * sizeof(float));
+    return SSKReplayChecksum(hash, field->z, field->count * sizeof(float));
 }
 
-#pragma mark - Simulation
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)dt {
+    SSK_PROFILE_SCOPE(self.renderDiagnostics.profiler, "simulation");
+    if (dt <= 0) { dt = 1.0 / 60.0; }
+    [self updateDirectionVectorWithDelta:dt];
+    [self updateStarsWithDelta:dt];
+}
 
 - (void)updateStarsWithDelta:(NSTimeInterval)dt {
-    CGFloat speed = MAX(0.05, self.speedMultiplier);
+    if (!self.starfield) { return; }
+    CGFloat speed = SSKPreferenceSnapshotDouble(self.preferenceSnapshot, StarfieldPrefSpeed);
     CGFloat depthVelocity = speed * dt;
-
-    for (NSUInteger i = 0; i < self.stars.count; i++) {
-        ClassicStar star;
-        [self.stars[i] getValue:&star];
-
-        star.prevX = star.x;
-        star.prevY = star.y;
-        star.prevZ = star.z;
-
-        star.z -= depthVelocity;
-        star.x += self.directionVector.x * depthVelocity * 0.75f;
-        star.y += self.directionVector.y * depthVelocity * 0.75f;
-
-        BOOL needsReset = (star.z <= 0.15f) ||
-                          (fabs(star.x) > 2.5f) ||
-                          (fabs(star.y) > 2.5f);
-
-        if (needsReset) {
-            star = [self randomStar];
-        }
-
-        self.stars[i] = [NSValue valueWithBytes:&star objCType:@encode(ClassicStar)];
-    }
+    SSKStarfieldStepParams params = {
+        (float)depthVelocity,
+        SSKFloat2Make((float)(self.directionVector.x * depthVelocity * 0.75),
+                      (float)(self.directionVector.y * depthVelocity * 0.75)),
+    };
+    SSKStarfieldStep(self.starfield, &params);
 }
 
 - (void)updateDirectionVectorWithDelta:(NSTimeInterval)dt {
-    if (!self.directionShiftsEnabled) {
+    if (!SSKPreferenceSnapshotBool(self.preferenceSnapshot, StarfieldPrefDirectionShifts)) {
         self.directionVector = NSZeroPoint;
         self.targetDirectionVector = NSZeroPoint;
         self.timeUntilNextDirectionShift = 0.0;
@@ -186,11 +346,13 @@ typedef struct {
 
     self.timeUntilNextDirectionShift -= dt;
     if (self.timeUntilNextDirectionShift <= 0.0) {
-        CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)M_PI * 2.0;
-        CGFloat magnitude = 0.2f + ((CGFloat)arc4random() / UINT32_MAX) * 0.45f;
+        SSKRandom random = self.directionRandom;
+        CGFloat angle = SSKRandomNextUnit(&random) * (CGFloat)M_PI * 2.0;
+        CGFloat magnitude = SSKRandomNextRange(&random, 0.2f, 0.65f);
         self.targetDirectionVector = NSMakePoint(cos(angle) * magnitude,
                                                  sin(angle) * magnitude * 0.75f);
-        self.timeUntilNextDirectionShift = 2.5 + ((CGFloat)arc4random() / UINT32_MAX) * 3.0;
+        self.timeUntilNextDirectionShift = SSKRandomNextRange(&random, 2.5f, 5.5f);
+        self.directionRandom = random;
     }
 
     CGFloat lerpSpeed = MIN(1.0, dt * 1.5);
@@ -198,96 +360,25 @@ typedef struct {
                                        self.directionVector.y + (self.targetDirectionVector.y - self.directionVector.y) * lerpSpeed);
 }
 
-- (ClassicStar)randomStar {
-    ClassicStar star;
-    CGFloat angle = ((CGFloat)arc4random() / UINT32_MAX) * (CGFloat)M_PI * 2.0;
-    CGFloat radius = sqrt(((CGFloat)arc4random() / UINT32_MAX)) * 1.6f;
-    star.x = cos(angle) * radius;
-    star.y = sin(angle) * radius;
-    star.z = 1.0f + ((CGFloat)arc4random() / UINT32_MAX) * 1.9f;
-    star.prevX = star.x;
-    star.prevY = star.y;
-    star.prevZ = star.z;
-    return star;
-}
-
 - (void)rebuildStars {
-    if (!self.stars) {
-        self.stars = [NSMutableArray array];
-    } else {
-        [self.stars removeAllObjects];
-    }
-    NSInteger count = MAX(50, self.starCount);
-    for (NSInteger i = 0; i < count; i++) {
-        ClassicStar star = [self randomStar];
-        [self.stars addObject:[NSValue valueWithBytes:&star objCType:@encode(ClassicStar)]];
+    // Before the schema is in place (a frame set during init) there is no
+    // count to build with yet.
+    const SSKPreferenceSnapshot *prefs = self.preferenceSnapshot;
+    if (prefs->count == 0) { return; }
+    int64_t count = SSKPreferenceSnapshotInteger(prefs, StarfieldPrefStarCount);
+    if (!self.starfield) {
+        self.starfield = SSKStarfieldCreate((uint32_t)count, [self nextRandomSeed]);
+    } else if (!SSKStarfieldSetCount(self.starfield, (uint32_t)count) && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"StarfieldView: could not allocate %ld stars.", (long)count];
     }
 }
 
-- (NSPoint)projectStarWithX:(float)x
-                          y:(float)y
-                          z:(float)z
-                     centerX:(CGFloat)centerX
-                     centerY:(CGFloat)centerY
-                      aspect:(CGFloat)aspect
-                         fov:(CGFloat)fov {
-    CGFloat safeZ = MAX(0.05f, z);
-    CGFloat depthScale = fov / safeZ;
-    CGFloat horizontalScale = depthScale * aspect * 0.5;
-    CGFloat verticalScale = depthScale * 0.5;
-    CGFloat projectedX = centerX + (CGFloat)x * horizontalScale * centerX;
-    CGFloat projectedY = centerY + (CGFloat)y * verticalScale * centerY;
-    return NSMakePoint(projectedX, projectedY);
-}
-
 #pragma mark - Preferences
 
 - (void)preferencesDidChange:(NSDictionary<NSString *,id> *)preferences
                  changedKeys:(NSSet<NSString *> *)changedKeys {
-    [self applyPreferences:preferences changedKeys:changedKeys];
-}
-
-- (void)applyPreferences:(NSDictionary<NSString *,id> *)preferences
-             changedKeys:(nullable NSSet<NSString *> *)changedKeys {
-    NSDictionary *defaults = [self defaultPreferences];
-
-    NSInteger newCount = [preferences[kPrefStarCount] respondsToSelector:@selector(integerValue)] ?
-        [preferences[kPrefStarCount] integerValue] :
-        [defaults[kPrefStarCount] integerValue];
-
-    self.speedMultiplier = [preferences[kPrefSpeed] respondsToSelector:@selector(doubleValue)] ?
-        [preferences[kPrefSpeed] doubleValue] :
-        [defaults[kPrefSpeed] doubleValue];
-
-    self.fieldOfView = [preferences[kPrefFieldOfView] respondsToSelector:@selector(doubleValue)] ?
-        [preferences[kPrefFieldOfView] doubleValue] :
-        [defaults[kPrefFieldOfView] doubleValue];
-
-    self.motionBlurEnabled = [preferences[kPrefMotionBlur] respondsToSelector:@selector(boolValue)] ?
-        [preferences[kPrefMotionBlur] boolValue] :
-        [defaults[kPrefMotionBlur] boolValue];
-
-    self.blurAmount = [preferences[kPrefBlurAmount] respondsToSelector:@selector(doubleValue)] ?
-        [preferences[kPrefBlurAmount] doubleValue] :
-        [defaults[kPrefBlurAmount] doubleValue];
-
-    self.directionShiftsEnabled = [preferences[kPrefDirectionShifts] respondsToSelector:@selector(boolValue)] ?
-        [preferences[kPrefDirectionShifts] boolValue] :
-        [defaults[kPrefDirectionShifts] boolValue];
-
-    double sizeSetting = [preferences[kPrefStarSize] respondsToSelector:@selector(doubleValue)] ?
-        [preferences[kPrefStarSize] doubleValue] :
-        [defaults[kPrefStarSize] doubleValue];
-    self.starSize = MAX(0.1, sizeSetting);
-
-    NSInteger previousCount = self.starCount;
-    BOOL starCountDirty = (newCount != previousCount);
-    if (changedKeys && [changedKeys containsObject:kPrefStarCount]) {
-        starCountDirty = YES;
-    }
-    self.starCount = newCount;
-
-    if (starCountDirty) {
+    // Everything else is read from the snapshot each frame.
+    if (SSKPreferenceSnapshotIsDirty(self.preferenceSnapshot, StarfieldPrefStarCount)) {
         [self rebuildStars];
     }
 }
@@ -313,7 +404,7 @@ typedef struct {
 
     [stack addArrangedSubview:[self sliderRowWithTitle:@"Star Count"
                                              minValue:80
-                                             maxValue:900
+                                             maxValue:kStarfieldMaxStars
                                                   key:kPrefStarCount
                                                format:@"%.0f"
                                                 binder:binder]];
@@ -0,0 +1,477 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKBenchHarness.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+
+#include "SSKProfiler.h"
+#include "SSKSIMD.h"
+
+enum { SSKBenchNameLength = 128 };
+
+/// Calibration stops once a batch runs this long, then sizes the samples from it.
+static const double kSSKBenchCalibrationNs = 5.0e6;
+/// Rise in allocations per operation over the baseline that counts as a regression.
+static const double kSSKBenchAllocationSlack = 0.01;
+
+#ifdef SSK_BENCH_COUNT_ALLOCATIONS
+
+// Linked with `-Wl,--wrap=malloc,...` (GNU ld), so every allocation the core
+// library makes goes through these first. Relaxed counters: task pool
+// workers may allocate while the main thread reads them between samples.
+
+static atomic_uint_fast64_t SSKBenchAllocationCount;
+static atomic_uint_fast64_t SSKBenchAllocationBytes;
+
+static void SSKBenchCountAllocation(size_t size) {
+    atomic_fetch_add_explicit(&SSKBenchAllocationCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&SSKBenchAllocationBytes, size, memory_order_relaxed);
+}
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+int __real_posix_memalign(void **pointer, size_t alignment, size_t size);
+void *__real_aligned_alloc(size_t alignment, size_t size);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *pointer, size_t size);
+int __wrap_posix_memalign(void **pointer, size_t alignment, size_t size);
+void *__wrap_aligned_alloc(size_t alignment, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    SSKBenchCountAllocation(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    SSKBenchCountAllocation(count * size);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    SSKBenchCountAllocation(size);
+    return __real_realloc(pointer, size);
+}
+
+int __wrap_posix_memalign(void **pointer, size_t alignment, size_t size) {
+    SSKBenchCountAllocation(size);
+    return __real_posix_memalign(pointer, alignment, size);
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size) {
+    SSKBenchCountAllocation(size);
+    return __real_aligned_alloc(alignment, size);
+}
+
+bool SSKBenchAllocations(uint64_t *count, uint64_t *bytes) {
+    *count = atomic_load_explicit(&SSKBenchAllocationCount, memory_order_relaxed);
+    *bytes = atomic_load_explicit(&SSKBenchAllocationBytes, memory_order_relaxed);
+    return true;
+}
+
+#else
+
+bool SSKBenchAllocations(uint64_t *count, uint64_t *bytes) {
+    *count = 0;
+    *bytes = 0;
+    return false;
+}
+
+#endif
+
+typedef struct {
+    char name[SSKBenchNameLength];
+    double nsPerOp;
+    double allocationsPerOp;
+    bool hasAllocations;
+} SSKBenchBaselineEntry;
+
+typedef struct {
+    SSKBenchBaselineEntry *entries;
+    uint32_t count;
+} SSKBenchBaseline;
+
+typedef struct {
+    char name[SSKBenchNameLength];
+    const SSKBenchScenario *scenario;
+    bool failed;
+    uint64_t iterations;
+    uint64_t itemsPerOp;
+    double nsPerOp;
+    double minNsPerOp;
+    double maxNsPerOp;
+    double itemsPerSecond;
+    bool hasAllocations;
+    double allocationsPerOp;
+    double bytesPerOp;
+    const SSKBenchBaselineEntry *baseline;
+    double change;
+    bool regressed;
+} SSKBenchResult;
+
+SSKBenchOptions SSKBenchOptionsDefault(void) {
+    SSKBenchOptions options = {NULL, NULL, NULL, NULL, 10.0, 300.0, 5, false};
+    return options;
+}
+
+static void SSKBenchPrintUsage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--filter TEXT] [--json PATH|-] [--baseline PATH] [--threshold PERCENT]\n"
+            "          [--min-time MS] [--repeat N] [--label TEXT] [--list]\n",
+            program);
+}
+
+bool SSKBenchParseOptions(int argc, char **argv, SSKBenchOptions *options) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--list") == 0) {
+            options->list = true;
+            continue;
+        }
+        if (!value) {
+            SSKBenchPrintUsage(argv[0]);
+            return false;
+        }
+        if (strcmp(arg, "--filter") == 0) {
+            options->filter = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            options->jsonPath = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            options->baselinePath = value;
+        } else if (strcmp(arg, "--label") == 0) {
+            options->label = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            options->threshold = strtod(value, NULL);
+        } else if (strcmp(arg, "--min-time") == 0) {
+            options->minTimeMs = strtod(value, NULL);
+        } else if (strcmp(arg, "--repeat") == 0) {
+            options->repeats = (uint32_t)strtoul(value, NULL, 10);
+        } else {
+            SSKBenchPrintUsage(argv[0]);
+            return false;
+        }
+        i++;
+    }
+    if (options->repeats == 0) { options->repeats = 1; }
+    if (!(options->minTimeMs > 0.0)) { options->minTimeMs = 1.0; }
+    if (!(options->threshold >= 0.0)) { options->threshold = 0.0; }
+    return true;
+}
+
+static void SSKBenchFormatName(const SSKBenchScenario *scenario, char *name) {
+    const SSKBenchParams *params = &scenario->params;
+    int length = snprintf(name, SSKBenchNameLength, "%s", scenario->name);
+    if (params->count > 0 && length < SSKBenchNameLength) {
+        length += snprintf(name + length, (size_t)(SSKBenchNameLength - length), "/count=%u", params->count);
+    }
+    if (params->emitters > 0 && length < SSKBenchNameLength) {
+        length += snprintf(name + length, (size_t)(SSKBenchNameLength - length), "/emitters=%u", params->emitters);
+    }
+    if (params->width > 0 && length < SSKBenchNameLength) {
+        snprintf(name + length, (size_t)(SSKBenchNameLength - length), "/%ux%u", params->width, params->height);
+    }
+}
+
+static int SSKBenchCompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t SSKBenchTimeBatch(const SSKBenchScenario *scenario, void *state, uint64_t iterations) {
+    uint64_t start = SSKProfilerNow();
+    scenario->run(state, iterations);
+    uint64_t elapsed = SSKProfilerNow() - start;
+    return elapsed > 0 ? elapsed : 1;
+}
+
+/// Doubles the batch until it runs long enough to time, then splits the
+/// measuring time into `repeats` samples of equal iteration counts. The
+/// median sample is the headline figure; min and max show the spread.
+static void SSKBenchMeasure(const SSKBenchScenario *scenario, const SSKBenchOptions *options, SSKBenchResult *result) {
+    uint64_t itemsPerOp = 0;
+    void *state = scenario->setup(&scenario->params, &itemsPerOp);
+    if (!state) {
+        result->failed = true;
+        return;
+    }
+
+    uint64_t iterations = 1;
+    uint64_t elapsed = SSKBenchTimeBatch(scenario, state, iterations);
+    while ((double)elapsed < kSSKBenchCalibrationNs && iterations < (1ull << 40)) {
+        iterations *= 2;
+        elapsed = SSKBenchTimeBatch(scenario, state, iterations);
+    }
+    double sampleNs = options->minTimeMs * 1.0e6 / options->repeats;
+    double perOp = (double)elapsed / (double)iterations;
+    iterations = (uint64_t)fmax(1.0, ceil(sampleNs / perOp));
+
+    double *samples = malloc(options->repeats * sizeof(double));
+    if (!samples) {
+        scenario->teardown(state);
+        result->failed = true;
+        return;
+    }
+    uint64_t allocationsBefore = 0;
+    uint64_t bytesBefore = 0;
+    result->hasAllocations = SSKBenchAllocations(&allocationsBefore, &bytesBefore);
+    for (uint32_t r = 0; r < options->repeats; r++) {
+        samples[r] = (double)SSKBenchTimeBatch(scenario, state, iterations) / (double)iterations;
+    }
+    uint64_t allocationsAfter = 0;
+    uint64_t bytesAfter = 0;
+    SSKBenchAllocations(&allocationsAfter, &bytesAfter);
+    scenario->teardown(state);
+
+    qsort(samples, options->repeats, sizeof(double), SSKBenchCompareDoubles);
+    uint32_t middle = options->repeats / 2;
+    result->nsPerOp = options->repeats % 2 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+    result->minNsPerOp = samples[0];
+    result->maxNsPerOp = samples[options->repeats - 1];
+    free(samples);
+
+    double totalOps = (double)iterations * options->repeats;
+    result->iterations = iterations;
+    result->itemsPerOp = itemsPerOp;
+    result->itemsPerSecond = (double)itemsPerOp * 1.0e9 / result->nsPerOp;
+    result->allocationsPerOp = (double)(allocationsAfter - allocationsBefore) / totalOps;
+    result->bytesPerOp = (double)(bytesAfter - bytesBefore) / totalOps;
+}
+
+/// Reads the JSON written by `SSKBenchWriteReport`: every result's `name`
+/// followed by its `nsPerOp` and `allocationsPerOp`. Not a general JSON parser.
+static bool SSKBenchLoadBaseline(const char *path, SSKBenchBaseline *baseline) {
+    FILE *file = fopen(path, "rb");
+    if (!file) { return false; }
+    char *text = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) { length = ftell(file); }
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) { text = malloc((size_t)length + 1); }
+    bool ok = text && fread(text, 1, (size_t)length, file) == (size_t)length;
+    fclose(file);
+    if (!ok) {
+        free(text);
+        return false;
+    }
+    text[length] = '\0';
+
+    uint32_t capacity = 0;
+    for (const char *c = strstr(text, "\"name\""); c; c = strstr(c + 1, "\"name\"")) { capacity++; }
+    baseline->entries = calloc(capacity > 0 ? capacity : 1, sizeof(SSKBenchBaselineEntry));
+    baseline->count = 0;
+    if (!baseline->entries) {
+        free(text);
+        return false;
+    }
+
+    const char *cursor = strstr(text, "\"name\"");
+    while (cursor) {
+        const char *next = strstr(cursor + 1, "\"name\"");
+        const char *open = strchr(cursor + 6, '"');
+        const char *close = open ? strchr(open + 1, '"') : NULL;
+        const char *ns = strstr(cursor, "\"nsPerOp\"");
+        if (close && ns && (!next || ns < next) && close - open - 1 < SSKBenchNameLength) {
+            SSKBenchBaselineEntry *entry = &baseline->entries[baseline->count++];
+            memcpy(entry->name, open + 1, (size_t)(close - open - 1));
+            entry->nsPerOp = strtod(strchr(ns, ':') + 1, NULL);
+            const char *allocations = strstr(cursor, "\"allocationsPerOp\"");
+            if (allocations && (!next || allocations < next)) {
+                char *end = NULL;
+                const char *value = strchr(allocations, ':') + 1;
+                entry->allocationsPerOp = strtod(value, &end);
+                entry->hasAllocations = end != value;
+            }
+        }
+        cursor = next;
+    }
+    free(text);
+    return true;
+}
+
+static const SSKBenchBaselineEntry *SSKBenchFindBaseline(const SSKBenchBaseline *baseline, const char *name) {
+    for (uint32_t i = 0; i < baseline->count; i++) {
+        if (strcmp(baseline->entries[i].name, name) == 0) { return &baseline->entries[i]; }
+    }
+    return NULL;
+}
+
+static void SSKBenchCompare(SSKBenchResult *result, const SSKBenchBaseline *baseline, double threshold) {
+    result->baseline = SSKBenchFindBaseline(baseline, result->name);
+    if (result->failed || !result->baseline || !(result->baseline->nsPerOp > 0.0)) { return; }
+    result->change = (result->nsPerOp / result->baseline->nsPerOp - 1.0) * 100.0;
+    result->regressed = result->change > threshold;
+    if (result->hasAllocations && result->baseline->hasAllocations &&
+        result->allocationsPerOp > result->baseline->allocationsPerOp + kSSKBenchAllocationSlack) {
+        result->regressed = true;
+    }
+}
+
+static void SSKBenchFormatRate(double rate, char *text, size_t length) {
+    static const char *suffixes[] = {"", "k", "M", "G", "T"};
+    uint32_t s = 0;
+    while (rate >= 1000.0 && s < 4) {
+        rate /= 1000.0;
+        s++;
+    }
+    snprintf(text, length, "%.3g%s", rate, suffixes[s]);
+}
+
+static void SSKBenchPrintResult(FILE *out, const SSKBenchResult *result) {
+    if (result->failed) {
+        fprintf(out, "%-48s FAILED (setup)\n", result->name);
+        return;
+    }
+    char rate[32];
+    SSKBenchFormatRate(result->itemsPerSecond, rate, sizeof rate);
+    char allocations[32] = "-";
+    if (result->hasAllocations) { snprintf(allocations, sizeof allocations, "%.2f", result->allocationsPerOp); }
+    char comparison[64] = "";
+    if (result->baseline) {
+        snprintf(comparison, sizeof comparison, "%+7.1f%%%s", result->change, result->regressed ? "  REGRESSED" : "");
+    }
+    fprintf(out, "%-48s %14.1f %9s %s/s %9s  %s\n", result->name, result->nsPerOp, rate, result->scenario->unit,
+            allocations, comparison);
+}
+
+static void SSKBenchWriteString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void SSKBenchWriteNumberOrNull(FILE *out, bool present, double value) {
+    if (present && isfinite(value)) {
+        fprintf(out, "%.6g", value);
+    } else {
+        fputs("null", out);
+    }
+}
+
+static void SSKBenchWriteReport(FILE *out, const SSKBenchResult *results, uint32_t count,
+                                const SSKBenchOptions *options) {
+    struct utsname system;
+    bool hasSystem = uname(&system) == 0;
+    char timestamp[32] = "";
+    time_t now = time(NULL);
+    struct tm utc;
+    if (gmtime_r(&now, &utc)) { strftime(timestamp, sizeof timestamp, "%Y-%m-%dT%H:%M:%SZ", &utc); }
+
+    fputs("{\n  \"suite\": \"ScreenSaverKit\",\n  \"label\": ", out);
+    SSKBenchWriteString(out, options->label ? options->label : "");
+    fputs(",\n  \"timestamp\": ", out);
+    SSKBenchWriteString(out, timestamp);
+    fputs(",\n  \"system\": ", out);
+    SSKBenchWriteString(out, hasSystem ? system.sysname : "");
+    fputs(",\n  \"machine\": ", out);
+    SSKBenchWriteString(out, hasSystem ? system.machine : "");
+    fputs(",\n  \"simd\": ", out);
+    SSKBenchWriteString(out, SSKSIMDLevelName(SSKSIMDBestLevel()));
+    fprintf(out, ",\n  \"threshold\": %.6g,\n  \"results\": [", options->threshold);
+    for (uint32_t i = 0; i < count; i++) {
+        const SSKBenchResult *result = &results[i];
+        const SSKBenchParams *params = &result->scenario->params;
+        fputs(i > 0 ? ",\n    {\"name\": " : "\n    {\"name\": ", out);
+        SSKBenchWriteString(out, result->name);
+        fputs(", \"unit\": ", out);
+        SSKBenchWriteString(out, result->scenario->unit);
+        fprintf(out, ",\n     \"params\": {\"count\": %u, \"emitters\": %u, \"width\": %u, \"height\": %u}",
+                params->count, params->emitters, params->width, params->height);
+        fprintf(out, ",\n     \"failed\": %s", result->failed ? "true" : "false");
+        if (!result->failed) {
+            fprintf(out, ", \"iterations\": %llu, \"itemsPerOp\": %llu",
+                    (unsigned long long)result->iterations, (unsigned long long)result->itemsPerOp);
+            fprintf(out, ",\n     \"nsPerOp\": %.6g, \"minNsPerOp\": %.6g, \"maxNsPerOp\": %.6g, \"itemsPerSecond\": %.6g",
+                    result->nsPerOp, result->minNsPerOp, result->maxNsPerOp, result->itemsPerSecond);
+            fputs(",\n     \"allocationsPerOp\": ", out);
+            SSKBenchWriteNumberOrNull(out, result->hasAllocations, result->allocationsPerOp);
+            fputs(", \"bytesPerOp\": ", out);
+            SSKBenchWriteNumberOrNull(out, result->hasAllocations, result->bytesPerOp);
+        }
+        if (result->baseline) {
+            fprintf(out, ",\n     \"baselineNsPerOp\": %.6g, \"change\": ", result->baseline->nsPerOp);
+            SSKBenchWriteNumberOrNull(out, !result->failed, result->change);
+            fprintf(out, ", \"regressed\": %s", result->regressed ? "true" : "false");
+        }
+        fputc('}', out);
+    }
+    fputs("\n  ]\n}\n", out);
+}
+
+int SSKBenchRunSuite(const SSKBenchScenario *scenarios, uint32_t scenarioCount, const SSKBenchOptions *options) {
+    bool jsonToStdout = options->jsonPath && strcmp(options->jsonPath, "-") == 0;
+    FILE *table = jsonToStdout ? stderr : stdout;
+
+    SSKBenchResult *results = calloc(scenarioCount > 0 ? scenarioCount : 1, sizeof(SSKBenchResult));
+    if (!results) { return 2; }
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < scenarioCount; i++) {
+        SSKBenchResult *result = &results[count];
+        SSKBenchFormatName(&scenarios[i], result->name);
+        if (options->filter && !strstr(result->name, options->filter)) { continue; }
+        result->scenario = &scenarios[i];
+        count++;
+    }
+    if (options->list) {
+        for (uint32_t i = 0; i < count; i++) { fprintf(table, "%s\n", results[i].name); }
+        free(results);
+        return 0;
+    }
+
+    SSKBenchBaseline baseline = {NULL, 0};
+    if (options->baselinePath && !SSKBenchLoadBaseline(options->baselinePath, &baseline)) {
+        fprintf(stderr, "cannot read baseline %s\n", options->baselinePath);
+        free(results);
+        return 2;
+    }
+
+    fprintf(table, "%-48s %14s %9s %-12s %9s  %s\n", "scenario", "ns/op", "rate", "", "allocs/op",
+            options->baselinePath ? "vs baseline" : "");
+    uint32_t failed = 0;
+    uint32_t regressed = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        SSKBenchResult *result = &results[i];
+        SSKBenchMeasure(result->scenario, options, result);
+        SSKBenchCompare(result, &baseline, options->threshold);
+        SSKBenchPrintResult(table, result);
+        fflush(table);
+        failed += result->failed;
+        regressed += result->regressed;
+    }
+
+    int status = failed > 0 || regressed > 0 ? 1 : 0;
+    if (options->baselinePath) {
+        fprintf(table, "%u of %u scenarios regressed beyond %.1f%% of %s\n", regressed, count, options->threshold,
+                options->baselinePath);
+    }
+    if (options->jsonPath) {
+        FILE *out = jsonToStdout ? stdout : fopen(options->jsonPath, "w");
+        if (out) {
+            SSKBenchWriteReport(out, results, count, options);
+            if (!jsonToStdout && fclose(out) != 0) { out = NULL; }
+        }
+        if (!out) {
+            fprintf(stderr, "cannot write %s\n", options->jsonPath);
+            status = 2;
+        }
+    }
+    free(baseline.entries);
+    free(results);
+    return status;
+}
@@ -0,0 +1,78 @@
+#ifndef SSKBenchHarness_h
+#define SSKBenchHarness_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Knobs a scenario reads; unused ones are 0 and left out of the report.
+typedef struct {
+    /// Particles, stars, samples or textures per operation.
+    uint32_t count;
+    /// Emitters or trails sharing `count`.
+    uint32_t emitters;
+    /// Image size of the blur and bloom scenarios.
+    uint32_t width;
+    uint32_t height;
+} SSKBenchParams;
+
+/// One timed operation at one parameter set.
+///
+/// `setup` builds everything the operation needs and returns it (NULL fails
+/// the scenario); it also reports how many items one operation processes,
+/// for the throughput column. `run` performs `iterations` operations back to
+/// back. Only `run` is timed and only its allocations are counted, so hot
+/// paths that are meant to be allocation free show up as 0.
+typedef struct {
+    const char *name;
+    /// Counted by the throughput column, e.g. "particles" or "pixels".
+    const char *unit;
+    SSKBenchParams params;
+    void *(*setup)(const SSKBenchParams *params, uint64_t *itemsPerOp);
+    void (*run)(void *state, uint64_t iterations);
+    void (*teardown)(void *state);
+} SSKBenchScenario;
+
+typedef struct {
+    /// Only scenarios whose full name contains this substring run.
+    const char *filter;
+    /// JSON report path; "-" writes it to standard output and the table to
+    /// standard error.
+    const char *jsonPath;
+    /// Report of an earlier run to compare against.
+    const char *baselinePath;
+    /// Recorded in the report, e.g. the commit the suite was built from.
+    const char *label;
+    /// Slowdown in percent of the median time per operation that counts as
+    /// a regression.
+    double threshold;
+    /// Time spent measuring each scenario, split across `repeats` samples.
+    double minTimeMs;
+    uint32_t repeats;
+    bool list;
+} SSKBenchOptions;
+
+/// Threshold 10%, 300 ms per scenario in 5 samples.
+SSKBenchOptions SSKBenchOptionsDefault(void);
+
+/// Parses `--filter`, `--json`, `--baseline`, `--threshold`, `--min-time`,
+/// `--repeat`, `--label` and `--list` into `options`. Prints usage and
+/// returns false on anything else.
+bool SSKBenchParseOptions(int argc, char **argv, SSKBenchOptions *options);
+
+/// Allocation calls and bytes requested by the process so far. Returns false
+/// when the build does not count them (see `SSK_BENCH_COUNT_ALLOCATIONS`).
+bool SSKBenchAllocations(uint64_t *count, uint64_t *bytes);
+
+/// Runs every scenario that passes the filter, prints a table, writes the
+/// JSON report and compares against the baseline. Returns the process exit
+/// status: 1 when a scenario failed or regressed, 2 when the baseline or
+/// report could not be read or written, 0 otherwise.
+int SSKBenchRunSuite(const SSKBenchScenario *scenarios, uint32_t scenarioCount, const SSKBenchOptions *options);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKBenchHarness_h */
@@ -0,0 +1,493 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Headless benchmark suite for the portable hot paths.
+//
+// Every scenario drives the same core entry points the savers call each
+// frame, at a few parameter sets, and reports the median time per operation,
+// throughput and allocations per operation as a table and optionally JSON.
+// Everything runs on the calling thread, so results compare across machines
+// with different core counts; a report from an earlier commit can be passed
+// as the baseline to flag regressions.
+//
+//   make -C ScreenSaverKit/Core suite
+//   make -C ScreenSaverKit/Core suite SUITE_ARGS="--json base.json"
+//   make -C ScreenSaverKit/Core suite SUITE_ARGS="--baseline base.json --threshold 10"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "SSKBenchHarness.h"
+#include "SSKBlur.h"
+#include "SSKPalette.h"
+#include "SSKParticleEmitter.h"
+#include "SSKParticleInstances.h"
+#include "SSKRandom.h"
+#include "SSKStarfield.h"
+#include "SSKTexturePool.h"
+#include "SSKTrail.h"
+
+static const uint64_t kSSKBenchSeed = 0x5eed5eedull;
+
+static const SSKParticleSimParams kSSKBenchSimParams = {{0.0f, -98.0f}, 1.0f / 60.0f, 0.05f};
+
+// MARK: - Particles
+
+typedef struct {
+    SSKParticleCore *core;
+    SSKParticleEmitter *emitters;
+    uint32_t emitterCount;
+    uint32_t perEmitter;
+    SSKRandom random;
+    SSKParticleInstanceStyle style;
+    SSKParticleInstance *instances;
+} SSKBenchParticles;
+
+static SSKParticleEmitter SSKBenchEmitter(uint32_t index, float maxLife) {
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.origin = SSKFloat2Make(160.0f + 97.0f * (float)(index % 16), 120.0f + 61.0f * (float)(index / 16 % 16));
+    emitter.originJitter = SSKFloat2Make(4.0f, 4.0f);
+    emitter.angle = SSKFloatRangeMake(0.0f, 6.2831853f);
+    emitter.speed = SSKFloatRangeMake(20.0f, 180.0f);
+    emitter.maxLife = SSKFloatRangeMake(maxLife, maxLife);
+    emitter.size = SSKFloatRangeMake(2.0f, 6.0f);
+    emitter.sizeOverLife = SSKFloat2Make(1.0f, 0.2f);
+    emitter.rotationVelocity = SSKFloatRangeMake(-2.0f, 2.0f);
+    emitter.colorStart = SSKFloat4Make(1.0f, 0.6f, 0.2f, 1.0f);
+    emitter.colorEnd = SSKFloat4Make(0.2f, 0.4f, 1.0f, 1.0f);
+    emitter.behaviorFlags = SSKParticleCoreBehaviorFadeAlpha | SSKParticleCoreBehaviorFadeSize;
+    return emitter;
+}
+
+static void SSKBenchParticlesTeardown(void *state) {
+    SSKBenchParticles *particles = state;
+    SSKParticleCoreDestroy(particles->core);
+    free(particles->emitters);
+    free(particles->instances);
+    free(particles);
+}
+
+/// A core with `count` slots shared by `emitters` emitters. With `filled`,
+/// every slot is emitted with a life long enough to outlast the run.
+static SSKBenchParticles *SSKBenchParticlesCreate(const SSKBenchParams *params, float maxLife, bool filled) {
+    SSKBenchParticles *particles = calloc(1, sizeof(SSKBenchParticles));
+    if (!particles) { return NULL; }
+    particles->emitterCount = params->emitters > 0 ? params->emitters : 1;
+    particles->perEmitter = params->count / particles->emitterCount;
+    particles->random = SSKRandomMake(kSSKBenchSeed);
+    particles->style = SSKParticleInstanceStyleDefault();
+    particles->core = SSKParticleCoreCreate(params->count);
+    particles->emitters = calloc(particles->emitterCount, sizeof(SSKParticleEmitter));
+    particles->instances = calloc(params->count, sizeof(SSKParticleInstance));
+    if (!particles->core || !particles->emitters || !particles->instances) {
+        SSKBenchParticlesTeardown(particles);
+        return NULL;
+    }
+    for (uint32_t e = 0; e < particles->emitterCount; e++) {
+        particles->emitters[e] = SSKBenchEmitter(e, maxLife);
+        if (filled) {
+            SSKParticleCoreEmit(particles->core, &particles->emitters[e], particles->perEmitter, &particles->random,
+                                NULL);
+        }
+    }
+    return particles;
+}
+
+static void *SSKBenchParticlesSetupFilled(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchParticles *particles = SSKBenchParticlesCreate(params, 1.0e9f, true);
+    if (particles) { *itemsPerOp = particles->core->aliveCount; }
+    return particles;
+}
+
+static void SSKBenchParticlesAdvance(void *state, uint64_t iterations) {
+    SSKBenchParticles *particles = state;
+    for (uint64_t i = 0; i < iterations; i++) { SSKParticleCoreAdvance(particles->core, &kSSKBenchSimParams); }
+}
+
+static void SSKBenchParticlesWriteInstances(void *state, uint64_t iterations) {
+    SSKBenchParticles *particles = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKParticleCoreWriteInstances(particles->core, &particles->style, particles->instances,
+                                      particles->core->capacity);
+    }
+}
+
+static void *SSKBenchParticlesSetupEmpty(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchParticles *particles = SSKBenchParticlesCreate(params, 0.5f, false);
+    if (particles) { *itemsPerOp = (uint64_t)particles->perEmitter * particles->emitterCount; }
+    return particles;
+}
+
+/// One burst per emitter, then a step long enough to retire the whole batch,
+/// so each operation spawns and recycles `count` particles.
+static void SSKBenchParticlesSpawn(void *state, uint64_t iterations) {
+    SSKBenchParticles *particles = state;
+    SSKParticleSimParams params = kSSKBenchSimParams;
+    params.dt = 1.0f;
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (uint32_t e = 0; e < particles->emitterCount; e++) {
+            SSKParticleCoreEmit(particles->core, &particles->emitters[e], particles->perEmitter, &particles->random,
+                                NULL);
+        }
+        SSKParticleCoreAdvance(particles->core, &params);
+    }
+}
+
+// MARK: - Palette
+
+typedef struct {
+    SSKPaletteLUT lut;
+    float *progress;
+    SSKFloat4 *colors;
+    uint32_t count;
+} SSKBenchPalette;
+
+static void SSKBenchPaletteTeardown(void *state) {
+    SSKBenchPalette *palette = state;
+    free(palette->progress);
+    free(palette->colors);
+    free(palette);
+}
+
+static void *SSKBenchPaletteSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchPalette *palette = calloc(1, sizeof(SSKBenchPalette));
+    if (!palette) { return NULL; }
+    palette->count = params->count;
+    palette->progress = malloc(params->count * sizeof(float));
+    palette->colors = malloc(params->count * sizeof(SSKFloat4));
+    if (!palette->progress || !palette->colors) {
+        SSKBenchPaletteTeardown(palette);
+        return NULL;
+    }
+    const SSKFloat4 stops[] = {
+        {0.05f, 0.02f, 0.20f, 1.0f}, {0.60f, 0.10f, 0.55f, 1.0f}, {1.00f, 0.45f, 0.20f, 1.0f},
+        {1.00f, 0.90f, 0.55f, 1.0f}, {0.20f, 0.75f, 0.90f, 1.0f},
+    };
+    SSKPaletteLUTBuild(&palette->lut, stops, 5, SSKPaletteWrapLoop, SSKPaletteEncodingSRGB);
+    SSKRandom random = SSKRandomMake(kSSKBenchSeed);
+    for (uint32_t i = 0; i < params->count; i++) { palette->progress[i] = SSKRandomNextRange(&random, -2.0f, 2.0f); }
+    *itemsPerOp = params->count;
+    return palette;
+}
+
+static void SSKBenchPaletteSample(void *state, uint64_t iterations) {
+    SSKBenchPalette *palette = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKPaletteLUTSampleBatch(&palette->lut, palette->progress, palette->colors, palette->count);
+    }
+}
+
+// MARK: - Blur and bloom
+
+typedef struct {
+    SSKBlurContext context;
+    SSKFloatImage image;
+    SSKBloomParams bloom;
+} SSKBenchImage;
+
+static void SSKBenchImageTeardown(void *state) {
+    SSKBenchImage *image = state;
+    SSKBlurContextDestroy(&image->context);
+    free(image->image.pixels);
+    free(image);
+}
+
+/// A noisy image with sparse highlights above the bloom threshold. The first
+/// operation in `setup` grows the context's scratch buffers, as a renderer's
+/// first frame does.
+static SSKBenchImage *SSKBenchImageCreate(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchImage *image = calloc(1, sizeof(SSKBenchImage));
+    if (!image) { return NULL; }
+    SSKBlurContextInit(&image->context);
+    size_t pixels = (size_t)params->width * params->height;
+    image->image = (SSKFloatImage){malloc(pixels * sizeof(SSKFloat4)), params->width, params->height, params->width};
+    if (!image->image.pixels) {
+        SSKBenchImageTeardown(image);
+        return NULL;
+    }
+    SSKRandom random = SSKRandomMake(kSSKBenchSeed);
+    for (size_t i = 0; i < pixels; i++) {
+        float v = SSKRandomNextUnit(&random);
+        v = v > 0.98f ? 1.0f : v * 0.4f;
+        image->image.pixels[i] = SSKFloat4Make(v, v * 0.8f, v * 0.6f, 1.0f);
+    }
+    *itemsPerOp = pixels;
+    return image;
+}
+
+static void *SSKBenchBlurSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchImage *image = SSKBenchImageCreate(params, itemsPerOp);
+    if (image && !SSKBlurGaussian(&image->context, NULL, &image->image, &image->image, 3.0f)) {
+        SSKBenchImageTeardown(image);
+        return NULL;
+    }
+    return image;
+}
+
+static void SSKBenchBlur(void *state, uint64_t iterations) {
+    SSKBenchImage *image = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKBlurGaussian(&image->context, NULL, &image->image, &image->image, 3.0f);
+    }
+}
+
+static void *SSKBenchBloomSetup(const SSKBenchParams *params, uint64_t *itemsPerOp, SSKBloomMode mode) {
+    SSKBenchImage *image = SSKBenchImageCreate(params, itemsPerOp);
+    if (!image) { return NULL; }
+    image->bloom = (SSKBloomParams){0.8f, 0.6f, 3.0f, mode == SSKBloomModeMipChain ? 5 : 0, mode};
+    if (!SSKBloomApply(&image->context, NULL, &image->image, &image->bloom)) {
+        SSKBenchImageTeardown(image);
+        return NULL;
+    }
+    return image;
+}
+
+static void *SSKBenchBloomGaussianSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    return SSKBenchBloomSetup(params, itemsPerOp, SSKBloomModeGaussian);
+}
+
+static void *SSKBenchBloomMipChainSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    return SSKBenchBloomSetup(params, itemsPerOp, SSKBloomModeMipChain);
+}
+
+static void SSKBenchBloom(void *state, uint64_t iterations) {
+    SSKBenchImage *image = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKBloomApply(&image->context, NULL, &image->image, &image->bloom);
+    }
+}
+
+// MARK: - Starfield
+
+typedef struct {
+    SSKStarfield *field;
+    SSKStarfieldProjection projection;
+    SSKParticleInstance *instances;
+    uint32_t maxInstances;
+    uint32_t frame;
+} SSKBenchStarfield;
+
+static void SSKBenchStarfieldTeardown(void *state) {
+    SSKBenchStarfield *starfield = state;
+    SSKStarfieldDestroy(starfield->field);
+    free(starfield->instances);
+    free(starfield);
+}
+
+/// The Starfield demo's projection onto a 1920x1080 view.
+static void *SSKBenchStarfieldSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchStarfield *starfield = calloc(1, sizeof(SSKBenchStarfield));
+    if (!starfield) { return NULL; }
+    starfield->field = SSKStarfieldCreate(params->count, kSSKBenchSeed);
+    starfield->maxInstances = params->count * SSKStarfieldMaxInstancesPerStar;
+    starfield->instances = calloc(starfield->maxInstances, sizeof(SSKParticleInstance));
+    if (!starfield->field || !starfield->instances) {
+        SSKBenchStarfieldTeardown(starfield);
+        return NULL;
+    }
+    float width = 1920.0f;
+    float height = 1080.0f;
+    SSKStarfieldProjection *projection = &starfield->projection;
+    projection->center = SSKFloat2Make(width * 0.5f, height * 0.5f);
+    projection->scale = SSKFloat2Make(1.35f * (width / height) * 0.25f * width, -1.35f * 0.25f * height);
+    projection->boundsMin = SSKFloat2Make(-50.0f, -50.0f);
+    projection->boundsMax = SSKFloat2Make(width + 50.0f, height + 50.0f);
+    projection->baseRadius = 1.8f;
+    projection->sizeScale = 0.25f;
+    projection->tail = 0.65f;
+    *itemsPerOp = params->count;
+    return starfield;
+}
+
+static void SSKBenchStarfieldStep(void *state, uint64_t iterations) {
+    SSKBenchStarfield *starfield = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        float phase = (float)(starfield->frame++ % 600) / 600.0f;
+        SSKStarfieldStepParams params = {1.4f / 60.0f,
+                                         SSKFloat2Make((phase - 0.5f) * 0.01f, (0.5f - phase) * 0.006f)};
+        SSKStarfieldStep(starfield->field, &params);
+    }
+}
+
+static void SSKBenchStarfieldWriteInstances(void *state, uint64_t iterations) {
+    SSKBenchStarfield *starfield = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKStarfieldWriteInstances(starfield->field, &starfield->projection, starfield->instances,
+                                   starfield->maxInstances);
+    }
+}
+
+// MARK: - Texture pool
+
+typedef struct {
+    SSKTexturePool *pool;
+    SSKTexturePoolKey *keys;
+    void **handles;
+    uint32_t count;
+    uintptr_t nextHandle;
+} SSKBenchTexturePool;
+
+/// Handles are plain numbers; the pool never dereferences them.
+static void *SSKBenchCreateTexture(void *context, const SSKTexturePoolKey *key) {
+    (void)key;
+    SSKBenchTexturePool *texturePool = context;
+    return (void *)++texturePool->nextHandle;
+}
+
+static void SSKBenchDestroyTexture(void *context, void *handle) {
+    (void)context;
+    (void)handle;
+}
+
+static void SSKBenchTexturePoolTeardown(void *state) {
+    SSKBenchTexturePool *texturePool = state;
+    SSKTexturePoolDestroy(texturePool->pool);
+    free(texturePool->keys);
+    free(texturePool->handles);
+    free(texturePool);
+}
+
+/// An effect chain's frame: `count` intermediates at full, half and quarter
+/// resolution acquired, handed back and the frame advanced.
+static void *SSKBenchTexturePoolSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchTexturePool *texturePool = calloc(1, sizeof(SSKBenchTexturePool));
+    if (!texturePool) { return NULL; }
+    SSKTexturePoolDevice device = {texturePool, SSKBenchCreateTexture, SSKBenchDestroyTexture};
+    texturePool->pool = SSKTexturePoolCreate(&device, 256ull << 20);
+    texturePool->count = params->count;
+    texturePool->keys = calloc(params->count, sizeof(SSKTexturePoolKey));
+    texturePool->handles = calloc(params->count, sizeof(void *));
+    if (!texturePool->pool || !texturePool->keys || !texturePool->handles) {
+        SSKBenchTexturePoolTeardown(texturePool);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < params->count; i++) {
+        uint32_t shift = i % 3;
+        texturePool->keys[i] = (SSKTexturePoolKey){params->width >> shift, params->height >> shift, 115, 7, 8};
+    }
+    *itemsPerOp = params->count;
+    return texturePool;
+}
+
+static void SSKBenchTexturePoolFrame(void *state, uint64_t iterations) {
+    SSKBenchTexturePool *texturePool = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (uint32_t t = 0; t < texturePool->count; t++) {
+            texturePool->handles[t] = SSKTexturePoolAcquire(texturePool->pool, &texturePool->keys[t]);
+        }
+        for (uint32_t t = 0; t < texturePool->count; t++) {
+            SSKTexturePoolRelease(texturePool->pool, &texturePool->keys[t], texturePool->handles[t]);
+        }
+        SSKTexturePoolAdvanceFrame(texturePool->pool);
+    }
+}
+
+// MARK: - Trails
+
+typedef struct {
+    SSKTrailSet *set;
+    SSKTrailMeshParams mesh;
+    SSKTrailVertex *vertices;
+    uint32_t *indices;
+    uint32_t maxVertices;
+    uint32_t maxIndices;
+} SSKBenchTrails;
+
+static void SSKBenchTrailsTeardown(void *state) {
+    SSKBenchTrails *trails = state;
+    SSKTrailSetDestroy(trails->set);
+    free(trails->vertices);
+    free(trails->indices);
+    free(trails);
+}
+
+/// `emitters` full trails of `count` points each, wandering like SimpleLines.
+static void *SSKBenchTrailsSetup(const SSKBenchParams *params, uint64_t *itemsPerOp) {
+    SSKBenchTrails *trails = calloc(1, sizeof(SSKBenchTrails));
+    if (!trails) { return NULL; }
+    trails->set = SSKTrailSetCreate(params->emitters, params->count);
+    trails->mesh = SSKTrailMeshParamsDefault();
+    if (trails->set) {
+        trails->maxVertices = SSKTrailSetMaxVertexCount(trails->set);
+        trails->maxIndices = SSKTrailSetMaxIndexCount(trails->set);
+        trails->vertices = calloc(trails->maxVertices, sizeof(SSKTrailVertex));
+        trails->indices = calloc(trails->maxIndices, sizeof(uint32_t));
+    }
+    if (!trails->set || !trails->vertices || !trails->indices) {
+        SSKBenchTrailsTeardown(trails);
+        return NULL;
+    }
+    SSKRandom random = SSKRandomMake(kSSKBenchSeed);
+    for (uint32_t t = 0; t < params->emitters; t++) {
+        float x = SSKRandomNextRange(&random, 0.0f, 1920.0f);
+        float y = SSKRandomNextRange(&random, 0.0f, 1080.0f);
+        float heading = SSKRandomNextRange(&random, 0.0f, 6.2831853f);
+        for (uint32_t i = 0; i < params->count; i++) {
+            heading += SSKRandomNextRange(&random, -0.3f, 0.3f);
+            x += 6.0f * cosf(heading);
+            y += 6.0f * sinf(heading);
+            SSKTrailSetPush(trails->set, t, SSKFloat2Make(x, y));
+        }
+        trails->set->styles[t] = (SSKTrailStyle){SSKRandomNextRange(&random, 2.0f, 12.0f), 0.5f,
+                                                 SSKFloat4Make(1.0f, 0.8f, 0.4f, 1.0f),
+                                                 SSKFloat4Make(0.2f, 0.4f, 1.0f, 0.0f)};
+    }
+    *itemsPerOp = (uint64_t)params->emitters * params->count;
+    return trails;
+}
+
+static void SSKBenchTrailsTessellate(void *state, uint64_t iterations) {
+    SSKBenchTrails *trails = state;
+    for (uint64_t i = 0; i < iterations; i++) {
+        SSKTrailSetTessellate(trails->set, &trails->mesh, trails->vertices, trails->maxVertices, trails->indices,
+                              trails->maxIndices);
+    }
+}
+
+// MARK: - Scenarios
+
+static const SSKBenchScenario kSSKBenchScenarios[] = {
+    {"particles.advance", "particles", {4096, 0, 0, 0},
+     SSKBenchParticlesSetupFilled, SSKBenchParticlesAdvance, SSKBenchParticlesTeardown},
+    {"particles.advance", "particles", {65536, 0, 0, 0},
+     SSKBenchParticlesSetupFilled, SSKBenchParticlesAdvance, SSKBenchParticlesTeardown},
+    {"particles.advance", "particles", {262144, 0, 0, 0},
+     SSKBenchParticlesSetupFilled, SSKBenchParticlesAdvance, SSKBenchParticlesTeardown},
+    {"particles.spawn", "particles", {65536, 1, 0, 0},
+     SSKBenchParticlesSetupEmpty, SSKBenchParticlesSpawn, SSKBenchParticlesTeardown},
+    {"particles.spawn", "particles", {65536, 64, 0, 0},
+     SSKBenchParticlesSetupEmpty, SSKBenchParticlesSpawn, SSKBenchParticlesTeardown},
+    {"particles.instances", "particles", {4096, 0, 0, 0},
+     SSKBenchParticlesSetupFilled, SSKBenchParticlesWriteInstances, SSKBenchParticlesTeardown},
+    {"particles.instances", "particles", {65536, 0, 0, 0},
+     SSKBenchParticlesSetupFilled, SSKBenchParticlesWriteInstances, SSKBenchParticlesTeardown},
+    {"palette.sample", "colours", {4096, 0, 0, 0},
+     SSKBenchPaletteSetup, SSKBenchPaletteSample, SSKBenchPaletteTeardown},
+    {"blur.gaussian", "pixels", {0, 0, 640, 360},
+     SSKBenchBlurSetup, SSKBenchBlur, SSKBenchImageTeardown},
+    {"blur.gaussian", "pixels", {0, 0, 1280, 720},
+     SSKBenchBlurSetup, SSKBenchBlur, SSKBenchImageTeardown},
+    {"bloom.gaussian", "pixels", {0, 0, 1280, 720},
+     SSKBenchBloomGaussianSetup, SSKBenchBloom, SSKBenchImageTeardown},
+    {"bloom.mipchain", "pixels", {0, 0, 1280, 720},
+     SSKBenchBloomMipChainSetup, SSKBenchBloom, SSKBenchImageTeardown},
+    {"bloom.mipchain", "pixels", {0, 0, 1920, 1080},
+     SSKBenchBloomMipChainSetup, SSKBenchBloom, SSKBenchImageTeardown},
+    {"starfield.step", "stars", {4096, 0, 0, 0},
+     SSKBenchStarfieldSetup, SSKBenchStarfieldStep, SSKBenchStarfieldTeardown},
+    {"starfield.step", "stars", {65536, 0, 0, 0},
+     SSKBenchStarfieldSetup, SSKBenchStarfieldStep, SSKBenchStarfieldTeardown},
+    {"starfield.instances", "stars", {65536, 0, 0, 0},
+     SSKBenchStarfieldSetup, SSKBenchStarfieldWriteInstances, SSKBenchStarfieldTeardown},
+    {"texturepool.frame", "textures", {12, 0, 1920, 1080},
+     SSKBenchTexturePoolSetup, SSKBenchTexturePoolFrame, SSKBenchTexturePoolTeardown},
+    {"trails.tessellate", "points", {64, 64, 0, 0},
+     SSKBenchTrailsSetup, SSKBenchTrailsTessellate, SSKBenchTrailsTeardown},
+    {"trails.tessellate", "points", {256, 256, 0, 0},
+     SSKBenchTrailsSetup, SSKBenchTrailsTessellate, SSKBenchTrailsTeardown},
+};
+
+int main(int argc, char **argv) {
+    SSKBenchOptions options = SSKBenchOptionsDefault();
+    if (!SSKBenchParseOptions(argc, argv, &options)) { return 2; }
+    return SSKBenchRunSuite(kSSKBenchScenarios, sizeof kSSKBenchScenarios / sizeof kSSKBenchScenarios[0], &options);
+}
@@ -0,0 +1,39 @@
+#ifndef SSKBench_h
+#define SSKBench_h
+
+// Helpers shared by the programs in Benchmarks/. Each bench still builds
+// from its single .c file, so everything here is inline.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "SSKProfiler.h"
+
+/// Monotonic time in seconds, on the profiler's clock.
+static inline double SSKBenchNow(void) {
+    return (double)SSKProfilerNow() * 1e-9;
+}
+
+/// "ok" or "FAILED", for check lines that also print measurements.
+static inline const char *SSKBenchStatus(bool ok) {
+    return ok ? "ok" : "FAILED";
+}
+
+/// Prints a check line ("  label: ok") and passes `ok` through.
+static inline bool SSKBenchCheck(const char *label, bool ok) {
+    printf("  %s: %s\n", label, SSKBenchStatus(ok));
+    return ok;
+}
+
+/// Xorshift32 for test data; `*state` must not be 0.
+static inline uint32_t SSKBenchRandom(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+#endif /* SSKBench_h */
@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Change monitor benchmark.
+//
+// Checks the scheduling rules of the preference change monitor (back-off
+// sequence, snap back on change, coalesced notifications, parameter fix-up),
+// then replays an hour of a saver's life: three bursts of notified edits
+// from the configuration sheet and one `defaults write` that posts nothing.
+// Every edit must be picked up, notified ones at once and the silent one
+// within the back-off ceiling, with far fewer preference reads than the fixed
+// 2 s poll the view used before. The timing line is the per-frame cost of
+// asking whether a read is due.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "SSKBench.h"
+#include "SSKChangeMonitor.h"
+
+static const double SSKBenchHour = 3600.0;
+static const double SSKBenchLegacyInterval = 2.0;
+
+typedef struct {
+    double time;
+    bool notifies;
+} SSKBenchWrite;
+
+static const SSKBenchWrite SSKBenchWrites[] = {
+    {600.0, true}, {600.4, true}, {601.5, true},
+    {1500.0, true},
+    {2000.0, false},
+    {2900.0, true}, {2900.1, true},
+};
+enum { SSKBenchWriteCount = sizeof SSKBenchWrites / sizeof SSKBenchWrites[0] };
+
+static bool SSKBenchScheduling(void) {
+    SSKChangeMonitorParams params = {2.0, 60.0, 2.0};
+    SSKChangeMonitor monitor;
+    SSKChangeMonitorInit(&monitor, &params, 0.0);
+    bool ok = !SSKChangeMonitorIsCheckDue(&monitor, 1.9) && SSKChangeMonitorIsCheckDue(&monitor, 2.0);
+    ok = ok && fabs(SSKChangeMonitorDelay(&monitor, 0.5) - 1.5) < 1e-12;
+
+    // Idle polls back off: 2 4 8 16 32 60 60.
+    static const double expected[] = {4.0, 8.0, 16.0, 32.0, 60.0, 60.0};
+    double now = 2.0;
+    for (int i = 0; i < 6; i++) {
+        SSKChangeMonitorDidCheck(&monitor, now, false);
+        ok = ok && monitor.interval == expected[i] && monitor.nextPoll == now + expected[i];
+        now = monitor.nextPoll;
+    }
+
+    // Notifications coalesce into one check and leave the schedule alone when
+    // nothing changed. The last poll ran at `now - 60`.
+    double last = now - 60.0;
+    SSKChangeMonitorNotify(&monitor);
+    SSKChangeMonitorNotify(&monitor);
+    ok = ok && SSKChangeMonitorIsCheckDue(&monitor, last + 1.0) && SSKChangeMonitorDelay(&monitor, last + 1.0) == 0.0;
+    SSKChangeMonitorDidCheck(&monitor, last + 1.0, false);
+    ok = ok && !SSKChangeMonitorIsCheckDue(&monitor, last + 1.0) && monitor.nextPoll == now;
+
+    // A change snaps back to the minimum.
+    SSKChangeMonitorNotify(&monitor);
+    SSKChangeMonitorDidCheck(&monitor, last + 2.0, true);
+    ok = ok && monitor.interval == 2.0 && monitor.nextPoll == last + 4.0 && monitor.changes == 1;
+
+    // Nonsense parameters are fixed up.
+    SSKChangeMonitorParams bad = {-1.0, NAN, 0.5};
+    SSKChangeMonitorInit(&monitor, &bad, 10.0);
+    ok = ok && monitor.params.minInterval == 2.0 && monitor.params.maxInterval == 2.0 &&
+         monitor.params.growth == 1.0 && monitor.nextPoll == 12.0;
+    SSKChangeMonitorInit(&monitor, NULL, 0.0);
+    ok = ok && monitor.params.maxInterval == 60.0;
+    return ok;
+}
+
+typedef struct {
+    uint64_t checks;
+    uint32_t detected;
+    double worstNotifiedLatency;
+    double silentLatency;
+} SSKBenchHourResult;
+
+/// Wakes the saver the way the view does: at the next poll or when a
+/// notification arrives, whichever is first.
+static SSKBenchHourResult SSKBenchSimulateHour(void) {
+    SSKBenchHourResult result = {0, 0, 0.0, 0.0};
+    SSKChangeMonitor monitor;
+    SSKChangeMonitorInit(&monitor, NULL, 0.0);
+    uint32_t next = 0;
+    uint32_t pendingFrom = 0;
+    double now = 0.0;
+    while (now < SSKBenchHour) {
+        double wake = monitor.nextPoll;
+        if (next < SSKBenchWriteCount && SSKBenchWrites[next].notifies && SSKBenchWrites[next].time < wake) {
+            wake = SSKBenchWrites[next].time;
+        }
+        now = wake;
+        while (next < SSKBenchWriteCount && SSKBenchWrites[next].time <= now) {
+            if (SSKBenchWrites[next].notifies) { SSKChangeMonitorNotify(&monitor); }
+            next++;
+        }
+        if (!SSKChangeMonitorIsCheckDue(&monitor, now)) { continue; }
+        bool changed = pendingFrom < next;
+        for (; pendingFrom < next; pendingFrom++) {
+            double latency = now - SSKBenchWrites[pendingFrom].time;
+            if (SSKBenchWrites[pendingFrom].notifies) {
+                result.worstNotifiedLatency = fmax(result.worstNotifiedLatency, latency);
+            } else {
+                result.silentLatency = latency;
+            }
+            result.detected++;
+        }
+        SSKChangeMonitorDidCheck(&monitor, now, changed);
+    }
+    result.checks = monitor.checks;
+    return result;
+}
+
+int main(void) {
+    printf("SSKChangeMonitorBench\n");
+
+    bool ok = SSKBenchScheduling();
+    SSKBenchCheck("back-off, coalescing and fix-up", ok);
+
+    SSKBenchHourResult hour = SSKBenchSimulateHour();
+    uint64_t legacyChecks = (uint64_t)(SSKBenchHour / SSKBenchLegacyInterval);
+    bool hourOk = hour.detected == SSKBenchWriteCount && hour.worstNotifiedLatency == 0.0 &&
+                  hour.silentLatency <= SSKChangeMonitorParamsDefault().maxInterval &&
+                  hour.checks * 10 < legacyChecks;
+    printf("  one hour, %d edits: %llu reads (fixed 2 s poll: %llu), notified edits seen after %.1f s, "
+           "silent edit after %.1f s: %s\n",
+           (int)SSKBenchWriteCount, (unsigned long long)hour.checks, (unsigned long long)legacyChecks,
+           hour.worstNotifiedLatency, hour.silentLatency, SSKBenchStatus(hourOk));
+    ok = hourOk && ok;
+    if (!ok) { return 1; }
+
+    enum { SSKBenchFrames = 50000000 };
+    SSKChangeMonitor monitor;
+    SSKChangeMonitorInit(&monitor, NULL, 0.0);
+    uint64_t due = 0;
+    double start = SSKBenchNow();
+    for (uint32_t frame = 0; frame < SSKBenchFrames; frame++) {
+        double now = frame * (1.0 / 60.0);
+        if (SSKChangeMonitorIsCheckDue(&monitor, now)) {
+            SSKChangeMonitorDidCheck(&monitor, now, false);
+            due++;
+        }
+    }
+    double elapsed = SSKBenchNow() - start;
+    printf("  due check: %.2f ns per frame (%llu reads over %.0f simulated hours)\n",
+           elapsed * 1e9 / SSKBenchFrames, (unsigned long long)due, SSKBenchFrames / 60.0 / 3600.0);
+    return 0;
+}
@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Fixed-timestep benchmark.
+//
+// Drives one particle world through several display pacings (30, 60 and
+// 144 Hz, jittered frame times, and 60 Hz with long hitches) for the same
+// stretch of wall-clock time. With the accumulator every pacing must run the
+// same number of ticks per second (minus those dropped by the catch-up limit)
+// and, stopped at a given tick, land on bit-identical particle state. Alpha
+// must stay in [0, 1) and no frame may exceed the catch-up limit. The timing
+// table compares simulation cost per wall-clock second with the accumulator
+// against feeding the variable frame delta straight into the core.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKFixedStep.h"
+#include "SSKParticleCore.h"
+#include "SSKRandom.h"
+
+enum {
+    SSKBenchCapacity = 20000,
+    SSKBenchSpawnPerTick = 200,
+    SSKBenchMaxSteps = 5,
+};
+
+static const double SSKBenchTickRate = 60.0;
+static const double SSKBenchSeconds = 20.0;
+
+typedef struct {
+    SSKParticleCore *core;
+    SSKRandom random;
+    uint32_t *slots;
+} SSKBenchWorld;
+
+static bool SSKBenchWorldInit(SSKBenchWorld *world) {
+    world->core = SSKParticleCoreCreate(SSKBenchCapacity);
+    world->random = SSKRandomMake(42);
+    world->slots = malloc(sizeof(uint32_t) * SSKBenchCapacity);
+    return world->core && world->slots;
+}
+
+static void SSKBenchWorldDestroy(SSKBenchWorld *world) {
+    SSKParticleCoreDestroy(world->core);
+    free(world->slots);
+}
+
+/// One simulation step: a burst sized by `dt`, then the core update. Spawn
+/// counts and values depend only on the step sequence, like a saver that
+/// emits from inside its update.
+static void SSKBenchWorldStep(SSKBenchWorld *world, float dt) {
+    SSKParticleCore *core = world->core;
+    uint32_t spawned = SSKParticleCoreSpawn(core, (uint32_t)ceilf(SSKBenchSpawnPerTick * dt * 60.0f), world->slots);
+    for (uint32_t i = 0; i < spawned; i++) {
+        uint32_t slot = world->slots[i];
+        float angle = SSKRandomNextRange(&world->random, 0.0f, 6.2831853f);
+        float speed = SSKRandomNextRange(&world->random, 40.0f, 240.0f);
+        core->position[slot] = SSKFloat2Make(960.0f, 540.0f);
+        core->velocity[slot] = SSKFloat2Make(cosf(angle) * speed, sinf(angle) * speed);
+        core->maxLife[slot] = SSKRandomNextRange(&world->random, 1.0f, 3.0f);
+        core->damping[slot] = 0.3f;
+    }
+    SSKParticleSimParams params = {SSKFloat2Make(0.0f, -90.0f), dt, 0.1f};
+    SSKParticleCoreAdvance(core, &params);
+}
+
+typedef enum {
+    SSKBenchPacing30,
+    SSKBenchPacing60,
+    SSKBenchPacing144,
+    SSKBenchPacingJitter,
+    SSKBenchPacingHitches,
+    SSKBenchPacingCount,
+} SSKBenchPacing;
+
+static const char *const SSKBenchPacingNames[SSKBenchPacingCount] = {
+    "30 Hz", "60 Hz", "144 Hz", "jittered", "60 Hz + hitches",
+};
+
+/// Wall-clock length of frame `frame` for `pacing`.
+static double SSKBenchFrameTime(SSKBenchPacing pacing, uint32_t frame, SSKRandom *random) {
+    switch (pacing) {
+        case SSKBenchPacing30: return 1.0 / 30.0;
+        case SSKBenchPacing60: return 1.0 / 60.0;
+        case SSKBenchPacing144: return 1.0 / 144.0;
+        case SSKBenchPacingJitter: return SSKRandomNextRange(random, 1.0f / 240.0f, 1.0f / 20.0f);
+        case SSKBenchPacingHitches: return frame % 120 == 119 ? 0.5 : 1.0 / 60.0;
+        default: return 1.0 / 60.0;
+    }
+}
+
+typedef struct {
+    uint64_t ticks;
+    uint64_t dropped;
+    uint32_t frames;
+    uint32_t maxStepsSeen;
+    double minAlpha;
+    double maxAlpha;
+    double elapsed;             ///< Wall-clock time fed to the accumulator.
+    double simulationSeconds;   ///< CPU time spent inside world steps.
+    SSKFloat2 *position;        ///< Snapshot at `checkpointTick`.
+    SSKFloat2 *velocity;
+    bool reachedCheckpoint;
+} SSKBenchRun;
+
+static bool SSKBenchRunFixed(SSKBenchPacing pacing, uint64_t checkpointTick, SSKBenchRun *run) {
+    SSKBenchWorld world;
+    if (!SSKBenchWorldInit(&world)) { return false; }
+    SSKFixedStep clock;
+    SSKFixedStepInit(&clock, SSKBenchTickRate, SSKBenchMaxSteps);
+    SSKRandom pacingRandom = SSKRandomMake(7);
+    size_t streamBytes = sizeof(SSKFloat2) * world.core->capacity;
+    memset(run, 0, sizeof(*run));
+    run->minAlpha = 1.0;
+    run->position = malloc(streamBytes);
+    run->velocity = malloc(streamBytes);
+    if (!run->position || !run->velocity) { return false; }
+
+    double elapsed = 0.0;
+    while (elapsed < SSKBenchSeconds) {
+        double frameTime = SSKBenchFrameTime(pacing, run->frames++, &pacingRandom);
+        elapsed += frameTime;
+        uint64_t firstTick = clock.tick;
+        uint32_t steps = SSKFixedStepAccumulate(&clock, frameTime);
+        double start = SSKBenchNow();
+        for (uint32_t s = 0; s < steps; s++) {
+            SSKBenchWorldStep(&world, (float)clock.step);
+            if (firstTick + s + 1 == checkpointTick) {
+                memcpy(run->position, world.core->position, streamBytes);
+                memcpy(run->velocity, world.core->velocity, streamBytes);
+                run->reachedCheckpoint = true;
+            }
+        }
+        run->simulationSeconds += SSKBenchNow() - start;
+        if (steps > run->maxStepsSeen) { run->maxStepsSeen = steps; }
+        double alpha = SSKFixedStepAlpha(&clock);
+        if (alpha < run->minAlpha) { run->minAlpha = alpha; }
+        if (alpha > run->maxAlpha) { run->maxAlpha = alpha; }
+    }
+    run->elapsed = elapsed;
+    run->ticks = clock.tick;
+    run->dropped = clock.droppedTicks;
+    SSKBenchWorldDestroy(&world);
+    return true;
+}
+
+/// Same pacing, but one core step per frame with the raw frame delta.
+static double SSKBenchRunVariable(SSKBenchPacing pacing) {
+    SSKBenchWorld world;
+    if (!SSKBenchWorldInit(&world)) { return 0.0; }
+    SSKRandom pacingRandom = SSKRandomMake(7);
+    double elapsed = 0.0, simulation = 0.0;
+    for (uint32_t frame = 0; elapsed < SSKBenchSeconds; frame++) {
+        double frameTime = SSKBenchFrameTime(pacing, frame, &pacingRandom);
+        elapsed += frameTime;
+        double start = SSKBenchNow();
+        SSKBenchWorldStep(&world, (float)frameTime);
+        simulation += SSKBenchNow() - start;
+    }
+    SSKBenchWorldDestroy(&world);
+    return simulation;
+}
+
+static void SSKBenchRunFree(SSKBenchRun *run) {
+    free(run->position);
+    free(run->velocity);
+}
+
+int main(void) {
+    printf("SSKFixedStepBench\n");
+
+    // Edge cases of the accumulator itself.
+    SSKFixedStep clock;
+    SSKFixedStepInit(&clock, 0.0, 0);
+    bool ok = fabs(clock.step - 1.0 / 60.0) < 1e-12 && clock.maxSteps == 1;
+    ok = ok && SSKFixedStepAccumulate(&clock, -1.0) == 0 && SSKFixedStepAccumulate(&clock, NAN) == 0;
+    ok = ok && SSKFixedStepAccumulate(&clock, 10.0) == 1 && clock.droppedTicks == 599;
+    ok = ok && SSKFixedStepAlpha(&clock) >= 0.0 && SSKFixedStepAlpha(&clock) < 1.0;
+    SSKBenchCheck("accumulator edge cases", ok);
+
+    // Hitches drop ticks, so compare state halfway, which every pacing reaches.
+    const uint64_t checkpoint = (uint64_t)(SSKBenchSeconds * SSKBenchTickRate) / 2;
+    SSKBenchRun runs[SSKBenchPacingCount];
+    for (int p = 0; p < SSKBenchPacingCount; p++) {
+        ok = SSKBenchRunFixed((SSKBenchPacing)p, checkpoint, &runs[p]) && ok;
+    }
+    if (!ok) { return 1; }
+
+    size_t streamBytes = sizeof(SSKFloat2) * SSKParticleCorePaddedCapacity(SSKBenchCapacity);
+    for (int p = 0; p < SSKBenchPacingCount; p++) {
+        SSKBenchRun *run = &runs[p];
+        double expected = run->elapsed * SSKBenchTickRate;
+        double accounted = (double)(run->ticks + run->dropped);
+        bool runOk = fabs(accounted - expected) <= 1.0 && run->maxStepsSeen <= SSKBenchMaxSteps &&
+                     run->minAlpha >= 0.0 && run->maxAlpha < 1.0 && run->reachedCheckpoint &&
+                     memcmp(run->position, runs[0].position, streamBytes) == 0 &&
+                     memcmp(run->velocity, runs[0].velocity, streamBytes) == 0;
+        printf("  %-16s %5u frames, %5llu ticks + %4llu dropped, <= %u per frame, alpha [%.3f, %.3f], "
+               "state at tick %llu: %s\n",
+               SSKBenchPacingNames[p], run->frames, (unsigned long long)run->ticks,
+               (unsigned long long)run->dropped, run->maxStepsSeen, run->minAlpha, run->maxAlpha,
+               (unsigned long long)checkpoint, runOk ? "identical" : "FAILED");
+        ok = runOk && ok;
+    }
+    if (!ok) {
+        for (int p = 0; p < SSKBenchPacingCount; p++) { SSKBenchRunFree(&runs[p]); }
+        return 1;
+    }
+
+    printf("  simulation cost per wall-clock second (%u particle capacity):\n", (unsigned)SSKBenchCapacity);
+    for (int p = 0; p < SSKBenchPacingCount; p++) {
+        double variable = SSKBenchRunVariable((SSKBenchPacing)p);
+        printf("  %-16s fixed %6.2f ms/s (%5.1f ticks/s), variable dt %6.2f ms/s (%5.1f steps/s)\n",
+               SSKBenchPacingNames[p], runs[p].simulationSeconds * 1e3 / SSKBenchSeconds,
+               (double)runs[p].ticks / SSKBenchSeconds, variable * 1e3 / SSKBenchSeconds,
+               (double)runs[p].frames / SSKBenchSeconds);
+    }
+    for (int p = 0; p < SSKBenchPacingCount; p++) { SSKBenchRunFree(&runs[p]); }
+    return 0;
+}
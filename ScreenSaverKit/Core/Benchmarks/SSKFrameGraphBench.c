@@ -0,0 +1,266 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Frame graph compiler benchmark.
+//
+// Builds the graph SSKMetalRenderer records for a particle frame with blur
+// and Gaussian bloom at 5K and checks the plan: one encoder batch for the
+// particles and one shared compute batch for the six effect dispatches, the
+// barriers inside it, and two physical scratch textures instead of the four
+// transients (three would be live at once when each effect kept its own). It
+// then checks culling (dead chains, writes overwritten before being read,
+// side-effect passes), the read-before-write error and the mip chain bloom
+// levels. Random graphs are compiled and checked for overlapping tenants,
+// mismatched descriptions and more physical textures than the peak number
+// alive. Finally times Compile for the effect chain and for a 256-pass graph.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKFrameGraph.h"
+#include "SSKRandom.h"
+
+static SSKFrameGraphTextureDesc SSKBenchDesc(uint32_t width, uint32_t height) {
+    // BGRA8, read + write usage.
+    return (SSKFrameGraphTextureDesc){width, height, 80, 3, 4};
+}
+
+static uint32_t SSKBenchPass(SSKFrameGraph *graph, const char *name, SSKFrameGraphPassKind kind,
+                             SSKFrameGraphResource read0, SSKFrameGraphResource read1, SSKFrameGraphResource write) {
+    SSKFrameGraphResource reads[2] = {read0, read1};
+    uint32_t readCount = read0 == SSKFrameGraphInvalid ? 0 : (read1 == SSKFrameGraphInvalid ? 1 : 2);
+    return SSKFrameGraphAddPass(graph, name, kind, 0, reads, readCount, &write, 1, NULL);
+}
+
+/// Particles, blur and bloom on the drawable as recorded by SSKMetalRenderer.
+static void SSKBenchEffectChain(SSKFrameGraph *graph, uint32_t width, uint32_t height) {
+    const SSKFrameGraphResource none = SSKFrameGraphInvalid;
+    SSKFrameGraphTextureDesc desc = SSKBenchDesc(width, height);
+    SSKFrameGraphResource drawable = SSKFrameGraphImport(graph, "drawable", &desc, NULL);
+    SSKBenchPass(graph, "particles", SSKFrameGraphPassEncoder, none, none, drawable);
+    SSKFrameGraphResource blurScratch = SSKFrameGraphCreate(graph, "blur.scratch", &desc);
+    SSKBenchPass(graph, "blur.horizontal", SSKFrameGraphPassCompute, drawable, none, blurScratch);
+    SSKBenchPass(graph, "blur.vertical", SSKFrameGraphPassCompute, blurScratch, none, drawable);
+    SSKFrameGraphResource bright = SSKFrameGraphCreate(graph, "bloom.bright", &desc);
+    SSKBenchPass(graph, "bloom.threshold", SSKFrameGraphPassCompute, drawable, none, bright);
+    SSKFrameGraphResource bloomScratch = SSKFrameGraphCreate(graph, "blur.scratch", &desc);
+    SSKBenchPass(graph, "blur.horizontal", SSKFrameGraphPassCompute, bright, none, bloomScratch);
+    SSKFrameGraphResource blurred = SSKFrameGraphCreate(graph, "bloom.blurred", &desc);
+    SSKBenchPass(graph, "blur.vertical", SSKFrameGraphPassCompute, bloomScratch, none, blurred);
+    SSKBenchPass(graph, "bloom.composite", SSKFrameGraphPassCompute, blurred, drawable, drawable);
+}
+
+static bool SSKBenchCheckEffectChain(void) {
+    SSKFrameGraph graph;
+    SSKFrameGraphInit(&graph);
+    SSKBenchEffectChain(&graph, 5120, 2880);
+    SSKFrameGraphStatus status = SSKFrameGraphCompile(&graph);
+
+    bool ok = status == SSKFrameGraphOK && graph.orderCount == 7 && graph.batchCount == 2 &&
+              graph.physicalCount == 2 && graph.transientBytes == 2 * graph.physicalBytes;
+    for (uint32_t k = 0; k < graph.orderCount && ok; k++) {
+        const SSKFrameGraphPass *pass = &graph.passes[graph.order[k]];
+        // Every dispatch after the first depends on the one before it.
+        ok = pass->batch == (k == 0 ? 0u : 1u) && pass->barrier == (k >= 2);
+    }
+    printf("  effect chain 5K: %u passes in %u encoder batches, %u of 4 transients backed (%.1f of %.1f MB): %s\n",
+           graph.orderCount, graph.batchCount, graph.physicalCount, (double)graph.physicalBytes / 1e6,
+           (double)graph.transientBytes / 1e6, SSKBenchStatus(ok));
+    SSKFrameGraphDestroy(&graph);
+    return ok;
+}
+
+static bool SSKBenchCheckCulling(void) {
+    const SSKFrameGraphResource none = SSKFrameGraphInvalid;
+    SSKFrameGraphTextureDesc desc = SSKBenchDesc(640, 480);
+    SSKFrameGraph graph;
+    SSKFrameGraphInit(&graph);
+
+    SSKFrameGraphResource target = SSKFrameGraphImport(&graph, "target", &desc, NULL);
+    SSKFrameGraphResource unused = SSKFrameGraphCreate(&graph, "unused", &desc);
+    SSKFrameGraphResource unusedTail = SSKFrameGraphCreate(&graph, "unusedTail", &desc);
+    uint32_t early = SSKBenchPass(&graph, "early", SSKFrameGraphPassEncoder, none, none, target);
+    uint32_t clear = SSKBenchPass(&graph, "clear", SSKFrameGraphPassEncoder, none, none, target);
+    uint32_t dead = SSKBenchPass(&graph, "dead", SSKFrameGraphPassCompute, target, none, unused);
+    uint32_t deadTail = SSKBenchPass(&graph, "deadTail", SSKFrameGraphPassCompute, unused, none, unusedTail);
+    uint32_t draw = SSKBenchPass(&graph, "draw", SSKFrameGraphPassEncoder, target, none, target);
+    uint32_t capture = SSKFrameGraphAddPass(&graph, "capture", SSKFrameGraphPassEncoder,
+                                            SSKFrameGraphPassFlagSideEffect, &target, 1, NULL, 0, NULL);
+    bool ok = SSKFrameGraphCompile(&graph) == SSKFrameGraphOK;
+    ok = ok && !graph.passes[early].live && graph.passes[clear].live && !graph.passes[dead].live &&
+         !graph.passes[deadTail].live && graph.passes[draw].live && graph.passes[capture].live;
+    ok = ok && graph.physicalCount == 0 && graph.resources[unused].firstUse == SSKFrameGraphInvalid;
+    SSKBenchCheck("culling: overwritten, dead chain and side-effect passes", ok);
+
+    SSKFrameGraphReset(&graph);
+    target = SSKFrameGraphImport(&graph, "target", &desc, NULL);
+    SSKFrameGraphResource uninitialised = SSKFrameGraphCreate(&graph, "uninitialised", &desc);
+    SSKBenchPass(&graph, "reads garbage", SSKFrameGraphPassCompute, uninitialised, none, target);
+    bool rejected = SSKFrameGraphCompile(&graph) == SSKFrameGraphErrorReadBeforeWrite;
+    SSKFrameGraphResource many[SSKFrameGraphMaxPassResources + 1] = {0};
+    rejected = rejected &&
+               SSKFrameGraphAddPass(&graph, "too many", SSKFrameGraphPassCompute, 0, many,
+                                    SSKFrameGraphMaxPassResources + 1, &target, 1, NULL) == SSKFrameGraphInvalid &&
+               SSKBenchPass(&graph, "undeclared", SSKFrameGraphPassCompute, 7, none, target) == SSKFrameGraphInvalid;
+    SSKBenchCheck("read before write and malformed passes rejected", rejected);
+
+    SSKFrameGraphDestroy(&graph);
+    return ok && rejected;
+}
+
+/// Mip chain bloom after a blur: every level has its own size, so nothing
+/// aliases, and the whole chain shares one compute encoder with the blur.
+static bool SSKBenchCheckMipChain(void) {
+    const SSKFrameGraphResource none = SSKFrameGraphInvalid;
+    SSKFrameGraph graph;
+    SSKFrameGraphInit(&graph);
+    SSKFrameGraphTextureDesc desc = SSKBenchDesc(2560, 1440);
+    SSKFrameGraphResource target = SSKFrameGraphImport(&graph, "target", &desc, NULL);
+    SSKFrameGraphResource scratch = SSKFrameGraphCreate(&graph, "blur.scratch", &desc);
+    SSKBenchPass(&graph, "blur.horizontal", SSKFrameGraphPassCompute, target, none, scratch);
+    SSKBenchPass(&graph, "blur.vertical", SSKFrameGraphPassCompute, scratch, none, target);
+    enum { levels = 5 };
+    SSKFrameGraphResource chain[levels];
+    uint32_t width = desc.width, height = desc.height;
+    for (uint32_t l = 0; l < levels; l++) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        SSKFrameGraphTextureDesc levelDesc = SSKBenchDesc(width, height);
+        chain[l] = SSKFrameGraphCreate(&graph, "bloom.level", &levelDesc);
+        SSKBenchPass(&graph, "bloom.down", SSKFrameGraphPassCompute, l == 0 ? target : chain[l - 1], none, chain[l]);
+    }
+    for (uint32_t l = levels - 1; l > 0; l--) {
+        SSKBenchPass(&graph, "bloom.up", SSKFrameGraphPassCompute, chain[l], none, chain[l - 1]);
+    }
+    SSKBenchPass(&graph, "bloom.composite", SSKFrameGraphPassCompute, chain[0], target, target);
+    bool ok = SSKFrameGraphCompile(&graph) == SSKFrameGraphOK && graph.batchCount == 1 &&
+              graph.physicalCount == 1 + levels;
+    printf("  mip chain bloom: %u passes in %u batch, %u physical textures: %s\n", graph.orderCount,
+           graph.batchCount, graph.physicalCount, SSKBenchStatus(ok));
+    SSKFrameGraphDestroy(&graph);
+    return ok;
+}
+
+/// Random graph over `resourceCount` transients of three sizes plus one
+/// imported target. Reads only name textures some earlier pass wrote, so the
+/// latest writer before any live reader is live too and Compile must succeed.
+static void SSKBenchRandomGraph(SSKFrameGraph *graph, SSKRandom *random, uint32_t passCount, uint32_t resourceCount) {
+    SSKFrameGraphTextureDesc target = SSKBenchDesc(256, 256);
+    SSKFrameGraphImport(graph, "target", &target, NULL);
+    for (uint32_t r = 0; r < resourceCount; r++) {
+        SSKFrameGraphTextureDesc desc = SSKBenchDesc(64u << (r % 3), 64);
+        SSKFrameGraphCreate(graph, "transient", &desc);
+    }
+    uint8_t written[257] = {1};
+    for (uint32_t p = 0; p < passCount; p++) {
+        SSKFrameGraphResource reads[3], writes[2];
+        uint32_t readCount = 0, writeCount = 0;
+        uint32_t wantReads = (uint32_t)SSKRandomNextRange(random, 0.0f, 3.0f);
+        for (uint32_t i = 0; i < wantReads * 4 && readCount < wantReads; i++) {
+            SSKFrameGraphResource r = (SSKFrameGraphResource)SSKRandomNextRange(random, 0.0f, (float)resourceCount + 1);
+            if (r <= resourceCount && written[r]) { reads[readCount++] = r; }
+        }
+        uint32_t wantWrites = 1 + (SSKRandomNextUnit(random) < 0.3f);
+        while (writeCount < wantWrites) {
+            SSKFrameGraphResource w = (SSKFrameGraphResource)SSKRandomNextRange(random, 0.0f, (float)resourceCount + 1);
+            writes[writeCount++] = w > resourceCount ? resourceCount : w;
+        }
+        // Composite into the target in place often enough that chains stay live.
+        if (SSKRandomNextUnit(random) < 0.3f) {
+            writes[0] = 0;
+            if (readCount < 3) { reads[readCount++] = 0; }
+        }
+        for (uint32_t i = 0; i < writeCount; i++) { written[writes[i]] = 1; }
+        SSKFrameGraphPassKind kind = SSKRandomNextUnit(random) < 0.2f ? SSKFrameGraphPassEncoder : SSKFrameGraphPassCompute;
+        SSKFrameGraphAddPass(graph, "random", kind, 0, reads, readCount, writes, writeCount, NULL);
+    }
+}
+
+static bool SSKBenchCheckRandom(void) {
+    SSKRandom random = SSKRandomMake(11);
+    SSKFrameGraph graph;
+    SSKFrameGraphInit(&graph);
+    uint32_t graphs = 400, culled = 0, passes = 0, transients = 0, physical = 0;
+    bool ok = true;
+    for (uint32_t g = 0; g < graphs && ok; g++) {
+        SSKFrameGraphReset(&graph);
+        SSKBenchRandomGraph(&graph, &random, 8 + g % 40, 2 + g % 24);
+        ok = SSKFrameGraphCompile(&graph) == SSKFrameGraphOK;
+        for (uint32_t a = 0; a < graph.resourceCount && ok; a++) {
+            const SSKFrameGraphResourceInfo *ra = &graph.resources[a];
+            if (ra->imported || ra->physical == SSKFrameGraphInvalid) { continue; }
+            ok = SSKFrameGraphTextureDescEqual(&graph.physical[ra->physical], &ra->desc);
+            for (uint32_t b = a + 1; b < graph.resourceCount && ok; b++) {
+                const SSKFrameGraphResourceInfo *rb = &graph.resources[b];
+                if (rb->physical != ra->physical) { continue; }
+                ok = ra->lastUse < rb->firstUse || rb->lastUse < ra->firstUse;
+            }
+        }
+        // Physical textures per description must equal the peak alive at once.
+        for (uint32_t p = 0; p < graph.physicalCount && ok; p++) {
+            uint32_t sameDesc = 0, peak = 0;
+            for (uint32_t q = 0; q < graph.physicalCount; q++) {
+                sameDesc += SSKFrameGraphTextureDescEqual(&graph.physical[p], &graph.physical[q]);
+            }
+            for (uint32_t k = 0; k < graph.orderCount; k++) {
+                uint32_t alive = 0;
+                for (uint32_t r = 0; r < graph.resourceCount; r++) {
+                    const SSKFrameGraphResourceInfo *info = &graph.resources[r];
+                    alive += !info->imported && info->physical != SSKFrameGraphInvalid &&
+                             SSKFrameGraphTextureDescEqual(&info->desc, &graph.physical[p]) && info->firstUse <= k &&
+                             k <= info->lastUse;
+                }
+                peak = alive > peak ? alive : peak;
+            }
+            ok = sameDesc == peak;
+        }
+        passes += graph.passCount;
+        culled += graph.passCount - graph.orderCount;
+        for (uint32_t r = 0; r < graph.resourceCount; r++) {
+            transients += !graph.resources[r].imported && graph.resources[r].physical != SSKFrameGraphInvalid;
+        }
+        physical += graph.physicalCount;
+    }
+    printf("  %u random graphs: %u of %u passes culled, %u transients on %u textures: %s\n", graphs, culled, passes,
+           transients, physical, SSKBenchStatus(ok));
+    SSKFrameGraphDestroy(&graph);
+    return ok;
+}
+
+static void SSKBenchTiming(void) {
+    SSKFrameGraph graph;
+    SSKFrameGraphInit(&graph);
+    const int iterations = 20000;
+    double start = SSKBenchNow();
+    for (int i = 0; i < iterations; i++) {
+        SSKFrameGraphReset(&graph);
+        SSKBenchEffectChain(&graph, 5120, 2880);
+        SSKFrameGraphCompile(&graph);
+    }
+    double chain = (SSKBenchNow() - start) / iterations;
+
+    SSKRandom random = SSKRandomMake(5);
+    SSKFrameGraphReset(&graph);
+    SSKBenchRandomGraph(&graph, &random, 256, 64);
+    const int largeIterations = 2000;
+    start = SSKBenchNow();
+    for (int i = 0; i < largeIterations; i++) { SSKFrameGraphCompile(&graph); }
+    double large = (SSKBenchNow() - start) / largeIterations;
+    printf("  record + compile effect chain: %.2f us | compile 256 passes / 64 transients: %.1f us\n", chain * 1e6,
+           large * 1e6);
+    SSKFrameGraphDestroy(&graph);
+}
+
+int main(void) {
+    printf("SSKFrameGraphBench\n");
+    bool ok = SSKBenchCheckEffectChain();
+    ok = SSKBenchCheckCulling() && ok;
+    ok = SSKBenchCheckMipChain() && ok;
+    ok = SSKBenchCheckRandom() && ok;
+    if (!ok) { return 1; }
+    SSKBenchTiming();
+    return 0;
+}
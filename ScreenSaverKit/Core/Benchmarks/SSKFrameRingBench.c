@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Frame ring benchmark with a mock device and a mock GPU.
+//
+// The mock device hands out malloc'd buffers and counts them. The mock GPU is
+// a thread that "executes" submitted frames after a delay: it checks that
+// every range the frame wrote still holds that frame's pattern (so the CPU
+// never reused memory still in flight) and then retires the frame. The run
+// also checks that no more than frameCount frames were ever in flight and
+// that steady state stops creating buffers. Finally it times Begin/Allocate/
+// End against an idle mock GPU.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SSKBench.h"
+#include "SSKFrameRing.h"
+
+typedef struct {
+    atomic_int liveBuffers;
+    atomic_int createdBuffers;
+} SSKMockDevice;
+
+static void *SSKMockCreateBuffer(void *context, size_t length, void **outHandle) {
+    SSKMockDevice *device = context;
+    void *memory = malloc(length);
+    *outHandle = memory;
+    if (memory) {
+        atomic_fetch_add(&device->liveBuffers, 1);
+        atomic_fetch_add(&device->createdBuffers, 1);
+    }
+    return memory;
+}
+
+static void SSKMockDestroyBuffer(void *context, void *handle) {
+    SSKMockDevice *device = context;
+    free(handle);
+    atomic_fetch_sub(&device->liveBuffers, 1);
+}
+
+enum { SSKMockMaxRanges = 8, SSKMockQueueLength = 64 };
+
+typedef struct {
+    uint64_t frame;
+    uint32_t rangeCount;
+    unsigned char *ranges[SSKMockMaxRanges];
+    size_t lengths[SSKMockMaxRanges];
+} SSKMockFrame;
+
+typedef struct {
+    SSKFrameRing *ring;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    SSKMockFrame queue[SSKMockQueueLength];
+    uint32_t head;
+    uint32_t tail;
+    bool stopping;
+    atomic_int corruptFrames;
+    long latencyNanoseconds;
+} SSKMockGPU;
+
+static void SSKBenchSleep(long nanoseconds) {
+    struct timespec ts = { 0, nanoseconds };
+    nanosleep(&ts, NULL);
+}
+
+static void *SSKMockGPUMain(void *argument) {
+    SSKMockGPU *gpu = argument;
+    for (;;) {
+        pthread_mutex_lock(&gpu->mutex);
+        while (gpu->head == gpu->tail && !gpu->stopping) {
+            pthread_cond_wait(&gpu->changed, &gpu->mutex);
+        }
+        if (gpu->head == gpu->tail) {
+            pthread_mutex_unlock(&gpu->mutex);
+            break;
+        }
+        SSKMockFrame frame = gpu->queue[gpu->head % SSKMockQueueLength];
+        pthread_mutex_unlock(&gpu->mutex);
+
+        if (gpu->latencyNanoseconds > 0) {
+            SSKBenchSleep(gpu->latencyNanoseconds);
+        }
+        unsigned char pattern = (unsigned char)(frame.frame * 31u + 7u);
+        for (uint32_t r = 0; r < frame.rangeCount; r++) {
+            for (size_t i = 0; i < frame.lengths[r]; i++) {
+                if (frame.ranges[r][i] != pattern) {
+                    atomic_fetch_add(&gpu->corruptFrames, 1);
+                    break;
+                }
+            }
+        }
+        SSKFrameRingRetire(gpu->ring, frame.frame);
+
+        pthread_mutex_lock(&gpu->mutex);
+        gpu->head++;
+        pthread_mutex_unlock(&gpu->mutex);
+    }
+    return NULL;
+}
+
+static void SSKMockSubmit(SSKMockGPU *gpu, const SSKMockFrame *frame) {
+    pthread_mutex_lock(&gpu->mutex);
+    gpu->queue[gpu->tail % SSKMockQueueLength] = *frame;
+    gpu->tail++;
+    pthread_cond_signal(&gpu->changed);
+    pthread_mutex_unlock(&gpu->mutex);
+}
+
+static bool SSKBenchRun(uint32_t frameCount, int frames, long latency, bool verbose, double *outNsPerFrame) {
+    SSKMockDevice device = { 0 };
+    SSKFrameRingDevice interface = { &device, SSKMockCreateBuffer, SSKMockDestroyBuffer };
+    SSKFrameRing *ring = SSKFrameRingCreate(&interface, frameCount, 1024);
+    SSKMockGPU gpu = { .ring = ring, .latencyNanoseconds = latency };
+    pthread_mutex_init(&gpu.mutex, NULL);
+    pthread_cond_init(&gpu.changed, NULL);
+    pthread_t thread;
+    pthread_create(&thread, NULL, SSKMockGPUMain, &gpu);
+
+    uint32_t maxInFlight = 0;
+    int createdAfterWarmup = 0;
+    double start = SSKBenchNow();
+    for (int i = 0; i < frames; i++) {
+        uint64_t frameId = SSKFrameRingBeginFrame(ring);
+        uint32_t inFlight = SSKFrameRingFramesInFlight(ring);
+        if (inFlight > maxInFlight) { maxInFlight = inFlight; }
+        if (i == frames / 2) {
+            createdAfterWarmup = atomic_load(&device.createdBuffers);
+        }
+
+        // Uniforms, an instance block whose size swings between frames, and a
+        // dead list, like the particle system and pass allocate.
+        SSKMockFrame frame = { .frame = frameId };
+        size_t lengths[] = { 32, (size_t)(64 * (1 + (i * 37) % 500)), 4096 + 16 };
+        for (uint32_t r = 0; r < 3; r++) {
+            SSKFrameAllocation allocation;
+            if (!SSKFrameRingAllocate(ring, lengths[r], 64, &allocation)) {
+                fprintf(stderr, "allocation failed\n");
+                return false;
+            }
+            memset(allocation.contents, (unsigned char)(frameId * 31u + 7u), lengths[r]);
+            frame.ranges[frame.rangeCount] = allocation.contents;
+            frame.lengths[frame.rangeCount++] = lengths[r];
+        }
+        SSKFrameRingEndFrame(ring);
+        SSKMockSubmit(&gpu, &frame);
+    }
+    SSKFrameRingWaitIdle(ring);
+    double elapsed = SSKBenchNow() - start;
+
+    pthread_mutex_lock(&gpu.mutex);
+    gpu.stopping = true;
+    pthread_cond_signal(&gpu.changed);
+    pthread_mutex_unlock(&gpu.mutex);
+    pthread_join(thread, NULL);
+
+    int created = atomic_load(&device.createdBuffers);
+    SSKFrameRingDestroy(ring);
+    bool ok = atomic_load(&gpu.corruptFrames) == 0 && maxInFlight <= frameCount &&
+              atomic_load(&device.liveBuffers) == 0 && created == createdAfterWarmup;
+    if (verbose) {
+        printf("  %u frames in flight, %d frames: max in flight %u, corrupt %d, buffers created %d (%d after warm-up): %s\n",
+               frameCount, frames, maxInFlight, atomic_load(&gpu.corruptFrames), created,
+               created - createdAfterWarmup, SSKBenchStatus(ok));
+    }
+    if (outNsPerFrame) {
+        *outNsPerFrame = elapsed * 1e9 / frames;
+    }
+    pthread_cond_destroy(&gpu.changed);
+    pthread_mutex_destroy(&gpu.mutex);
+    return ok;
+}
+
+int main(void) {
+    printf("SSKFrameRingBench\n");
+    bool ok = true;
+    ok &= SSKBenchRun(1, 200, 200000, true, NULL);
+    ok &= SSKBenchRun(3, 600, 200000, true, NULL);
+    ok &= SSKBenchRun(5, 600, 50000, true, NULL);
+    if (!ok) {
+        fprintf(stderr, "SSKFrameRingBench: mock GPU detected a violation\n");
+        return 1;
+    }
+    double nsPerFrame = 0.0;
+    SSKBenchRun(3, 20000, 0, false, &nsPerFrame);
+    printf("  begin + 3 allocations + end + mock retire: %.0f ns/frame\n", nsPerFrame);
+    return 0;
+}
@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Key/value diff benchmark.
+//
+// Runs the diff behind SSKPreferenceChangedKeys over small pointer-keyed maps
+// and checks that added, removed and changed keys are each reported once,
+// that identical value pointers never reach the equality callback while equal
+// values in distinct objects do and are not reported, that the previous map
+// is only walked when a key may have been removed, and that an empty previous
+// map reports everything. Then times a 64-key preference set unchanged, with
+// one changed value, and with one key removed.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKKeyDiff.h"
+
+enum {
+    SSKBenchMaxKeys = 128,
+    SSKBenchTableSize = 256,
+};
+
+/// Values compare by `number`; distinct objects may be equal.
+typedef struct {
+    int number;
+} SSKBenchValue;
+
+typedef struct {
+    const void *keys[SSKBenchMaxKeys];
+    const void *values[SSKBenchMaxKeys];
+    uint32_t count;
+    /// Open addressing over key pointers; slot holds index + 1.
+    uint32_t table[SSKBenchTableSize];
+} SSKBenchMap;
+
+typedef struct {
+    const SSKBenchMap *previous;
+    const SSKBenchMap *current;
+    const void *changed[2 * SSKBenchMaxKeys];
+    uint32_t changedCount;
+    uint32_t previousKeyRequests;
+} SSKBenchContext;
+
+static uint32_t SSKBenchHash(const void *key) {
+    uint64_t bits = (uint64_t)(uintptr_t)key;
+    return (uint32_t)((bits * UINT64_C(0x9E3779B97F4A7C15)) >> 56) & (SSKBenchTableSize - 1);
+}
+
+static void SSKBenchMapSet(SSKBenchMap *map, const void *key, const void *value) {
+    uint32_t slot = SSKBenchHash(key);
+    while (map->table[slot]) {
+        uint32_t index = map->table[slot] - 1;
+        if (map->keys[index] == key) {
+            map->values[index] = value;
+            return;
+        }
+        slot = (slot + 1) & (SSKBenchTableSize - 1);
+    }
+    map->keys[map->count] = key;
+    map->values[map->count] = value;
+    map->table[slot] = ++map->count;
+}
+
+static const void *SSKBenchMapGet(const SSKBenchMap *map, const void *key) {
+    uint32_t slot = SSKBenchHash(key);
+    while (map->table[slot]) {
+        uint32_t index = map->table[slot] - 1;
+        if (map->keys[index] == key) { return map->values[index]; }
+        slot = (slot + 1) & (SSKBenchTableSize - 1);
+    }
+    return NULL;
+}
+
+static const void *SSKBenchPreviousValue(void *context, const void *key) {
+    return SSKBenchMapGet(((SSKBenchContext *)context)->previous, key);
+}
+
+static bool SSKBenchCurrentContains(void *context, const void *key) {
+    return SSKBenchMapGet(((SSKBenchContext *)context)->current, key) != NULL;
+}
+
+static bool SSKBenchEqual(void *context, const void *a, const void *b) {
+    (void)context;
+    return ((const SSKBenchValue *)a)->number == ((const SSKBenchValue *)b)->number;
+}
+
+static const void *const *SSKBenchPreviousKeys(void *context) {
+    SSKBenchContext *bench = context;
+    bench->previousKeyRequests++;
+    return bench->previous->keys;
+}
+
+static void SSKBenchChanged(void *context, const void *key) {
+    SSKBenchContext *bench = context;
+    bench->changed[bench->changedCount++] = key;
+}
+
+static const SSKKeyDiffCallbacks SSKBenchCallbacks = {
+    SSKBenchPreviousValue,
+    SSKBenchCurrentContains,
+    SSKBenchEqual,
+    SSKBenchPreviousKeys,
+    SSKBenchChanged,
+};
+
+static char SSKBenchKeys[SSKBenchMaxKeys][24];
+static SSKBenchValue SSKBenchValues[SSKBenchMaxKeys];
+static SSKBenchValue SSKBenchCopies[SSKBenchMaxKeys];
+
+static void SSKBenchInitKeys(void) {
+    for (int i = 0; i < SSKBenchMaxKeys; i++) {
+        snprintf(SSKBenchKeys[i], sizeof SSKBenchKeys[i], "key%d", i);
+        SSKBenchValues[i].number = i;
+        SSKBenchCopies[i].number = i;
+    }
+}
+
+/// Keys [first, first + count) holding the shared value objects.
+static void SSKBenchMapFill(SSKBenchMap *map, uint32_t first, uint32_t count) {
+    memset(map, 0, sizeof *map);
+    for (uint32_t i = first; i < first + count; i++) {
+        SSKBenchMapSet(map, SSKBenchKeys[i], &SSKBenchValues[i]);
+    }
+}
+
+static SSKKeyDiffResult SSKBenchDiff(const SSKBenchMap *previous, const SSKBenchMap *current,
+                                     SSKBenchContext *context) {
+    memset(context, 0, sizeof *context);
+    context->previous = previous;
+    context->current = current;
+    return SSKKeyDiffRun(current->keys, current->values, current->count, previous ? previous->count : 0,
+                         &SSKBenchCallbacks, context);
+}
+
+/// Whether the reported keys are exactly `expected`, each once.
+static bool SSKBenchReported(const SSKBenchContext *context, const void *const *expected, uint32_t count) {
+    if (context->changedCount != count) { return false; }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t seen = 0;
+        for (uint32_t j = 0; j < context->changedCount; j++) {
+            if (context->changed[j] == expected[i]) { seen++; }
+        }
+        if (seen != 1) { return false; }
+    }
+    return true;
+}
+
+static bool SSKBenchVerify(void) {
+    static SSKBenchMap previous;
+    static SSKBenchMap current;
+    SSKBenchContext context;
+    bool ok = true;
+
+    // Same value objects: no equality calls, no walk of the previous map.
+    SSKBenchMapFill(&previous, 0, 8);
+    SSKBenchMapFill(&current, 0, 8);
+    SSKKeyDiffResult result = SSKBenchDiff(&previous, &current, &context);
+    ok = ok && result.changed == 0 && result.shared == 8 && result.equalityChecks == 0 &&
+         !result.scannedPrevious && context.previousKeyRequests == 0;
+
+    // Equal values in distinct objects are compared, not reported; a changed
+    // value is reported.
+    SSKBenchMapSet(&current, SSKBenchKeys[2], &SSKBenchCopies[2]);
+    SSKBenchValue changedValue = {1000};
+    SSKBenchMapSet(&current, SSKBenchKeys[5], &changedValue);
+    result = SSKBenchDiff(&previous, &current, &context);
+    const void *changedKeys[] = {SSKBenchKeys[5]};
+    ok = ok && result.equalityChecks == 2 && SSKBenchReported(&context, changedKeys, 1) && !result.scannedPrevious;
+
+    // An added key alone leaves every previous key matched: no walk.
+    SSKBenchMapFill(&current, 0, 9);
+    result = SSKBenchDiff(&previous, &current, &context);
+    const void *addedKeys[] = {SSKBenchKeys[8]};
+    ok = ok && SSKBenchReported(&context, addedKeys, 1) && !result.scannedPrevious && result.shared == 8;
+
+    // Removed keys are found by the walk, alongside added and changed ones.
+    SSKBenchMapFill(&current, 2, 8);
+    SSKBenchMapSet(&current, SSKBenchKeys[4], &changedValue);
+    result = SSKBenchDiff(&previous, &current, &context);
+    const void *mixedKeys[] = {SSKBenchKeys[0], SSKBenchKeys[1], SSKBenchKeys[4], SSKBenchKeys[8], SSKBenchKeys[9]};
+    ok = ok && SSKBenchReported(&context, mixedKeys, 5) && result.scannedPrevious &&
+         context.previousKeyRequests == 1 && result.shared == 6;
+
+    // Swapping one key for another is caught even though the counts match.
+    SSKBenchMapFill(&current, 1, 8);
+    result = SSKBenchDiff(&previous, &current, &context);
+    const void *swappedKeys[] = {SSKBenchKeys[0], SSKBenchKeys[8]};
+    ok = ok && SSKBenchReported(&context, swappedKeys, 2) && result.scannedPrevious;
+
+    // No previous map: everything, without asking about it.
+    result = SSKBenchDiff(NULL, &current, &context);
+    ok = ok && result.changed == current.count && context.changedCount == current.count &&
+         result.equalityChecks == 0 && context.previousKeyRequests == 0;
+
+    // Everything removed.
+    SSKBenchMapFill(&current, 0, 0);
+    result = SSKBenchDiff(&previous, &current, &context);
+    ok = ok && SSKBenchReported(&context, previous.keys, previous.count);
+    return ok;
+}
+
+static double SSKBenchTime(const SSKBenchMap *previous, const SSKBenchMap *current, uint32_t runs) {
+    SSKBenchContext context;
+    volatile uint32_t sink = 0;
+    double start = SSKBenchNow();
+    for (uint32_t i = 0; i < runs; i++) {
+        sink += SSKBenchDiff(previous, current, &context).changed;
+    }
+    (void)sink;
+    return (SSKBenchNow() - start) * 1e9 / runs;
+}
+
+int main(void) {
+    printf("SSKKeyDiffBench\n");
+    SSKBenchInitKeys();
+
+    bool ok = SSKBenchCheck("added, removed and changed keys, pointer shortcut, walk only on removal",
+                            SSKBenchVerify());
+    if (!ok) { return 1; }
+
+    static SSKBenchMap previous;
+    static SSKBenchMap current;
+    enum { SSKBenchRuns = 2000000 };
+    SSKBenchMapFill(&previous, 0, 64);
+    SSKBenchMapFill(&current, 0, 64);
+    double unchanged = SSKBenchTime(&previous, &current, SSKBenchRuns);
+    SSKBenchValue changedValue = {-1};
+    SSKBenchMapSet(&current, SSKBenchKeys[17], &changedValue);
+    double oneChanged = SSKBenchTime(&previous, &current, SSKBenchRuns);
+    SSKBenchMapFill(&current, 1, 63);
+    double oneRemoved = SSKBenchTime(&previous, &current, SSKBenchRuns);
+
+    printf("  64 keys unchanged: %.1f ns, one changed: %.1f ns, one removed: %.1f ns\n",
+           unchanged, oneChanged, oneRemoved);
+    return 0;
+}
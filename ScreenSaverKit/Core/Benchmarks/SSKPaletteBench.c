@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Palette lookup table benchmark.
+//
+// Compiles a few palettes (a bright three-colour loop, black to white, and
+// translucent stops) and compares the table against the palette evaluated
+// exactly in double precision, for both wrap modes and both encodings,
+// over progress values well outside [0, 1]. The error in linear light must
+// stay under half an 8-bit step. Stops must come back exactly where they
+// fall on an entry; looping must be continuous across 1, and clamping must
+// stop on the first and last colour. NaN and infinite progress must not read outside the
+// table, and batch sampling must match single samples bit for bit. The timing
+// table compares a batch sample per colour against blending the stops per
+// call, which is what `colorForPalette:` did with `NSColor`.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKPalette.h"
+#include "SSKRandom.h"
+
+enum {
+    SSKBenchSamples = 1 << 20,
+    SSKBenchRepeats = 8,
+};
+
+/// Half of one 8-bit step.
+static const double SSKBenchTolerance = 0.5 / 255.0;
+
+typedef struct {
+    const char *name;
+    SSKFloat4 stops[4];
+    uint32_t stopCount;
+} SSKBenchPalette;
+
+static const SSKBenchPalette SSKBenchPalettes[] = {
+    {"neon", {{0.25f, 0.55f, 1.0f, 1.0f}, {0.85f, 0.2f, 1.0f, 1.0f}, {1.0f, 0.75f, 0.15f, 1.0f}}, 3},
+    {"black-white", {{0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}}, 2},
+    {"translucent", {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 0.5f},
+                     {0.5f, 0.5f, 0.5f, 0.25f}}, 4},
+};
+
+static double SSKBenchToLinear(double value) {
+    return value <= 0.04045 ? value / 12.92 : pow((value + 0.055) / 1.055, 2.4);
+}
+
+static double SSKBenchToSRGB(double value) {
+    return value <= 0.0031308 ? value * 12.92 : 1.055 * pow(value, 1.0 / 2.4) - 0.055;
+}
+
+/// The palette at `progress`, computed directly in double precision.
+static void SSKBenchReference(const SSKBenchPalette *palette, SSKPaletteWrap wrap, SSKPaletteEncoding encoding,
+                              double progress, double out[4]) {
+    uint32_t n = palette->stopCount;
+    double u = wrap == SSKPaletteWrapLoop ? progress - floor(progress) : fmin(fmax(progress, 0.0), 1.0);
+    uint32_t segments = wrap == SSKPaletteWrapLoop ? n : n - 1;
+    double scaled = u * segments;
+    uint32_t segment = (uint32_t)scaled;
+    if (segment > segments - 1) { segment = segments - 1; }
+    double t = scaled - segment;
+    const float *a = &palette->stops[segment].x;
+    const float *b = &palette->stops[(segment + 1) % n].x;
+    for (int c = 0; c < 3; c++) {
+        double linear = SSKBenchToLinear(a[c]) + (SSKBenchToLinear(b[c]) - SSKBenchToLinear(a[c])) * t;
+        out[c] = encoding == SSKPaletteEncodingSRGB ? SSKBenchToSRGB(linear) : linear;
+    }
+    out[3] = a[3] + ((double)b[3] - a[3]) * t;
+}
+
+static bool SSKBenchSameColor(SSKFloat4 a, SSKFloat4 b) {
+    return memcmp(&a, &b, sizeof(SSKFloat4)) == 0;
+}
+
+/// Largest difference from the reference, as stored (`encoded`) and in linear
+/// light (`light`). For linear tables the two are the same.
+typedef struct {
+    double encoded;
+    double light;
+} SSKBenchError;
+
+static SSKBenchError SSKBenchMaxError(const SSKBenchPalette *palette, SSKPaletteWrap wrap,
+                                      SSKPaletteEncoding encoding) {
+    SSKPaletteLUT lut;
+    SSKPaletteLUTBuild(&lut, palette->stops, palette->stopCount, wrap, encoding);
+    SSKRandom random = SSKRandomMake(7);
+    SSKBenchError error = {0.0, 0.0};
+    for (uint32_t i = 0; i < 100000; i++) {
+        float progress = SSKRandomNextRange(&random, -3.0f, 4.0f);
+        double expected[4];
+        SSKBenchReference(palette, wrap, encoding, progress, expected);
+        SSKFloat4 sample = SSKPaletteLUTSample(&lut, progress);
+        const float *actual = &sample.x;
+        for (int c = 0; c < 4; c++) {
+            error.encoded = fmax(error.encoded, fabs(actual[c] - expected[c]));
+            bool encoded = c < 3 && encoding == SSKPaletteEncodingSRGB;
+            double light = encoded ? SSKBenchToLinear(actual[c]) - SSKBenchToLinear(expected[c]) :
+                                     actual[c] - expected[c];
+            error.light = fmax(error.light, fabs(light));
+        }
+    }
+    return error;
+}
+
+/// Tables must be within half an 8-bit step of the exact palette in linear
+/// light. sRGB tables interpolate between entries in encoded space, so their
+/// encoded error is larger where a channel approaches black; it is reported
+/// but not held to the tolerance.
+static bool SSKBenchCheckAccuracy(void) {
+    bool ok = true;
+    for (size_t p = 0; p < sizeof(SSKBenchPalettes) / sizeof(SSKBenchPalettes[0]); p++) {
+        for (int wrap = SSKPaletteWrapLoop; wrap <= SSKPaletteWrapClamp; wrap++) {
+            for (int encoding = SSKPaletteEncodingLinear; encoding <= SSKPaletteEncodingSRGB; encoding++) {
+                SSKBenchError error = SSKBenchMaxError(&SSKBenchPalettes[p], (SSKPaletteWrap)wrap,
+                                                       (SSKPaletteEncoding)encoding);
+                bool passed = error.light < SSKBenchTolerance;
+                printf("  %-12s %-5s %-6s max error %.2e (linear light %.2e)%s\n", SSKBenchPalettes[p].name,
+                       wrap == SSKPaletteWrapLoop ? "loop" : "clamp",
+                       encoding == SSKPaletteEncodingLinear ? "linear" : "sRGB", error.encoded, error.light,
+                       passed ? "" : "  FAILED");
+                ok = ok && passed;
+            }
+        }
+    }
+    return ok;
+}
+
+static bool SSKBenchCheckEdges(void) {
+    const SSKBenchPalette *translucent = &SSKBenchPalettes[2];
+    SSKPaletteLUT loop;
+    SSKPaletteLUT clamp;
+    SSKPaletteLUTBuild(&loop, translucent->stops, translucent->stopCount, SSKPaletteWrapLoop, SSKPaletteEncodingSRGB);
+    SSKPaletteLUTBuild(&clamp, translucent->stops, translucent->stopCount, SSKPaletteWrapClamp,
+                       SSKPaletteEncodingSRGB);
+
+    // Four looping stops fall on every quarter of the table.
+    bool stopsExact = true;
+    for (uint32_t s = 0; s < translucent->stopCount; s++) {
+        SSKFloat4 sample = SSKPaletteLUTSample(&loop, (float)s * 0.25f);
+        stopsExact = stopsExact && SSKBenchSameColor(sample, translucent->stops[s]);
+    }
+    bool loopContinuous = SSKBenchSameColor(SSKPaletteLUTSample(&loop, 1.0f), SSKPaletteLUTSample(&loop, 0.0f)) &&
+                          SSKBenchSameColor(SSKPaletteLUTSample(&loop, -0.25f), SSKPaletteLUTSample(&loop, 0.75f)) &&
+                          SSKBenchSameColor(SSKPaletteLUTSample(&loop, 3.5f), SSKPaletteLUTSample(&loop, 0.5f));
+    bool clampEnds = SSKBenchSameColor(SSKPaletteLUTSample(&clamp, -2.0f), translucent->stops[0]) &&
+                     SSKBenchSameColor(SSKPaletteLUTSample(&clamp, 1.0f), translucent->stops[3]) &&
+                     SSKBenchSameColor(SSKPaletteLUTSample(&clamp, 7.0f), translucent->stops[3]);
+    bool nonFinite = SSKBenchSameColor(SSKPaletteLUTSample(&loop, NAN), loop.entries[0]) &&
+                     SSKBenchSameColor(SSKPaletteLUTSample(&loop, INFINITY), loop.entries[0]) &&
+                     SSKBenchSameColor(SSKPaletteLUTSample(&clamp, NAN), clamp.entries[0]) &&
+                     SSKBenchSameColor(SSKPaletteLUTSample(&clamp, -INFINITY), translucent->stops[0]);
+
+    SSKPaletteLUT white;
+    SSKPaletteLUT solid;
+    SSKPaletteLUTBuild(&white, NULL, 0, SSKPaletteWrapLoop, SSKPaletteEncodingSRGB);
+    SSKPaletteLUTBuild(&solid, &translucent->stops[2], 1, SSKPaletteWrapClamp, SSKPaletteEncodingSRGB);
+    bool degenerate = SSKBenchSameColor(SSKPaletteLUTSample(&white, 0.3f), SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f)) &&
+                      SSKBenchSameColor(SSKPaletteLUTSample(&solid, 0.7f), translucent->stops[2]);
+
+    // Halfway from black to white is half the light, not half the code value.
+    const SSKBenchPalette *blackWhite = &SSKBenchPalettes[1];
+    SSKPaletteLUT linear;
+    SSKPaletteLUTBuild(&linear, blackWhite->stops, blackWhite->stopCount, SSKPaletteWrapClamp,
+                       SSKPaletteEncodingLinear);
+    bool linearLight = fabsf(SSKPaletteLUTSample(&linear, 0.5f).x - 0.5f) < 1e-6f;
+
+    float progress[7] = {-1.3f, 0.0f, 0.125f, 0.5f, 0.999f, 2.75f, NAN};
+    SSKFloat4 batch[7];
+    SSKPaletteLUTSampleBatch(&loop, progress, batch, 7);
+    bool batchMatches = true;
+    for (int i = 0; i < 7; i++) {
+        batchMatches = batchMatches && SSKBenchSameColor(batch[i], SSKPaletteLUTSample(&loop, progress[i]));
+    }
+
+    bool ok = stopsExact && loopContinuous && clampEnds && nonFinite && degenerate && linearLight && batchMatches;
+    printf("  edges: stops %s, loop wrap %s, clamp ends %s, non-finite %s, 0/1 stops %s, linear light %s, "
+           "batch %s%s\n",
+           stopsExact ? "exact" : "off", loopContinuous ? "continuous" : "broken", clampEnds ? "held" : "off",
+           nonFinite ? "in range" : "off", degenerate ? "ok" : "off", linearLight ? "ok" : "off",
+           batchMatches ? "matches" : "differs", ok ? "" : "  FAILED");
+    return ok;
+}
+
+/// Blends the two neighbouring stops for each sample as the old per-call
+/// path did: wrap, pick a segment, convert and mix.
+static void SSKBenchBlendPerCall(const SSKBenchPalette *palette, const float *progress, SSKFloat4 *colors,
+                                 uint32_t count) {
+    uint32_t n = palette->stopCount;
+    for (uint32_t i = 0; i < count; i++) {
+        float u = progress[i] - floorf(progress[i]);
+        float scaled = u * (float)n;
+        uint32_t segment = (uint32_t)scaled % n;
+        float t = scaled - floorf(scaled);
+        SSKFloat4 a = palette->stops[segment];
+        SSKFloat4 b = palette->stops[(segment + 1) % n];
+        float rgb[3];
+        const float *pa = &a.x;
+        const float *pb = &b.x;
+        for (int c = 0; c < 3; c++) {
+            float la = SSKPaletteSRGBToLinear(pa[c]);
+            rgb[c] = SSKPaletteLinearToSRGB(la + (SSKPaletteSRGBToLinear(pb[c]) - la) * t);
+        }
+        colors[i] = SSKFloat4Make(rgb[0], rgb[1], rgb[2], a.w + (b.w - a.w) * t);
+    }
+}
+
+static void SSKBenchTime(void) {
+    float *progress = malloc(sizeof(float) * SSKBenchSamples);
+    SSKFloat4 *colors = malloc(sizeof(SSKFloat4) * SSKBenchSamples);
+    if (!progress || !colors) {
+        free(progress);
+        free(colors);
+        return;
+    }
+    SSKRandom random = SSKRandomMake(11);
+    for (uint32_t i = 0; i < SSKBenchSamples; i++) {
+        progress[i] = SSKRandomNextRange(&random, 0.0f, 8.0f);
+    }
+    const SSKBenchPalette *palette = &SSKBenchPalettes[0];
+    SSKPaletteLUT lut;
+
+    double start = SSKBenchNow();
+    for (int r = 0; r < SSKBenchRepeats; r++) {
+        SSKPaletteLUTBuild(&lut, palette->stops, palette->stopCount, SSKPaletteWrapLoop, SSKPaletteEncodingSRGB);
+    }
+    double build = (SSKBenchNow() - start) / SSKBenchRepeats;
+
+    start = SSKBenchNow();
+    for (int r = 0; r < SSKBenchRepeats; r++) {
+        SSKPaletteLUTSampleBatch(&lut, progress, colors, SSKBenchSamples);
+    }
+    double batch = (SSKBenchNow() - start) / ((double)SSKBenchRepeats * SSKBenchSamples);
+    float checksum = colors[SSKBenchSamples / 2].x;
+
+    start = SSKBenchNow();
+    for (int r = 0; r < SSKBenchRepeats; r++) {
+        SSKBenchBlendPerCall(palette, progress, colors, SSKBenchSamples);
+    }
+    double perCall = (SSKBenchNow() - start) / ((double)SSKBenchRepeats * SSKBenchSamples);
+    checksum += colors[SSKBenchSamples / 2].x;
+
+    printf("  build %.1f us, batch %.2f ns/colour, blend per call %.2f ns/colour (%.1fx)  [checksum %.3f]\n",
+           build * 1e6, batch * 1e9, perCall * 1e9, perCall / batch, checksum);
+    free(progress);
+    free(colors);
+}
+
+int main(void) {
+    printf("SSKPalette: %d-entry lookup tables\n", SSKPaletteLUTResolution);
+    bool ok = SSKBenchCheckAccuracy();
+    ok = SSKBenchCheckEdges() && ok;
+    SSKBenchTime();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
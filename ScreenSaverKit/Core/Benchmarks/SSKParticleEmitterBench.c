@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Batch emission benchmark.
+//
+// Checks that SSKParticleCoreEmit is reproducible (same seed, same streams)
+// and honours its ranges, then compares ns/particle for bursts emitted from a
+// descriptor against spawning and filling the streams field by field, the
+// way the per-particle initializer path does.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleEmitter.h"
+
+static SSKParticleEmitter SSKBenchEmitter(void) {
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.origin = SSKFloat2Make(960.0f, 540.0f);
+    emitter.originJitter = SSKFloat2Make(4.0f, 4.0f);
+    emitter.angle = SSKFloatRangeMake(0.0f, 6.2831853f);
+    emitter.speed = SSKFloatRangeMake(90.0f, 230.0f);
+    emitter.maxLife = SSKFloatRangeMake(0.35f, 0.55f);
+    emitter.size = SSKFloatRangeMake(3.0f, 7.0f);
+    emitter.sizeVelocity = SSKFloatRangeMake(20.0f, 20.0f);
+    emitter.rotationVelocity = SSKFloatRangeMake(-1.5f, 1.5f);
+    emitter.damping = 0.45f;
+    emitter.colorStart = SSKFloat4Make(1.0f, 0.4f, 0.1f, 1.0f);
+    emitter.colorEnd = SSKFloat4Make(1.0f, 0.9f, 0.3f, 1.0f);
+    emitter.behaviorFlags = SSKParticleCoreBehaviorFadeAlpha;
+    return emitter;
+}
+
+static bool SSKBenchVerify(void) {
+    const uint32_t capacity = 4096;
+    SSKParticleCore *a = SSKParticleCoreCreate(capacity);
+    SSKParticleCore *b = SSKParticleCoreCreate(capacity);
+    if (!a || !b) { return false; }
+    SSKParticleEmitter emitter = SSKBenchEmitter();
+    SSKRandom ra = SSKRandomMake(42);
+    SSKRandom rb = SSKRandomMake(42);
+    bool ok = SSKParticleCoreEmit(a, &emitter, capacity + 10, &ra, NULL) == capacity;
+    ok = ok && SSKParticleCoreEmit(b, &emitter, capacity, &rb, NULL) == capacity;
+    ok = ok && memcmp(a->storage, b->storage, SSKParticleCoreStorageSize(capacity)) == 0;
+    for (uint32_t i = 0; ok && i < a->aliveCount; i++) {
+        uint32_t slot = a->aliveList[i];
+        float speed = hypotf(a->velocity[slot].x, a->velocity[slot].y);
+        ok = a->alive[slot] == 1u && a->life[slot] == 0.0f &&
+             a->maxLife[slot] >= 0.35f && a->maxLife[slot] <= 0.55f &&
+             a->size[slot] == a->baseSize[slot] && speed >= 89.9f && speed <= 230.1f &&
+             fabsf(a->position[slot].x - 960.0f) <= 4.0f &&
+             a->color[slot].y >= 0.4f && a->color[slot].y <= 0.9f;
+    }
+    SSKParticleCoreDestroy(a);
+    SSKParticleCoreDestroy(b);
+    return ok;
+}
+
+// Reference: claim slots, then overwrite the defaults one field at a time.
+static uint32_t SSKBenchSpawnPerField(SSKParticleCore *core, uint32_t count, uint32_t *slots, SSKRandom *random) {
+    uint32_t spawned = SSKParticleCoreSpawn(core, count, slots);
+    for (uint32_t i = 0; i < spawned; i++) {
+        uint32_t slot = slots[i];
+        float angle = SSKRandomNextRange(random, 0.0f, 6.2831853f);
+        float speed = SSKRandomNextRange(random, 90.0f, 230.0f);
+        core->position[slot] = SSKFloat2Make(960.0f + SSKRandomNextRange(random, -4.0f, 4.0f),
+                                             540.0f + SSKRandomNextRange(random, -4.0f, 4.0f));
+        core->velocity[slot] = SSKFloat2Make(cosf(angle) * speed, sinf(angle) * speed);
+        core->maxLife[slot] = SSKRandomNextRange(random, 0.35f, 0.55f);
+        core->size[slot] = SSKRandomNextRange(random, 3.0f, 7.0f);
+        core->baseSize[slot] = core->size[slot];
+        core->sizeVelocity[slot] = 20.0f;
+        core->rotationVelocity[slot] = SSKRandomNextRange(random, -1.5f, 1.5f);
+        core->damping[slot] = 0.45f;
+        float t = SSKRandomNextUnit(random);
+        SSKFloat4 color = SSKFloat4Make(1.0f, 0.4f + 0.5f * t, 0.1f + 0.2f * t, 1.0f);
+        core->color[slot] = color;
+        core->baseColor[slot] = color;
+        core->behaviorFlags[slot] = SSKParticleCoreBehaviorFadeAlpha;
+    }
+    return spawned;
+}
+
+static void SSKBenchBursts(uint32_t burst, bool useEmitter) {
+    const uint32_t capacity = 65536;
+    SSKParticleCore *core = SSKParticleCoreCreate(capacity);
+    uint32_t *slots = malloc(sizeof(uint32_t) * burst);
+    if (!core || !slots) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    SSKParticleEmitter emitter = SSKBenchEmitter();
+    SSKRandom random = SSKRandomMake(7);
+    uint64_t emitted = 0;
+    double elapsed = 0.0;
+    for (int round = 0; round < 4000; round++) {
+        if (core->slots.freeCount < burst) {
+            SSKParticleCoreReset(core);
+        }
+        double start = SSKBenchNow();
+        emitted += useEmitter ? SSKParticleCoreEmit(core, &emitter, burst, &random, NULL)
+                              : SSKBenchSpawnPerField(core, burst, slots, &random);
+        elapsed += SSKBenchNow() - start;
+    }
+    printf("  %-10s burst %5u: %6.1f ns/particle\n", useEmitter ? "emitter" : "per-field", burst,
+           elapsed * 1e9 / (double)(emitted ? emitted : 1));
+    free(slots);
+    SSKParticleCoreDestroy(core);
+}
+
+int main(void) {
+    if (!SSKBenchVerify()) {
+        fprintf(stderr, "SSKParticleEmitterBench: verification FAILED\n");
+        return 1;
+    }
+    printf("SSKParticleEmitterBench: seeded emission verified\n");
+    const uint32_t bursts[] = { 36, 512, 4096 };
+    for (size_t i = 0; i < sizeof(bursts) / sizeof(bursts[0]); i++) {
+        SSKBenchBursts(bursts[i], false);
+        SSKBenchBursts(bursts[i], true);
+    }
+    return 0;
+}
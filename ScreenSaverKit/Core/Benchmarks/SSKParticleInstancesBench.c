@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Instance generation benchmark.
+//
+// Fills cores with random state (including dead gaps, zero velocities and
+// NaN/negative/infinite softness) and requires SSKParticleCoreWriteInstances
+// to produce exactly the bytes of the scalar reference. Then reports
+// M instances/s for both at several particle counts and live ratios.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleInstances.h"
+#include "SSKRandom.h"
+
+static SSKParticleCore *SSKBenchCore(uint32_t capacity, float liveRatio, uint64_t seed) {
+    SSKParticleCore *core = SSKParticleCoreCreate(capacity);
+    if (!core) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    SSKRandom random = SSKRandomMake(seed);
+    SSKParticleCoreSpawn(core, capacity, NULL);
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        core->position[slot] = SSKFloat2Make(SSKRandomNextRange(&random, 0, 1920), SSKRandomNextRange(&random, 0, 1080));
+        uint32_t kind = SSKRandomNext(&random) % 16u;
+        core->userVector[slot] = kind == 0 ? SSKFloat2Make(0.0f, 0.0f)
+                                           : SSKFloat2Make(SSKRandomNextRange(&random, -3, 3), SSKRandomNextRange(&random, -3, 3));
+        core->size[slot] = SSKRandomNextRange(&random, -1.0f, 12.0f);
+        core->color[slot] = SSKFloat4Make(SSKRandomNextUnit(&random), SSKRandomNextUnit(&random),
+                                          SSKRandomNextUnit(&random), SSKRandomNextUnit(&random));
+        core->userScalar[slot] = kind == 1 ? NAN : kind == 2 ? INFINITY : SSKRandomNextRange(&random, -2.0f, 8.0f);
+        if (SSKRandomNextUnit(&random) >= liveRatio) {
+            core->alive[slot] = 0u;
+        }
+    }
+    SSKParticleCoreCompactAliveList(core);
+    return core;
+}
+
+static bool SSKBenchVerify(uint32_t capacity, float liveRatio, uint32_t maxCount) {
+    SSKParticleCore *core = SSKBenchCore(capacity, liveRatio, capacity);
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    size_t bytes = sizeof(SSKParticleInstance) * (capacity + 1);
+    SSKParticleInstance *expected = malloc(bytes);
+    SSKParticleInstance *actual = malloc(bytes);
+    // Different fills, so a byte either path leaves unwritten (padding
+    // included) shows up as a mismatch.
+    memset(expected, 0xAB, bytes);
+    memset(actual, 0xCD, bytes);
+    uint32_t a = SSKParticleCoreWriteInstancesScalar(core, &style, expected, maxCount);
+    uint32_t b = SSKParticleCoreWriteInstances(core, &style, actual, maxCount);
+    uint32_t live = core->aliveCount < maxCount ? core->aliveCount : maxCount;
+    bool ok = a == live && b == a && memcmp(expected, actual, sizeof(SSKParticleInstance) * a) == 0;
+    // Nothing past the last instance is touched.
+    const uint8_t *tail = (const uint8_t *)(actual + b);
+    for (size_t i = 0; ok && i < bytes - sizeof(SSKParticleInstance) * b; i++) {
+        ok = tail[i] == 0xCD;
+    }
+    printf("  verify capacity %6u live %3.0f%% limit %6u: %s\n", capacity, liveRatio * 100.0f, maxCount,
+           ok ? "ok" : "MISMATCH");
+    free(expected);
+    free(actual);
+    SSKParticleCoreDestroy(core);
+    return ok;
+}
+
+static void SSKBenchThroughput(uint32_t capacity, float liveRatio) {
+    SSKParticleCore *core = SSKBenchCore(capacity, liveRatio, 11);
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    SSKParticleInstance *out = malloc(sizeof(SSKParticleInstance) * capacity);
+    double rates[2];
+    for (int variant = 0; variant < 2; variant++) {
+        uint64_t total = 0;
+        int rounds = (int)(20000000u / capacity) + 1;
+        double start = SSKBenchNow();
+        for (int i = 0; i < rounds; i++) {
+            total += variant ? SSKParticleCoreWriteInstances(core, &style, out, capacity)
+                             : SSKParticleCoreWriteInstancesScalar(core, &style, out, capacity);
+        }
+        rates[variant] = (double)total / (SSKBenchNow() - start) * 1e-6;
+    }
+    printf("  %7u particles, %3.0f%% live: scalar %6.1f  vector %6.1f M instances/s (%.2fx)\n",
+           capacity, liveRatio * 100.0f, rates[0], rates[1], rates[1] / rates[0]);
+    free(out);
+    SSKParticleCoreDestroy(core);
+}
+
+int main(void) {
+    printf("SSKParticleInstancesBench\n");
+    bool ok = true;
+    ok &= SSKBenchVerify(1000, 1.0f, 1000);
+    ok &= SSKBenchVerify(4099, 0.6f, 4099);
+    ok &= SSKBenchVerify(4099, 0.6f, 1001);
+    ok &= SSKBenchVerify(777, 0.05f, 777);
+    if (!ok) {
+        fprintf(stderr, "SSKParticleInstancesBench: vector output differs from scalar reference\n");
+        return 1;
+    }
+    SSKBenchThroughput(4096, 1.0f);
+    SSKBenchThroughput(65536, 1.0f);
+    SSKBenchThroughput(65536, 0.5f);
+    SSKBenchThroughput(262144, 0.9f);
+    return 0;
+}
@@ -0,0 +1,228 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Kernel variant selection benchmark.
+//
+// Checks SSKParticleKernelSelectVariant against a brute-force search for every
+// feature set and every set of ready variants. Then it steps random particle
+// populations twice with a CPU copy of the Metal `stepParticle` that honours the
+// feature gates: once with every feature on, once with the features
+// SSKParticleKernelFeaturesForStep picked. Both must produce the same bytes.
+// Finally it times the selection, which runs once per step, and the CPU copy
+// with both variants for a typical fade-only population.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleEmitter.h"
+#include "SSKParticleKernelVariant.h"
+#include "SSKRandom.h"
+
+static bool SSKBenchVerifySelection(void) {
+    for (uint32_t features = 0; features < SSKParticleKernelVariantCount; features++) {
+        for (uint32_t ready = 0; ready < (1u << SSKParticleKernelVariantCount); ready++) {
+            uint32_t expected = SSKParticleKernelNoVariant;
+            for (int bits = 0; bits <= SSKParticleKernelFeatureCount && expected == SSKParticleKernelNoVariant; bits++) {
+                for (uint32_t variant = 0; variant < SSKParticleKernelVariantCount; variant++) {
+                    if ((ready & (1u << variant)) && (variant & features) == features &&
+                        __builtin_popcount(variant) == bits) {
+                        expected = variant;
+                        break;
+                    }
+                }
+            }
+            if (SSKParticleKernelSelectVariant(features, ready) != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// `stepParticle` in SSKParticleShaders.metal without force fields; a feature
+// that is off skips its work exactly as the specialised kernel does.
+static void SSKBenchStep(SSKParticleCore *core, const SSKParticleSimParams *params, uint32_t features) {
+    float dt = params->dt;
+    for (uint32_t id = 0; id < core->capacity; id++) {
+        if (!core->alive[id]) { continue; }
+        float age = core->life[id] + dt;
+        core->life[id] = age;
+        if (age >= core->maxLife[id]) {
+            core->alive[id] = 0u;
+            continue;
+        }
+        SSKFloat2 v = core->velocity[id];
+        if ((features & SSKParticleKernelFeatureGravity) && (params->gravity.x != 0.0f || params->gravity.y != 0.0f)) {
+            v.x += params->gravity.x * dt;
+            v.y += params->gravity.y * dt;
+        }
+        if (features & SSKParticleKernelFeatureDamping) {
+            float damp = fmaxf(0.0f, core->damping[id] + params->globalDamping);
+            if (damp > 0.0f) {
+                float factor = powf(fmaxf(0.0f, 1.0f - damp), dt);
+                v.x *= factor;
+                v.y *= factor;
+            }
+        }
+        core->velocity[id] = v;
+        core->position[id].x += v.x * dt;
+        core->position[id].y += v.y * dt;
+        core->rotation[id] += core->rotationVelocity[id] * dt;
+        float size = core->size[id];
+        if (fabsf(core->sizeVelocity[id]) > 0.0001f) {
+            size = fmaxf(0.0f, size + core->sizeVelocity[id] * dt);
+        }
+        uint32_t flags = core->behaviorFlags[id];
+        float normalized = core->maxLife[id] > 0.0f ? fminf(fmaxf(age / core->maxLife[id], 0.0f), 1.0f) : 0.0f;
+        if ((features & SSKParticleKernelFeatureFadeAlpha) && (flags & SSKParticleCoreBehaviorFadeAlpha)) {
+            SSKFloat4 base = core->baseColor[id];
+            core->color[id] = SSKFloat4Make(base.x, base.y, base.z, base.w * (1.0f - normalized));
+        }
+        if ((features & SSKParticleKernelFeatureFadeSize) && (flags & SSKParticleCoreBehaviorFadeSize)) {
+            SSKFloat2 range = core->sizeRange[id];
+            size = fmaxf(0.0f, core->baseSize[id] * (range.x + (range.y - range.x) * normalized));
+        }
+        core->size[id] = size;
+        float lengthSquared = v.x * v.x + v.y * v.y;
+        if (lengthSquared > 0.0001f) {
+            float inverse = 1.0f / sqrtf(lengthSquared);
+            core->userVector[id] = SSKFloat2Make(v.x * inverse, v.y * inverse);
+        }
+    }
+}
+
+static SSKParticleEmitter SSKBenchEmitter(SSKRandom *random) {
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.origin = SSKFloat2Make(SSKRandomNextRange(random, 0.0f, 1920.0f), SSKRandomNextRange(random, 0.0f, 1080.0f));
+    emitter.angle = SSKFloatRangeMake(0.0f, 6.2831853f);
+    emitter.speed = SSKFloatRangeMake(20.0f, 200.0f);
+    emitter.maxLife = SSKFloatRangeMake(0.5f, 2.0f);
+    emitter.size = SSKFloatRangeMake(2.0f, 6.0f);
+    emitter.sizeOverLife = SSKFloat2Make(1.0f, 0.25f);
+    emitter.sizeVelocity = SSKFloatRangeMake(-1.0f, 1.0f);
+    emitter.colorStart = SSKFloat4Make(1.0f, 0.5f, 0.2f, 1.0f);
+    emitter.colorEnd = SSKFloat4Make(0.2f, 0.5f, 1.0f, 0.8f);
+    emitter.behaviorFlags = SSKRandomNext(random) % 4u;
+    emitter.damping = SSKRandomNext(random) % 3u == 0 ? SSKRandomNextRange(random, 0.1f, 0.8f) : 0.0f;
+    return emitter;
+}
+
+// Random populations and steps; returns how many scenarios ran something
+// narrower than the generic variant through `specialised`.
+static bool SSKBenchVerifySpecialisation(uint32_t *specialised) {
+    static const float globalDampings[] = {-0.3f, 0.0f, 0.0f, 0.4f};
+    const uint32_t capacity = 1024;
+    SSKRandom random = SSKRandomMake(17);
+    bool ok = true;
+    *specialised = 0;
+    for (uint32_t scenario = 0; ok && scenario < 200; scenario++) {
+        SSKParticleCore *generic = SSKParticleCoreCreate(capacity);
+        SSKParticleCore *narrow = SSKParticleCoreCreate(capacity);
+        if (!generic || !narrow) {
+            SSKParticleCoreDestroy(generic);
+            SSKParticleCoreDestroy(narrow);
+            return false;
+        }
+        uint32_t emitters = 1 + SSKRandomNext(&random) % 3u;
+        for (uint32_t e = 0; e < emitters; e++) {
+            SSKParticleEmitter emitter = SSKBenchEmitter(&random);
+            uint64_t seed = SSKRandomNext(&random);
+            SSKRandom ra = SSKRandomMake(seed);
+            SSKRandom rb = SSKRandomMake(seed);
+            SSKParticleCoreEmit(generic, &emitter, 300, &ra, NULL);
+            SSKParticleCoreEmit(narrow, &emitter, 300, &rb, NULL);
+        }
+        SSKParticleSimParams params;
+        params.gravity = SSKRandomNext(&random) % 2u ? SSKFloat2Make(0.0f, -98.0f) : SSKFloat2Make(0.0f, 0.0f);
+        params.dt = 1.0f / 60.0f;
+        params.globalDamping = globalDampings[SSKRandomNext(&random) % 4u];
+        uint32_t features = SSKParticleKernelFeaturesForStep(narrow, &params);
+        if (features != SSKParticleKernelFeatureAll) {
+            *specialised += 1;
+        }
+        for (int step = 0; step < 90; step++) {
+            SSKBenchStep(generic, &params, SSKParticleKernelFeatureAll);
+            SSKBenchStep(narrow, &params, features);
+        }
+        ok = memcmp(generic->storage, narrow->storage, SSKParticleCoreStorageSize(capacity)) == 0;
+        SSKParticleCoreDestroy(generic);
+        SSKParticleCoreDestroy(narrow);
+    }
+    return ok;
+}
+
+static bool SSKBenchVerifyReset(void) {
+    SSKParticleCore *core = SSKParticleCoreCreate(64);
+    if (!core) { return false; }
+    SSKRandom random = SSKRandomMake(3);
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.behaviorFlags = SSKParticleCoreBehaviorFadeSize;
+    emitter.damping = 0.2f;
+    SSKParticleCoreEmit(core, &emitter, 8, &random, NULL);
+    SSKParticleSimParams params = {SSKFloat2Make(0.0f, 0.0f), 1.0f / 60.0f, 0.0f};
+    bool ok = SSKParticleKernelFeaturesForStep(core, &params) ==
+              (SSKParticleKernelFeatureFadeSize | SSKParticleKernelFeatureDamping);
+    SSKParticleCoreReset(core);
+    ok = ok && SSKParticleKernelFeaturesForStep(core, &params) == 0u;
+    SSKParticleCoreDestroy(core);
+    return ok;
+}
+
+static void SSKBenchTimeSelection(void) {
+    const uint32_t iterations = 1u << 22;
+    volatile uint32_t sink = 0;
+    double start = SSKBenchNow();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sink += SSKParticleKernelSelectVariant(i & SSKParticleKernelFeatureAll, 0x8001u | (i << 4));
+    }
+    double elapsed = SSKBenchNow() - start;
+    printf("  select variant:                %6.2f ns/call\n", elapsed / iterations * 1e9);
+    (void)sink;
+}
+
+static void SSKBenchTimeStep(void) {
+    const uint32_t capacity = 65536;
+    const int steps = 40;
+    SSKParticleCore *core = SSKParticleCoreCreate(capacity);
+    if (!core) { return; }
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.angle = SSKFloatRangeMake(0.0f, 6.2831853f);
+    emitter.speed = SSKFloatRangeMake(20.0f, 200.0f);
+    emitter.maxLife = SSKFloatRangeMake(1000.0f, 1000.0f);
+    emitter.behaviorFlags = SSKParticleCoreBehaviorFadeAlpha;
+    SSKRandom random = SSKRandomMake(5);
+    SSKParticleCoreEmit(core, &emitter, capacity, &random, NULL);
+    SSKParticleSimParams params = {SSKFloat2Make(0.0f, 0.0f), 1.0f / 60.0f, 0.0f};
+    uint32_t variants[2] = {SSKParticleKernelFeatureAll, SSKParticleKernelFeaturesForStep(core, &params)};
+    const char *names[2] = {"generic", "specialised"};
+    for (int v = 0; v < 2; v++) {
+        double start = SSKBenchNow();
+        for (int step = 0; step < steps; step++) {
+            SSKBenchStep(core, &params, variants[v]);
+        }
+        double elapsed = SSKBenchNow() - start;
+        printf("  CPU step copy, %-11s    %6.2f ns/particle (features 0x%x)\n", names[v],
+               elapsed / ((double)steps * capacity) * 1e9, variants[v]);
+    }
+    SSKParticleCoreDestroy(core);
+}
+
+int main(void) {
+    printf("SSKParticleKernelVariantBench\n");
+    bool ok = SSKBenchVerifySelection();
+    SSKBenchCheck("selection matches brute force", ok);
+    uint32_t specialised = 0;
+    bool matches = SSKBenchVerifySpecialisation(&specialised);
+    printf("  specialised steps match generic (%u/200 narrower): %s\n", specialised,
+           SSKBenchStatus(matches && specialised > 0));
+    bool reset = SSKBenchVerifyReset();
+    SSKBenchCheck("used features cleared on reset", reset);
+    SSKBenchTimeSelection();
+    SSKBenchTimeStep();
+    return ok && matches && specialised > 0 && reset ? 0 : 1;
+}
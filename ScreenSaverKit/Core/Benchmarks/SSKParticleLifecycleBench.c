@@ -0,0 +1,262 @@
+#define _POSIX_C_SOURCE 200112L
+
+// GPU-resident particle lifecycle benchmark.
+//
+// Runs the CPU mirror of the emit/prepare/simulate/finalize kernels with the
+// threads of every dispatch in a shuffled order and checks after each step
+// that every slot is either alive or free exactly once, that emission claims
+// exactly min(request, free) slots, that the indirect arguments match the
+// counts, and that the compacted instances are the ones the CPU path would
+// draw. A second run in thread-index order must draw the same instances.
+// Then times the host's per-particle share of a frame on the dead-list path
+// (emit, retire the GPU's dead list, write instances), the whole frame on the
+// CPU, and the kernel mirror doing the resident path's work, none of which is
+// left to the host when it runs on the GPU.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleEmitter.h"
+#include "SSKParticleInstances.h"
+#include "SSKParticleLifecycle.h"
+
+typedef struct {
+    SSKParticleCore *core;
+    SSKParticleLifecycle lifecycle;
+    SSKParticleLifecycleState state;
+    SSKParticleInstance *instances;
+    uint32_t list;
+} SSKBenchWorld;
+
+/// `fill` poisons the instance buffer, so bytes a step leaves unwritten
+/// (padding included) differ between worlds and fail the comparisons.
+static bool SSKBenchWorldInit(SSKBenchWorld *world, uint32_t capacity, uint8_t fill) {
+    memset(world, 0, sizeof(*world));
+    world->core = SSKParticleCoreCreate(capacity);
+    world->lifecycle.state = &world->state;
+    world->lifecycle.aliveLists[0] = malloc(sizeof(uint32_t) * capacity);
+    world->lifecycle.aliveLists[1] = malloc(sizeof(uint32_t) * capacity);
+    world->lifecycle.freeSlots = malloc(sizeof(uint32_t) * capacity);
+    world->lifecycle.capacity = capacity;
+    world->instances = malloc(sizeof(SSKParticleInstance) * capacity);
+    if (world->instances) { memset(world->instances, fill, sizeof(SSKParticleInstance) * capacity); }
+    return world->core && world->lifecycle.aliveLists[0] && world->lifecycle.aliveLists[1] &&
+           world->lifecycle.freeSlots && world->instances;
+}
+
+static void SSKBenchWorldDestroy(SSKBenchWorld *world) {
+    SSKParticleCoreDestroy(world->core);
+    free(world->lifecycle.aliveLists[0]);
+    free(world->lifecycle.aliveLists[1]);
+    free(world->lifecycle.freeSlots);
+    free(world->instances);
+}
+
+static SSKParticleEmitter SSKBenchEmitter(void) {
+    SSKParticleEmitter emitter = SSKParticleEmitterDefault();
+    emitter.origin = SSKFloat2Make(960.0f, 540.0f);
+    emitter.originJitter = SSKFloat2Make(40.0f, 40.0f);
+    emitter.angle = SSKFloatRangeMake(0.0f, 6.2831853f);
+    emitter.speed = SSKFloatRangeMake(30.0f, 180.0f);
+    emitter.maxLife = SSKFloatRangeMake(0.2f, 1.4f);
+    emitter.size = SSKFloatRangeMake(2.0f, 6.0f);
+    emitter.damping = 0.3f;
+    emitter.colorStart = SSKFloat4Make(0.2f, 0.6f, 1.0f, 1.0f);
+    emitter.colorEnd = SSKFloat4Make(1.0f, 0.9f, 0.5f, 1.0f);
+    emitter.userScalar = 1.5f;
+    emitter.behaviorFlags = SSKParticleCoreBehaviorFadeAlpha | SSKParticleCoreBehaviorFadeSize;
+    return emitter;
+}
+
+static int SSKBenchCompareInstances(const void *a, const void *b) {
+    return memcmp(a, b, sizeof(SSKParticleInstance));
+}
+
+/// Checks the lifecycle invariants of `world` after a step that read list
+/// `world->list ^ 1`. `seen` and `expected` are scratch of `capacity` entries.
+static bool SSKBenchCheckStep(SSKBenchWorld *world, uint8_t *seen, SSKParticleInstance *expected) {
+    const SSKParticleLifecycle *lifecycle = &world->lifecycle;
+    const SSKParticleLifecycleState *state = lifecycle->state;
+    SSKParticleCore *core = world->core;
+    uint32_t capacity = lifecycle->capacity;
+    uint32_t out = world->list;
+    uint32_t aliveCount = state->aliveCount[out];
+    if (aliveCount + state->freeCount != capacity) { return false; }
+
+    memset(seen, 0, capacity);
+    for (uint32_t i = 0; i < aliveCount; i++) {
+        uint32_t slot = lifecycle->aliveLists[out][i];
+        if (slot >= capacity || seen[slot] || !core->alive[slot]) { return false; }
+        seen[slot] = 1;
+    }
+    for (uint32_t i = 0; i < state->freeCount; i++) {
+        uint32_t slot = lifecycle->freeSlots[i];
+        if (slot >= capacity || seen[slot] || core->alive[slot]) { return false; }
+        seen[slot] = 1;
+    }
+
+    uint32_t width = SSKParticleLifecycleThreadgroupWidth;
+    if (state->dispatchArgs[0] != (state->aliveCount[out ^ 1u] + width - 1) / width ||
+        state->dispatchArgs[1] != 1 || state->dispatchArgs[2] != 1) {
+        return false;
+    }
+    if (state->drawArgs[0] != 4 || state->drawArgs[1] != aliveCount || state->drawArgs[2] != 0 ||
+        state->drawArgs[3] != 0) {
+        return false;
+    }
+
+    // The lifecycle never maintains the core's own bookkeeping; sweep it all.
+    core->highWater = capacity;
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    uint32_t written = SSKParticleCoreWriteInstancesScalar(core, &style, expected, capacity);
+    if (written != aliveCount) { return false; }
+    qsort(expected, written, sizeof(SSKParticleInstance), SSKBenchCompareInstances);
+    qsort(world->instances, aliveCount, sizeof(SSKParticleInstance), SSKBenchCompareInstances);
+    return memcmp(expected, world->instances, sizeof(SSKParticleInstance) * aliveCount) == 0;
+}
+
+static bool SSKBenchVerify(void) {
+    const uint32_t capacity = 3000;
+    SSKBenchWorld shuffled;
+    SSKBenchWorld ordered;
+    uint8_t *seen = malloc(capacity);
+    SSKParticleInstance *expected = malloc(sizeof(SSKParticleInstance) * capacity);
+    bool ok = SSKBenchWorldInit(&shuffled, capacity, 0x11) && SSKBenchWorldInit(&ordered, capacity, 0x22) && seen &&
+              expected;
+    if (expected) { memset(expected, 0xBE, sizeof(SSKParticleInstance) * capacity); }
+
+    // Start from particles the CPU emitted, as when the mode is switched on.
+    SSKParticleEmitter emitter = SSKBenchEmitter();
+    SSKRandom warmup = SSKRandomMake(3);
+    for (int w = 0; ok && w < 2; w++) {
+        SSKBenchWorld *world = w == 0 ? &shuffled : &ordered;
+        SSKRandom random = warmup;
+        ok = SSKParticleCoreEmit(world->core, &emitter, 700, &random, NULL) == 700;
+        SSKParticleLifecycleLoad(&world->lifecycle, world->core->alive);
+        ok = ok && world->state.aliveCount[0] == 700 && world->state.freeCount == capacity - 700;
+    }
+
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, -40.0f), 1.0f / 60.0f, 0.05f };
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    SSKRandom requests = SSKRandomMake(11);
+    SSKRandom schedule = SSKRandomMake(12);
+    bool saturated = false;
+    bool drained = false;
+    for (uint32_t step = 0; ok && step < 600; step++) {
+        // Bursts that overrun the capacity, then quiet phases that drain it.
+        uint32_t request = (step % 150) < 40 ? SSKRandomNext(&requests) % 400 : 0;
+        uint64_t seed = (uint64_t)step * 0x9E3779B97F4A7C15ull;
+
+        uint32_t available = shuffled.state.freeCount;
+        uint32_t expectedEmitted = request < available ? request : available;
+        uint32_t emitted = SSKParticleLifecycleEmit(&shuffled.lifecycle, shuffled.core, shuffled.list, &emitter,
+                                                    request, seed, &schedule);
+        ok = emitted == expectedEmitted;
+        saturated = saturated || (request > 0 && emitted < request);
+        ok = ok && SSKParticleLifecycleEmit(&ordered.lifecycle, ordered.core, ordered.list, &emitter, request, seed,
+                                            NULL) == emitted;
+
+        shuffled.list = SSKParticleLifecycleSimulate(&shuffled.lifecycle, shuffled.core, shuffled.list, &params,
+                                                     &style, shuffled.instances, &schedule);
+        ordered.list = SSKParticleLifecycleSimulate(&ordered.lifecycle, ordered.core, ordered.list, &params, &style,
+                                                    ordered.instances, NULL);
+        ok = ok && SSKBenchCheckStep(&shuffled, seen, expected) && SSKBenchCheckStep(&ordered, seen, expected);
+
+        // Slots differ between the two runs; what gets drawn must not.
+        uint32_t count = shuffled.state.drawArgs[1];
+        ok = ok && ordered.state.drawArgs[1] == count &&
+             memcmp(shuffled.instances, ordered.instances, sizeof(SSKParticleInstance) * count) == 0;
+        drained = drained || (saturated && count == 0);
+    }
+    ok = ok && saturated && drained;
+
+    SSKBenchWorldDestroy(&shuffled);
+    SSKBenchWorldDestroy(&ordered);
+    free(seen);
+    free(expected);
+    return ok;
+}
+
+typedef enum {
+    /// Dead-list path, host share: retire the GPU's dead list, write instances.
+    SSKBenchModeDeadListHost,
+    /// The same frame entirely on the CPU: emit, step, retire, write instances.
+    SSKBenchModeCPUFrame,
+    /// The kernel mirror doing the resident path's work (all of it GPU work).
+    SSKBenchModeResident,
+} SSKBenchMode;
+
+/// Steady state around `live` particles, refilling what expires each frame.
+static void SSKBenchFrames(uint32_t live, SSKBenchMode mode) {
+    const uint32_t capacity = 65536;
+    const int frames = 200;
+    SSKBenchWorld world;
+    uint32_t *deadSlots = malloc(sizeof(uint32_t) * capacity);
+    if (!SSKBenchWorldInit(&world, capacity, 0) || !deadSlots) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    SSKParticleEmitter emitter = SSKBenchEmitter();
+    emitter.maxLife = SSKFloatRangeMake(1.0f, 3.0f);
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, 0.0f), 1.0f / 60.0f, 0.0f };
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    SSKRandom random = SSKRandomMake(5);
+    SSKParticleCoreEmit(world.core, &emitter, live, &random, NULL);
+    SSKParticleLifecycleLoad(&world.lifecycle, world.core->alive);
+
+    uint64_t drawn = 0;
+    double elapsed = 0.0;
+    // Lifetimes average two seconds, so about a 120th expire each frame.
+    uint32_t refill = live / 120 + 1;
+    for (int frame = 0; frame < frames; frame++) {
+        if (mode == SSKBenchModeResident) {
+            double start = SSKBenchNow();
+            SSKParticleLifecycleEmit(&world.lifecycle, world.core, world.list, &emitter, refill,
+                                     (uint64_t)frame, NULL);
+            world.list = SSKParticleLifecycleSimulate(&world.lifecycle, world.core, world.list, &params, &style,
+                                                      world.instances, NULL);
+            elapsed += SSKBenchNow() - start;
+            drawn += world.state.drawArgs[1];
+            continue;
+        }
+        double start = SSKBenchNow();
+        SSKParticleCoreEmit(world.core, &emitter, refill, &random, NULL);
+        if (mode == SSKBenchModeDeadListHost) {
+            elapsed += SSKBenchNow() - start;
+        }
+        uint32_t dead = SSKParticleCoreAdvanceSlots(world.core, &params, 0, world.core->highWater, deadSlots);
+        if (mode == SSKBenchModeDeadListHost) {
+            start = SSKBenchNow();
+        }
+        SSKParticleCoreRetireSlots(world.core, deadSlots, dead);
+        drawn += SSKParticleCoreWriteInstances(world.core, &style, world.instances, capacity);
+        elapsed += SSKBenchNow() - start;
+    }
+    static const char *const names[] = { "dead list, host share", "CPU frame", "resident, kernel mirror" };
+    printf("  %-24s %6u live: %6.2f ns/particle/frame\n", names[mode], live,
+           elapsed * 1e9 / (double)(drawn ? drawn : 1));
+    SSKBenchWorldDestroy(&world);
+    free(deadSlots);
+}
+
+int main(void) {
+    printf("SSKParticleLifecycleBench\n");
+    if (!SSKBenchVerify()) {
+        printf("  invariants under shuffled scheduling: FAILED\n");
+        return 1;
+    }
+    printf("  invariants under shuffled scheduling: ok\n");
+    const uint32_t counts[] = { 4096, 32768 };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        SSKBenchFrames(counts[i], SSKBenchModeDeadListHost);
+        SSKBenchFrames(counts[i], SSKBenchModeCPUFrame);
+        SSKBenchFrames(counts[i], SSKBenchModeResident);
+    }
+    printf("  (resident mode runs the mirrored work on the GPU; its host share is a fixed number of dispatches)\n");
+    return 0;
+}
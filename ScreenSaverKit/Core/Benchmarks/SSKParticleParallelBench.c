@@ -0,0 +1,155 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Scaling benchmark for the chunked parallel particle step.
+//
+// First checks determinism: 120 frames with spawning and expiry must leave
+// byte-identical streams, alive lists and free lists whether one worker or
+// several ran the chunks, and whether steps stayed on the calling thread
+// under the serial threshold or went to the pool. Then times 10k, 100k and 1M particles with 1..N
+// workers (N = online CPUs) and reports ms per step and speed-up over one
+// worker.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleParallel.h"
+
+static float SSKBenchUniform(uint32_t *state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(SSKBenchRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+static void SSKBenchSpawn(SSKParticleCore *core, uint32_t count, uint32_t *rng, float maxLife) {
+    uint32_t *slots = malloc(sizeof(uint32_t) * (count ? count : 1));
+    uint32_t spawned = SSKParticleCoreSpawn(core, count, slots);
+    for (uint32_t i = 0; i < spawned; i++) {
+        uint32_t slot = slots[i];
+        core->position[slot] = SSKFloat2Make(SSKBenchUniform(rng, 0, 1920), SSKBenchUniform(rng, 0, 1080));
+        core->velocity[slot] = SSKFloat2Make(SSKBenchUniform(rng, -200, 200), SSKBenchUniform(rng, -200, 200));
+        core->maxLife[slot] = maxLife > 0 ? maxLife : SSKBenchUniform(rng, 0.2f, 2.0f);
+        core->baseSize[slot] = SSKBenchUniform(rng, 1, 8);
+        core->size[slot] = core->baseSize[slot];
+        core->sizeRange[slot] = SSKFloat2Make(1.0f, 0.0f);
+        core->rotationVelocity[slot] = SSKBenchUniform(rng, -3, 3);
+        core->damping[slot] = SSKBenchUniform(rng, 0, 0.9f);
+        core->behaviorFlags[slot] = SSKBenchRandom(rng) & 3u;
+    }
+    free(slots);
+}
+
+/// Replays the same spawn/step sequence with `workers` participants; steps
+/// with fewer than `serialThreshold` live particles stay on this thread.
+static SSKParticleCore *SSKBenchReplay(uint32_t workers, uint32_t serialThreshold, uint32_t capacity) {
+    SSKParticleCore *core = SSKParticleCoreCreate(capacity);
+    SSKParticleParallel *parallel = SSKParticleParallelCreate(capacity, workers);
+    if (!core || !parallel) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    parallel->serialThreshold = serialThreshold;
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, -98.0f), 1.0f / 60.0f, 0.05f };
+    uint32_t rng = 99u;
+    for (int frame = 0; frame < 120; frame++) {
+        SSKBenchSpawn(core, core->slots.freeCount / 4 + 1, &rng, 0.0f);
+        SSKParticleParallelAdvance(parallel, core, &params);
+    }
+    SSKParticleParallelDestroy(parallel);
+    return core;
+}
+
+/// Whether two replays left identical live state, alive lists and free lists.
+static bool SSKBenchSameState(const SSKParticleCore *a, const SSKParticleCore *b) {
+    bool ok = a->aliveCount == b->aliveCount && a->slots.freeCount == b->slots.freeCount &&
+              memcmp(a->aliveList, b->aliveList, sizeof(uint32_t) * a->aliveCount) == 0 &&
+              memcmp(a->slots.freeStack, b->slots.freeStack, sizeof(uint32_t) * a->slots.freeCount) == 0;
+    for (uint32_t i = 0; ok && i < a->aliveCount; i++) {
+        uint32_t slot = a->aliveList[i];
+        ok = memcmp(&a->position[slot], &b->position[slot], sizeof(SSKFloat2)) == 0 &&
+             memcmp(&a->velocity[slot], &b->velocity[slot], sizeof(SSKFloat2)) == 0 &&
+             memcmp(&a->color[slot], &b->color[slot], sizeof(SSKFloat4)) == 0 &&
+             a->size[slot] == b->size[slot] && a->life[slot] == b->life[slot];
+    }
+    return ok;
+}
+
+static bool SSKBenchVerifyDeterminism(uint32_t workers) {
+    const uint32_t capacity = 50000;
+    SSKParticleCore *reference = SSKBenchReplay(workers, 0, capacity);
+    // One worker with the default threshold is what `SSKParticleSystem` runs
+    // at `workerCount` 1; the live count crosses the threshold during the run.
+    SSKParticleCore *variants[] = {
+        SSKBenchReplay(1, 0, capacity),
+        SSKBenchReplay(1, SSKParticleParallelDefaultSerialThreshold, capacity),
+        SSKBenchReplay(workers, SSKParticleParallelDefaultSerialThreshold, capacity),
+        SSKBenchReplay(workers, UINT32_MAX, capacity),
+    };
+    static const char *labels[] = {
+        "1 worker", "1 worker, default threshold", "default threshold", "always below threshold",
+    };
+    bool ok = true;
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        bool same = SSKBenchSameState(reference, variants[v]);
+        printf("  determinism %u workers vs %s (%u alive): %s\n", workers, labels[v], reference->aliveCount,
+               SSKBenchStatus(same));
+        ok = ok && same;
+        SSKParticleCoreDestroy(variants[v]);
+    }
+    SSKParticleCoreDestroy(reference);
+    return ok;
+}
+
+static double SSKBenchMeasure(uint32_t workers, uint32_t count) {
+    SSKParticleCore *core = SSKParticleCoreCreate(count);
+    SSKParticleParallel *parallel = SSKParticleParallelCreate(count, workers);
+    if (!core || !parallel) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    parallel->serialThreshold = 0;
+    uint32_t rng = 7u;
+    SSKBenchSpawn(core, count, &rng, 1e9f);
+
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, -98.0f), 1.0f / 60.0f, 0.05f };
+    SSKParticleParallelAdvance(parallel, core, &params);
+
+    uint64_t frames = 0;
+    double start = SSKBenchNow();
+    double elapsed = 0.0;
+    do {
+        SSKParticleParallelAdvance(parallel, core, &params);
+        frames++;
+        elapsed = SSKBenchNow() - start;
+    } while (elapsed < 0.25 || frames < 4);
+
+    SSKParticleParallelDestroy(parallel);
+    SSKParticleCoreDestroy(core);
+    return elapsed / (double)frames;
+}
+
+int main(void) {
+    static const uint32_t counts[] = { 10000, 100000, 1000000 };
+    uint32_t hardware = SSKTaskPoolHardwareConcurrency();
+    bool ok = true;
+
+    printf("SSKParticleParallelBench (%u CPUs, chunk %u slots)\n", hardware, (unsigned)SSKParticleParallelChunkSize);
+    // Oversubscribe on purpose so determinism is checked even on small machines.
+    ok &= SSKBenchVerifyDeterminism(3);
+    ok &= SSKBenchVerifyDeterminism(hardware > 1 ? hardware : 2);
+
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        double single = 0.0;
+        // 1, 2, 4, ... and finally every CPU.
+        for (uint32_t workers = 1;; workers = (workers * 2 < hardware) ? workers * 2 : hardware) {
+            double seconds = SSKBenchMeasure(workers, counts[c]);
+            if (workers == 1) { single = seconds; }
+            printf("  %8u particles, %2u workers: %8.3f ms/step (%.2fx)\n",
+                   counts[c], workers, seconds * 1e3, single / seconds);
+            if (workers == hardware) { break; }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Software particle rasterizer benchmark.
+//
+// Checks the tiled rasterizer against a naive reference that evaluates the
+// `particleVertex` / `particleFragment` maths in particle space for every
+// pixel and every instance, for both blend modes and both target formats.
+// Then checks exact coverage and softness on hand-computed quads and that the
+// output is bit-identical for any tile size and worker count. Finally times
+// full-HD frames from 1k to 50k particles and prints a checksum of a fixed
+// scene, usable as a golden value on a given toolchain.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleRaster.h"
+#include "SSKRandom.h"
+#include "SSKTaskPool.h"
+
+/// Random streaks like the default Metal instance style: width 2-10, twelve
+/// times as long, random direction, mostly soft.
+static SSKParticleInstance *SSKBenchInstances(uint32_t count, float width, float height, uint64_t seed) {
+    SSKParticleInstance *instances = calloc(count, sizeof(SSKParticleInstance));
+    if (!instances) { return NULL; }
+    SSKRandom random = SSKRandomMake(seed);
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleInstance *instance = &instances[i];
+        float angle = SSKRandomNextRange(&random, 0.0f, 6.2831853f);
+        instance->position = SSKFloat2Make(SSKRandomNextRange(&random, -20.0f, width + 20.0f),
+                                           SSKRandomNextRange(&random, -20.0f, height + 20.0f));
+        instance->direction = SSKFloat2Make(cosf(angle), sinf(angle));
+        instance->width = SSKRandomNextRange(&random, 2.0f, 10.0f);
+        instance->length = instance->width * 12.0f;
+        instance->color = (SSKFloat4){SSKRandomNextUnit(&random), SSKRandomNextUnit(&random),
+                                      SSKRandomNextUnit(&random), SSKRandomNextRange(&random, 0.2f, 1.0f)};
+        instance->softness = i % 4 == 0 ? 0.0f : SSKRandomNextRange(&random, 0.5f, 6.0f);
+    }
+    return instances;
+}
+
+static SSKRasterTarget SSKBenchTarget(uint32_t width, uint32_t height, SSKRasterFormat format) {
+    size_t pixelBytes = format == SSKRasterFormatRGBA8 ? 4 : sizeof(SSKFloat4);
+    SSKRasterTarget target = {calloc((size_t)width * height, pixelBytes), width, height, width * pixelBytes, format};
+    return target;
+}
+
+static inline float SSKBenchQuantize(float value) {
+    value = fminf(fmaxf(value, 0.0f), 1.0f);
+    return floorf(value * 255.0f + 0.5f) / 255.0f;
+}
+
+static SSKFloat4 SSKBenchLoad(const SSKRasterTarget *target, uint32_t x, uint32_t y) {
+    const uint8_t *row = (const uint8_t *)target->pixels + (size_t)y * target->rowBytes;
+    if (target->format == SSKRasterFormatFloat) { return ((const SSKFloat4 *)(const void *)row)[x]; }
+    const uint8_t *p = row + x * 4;
+    return (SSKFloat4){p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, p[3] / 255.0f};
+}
+
+static void SSKBenchStore(const SSKRasterTarget *target, uint32_t x, uint32_t y, SSKFloat4 v) {
+    uint8_t *row = (uint8_t *)target->pixels + (size_t)y * target->rowBytes;
+    if (target->format == SSKRasterFormatFloat) {
+        ((SSKFloat4 *)(void *)row)[x] = v;
+        return;
+    }
+    uint8_t *p = row + x * 4;
+    p[0] = (uint8_t)lrintf(v.x * 255.0f);
+    p[1] = (uint8_t)lrintf(v.y * 255.0f);
+    p[2] = (uint8_t)lrintf(v.z * 255.0f);
+    p[3] = (uint8_t)lrintf(v.w * 255.0f);
+}
+
+/// Shader maths in particle space, one pixel and one instance at a time.
+static void SSKBenchReferenceDraw(const SSKRasterTarget *target, const SSKParticleRasterParams *params,
+                                  const SSKParticleInstance *instances, uint32_t count) {
+    for (uint32_t y = 0; y < target->height; y++) {
+        for (uint32_t x = 0; x < target->width; x++) {
+            double wx = params->origin.x + (x + 0.5) * params->size.x / target->width;
+            double wy = params->origin.y + (y + 0.5) * params->size.y / target->height;
+            SSKFloat4 d = SSKBenchLoad(target, x, y);
+            for (uint32_t i = 0; i < count; i++) {
+                const SSKParticleInstance *in = &instances[i];
+                double len = hypot(in->direction.x, in->direction.y);
+                double fx = in->direction.x / len, fy = in->direction.y / len;
+                if (!isfinite(fx) || !isfinite(fy)) { fx = 1.0; fy = 0.0; }
+                double dx = wx - in->position.x, dy = wy - in->position.y;
+                double qa = (-fy * dx + fx * dy) / in->width;   // along `right`
+                double qb = (fx * dx + fy * dy) / in->length;   // along `forward`
+                if (!(qa >= -0.5 && qa < 0.5 && qb >= -0.5 && qb < 0.5)) { continue; }
+                float alpha = in->color.w;
+                if (in->softness > 0.01f) {
+                    alpha = in->color.w * expf(-in->softness * (float)(qa * qa + qb * qb) * 4.0f);
+                }
+                if (params->blend == SSKRasterBlendAdditive) {
+                    d = (SSKFloat4){d.x + in->color.x, d.y + in->color.y, d.z + in->color.z, d.w + alpha};
+                } else {
+                    d = (SSKFloat4){in->color.x * alpha + d.x * (1.0f - alpha), in->color.y * alpha + d.y * (1.0f - alpha),
+                                    in->color.z * alpha + d.z * (1.0f - alpha), alpha * alpha + d.w * (1.0f - alpha)};
+                }
+                if (target->format == SSKRasterFormatRGBA8) {
+                    d = (SSKFloat4){SSKBenchQuantize(d.x), SSKBenchQuantize(d.y), SSKBenchQuantize(d.z),
+                                    SSKBenchQuantize(d.w)};
+                }
+            }
+            SSKBenchStore(target, x, y, d);
+        }
+    }
+}
+
+/// Pixels whose channels differ by more than `tolerance`. The reference works
+/// in double precision, so pixel centres that sit exactly on a quad edge may
+/// round the other way; a handful of such pixels is expected.
+static uint32_t SSKBenchMismatches(const SSKRasterTarget *a, const SSKRasterTarget *b, float tolerance) {
+    uint32_t mismatches = 0;
+    for (uint32_t y = 0; y < a->height; y++) {
+        for (uint32_t x = 0; x < a->width; x++) {
+            SSKFloat4 p = SSKBenchLoad(a, x, y), q = SSKBenchLoad(b, x, y);
+            float diff = fmaxf(fmaxf(fabsf(p.x - q.x), fabsf(p.y - q.y)), fmaxf(fabsf(p.z - q.z), fabsf(p.w - q.w)));
+            if (diff > tolerance) { mismatches++; }
+        }
+    }
+    return mismatches;
+}
+
+static bool SSKBenchVerifyReference(SSKRasterFormat format, SSKRasterBlend blend) {
+    const uint32_t width = 240, height = 135;
+    SSKParticleInstance *instances = SSKBenchInstances(400, 480.0f, 270.0f, 5);
+    SSKRasterTarget tiled = SSKBenchTarget(width, height, format);
+    SSKRasterTarget reference = SSKBenchTarget(width, height, format);
+    bool ok = instances && tiled.pixels && reference.pixels;
+    // Half-resolution target, offset origin: exercises the viewport mapping.
+    SSKParticleRasterParams params = {SSKFloat2Make(-10.0f, 5.0f), SSKFloat2Make(480.0f, 270.0f), blend};
+    SSKFloat4 clear = {0.1f, 0.2f, 0.3f, 1.0f};
+    SSKParticleRasterizer rasterizer;
+    SSKParticleRasterizerInit(&rasterizer, 32);
+    if (ok) {
+        SSKRasterTargetClear(&tiled, clear);
+        SSKRasterTargetClear(&reference, clear);
+        ok = SSKParticleRasterizerDraw(&rasterizer, NULL, &tiled, &params, instances, 400);
+        SSKBenchReferenceDraw(&reference, &params, instances, 400);
+    }
+    float tolerance = format == SSKRasterFormatRGBA8 ? 1.5f / 255.0f : 1e-4f;
+    uint32_t mismatches = ok ? SSKBenchMismatches(&tiled, &reference, tolerance) : 0;
+    ok = ok && mismatches <= width * height / 1000;
+    printf("  reference  %-5s %-8s: %u of %u pixels differ: %s\n",
+           format == SSKRasterFormatRGBA8 ? "rgba8" : "float", blend == SSKRasterBlendAlpha ? "alpha" : "additive",
+           mismatches, width * height, SSKBenchStatus(ok));
+    SSKParticleRasterizerDestroy(&rasterizer);
+    free(instances);
+    free(tiled.pixels);
+    free(reference.pixels);
+    return ok;
+}
+
+static bool SSKBenchVerifyExact(void) {
+    SSKRasterTarget target = SSKBenchTarget(100, 100, SSKRasterFormatFloat);
+    if (!target.pixels) { return false; }
+    SSKParticleRasterizer rasterizer;
+    SSKParticleRasterizerInit(&rasterizer, 16);
+    SSKParticleRasterParams params = {SSKFloat2Make(0.0f, 0.0f), SSKFloat2Make(100.0f, 100.0f), SSKRasterBlendAlpha};
+
+    // Hard quad, 20 long along x and 10 wide along y: exactly 200 pixels.
+    SSKParticleInstance hard = {SSKFloat2Make(50.0f, 40.0f), SSKFloat2Make(1.0f, 0.0f), 10.0f, 20.0f,
+                                {0}, {1.0f, 1.0f, 1.0f, 1.0f}, 0.0f, {0}};
+    SSKRasterTargetClear(&target, (SSKFloat4){0});
+    SSKParticleRasterizerDraw(&rasterizer, NULL, &target, &params, &hard, 1);
+    uint32_t covered = 0;
+    for (uint32_t y = 0; y < 100; y++) {
+        for (uint32_t x = 0; x < 100; x++) {
+            if (SSKBenchLoad(&target, x, y).w > 0.0f) { covered++; }
+        }
+    }
+    bool ok = covered == 200 && SSKBenchLoad(&target, 40, 35).w == 1.0f && SSKBenchLoad(&target, 39, 35).w == 0.0f &&
+              SSKBenchLoad(&target, 59, 44).w == 1.0f && SSKBenchLoad(&target, 60, 44).w == 0.0f;
+
+    // Soft quad: pixel (50, 40) has its centre at quad coordinate (0.05, 0.025).
+    SSKParticleInstance soft = hard;
+    soft.softness = 2.0f;
+    SSKRasterTargetClear(&target, (SSKFloat4){0});
+    SSKParticleRasterizerDraw(&rasterizer, NULL, &target, &params, &soft, 1);
+    float expected = expf(-2.0f * (0.05f * 0.05f + 0.025f * 0.025f) * 4.0f);
+    SSKFloat4 centre = SSKBenchLoad(&target, 50, 40);
+    ok = ok && fabsf(centre.x - expected) < 1e-6f && fabsf(centre.w - expected * expected) < 1e-6f;
+
+    // A zero direction falls back to (1, 0) like the shader.
+    SSKParticleInstance still = hard;
+    still.direction = SSKFloat2Make(0.0f, 0.0f);
+    SSKRasterTargetClear(&target, (SSKFloat4){0});
+    SSKParticleRasterizerDraw(&rasterizer, NULL, &target, &params, &still, 1);
+    ok = ok && SSKBenchLoad(&target, 40, 35).w == 1.0f && SSKBenchLoad(&target, 50, 46).w == 0.0f;
+
+    printf("  coverage %u pixels (expected 200), soft centre %.6f (expected %.6f): %s\n", covered, centre.x,
+           expected, SSKBenchStatus(ok));
+    SSKParticleRasterizerDestroy(&rasterizer);
+    free(target.pixels);
+    return ok;
+}
+
+static uint64_t SSKBenchChecksum(const SSKRasterTarget *target) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t y = 0; y < target->height; y++) {
+        const uint8_t *row = (const uint8_t *)target->pixels + (size_t)y * target->rowBytes;
+        for (size_t b = 0; b < (size_t)target->width * 4; b++) {
+            hash = (hash ^ row[b]) * 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+
+static bool SSKBenchVerifyDeterminism(SSKTaskPool *pool) {
+    const uint32_t width = 640, height = 360, count = 5000;
+    SSKParticleInstance *instances = SSKBenchInstances(count, (float)width, (float)height, 9);
+    SSKRasterTarget a = SSKBenchTarget(width, height, SSKRasterFormatRGBA8);
+    SSKRasterTarget b = SSKBenchTarget(width, height, SSKRasterFormatRGBA8);
+    bool ok = instances && a.pixels && b.pixels;
+    SSKParticleRasterParams params = {SSKFloat2Make(0.0f, 0.0f), SSKFloat2Make((float)width, (float)height),
+                                      SSKRasterBlendAlpha};
+    SSKParticleRasterizer serial, parallel;
+    SSKParticleRasterizerInit(&serial, 16);
+    SSKParticleRasterizerInit(&parallel, 64);
+    if (ok) {
+        ok = SSKParticleRasterizerDraw(&serial, NULL, &a, &params, instances, count) &&
+             SSKParticleRasterizerDraw(&parallel, pool, &b, &params, instances, count);
+        ok = ok && memcmp(a.pixels, b.pixels, a.rowBytes * height) == 0;
+    }
+    printf("  16px tiles serial vs 64px tiles on %u workers: %s (checksum %016llx)\n", SSKTaskPoolWorkerCount(pool),
+           ok ? "identical" : "FAILED", ok ? (unsigned long long)SSKBenchChecksum(&a) : 0ull);
+    SSKParticleRasterizerDestroy(&serial);
+    SSKParticleRasterizerDestroy(&parallel);
+    free(instances);
+    free(a.pixels);
+    free(b.pixels);
+    return ok;
+}
+
+static void SSKBenchTime(uint32_t count, SSKTaskPool *pool) {
+    const uint32_t width = 1920, height = 1080;
+    SSKParticleInstance *instances = SSKBenchInstances(count, (float)width, (float)height, 3);
+    SSKRasterTarget target = SSKBenchTarget(width, height, SSKRasterFormatRGBA8);
+    SSKParticleRasterizer rasterizer;
+    SSKParticleRasterizerInit(&rasterizer, 0);
+    if (!instances || !target.pixels) { return; }
+    SSKParticleRasterParams params = {SSKFloat2Make(0.0f, 0.0f), SSKFloat2Make((float)width, (float)height),
+                                      SSKRasterBlendAdditive};
+    int rounds = count <= 10000 ? 10 : 3;
+    double timings[2];
+    for (int pass = 0; pass < 2; pass++) {
+        SSKTaskPool *usedPool = pass == 0 ? NULL : pool;
+        SSKParticleRasterizerDraw(&rasterizer, usedPool, &target, &params, instances, count);
+        double start = SSKBenchNow();
+        for (int r = 0; r < rounds; r++) {
+            SSKRasterTargetClear(&target, (SSKFloat4){0.0f, 0.0f, 0.0f, 1.0f});
+            SSKParticleRasterizerDraw(&rasterizer, usedPool, &target, &params, instances, count);
+        }
+        timings[pass] = (SSKBenchNow() - start) / rounds;
+    }
+    printf("  %6u particles at %ux%u: %7.2f ms/frame (%6.1f ns/particle), %u workers %7.2f ms/frame\n", count,
+           width, height, timings[0] * 1e3, timings[0] * 1e9 / count, SSKTaskPoolWorkerCount(pool),
+           timings[1] * 1e3);
+    SSKParticleRasterizerDestroy(&rasterizer);
+    free(instances);
+    free(target.pixels);
+}
+
+int main(void) {
+    printf("SSKParticleRasterBench\n");
+    SSKTaskPool *pool = SSKTaskPoolCreate(4);
+    if (!pool) { return 1; }
+    bool ok = SSKBenchVerifyReference(SSKRasterFormatRGBA8, SSKRasterBlendAlpha);
+    ok = SSKBenchVerifyReference(SSKRasterFormatRGBA8, SSKRasterBlendAdditive) && ok;
+    ok = SSKBenchVerifyReference(SSKRasterFormatFloat, SSKRasterBlendAlpha) && ok;
+    ok = SSKBenchVerifyReference(SSKRasterFormatFloat, SSKRasterBlendAdditive) && ok;
+    ok = SSKBenchVerifyExact() && ok;
+    ok = SSKBenchVerifyDeterminism(pool) && ok;
+    if (!ok) {
+        SSKTaskPoolDestroy(pool);
+        return 1;
+    }
+
+    const uint32_t counts[] = {1000, 10000, 50000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        SSKBenchTime(counts[i], pool);
+    }
+    SSKTaskPoolDestroy(pool);
+    return 0;
+}
@@ -0,0 +1,164 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Micro-benchmark for the vectorised particle step.
+//
+// For every SIMD level the CPU supports, first replays a few hundred frames
+// (with spawning and expiry) against the scalar phase loops and checks that
+// liveness matches exactly and every float stream stays within tolerance, then
+// times the steady-state step and reports particles per second.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKParticleSIMD.h"
+
+static const float kSSKBenchTolerance = 1e-4f;
+
+static float SSKBenchUniform(uint32_t *state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(SSKBenchRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+static void SSKBenchSpawn(SSKParticleCore *core, uint32_t count, uint32_t *rng, float maxLife) {
+    uint32_t *slots = malloc(sizeof(uint32_t) * (count ? count : 1));
+    uint32_t spawned = SSKParticleCoreSpawn(core, count, slots);
+    for (uint32_t i = 0; i < spawned; i++) {
+        uint32_t slot = slots[i];
+        core->position[slot] = SSKFloat2Make(SSKBenchUniform(rng, 0, 1920), SSKBenchUniform(rng, 0, 1080));
+        core->velocity[slot] = SSKFloat2Make(SSKBenchUniform(rng, -200, 200), SSKBenchUniform(rng, -200, 200));
+        core->baseColor[slot] = SSKFloat4Make(SSKBenchUniform(rng, 0, 1), SSKBenchUniform(rng, 0, 1),
+                                              SSKBenchUniform(rng, 0, 1), 1.0f);
+        core->color[slot] = core->baseColor[slot];
+        core->maxLife[slot] = maxLife > 0 ? maxLife : SSKBenchUniform(rng, 0.2f, 2.0f);
+        core->baseSize[slot] = SSKBenchUniform(rng, 1, 8);
+        core->size[slot] = core->baseSize[slot];
+        core->sizeRange[slot] = SSKFloat2Make(1.0f, SSKBenchUniform(rng, 0, 2));
+        core->sizeVelocity[slot] = (SSKBenchRandom(rng) & 3) == 0 ? SSKBenchUniform(rng, -2, 2) : 0.0f;
+        core->rotationVelocity[slot] = SSKBenchUniform(rng, -3, 3);
+        core->damping[slot] = SSKBenchUniform(rng, 0, 0.9f);
+        core->behaviorFlags[slot] = SSKBenchRandom(rng) & 3u;
+    }
+    free(slots);
+}
+
+/// Relative error with a floor on the scale, so values that cross zero (a
+/// velocity turned around by gravity) are judged against the field's typical
+/// magnitude instead of blowing up near zero.
+static float SSKBenchError(float a, float b, float floor) {
+    float diff = fabsf(a - b);
+    float scale = fmaxf(floor, fmaxf(fabsf(a), fabsf(b)));
+    return diff / scale;
+}
+
+static bool SSKBenchVerify(SSKSIMDLevel level, uint32_t capacity) {
+    SSKParticleCore *reference = SSKParticleCoreCreate(capacity);
+    SSKParticleCore *candidate = SSKParticleCoreCreate(capacity);
+    if (!reference || !candidate) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    reference->simdLevel = SSKSIMDLevelScalar;
+    candidate->simdLevel = level;
+
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, -98.0f), 1.0f / 60.0f, 0.05f };
+    uint32_t referenceRng = 1234u, candidateRng = 1234u;
+    float worst = 0.0f;
+    bool ok = true;
+
+    for (int frame = 0; frame < 300 && ok; frame++) {
+        SSKBenchSpawn(reference, reference->slots.freeCount, &referenceRng, 0.0f);
+        SSKBenchSpawn(candidate, candidate->slots.freeCount, &candidateRng, 0.0f);
+        SSKParticleCoreAdvance(reference, &params);
+        SSKParticleCoreAdvance(candidate, &params);
+
+        if (reference->aliveCount != candidate->aliveCount) {
+            ok = false;
+            break;
+        }
+        for (uint32_t i = 0; i < reference->aliveCount; i++) {
+            uint32_t slot = reference->aliveList[i];
+            if (candidate->aliveList[i] != slot || reference->life[slot] != candidate->life[slot]) {
+                ok = false;
+                break;
+            }
+            float e = 0.0f;
+            e = fmaxf(e, SSKBenchError(reference->position[slot].x, candidate->position[slot].x, 256.0f));
+            e = fmaxf(e, SSKBenchError(reference->position[slot].y, candidate->position[slot].y, 256.0f));
+            e = fmaxf(e, SSKBenchError(reference->velocity[slot].x, candidate->velocity[slot].x, 256.0f));
+            e = fmaxf(e, SSKBenchError(reference->velocity[slot].y, candidate->velocity[slot].y, 256.0f));
+            e = fmaxf(e, SSKBenchError(reference->userVector[slot].x, candidate->userVector[slot].x, 1.0f));
+            e = fmaxf(e, SSKBenchError(reference->userVector[slot].y, candidate->userVector[slot].y, 1.0f));
+            e = fmaxf(e, SSKBenchError(reference->size[slot], candidate->size[slot], 1.0f));
+            e = fmaxf(e, SSKBenchError(reference->rotation[slot], candidate->rotation[slot], 1.0f));
+            e = fmaxf(e, SSKBenchError(reference->color[slot].w, candidate->color[slot].w, 1.0f));
+            worst = fmaxf(worst, e);
+        }
+        if (worst > kSSKBenchTolerance) {
+            ok = false;
+        }
+    }
+
+    printf("  verify %-7s capacity %7u: %s (max relative error %.2e)\n",
+           SSKSIMDLevelName(level), capacity, ok ? "ok" : "MISMATCH", worst);
+    SSKParticleCoreDestroy(reference);
+    SSKParticleCoreDestroy(candidate);
+    return ok;
+}
+
+static double SSKBenchMeasure(SSKSIMDLevel level, uint32_t count) {
+    SSKParticleCore *core = SSKParticleCoreCreate(count);
+    if (!core) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    core->simdLevel = level;
+    uint32_t rng = 42u;
+    // Effectively immortal particles keep the population fixed while timing.
+    SSKBenchSpawn(core, count, &rng, 1e9f);
+
+    SSKParticleSimParams params = { SSKFloat2Make(0.0f, -98.0f), 1.0f / 60.0f, 0.05f };
+    SSKParticleCoreAdvance(core, &params);
+
+    uint64_t frames = 0;
+    double start = SSKBenchNow();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 8; i++) {
+            SSKParticleCoreAdvance(core, &params);
+        }
+        frames += 8;
+        elapsed = SSKBenchNow() - start;
+    } while (elapsed < 0.25);
+
+    SSKParticleCoreDestroy(core);
+    return (double)count * (double)frames / elapsed;
+}
+
+int main(void) {
+    static const uint32_t counts[] = { 4096, 65536, 262144 };
+    bool ok = true;
+
+    printf("SSKParticleSIMDBench (best level: %s)\n", SSKSIMDLevelName(SSKSIMDBestLevel()));
+    for (int level = SSKSIMDLevelSSE2; level < SSKSIMDLevelCount; level++) {
+        if (SSKSIMDLevelIsSupported((SSKSIMDLevel)level)) {
+            ok &= SSKBenchVerify((SSKSIMDLevel)level, 1000);
+            ok &= SSKBenchVerify((SSKSIMDLevel)level, 4099);
+        }
+    }
+
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        double scalar = 0.0;
+        for (int level = SSKSIMDLevelScalar; level < SSKSIMDLevelCount; level++) {
+            if (!SSKSIMDLevelIsSupported((SSKSIMDLevel)level)) { continue; }
+            double rate = SSKBenchMeasure((SSKSIMDLevel)level, counts[c]);
+            if (level == SSKSIMDLevelScalar) { scalar = rate; }
+            printf("  %-7s %8u particles: %8.1f M particles/s (%.2fx scalar)\n",
+                   SSKSIMDLevelName((SSKSIMDLevel)level), counts[c], rate * 1e-6, rate / scalar);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Preference snapshot benchmark.
+//
+// Declares a schema shaped like the Starfield saver's (a star count, five
+// ranged doubles, two switches, a choice and an object key) and checks
+// ingest: defaults are clamped, out-of-range, fractional and NaN values are
+// fixed up once, dirty bits name exactly the keys a batch changed, a batch
+// that changes nothing leaves the version alone, and the key limit holds.
+// The timing lines are the cost of a frame reading every value and of
+// ingesting a one-key change.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "SSKBench.h"
+#include "SSKPreferenceSnapshot.h"
+
+enum {
+    SSKBenchStarCount,
+    SSKBenchSpeed,
+    SSKBenchFieldOfView,
+    SSKBenchStarSize,
+    SSKBenchBlurAmount,
+    SSKBenchMotionBlur,
+    SSKBenchDirectionShifts,
+    SSKBenchPalette,
+    SSKBenchTint,
+    SSKBenchKeyCount,
+};
+
+static const SSKPreferenceKeySpec SSKBenchSpecs[SSKBenchKeyCount] = {
+    {SSKPreferenceTypeInteger, 320.0, 50.0, 4000.0},
+    {SSKPreferenceTypeDouble, 1.4, 0.05, 4.0},
+    {SSKPreferenceTypeDouble, 1.35, 0.5, 2.2},
+    {SSKPreferenceTypeDouble, 0.05, 0.1, 3.0},  // default below the range
+    {SSKPreferenceTypeDouble, 0.65, 1.5, 0.0},  // range given backwards
+    {SSKPreferenceTypeBool, 1.0, 0.0, 0.0},
+    {SSKPreferenceTypeBool, 1.0, 0.0, 0.0},
+    {SSKPreferenceTypeChoice, 2.0, 0.0, 3.0},
+    {SSKPreferenceTypeObject, 0.0, 0.0, 0.0},
+};
+
+static bool SSKBenchBuild(SSKPreferenceSnapshot *snapshot) {
+    SSKPreferenceSnapshotInit(snapshot);
+    for (uint32_t i = 0; i < SSKBenchKeyCount; i++) {
+        if (SSKPreferenceSnapshotAddKey(snapshot, &SSKBenchSpecs[i]) != (int32_t)i) { return false; }
+    }
+    return true;
+}
+
+static bool SSKBenchIngest(void) {
+    SSKPreferenceSnapshot snapshot;
+    bool ok = SSKBenchBuild(&snapshot);
+    const uint64_t all = (UINT64_C(1) << SSKBenchKeyCount) - 1;
+    ok = ok && snapshot.dirty == all && snapshot.version == 0;
+    ok = ok && SSKPreferenceSnapshotInteger(&snapshot, SSKBenchStarCount) == 320 &&
+         SSKPreferenceSnapshotDouble(&snapshot, SSKBenchStarSize) == 0.1 &&
+         snapshot.specs[SSKBenchBlurAmount].minimum == 0.0 && snapshot.specs[SSKBenchBlurAmount].maximum == 1.5 &&
+         SSKPreferenceSnapshotBool(&snapshot, SSKBenchMotionBlur) &&
+         SSKPreferenceSnapshotInteger(&snapshot, SSKBenchPalette) == 2;
+
+    // Bad values are fixed up at ingest and only real changes are dirty.
+    SSKPreferenceSnapshotBeginIngest(&snapshot);
+    ok = ok && SSKPreferenceSnapshotSet(&snapshot, SSKBenchStarCount, 99999.0);
+    ok = ok && SSKPreferenceSnapshotSet(&snapshot, SSKBenchSpeed, -3.0);
+    ok = ok && !SSKPreferenceSnapshotSet(&snapshot, SSKBenchFieldOfView, 1.35);
+    ok = ok && !SSKPreferenceSnapshotSet(&snapshot, SSKBenchMotionBlur, 7.0);
+    ok = ok && SSKPreferenceSnapshotSet(&snapshot, SSKBenchPalette, 0.6);
+    SSKPreferenceSnapshotMarkDirty(&snapshot, SSKBenchTint);
+    uint64_t dirty = SSKPreferenceSnapshotEndIngest(&snapshot);
+    uint64_t expected = (UINT64_C(1) << SSKBenchStarCount) | (UINT64_C(1) << SSKBenchSpeed) |
+                        (UINT64_C(1) << SSKBenchPalette) | (UINT64_C(1) << SSKBenchTint);
+    ok = ok && dirty == expected && snapshot.version == 1;
+    ok = ok && SSKPreferenceSnapshotInteger(&snapshot, SSKBenchStarCount) == 4000 &&
+         SSKPreferenceSnapshotDouble(&snapshot, SSKBenchSpeed) == 0.05 &&
+         SSKPreferenceSnapshotInteger(&snapshot, SSKBenchPalette) == 1 &&
+         SSKPreferenceSnapshotIsDirty(&snapshot, SSKBenchTint) &&
+         !SSKPreferenceSnapshotIsDirty(&snapshot, SSKBenchFieldOfView);
+
+    // NaN and removed values fall back to the default; a quiet batch keeps
+    // the version.
+    SSKPreferenceSnapshotBeginIngest(&snapshot);
+    ok = ok && SSKPreferenceSnapshotSet(&snapshot, SSKBenchSpeed, NAN) &&
+         SSKPreferenceSnapshotDouble(&snapshot, SSKBenchSpeed) == 1.4;
+    ok = ok && SSKPreferenceSnapshotSetDefault(&snapshot, SSKBenchStarCount) &&
+         SSKPreferenceSnapshotInteger(&snapshot, SSKBenchStarCount) == 320;
+    ok = ok && SSKPreferenceSnapshotEndIngest(&snapshot) != 0 && snapshot.version == 2;
+    SSKPreferenceSnapshotBeginIngest(&snapshot);
+    ok = ok && !SSKPreferenceSnapshotSet(&snapshot, SSKBenchSpeed, 1.4) &&
+         !SSKPreferenceSnapshotSet(&snapshot, SSKBenchKeyCount, 1.0);
+    ok = ok && SSKPreferenceSnapshotEndIngest(&snapshot) == 0 && snapshot.version == 2;
+
+    // The key limit.
+    SSKPreferenceSnapshotInit(&snapshot);
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeBool, 0.0, 0.0, 0.0};
+    for (uint32_t i = 0; i < SSKPreferenceSnapshotMaxKeys; i++) {
+        ok = ok && SSKPreferenceSnapshotAddKey(&snapshot, &spec) == (int32_t)i;
+    }
+    ok = ok && SSKPreferenceSnapshotAddKey(&snapshot, &spec) == -1 && snapshot.dirty == UINT64_MAX;
+    return ok;
+}
+
+int main(void) {
+    printf("SSKPreferenceSnapshotBench\n");
+
+    bool ok = SSKBenchIngest();
+    SSKBenchCheck("clamping, dirty bits and versions", ok);
+    if (!ok) { return 1; }
+
+    SSKPreferenceSnapshot snapshot;
+    SSKBenchBuild(&snapshot);
+    const SSKPreferenceSnapshot *volatile readable = &snapshot;
+
+    enum { SSKBenchFrames = 20000000 };
+    volatile double sink = 0.0;
+    double start = SSKBenchNow();
+    for (uint32_t frame = 0; frame < SSKBenchFrames; frame++) {
+        const SSKPreferenceSnapshot *prefs = readable;
+        sink += (double)SSKPreferenceSnapshotInteger(prefs, SSKBenchStarCount) +
+                SSKPreferenceSnapshotDouble(prefs, SSKBenchSpeed) +
+                SSKPreferenceSnapshotDouble(prefs, SSKBenchFieldOfView) +
+                SSKPreferenceSnapshotDouble(prefs, SSKBenchStarSize) +
+                SSKPreferenceSnapshotDouble(prefs, SSKBenchBlurAmount) +
+                (SSKPreferenceSnapshotBool(prefs, SSKBenchMotionBlur) ? 1.0 : 0.0) +
+                (SSKPreferenceSnapshotBool(prefs, SSKBenchDirectionShifts) ? 1.0 : 0.0);
+    }
+    double readSeconds = SSKBenchNow() - start;
+
+    enum { SSKBenchBatches = 5000000 };
+    start = SSKBenchNow();
+    for (uint32_t batch = 0; batch < SSKBenchBatches; batch++) {
+        SSKPreferenceSnapshotBeginIngest(&snapshot);
+        SSKPreferenceSnapshotSet(&snapshot, SSKBenchSpeed, 0.5 + (double)(batch & 7) * 0.25);
+        sink += (double)SSKPreferenceSnapshotEndIngest(&snapshot);
+    }
+    double ingestSeconds = SSKBenchNow() - start;
+
+    printf("  frame reading 7 values: %.2f ns\n", readSeconds * 1e9 / SSKBenchFrames);
+    (void)sink;
+
+    printf("  one-key ingest batch: %.2f ns\n", ingestSeconds * 1e9 / SSKBenchBatches);
+    return 0;
+}
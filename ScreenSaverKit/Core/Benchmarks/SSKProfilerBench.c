@@ -0,0 +1,306 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Frame-phase profiler benchmark.
+//
+// Checks the percentiles against samples of known duration and the rolling
+// window, that four threads recording while a fifth collects lose nothing
+// they do not count as dropped and keep each thread's order, the drop count
+// of a full ring, nested scopes, that a disabled profiler records nothing,
+// and that the Chrome trace has one event per kept sample with escaped names.
+// Then times a scope with profiling on and off, including draining it, and
+// reports the cost of a generous 64 scopes a frame against a 60 Hz budget.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKProfiler.h"
+
+static const uint32_t kSSKBenchThreadCount = 4;
+static const uint32_t kSSKBenchSamplesPerThread = 200000;
+
+static bool SSKBenchNearMs(double value, double expected) {
+    return value > expected - 1e-9 && value < expected + 1e-9;
+}
+
+static void SSKBenchSpin(uint64_t nanoseconds) {
+    uint64_t end = SSKProfilerNow() + nanoseconds;
+    while (SSKProfilerNow() < end) {
+    }
+}
+
+static bool SSKBenchVerifyPercentiles(void) {
+    SSKProfiler *profiler = SSKProfilerCreate(256, 100, 0);
+    if (!profiler) { return false; }
+    SSKProfilerSetEnabled(profiler, true);
+    uint32_t phase = SSKProfilerRegisterPhase("bench.percentiles");
+    // 1 ms to 100 ms, shuffled so the window has to sort.
+    for (uint32_t i = 0; i < 100; i++) {
+        uint64_t ms = (i * 37) % 100 + 1;
+        SSKProfilerRecord(profiler, phase, SSKProfilerClockCPU, 1000, 1000 + ms * 1000000);
+    }
+    SSKProfilerCollect(profiler, NULL, NULL);
+    SSKProfilerStats stats;
+    bool ok = SSKProfilerPhaseStats(profiler, phase, SSKProfilerClockCPU, &stats);
+    ok = ok && stats.count == 100 && SSKBenchNearMs(stats.mean, 50.5) && SSKBenchNearMs(stats.p50, 50.0) &&
+         SSKBenchNearMs(stats.p95, 95.0) && SSKBenchNearMs(stats.p99, 99.0) && SSKBenchNearMs(stats.max, 100.0);
+    // Nothing on the other clock.
+    ok = ok && !SSKProfilerPhaseStats(profiler, phase, SSKProfilerClockGPU, &stats);
+
+    // Fifty 200 ms samples push the fifty shortest out of the window.
+    for (uint32_t i = 0; i < 50; i++) {
+        SSKProfilerRecord(profiler, phase, SSKProfilerClockCPU, 0, 200000000);
+    }
+    SSKProfilerCollect(profiler, NULL, NULL);
+    ok = ok && SSKProfilerPhaseStats(profiler, phase, SSKProfilerClockCPU, &stats) && stats.count == 100;
+    // The median is the longest of the fifty kept from the first batch.
+    uint64_t longestKept = 0;
+    for (uint32_t i = 50; i < 100; i++) {
+        uint64_t ms = (i * 37) % 100 + 1;
+        longestKept = ms > longestKept ? ms : longestKept;
+    }
+    ok = ok && SSKBenchNearMs(stats.p50, (double)longestKept) && SSKBenchNearMs(stats.p95, 200.0) &&
+         SSKBenchNearMs(stats.max, 200.0);
+
+    SSKProfilerReset(profiler);
+    ok = ok && !SSKProfilerPhaseStats(profiler, phase, SSKProfilerClockCPU, &stats);
+    ok = ok && SSKProfilerRegisterPhase("bench.percentiles") == phase &&
+         strcmp(SSKProfilerPhaseName(phase), "bench.percentiles") == 0 && strcmp(SSKProfilerPhaseName(0), "?") == 0;
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+typedef struct {
+    SSKProfiler *profiler;
+    uint32_t phase;
+    atomic_uint finished;
+} SSKBenchProducer;
+
+static void *SSKBenchProduce(void *argument) {
+    SSKBenchProducer *producer = argument;
+    for (uint64_t i = 0; i < kSSKBenchSamplesPerThread; i++) {
+        SSKProfilerRecord(producer->profiler, producer->phase, SSKProfilerClockCPU, i, i + 1);
+        // Let the collector in on machines with fewer cores than threads.
+        if ((i & 511) == 511) { sched_yield(); }
+    }
+    atomic_fetch_add(&producer->finished, 1);
+    return NULL;
+}
+
+typedef struct {
+    uint64_t received[8];
+    int64_t lastStart[8];
+    bool ordered;
+} SSKBenchConsumer;
+
+static void SSKBenchConsume(void *context, const SSKProfilerSample *sample) {
+    SSKBenchConsumer *consumer = context;
+    if (sample->thread >= 8) {
+        consumer->ordered = false;
+        return;
+    }
+    if ((int64_t)sample->start <= consumer->lastStart[sample->thread] || sample->duration != 1) {
+        consumer->ordered = false;
+    }
+    consumer->lastStart[sample->thread] = (int64_t)sample->start;
+    consumer->received[sample->thread]++;
+}
+
+static bool SSKBenchVerifyConcurrent(void) {
+    SSKProfiler *profiler = SSKProfilerCreate(1024, 0, 0);
+    if (!profiler) { return false; }
+    SSKProfilerSetEnabled(profiler, true);
+    SSKBenchProducer producer = {profiler, SSKProfilerRegisterPhase("bench.concurrent"), 0};
+    SSKBenchConsumer consumer = {.ordered = true};
+    for (uint32_t i = 0; i < 8; i++) {
+        consumer.lastStart[i] = -1;
+    }
+
+    pthread_t threads[8];
+    uint32_t started = 0;
+    for (; started < kSSKBenchThreadCount; started++) {
+        if (pthread_create(&threads[started], NULL, SSKBenchProduce, &producer) != 0) { break; }
+    }
+    // Collect while the producers run, as the overlay would.
+    uint64_t collected = 0;
+    while (atomic_load(&producer.finished) < started) {
+        collected += SSKProfilerCollect(profiler, SSKBenchConsume, &consumer);
+    }
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    collected += SSKProfilerCollect(profiler, SSKBenchConsume, &consumer);
+
+    uint64_t dropped = SSKProfilerDroppedCount(profiler);
+    uint64_t produced = (uint64_t)started * kSSKBenchSamplesPerThread;
+    printf("    %u threads: %llu samples, %llu collected, %llu dropped\n", started, (unsigned long long)produced,
+           (unsigned long long)collected, (unsigned long long)dropped);
+    bool ok = started == kSSKBenchThreadCount && consumer.ordered && collected + dropped == produced;
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+static bool SSKBenchVerifyOverflowAndDisabled(void) {
+    SSKProfiler *profiler = SSKProfilerCreate(50, 0, 0);
+    if (!profiler) { return false; }
+    uint32_t phase = SSKProfilerRegisterPhase("bench.overflow");
+    // Disabled: nothing is recorded or dropped.
+    for (uint32_t i = 0; i < 10; i++) {
+        SSKProfilerRecord(profiler, phase, SSKProfilerClockCPU, 0, 1);
+    }
+    bool ok = SSKProfilerCollect(profiler, NULL, NULL) == 0 && SSKProfilerDroppedCount(profiler) == 0;
+
+    // The capacity rounds up to 64; the rest is dropped until collected.
+    SSKProfilerSetEnabled(profiler, true);
+    for (uint32_t i = 0; i < 100; i++) {
+        SSKProfilerRecord(profiler, phase, SSKProfilerClockCPU, 0, 1);
+    }
+    ok = ok && SSKProfilerDroppedCount(profiler) == 36 && SSKProfilerCollect(profiler, NULL, NULL) == 64;
+    SSKProfilerRecord(profiler, phase, SSKProfilerClockCPU, 0, 1);
+    ok = ok && SSKProfilerCollect(profiler, NULL, NULL) == 1 && SSKProfilerDroppedCount(profiler) == 36;
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+typedef struct {
+    SSKProfilerSample samples[4];
+    uint32_t count;
+} SSKBenchRecorder;
+
+static void SSKBenchRecord(void *context, const SSKProfilerSample *sample) {
+    SSKBenchRecorder *recorder = context;
+    if (recorder->count < 4) { recorder->samples[recorder->count] = *sample; }
+    recorder->count++;
+}
+
+static bool SSKBenchVerifyScopes(void) {
+    SSKProfiler *profiler = SSKProfilerCreate(0, 0, 0);
+    if (!profiler) { return false; }
+    SSKProfilerSetEnabled(profiler, true);
+    {
+        SSK_PROFILE_SCOPE(profiler, "bench.outer");
+        SSKBenchSpin(200000);
+        {
+            SSK_PROFILE_SCOPE(profiler, "bench.inner");
+            SSKBenchSpin(500000);
+        }
+        SSKBenchSpin(200000);
+    }
+    {
+        SSK_PROFILE_SCOPE(NULL, "bench.null");
+    }
+    SSKBenchRecorder recorder = {.count = 0};
+    SSKProfilerCollect(profiler, SSKBenchRecord, &recorder);
+    // The inner scope ends, and so is recorded, first.
+    const SSKProfilerSample *inner = &recorder.samples[0];
+    const SSKProfilerSample *outer = &recorder.samples[1];
+    bool ok = recorder.count == 2 && strcmp(SSKProfilerPhaseName(inner->phase), "bench.inner") == 0 &&
+              strcmp(SSKProfilerPhaseName(outer->phase), "bench.outer") == 0;
+    ok = ok && inner->duration >= 500000 && outer->duration >= inner->duration + 400000 &&
+         outer->start <= inner->start && inner->start + inner->duration <= outer->start + outer->duration;
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+static uint32_t SSKBenchCount(const char *text, const char *needle) {
+    uint32_t count = 0;
+    for (const char *found = strstr(text, needle); found; found = strstr(found + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+static bool SSKBenchVerifyTrace(void) {
+    SSKProfiler *profiler = SSKProfilerCreate(0, 0, 8);
+    FILE *file = tmpfile();
+    if (!profiler || !file) {
+        SSKProfilerDestroy(profiler);
+        if (file) { fclose(file); }
+        return false;
+    }
+    SSKProfilerSetEnabled(profiler, true);
+    uint32_t cpu = SSKProfilerRegisterPhase("bench \"quoted\"\\");
+    uint32_t gpu = SSKProfilerRegisterPhase("bench.gpu");
+    // Twelve samples into a trace of eight: the first four fall out.
+    for (uint64_t i = 0; i < 6; i++) {
+        SSKProfilerRecord(profiler, cpu, SSKProfilerClockCPU, 5000000 + i * 1000000, 5000000 + i * 1000000 + 2500);
+        SSKProfilerRecord(profiler, gpu, SSKProfilerClockGPU, 5000500 + i * 1000000, 5000500 + i * 1000000 + 1000);
+    }
+    SSKProfilerCollect(profiler, NULL, NULL);
+    bool ok = SSKProfilerWriteChromeTrace(profiler, file);
+
+    long length = ftell(file);
+    char *text = length > 0 ? calloc((size_t)length + 1, 1) : NULL;
+    rewind(file);
+    ok = ok && text && fread(text, 1, (size_t)length, file) == (size_t)length;
+    if (ok) {
+        ok = strncmp(text, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39) == 0 && strstr(text, "\n]}\n");
+        ok = ok && SSKBenchCount(text, "\"ph\":\"X\"") == 8 && SSKBenchCount(text, "\"ph\":\"M\"") == 2;
+        ok = ok && SSKBenchCount(text, "\"name\":\"bench \\\"quoted\\\"\\\\\"") == 4;
+        ok = ok && SSKBenchCount(text, "\"cat\":\"gpu\",\"ph\":\"X\"") == 4 && SSKBenchCount(text, "\"tid\":0}") == 4;
+        // Microseconds from the oldest kept sample (the third CPU sample).
+        ok = ok && strstr(text, "\"ts\":0.000,\"dur\":2.500") && strstr(text, "\"ts\":3000.500,\"dur\":1.000");
+        int depth = 0;
+        for (const char *c = text; *c && depth >= 0; c++) {
+            if (*c == '{' || *c == '[') { depth++; }
+            if (*c == '}' || *c == ']') { depth--; }
+        }
+        ok = ok && depth == 0;
+    }
+    free(text);
+    fclose(file);
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+/// Nanoseconds per scope, draining every 1024 as a frame would.
+static double SSKBenchScopeCost(SSKProfiler *profiler, uint32_t iterations) {
+    uint64_t start = SSKProfilerNow();
+    for (uint32_t i = 0; i < iterations; i++) {
+        {
+            SSK_PROFILE_SCOPE(profiler, "bench.scope");
+        }
+        if ((i & 1023) == 1023) { SSKProfilerCollect(profiler, NULL, NULL); }
+    }
+    return (double)(SSKProfilerNow() - start) / (double)iterations;
+}
+
+static bool SSKBenchTime(void) {
+    const uint32_t iterations = 2000000;
+    const double scopesPerFrame = 64.0;
+    const double frameBudget = 1.0e9 / 60.0;
+    SSKProfiler *profiler = SSKProfilerCreate(0, 0, 0);
+    if (!profiler) { return false; }
+    double disabled = SSKBenchScopeCost(profiler, iterations);
+    SSKProfilerSetEnabled(profiler, true);
+    double enabled = SSKBenchScopeCost(profiler, iterations);
+    double overhead = scopesPerFrame * enabled / frameBudget * 100.0;
+    printf("  scope: %5.1f ns enabled, %4.1f ns disabled; %.0f scopes/frame = %.4f%% of 16.7 ms\n", enabled,
+           disabled, scopesPerFrame, overhead);
+    bool ok = SSKProfilerDroppedCount(profiler) == 0 && overhead < 1.0;
+    SSKProfilerDestroy(profiler);
+    return ok;
+}
+
+int main(void) {
+    printf("SSKProfilerBench\n");
+    bool percentiles = SSKBenchVerifyPercentiles();
+    SSKBenchCheck("percentiles and rolling window", percentiles);
+    bool concurrent = SSKBenchVerifyConcurrent();
+    SSKBenchCheck("concurrent producers keep order and count drops", concurrent);
+    bool overflow = SSKBenchVerifyOverflowAndDisabled();
+    SSKBenchCheck("full rings drop, disabled records nothing", overflow);
+    bool scopes = SSKBenchVerifyScopes();
+    SSKBenchCheck("nested scopes", scopes);
+    bool trace = SSKBenchVerifyTrace();
+    SSKBenchCheck("Chrome trace export", trace);
+    bool timing = SSKBenchTime();
+    SSKBenchCheck("overhead under 1% of a frame", timing);
+    return percentiles && concurrent && overflow && scopes && trace && timing ? 0 : 1;
+}
@@ -0,0 +1,394 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Replay log benchmark.
+//
+// Writes a log of jittered 60 Hz frames, clock resets and preference
+// payloads (some larger than the writer's buffer) to a temporary file, reads
+// it back and checks every timestamp bit for bit and every payload byte, and
+// that a frame costs under eight bytes. Truncated logs, unknown events and
+// foreign headers must be rejected. A small starfield driven by the log
+// (seed, speed preference and frame deltas) must produce the same checksum
+// trace live and in two replays; a different seed must diverge at the first
+// frame and one nudged timestamp exactly at its frame. Traces must survive
+// the text format, and the comparison must report a doubled frame cost.
+// Finally times writing and reading a frame and checksumming state.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKRandom.h"
+#include "SSKReplay.h"
+#include "SSKStarfield.h"
+
+enum {
+    SSKBenchFrames = 20000,
+    SSKBenchStars = 4096,
+    SSKBenchReplayFrames = 1200,
+    SSKBenchMaxPayload = 9000,
+};
+
+/// Reads the whole of `file` into a new buffer.
+static uint8_t *SSKBenchSlurp(FILE *file, size_t *length) {
+    if (fseek(file, 0, SEEK_END) != 0) { return NULL; }
+    long size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) { return NULL; }
+    uint8_t *data = malloc((size_t)size + 1);
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+        free(data);
+        return NULL;
+    }
+    *length = (size_t)size;
+    return data;
+}
+
+typedef struct {
+    SSKReplayEventType type;
+    double timestamp;
+    uint32_t payloadLength;
+    uint8_t payloadByte;
+} SSKBenchExpected;
+
+static bool SSKBenchCheckRoundTrip(void) {
+    static SSKBenchExpected expected[SSKBenchFrames + 64];
+    static uint8_t payload[SSKBenchMaxPayload];
+    uint32_t expectedCount = 0;
+    FILE *file = tmpfile();
+    SSKReplayHeader header = {0x0123456789abcdefull, 1440.0, 900.5};
+    SSKReplayWriter *writer = SSKReplayWriterCreate(file, &header);
+    bool ok = writer != NULL;
+
+    SSKRandom random = SSKRandomMake(7);
+    double timestamp = 782000000.125;
+    ok = ok && SSKReplayWriterClockReset(writer, timestamp);
+    expected[expectedCount++] = (SSKBenchExpected){SSKReplayEventClockReset, timestamp, 0, 0};
+    for (uint32_t frame = 0; ok && frame < SSKBenchFrames; frame++) {
+        timestamp += 1.0 / 60.0 + SSKRandomNextRange(&random, -0.002f, 0.002f);
+        if (frame % 1000 == 999) {
+            uint32_t length = frame % 4000 == 3999 ? SSKBenchMaxPayload : 1 + SSKRandomNext(&random) % 200;
+            uint8_t byte = (uint8_t)frame;
+            memset(payload, byte, length);
+            ok = SSKReplayWriterPreferences(writer, payload, length);
+            expected[expectedCount++] = (SSKBenchExpected){SSKReplayEventPreferences, 0.0, length, byte};
+        }
+        if (frame == SSKBenchFrames / 2) {
+            timestamp += 30.0;
+            ok = ok && SSKReplayWriterClockReset(writer, timestamp);
+            expected[expectedCount++] = (SSKBenchExpected){SSKReplayEventClockReset, timestamp, 0, 0};
+        }
+        ok = ok && SSKReplayWriterFrame(writer, timestamp);
+        expected[expectedCount++] = (SSKBenchExpected){SSKReplayEventFrame, timestamp, 0, 0};
+    }
+    ok = ok && SSKReplayWriterFrameCount(writer) == SSKBenchFrames;
+    ok = SSKReplayWriterDestroy(writer) && ok;
+
+    size_t length = 0;
+    uint8_t *data = ok ? SSKBenchSlurp(file, &length) : NULL;
+    fclose(file);
+    SSKReplayReader reader;
+    ok = data && SSKReplayReaderInit(&reader, data, length) && reader.header.seed == header.seed &&
+        reader.header.viewWidth == header.viewWidth && reader.header.viewHeight == header.viewHeight;
+    uint32_t index = 0;
+    SSKReplayEvent event;
+    size_t payloadBytes = 0;
+    while (ok && SSKReplayReaderNext(&reader, &event)) {
+        const SSKBenchExpected *want = &expected[index++];
+        ok = index <= expectedCount && event.type == want->type;
+        if (ok && event.type == SSKReplayEventPreferences) {
+            ok = event.payloadLength == want->payloadLength;
+            for (uint32_t i = 0; ok && i < event.payloadLength; i++) { ok = event.payload[i] == want->payloadByte; }
+            payloadBytes += event.payloadLength + 3;
+        } else if (ok) {
+            ok = memcmp(&event.timestamp, &want->timestamp, sizeof(double)) == 0;
+        }
+    }
+    ok = ok && !reader.failed && index == expectedCount;
+    SSKBenchCheck("round trip is exact", ok);
+
+    double bytesPerFrame = (double)(length - payloadBytes) / SSKBenchFrames;
+    bool compact = ok && bytesPerFrame < 8.0;
+    printf("  %.2f bytes per frame\n", bytesPerFrame);
+    SSKBenchCheck("frames cost under eight bytes", compact);
+    ok = ok && compact;
+
+    // A cut log yields fewer events (failing if the cut splits one), never more.
+    bool rejects = data != NULL;
+    for (size_t cut = length - 1; rejects && cut > length - 40; cut--) {
+        SSKReplayReader truncated;
+        SSKReplayReaderInit(&truncated, data, cut);
+        uint32_t events = 0;
+        while (SSKReplayReaderNext(&truncated, &event)) { events++; }
+        rejects = truncated.failed || events < expectedCount;
+    }
+    if (data) {
+        SSKReplayReader foreign;
+        uint8_t saved = data[0];
+        data[0] = 'X';
+        rejects = rejects && !SSKReplayReaderInit(&foreign, data, length);
+        data[0] = saved;
+        // An event of an unknown kind, well formed otherwise, appended at the end.
+        uint8_t *extended = realloc(data, length + 2);
+        if (extended) {
+            data = extended;
+            data[length] = 9;
+            data[length + 1] = 0;
+        }
+        SSKReplayReader unknown;
+        rejects = rejects && extended && SSKReplayReaderInit(&unknown, data, length + 2);
+        uint32_t events = 0;
+        while (rejects && SSKReplayReaderNext(&unknown, &event)) { events++; }
+        rejects = rejects && unknown.failed && events == expectedCount;
+    }
+    SSKBenchCheck("truncated and foreign logs are rejected", rejects);
+    free(data);
+    return ok && rejects;
+}
+
+// MARK: - Deterministic replay
+
+typedef struct {
+    SSKStarfield *field;
+    SSKRandom random;
+    float speed;
+} SSKBenchWorld;
+
+/// Mirrors what a saver does: reseed, rebuild from preferences, then step
+/// with each frame's delta.
+static bool SSKBenchWorldInit(SSKBenchWorld *world, uint64_t seed) {
+    world->random = SSKRandomMake(seed);
+    world->speed = 1.0f;
+    world->field = SSKStarfieldCreate(SSKBenchStars, (uint64_t)SSKRandomNext(&world->random) << 32 |
+                                                         SSKRandomNext(&world->random));
+    return world->field != NULL;
+}
+
+static void SSKBenchWorldStep(SSKBenchWorld *world, double dt) {
+    float jitter = SSKRandomNextRange(&world->random, -0.001f, 0.001f);
+    SSKStarfieldStepParams params = {world->speed * (float)dt, SSKFloat2Make(jitter, -jitter)};
+    SSKStarfieldStep(world->field, &params);
+}
+
+static uint64_t SSKBenchWorldChecksum(const SSKBenchWorld *world) {
+    const SSKStarfield *field = world->field;
+    uint64_t hash = SSKReplayChecksum(0, field->x, field->count * sizeof(float));
+    hash = SSKReplayChecksum(hash, field->y, field->count * sizeof(float));
+    hash = SSKReplayChecksum(hash, field->z, field->count * sizeof(float));
+    return SSKReplayChecksum(hash, &world->random, sizeof world->random);
+}
+
+/// Runs the log against a fresh world and traces every frame.
+static bool SSKBenchReplay(const uint8_t *data, size_t length, SSKReplayTrace *trace) {
+    SSKReplayReader reader;
+    if (!SSKReplayReaderInit(&reader, data, length)) { return false; }
+    SSKBenchWorld world;
+    if (!SSKBenchWorldInit(&world, reader.header.seed)) { return false; }
+    double previous = 0.0;
+    SSKReplayEvent event;
+    while (SSKReplayReaderNext(&reader, &event)) {
+        if (event.type == SSKReplayEventClockReset) {
+            previous = event.timestamp;
+        } else if (event.type == SSKReplayEventPreferences && event.payloadLength == sizeof(float)) {
+            memcpy(&world.speed, event.payload, sizeof(float));
+        } else if (event.type == SSKReplayEventFrame) {
+            double start = SSKBenchNow();
+            SSKBenchWorldStep(&world, event.timestamp - previous);
+            double cost = SSKBenchNow() - start;
+            previous = event.timestamp;
+            SSKReplayFrame frame = {(uint64_t)(cost * 1e9), SSKBenchWorldChecksum(&world), 1};
+            SSKReplayTraceAppend(trace, &frame);
+        }
+    }
+    SSKStarfieldDestroy(world.field);
+    return !reader.failed;
+}
+
+/// Records a live run with `seed` into a memory buffer and traces it.
+static uint8_t *SSKBenchRecord(uint64_t seed, size_t *length, SSKReplayTrace *trace) {
+    FILE *file = tmpfile();
+    SSKReplayHeader header = {seed, 1920.0, 1080.0};
+    SSKReplayWriter *writer = SSKReplayWriterCreate(file, &header);
+    SSKBenchWorld world = {NULL, {0}, 0.0f};
+    bool ok = writer && SSKBenchWorldInit(&world, seed);
+    SSKRandom jitter = SSKRandomMake(seed ^ 0x55);
+    double now = 790000000.0 + seed;
+    double previous = now;
+    ok = ok && SSKReplayWriterClockReset(writer, now);
+    for (uint32_t frame = 0; ok && frame < SSKBenchReplayFrames; frame++) {
+        if (frame % 300 == 150) {
+            world.speed = 0.5f + (float)(frame / 300);
+            ok = SSKReplayWriterPreferences(writer, &world.speed, sizeof(float));
+        }
+        now += 1.0 / 60.0 + SSKRandomNextRange(&jitter, -0.003f, 0.003f);
+        ok = ok && SSKReplayWriterFrame(writer, now);
+        SSKBenchWorldStep(&world, now - previous);
+        previous = now;
+        SSKReplayFrame traced = {0, SSKBenchWorldChecksum(&world), 1};
+        ok = ok && SSKReplayTraceAppend(trace, &traced);
+    }
+    ok = SSKReplayWriterDestroy(writer) && ok;
+    SSKStarfieldDestroy(world.field);
+    uint8_t *data = ok ? SSKBenchSlurp(file, length) : NULL;
+    fclose(file);
+    return data;
+}
+
+/// Adds one ulp to the timestamp of frame `target` in a log.
+static bool SSKBenchNudgeFrame(const uint8_t *data, size_t length, uint32_t target, uint8_t **outData,
+                               size_t *outLength) {
+    SSKReplayReader reader;
+    if (!SSKReplayReaderInit(&reader, data, length)) { return false; }
+    FILE *file = tmpfile();
+    SSKReplayWriter *writer = SSKReplayWriterCreate(file, &reader.header);
+    uint32_t frame = 0;
+    SSKReplayEvent event;
+    bool ok = writer != NULL;
+    while (ok && SSKReplayReaderNext(&reader, &event)) {
+        if (event.type == SSKReplayEventClockReset) {
+            ok = SSKReplayWriterClockReset(writer, event.timestamp);
+        } else if (event.type == SSKReplayEventFrame) {
+            ok = SSKReplayWriterFrame(writer, frame++ == target ? nextafter(event.timestamp, INFINITY) : event.timestamp);
+        } else {
+            ok = SSKReplayWriterPreferences(writer, event.payload, event.payloadLength);
+        }
+    }
+    ok = SSKReplayWriterDestroy(writer) && ok && !reader.failed;
+    *outData = ok ? SSKBenchSlurp(file, outLength) : NULL;
+    fclose(file);
+    return *outData != NULL;
+}
+
+static bool SSKBenchCheckDeterminism(void) {
+    SSKReplayTrace live, first, second, otherLive, other, nudged;
+    SSKReplayTraceInit(&live);
+    SSKReplayTraceInit(&first);
+    SSKReplayTraceInit(&second);
+    SSKReplayTraceInit(&otherLive);
+    SSKReplayTraceInit(&other);
+    SSKReplayTraceInit(&nudged);
+
+    size_t length = 0;
+    size_t otherLength = 0;
+    size_t nudgedLength = 0;
+    uint8_t *nudgedData = NULL;
+    uint8_t *data = SSKBenchRecord(42, &length, &live);
+    uint8_t *otherData = SSKBenchRecord(43, &otherLength, &otherLive);
+    bool ok = data && otherData && SSKBenchReplay(data, length, &first) && SSKBenchReplay(data, length, &second);
+    SSKReplayComparison againstLive = SSKReplayTraceCompare(&live, &first);
+    SSKReplayComparison againstReplay = SSKReplayTraceCompare(&first, &second);
+    ok = ok && first.count == SSKBenchReplayFrames && againstLive.firstDivergentFrame == UINT32_MAX &&
+        againstReplay.firstDivergentFrame == UINT32_MAX && againstReplay.comparedFrames == SSKBenchReplayFrames;
+    SSKBenchCheck("replays match the live run and each other", ok);
+
+    bool diverges = otherData && SSKBenchReplay(otherData, otherLength, &other) &&
+        SSKReplayTraceCompare(&first, &other).firstDivergentFrame == 0;
+    diverges = diverges && SSKBenchNudgeFrame(data, length, 777, &nudgedData, &nudgedLength) &&
+        SSKBenchReplay(nudgedData, nudgedLength, &nudged) &&
+        SSKReplayTraceCompare(&first, &nudged).firstDivergentFrame == 777;
+    SSKBenchCheck("seed and timestamp changes diverge where expected", diverges);
+
+    free(data);
+    free(otherData);
+    free(nudgedData);
+    SSKReplayTraceDestroy(&live);
+    SSKReplayTraceDestroy(&second);
+    SSKReplayTraceDestroy(&otherLive);
+    SSKReplayTraceDestroy(&other);
+    SSKReplayTraceDestroy(&nudged);
+
+    // Text round trip, then a copy with every frame twice as slow.
+    FILE *file = tmpfile();
+    SSKReplayTrace reread, slower;
+    SSKReplayTraceInit(&reread);
+    SSKReplayTraceInit(&slower);
+    bool traces = SSKReplayTraceWrite(&first, file) && fseek(file, 0, SEEK_SET) == 0 &&
+        SSKReplayTraceRead(&reread, file) && reread.count == first.count;
+    fclose(file);
+    for (uint32_t i = 0; traces && i < first.count; i++) {
+        const SSKReplayFrame *a = &first.frames[i];
+        const SSKReplayFrame *b = &reread.frames[i];
+        traces = a->costNs == b->costNs && a->checksum == b->checksum && a->steps == b->steps;
+        SSKReplayFrame doubled = *a;
+        doubled.costNs = a->costNs * 2 + 2;
+        traces = traces && SSKReplayTraceAppend(&slower, &doubled);
+    }
+    SSKReplayComparison slowdown = SSKReplayTraceCompare(&reread, &slower);
+    traces = traces && slowdown.firstDivergentFrame == UINT32_MAX && slowdown.change > 95.0 &&
+        slowdown.currentP95Ns >= slowdown.baselineP95Ns * 2.0;
+    SSKReplayTrace shorter = reread;
+    shorter.count = 100;
+    traces = traces && SSKReplayTraceCompare(&reread, &shorter).firstDivergentFrame == 100;
+    printf("  replay median %.1f us per frame, p95 %.1f us\n", slowdown.baselineMedianNs * 1e-3,
+           slowdown.baselineP95Ns * 1e-3);
+    SSKBenchCheck("traces round trip and slowdowns are reported", traces);
+    SSKReplayTraceDestroy(&first);
+    SSKReplayTraceDestroy(&reread);
+    SSKReplayTraceDestroy(&slower);
+    return ok && diverges && traces;
+}
+
+static void SSKBenchTiming(void) {
+    enum { Frames = 1000000 };
+    FILE *sink = fopen("/dev/null", "wb");
+    SSKReplayHeader header = {1, 1920.0, 1080.0};
+    SSKReplayWriter *writer = SSKReplayWriterCreate(sink, &header);
+    double timestamp = 782000000.0;
+    double start = SSKBenchNow();
+    for (uint32_t i = 0; i < Frames; i++) {
+        timestamp += 1.0 / 60.0;
+        SSKReplayWriterFrame(writer, timestamp);
+    }
+    double write = SSKBenchNow() - start;
+    SSKReplayWriterDestroy(writer);
+    if (sink) { fclose(sink); }
+
+    size_t length = 0;
+    FILE *file = tmpfile();
+    writer = SSKReplayWriterCreate(file, &header);
+    timestamp = 782000000.0;
+    for (uint32_t i = 0; i < Frames; i++) {
+        timestamp += 1.0 / 60.0;
+        SSKReplayWriterFrame(writer, timestamp);
+    }
+    SSKReplayWriterDestroy(writer);
+    uint8_t *data = SSKBenchSlurp(file, &length);
+    fclose(file);
+    double read = 0.0;
+    if (data) {
+        SSKReplayReader reader;
+        SSKReplayReaderInit(&reader, data, length);
+        SSKReplayEvent event;
+        double sum = 0.0;
+        start = SSKBenchNow();
+        while (SSKReplayReaderNext(&reader, &event)) { sum += event.timestamp; }
+        read = SSKBenchNow() - start;
+        if (sum == 0.0) { printf("  (unexpected empty read)\n"); }
+    }
+    free(data);
+
+    size_t bytes = 16u << 20;
+    uint8_t *state = malloc(bytes);
+    double checksum = 0.0;
+    if (state) {
+        memset(state, 0x5a, bytes);
+        start = SSKBenchNow();
+        volatile uint64_t hash = SSKReplayChecksum(0, state, bytes);
+        (void)hash;
+        checksum = SSKBenchNow() - start;
+    }
+    free(state);
+    printf("  write %.1f ns/frame, read %.1f ns/frame, checksum %.2f GB/s\n", write * 1e9 / Frames,
+           read * 1e9 / Frames, checksum > 0.0 ? (double)bytes / checksum * 1e-9 : 0.0);
+}
+
+int main(void) {
+    printf("SSKReplayBench\n");
+    bool ok = SSKBenchCheckRoundTrip();
+    ok = SSKBenchCheckDeterminism() && ok;
+    SSKBenchTiming();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Slot allocator benchmark.
+//
+// First checks that retiring a dead list behaves like the GPU completion path
+// needs: slots released twice (a stale list after a rebuild) are ignored, the
+// alive list keeps spawn order, and a slot is only reused after it has been
+// released. Then times burst spawn/retire cycles and reports ns per particle.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+
+static bool SSKBenchVerifyRetire(void) {
+    SSKParticleCore *core = SSKParticleCoreCreate(64);
+    if (!core) { return false; }
+    uint32_t slots[64];
+    uint32_t spawned = SSKParticleCoreSpawn(core, 10, slots);
+    bool ok = spawned == 10 && slots[0] == 0 && slots[9] == 9;
+
+    // Simulate a kernel retiring slots 2, 5 and 7 in arbitrary order while a
+    // second in-flight step has already cleared slot 8's flag.
+    uint32_t dead[] = { 7, 2, 5 };
+    core->alive[2] = core->alive[5] = core->alive[7] = core->alive[8] = 0u;
+    SSKParticleCoreRetireSlots(core, dead, 3);
+    const uint32_t expected[] = { 0, 1, 3, 4, 6, 8, 9 };
+    ok = ok && core->aliveCount == 7 && core->slots.freeCount == 57;
+    for (uint32_t i = 0; ok && i < 7; i++) {
+        ok = core->aliveList[i] == expected[i];
+    }
+
+    // A stale duplicate of the same list must not free anything twice.
+    SSKParticleCoreRetireSlots(core, dead, 3);
+    ok = ok && core->aliveCount == 7 && core->slots.freeCount == 57;
+
+    // Released slots are reused last-released first; slot 8 is still held.
+    ok = ok && SSKParticleCoreSpawn(core, 3, slots) == 3 && slots[0] == 5 && slots[1] == 2 && slots[2] == 7;
+    ok = ok && SSKSlotAllocatorIsHeld(&core->slots, 8);
+    SSKParticleCoreDestroy(core);
+    return ok;
+}
+
+static void SSKBenchBursts(uint32_t capacity, uint32_t burst) {
+    SSKParticleCore *core = SSKParticleCoreCreate(capacity);
+    uint32_t *slots = malloc(sizeof(uint32_t) * burst);
+    if (!core || !slots) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    uint32_t rng = 7u;
+    uint64_t processed = 0;
+    double start = SSKBenchNow();
+    for (int frame = 0; frame < 2000; frame++) {
+        uint32_t spawned = SSKParticleCoreSpawn(core, burst, slots);
+        // Retire a pseudo-random subset of what was just spawned, the way a
+        // GPU dead list arrives: unordered and a fraction of the live set.
+        uint32_t deadCount = 0;
+        for (uint32_t i = 0; i < spawned; i++) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            if (rng & 1u) {
+                core->alive[slots[i]] = 0u;
+                slots[deadCount++] = slots[i];
+            }
+        }
+        SSKParticleCoreRetireSlots(core, slots, deadCount);
+        processed += spawned + deadCount;
+        if (core->slots.freeCount < burst) {
+            SSKParticleCoreReset(core);
+        }
+    }
+    double elapsed = SSKBenchNow() - start;
+    printf("  capacity %7u burst %5u: %6.1f ns/particle (spawn + retire, incl. alive-list filter)\n",
+           capacity, burst, elapsed * 1e9 / (double)(processed ? processed : 1));
+    free(slots);
+    SSKParticleCoreDestroy(core);
+}
+
+int main(void) {
+    if (!SSKBenchVerifyRetire()) {
+        fprintf(stderr, "SSKSlotAllocatorBench: dead-list retire check FAILED\n");
+        return 1;
+    }
+    printf("SSKSlotAllocatorBench: dead-list retire check passed\n");
+    SSKBenchBursts(4096, 256);
+    SSKBenchBursts(65536, 2048);
+    return 0;
+}
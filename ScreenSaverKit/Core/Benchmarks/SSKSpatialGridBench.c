@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Spatial grid benchmark.
+//
+// Checks grid queries and grid-driven flocking against brute force (same
+// neighbour sets, same steering within float tolerance), then times a full
+// neighbour pass at constant density from 1k to 100k particles. The grid cost
+// per particle should stay roughly flat while brute force grows linearly.
+// Brute force at 100k is extrapolated from a sample of particles.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKParticleCore.h"
+#include "SSKRandom.h"
+#include "SSKSpatialGrid.h"
+
+/// Spawns `count` particles spread uniformly over a square sized so each
+/// particle has about the same number of neighbours whatever the count.
+static SSKParticleCore *SSKBenchScatter(uint32_t count, uint64_t seed) {
+    SSKParticleCore *core = SSKParticleCoreCreate(count);
+    if (!core) { return NULL; }
+    SSKParticleCoreSpawn(core, count, NULL);
+    SSKRandom random = SSKRandomMake(seed);
+    float side = sqrtf((float)count) * 10.0f;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = core->aliveList[i];
+        core->position[slot] = SSKFloat2Make(SSKRandomNextRange(&random, 0.0f, side),
+                                             SSKRandomNextRange(&random, 0.0f, side));
+        core->velocity[slot] = SSKFloat2Make(0.0f, 0.0f);
+    }
+    return core;
+}
+
+static int SSKBenchCompareSlots(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t SSKBenchBruteQuery(const SSKParticleCore *core, SSKFloat2 center, float radius, uint32_t *out) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = core->aliveList[i];
+        if (!core->alive[slot]) { continue; }
+        float dx = core->position[slot].x - center.x;
+        float dy = core->position[slot].y - center.y;
+        if (dx * dx + dy * dy <= radius * radius) { out[count++] = slot; }
+    }
+    return count;
+}
+
+/// Brute-force steering for the live particle at alive-list index `i`, the
+/// same maths as `SSKParticleCoreApplyFlocking`.
+static SSKFloat2 SSKBenchBruteSteering(const SSKParticleCore *core, uint32_t i, const SSKParticleFlockingParams *params) {
+    uint32_t self = core->aliveList[i];
+    SSKFloat2 p = core->position[self];
+    float pushX = 0.0f, pushY = 0.0f, sumX = 0.0f, sumY = 0.0f;
+    uint32_t neighbours = 0;
+    for (uint32_t k = 0; k < core->aliveCount; k++) {
+        uint32_t slot = core->aliveList[k];
+        if (slot == self || !core->alive[slot]) { continue; }
+        float dx = core->position[slot].x - p.x;
+        float dy = core->position[slot].y - p.y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 < params->separationRadius * params->separationRadius && d2 > 0.0f) {
+            float d = sqrtf(d2);
+            float w = (1.0f - d / params->separationRadius) / d;
+            pushX -= dx * w;
+            pushY -= dy * w;
+        }
+        if (d2 <= params->radius * params->radius) {
+            sumX += dx;
+            sumY += dy;
+            neighbours++;
+        }
+    }
+    float steerX = pushX * params->separation, steerY = pushY * params->separation;
+    if (neighbours > 0) {
+        steerX += sumX / (float)neighbours * params->cohesion;
+        steerY += sumY / (float)neighbours * params->cohesion;
+    }
+    return SSKFloat2Make(steerX, steerY);
+}
+
+static SSKParticleFlockingParams SSKBenchFlocking(void) {
+    SSKParticleFlockingParams params = {20.0f, 8.0f, 40.0f, 2.0f};
+    return params;
+}
+
+static bool SSKBenchVerifyQueries(uint32_t count, float cellSize) {
+    SSKParticleCore *core = SSKBenchScatter(count, 7);
+    SSKSpatialGrid grid;
+    uint32_t *fromGrid = malloc(sizeof(uint32_t) * count);
+    uint32_t *fromBrute = malloc(sizeof(uint32_t) * count);
+    bool ok = core && fromGrid && fromBrute && SSKSpatialGridInit(&grid, count);
+    // Kill every seventh particle; dead slots must not be indexed.
+    for (uint32_t slot = 0; ok && slot < count; slot += 7) { core->alive[slot] = 0u; }
+    if (ok) { SSKSpatialGridBuild(&grid, core, cellSize); }
+
+    SSKRandom random = SSKRandomMake(99);
+    float side = sqrtf((float)count) * 10.0f;
+    for (int q = 0; ok && q < 300; q++) {
+        // Include centres outside the bounding box and a range of radii.
+        SSKFloat2 center = SSKFloat2Make(SSKRandomNextRange(&random, -0.2f * side, 1.2f * side),
+                                         SSKRandomNextRange(&random, -0.2f * side, 1.2f * side));
+        float radius = SSKRandomNextRange(&random, 0.0f, 60.0f);
+        uint32_t a = SSKSpatialGridQuery(&grid, center, radius, fromGrid, count);
+        uint32_t b = SSKBenchBruteQuery(core, center, radius, fromBrute);
+        qsort(fromGrid, a, sizeof(uint32_t), SSKBenchCompareSlots);
+        qsort(fromBrute, b, sizeof(uint32_t), SSKBenchCompareSlots);
+        ok = a == b && memcmp(fromGrid, fromBrute, sizeof(uint32_t) * a) == 0;
+    }
+    printf("  queries   %6u particles, cell %6.2f (used %6.2f, %u cells): %s\n",
+           count, cellSize, ok ? grid.cellSize : 0.0f, ok ? grid.cellCount : 0u, SSKBenchStatus(ok));
+    SSKSpatialGridDestroy(&grid);
+    SSKParticleCoreDestroy(core);
+    free(fromGrid);
+    free(fromBrute);
+    return ok;
+}
+
+static bool SSKBenchVerifyFlocking(uint32_t count) {
+    SSKParticleCore *core = SSKBenchScatter(count, 11);
+    SSKFloat2 *expected = malloc(sizeof(SSKFloat2) * count);
+    SSKSpatialGrid grid;
+    bool ok = core && expected && SSKSpatialGridInit(&grid, count);
+    SSKParticleFlockingParams params = SSKBenchFlocking();
+    const float dt = 1.0f / 60.0f;
+    for (uint32_t i = 0; ok && i < core->aliveCount; i++) {
+        SSKFloat2 steer = SSKBenchBruteSteering(core, i, &params);
+        expected[core->aliveList[i]] = SSKFloat2Make(steer.x * dt, steer.y * dt);
+    }
+    if (ok) {
+        SSKSpatialGridBuild(&grid, core, params.radius);
+        SSKParticleCoreApplyFlocking(core, &grid, &params, dt);
+    }
+    float worst = 0.0f;
+    for (uint32_t slot = 0; ok && slot < count; slot++) {
+        float ex = fabsf(core->velocity[slot].x - expected[slot].x);
+        float ey = fabsf(core->velocity[slot].y - expected[slot].y);
+        float scale = 1.0f + fabsf(expected[slot].x) + fabsf(expected[slot].y);
+        worst = fmaxf(worst, fmaxf(ex, ey) / scale);
+    }
+    ok = ok && worst < 1e-4f;
+    printf("  flocking  %6u particles vs brute force (max rel. error %.2g): %s\n", count, worst, SSKBenchStatus(ok));
+    SSKSpatialGridDestroy(&grid);
+    SSKParticleCoreDestroy(core);
+    free(expected);
+    return ok;
+}
+
+static void SSKBenchTime(uint32_t count) {
+    SSKParticleCore *core = SSKBenchScatter(count, 3);
+    SSKSpatialGrid grid;
+    if (!core || !SSKSpatialGridInit(&grid, count)) { return; }
+    SSKParticleFlockingParams params = SSKBenchFlocking();
+    const float dt = 1.0f / 60.0f;
+
+    int rounds = count <= 10000 ? 50 : 10;
+    double start = SSKBenchNow();
+    for (int r = 0; r < rounds; r++) {
+        SSKSpatialGridBuild(&grid, core, params.radius);
+    }
+    double build = (SSKBenchNow() - start) / rounds;
+    start = SSKBenchNow();
+    for (int r = 0; r < rounds; r++) {
+        SSKSpatialGridBuild(&grid, core, params.radius);
+        SSKParticleCoreApplyFlocking(core, &grid, &params, dt);
+    }
+    double withGrid = (SSKBenchNow() - start) / rounds;
+
+    // Brute force is quadratic, so past 10k only a sample of particles is run.
+    uint32_t sample = count <= 10000 ? count : 1000;
+    volatile float sink = 0.0f;
+    start = SSKBenchNow();
+    for (uint32_t i = 0; i < sample; i++) {
+        sink += SSKBenchBruteSteering(core, i, &params).x;
+    }
+    double brute = (SSKBenchNow() - start) * ((double)count / sample);
+    (void)sink;
+
+    printf("  %6u particles: build %8.3f ms, build+flock %8.3f ms (%6.1f ns/particle), "
+           "brute force %10.1f ms (%8.1f ns/particle)%s, %.0fx\n",
+           count, build * 1e3, withGrid * 1e3, withGrid * 1e9 / count,
+           brute * 1e3, brute * 1e9 / count, sample < count ? " est." : "", brute / withGrid);
+    SSKSpatialGridDestroy(&grid);
+    SSKParticleCoreDestroy(core);
+}
+
+int main(void) {
+    printf("SSKSpatialGridBench\n");
+    bool ok = SSKBenchVerifyQueries(5000, 20.0f);
+    ok = SSKBenchVerifyQueries(5000, 3.0f) && ok;
+    ok = SSKBenchVerifyQueries(5000, 0.01f) && ok;
+    ok = SSKBenchVerifyQueries(1, 20.0f) && ok;
+    ok = SSKBenchVerifyFlocking(3000) && ok;
+    if (!ok) { return 1; }
+
+    const uint32_t counts[] = {1000, 10000, 100000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        SSKBenchTime(counts[i]);
+    }
+    return 0;
+}
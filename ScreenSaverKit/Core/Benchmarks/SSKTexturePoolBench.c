@@ -0,0 +1,261 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Texture pool benchmark with a fake device.
+//
+// Fake textures are slots in a static array with a destroyed flag. Checks
+// that keys whose old XOR-packed cache keys collide stay apart, then runs
+// random acquire/release/advance-frame sequences against a naive array model
+// of the same policy (most recent match on acquire, least recently released
+// first on eviction, byte budget, idle age) and compares every handle, every
+// eviction and the counters. Finally times an acquire + release pair with
+// 16 to 16384 idle textures next to an insertion-order array that removes
+// the texture by linear search, as the previous cache did on every acquire.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKRandom.h"
+#include "SSKTexturePool.h"
+
+enum { SSKBenchMaxTextures = 1 << 16, SSKBenchMaxModel = 4096 };
+
+typedef struct {
+    SSKTexturePoolKey key;
+    bool live;
+} SSKBenchTexture;
+
+static SSKBenchTexture SSKBenchTextures[SSKBenchMaxTextures];
+static uint32_t SSKBenchTextureCount;
+static uint32_t SSKBenchLiveTextures;
+
+static void *SSKBenchCreateTexture(void *context, const SSKTexturePoolKey *key) {
+    (void)context;
+    if (SSKBenchTextureCount == SSKBenchMaxTextures) { return NULL; }
+    SSKBenchTexture *texture = &SSKBenchTextures[SSKBenchTextureCount++];
+    texture->key = *key;
+    texture->live = true;
+    SSKBenchLiveTextures += 1;
+    return texture;
+}
+
+static void SSKBenchDestroyTexture(void *context, void *handle) {
+    (void)context;
+    SSKBenchTexture *texture = handle;
+    texture->live = false;
+    SSKBenchLiveTextures -= 1;
+}
+
+static SSKTexturePool *SSKBenchCreatePool(uint64_t budget) {
+    SSKBenchTextureCount = 0;
+    SSKBenchLiveTextures = 0;
+    SSKTexturePoolDevice device = {NULL, SSKBenchCreateTexture, SSKBenchDestroyTexture};
+    return SSKTexturePoolCreate(&device, budget);
+}
+
+static uint64_t SSKBenchXorKey(const SSKTexturePoolKey *key) {
+    return ((uint64_t)key->width << 32) ^ ((uint64_t)key->height << 16) ^ ((uint64_t)key->format << 8) ^ key->usage;
+}
+
+static bool SSKBenchCheckCollisions(void) {
+    // Same XOR key: 0x81 << 8 ^ 0x3 == 0x80 << 8 ^ 0x103, and 1 << 16 ^ 0x10000 == 2 << 16 ^ 0x20000.
+    SSKTexturePoolKey pairs[2][2] = {
+        {{64, 64, 0x81, 0x3, 4}, {64, 64, 0x80, 0x103, 4}},
+        {{64, 1, 80, 0x10000, 4}, {64, 2, 80, 0x20000, 4}},
+    };
+    SSKTexturePool *pool = SSKBenchCreatePool(UINT64_MAX);
+    bool ok = pool != NULL;
+    for (int p = 0; ok && p < 2; p++) {
+        ok = SSKBenchXorKey(&pairs[p][0]) == SSKBenchXorKey(&pairs[p][1]);
+        void *first = SSKTexturePoolAcquire(pool, &pairs[p][0]);
+        SSKTexturePoolRelease(pool, &pairs[p][0], first);
+        void *second = SSKTexturePoolAcquire(pool, &pairs[p][1]);
+        ok = ok && second != first && SSKTexturePoolAcquire(pool, &pairs[p][0]) == first;
+        SSKTexturePoolRelease(pool, &pairs[p][1], second);
+    }
+    SSKTexturePoolStats stats = SSKTexturePoolGetStats(pool);
+    ok = ok && stats.hits == 2 && stats.misses == 4;
+    SSKTexturePoolDestroy(pool);
+    ok = ok && SSKBenchLiveTextures == 2;  // The two re-acquired textures are still out.
+    SSKBenchCheck("keys colliding under the old XOR packing stay distinct", ok);
+    return ok;
+}
+
+typedef struct {
+    SSKBenchTexture *handle;
+    uint64_t frame;
+} SSKBenchModelEntry;
+
+/// Naive pool: entries in release order, oldest first.
+typedef struct {
+    SSKBenchModelEntry entries[SSKBenchMaxModel];
+    uint32_t count;
+    uint64_t bytes;
+    uint64_t frame;
+    uint64_t evictions;
+} SSKBenchModel;
+
+static bool SSKBenchModelEvictOldest(SSKBenchModel *model) {
+    SSKBenchTexture *handle = model->entries[0].handle;
+    model->bytes -= SSKTexturePoolKeyBytes(&handle->key);
+    memmove(model->entries, model->entries + 1, sizeof(SSKBenchModelEntry) * --model->count);
+    model->evictions += 1;
+    return !handle->live;  // The pool must have destroyed the same texture.
+}
+
+static bool SSKBenchCheckModel(void) {
+    const uint32_t widths[] = {256, 512, 1024, 2048};
+    const uint64_t budget = 48ull << 20;
+    const uint32_t maxIdle = 40;
+    SSKRandom random = SSKRandomMake(11);
+    SSKTexturePool *pool = SSKBenchCreatePool(budget);
+    SSKTexturePoolSetMaxIdleFrames(pool, maxIdle);
+    static SSKBenchModel model;
+    memset(&model, 0, sizeof(model));
+    SSKBenchTexture *held[64];
+    uint32_t heldCount = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    bool ok = pool != NULL;
+    uint32_t steps = 0;
+    for (; ok && steps < 200000 && SSKBenchTextureCount + 8 < SSKBenchMaxTextures; steps++) {
+        uint32_t roll = SSKRandomNext(&random) % 100;
+        if (roll < 45 && heldCount < 64) {
+            uint32_t format = SSKRandomNext(&random) % 2;
+            SSKTexturePoolKey key = {widths[SSKRandomNext(&random) % 4], widths[SSKRandomNext(&random) % 2] / 2,
+                                     format ? 115 : 80, 1 + SSKRandomNext(&random) % 2, format ? 8 : 4};
+            SSKBenchTexture *expected = NULL;
+            for (uint32_t i = model.count; i-- > 0;) {
+                if (SSKTexturePoolKeyEqual(&model.entries[i].handle->key, &key)) {
+                    expected = model.entries[i].handle;
+                    model.bytes -= SSKTexturePoolKeyBytes(&key);
+                    memmove(model.entries + i, model.entries + i + 1, sizeof(SSKBenchModelEntry) * (model.count - i - 1));
+                    model.count -= 1;
+                    break;
+                }
+            }
+            uint32_t created = SSKBenchTextureCount;
+            SSKBenchTexture *texture = SSKTexturePoolAcquire(pool, &key);
+            if (expected) {
+                ok = texture == expected;
+                hits += 1;
+            } else {
+                ok = texture == &SSKBenchTextures[created] && SSKBenchTextureCount == created + 1;
+                misses += 1;
+            }
+            ok = ok && texture->live && SSKTexturePoolKeyEqual(&texture->key, &key);
+            held[heldCount++] = texture;
+        } else if (roll < 90 && heldCount > 0) {
+            uint32_t pick = SSKRandomNext(&random) % heldCount;
+            SSKBenchTexture *texture = held[pick];
+            held[pick] = held[--heldCount];
+            SSKTexturePoolRelease(pool, &texture->key, texture);
+            uint64_t bytes = SSKTexturePoolKeyBytes(&texture->key);
+            while (model.bytes + bytes > budget) {
+                ok = SSKBenchModelEvictOldest(&model) && ok;
+            }
+            model.entries[model.count++] = (SSKBenchModelEntry){texture, model.frame};
+            model.bytes += bytes;
+        } else {
+            SSKTexturePoolAdvanceFrame(pool);
+            model.frame += 1;
+            while (model.count > 0 && model.frame - model.entries[0].frame > maxIdle) {
+                ok = SSKBenchModelEvictOldest(&model) && ok;
+            }
+        }
+        SSKTexturePoolStats stats = SSKTexturePoolGetStats(pool);
+        ok = ok && stats.pooledCount == model.count && stats.pooledBytes == model.bytes && stats.pooledBytes <= budget &&
+             stats.hits == hits && stats.misses == misses && stats.evictions == model.evictions &&
+             SSKBenchLiveTextures == model.count + heldCount;
+        for (uint32_t i = 0; ok && i < model.count; i++) {
+            ok = model.entries[i].handle->live;
+        }
+    }
+    SSKTexturePoolStats stats = SSKTexturePoolGetStats(pool);
+    SSKTexturePoolDestroy(pool);
+    ok = ok && SSKBenchLiveTextures == heldCount;
+    printf("  %u random steps against the model: %llu hits, %llu misses, %llu evictions, %.0f%% hit rate: %s\n", steps,
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.evictions,
+           100.0 * (double)stats.hits / (double)(stats.hits + stats.misses), SSKBenchStatus(ok));
+    return ok;
+}
+
+static bool SSKBenchCheckAging(void) {
+    SSKTexturePool *pool = SSKBenchCreatePool(UINT64_MAX);
+    SSKTexturePoolSetMaxIdleFrames(pool, 3);
+    SSKTexturePoolKey small = {640, 360, 80, 3, 4};
+    SSKTexturePoolKey large = {5120, 2880, 80, 3, 4};
+    void *stale = SSKTexturePoolAcquire(pool, &small);
+    void *warm = SSKTexturePoolAcquire(pool, &large);
+    SSKTexturePoolRelease(pool, &small, stale);
+    SSKTexturePoolRelease(pool, &large, warm);
+    bool ok = true;
+    for (int frame = 0; frame < 10; frame++) {
+        SSKTexturePoolAdvanceFrame(pool);
+        // The large texture is reused every frame, as the effect chain does.
+        void *texture = SSKTexturePoolAcquire(pool, &large);
+        ok = ok && texture == warm;
+        SSKTexturePoolRelease(pool, &large, texture);
+    }
+    SSKTexturePoolStats stats = SSKTexturePoolGetStats(pool);
+    ok = ok && stats.pooledCount == 1 && stats.evictions == 1 && !((SSKBenchTexture *)stale)->live;
+    SSKTexturePoolSetBudget(pool, 1);
+    stats = SSKTexturePoolGetStats(pool);
+    ok = ok && stats.pooledCount == 0 && SSKBenchLiveTextures == 0;
+    SSKTexturePoolDestroy(pool);
+    SSKBenchCheck("idle aging and budget changes evict", ok);
+    return ok;
+}
+
+static void SSKBenchTiming(void) {
+    const uint32_t sizes[] = {16, 1024, 16384};
+    static void *linear[16384];
+    for (int s = 0; s < 3; s++) {
+        uint32_t count = sizes[s];
+        SSKTexturePool *pool = SSKBenchCreatePool(UINT64_MAX);
+        for (uint32_t i = 0; i < count; i++) {
+            SSKTexturePoolKey key = {64 + i, 64, 80, 3, 4};
+            linear[i] = SSKTexturePoolAcquire(pool, &key);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            SSKTexturePoolRelease(pool, &((SSKBenchTexture *)linear[i])->key, linear[i]);
+        }
+        SSKRandom random = SSKRandomMake(3);
+        const int iterations = 2000000;
+        double start = SSKBenchNow();
+        for (int i = 0; i < iterations; i++) {
+            SSKTexturePoolKey key = {64 + SSKRandomNext(&random) % count, 64, 80, 3, 4};
+            void *texture = SSKTexturePoolAcquire(pool, &key);
+            SSKTexturePoolRelease(pool, &key, texture);
+        }
+        double pooled = (SSKBenchNow() - start) / iterations;
+
+        // Old cache: insertion-order array, linear removeObjectIdenticalTo on acquire.
+        const int linearIterations = count > 1024 ? 20000 : 200000;
+        start = SSKBenchNow();
+        for (int i = 0; i < linearIterations; i++) {
+            void *texture = &SSKBenchTextures[SSKRandomNext(&random) % count];
+            uint32_t at = 0;
+            while (at < count && linear[at] != texture) { at++; }
+            memmove(linear + at, linear + at + 1, sizeof(void *) * (count - at - 1));
+            linear[count - 1] = texture;
+        }
+        double scanned = (SSKBenchNow() - start) / linearIterations;
+        printf("  acquire + release with %5u idle: %6.1f ns | linear removal: %8.1f ns\n", count, pooled * 1e9,
+               scanned * 1e9);
+        SSKTexturePoolDestroy(pool);
+    }
+}
+
+int main(void) {
+    printf("SSKTexturePoolBench\n");
+    bool ok = SSKBenchCheckCollisions();
+    ok = SSKBenchCheckModel() && ok;
+    ok = SSKBenchCheckAging() && ok;
+    if (!ok) { return 1; }
+    SSKBenchTiming();
+    return 0;
+}
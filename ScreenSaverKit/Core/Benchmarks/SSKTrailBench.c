@@ -0,0 +1,304 @@
+#define _POSIX_C_SOURCE 200112L
+
+// Trail tessellator benchmark.
+//
+// Checks the ring buffers (wrap-around order, moved heads, dropped duplicate
+// points), the geometry of hand-computed trails (straight runs, a right-angle
+// miter, a clamped sharp miter, a trail that doubles back), the width and
+// colour ramps, and that short buffers receive whole trails as a prefix of
+// the full mesh. Rasterises a strip to check solid interiors, one-pixel and
+// softened edges, and that the seam between a segment's two triangles is not
+// blended twice. Then times tessellating 1k to 100k wandering trails of 64 points.
+//
+//   make -C ScreenSaverKit/Core bench
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SSKBench.h"
+#include "SSKRandom.h"
+#include "SSKTrail.h"
+
+static bool SSKBenchNear(float a, float b) {
+    return fabsf(a - b) <= 1e-4f * fmaxf(1.0f, fabsf(b));
+}
+
+static bool SSKBenchPointNear(SSKFloat2 p, float x, float y) {
+    return SSKBenchNear(p.x, x) && SSKBenchNear(p.y, y);
+}
+
+/// Tessellates `set` into freshly allocated buffers sized for every trail.
+static SSKTrailMeshCounts SSKBenchTessellate(const SSKTrailSet *set, const SSKTrailMeshParams *params,
+                                             SSKTrailVertex **vertices, uint32_t **indices) {
+    uint32_t maxVertices = SSKTrailSetMaxVertexCount(set);
+    uint32_t maxIndices = SSKTrailSetMaxIndexCount(set);
+    *vertices = calloc(maxVertices, sizeof(SSKTrailVertex));
+    *indices = calloc(maxIndices, sizeof(uint32_t));
+    SSKTrailMeshCounts counts = {0, 0};
+    if (*vertices && *indices) {
+        counts = SSKTrailSetTessellate(set, params, *vertices, maxVertices, *indices, maxIndices);
+    }
+    return counts;
+}
+
+static bool SSKBenchVerifyRing(void) {
+    SSKTrailSet *set = SSKTrailSetCreate(2, 3);
+    if (!set) { return false; }
+    bool ok = true;
+    for (int i = 0; i < 5; i++) {
+        ok = SSKTrailSetPush(set, 1, SSKFloat2Make((float)i, 0.0f)) && ok;
+    }
+    ok = ok && set->length[0] == 0 && set->length[1] == 3;
+    ok = ok && SSKBenchPointNear(SSKTrailSetPoint(set, 1, 0), 2.0f, 0.0f) &&
+         SSKBenchPointNear(SSKTrailSetPoint(set, 1, 2), 4.0f, 0.0f);
+    // A point on top of the newest one is dropped; the trail is unchanged.
+    ok = ok && !SSKTrailSetPush(set, 1, SSKFloat2Make(4.001f, 0.0f)) && set->length[1] == 3 &&
+         SSKBenchPointNear(SSKTrailSetPoint(set, 1, 2), 4.0f, 0.0f);
+    // Moving the head replaces the newest point, unless it would land on the one before.
+    ok = ok && SSKTrailSetMoveHead(set, 1, SSKFloat2Make(5.0f, 1.0f)) && set->length[1] == 3 &&
+         SSKBenchPointNear(SSKTrailSetPoint(set, 1, 2), 5.0f, 1.0f) &&
+         !SSKTrailSetMoveHead(set, 1, SSKFloat2Make(3.0f, 0.0f)) &&
+         !SSKTrailSetMoveHead(set, 0, SSKFloat2Make(1.0f, 1.0f));
+    SSKTrailSetClear(set, 1);
+    ok = ok && set->length[1] == 0 && SSKTrailSetPush(set, 1, SSKFloat2Make(4.0f, 0.0f));
+    SSKTrailSetDestroy(set);
+    return ok;
+}
+
+static bool SSKBenchVerifyGeometry(void) {
+    SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+    params.miterLimit = 3.0f;
+    SSKTrailSet *set = SSKTrailSetCreate(4, 3);
+    if (!set) { return false; }
+    SSKFloat4 red = {1.0f, 0.0f, 0.0f, 1.0f};
+    SSKFloat4 clear = {0.0f, 0.0f, 1.0f, 0.0f};
+    // 0: straight run along x, tapering from 2 to 6 wide and fading in.
+    static const float straight[][2] = {{0, 0}, {10, 0}, {20, 0}};
+    // 1: right-angle turn to the left.
+    static const float corner[][2] = {{0, 0}, {10, 0}, {10, 10}};
+    // 2: a turn so sharp the miter must be clamped.
+    static const float sharp[][2] = {{0, 0}, {10, 0}, {0, 1}};
+    // 3: doubles straight back on itself.
+    static const float back[][2] = {{0, 0}, {10, 0}, {0, 0}};
+    const float (*paths[4])[2] = {straight, corner, sharp, back};
+    for (uint32_t t = 0; t < 4; t++) {
+        for (uint32_t i = 0; i < 3; i++) {
+            SSKTrailSetPush(set, t, SSKFloat2Make(paths[t][i][0], paths[t][i][1]));
+        }
+        set->styles[t] = (SSKTrailStyle){4.0f, 4.0f, red, red};
+    }
+    set->styles[0] = (SSKTrailStyle){6.0f, 2.0f, red, clear};
+
+    SSKTrailVertex *vertices = NULL;
+    uint32_t *indices = NULL;
+    SSKTrailMeshCounts counts = SSKBenchTessellate(set, &params, &vertices, &indices);
+    bool ok = counts.vertexCount == 24 && counts.indexCount == 48;
+    if (ok) {
+        // Straight: extents of 1 + 1, 2 + 1 and 3 + 1 to the left (+y) and right.
+        const SSKTrailVertex *v = vertices;
+        ok = SSKBenchPointNear(v[0].position, 0.0f, 2.0f) && SSKBenchPointNear(v[1].position, 0.0f, -2.0f) &&
+             SSKBenchPointNear(v[2].position, 10.0f, 3.0f) && SSKBenchPointNear(v[5].position, 20.0f, -4.0f) &&
+             SSKBenchNear(v[0].edge, 2.0f) && SSKBenchNear(v[1].edge, -2.0f) && SSKBenchNear(v[4].halfWidth, 3.0f) &&
+             SSKBenchNear(v[2].color.x, 0.5f) && SSKBenchNear(v[2].color.z, 0.5f) &&
+             SSKBenchNear(v[2].color.w, 0.5f) && SSKBenchNear(v[4].color.w, 1.0f);
+        static const uint32_t expected[] = {0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4};
+        ok = ok && memcmp(indices, expected, sizeof(expected)) == 0;
+        // Corner: the inner vertex sits 3 from both edges of the turn, the
+        // outer one on the far side of both offset lines.
+        v = vertices + 6;
+        ok = ok && SSKBenchPointNear(v[2].position, 7.0f, 3.0f) && SSKBenchPointNear(v[3].position, 13.0f, -3.0f) &&
+             SSKBenchNear(v[2].edge, 3.0f);
+        // Sharp: the miter stops at three times the extent.
+        v = vertices + 12;
+        float dx = v[2].position.x - 10.0f;
+        float dy = v[2].position.y;
+        ok = ok && SSKBenchNear(sqrtf(dx * dx + dy * dy), 9.0f);
+        // Doubling back keeps the incoming normal and stays finite.
+        v = vertices + 18;
+        ok = ok && SSKBenchPointNear(v[2].position, 10.0f, 3.0f) && SSKBenchPointNear(v[3].position, 10.0f, -3.0f);
+        // Every index lands in its own trail.
+        for (uint32_t i = 0; ok && i < counts.indexCount; i++) {
+            ok = indices[i] / 6 == i / 12;
+        }
+    }
+    free(vertices);
+    free(indices);
+    SSKTrailSetDestroy(set);
+    return ok;
+}
+
+/// Trails that wander like RibbonFlow's emitters, at every fill level.
+static SSKTrailSet *SSKBenchWanderingTrails(uint32_t trailCount, uint32_t capacity, uint64_t seed) {
+    SSKTrailSet *set = SSKTrailSetCreate(trailCount, capacity);
+    if (!set) { return NULL; }
+    SSKRandom random = SSKRandomMake(seed);
+    for (uint32_t t = 0; t < trailCount; t++) {
+        uint32_t points = t % 5 == 0 ? t % capacity : capacity + t % 7;
+        float x = SSKRandomNextRange(&random, 0.0f, 1920.0f);
+        float y = SSKRandomNextRange(&random, 0.0f, 1080.0f);
+        float heading = SSKRandomNextRange(&random, 0.0f, 6.2831853f);
+        for (uint32_t i = 0; i < points; i++) {
+            heading += SSKRandomNextRange(&random, -0.6f, 0.6f);
+            x += cosf(heading) * 6.0f;
+            y += sinf(heading) * 6.0f;
+            SSKTrailSetPush(set, t, SSKFloat2Make(x, y));
+        }
+        set->styles[t] = (SSKTrailStyle){SSKRandomNextRange(&random, 2.0f, 12.0f), 0.5f,
+                                         {SSKRandomNextUnit(&random), 0.5f, 1.0f, 0.9f}, {0.2f, 0.2f, 0.8f, 0.0f}};
+    }
+    return set;
+}
+
+static bool SSKBenchVerifyPrefix(void) {
+    SSKTrailSet *set = SSKBenchWanderingTrails(200, 24, 5);
+    if (!set) { return false; }
+    SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+    SSKTrailVertex *full = NULL;
+    uint32_t *fullIndices = NULL;
+    SSKTrailMeshCounts whole = SSKBenchTessellate(set, &params, &full, &fullIndices);
+    SSKTrailVertex *partial = calloc(whole.vertexCount, sizeof(SSKTrailVertex));
+    uint32_t *partialIndices = calloc(whole.indexCount, sizeof(uint32_t));
+    bool ok = full && fullIndices && partial && partialIndices && whole.vertexCount > 0;
+    for (uint32_t i = 0; ok && i < whole.vertexCount; i++) {
+        ok = isfinite(full[i].position.x) && isfinite(full[i].position.y) && full[i].halfWidth >= 0.0f;
+    }
+    const uint32_t vertexLimits[] = {0, 3, whole.vertexCount / 2, whole.vertexCount - 1, whole.vertexCount};
+    for (size_t l = 0; ok && l < sizeof(vertexLimits) / sizeof(vertexLimits[0]); l++) {
+        SSKTrailMeshCounts got = SSKTrailSetTessellate(set, &params, partial, vertexLimits[l], partialIndices,
+                                                       whole.indexCount);
+        // The mesh must end on a trail boundary, just before the first trail that did not fit.
+        SSKTrailMeshCounts boundary = {0, 0};
+        uint32_t t = 0;
+        for (; t < set->trailCount; t++) {
+            uint32_t points = set->length[t];
+            if (points < 2) { continue; }
+            if (boundary.vertexCount + points * 2 > vertexLimits[l]) { break; }
+            boundary.vertexCount += points * 2;
+            boundary.indexCount += (points - 1) * 6;
+        }
+        ok = got.vertexCount == boundary.vertexCount && got.indexCount == boundary.indexCount &&
+             memcmp(full, partial, got.vertexCount * sizeof(SSKTrailVertex)) == 0 &&
+             memcmp(fullIndices, partialIndices, got.indexCount * sizeof(uint32_t)) == 0;
+    }
+    free(partial);
+    free(partialIndices);
+    free(full);
+    free(fullIndices);
+    SSKTrailSetDestroy(set);
+    return ok;
+}
+
+/// A half-transparent strip 6 points wide along y = 10.5, tessellated into
+/// `vertices` and `indices`.
+static SSKTrailMeshCounts SSKBenchStrip(SSKTrailSet *set, const SSKTrailMeshParams *params,
+                                        SSKTrailVertex *vertices, uint32_t *indices) {
+    SSKTrailSetClear(set, 0);
+    SSKTrailSetPush(set, 0, SSKFloat2Make(4.0f, 10.5f));
+    SSKTrailSetPush(set, 0, SSKFloat2Make(36.0f, 10.5f));
+    SSKFloat4 color = {1.0f, 1.0f, 1.0f, 0.5f};
+    set->styles[0] = (SSKTrailStyle){6.0f, 6.0f, color, color};
+    return SSKTrailSetTessellate(set, params, vertices, 4, indices, 6);
+}
+
+static bool SSKBenchVerifyRaster(void) {
+    const uint32_t width = 40;
+    const uint32_t height = 20;
+    SSKTrailSet *set = SSKTrailSetCreate(1, 2);
+    uint8_t *pixels = calloc((size_t)width * height, 4);
+    SSKFloat4 *wide = calloc((size_t)width * height, sizeof(SSKFloat4));
+    SSKTrailVertex vertices[4];
+    uint32_t indices[6];
+    bool ok = set && pixels && wide;
+    if (ok) {
+        // Drawn at 1 pixel per point with the default one-pixel edge.
+        SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+        SSKTrailMeshCounts counts = SSKBenchStrip(set, &params, vertices, indices);
+        SSKRasterTarget target = {pixels, width, height, width * 4, SSKRasterFormatRGBA8};
+        SSKParticleRasterParams raster = {SSKFloat2Make(0.0f, 0.0f), SSKFloat2Make((float)width, (float)height),
+                                          SSKRasterBlendAlpha};
+        SSKTrailRasterize(&target, &raster, &params, vertices, indices, counts.indexCount);
+        // Rows 8 to 12 are inside: every pixel there, including those on the
+        // diagonal seam, is blended exactly once.
+        for (uint32_t y = 8; ok && y <= 12; y++) {
+            for (uint32_t x = 4; ok && x < 36; x++) {
+                ok = pixels[(y * width + x) * 4 + 3] == 128 && pixels[(y * width + x) * 4] == 128;
+            }
+        }
+        // Rows 7 and 13 have their centres on the edges and are half covered;
+        // the rows beyond are empty.
+        ok = ok && pixels[(7 * width + 20) * 4 + 3] == 64 && pixels[(13 * width + 20) * 4 + 3] == 64;
+        ok = ok && pixels[(6 * width + 20) * 4 + 3] == 0 && pixels[(14 * width + 20) * 4 + 3] == 0;
+
+        // With 4 points of softness the edge fades from 2 points inside to 2
+        // outside; added into a float target, each row holds its coverage / 2.
+        params.softness = 4.0f;
+        counts = SSKBenchStrip(set, &params, vertices, indices);
+        ok = ok && SSKBenchNear(vertices[0].edge, 6.0f);
+        SSKRasterTarget floatTarget = {wide, width, height, width * sizeof(SSKFloat4), SSKRasterFormatFloat};
+        raster.blend = SSKRasterBlendAdditive;
+        SSKTrailRasterize(&floatTarget, &raster, &params, vertices, indices, counts.indexCount);
+        // Row 10 +- d has its centre d points from the centre line.
+        static const float expected[] = {0.5f, 0.5f, 0.375f, 0.25f, 0.125f, 0.0f, 0.0f};
+        for (uint32_t d = 0; ok && d < sizeof(expected) / sizeof(expected[0]); d++) {
+            SSKFloat4 below = wide[(10 + d) * width + 20];
+            SSKFloat4 above = wide[(10 - d) * width + 20];
+            ok = fabsf(below.w - expected[d]) < 1e-5f && fabsf(above.w - expected[d]) < 1e-5f &&
+                 fabsf(below.x - expected[d]) < 1e-5f;
+        }
+    }
+    free(pixels);
+    free(wide);
+    SSKTrailSetDestroy(set);
+    return ok;
+}
+
+static void SSKBenchTime(uint32_t trailCount) {
+    const uint32_t capacity = 64;
+    const int frames = 20;
+    SSKTrailSet *set = SSKBenchWanderingTrails(trailCount, capacity, 11);
+    SSKTrailVertex *vertices = NULL;
+    uint32_t *indices = NULL;
+    SSKTrailMeshParams params = SSKTrailMeshParamsDefault();
+    SSKTrailMeshCounts counts = {0, 0};
+    if (set) {
+        counts = SSKBenchTessellate(set, &params, &vertices, &indices);
+    }
+    if (!set || !vertices || !indices) {
+        free(vertices);
+        free(indices);
+        SSKTrailSetDestroy(set);
+        return;
+    }
+    uint32_t maxVertices = SSKTrailSetMaxVertexCount(set);
+    uint32_t maxIndices = SSKTrailSetMaxIndexCount(set);
+    double start = SSKBenchNow();
+    for (int frame = 0; frame < frames; frame++) {
+        counts = SSKTrailSetTessellate(set, &params, vertices, maxVertices, indices, maxIndices);
+    }
+    double elapsed = (SSKBenchNow() - start) / frames;
+    uint32_t points = counts.vertexCount / 2;
+    printf("  %6u trails: %5.2f ns/point, %7.3f ms/frame (%u vertices, %u triangles)\n", trailCount,
+           elapsed / (points > 0 ? points : 1) * 1e9, elapsed * 1e3, counts.vertexCount, counts.indexCount / 3);
+    free(vertices);
+    free(indices);
+    SSKTrailSetDestroy(set);
+}
+
+int main(void) {
+    printf("SSKTrailBench\n");
+    bool ring = SSKBenchVerifyRing();
+    SSKBenchCheck("ring order, moved heads and dropped duplicates", ring);
+    bool geometry = SSKBenchVerifyGeometry();
+    SSKBenchCheck("miters, ramps and indices", geometry);
+    bool prefix = SSKBenchVerifyPrefix();
+    SSKBenchCheck("short buffers get whole trails as a prefix", prefix);
+    bool raster = SSKBenchVerifyRaster();
+    SSKBenchCheck("rasterised strips: hard and soft edges, seams", raster);
+    const uint32_t counts[] = {1000, 10000, 100000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        SSKBenchTime(counts[i]);
+    }
+    return ring && geometry && prefix && raster ? 0 : 1;
+}
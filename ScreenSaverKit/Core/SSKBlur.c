@@ -0,0 +1,701 @@
+#include "SSKBlur.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    /// Rows blurred before they are written out transposed: 8 pixels are two
+    /// cache lines per destination row.
+    SSKBlurBandRows = 8,
+    /// Rows per chunk for the per-pixel passes.
+    SSKBlurPixelBandRows = 16,
+};
+
+static void SSKBlurRowScalar(const float *row, float *out, uint32_t count, const float *weights, uint32_t radius) {
+    for (uint32_t j = 0; j < count; j++) {
+        const float *center = row + j;
+        float accum = center[0] * weights[0];
+        for (uint32_t i = 1; i <= radius; i++) {
+            accum += *(center + 4 * i) * weights[i];
+            accum += *(center - 4 * i) * weights[i];
+        }
+        out[j] = accum;
+    }
+}
+
+#if defined(__x86_64__)
+
+#define SSK_BLUR_WIDTH 4
+#define SSK_BLUR_SUFFIX SSE2
+#define SSK_BLUR_TARGET __attribute__((target("sse2")))
+#include "SSKBlurKernel.inc"
+
+#define SSK_BLUR_WIDTH 8
+#define SSK_BLUR_SUFFIX AVX2
+#define SSK_BLUR_TARGET __attribute__((target("avx2,fma")))
+#include "SSKBlurKernel.inc"
+
+#define SSK_BLUR_WIDTH 16
+#define SSK_BLUR_SUFFIX AVX512
+#define SSK_BLUR_TARGET __attribute__((target("avx512f")))
+#include "SSKBlurKernel.inc"
+
+#endif
+
+#if defined(__aarch64__)
+
+#define SSK_BLUR_WIDTH 4
+#define SSK_BLUR_SUFFIX NEON
+#define SSK_BLUR_TARGET
+#include "SSKBlurKernel.inc"
+
+#endif
+
+typedef void (*SSKBlurRowFunction)(const float *row, float *out, uint32_t count, const float *weights,
+                                   uint32_t radius);
+
+static SSKBlurRowFunction SSKBlurRowForLevel(SSKSIMDLevel level) {
+    if (!SSKSIMDLevelIsSupported(level)) { return SSKBlurRowScalar; }
+    switch (level) {
+#if defined(__x86_64__)
+        case SSKSIMDLevelSSE2:   return SSKBlurRowSSE2;
+        case SSKSIMDLevelAVX2:   return SSKBlurRowAVX2;
+        case SSKSIMDLevelAVX512: return SSKBlurRowAVX512;
+#endif
+#if defined(__aarch64__)
+        case SSKSIMDLevelNEON:   return SSKBlurRowNEON;
+#endif
+        default:                 return SSKBlurRowScalar;
+    }
+}
+
+bool SSKBlurWeightsInit(SSKBlurWeights *weights, float sigma, uint32_t radius) {
+    if (radius == 0 || radius > SSKBlurMaxRadius) { return false; }
+    memset(weights, 0, sizeof(*weights));
+    weights->radius = radius;
+    weights->weights[0] = 1.0f;
+    float sum = 1.0f;
+    float doubleSigmaSq = 2.0f * sigma * sigma;
+    for (uint32_t i = 1; i <= radius; ++i) {
+        float weight = expf(-(float)(i * i) / doubleSigmaSq);
+        weights->weights[i] = weight;
+        sum += 2.0f * weight;
+    }
+    float invSum = sum > 0.00001f ? (1.0f / sum) : 1.0f;
+    for (uint32_t i = 0; i <= radius; ++i) {
+        weights->weights[i] *= invSum;
+    }
+    return true;
+}
+
+SSKBlurWeights SSKBlurWeightsForSigma(float sigma) {
+    sigma = sigma > 0.5f ? sigma : 0.5f;
+    uint32_t radius = (uint32_t)ceilf(sigma * 3.0f > 1.0f ? sigma * 3.0f : 1.0f);
+    radius = radius < SSKBlurMaxRadius ? radius : SSKBlurMaxRadius;
+    SSKBlurWeights weights;
+    SSKBlurWeightsInit(&weights, sigma, radius);
+    return weights;
+}
+
+void SSKBlurContextInit(SSKBlurContext *context) {
+    memset(context, 0, sizeof(*context));
+    context->simdLevel = SSKSIMDBestLevel();
+}
+
+void SSKBlurContextDestroy(SSKBlurContext *context) {
+    if (!context) { return; }
+    free(context->scratch);
+    free(context->bright);
+    free(context->rows);
+    memset(context, 0, sizeof(*context));
+}
+
+static bool SSKBlurReserve(void **buffer, size_t *capacity, size_t count, size_t elementSize) {
+    if (*capacity >= count) { return true; }
+    void *grown = realloc(*buffer, count * elementSize);
+    if (!grown) { return false; }
+    *buffer = grown;
+    *capacity = count;
+    return true;
+}
+
+static bool SSKBlurImagesMatch(const SSKFloatImage *a, const SSKFloatImage *b) {
+    return a && b && a->pixels && b->pixels && a->width > 0 && a->height > 0 && a->width == b->width &&
+           a->height == b->height && a->stride >= a->width && b->stride >= b->width;
+}
+
+typedef void (*SSKBlurBandFunction)(void *context, uint32_t y0, uint32_t y1, uint32_t worker);
+
+typedef struct {
+    SSKBlurBandFunction function;
+    void *context;
+    uint32_t rows;
+    uint32_t bandRows;
+} SSKBlurBandJob;
+
+static void SSKBlurBandChunk(void *context, uint32_t chunk, uint32_t worker) {
+    SSKBlurBandJob *job = context;
+    uint32_t y0 = chunk * job->bandRows;
+    uint32_t y1 = y0 + job->bandRows < job->rows ? y0 + job->bandRows : job->rows;
+    job->function(job->context, y0, y1, worker);
+}
+
+/// Runs `function` over `rows` in bands of `bandRows`, on `pool` when it has
+/// more than one worker.
+static void SSKBlurForBands(SSKTaskPool *pool, uint32_t rows, uint32_t bandRows, SSKBlurBandFunction function,
+                            void *context) {
+    SSKBlurBandJob job = {function, context, rows, bandRows};
+    uint32_t bands = (rows + bandRows - 1) / bandRows;
+    if (!pool || SSKTaskPoolWorkerCount(pool) < 2 || bands < 2) {
+        for (uint32_t b = 0; b < bands; b++) { SSKBlurBandChunk(&job, b, 0); }
+        return;
+    }
+    SSKTaskPoolParallelFor(pool, bands, SSKBlurBandChunk, &job);
+}
+
+static inline uint32_t SSKBlurWorkerCount(SSKTaskPool *pool) {
+    return pool ? SSKTaskPoolWorkerCount(pool) : 1;
+}
+
+typedef struct {
+    const SSKFloatImage *source;
+    const SSKFloatImage *transposed;
+    const SSKBlurWeights *weights;
+    SSKBlurRowFunction row;
+    float *rows;
+    size_t rowsPerWorker;
+} SSKBlurPassJob;
+
+/// Blurs source rows `[y0, y1)` horizontally and stores them as columns of
+/// the transposed image.
+static void SSKBlurPassBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    SSKBlurPassJob *job = context;
+    const SSKFloatImage *source = job->source;
+    const SSKFloatImage *transposed = job->transposed;
+    uint32_t width = source->width;
+    uint32_t radius = job->weights->radius;
+    float *padded = job->rows + job->rowsPerWorker * worker;
+    SSKFloat4 *band = (SSKFloat4 *)(void *)(padded + ((size_t)width + 2 * SSKBlurMaxRadius) * 4);
+    SSKFloat4 *paddedPixels = (SSKFloat4 *)(void *)padded;
+
+    for (uint32_t y = y0; y < y1; y++) {
+        const SSKFloat4 *src = source->pixels + (size_t)y * source->stride;
+        // Clamp-to-edge: replicate the end pixels across the radius.
+        for (uint32_t i = 0; i < radius; i++) {
+            paddedPixels[i] = src[0];
+            paddedPixels[radius + width + i] = src[width - 1];
+        }
+        memcpy(paddedPixels + radius, src, sizeof(SSKFloat4) * width);
+        job->row(padded + (size_t)radius * 4, (float *)(void *)(band + (size_t)(y - y0) * width), width * 4,
+                 job->weights->weights, radius);
+    }
+
+    uint32_t bandRows = y1 - y0;
+    for (uint32_t x = 0; x < width; x++) {
+        SSKFloat4 *dst = transposed->pixels + (size_t)x * transposed->stride + y0;
+        for (uint32_t k = 0; k < bandRows; k++) {
+            dst[k] = band[(size_t)k * width + x];
+        }
+    }
+}
+
+/// One horizontal pass from `source` into its transpose.
+static void SSKBlurPass(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                        const SSKFloatImage *transposed, const SSKBlurWeights *weights, size_t rowsPerWorker) {
+    SSKBlurPassJob job = {
+        source, transposed, weights, SSKBlurRowForLevel(context->simdLevel), context->rows, rowsPerWorker,
+    };
+    SSKBlurForBands(pool, source->height, SSKBlurBandRows, SSKBlurPassBand, &job);
+}
+
+/// Floats of per-worker row storage for images up to `extent` pixels wide or tall.
+static size_t SSKBlurRowsPerWorker(uint32_t extent) {
+    return ((size_t)extent + 2 * SSKBlurMaxRadius) * 4 + (size_t)extent * SSKBlurBandRows * 4;
+}
+
+/// Blurs `source` into `destination` through `transposed`, which must hold
+/// `width * height` pixels. The context rows must already be reserved.
+static void SSKBlurSeparable(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                             const SSKFloatImage *destination, SSKFloat4 *transposedPixels,
+                             const SSKBlurWeights *weights) {
+    uint32_t extent = source->width > source->height ? source->width : source->height;
+    size_t rowsPerWorker = SSKBlurRowsPerWorker(extent);
+    SSKFloatImage transposed = {transposedPixels, source->height, source->width, source->height};
+    SSKBlurPass(context, pool, source, &transposed, weights, rowsPerWorker);
+    SSKBlurPass(context, pool, &transposed, destination, weights, rowsPerWorker);
+}
+
+static bool SSKBlurReserveRows(SSKBlurContext *context, SSKTaskPool *pool, uint32_t extent) {
+    size_t count = SSKBlurRowsPerWorker(extent) * SSKBlurWorkerCount(pool);
+    return SSKBlurReserve((void **)&context->rows, &context->rowCapacity, count, sizeof(float));
+}
+
+static void SSKBlurCopy(const SSKFloatImage *source, const SSKFloatImage *destination) {
+    if (source->pixels == destination->pixels && source->stride == destination->stride) { return; }
+    for (uint32_t y = 0; y < source->height; y++) {
+        memmove(destination->pixels + (size_t)y * destination->stride, source->pixels + (size_t)y * source->stride,
+                sizeof(SSKFloat4) * source->width);
+    }
+}
+
+bool SSKBlurGaussian(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                     const SSKFloatImage *destination, float sigma) {
+    if (!context || !SSKBlurImagesMatch(source, destination)) { return false; }
+    if (!(sigma > 0.01f)) {
+        SSKBlurCopy(source, destination);
+        return true;
+    }
+    size_t pixels = (size_t)source->width * source->height;
+    uint32_t extent = source->width > source->height ? source->width : source->height;
+    if (!SSKBlurReserve((void **)&context->scratch, &context->scratchCapacity, pixels, sizeof(SSKFloat4)) ||
+        !SSKBlurReserveRows(context, pool, extent)) {
+        return false;
+    }
+    SSKBlurWeights weights = SSKBlurWeightsForSigma(sigma);
+    SSKBlurSeparable(context, pool, source, destination, context->scratch, &weights);
+    return true;
+}
+
+uint32_t SSKBlurLevelsForSigma(float sigma) {
+    uint32_t levels = 0;
+    while (sigma > 4.0f && levels < 8) {
+        sigma *= 0.5f;
+        levels++;
+    }
+    return levels;
+}
+
+typedef struct {
+    const SSKFloatImage *source;
+    const SSKFloatImage *destination;
+} SSKBlurResampleJob;
+
+/// 2x2 box average, clamping the odd last row and column.
+static void SSKBlurDownsampleBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBlurResampleJob *job = context;
+    const SSKFloatImage *source = job->source;
+    const SSKFloatImage *destination = job->destination;
+    for (uint32_t y = y0; y < y1; y++) {
+        const SSKFloat4 *top = source->pixels + (size_t)(2 * y) * source->stride;
+        const SSKFloat4 *bottom = 2 * y + 1 < source->height ? top + source->stride : top;
+        SSKFloat4 *dst = destination->pixels + (size_t)y * destination->stride;
+        for (uint32_t x = 0; x < destination->width; x++) {
+            uint32_t x0 = 2 * x;
+            uint32_t x1 = x0 + 1 < source->width ? x0 + 1 : x0;
+            dst[x].x = (top[x0].x + top[x1].x + bottom[x0].x + bottom[x1].x) * 0.25f;
+            dst[x].y = (top[x0].y + top[x1].y + bottom[x0].y + bottom[x1].y) * 0.25f;
+            dst[x].z = (top[x0].z + top[x1].z + bottom[x0].z + bottom[x1].z) * 0.25f;
+            dst[x].w = (top[x0].w + top[x1].w + bottom[x0].w + bottom[x1].w) * 0.25f;
+        }
+    }
+}
+
+/// Bilinear upsample with pixel centres aligned, clamped at the edges.
+static void SSKBlurUpsampleBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBlurResampleJob *job = context;
+    const SSKFloatImage *source = job->source;
+    const SSKFloatImage *destination = job->destination;
+    float scaleX = (float)source->width / (float)destination->width;
+    float scaleY = (float)source->height / (float)destination->height;
+    float maxX = (float)(source->width - 1);
+    float maxY = (float)(source->height - 1);
+    for (uint32_t y = y0; y < y1; y++) {
+        float fy = ((float)y + 0.5f) * scaleY - 0.5f;
+        fy = fy > 0.0f ? (fy < maxY ? fy : maxY) : 0.0f;
+        uint32_t sy0 = (uint32_t)fy;
+        uint32_t sy1 = sy0 + 1 < source->height ? sy0 + 1 : sy0;
+        float ty = fy - (float)sy0;
+        const SSKFloat4 *top = source->pixels + (size_t)sy0 * source->stride;
+        const SSKFloat4 *bottom = source->pixels + (size_t)sy1 * source->stride;
+        SSKFloat4 *dst = destination->pixels + (size_t)y * destination->stride;
+        for (uint32_t x = 0; x < destination->width; x++) {
+            float fx = ((float)x + 0.5f) * scaleX - 0.5f;
+            fx = fx > 0.0f ? (fx < maxX ? fx : maxX) : 0.0f;
+            uint32_t sx0 = (uint32_t)fx;
+            uint32_t sx1 = sx0 + 1 < source->width ? sx0 + 1 : sx0;
+            float tx = fx - (float)sx0;
+            float w00 = (1.0f - tx) * (1.0f - ty), w10 = tx * (1.0f - ty);
+            float w01 = (1.0f - tx) * ty, w11 = tx * ty;
+            dst[x].x = top[sx0].x * w00 + top[sx1].x * w10 + bottom[sx0].x * w01 + bottom[sx1].x * w11;
+            dst[x].y = top[sx0].y * w00 + top[sx1].y * w10 + bottom[sx0].y * w01 + bottom[sx1].y * w11;
+            dst[x].z = top[sx0].z * w00 + top[sx1].z * w10 + bottom[sx0].z * w01 + bottom[sx1].z * w11;
+            dst[x].w = top[sx0].w * w00 + top[sx1].w * w10 + bottom[sx0].w * w01 + bottom[sx1].w * w11;
+        }
+    }
+}
+
+bool SSKBlurGaussianDownsampled(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                                const SSKFloatImage *destination, float sigma, uint32_t levels) {
+    if (levels == 0 || !(sigma > 0.01f)) { return SSKBlurGaussian(context, pool, source, destination, sigma); }
+    if (!context || !SSKBlurImagesMatch(source, destination)) { return false; }
+
+    // Stop early rather than shrink a dimension below one pixel.
+    SSKFloatImage pyramid[9];
+    uint32_t width = source->width, height = source->height;
+    uint32_t count = 0;
+    size_t total = 0;
+    while (count < levels && count < 8 && (width > 1 || height > 1)) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        pyramid[count++] = (SSKFloatImage){NULL, width, height, width};
+        total += (size_t)width * height;
+    }
+    if (count == 0) { return SSKBlurGaussian(context, pool, source, destination, sigma); }
+
+    // The coarsest level is blurred through a transposed copy at the front.
+    size_t coarsest = (size_t)width * height;
+    uint32_t extent = width > height ? width : height;
+    if (!SSKBlurReserve((void **)&context->scratch, &context->scratchCapacity, coarsest + total, sizeof(SSKFloat4)) ||
+        !SSKBlurReserveRows(context, pool, extent)) {
+        return false;
+    }
+    SSKFloat4 *next = context->scratch + coarsest;
+    for (uint32_t l = 0; l < count; l++) {
+        pyramid[l].pixels = next;
+        next += (size_t)pyramid[l].width * pyramid[l].height;
+    }
+
+    const SSKFloatImage *level = source;
+    for (uint32_t l = 0; l < count; l++) {
+        SSKBlurResampleJob job = {level, &pyramid[l]};
+        SSKBlurForBands(pool, pyramid[l].height, SSKBlurPixelBandRows, SSKBlurDownsampleBand, &job);
+        level = &pyramid[l];
+    }
+
+    // Each box stage and the final bilinear tent already blur a little; take
+    // their variance (in full-resolution pixels) out of the Gaussian.
+    double scale = ldexp(1.0, (int)count);
+    double variance = (double)sigma * sigma - (scale * scale - 1.0) / 12.0 - scale * scale / 6.0;
+    float levelSigma = (float)(sqrt(variance > 0.0 ? variance : 0.0) / scale);
+    if (levelSigma > 0.01f) {
+        SSKBlurWeights weights = SSKBlurWeightsForSigma(levelSigma);
+        SSKBlurSeparable(context, pool, level, level, context->scratch, &weights);
+    }
+
+    SSKBlurResampleJob job = {level, destination};
+    SSKBlurForBands(pool, destination->height, SSKBlurPixelBandRows, SSKBlurUpsampleBand, &job);
+    return true;
+}
+
+typedef struct {
+    const SSKFloatImage *source;
+    const SSKFloatImage *destination;
+    float value;
+} SSKBloomJob;
+
+/// Bright pass of one colour, shared by the Gaussian and mip chain modes.
+static inline SSKFloat4 SSKBloomPrefilter(SSKFloat4 color, float threshold) {
+    float lum = color.x * 0.2126f + color.y * 0.7152f + color.z * 0.0722f;
+    float bloomFactor = lum - threshold > 0.0f ? lum - threshold : 0.0f;
+    float scale = bloomFactor > 0.0f ? bloomFactor / (lum > 0.0001f ? lum : 0.0001f) : 0.0f;
+    return (SSKFloat4){color.x * scale, color.y * scale, color.z * scale, bloomFactor};
+}
+
+static void SSKBloomThresholdBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBloomJob *job = context;
+    float threshold = job->value;
+    for (uint32_t y = y0; y < y1; y++) {
+        const SSKFloat4 *src = job->source->pixels + (size_t)y * job->source->stride;
+        SSKFloat4 *dst = job->destination->pixels + (size_t)y * job->destination->stride;
+        for (uint32_t x = 0; x < job->source->width; x++) {
+            dst[x] = SSKBloomPrefilter(src[x], threshold);
+        }
+    }
+}
+
+static void SSKBloomCompositeBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBloomJob *job = context;
+    float intensity = job->value;
+    for (uint32_t y = y0; y < y1; y++) {
+        const SSKFloat4 *bloom = job->source->pixels + (size_t)y * job->source->stride;
+        SSKFloat4 *dst = job->destination->pixels + (size_t)y * job->destination->stride;
+        for (uint32_t x = 0; x < job->source->width; x++) {
+            float glow = bloom[x].w * intensity;
+            if (glow > 0.0001f) {
+                float r = dst[x].x + bloom[x].x * glow;
+                float g = dst[x].y + bloom[x].y * glow;
+                float b = dst[x].z + bloom[x].z * glow;
+                dst[x].x = r > 0.0f ? (r < 1.0f ? r : 1.0f) : 0.0f;
+                dst[x].y = g > 0.0f ? (g < 1.0f ? g : 1.0f) : 0.0f;
+                dst[x].z = b > 0.0f ? (b < 1.0f ? b : 1.0f) : 0.0f;
+            }
+        }
+    }
+}
+
+/// One RGBA pixel in a vector register; the Kawase taps below do their
+/// arithmetic on whole pixels.
+typedef float SSKBloomPixel __attribute__((vector_size(4 * sizeof(float))));
+
+static inline SSKBloomPixel SSKBloomLoad(const SSKFloat4 *pixel) {
+    SSKBloomPixel value;
+    memcpy(&value, pixel, sizeof(value));
+    return value;
+}
+
+static inline SSKFloat4 SSKBloomStore(SSKBloomPixel value) {
+    SSKFloat4 pixel;
+    memcpy(&pixel, &value, sizeof(pixel));
+    return pixel;
+}
+
+/// One axis of a `filter::linear` + `address::clamp_to_edge` sample: the two
+/// clamped texel indices and the weight of the second.
+typedef struct {
+    int32_t i0;
+    int32_t i1;
+    float t;
+} SSKBloomTap;
+
+/// `coord` is in pixel units (pixel centres at `i + 0.5`). Taps reach at most
+/// 1.5 pixels past the edge, so truncating after the shift by 2 floors
+/// without a libm call.
+static inline SSKBloomTap SSKBloomTapAt(float coord, int32_t extent) {
+    coord += 1.5f;
+    int32_t i0 = (int32_t)coord - 2;
+    SSKBloomTap tap = {i0, i0 + 1, coord - (float)(i0 + 2)};
+    tap.i0 = tap.i0 < 0 ? 0 : (tap.i0 >= extent ? extent - 1 : tap.i0);
+    tap.i1 = tap.i1 < 0 ? 0 : (tap.i1 >= extent ? extent - 1 : tap.i1);
+    return tap;
+}
+
+/// Sample offsets (in source pixels) along each axis shared by both Kawase
+/// kernels; taps name them by index.
+static const float SSKBloomOffsets[5] = {-1.0f, -0.5f, 0.0f, 0.5f, 1.0f};
+enum { SSKBloomOffsetCount = 5, SSKBloomColumnChunk = 64 };
+
+/// Bilinear sample from a pair of rows and a column tap.
+static inline SSKBloomPixel SSKBloomSample(const SSKFloat4 *top, const SSKFloat4 *bottom, float ty,
+                                          SSKBloomTap column) {
+    SSKBloomPixel upper =
+        SSKBloomLoad(&top[column.i0]) * (1.0f - column.t) + SSKBloomLoad(&top[column.i1]) * column.t;
+    SSKBloomPixel lower =
+        SSKBloomLoad(&bottom[column.i0]) * (1.0f - column.t) + SSKBloomLoad(&bottom[column.i1]) * column.t;
+    return upper * (1.0f - ty) + lower * ty;
+}
+
+static inline SSKBloomPixel SSKBloomPrefilterPixel(SSKBloomPixel color, float threshold) {
+    SSKFloat4 prefiltered = SSKBloomPrefilter(SSKBloomStore(color), threshold);
+    return SSKBloomLoad(&prefiltered);
+}
+
+typedef enum {
+    SSKBloomKawaseDown = 0,
+    SSKBloomKawaseUp,
+    SSKBloomKawaseAdd,
+} SSKBloomKawaseKind;
+
+/// Shared body of the three Kawase kernels. Destination pixel centres map to
+/// `(x + 0.5) / dstSize * srcSize` in the source, like the normalised
+/// `(gid + 0.5) / size` the Metal kernels sample at. Column taps are set up
+/// once per chunk of columns and reused for every row of the band.
+static void SSKBloomKawaseBand(const SSKBloomJob *job, SSKBloomKawaseKind kind, uint32_t y0, uint32_t y1) {
+    // Per tap: column offset index, row offset index, weight.
+    static const int downTaps[5][3] = {{2, 2, 4}, {0, 0, 1}, {4, 0, 1}, {0, 4, 1}, {4, 4, 1}};
+    static const int upTaps[8][3] = {{0, 2, 1}, {4, 2, 1}, {2, 0, 1}, {2, 4, 1},
+                                     {1, 1, 2}, {3, 1, 2}, {1, 3, 2}, {3, 3, 2}};
+    const SSKFloatImage *source = job->source;
+    const SSKFloatImage *destination = job->destination;
+    const int (*taps)[3] = kind == SSKBloomKawaseDown ? downTaps : upTaps;
+    int tapCount = kind == SSKBloomKawaseDown ? 5 : 8;
+    float scale = kind == SSKBloomKawaseDown ? 0.125f : 1.0f / 12.0f;
+    bool prefilter = kind == SSKBloomKawaseDown && job->value >= 0.0f;
+    SSKBloomTap columns[SSKBloomColumnChunk][SSKBloomOffsetCount];
+
+    for (uint32_t x0 = 0; x0 < destination->width; x0 += SSKBloomColumnChunk) {
+        uint32_t x1 = x0 + SSKBloomColumnChunk < destination->width ? x0 + SSKBloomColumnChunk : destination->width;
+        for (uint32_t x = x0; x < x1; x++) {
+            float px = ((float)x + 0.5f) / (float)destination->width * (float)source->width;
+            for (int o = 0; o < SSKBloomOffsetCount; o++) {
+                columns[x - x0][o] = SSKBloomTapAt(px + SSKBloomOffsets[o], (int32_t)source->width);
+            }
+        }
+        for (uint32_t y = y0; y < y1; y++) {
+            float py = ((float)y + 0.5f) / (float)destination->height * (float)source->height;
+            SSKBloomTap rows[SSKBloomOffsetCount];
+            for (int o = 0; o < SSKBloomOffsetCount; o++) {
+                rows[o] = SSKBloomTapAt(py + SSKBloomOffsets[o], (int32_t)source->height);
+            }
+            SSKFloat4 *dst = destination->pixels + (size_t)y * destination->stride;
+            for (uint32_t x = x0; x < x1; x++) {
+                const SSKBloomTap *column = columns[x - x0];
+                SSKBloomPixel sum = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (int t = 0; t < tapCount; t++) {
+                    SSKBloomTap row = rows[taps[t][1]];
+                    SSKBloomPixel tap = SSKBloomSample(source->pixels + (size_t)row.i0 * source->stride,
+                                                       source->pixels + (size_t)row.i1 * source->stride, row.t,
+                                                       column[taps[t][0]]);
+                    if (prefilter) { tap = SSKBloomPrefilterPixel(tap, job->value); }
+                    sum += tap * (float)taps[t][2];
+                }
+                SSKFloat4 value = SSKBloomStore(sum * scale);
+                if (kind != SSKBloomKawaseAdd) {
+                    dst[x] = value;
+                    continue;
+                }
+                float glow = value.w * job->value;
+                if (glow > 0.0001f) {
+                    float r = dst[x].x + value.x * glow;
+                    float g = dst[x].y + value.y * glow;
+                    float b = dst[x].z + value.z * glow;
+                    dst[x].x = r > 0.0f ? (r < 1.0f ? r : 1.0f) : 0.0f;
+                    dst[x].y = g > 0.0f ? (g < 1.0f ? g : 1.0f) : 0.0f;
+                    dst[x].z = b > 0.0f ? (b < 1.0f ? b : 1.0f) : 0.0f;
+                }
+            }
+        }
+    }
+}
+
+static void SSKBloomKawaseDownsampleBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBloomKawaseBand(context, SSKBloomKawaseDown, y0, y1);
+}
+
+static void SSKBloomKawaseUpsampleBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBloomKawaseBand(context, SSKBloomKawaseUp, y0, y1);
+}
+
+static void SSKBloomKawaseCompositeBand(void *context, uint32_t y0, uint32_t y1, uint32_t worker) {
+    (void)worker;
+    SSKBloomKawaseBand(context, SSKBloomKawaseAdd, y0, y1);
+}
+
+static bool SSKBloomImageValid(const SSKFloatImage *image) {
+    return image && image->pixels && image->width > 0 && image->height > 0 && image->stride >= image->width;
+}
+
+void SSKBloomKawaseDownsample(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination,
+                              float threshold) {
+    if (!SSKBloomImageValid(source) || !SSKBloomImageValid(destination)) { return; }
+    SSKBloomJob job = {source, destination, threshold};
+    SSKBlurForBands(pool, destination->height, SSKBlurPixelBandRows, SSKBloomKawaseDownsampleBand, &job);
+}
+
+void SSKBloomKawaseUpsample(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination) {
+    if (!SSKBloomImageValid(source) || !SSKBloomImageValid(destination)) { return; }
+    SSKBloomJob job = {source, destination, 0.0f};
+    SSKBlurForBands(pool, destination->height, SSKBlurPixelBandRows, SSKBloomKawaseUpsampleBand, &job);
+}
+
+void SSKBloomKawaseComposite(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination,
+                             float intensity) {
+    if (!SSKBloomImageValid(source) || !SSKBloomImageValid(destination)) { return; }
+    SSKBloomJob job = {source, destination, intensity};
+    SSKBlurForBands(pool, destination->height, SSKBlurPixelBandRows, SSKBloomKawaseCompositeBand, &job);
+}
+
+uint32_t SSKBloomMipChainLevels(uint32_t width, uint32_t height, uint32_t levels) {
+    levels = levels < 1 ? 1 : (levels > 8 ? 8 : levels);
+    uint32_t count = 0;
+    while (count < levels && SSKBloomMipExtent(width, count + 1) >= 2 && SSKBloomMipExtent(height, count + 1) >= 2) {
+        count++;
+    }
+    return count;
+}
+
+/// Bright pass into level 1, downsample to the last level, upsample back up
+/// in place (each level is only read once on the way down) and composite.
+static bool SSKBloomApplyMipChain(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *image,
+                                  float threshold, float intensity, uint32_t requestedLevels) {
+    uint32_t levels = SSKBloomMipChainLevels(image->width, image->height, requestedLevels);
+    if (levels == 0) { return true; }
+    SSKFloatImage chain[8];
+    size_t total = 0;
+    for (uint32_t l = 0; l < levels; l++) {
+        uint32_t width = SSKBloomMipExtent(image->width, l + 1);
+        uint32_t height = SSKBloomMipExtent(image->height, l + 1);
+        chain[l] = (SSKFloatImage){NULL, width, height, width};
+        total += (size_t)width * height;
+    }
+    if (!SSKBlurReserve((void **)&context->bright, &context->brightCapacity, total, sizeof(SSKFloat4))) {
+        return false;
+    }
+    SSKFloat4 *next = context->bright;
+    for (uint32_t l = 0; l < levels; l++) {
+        chain[l].pixels = next;
+        next += (size_t)chain[l].width * chain[l].height;
+    }
+
+    SSKBloomKawaseDownsample(pool, image, &chain[0], threshold);
+    for (uint32_t l = 1; l < levels; l++) {
+        SSKBloomKawaseDownsample(pool, &chain[l - 1], &chain[l], -1.0f);
+    }
+    for (uint32_t l = levels - 1; l > 0; l--) {
+        SSKBloomKawaseUpsample(pool, &chain[l], &chain[l - 1]);
+    }
+    SSKBloomKawaseComposite(pool, &chain[0], image, intensity);
+    return true;
+}
+
+void SSKBloomThreshold(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *bright, float threshold) {
+    if (!SSKBlurImagesMatch(source, bright)) { return; }
+    SSKBloomJob job = {source, bright, threshold};
+    SSKBlurForBands(pool, source->height, SSKBlurPixelBandRows, SSKBloomThresholdBand, &job);
+}
+
+void SSKBloomComposite(SSKTaskPool *pool, const SSKFloatImage *bloom, const SSKFloatImage *destination,
+                       float intensity) {
+    if (!SSKBlurImagesMatch(bloom, destination)) { return; }
+    SSKBloomJob job = {bloom, destination, intensity};
+    SSKBlurForBands(pool, bloom->height, SSKBlurPixelBandRows, SSKBloomCompositeBand, &job);
+}
+
+bool SSKBloomApply(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *image,
+                   const SSKBloomParams *params) {
+    if (!context || !params || !SSKBlurImagesMatch(image, image)) { return false; }
+    float threshold = params->threshold > 0.0f ? (params->threshold < 1.0f ? params->threshold : 1.0f) : 0.0f;
+    float intensity = params->intensity > 0.0f ? params->intensity : 0.0f;
+    if (params->mode == SSKBloomModeMipChain) {
+        return SSKBloomApplyMipChain(context, pool, image, threshold, intensity, params->levels);
+    }
+
+    size_t pixels = (size_t)image->width * image->height;
+    if (!SSKBlurReserve((void **)&context->bright, &context->brightCapacity, pixels, sizeof(SSKFloat4))) {
+        return false;
+    }
+    float sigma = params->sigma > 0.01f ? params->sigma : 3.0f;
+    SSKFloatImage bright = {context->bright, image->width, image->height, image->width};
+
+    SSKBloomThreshold(pool, image, &bright, threshold);
+    if (!SSKBlurGaussianDownsampled(context, pool, &bright, &bright, sigma, params->levels)) { return false; }
+    SSKBloomComposite(pool, &bright, image, intensity);
+    return true;
+}
+
+void SSKFloatImageLoadRGBA8(const SSKFloatImage *image, const uint8_t *pixels, size_t rowBytes) {
+    if (!image || !image->pixels || !pixels) { return; }
+    const float scale = 1.0f / 255.0f;
+    for (uint32_t y = 0; y < image->height; y++) {
+        const uint8_t *src = pixels + (size_t)y * rowBytes;
+        SSKFloat4 *dst = image->pixels + (size_t)y * image->stride;
+        for (uint32_t x = 0; x < image->width; x++, src += 4) {
+            dst[x] = (SSKFloat4){src[0] * scale, src[1] * scale, src[2] * scale, src[3] * scale};
+        }
+    }
+}
+
+static inline uint8_t SSKBlurToUnorm8(float value) {
+    value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    return (uint8_t)(int32_t)(value * 255.0f + 0.5f);
+}
+
+void SSKFloatImageStoreRGBA8(const SSKFloatImage *image, uint8_t *pixels, size_t rowBytes) {
+    if (!image || !image->pixels || !pixels) { return; }
+    for (uint32_t y = 0; y < image->height; y++) {
+        const SSKFloat4 *src = image->pixels + (size_t)y * image->stride;
+        uint8_t *dst = pixels + (size_t)y * rowBytes;
+        for (uint32_t x = 0; x < image->width; x++, dst += 4) {
+            dst[0] = SSKBlurToUnorm8(src[x].x);
+            dst[1] = SSKBlurToUnorm8(src[x].y);
+            dst[2] = SSKBlurToUnorm8(src[x].z);
+            dst[3] = SSKBlurToUnorm8(src[x].w);
+        }
+    }
+}
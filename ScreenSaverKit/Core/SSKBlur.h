@@ -0,0 +1,160 @@
+#ifndef SSKBlur_h
+#define SSKBlur_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKSIMD.h"
+#include "SSKTaskPool.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Caller-owned float RGBA image, one `SSKFloat4` per pixel. Row 0 is the top
+/// row; `stride` is the distance between rows in pixels (at least `width`).
+typedef struct {
+    SSKFloat4 *pixels;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+} SSKFloatImage;
+
+/// Largest tap radius, matching `SSK_MAX_BLUR_RADIUS` in the Metal kernels.
+enum { SSKBlurMaxRadius = 32 };
+
+/// Normalised one-sided Gaussian taps: `weights[0]` is the centre and
+/// `weights[i]` applies to both neighbours at distance `i`.
+typedef struct {
+    uint32_t radius;
+    float weights[SSKBlurMaxRadius + 1];
+} SSKBlurWeights;
+
+/// Fills `weights` for `sigma` over `[-radius, radius]`, exactly as
+/// `SSKMetalBlurPass` uploads them. Returns false if `radius` is 0 or above
+/// `SSKBlurMaxRadius`.
+bool SSKBlurWeightsInit(SSKBlurWeights *weights, float sigma, uint32_t radius);
+
+/// The taps `SSKMetalBlurPass` uses for a blur radius (sigma): sigma is
+/// clamped to at least 0.5 and the radius is `ceil(3 * sigma)`, capped at
+/// `SSKBlurMaxRadius`.
+SSKBlurWeights SSKBlurWeightsForSigma(float sigma);
+
+/// Scratch storage for the CPU blur and bloom. Buffers grow on demand and are
+/// reused, so keep one context per renderer rather than per frame.
+typedef struct {
+    /// Row kernel used by the passes; defaults to `SSKSIMDBestLevel()`.
+    SSKSIMDLevel simdLevel;
+
+    /// Transposed intermediate image and downsampled levels.
+    SSKFloat4 *scratch;
+    size_t scratchCapacity;
+
+    /// Thresholded image or mip chain of `SSKBloomApply`.
+    SSKFloat4 *bright;
+    size_t brightCapacity;
+
+    /// Per-worker padded source row and band of blurred rows.
+    float *rows;
+    size_t rowCapacity;
+} SSKBlurContext;
+
+void SSKBlurContextInit(SSKBlurContext *context);
+
+void SSKBlurContextDestroy(SSKBlurContext *context);
+
+/// Separable Gaussian blur of `source` into `destination` (same size; they
+/// may be the same image), matching `gaussianBlurHorizontal` followed by
+/// `gaussianBlurVertical`: clamp-to-edge sampling with the taps of
+/// `SSKBlurWeightsForSigma`. Sigma <= 0.01 copies the source.
+///
+/// Each pass blurs bands of rows with a vector row kernel and writes them
+/// transposed, so the vertical pass is a second horizontal pass over
+/// contiguous memory. Bands run on `pool` when one is given (NULL runs on the
+/// calling thread). Returns false if scratch storage could not be allocated.
+bool SSKBlurGaussian(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                     const SSKFloatImage *destination, float sigma);
+
+/// Number of 2x downsampling levels that bring `sigma` to at most 4 pixels at
+/// the coarsest level. 0 for small blurs.
+uint32_t SSKBlurLevelsForSigma(float sigma);
+
+/// Approximate blur for large sigmas: box-downsamples `levels` times, blurs
+/// the coarsest level with `sigma / 2^levels` and upsamples bilinearly into
+/// `destination`. Costs a fraction of the full-resolution blur and is not
+/// limited to `SSKBlurMaxRadius`. `levels` of 0 is `SSKBlurGaussian`.
+bool SSKBlurGaussianDownsampled(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *source,
+                                const SSKFloatImage *destination, float sigma, uint32_t levels);
+
+/// Writes the part of `source` brighter than `threshold` (Rec. 709 luminance)
+/// to `bright`, like `bloomThresholdKernel`: colour scaled by the excess over
+/// the luminance, excess in alpha.
+void SSKBloomThreshold(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *bright, float threshold);
+
+/// Adds `bloom.rgb * bloom.a * intensity` to `destination` clamped to [0, 1],
+/// like `bloomCompositeKernel`. Alpha is left alone.
+void SSKBloomComposite(SSKTaskPool *pool, const SSKFloatImage *bloom, const SSKFloatImage *destination,
+                       float intensity);
+
+/// Dual Kawase downsample into `destination` (about half the size of
+/// `source`): the bilinear sample at the centre weighted 4 plus the four
+/// diagonal samples one source pixel away, over 8. A `threshold` >= 0 runs
+/// every sample through the bright pass first, so the chain starts from the
+/// source image directly. Matches `bloomKawaseDownsample`.
+void SSKBloomKawaseDownsample(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination,
+                              float threshold);
+
+/// Dual Kawase upsample into `destination` (about twice the size of
+/// `source`): four samples one source pixel away along the axes and four
+/// diagonal samples half a pixel away weighted 2, over 12. Matches
+/// `bloomKawaseUpsample`.
+void SSKBloomKawaseUpsample(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination);
+
+/// Final upsample of the chain added to `destination` like
+/// `SSKBloomComposite`. Matches `bloomKawaseComposite`.
+void SSKBloomKawaseComposite(SSKTaskPool *pool, const SSKFloatImage *source, const SSKFloatImage *destination,
+                             float intensity);
+
+/// Width or height of mip level `level` (1 is half resolution) for an image
+/// `extent` pixels across.
+static inline uint32_t SSKBloomMipExtent(uint32_t extent, uint32_t level) {
+    for (uint32_t l = 0; l < level; l++) { extent = (extent + 1) / 2; }
+    return extent;
+}
+
+/// Clamps a requested level count to [1, 8] and stops before a level would
+/// shrink below 2 pixels in either dimension.
+uint32_t SSKBloomMipChainLevels(uint32_t width, uint32_t height, uint32_t levels);
+
+typedef enum {
+    /// Full-resolution bright pass and separable Gaussian.
+    SSKBloomModeGaussian = 0,
+    /// Dual Kawase downsample/upsample chain; cost barely depends on the
+    /// glow radius, which doubles with every level.
+    SSKBloomModeMipChain,
+} SSKBloomMode;
+
+typedef struct {
+    float threshold;    ///< Clamped to [0, 1].
+    float intensity;    ///< Clamped to >= 0.
+    float sigma;        ///< Gaussian mode; <= 0.01 means 3, the `SSKMetalBloomPass` default.
+    /// Gaussian mode: downsampling levels for the blur, 0 blurs at full
+    /// resolution. Mip chain mode: chain length (see `SSKBloomMipChainLevels`).
+    uint32_t levels;
+    SSKBloomMode mode;
+} SSKBloomParams;
+
+/// Threshold, blur and composite in place, as `SSKMetalBloomPass` does in
+/// the same mode.
+bool SSKBloomApply(SSKBlurContext *context, SSKTaskPool *pool, const SSKFloatImage *image,
+                   const SSKBloomParams *params);
+
+/// Converts between `SSKFloatImage` and 8-bit RGBA (`uint8_t[4]` per pixel),
+/// for callers that blur bitmap contexts or image data.
+void SSKFloatImageLoadRGBA8(const SSKFloatImage *image, const uint8_t *pixels, size_t rowBytes);
+
+void SSKFloatImageStoreRGBA8(const SSKFloatImage *image, uint8_t *pixels, size_t rowBytes);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKBlur_h */
@@ -0,0 +1,47 @@
+#include "SSKChangeMonitor.h"
+
+#include <math.h>
+
+SSKChangeMonitorParams SSKChangeMonitorParamsDefault(void) {
+    SSKChangeMonitorParams params = {2.0, 60.0, 2.0};
+    return params;
+}
+
+void SSKChangeMonitorInit(SSKChangeMonitor *monitor, const SSKChangeMonitorParams *params, double now) {
+    SSKChangeMonitorParams fixed = params ? *params : SSKChangeMonitorParamsDefault();
+    if (!(fixed.minInterval > 0.0) || !isfinite(fixed.minInterval)) { fixed.minInterval = 2.0; }
+    if (!(fixed.maxInterval >= fixed.minInterval) || !isfinite(fixed.maxInterval)) {
+        fixed.maxInterval = fixed.minInterval;
+    }
+    if (!(fixed.growth >= 1.0) || !isfinite(fixed.growth)) { fixed.growth = 1.0; }
+
+    monitor->params = fixed;
+    monitor->generation = 0;
+    monitor->checkedGeneration = 0;
+    monitor->interval = fixed.minInterval;
+    monitor->nextPoll = now + fixed.minInterval;
+    monitor->checks = 0;
+    monitor->changes = 0;
+}
+
+void SSKChangeMonitorDidCheck(SSKChangeMonitor *monitor, double now, bool changed) {
+    const SSKChangeMonitorParams *params = &monitor->params;
+    monitor->checkedGeneration = monitor->generation;
+    monitor->checks++;
+    if (changed) {
+        monitor->changes++;
+        monitor->interval = params->minInterval;
+    } else if (now >= monitor->nextPoll) {
+        // Only an idle poll backs off; a notification that turned out to
+        // change nothing leaves the schedule alone.
+        monitor->interval = fmin(monitor->interval * params->growth, params->maxInterval);
+    } else {
+        return;
+    }
+    monitor->nextPoll = now + monitor->interval;
+}
+
+double SSKChangeMonitorDelay(const SSKChangeMonitor *monitor, double now) {
+    if (SSKChangeMonitorIsCheckDue(monitor, now)) { return 0.0; }
+    return monitor->nextPoll - now;
+}
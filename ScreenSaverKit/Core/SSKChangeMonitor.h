@@ -0,0 +1,63 @@
+#ifndef SSKChangeMonitor_h
+#define SSKChangeMonitor_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Decides when a saver re-reads a store it cannot fully observe, such as its
+/// preferences domain.
+///
+/// Change notifications bump `generation`; a check is due as soon as one has
+/// arrived since the last check, so a burst of notifications costs one read.
+/// Writers that do not notify are caught by a fallback poll whose interval
+/// backs off: each poll that finds nothing multiplies it by `growth` up to
+/// `maxInterval`, and a check that finds a change snaps it back to
+/// `minInterval`, since more edits tend to follow the first.
+typedef struct {
+    double minInterval;   ///< Seconds between polls right after a change.
+    double maxInterval;   ///< Ceiling of the back-off.
+    double growth;        ///< Interval multiplier per idle poll, >= 1.
+} SSKChangeMonitorParams;
+
+typedef struct {
+    SSKChangeMonitorParams params;
+    uint64_t generation;         ///< Notifications received.
+    uint64_t checkedGeneration;  ///< `generation` at the last check.
+    double interval;             ///< Current poll interval in seconds.
+    double nextPoll;             ///< Time of the next poll, on the caller's clock.
+    uint64_t checks;             ///< Checks run so far.
+    uint64_t changes;            ///< Checks that found a change.
+} SSKChangeMonitor;
+
+/// 2 s after a change, backing off by 2x to 60 s.
+SSKChangeMonitorParams SSKChangeMonitorParamsDefault(void);
+
+/// Starts polling at `minInterval` from `now`. Out-of-range parameters are
+/// fixed up: intervals must be positive and ordered, growth at least 1.
+void SSKChangeMonitorInit(SSKChangeMonitor *monitor, const SSKChangeMonitorParams *params, double now);
+
+/// Records a change notification.
+static inline void SSKChangeMonitorNotify(SSKChangeMonitor *monitor) {
+    monitor->generation++;
+}
+
+/// Whether the store should be read now: a notification is pending or the
+/// poll is due.
+static inline bool SSKChangeMonitorIsCheckDue(const SSKChangeMonitor *monitor, double now) {
+    return monitor->generation != monitor->checkedGeneration || now >= monitor->nextPoll;
+}
+
+/// Records a check made at `now` and whether it found a change, and
+/// schedules the next poll.
+void SSKChangeMonitorDidCheck(SSKChangeMonitor *monitor, double now, bool changed);
+
+/// Seconds from `now` until the next poll; 0 when a check is already due.
+double SSKChangeMonitorDelay(const SSKChangeMonitor *monitor, double now);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKChangeMonitor_h */
@@ -0,0 +1,30 @@
+# Sources of the portable core, relative to this directory. Core/Makefile,
+# Makefile.demo and every demo Makefile include this list, so a new Core/*.c
+# file only needs adding here.
+SSK_CORE_SOURCES := \
+	SSKBlur.c \
+	SSKChangeMonitor.c \
+	SSKFixedStep.c \
+	SSKForceField.c \
+	SSKFrameGraph.c \
+	SSKFrameRing.c \
+	SSKKeyDiff.c \
+	SSKPalette.c \
+	SSKParticleCore.c \
+	SSKParticleEmitter.c \
+	SSKParticleInstances.c \
+	SSKParticleKernelVariant.c \
+	SSKParticleLifecycle.c \
+	SSKParticleParallel.c \
+	SSKParticleRaster.c \
+	SSKParticleSIMD.c \
+	SSKPreferenceSnapshot.c \
+	SSKProfiler.c \
+	SSKReplay.c \
+	SSKSIMD.c \
+	SSKSlotAllocator.c \
+	SSKSpatialGrid.c \
+	SSKStarfield.c \
+	SSKTaskPool.c \
+	SSKTexturePool.c \
+	SSKTrail.c
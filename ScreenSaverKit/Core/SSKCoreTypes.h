@@ -0,0 +1,46 @@
+#ifndef SSKCoreTypes_h
+#define SSKCoreTypes_h
+
+/*
+ Shared value types for the portable ScreenSaverKit core. Everything under
+ `ScreenSaverKit/Core` is plain C11 with no AppKit, Metal or simd dependency so
+ it can be built and benchmarked headlessly (see `Core/Makefile`). The layouts
+ below intentionally match `vector_float2` / `vector_float4` so the Objective-C
+ and Metal layers can share buffers with the core without conversion.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+#define SSK_CORE_EXTERN_C_BEGIN extern "C" {
+#define SSK_CORE_EXTERN_C_END }
+#else
+#define SSK_CORE_EXTERN_C_BEGIN
+#define SSK_CORE_EXTERN_C_END
+#endif
+
+/// Two-component float vector laid out like `vector_float2` (8 bytes).
+typedef struct __attribute__((aligned(8))) {
+    float x;
+    float y;
+} SSKFloat2;
+
+/// Four-component float vector laid out like `vector_float4` (16 bytes).
+typedef struct __attribute__((aligned(16))) {
+    float x;
+    float y;
+    float z;
+    float w;
+} SSKFloat4;
+
+static inline SSKFloat2 SSKFloat2Make(float x, float y) {
+    SSKFloat2 value = {x, y};
+    return value;
+}
+
+static inline SSKFloat4 SSKFloat4Make(float x, float y, float z, float w) {
+    SSKFloat4 value = {x, y, z, w};
+    return value;
+}
+
+#endif /* SSKCoreTypes_h */
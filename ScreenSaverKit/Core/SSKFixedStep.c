@@ -0,0 +1,37 @@
+#include "SSKFixedStep.h"
+
+#include <math.h>
+
+void SSKFixedStepInit(SSKFixedStep *clock, double tickRate, uint32_t maxSteps) {
+    if (!(tickRate > 0.0) || !isfinite(tickRate)) { tickRate = 60.0; }
+    clock->step = 1.0 / tickRate;
+    clock->maxSteps = maxSteps > 0 ? maxSteps : 1;
+    SSKFixedStepReset(clock);
+}
+
+void SSKFixedStepReset(SSKFixedStep *clock) {
+    clock->accumulator = 0.0;
+    clock->tick = 0;
+    clock->droppedTicks = 0;
+}
+
+uint32_t SSKFixedStepAccumulate(SSKFixedStep *clock, double elapsed) {
+    if (!(elapsed > 0.0) || !isfinite(elapsed)) { elapsed = 0.0; }
+    clock->accumulator += elapsed;
+    uint32_t steps = 0;
+    while (clock->accumulator >= clock->step && steps < clock->maxSteps) {
+        clock->accumulator -= clock->step;
+        steps++;
+    }
+    if (clock->accumulator >= clock->step) {
+        double dropped = floor(clock->accumulator / clock->step);
+        clock->droppedTicks += (uint64_t)dropped;
+        clock->accumulator -= dropped * clock->step;
+        // Rounding can leave the remainder a hair outside `[0, step)`; keep
+        // alpha in range so renderers never blend past either state.
+        if (clock->accumulator >= clock->step) { clock->accumulator = nextafter(clock->step, 0.0); }
+        if (clock->accumulator < 0.0) { clock->accumulator = 0.0; }
+    }
+    clock->tick += steps;
+    return steps;
+}
@@ -0,0 +1,49 @@
+#ifndef SSKFixedStep_h
+#define SSKFixedStep_h
+
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Fixed-timestep accumulator.
+///
+/// Frames feed the wall-clock time that elapsed; the accumulator answers how
+/// many whole ticks of `step` seconds are due. Running the simulation once per
+/// tick makes its cost per second and its result independent of the display
+/// rate: the same sequence of ticks gives the same state however the frames
+/// were paced. The fraction of a tick left over is the interpolation alpha a
+/// renderer can use to blend (or extrapolate) between the last two states.
+///
+/// A frame never runs more than `maxSteps` ticks. Time beyond that is dropped
+/// rather than carried over, so a long hitch costs one bounded catch-up frame
+/// instead of a growing backlog.
+typedef struct {
+    double step;            ///< Seconds per tick.
+    uint32_t maxSteps;      ///< Catch-up limit per frame.
+    double accumulator;     ///< Unsimulated time, in `[0, step)` between frames.
+    uint64_t tick;          ///< Ticks consumed so far.
+    uint64_t droppedTicks;  ///< Whole ticks discarded by the catch-up limit.
+} SSKFixedStep;
+
+/// `tickRate` is in ticks per second (non-positive means 60); `maxSteps` of 0
+/// means 1.
+void SSKFixedStepInit(SSKFixedStep *clock, double tickRate, uint32_t maxSteps);
+
+/// Clears the accumulator and counters, keeping the rate and limit.
+void SSKFixedStepReset(SSKFixedStep *clock);
+
+/// Adds `elapsed` seconds (negative or non-finite values count as 0) and
+/// returns the number of ticks to run now, at most `maxSteps`. Those ticks are
+/// consumed: `tick` advances by the returned count.
+uint32_t SSKFixedStepAccumulate(SSKFixedStep *clock, double elapsed);
+
+/// Fraction of a tick accumulated but not yet simulated, in `[0, 1)`.
+static inline double SSKFixedStepAlpha(const SSKFixedStep *clock) {
+    return clock->step > 0.0 ? clock->accumulator / clock->step : 0.0;
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKFixedStep_h */
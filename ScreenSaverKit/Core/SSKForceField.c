@@ -0,0 +1,162 @@
+#include "SSKForceField.h"
+
+#include <math.h>
+
+// The noise hash, fade curve and field maths below are mirrored line for line
+// in the particle simulation kernels of SSKParticleShaders.metal; keep them in sync.
+
+static inline uint32_t SSKForceFieldHash(int32_t x, int32_t y) {
+    uint32_t h = (uint32_t)x * 0x8da6b343u ^ (uint32_t)y * 0xd8163841u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return h;
+}
+
+/// Lattice value in [-1, 1].
+static inline float SSKForceFieldLattice(int32_t x, int32_t y) {
+    return (float)(SSKForceFieldHash(x, y) >> 8) * (2.0f / 16777215.0f) - 1.0f;
+}
+
+/// Gradient of quintic-interpolated value noise at (x, y), computed
+/// analytically so a curl costs one lattice lookup instead of four.
+static inline SSKFloat2 SSKForceFieldNoiseGradient(float x, float y) {
+    float fx = floorf(x);
+    float fy = floorf(y);
+    int32_t ix = (int32_t)fx;
+    int32_t iy = (int32_t)fy;
+    float tx = x - fx;
+    float ty = y - fy;
+    float u = tx * tx * tx * (tx * (tx * 6.0f - 15.0f) + 10.0f);
+    float v = ty * ty * ty * (ty * (ty * 6.0f - 15.0f) + 10.0f);
+    float du = 30.0f * tx * tx * (tx * (tx - 2.0f) + 1.0f);
+    float dv = 30.0f * ty * ty * (ty * (ty - 2.0f) + 1.0f);
+    float a = SSKForceFieldLattice(ix, iy);
+    float b = SSKForceFieldLattice(ix + 1, iy);
+    float c = SSKForceFieldLattice(ix, iy + 1);
+    float d = SSKForceFieldLattice(ix + 1, iy + 1);
+    float k = a - b - c + d;
+    return SSKFloat2Make(du * ((b - a) + k * v), dv * ((c - a) + k * u));
+}
+
+SSKFloat2 SSKForceFieldCurlNoiseSample(const SSKForceField *field, SSKFloat2 position, float time) {
+    float x = (position.x - field->center.x * time) * field->frequency;
+    float y = (position.y - field->center.y * time) * field->frequency;
+    SSKFloat2 gradient = SSKForceFieldNoiseGradient(x, y);
+    // The curl of a scalar potential is its gradient turned a quarter; halving
+    // keeps typical magnitudes close to `strength`.
+    float scale = 0.5f * field->strength;
+    return SSKFloat2Make(gradient.y * scale, -gradient.x * scale);
+}
+
+/// Point and vortex fields share the radial falloff; `swirl` picks the
+/// tangential direction instead of the radial one.
+static void SSKForceFieldApplyRadial(SSKParticleCore *core, const SSKForceField *field, float dt,
+                                     int swirl, uint32_t begin, uint32_t end) {
+    const SSKFloat2 *position = core->position;
+    SSKFloat2 *velocity = core->velocity;
+    const uint32_t *alive = core->alive;
+    float cx = field->center.x;
+    float cy = field->center.y;
+    float inverseRadius = field->radius > 0.0f ? 1.0f / field->radius : 0.0f;
+    float gain = field->strength * dt;
+    for (uint32_t i = begin; i < end; i++) {
+        float dx = cx - position[i].x;
+        float dy = cy - position[i].y;
+        float distance = sqrtf(dx * dx + dy * dy);
+        float inverse = distance > 1e-4f ? 1.0f / distance : 0.0f;
+        float falloff = fmaxf(0.0f, 1.0f - distance * inverseRadius);
+        float scale = alive[i] ? gain * falloff * inverse : 0.0f;
+        float ax = swirl ? dy : dx;
+        float ay = swirl ? -dx : dy;
+        velocity[i].x += ax * scale;
+        velocity[i].y += ay * scale;
+    }
+}
+
+static void SSKForceFieldApplyCurlNoise(SSKParticleCore *core, const SSKForceField *field, float time, float dt,
+                                        uint32_t begin, uint32_t end) {
+    const SSKFloat2 *position = core->position;
+    SSKFloat2 *velocity = core->velocity;
+    const uint32_t *alive = core->alive;
+    for (uint32_t i = begin; i < end; i++) {
+        if (!alive[i]) { continue; }
+        SSKFloat2 a = SSKForceFieldCurlNoiseSample(field, position[i], time);
+        velocity[i].x += a.x * dt;
+        velocity[i].y += a.y * dt;
+    }
+}
+
+static void SSKForceFieldApplyDrag(SSKParticleCore *core, const SSKForceField *field, float dt,
+                                   uint32_t begin, uint32_t end) {
+    const SSKFloat2 *position = core->position;
+    SSKFloat2 *velocity = core->velocity;
+    const uint32_t *alive = core->alive;
+    // Same per-second convention as `damping`, so the factor is one pow per step.
+    float factor = powf(fmaxf(0.0f, 1.0f - field->strength), dt);
+    float cx = field->center.x, cy = field->center.y;
+    float ex = field->extent.x, ey = field->extent.y;
+    for (uint32_t i = begin; i < end; i++) {
+        int inside = alive[i] && fabsf(position[i].x - cx) <= ex && fabsf(position[i].y - cy) <= ey;
+        float scale = inside ? factor : 1.0f;
+        velocity[i].x *= scale;
+        velocity[i].y *= scale;
+    }
+}
+
+void SSKParticleCoreApplyForceFields(SSKParticleCore *core, const SSKForceFieldParams *params,
+                                     uint32_t begin, uint32_t end) {
+    if (!core || !params || params->count == 0 || params->dt <= 0.0f) { return; }
+    if (end > core->highWater) { end = core->highWater; }
+    if (begin >= end) { return; }
+    for (uint32_t f = 0; f < params->count; f++) {
+        const SSKForceField *field = &params->fields[f];
+        switch ((SSKForceFieldType)field->type) {
+            case SSKForceFieldTypePoint:
+                SSKForceFieldApplyRadial(core, field, params->dt, 0, begin, end);
+                break;
+            case SSKForceFieldTypeVortex:
+                SSKForceFieldApplyRadial(core, field, params->dt, 1, begin, end);
+                break;
+            case SSKForceFieldTypeCurlNoise:
+                SSKForceFieldApplyCurlNoise(core, field, params->time, params->dt, begin, end);
+                break;
+            case SSKForceFieldTypeDrag:
+                SSKForceFieldApplyDrag(core, field, params->dt, begin, end);
+                break;
+            case SSKForceFieldTypeBounds:
+                break;
+        }
+    }
+}
+
+/// Clamps one axis to `[low, high]`, reflecting the velocity component that
+/// carried the particle out.
+static inline void SSKForceFieldBounceAxis(float *position, float *velocity, float low, float high, float restitution) {
+    if (*position < low) {
+        *position = low;
+        if (*velocity < 0.0f) { *velocity = -*velocity * restitution; }
+    } else if (*position > high) {
+        *position = high;
+        if (*velocity > 0.0f) { *velocity = -*velocity * restitution; }
+    }
+}
+
+void SSKParticleCoreResolveForceFieldBounds(SSKParticleCore *core, const SSKForceFieldParams *params,
+                                            uint32_t begin, uint32_t end) {
+    if (!core || !params || params->count == 0) { return; }
+    if (end > core->highWater) { end = core->highWater; }
+    if (begin >= end) { return; }
+    for (uint32_t f = 0; f < params->count; f++) {
+        const SSKForceField *field = &params->fields[f];
+        if (field->type != SSKForceFieldTypeBounds) { continue; }
+        float restitution = fmaxf(0.0f, field->strength);
+        float minX = field->center.x - field->extent.x, maxX = field->center.x + field->extent.x;
+        float minY = field->center.y - field->extent.y, maxY = field->center.y + field->extent.y;
+        for (uint32_t i = begin; i < end; i++) {
+            if (!core->alive[i]) { continue; }
+            SSKForceFieldBounceAxis(&core->position[i].x, &core->velocity[i].x, minX, maxX, restitution);
+            SSKForceFieldBounceAxis(&core->position[i].y, &core->velocity[i].y, minY, maxY, restitution);
+        }
+    }
+}
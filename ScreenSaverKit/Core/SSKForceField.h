@@ -0,0 +1,109 @@
+#ifndef SSKForceField_h
+#define SSKForceField_h
+
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKParticleCore.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+typedef enum {
+    /// Pulls towards `center` (negative `strength` pushes away). The pull fades
+    /// linearly to zero at `radius`; a radius of 0 means unlimited reach.
+    SSKForceFieldTypePoint = 0,
+    /// Swirls around `center`, counter-clockwise for positive `strength`, with
+    /// the same falloff as `Point`.
+    SSKForceFieldTypeVortex,
+    /// Divergence-free flow taken from the curl of smooth value noise sampled
+    /// at `frequency` cycles per point. `center` is the drift of the noise
+    /// domain in points per second, which animates the flow.
+    SSKForceFieldTypeCurlNoise,
+    /// Extra damping (`strength`, a per-second factor like `damping`) for
+    /// particles inside the rectangle `center` ± `extent`.
+    SSKForceFieldTypeDrag,
+    /// Keeps particles inside the rectangle `center` ± `extent`. Particles that
+    /// leave are put back on the edge and bounce with `strength` as restitution.
+    SSKForceFieldTypeBounds,
+} SSKForceFieldType;
+
+/// One entry of a force-field list. The layout (32 bytes) matches `ForceField`
+/// in `SSKParticleShaders.metal` so a list can be uploaded as-is.
+typedef struct __attribute__((aligned(8))) {
+    uint32_t type;       ///< `SSKForceFieldType`.
+    float strength;      ///< Acceleration in points per second², or see the type.
+    float radius;
+    float frequency;
+    SSKFloat2 center;
+    SSKFloat2 extent;
+} SSKForceField;
+
+/// Per-step inputs shared by every field in a list.
+typedef struct {
+    const SSKForceField *fields;
+    uint32_t count;
+    float time;          ///< Seconds since the system started, for animated fields.
+    float dt;
+} SSKForceFieldParams;
+
+static inline SSKForceField SSKForceFieldMake(SSKForceFieldType type, float strength) {
+    SSKForceField field = {(uint32_t)type, strength, 0.0f, 0.0f, {0.0f, 0.0f}, {0.0f, 0.0f}};
+    return field;
+}
+
+static inline SSKForceField SSKForceFieldPoint(SSKFloat2 center, float strength, float radius) {
+    SSKForceField field = SSKForceFieldMake(SSKForceFieldTypePoint, strength);
+    field.center = center;
+    field.radius = radius;
+    return field;
+}
+
+static inline SSKForceField SSKForceFieldVortex(SSKFloat2 center, float strength, float radius) {
+    SSKForceField field = SSKForceFieldMake(SSKForceFieldTypeVortex, strength);
+    field.center = center;
+    field.radius = radius;
+    return field;
+}
+
+static inline SSKForceField SSKForceFieldCurlNoise(float frequency, float strength, SSKFloat2 drift) {
+    SSKForceField field = SSKForceFieldMake(SSKForceFieldTypeCurlNoise, strength);
+    field.frequency = frequency;
+    field.center = drift;
+    return field;
+}
+
+static inline SSKForceField SSKForceFieldDrag(SSKFloat2 center, SSKFloat2 extent, float damping) {
+    SSKForceField field = SSKForceFieldMake(SSKForceFieldTypeDrag, damping);
+    field.center = center;
+    field.extent = extent;
+    return field;
+}
+
+static inline SSKForceField SSKForceFieldBounds(SSKFloat2 center, SSKFloat2 extent, float restitution) {
+    SSKForceField field = SSKForceFieldMake(SSKForceFieldTypeBounds, restitution);
+    field.center = center;
+    field.extent = extent;
+    return field;
+}
+
+/// Accelerations and drag for the live slots in `[begin, end)`, applied in
+/// list order. Run before integration; touches `velocity` only. Each field is
+/// its own sweep over the slot range, so a long list stays a handful of tight
+/// loops (point, vortex and drag sweeps are branch-free and masked by `alive`,
+/// which lets the compiler vectorise them). Disjoint ranges may run
+/// concurrently.
+void SSKParticleCoreApplyForceFields(SSKParticleCore *core, const SSKForceFieldParams *params,
+                                     uint32_t begin, uint32_t end);
+
+/// Bounds collisions for the live slots in `[begin, end)`. Run after
+/// integration; touches `position` and `velocity`.
+void SSKParticleCoreResolveForceFieldBounds(SSKParticleCore *core, const SSKForceFieldParams *params,
+                                            uint32_t begin, uint32_t end);
+
+/// Acceleration the `CurlNoise` field applies at `position` and `time`.
+/// Exposed so tools and tests can sample the flow.
+SSKFloat2 SSKForceFieldCurlNoiseSample(const SSKForceField *field, SSKFloat2 position, float time);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKForceField_h */
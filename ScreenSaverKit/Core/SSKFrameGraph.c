@@ -0,0 +1,239 @@
+#include "SSKFrameGraph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void SSKFrameGraphInit(SSKFrameGraph *graph) {
+    if (!graph) { return; }
+    memset(graph, 0, sizeof(*graph));
+}
+
+void SSKFrameGraphDestroy(SSKFrameGraph *graph) {
+    if (!graph) { return; }
+    free(graph->passes);
+    free(graph->resources);
+    free(graph->order);
+    free(graph->physical);
+    free(graph->scratch);
+    memset(graph, 0, sizeof(*graph));
+}
+
+void SSKFrameGraphReset(SSKFrameGraph *graph) {
+    if (!graph) { return; }
+    graph->passCount = 0;
+    graph->resourceCount = 0;
+    graph->orderCount = 0;
+    graph->batchCount = 0;
+    graph->physicalCount = 0;
+    graph->transientBytes = 0;
+    graph->physicalBytes = 0;
+}
+
+/// Grows `*buffer` to hold at least `needed` elements of `size` bytes.
+static bool SSKFrameGraphReserve(void **buffer, uint32_t *capacity, uint32_t needed, size_t size) {
+    if (needed <= *capacity) { return true; }
+    uint32_t grown = *capacity > 0 ? *capacity : 16;
+    while (grown < needed) {
+        grown = grown > UINT32_MAX / 2 ? needed : grown * 2;
+    }
+    void *resized = realloc(*buffer, size * grown);
+    if (!resized) { return false; }
+    *buffer = resized;
+    *capacity = grown;
+    return true;
+}
+
+static SSKFrameGraphResource SSKFrameGraphDeclare(SSKFrameGraph *graph, const char *name,
+                                                  const SSKFrameGraphTextureDesc *desc, bool imported,
+                                                  void *userData) {
+    if (!graph || !desc || graph->resourceCount == SSKFrameGraphInvalid - 1 ||
+        !SSKFrameGraphReserve((void **)&graph->resources, &graph->resourceCapacity, graph->resourceCount + 1,
+                              sizeof(SSKFrameGraphResourceInfo))) {
+        return SSKFrameGraphInvalid;
+    }
+    SSKFrameGraphResource handle = graph->resourceCount++;
+    graph->resources[handle] = (SSKFrameGraphResourceInfo){
+        .name = name,
+        .desc = *desc,
+        .imported = imported,
+        .userData = userData,
+        .firstUse = SSKFrameGraphInvalid,
+        .lastUse = SSKFrameGraphInvalid,
+        .physical = SSKFrameGraphInvalid,
+    };
+    return handle;
+}
+
+SSKFrameGraphResource SSKFrameGraphImport(SSKFrameGraph *graph, const char *name,
+                                          const SSKFrameGraphTextureDesc *desc, void *userData) {
+    return SSKFrameGraphDeclare(graph, name, desc, true, userData);
+}
+
+SSKFrameGraphResource SSKFrameGraphCreate(SSKFrameGraph *graph, const char *name,
+                                          const SSKFrameGraphTextureDesc *desc) {
+    return SSKFrameGraphDeclare(graph, name, desc, false, NULL);
+}
+
+uint32_t SSKFrameGraphAddPass(SSKFrameGraph *graph, const char *name, SSKFrameGraphPassKind kind, uint32_t flags,
+                              const SSKFrameGraphResource *reads, uint32_t readCount,
+                              const SSKFrameGraphResource *writes, uint32_t writeCount, void *userData) {
+    if (!graph || readCount > SSKFrameGraphMaxPassResources || writeCount > SSKFrameGraphMaxPassResources ||
+        (readCount > 0 && !reads) || (writeCount > 0 && !writes)) {
+        return SSKFrameGraphInvalid;
+    }
+    for (uint32_t i = 0; i < readCount; i++) {
+        if (reads[i] >= graph->resourceCount) { return SSKFrameGraphInvalid; }
+    }
+    for (uint32_t i = 0; i < writeCount; i++) {
+        if (writes[i] >= graph->resourceCount) { return SSKFrameGraphInvalid; }
+    }
+    if (graph->passCount == SSKFrameGraphInvalid - 1 ||
+        !SSKFrameGraphReserve((void **)&graph->passes, &graph->passCapacity, graph->passCount + 1,
+                              sizeof(SSKFrameGraphPass))) {
+        return SSKFrameGraphInvalid;
+    }
+    uint32_t index = graph->passCount++;
+    SSKFrameGraphPass *pass = &graph->passes[index];
+    memset(pass, 0, sizeof(*pass));
+    pass->name = name;
+    pass->kind = kind;
+    pass->flags = flags;
+    pass->readCount = readCount;
+    pass->writeCount = writeCount;
+    if (readCount > 0) { memcpy(pass->reads, reads, sizeof(SSKFrameGraphResource) * readCount); }
+    if (writeCount > 0) { memcpy(pass->writes, writes, sizeof(SSKFrameGraphResource) * writeCount); }
+    pass->userData = userData;
+    return index;
+}
+
+static uint64_t SSKFrameGraphDescBytes(const SSKFrameGraphTextureDesc *desc) {
+    return (uint64_t)desc->width * desc->height * desc->bytesPerPixel;
+}
+
+/// Walks the passes backwards with one flag per texture meaning "the current
+/// version is read later". A pass is live when it has side effects or writes
+/// a needed version; its writes then start a new version (no longer needed
+/// before it) and its reads become needed. Imported textures start needed.
+static void SSKFrameGraphCull(SSKFrameGraph *graph, uint32_t *needed) {
+    for (uint32_t r = 0; r < graph->resourceCount; r++) { needed[r] = graph->resources[r].imported; }
+    for (uint32_t i = graph->passCount; i-- > 0;) {
+        SSKFrameGraphPass *pass = &graph->passes[i];
+        bool live = (pass->flags & SSKFrameGraphPassFlagSideEffect) != 0;
+        for (uint32_t w = 0; w < pass->writeCount && !live; w++) { live = needed[pass->writes[w]] != 0; }
+        pass->live = live;
+        if (!live) { continue; }
+        for (uint32_t w = 0; w < pass->writeCount; w++) { needed[pass->writes[w]] = 0; }
+        for (uint32_t r = 0; r < pass->readCount; r++) { needed[pass->reads[r]] = 1; }
+    }
+    graph->orderCount = 0;
+    for (uint32_t i = 0; i < graph->passCount; i++) {
+        if (graph->passes[i].live) { graph->order[graph->orderCount++] = i; }
+    }
+}
+
+static void SSKFrameGraphTouch(SSKFrameGraphResourceInfo *resource, uint32_t position) {
+    if (resource->firstUse == SSKFrameGraphInvalid) { resource->firstUse = position; }
+    resource->lastUse = position;
+}
+
+/// Records lifetimes and encoder batches. `lastWrite` / `lastRead` hold the
+/// latest position that wrote / read each texture; anything at or after the
+/// start of the current batch forces a barrier.
+static SSKFrameGraphStatus SSKFrameGraphSchedule(SSKFrameGraph *graph, uint32_t *lastWrite, uint32_t *lastRead) {
+    for (uint32_t r = 0; r < graph->resourceCount; r++) {
+        SSKFrameGraphResourceInfo *resource = &graph->resources[r];
+        resource->firstUse = resource->lastUse = resource->physical = SSKFrameGraphInvalid;
+        lastWrite[r] = lastRead[r] = SSKFrameGraphInvalid;
+    }
+    graph->batchCount = 0;
+    uint32_t batchStart = 0;
+    for (uint32_t k = 0; k < graph->orderCount; k++) {
+        SSKFrameGraphPass *pass = &graph->passes[graph->order[k]];
+        bool joins = k > 0 && pass->kind == SSKFrameGraphPassCompute &&
+                     graph->passes[graph->order[k - 1]].kind == SSKFrameGraphPassCompute;
+        if (!joins) {
+            batchStart = k;
+            graph->batchCount++;
+        }
+        pass->batch = graph->batchCount - 1;
+        pass->barrier = false;
+
+        for (uint32_t i = 0; i < pass->readCount; i++) {
+            SSKFrameGraphResource r = pass->reads[i];
+            if (!graph->resources[r].imported && lastWrite[r] == SSKFrameGraphInvalid) {
+                return SSKFrameGraphErrorReadBeforeWrite;
+            }
+            if (joins && lastWrite[r] != SSKFrameGraphInvalid && lastWrite[r] >= batchStart) { pass->barrier = true; }
+        }
+        for (uint32_t i = 0; i < pass->writeCount; i++) {
+            SSKFrameGraphResource w = pass->writes[i];
+            if (joins && ((lastWrite[w] != SSKFrameGraphInvalid && lastWrite[w] >= batchStart) ||
+                          (lastRead[w] != SSKFrameGraphInvalid && lastRead[w] >= batchStart))) {
+                pass->barrier = true;
+            }
+        }
+        for (uint32_t i = 0; i < pass->readCount; i++) {
+            lastRead[pass->reads[i]] = k;
+            SSKFrameGraphTouch(&graph->resources[pass->reads[i]], k);
+        }
+        for (uint32_t i = 0; i < pass->writeCount; i++) {
+            lastWrite[pass->writes[i]] = k;
+            SSKFrameGraphTouch(&graph->resources[pass->writes[i]], k);
+        }
+    }
+    return SSKFrameGraphOK;
+}
+
+/// Hands each transient, in order of first use, the lowest physical texture
+/// of the same description whose tenant's last use is behind it.
+static SSKFrameGraphStatus SSKFrameGraphAlias(SSKFrameGraph *graph, uint32_t *busyUntil) {
+    graph->physicalCount = 0;
+    graph->transientBytes = 0;
+    graph->physicalBytes = 0;
+    for (uint32_t k = 0; k < graph->orderCount; k++) {
+        const SSKFrameGraphPass *pass = &graph->passes[graph->order[k]];
+        for (uint32_t i = 0; i < pass->readCount + pass->writeCount; i++) {
+            SSKFrameGraphResource handle = i < pass->readCount ? pass->reads[i] : pass->writes[i - pass->readCount];
+            SSKFrameGraphResourceInfo *resource = &graph->resources[handle];
+            if (resource->imported || resource->firstUse != k || resource->physical != SSKFrameGraphInvalid) {
+                continue;
+            }
+            uint32_t slot = SSKFrameGraphInvalid;
+            for (uint32_t p = 0; p < graph->physicalCount && slot == SSKFrameGraphInvalid; p++) {
+                if (busyUntil[p] < k && SSKFrameGraphTextureDescEqual(&graph->physical[p], &resource->desc)) {
+                    slot = p;
+                }
+            }
+            if (slot == SSKFrameGraphInvalid) {
+                if (!SSKFrameGraphReserve((void **)&graph->physical, &graph->physicalCapacity,
+                                          graph->physicalCount + 1, sizeof(SSKFrameGraphTextureDesc))) {
+                    return SSKFrameGraphErrorOutOfMemory;
+                }
+                slot = graph->physicalCount++;
+                graph->physical[slot] = resource->desc;
+                graph->physicalBytes += SSKFrameGraphDescBytes(&resource->desc);
+            }
+            busyUntil[slot] = resource->lastUse;
+            resource->physical = slot;
+            graph->transientBytes += SSKFrameGraphDescBytes(&resource->desc);
+        }
+    }
+    return SSKFrameGraphOK;
+}
+
+SSKFrameGraphStatus SSKFrameGraphCompile(SSKFrameGraph *graph) {
+    if (!graph) { return SSKFrameGraphErrorOutOfMemory; }
+    if (!SSKFrameGraphReserve((void **)&graph->order, &graph->orderCapacity, graph->passCount, sizeof(uint32_t)) ||
+        !SSKFrameGraphReserve((void **)&graph->scratch, &graph->scratchCapacity, graph->resourceCount * 3,
+                              sizeof(uint32_t))) {
+        return SSKFrameGraphErrorOutOfMemory;
+    }
+    uint32_t *first = graph->scratch;
+    uint32_t *second = graph->scratch + graph->resourceCount;
+    uint32_t *third = graph->scratch + 2 * (size_t)graph->resourceCount;
+
+    SSKFrameGraphCull(graph, first);
+    SSKFrameGraphStatus status = SSKFrameGraphSchedule(graph, first, second);
+    if (status != SSKFrameGraphOK) { return status; }
+    return SSKFrameGraphAlias(graph, third);
+}
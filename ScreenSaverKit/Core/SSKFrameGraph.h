@@ -0,0 +1,178 @@
+#ifndef SSKFrameGraph_h
+#define SSKFrameGraph_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Handle of a texture declared in an `SSKFrameGraph` (its index).
+typedef uint32_t SSKFrameGraphResource;
+
+enum {
+    SSKFrameGraphInvalid = UINT32_MAX,
+    /// Most textures a single pass may read, and separately write.
+    SSKFrameGraphMaxPassResources = 8,
+};
+
+/// Texture description. The graph never interprets `format` or `usage` (the
+/// Metal layer stores `MTLPixelFormat` and `MTLTextureUsage`); two transient
+/// textures share storage only when all five fields match.
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t usage;
+    /// Only used for the memory figures reported by `SSKFrameGraphCompile`.
+    uint32_t bytesPerPixel;
+} SSKFrameGraphTextureDesc;
+
+typedef enum {
+    /// Compute dispatches only. Consecutive live compute passes are encoded
+    /// into one compute encoder.
+    SSKFrameGraphPassCompute = 0,
+    /// Opens its own encoders (render passes, blits, stages that were written
+    /// against a command buffer). Always gets an encoder batch to itself.
+    SSKFrameGraphPassEncoder,
+} SSKFrameGraphPassKind;
+
+typedef enum {
+    SSKFrameGraphPassFlagNone = 0,
+    /// Never culled, even when nothing reads what it writes.
+    SSKFrameGraphPassFlagSideEffect = 1u << 0,
+} SSKFrameGraphPassFlags;
+
+typedef struct {
+    const char *name;
+    SSKFrameGraphPassKind kind;
+    uint32_t flags;
+    uint32_t readCount;
+    uint32_t writeCount;
+    SSKFrameGraphResource reads[SSKFrameGraphMaxPassResources];
+    SSKFrameGraphResource writes[SSKFrameGraphMaxPassResources];
+    void *userData;
+
+    // Filled in by `SSKFrameGraphCompile`.
+    bool live;
+    /// Encoder batch the pass is encoded into.
+    uint32_t batch;
+    /// The pass touches a texture an earlier pass of the same batch wrote, or
+    /// writes one it read, so the encoder needs a memory barrier before it.
+    bool barrier;
+} SSKFrameGraphPass;
+
+typedef struct {
+    const char *name;
+    SSKFrameGraphTextureDesc desc;
+    /// Imported textures (the drawable, caller-owned targets) outlive the
+    /// frame: they are never aliased and their final contents count as output.
+    bool imported;
+    void *userData;
+
+    // Filled in by `SSKFrameGraphCompile`.
+    /// Positions in `order` of the first and last live pass using the texture;
+    /// `SSKFrameGraphInvalid` when no live pass does.
+    uint32_t firstUse;
+    uint32_t lastUse;
+    /// Index into `physical` for transients that are used.
+    uint32_t physical;
+} SSKFrameGraphResourceInfo;
+
+/// Per-frame pass graph for the Metal effect chain.
+///
+/// Passes are added in submission order and declare the textures they read
+/// and write; a pass that updates a texture in place lists it in both. The
+/// submission order is the execution order, so a read always sees the latest
+/// earlier write. `Compile` then:
+///
+/// - culls passes whose writes nothing live reads (walking backwards from the
+///   imported textures and side-effect passes, and tracking each write as a
+///   new version, so a pass overwritten before it is read is culled too);
+/// - groups consecutive live compute passes into shared encoder batches and
+///   flags where a batch needs a barrier;
+/// - computes every transient's lifetime over the live passes and assigns it a
+///   physical texture, reusing one whose previous tenant is dead when the
+///   descriptions match. Interval colouring in order of first use is optimal
+///   per description, so the physical count is the peak number of textures of
+///   that description alive at once.
+///
+/// The graph is plain data, so the whole compiler runs headless; the Metal
+/// layer (`SSKMetalFrameGraph`) only acquires the physical textures and calls
+/// the pass callbacks. Storage grows on demand and is kept across `Reset`, so
+/// steady-state frames do not allocate.
+typedef struct {
+    SSKFrameGraphPass *passes;
+    uint32_t passCount;
+    uint32_t passCapacity;
+
+    SSKFrameGraphResourceInfo *resources;
+    uint32_t resourceCount;
+    uint32_t resourceCapacity;
+
+    // Filled in by `SSKFrameGraphCompile`.
+    /// Live pass indices in execution order.
+    uint32_t *order;
+    uint32_t orderCount;
+    uint32_t orderCapacity;
+    uint32_t batchCount;
+    /// Descriptions of the physical textures backing the transients.
+    SSKFrameGraphTextureDesc *physical;
+    uint32_t physicalCount;
+    uint32_t physicalCapacity;
+    /// Bytes of every used transient if each had its own texture, and of the
+    /// physical textures actually needed.
+    uint64_t transientBytes;
+    uint64_t physicalBytes;
+
+    /// Compiler scratch, three entries per resource.
+    uint32_t *scratch;
+    uint32_t scratchCapacity;
+} SSKFrameGraph;
+
+typedef enum {
+    SSKFrameGraphOK = 0,
+    SSKFrameGraphErrorOutOfMemory,
+    /// A live pass reads a transient texture no earlier live pass wrote.
+    SSKFrameGraphErrorReadBeforeWrite,
+} SSKFrameGraphStatus;
+
+void SSKFrameGraphInit(SSKFrameGraph *graph);
+
+void SSKFrameGraphDestroy(SSKFrameGraph *graph);
+
+/// Forgets every pass and texture, keeping storage for the next frame.
+void SSKFrameGraphReset(SSKFrameGraph *graph);
+
+/// Declares a texture that lives outside the frame. Returns
+/// `SSKFrameGraphInvalid` on allocation failure.
+SSKFrameGraphResource SSKFrameGraphImport(SSKFrameGraph *graph, const char *name,
+                                          const SSKFrameGraphTextureDesc *desc, void *userData);
+
+/// Declares a texture that only lives within the frame. Returns
+/// `SSKFrameGraphInvalid` on allocation failure.
+SSKFrameGraphResource SSKFrameGraphCreate(SSKFrameGraph *graph, const char *name,
+                                          const SSKFrameGraphTextureDesc *desc);
+
+/// Appends a pass. Returns its index, or `SSKFrameGraphInvalid` if a list is
+/// longer than `SSKFrameGraphMaxPassResources`, names an undeclared texture,
+/// or storage could not grow. `name` is not copied.
+uint32_t SSKFrameGraphAddPass(SSKFrameGraph *graph, const char *name, SSKFrameGraphPassKind kind, uint32_t flags,
+                              const SSKFrameGraphResource *reads, uint32_t readCount,
+                              const SSKFrameGraphResource *writes, uint32_t writeCount, void *userData);
+
+/// Culls, batches and plans aliasing (see `SSKFrameGraph`). May be called
+/// again after adding more passes.
+SSKFrameGraphStatus SSKFrameGraphCompile(SSKFrameGraph *graph);
+
+static inline bool SSKFrameGraphTextureDescEqual(const SSKFrameGraphTextureDesc *a,
+                                                 const SSKFrameGraphTextureDesc *b) {
+    return a->width == b->width && a->height == b->height && a->format == b->format && a->usage == b->usage &&
+           a->bytesPerPixel == b->bytesPerPixel;
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKFrameGraph_h */
@@ -0,0 +1,201 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKFrameRing.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+enum { SSKFrameRingMaxAlignment = 256, SSKFrameRingMaxChunks = 8 };
+
+typedef struct {
+    void *contents;
+    void *handle;
+    size_t length;
+} SSKFrameRingBuffer;
+
+/// Linear arena for one frame slot. `chunks[0]` is the main buffer; overflow
+/// chunks are chained when a frame needs more than it holds.
+typedef struct {
+    SSKFrameRingBuffer chunks[SSKFrameRingMaxChunks];
+    uint32_t chunkCount;
+    size_t used;
+} SSKFrameRingArena;
+
+struct SSKFrameRing {
+    SSKFrameRingDevice device;
+    uint32_t frameCount;
+    size_t initialArenaLength;
+    SSKFrameRingArena *arenas;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t retired;
+    uint64_t nextFrame;        ///< Identifier handed out by the next BeginFrame.
+    uint64_t retiredFrames;    ///< Number of frames retired so far (frames retire in order).
+    bool frameOpen;
+};
+
+static size_t SSKFrameRingAlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static bool SSKFrameRingCreateChunk(SSKFrameRing *ring, size_t length, SSKFrameRingBuffer *outBuffer) {
+    void *handle = NULL;
+    void *contents = ring->device.createBuffer(ring->device.context, length, &handle);
+    if (!contents) { return false; }
+    outBuffer->contents = contents;
+    outBuffer->handle = handle;
+    outBuffer->length = length;
+    return true;
+}
+
+static void SSKFrameRingReleaseArena(SSKFrameRing *ring, SSKFrameRingArena *arena) {
+    for (uint32_t i = 0; i < arena->chunkCount; i++) {
+        ring->device.destroyBuffer(ring->device.context, arena->chunks[i].handle);
+    }
+    arena->chunkCount = 0;
+    arena->used = 0;
+}
+
+/// Resets a slot's arena for reuse. If the last frame in this slot overflowed
+/// into extra chunks, they are replaced by one buffer large enough for all of it.
+static void SSKFrameRingResetArena(SSKFrameRing *ring, SSKFrameRingArena *arena) {
+    if (arena->chunkCount > 1) {
+        size_t total = 0;
+        for (uint32_t i = 0; i < arena->chunkCount; i++) {
+            total += arena->chunks[i].length;
+        }
+        SSKFrameRingBuffer merged;
+        if (SSKFrameRingCreateChunk(ring, total, &merged)) {
+            SSKFrameRingReleaseArena(ring, arena);
+            arena->chunks[0] = merged;
+            arena->chunkCount = 1;
+        }
+    }
+    arena->used = 0;
+}
+
+SSKFrameRing *SSKFrameRingCreate(const SSKFrameRingDevice *device, uint32_t frameCount, size_t initialArenaLength) {
+    if (!device || !device->createBuffer || !device->destroyBuffer) { return NULL; }
+    SSKFrameRing *ring = calloc(1, sizeof(SSKFrameRing));
+    if (!ring) { return NULL; }
+    ring->device = *device;
+    ring->frameCount = frameCount ? frameCount : SSKFrameRingDefaultFrameCount;
+    ring->initialArenaLength = SSKFrameRingAlignUp(initialArenaLength ? initialArenaLength : 4096,
+                                                   SSKFrameRingMaxAlignment);
+    ring->arenas = calloc(ring->frameCount, sizeof(SSKFrameRingArena));
+    if (!ring->arenas) {
+        free(ring);
+        return NULL;
+    }
+    pthread_mutex_init(&ring->mutex, NULL);
+    pthread_cond_init(&ring->retired, NULL);
+    return ring;
+}
+
+void SSKFrameRingDestroy(SSKFrameRing *ring) {
+    if (!ring) { return; }
+    SSKFrameRingWaitIdle(ring);
+    for (uint32_t i = 0; i < ring->frameCount; i++) {
+        SSKFrameRingReleaseArena(ring, &ring->arenas[i]);
+    }
+    pthread_cond_destroy(&ring->retired);
+    pthread_mutex_destroy(&ring->mutex);
+    free(ring->arenas);
+    free(ring);
+}
+
+uint32_t SSKFrameRingFrameCount(const SSKFrameRing *ring) {
+    return ring ? ring->frameCount : 0;
+}
+
+static uint64_t SSKFrameRingOpenFrameLocked(SSKFrameRing *ring) {
+    uint64_t frame = ring->nextFrame++;
+    ring->frameOpen = true;
+    SSKFrameRingResetArena(ring, &ring->arenas[frame % ring->frameCount]);
+    return frame;
+}
+
+uint64_t SSKFrameRingBeginFrame(SSKFrameRing *ring) {
+    pthread_mutex_lock(&ring->mutex);
+    while (ring->nextFrame - ring->retiredFrames >= ring->frameCount) {
+        pthread_cond_wait(&ring->retired, &ring->mutex);
+    }
+    uint64_t frame = SSKFrameRingOpenFrameLocked(ring);
+    pthread_mutex_unlock(&ring->mutex);
+    return frame;
+}
+
+bool SSKFrameRingTryBeginFrame(SSKFrameRing *ring, uint64_t *outFrame) {
+    pthread_mutex_lock(&ring->mutex);
+    bool available = ring->nextFrame - ring->retiredFrames < ring->frameCount;
+    if (available) {
+        uint64_t frame = SSKFrameRingOpenFrameLocked(ring);
+        if (outFrame) { *outFrame = frame; }
+    }
+    pthread_mutex_unlock(&ring->mutex);
+    return available;
+}
+
+bool SSKFrameRingAllocate(SSKFrameRing *ring, size_t length, size_t alignment, SSKFrameAllocation *outAllocation) {
+    if (!ring || !outAllocation || !ring->frameOpen) { return false; }
+    if (alignment == 0) { alignment = 16; }
+    if (alignment > SSKFrameRingMaxAlignment || (alignment & (alignment - 1)) != 0) { return false; }
+    if (length == 0) { length = 1; }
+
+    // The open slot belongs to the CPU until EndFrame, so no lock is needed here.
+    SSKFrameRingArena *arena = &ring->arenas[(ring->nextFrame - 1) % ring->frameCount];
+    SSKFrameRingBuffer *chunk = arena->chunkCount ? &arena->chunks[arena->chunkCount - 1] : NULL;
+    size_t offset = SSKFrameRingAlignUp(arena->used, alignment);
+    if (!chunk || offset + length > chunk->length) {
+        if (arena->chunkCount == SSKFrameRingMaxChunks) { return false; }
+        size_t previous = chunk ? chunk->length : ring->initialArenaLength / 2;
+        size_t grown = SSKFrameRingAlignUp(length, SSKFrameRingMaxAlignment);
+        if (grown < previous * 2) { grown = previous * 2; }
+        if (!SSKFrameRingCreateChunk(ring, grown, &arena->chunks[arena->chunkCount])) { return false; }
+        chunk = &arena->chunks[arena->chunkCount++];
+        offset = 0;
+    }
+
+    arena->used = offset + length;
+    outAllocation->contents = (char *)chunk->contents + offset;
+    outAllocation->handle = chunk->handle;
+    outAllocation->offset = offset;
+    return true;
+}
+
+void SSKFrameRingEndFrame(SSKFrameRing *ring) {
+    if (!ring) { return; }
+    pthread_mutex_lock(&ring->mutex);
+    ring->frameOpen = false;
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+void SSKFrameRingRetire(SSKFrameRing *ring, uint64_t frame) {
+    if (!ring) { return; }
+    pthread_mutex_lock(&ring->mutex);
+    // Command buffers on one queue complete in commit order, so frames retire
+    // in order; tolerate duplicates rather than double counting.
+    if (frame + 1 > ring->retiredFrames) {
+        ring->retiredFrames = frame + 1;
+        pthread_cond_broadcast(&ring->retired);
+    }
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+void SSKFrameRingWaitIdle(SSKFrameRing *ring) {
+    if (!ring) { return; }
+    pthread_mutex_lock(&ring->mutex);
+    uint64_t target = ring->frameOpen ? ring->nextFrame - 1 : ring->nextFrame;
+    while (ring->retiredFrames < target) {
+        pthread_cond_wait(&ring->retired, &ring->mutex);
+    }
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+uint32_t SSKFrameRingFramesInFlight(SSKFrameRing *ring) {
+    if (!ring) { return 0; }
+    pthread_mutex_lock(&ring->mutex);
+    uint32_t inFlight = (uint32_t)(ring->nextFrame - ring->retiredFrames);
+    pthread_mutex_unlock(&ring->mutex);
+    return inFlight;
+}
@@ -0,0 +1,82 @@
+#ifndef SSKFrameRing_h
+#define SSKFrameRing_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Default number of frames the CPU may run ahead of the GPU.
+enum { SSKFrameRingDefaultFrameCount = 3 };
+
+/// Buffer provider behind an `SSKFrameRing`. The Metal layer backs it with
+/// shared `MTLBuffer`s; headless code and tests can back it with `malloc`.
+typedef struct {
+    void *context;
+    /// Creates a CPU-visible buffer of at least `length` bytes. Returns its
+    /// mapped contents and stores an opaque handle (e.g. a retained
+    /// `id<MTLBuffer>`) in `outHandle`, or returns NULL on failure.
+    void *(*createBuffer)(void *context, size_t length, void **outHandle);
+    /// Releases a buffer returned by `createBuffer`. Only called once the GPU
+    /// has retired every frame that used it.
+    void (*destroyBuffer)(void *context, void *handle);
+} SSKFrameRingDevice;
+
+/// A sub-allocation valid for one frame.
+typedef struct {
+    void *contents;   ///< CPU pointer to the first byte of the range.
+    void *handle;     ///< Buffer handle from the device (bind this on the GPU).
+    size_t offset;    ///< Byte offset of the range inside `handle`.
+} SSKFrameAllocation;
+
+/// Frame-in-flight ring allocator.
+///
+/// Each of the `frameCount` frame slots owns a linear arena. `BeginFrame`
+/// waits (semaphore-style) until the slot it is about to reuse has been
+/// retired by the GPU, then resets the arena; `Allocate` bumps a pointer
+/// inside it. Arenas grow by chaining extra buffers, which are folded into a
+/// single larger one the next time the slot comes round, so steady state
+/// allocates nothing. `Retire` may be called from any thread, typically a
+/// command buffer completion handler.
+typedef struct SSKFrameRing SSKFrameRing;
+
+/// Creates a ring with `frameCount` slots (0 means the default) whose arenas
+/// start at `initialArenaLength` bytes. Returns NULL on failure.
+SSKFrameRing *SSKFrameRingCreate(const SSKFrameRingDevice *device, uint32_t frameCount, size_t initialArenaLength);
+
+/// Waits for every frame in flight to retire, then releases all buffers.
+void SSKFrameRingDestroy(SSKFrameRing *ring);
+
+uint32_t SSKFrameRingFrameCount(const SSKFrameRing *ring);
+
+/// Starts the next frame and returns its identifier. Blocks while all
+/// `frameCount` slots are still in flight. Frames must be ended (and later
+/// retired) in the order they were begun; only one frame is open at a time.
+uint64_t SSKFrameRingBeginFrame(SSKFrameRing *ring);
+
+/// Non-blocking variant: returns false instead of waiting when no slot is free.
+bool SSKFrameRingTryBeginFrame(SSKFrameRing *ring, uint64_t *outFrame);
+
+/// Sub-allocates `length` bytes aligned to `alignment` (a power of two, at
+/// most 256) from the open frame. Returns false when no frame is open or the
+/// device could not provide memory.
+bool SSKFrameRingAllocate(SSKFrameRing *ring, size_t length, size_t alignment, SSKFrameAllocation *outAllocation);
+
+/// Closes the open frame. Its allocations stay untouched until `frame` is retired.
+void SSKFrameRingEndFrame(SSKFrameRing *ring);
+
+/// Marks `frame` as finished on the GPU so its slot can be reused. Thread safe.
+void SSKFrameRingRetire(SSKFrameRing *ring, uint64_t frame);
+
+/// Blocks until every ended frame has been retired.
+void SSKFrameRingWaitIdle(SSKFrameRing *ring);
+
+/// Frames begun but not yet retired.
+uint32_t SSKFrameRingFramesInFlight(SSKFrameRing *ring);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKFrameRing_h */
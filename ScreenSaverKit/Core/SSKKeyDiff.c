@@ -0,0 +1,46 @@
+#include "SSKKeyDiff.h"
+
+SSKKeyDiffResult SSKKeyDiffRun(const void *const *currentKeys,
+                               const void *const *currentValues,
+                               uint32_t currentCount,
+                               uint32_t previousCount,
+                               const SSKKeyDiffCallbacks *callbacks,
+                               void *context) {
+    SSKKeyDiffResult result = {0, 0, 0, false};
+    if (previousCount == 0) {
+        for (uint32_t i = 0; i < currentCount; i++) {
+            callbacks->changed(context, currentKeys[i]);
+        }
+        result.changed = currentCount;
+        return result;
+    }
+
+    for (uint32_t i = 0; i < currentCount; i++) {
+        const void *old = callbacks->previousValue(context, currentKeys[i]);
+        if (!old) {
+            callbacks->changed(context, currentKeys[i]);
+            result.changed++;
+            continue;
+        }
+        result.shared++;
+        if (old == currentValues[i]) { continue; }
+        result.equalityChecks++;
+        if (!callbacks->equal(context, old, currentValues[i])) {
+            callbacks->changed(context, currentKeys[i]);
+            result.changed++;
+        }
+    }
+
+    // Every previous key was matched, so none can be missing.
+    if (result.shared >= previousCount) { return result; }
+    result.scannedPrevious = true;
+    const void *const *previousKeys = callbacks->previousKeys(context);
+    if (!previousKeys) { return result; }
+    for (uint32_t i = 0; i < previousCount; i++) {
+        if (!callbacks->currentContains(context, previousKeys[i])) {
+            callbacks->changed(context, previousKeys[i]);
+            result.changed++;
+        }
+    }
+    return result;
+}
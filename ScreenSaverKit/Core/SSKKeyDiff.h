@@ -0,0 +1,55 @@
+#ifndef SSKKeyDiff_h
+#define SSKKeyDiff_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Finds the keys whose values differ between two key/value maps, including
+/// keys present in only one of them.
+///
+/// Keys and values are opaque pointers (the Objective-C side passes
+/// `NSString`s and property-list objects); the maps themselves are reached
+/// through callbacks. The current map is walked once. Values are compared by
+/// pointer first and only handed to `equal` when the pointers differ, which
+/// settles most keys since unchanged values usually come back as the same
+/// objects. The previous map is walked, to find removed keys, only when fewer
+/// of its keys were seen in the current map than it holds.
+typedef struct {
+    /// Value stored under `key` in the previous map, or NULL when absent.
+    const void *(*previousValue)(void *context, const void *key);
+    /// Whether `key` is in the current map.
+    bool (*currentContains)(void *context, const void *key);
+    /// Deep equality of two values with different pointers.
+    bool (*equal)(void *context, const void *a, const void *b);
+    /// The previous map's keys, `previousCount` of them. Only asked for when
+    /// some may have been removed.
+    const void *const *(*previousKeys)(void *context);
+    /// Receives each changed key once.
+    void (*changed)(void *context, const void *key);
+} SSKKeyDiffCallbacks;
+
+typedef struct {
+    uint32_t changed;          ///< Keys reported.
+    uint32_t shared;           ///< Current keys also in the previous map.
+    uint32_t equalityChecks;   ///< Calls to `equal`.
+    bool scannedPrevious;      ///< Whether the previous map was walked.
+} SSKKeyDiffResult;
+
+/// Reports the keys of `currentKeys`/`currentValues` (`currentCount` pairs)
+/// that are new or hold a different value than in the previous map, then the
+/// previous map's keys missing from the current one. With `previousCount` 0
+/// every current key is reported and no callback but `changed` is used.
+SSKKeyDiffResult SSKKeyDiffRun(const void *const *currentKeys,
+                               const void *const *currentValues,
+                               uint32_t currentCount,
+                               uint32_t previousCount,
+                               const SSKKeyDiffCallbacks *callbacks,
+                               void *context);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKKeyDiff_h */
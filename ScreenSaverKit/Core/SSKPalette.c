@@ -0,0 +1,83 @@
+#include "SSKPalette.h"
+
+float SSKPaletteSRGBToLinear(float value) {
+    if (value <= 0.04045f) { return value / 12.92f; }
+    return powf((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float SSKPaletteLinearToSRGB(float value) {
+    if (value <= 0.0031308f) { return value * 12.92f; }
+    return 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static SSKFloat4 SSKPaletteLinearise(SSKFloat4 color) {
+    return SSKFloat4Make(SSKPaletteSRGBToLinear(color.x), SSKPaletteSRGBToLinear(color.y),
+                         SSKPaletteSRGBToLinear(color.z), color.w);
+}
+
+/// `stop` in `encoding`, without a round trip through linear when it is
+/// already sRGB.
+static SSKFloat4 SSKPaletteStopInEncoding(SSKFloat4 stop, SSKPaletteEncoding encoding) {
+    return encoding == SSKPaletteEncodingSRGB ? stop : SSKPaletteLinearise(stop);
+}
+
+static SSKFloat4 SSKPaletteEncode(SSKFloat4 linear, SSKPaletteEncoding encoding) {
+    if (encoding == SSKPaletteEncodingLinear) { return linear; }
+    return SSKFloat4Make(SSKPaletteLinearToSRGB(linear.x), SSKPaletteLinearToSRGB(linear.y),
+                         SSKPaletteLinearToSRGB(linear.z), linear.w);
+}
+
+void SSKPaletteLUTBuild(SSKPaletteLUT *lut, const SSKFloat4 *stops, uint32_t stopCount, SSKPaletteWrap wrap,
+                        SSKPaletteEncoding encoding) {
+    if (!lut) { return; }
+    lut->wrap = wrap;
+    lut->encoding = encoding;
+    if (!stops || stopCount < 2) {
+        SSKFloat4 solid = (stops && stopCount == 1) ?
+            SSKPaletteStopInEncoding(stops[0], encoding) : SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+        lut->intervals = SSKPaletteLUTResolution;
+        for (uint32_t i = 0; i <= SSKPaletteLUTResolution; i++) {
+            lut->entries[i] = solid;
+        }
+        return;
+    }
+
+    // A looping palette has a segment from the last stop back to the first.
+    // Palettes with more segments than entries are sampled unaligned.
+    uint32_t segments = wrap == SSKPaletteWrapLoop ? stopCount : stopCount - 1;
+    uint32_t perSegment = segments <= SSKPaletteLUTResolution ? SSKPaletteLUTResolution / segments : 0;
+    uint32_t intervals = perSegment > 0 ? segments * perSegment : SSKPaletteLUTResolution;
+    lut->intervals = intervals;
+    for (uint32_t i = 0; i < intervals; i++) {
+        uint32_t segment;
+        float t;
+        if (perSegment > 0) {
+            segment = i / perSegment;
+            t = (float)(i % perSegment) / (float)perSegment;
+        } else {
+            float scaled = (float)i * (float)segments / (float)intervals;
+            segment = (uint32_t)scaled < segments ? (uint32_t)scaled : segments - 1;
+            t = scaled - (float)segment;
+        }
+        if (t == 0.0f) {
+            lut->entries[i] = SSKPaletteStopInEncoding(stops[segment], encoding);
+            continue;
+        }
+        SSKFloat4 a = SSKPaletteLinearise(stops[segment]);
+        SSKFloat4 b = SSKPaletteLinearise(stops[(segment + 1) % stopCount]);
+        SSKFloat4 mixed = SSKFloat4Make(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                                        a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+        lut->entries[i] = SSKPaletteEncode(mixed, encoding);
+    }
+    // The end point is exact: back to the first entry when looping, the last
+    // stop when clamped.
+    lut->entries[intervals] = wrap == SSKPaletteWrapLoop ?
+        lut->entries[0] : SSKPaletteStopInEncoding(stops[stopCount - 1], encoding);
+}
+
+void SSKPaletteLUTSampleBatch(const SSKPaletteLUT *lut, const float *progress, SSKFloat4 *colors, uint32_t count) {
+    if (!lut || !progress || !colors) { return; }
+    for (uint32_t i = 0; i < count; i++) {
+        colors[i] = SSKPaletteLUTSample(lut, progress[i]);
+    }
+}
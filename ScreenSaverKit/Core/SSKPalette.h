@@ -0,0 +1,76 @@
+#ifndef SSKPalette_h
+#define SSKPalette_h
+
+#include <math.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Intervals in a palette lookup table; the table holds one more entry so
+/// the last interval has an end point.
+enum { SSKPaletteLUTResolution = 512 };
+
+/// How progress outside `[0, 1]` maps onto the palette.
+typedef enum {
+    /// Progress wraps, and the last colour blends back into the first.
+    SSKPaletteWrapLoop = 0,
+    /// Progress is clamped; the palette runs from the first colour at 0 to
+    /// the last at 1.
+    SSKPaletteWrapClamp = 1,
+} SSKPaletteWrap;
+
+/// Transfer function of the colours a table returns.
+typedef enum {
+    /// Linear-light components, for blending or sRGB render targets.
+    SSKPaletteEncodingLinear = 0,
+    /// sRGB-encoded components, for `BGRA8Unorm` drawables and CoreGraphics.
+    SSKPaletteEncodingSRGB = 1,
+} SSKPaletteEncoding;
+
+/// A palette compiled to evenly spaced float colours.
+///
+/// The stops are blended in linear light once, at build time, so sampling is
+/// one wrap, one table read and one lerp. A built table is never written
+/// again and can be sampled from any number of threads without locking.
+typedef struct {
+    /// Straight (not premultiplied) RGBA at progress `i / intervals`.
+    SSKFloat4 entries[SSKPaletteLUTResolution + 1];
+    /// Intervals in use: the largest multiple of the segment count that fits,
+    /// so every stop lands on an entry and no interval straddles a corner.
+    uint32_t intervals;
+    SSKPaletteWrap wrap;
+    SSKPaletteEncoding encoding;
+} SSKPaletteLUT;
+
+/// sRGB transfer function and its inverse, per component.
+float SSKPaletteSRGBToLinear(float value);
+float SSKPaletteLinearToSRGB(float value);
+
+/// Compiles `stopCount` sRGB-encoded, straight RGBA stops spaced evenly along
+/// the palette. Colour is interpolated in linear light and alpha linearly.
+/// No stops gives opaque white; one stop gives a solid colour.
+void SSKPaletteLUTBuild(SSKPaletteLUT *lut, const SSKFloat4 *stops, uint32_t stopCount, SSKPaletteWrap wrap,
+                        SSKPaletteEncoding encoding);
+
+/// Colour at `progress`. NaN, and infinite progress when looping, sample the
+/// start of the palette.
+static inline SSKFloat4 SSKPaletteLUTSample(const SSKPaletteLUT *lut, float progress) {
+    float u = lut->wrap == SSKPaletteWrapLoop ? progress - floorf(progress) : fminf(fmaxf(progress, 0.0f), 1.0f);
+    if (!(u >= 0.0f)) { u = 0.0f; }
+    float scaled = u * (float)lut->intervals;
+    uint32_t index = (uint32_t)scaled;
+    if (index > lut->intervals - 1) { index = lut->intervals - 1; }
+    float t = scaled - (float)index;
+    SSKFloat4 a = lut->entries[index];
+    SSKFloat4 b = lut->entries[index + 1];
+    return SSKFloat4Make(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+}
+
+/// Samples `count` progress values into `colors`, as `SSKPaletteLUTSample`.
+void SSKPaletteLUTSampleBatch(const SSKPaletteLUT *lut, const float *progress, SSKFloat4 *colors, uint32_t count);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKPalette_h */
@@ -0,0 +1,399 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKParticleCore.h"
+#include "SSKParticleSIMD.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t kSSKParticleStreamAlignment = 64;
+static const uint32_t kSSKParticleSlotPadding = 16;
+
+static size_t SSKParticleStreamElementSize(SSKParticleStream stream) {
+    switch (stream) {
+        case SSKParticleStreamPosition:
+        case SSKParticleStreamVelocity:
+        case SSKParticleStreamUserVector:
+        case SSKParticleStreamSizeRange:
+            return sizeof(SSKFloat2);
+        case SSKParticleStreamColor:
+        case SSKParticleStreamBaseColor:
+            return sizeof(SSKFloat4);
+        case SSKParticleStreamBehaviorFlags:
+        case SSKParticleStreamAlive:
+            return sizeof(uint32_t);
+        default:
+            return sizeof(float);
+    }
+}
+
+static size_t SSKAlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t SSKParticleCorePaddedCapacity(uint32_t capacity) {
+    return (uint32_t)SSKAlignUp(capacity, kSSKParticleSlotPadding);
+}
+
+size_t SSKParticleCoreStreamOffset(uint32_t capacity, SSKParticleStream stream) {
+    size_t padded = SSKParticleCorePaddedCapacity(capacity);
+    size_t offset = 0;
+    for (int s = 0; s < (int)stream; s++) {
+        offset += SSKAlignUp(SSKParticleStreamElementSize((SSKParticleStream)s) * padded,
+                             kSSKParticleStreamAlignment);
+    }
+    return offset;
+}
+
+size_t SSKParticleCoreStorageSize(uint32_t capacity) {
+    return SSKParticleCoreStreamOffset(capacity, SSKParticleStreamCount);
+}
+
+static SSKParticleCore *SSKParticleCoreAllocate(uint32_t capacity, void *storage, bool ownsStorage) {
+    SSKParticleCore *core = calloc(1, sizeof(SSKParticleCore));
+    if (!core) { return NULL; }
+
+    core->capacity = capacity;
+    core->storage = storage;
+    core->ownsStorage = ownsStorage;
+    core->simdLevel = SSKSIMDBestLevel();
+    core->aliveList = malloc(sizeof(uint32_t) * capacity);
+    bool slotsReady = SSKSlotAllocatorInit(&core->slots, capacity);
+    if (!core->aliveList || !slotsReady) {
+        core->ownsStorage = false;
+        SSKParticleCoreDestroy(core);
+        return NULL;
+    }
+
+    char *base = storage;
+#define SSK_STREAM(field, stream) core->field = (void *)(base + SSKParticleCoreStreamOffset(capacity, stream))
+    SSK_STREAM(position, SSKParticleStreamPosition);
+    SSK_STREAM(velocity, SSKParticleStreamVelocity);
+    SSK_STREAM(userVector, SSKParticleStreamUserVector);
+    SSK_STREAM(sizeRange, SSKParticleStreamSizeRange);
+    SSK_STREAM(color, SSKParticleStreamColor);
+    SSK_STREAM(baseColor, SSKParticleStreamBaseColor);
+    SSK_STREAM(life, SSKParticleStreamLife);
+    SSK_STREAM(maxLife, SSKParticleStreamMaxLife);
+    SSK_STREAM(size, SSKParticleStreamSize);
+    SSK_STREAM(baseSize, SSKParticleStreamBaseSize);
+    SSK_STREAM(sizeVelocity, SSKParticleStreamSizeVelocity);
+    SSK_STREAM(rotation, SSKParticleStreamRotation);
+    SSK_STREAM(rotationVelocity, SSKParticleStreamRotationVelocity);
+    SSK_STREAM(damping, SSKParticleStreamDamping);
+    SSK_STREAM(behaviorFlags, SSKParticleStreamBehaviorFlags);
+    SSK_STREAM(alive, SSKParticleStreamAlive);
+    SSK_STREAM(userScalar, SSKParticleStreamUserScalar);
+#undef SSK_STREAM
+
+    SSKParticleCoreReset(core);
+    return core;
+}
+
+SSKParticleCore *SSKParticleCoreCreate(uint32_t capacity) {
+    if (capacity == 0) { return NULL; }
+    void *storage = NULL;
+    if (posix_memalign(&storage, kSSKParticleStreamAlignment, SSKParticleCoreStorageSize(capacity)) != 0) {
+        return NULL;
+    }
+    SSKParticleCore *core = SSKParticleCoreAllocate(capacity, storage, true);
+    if (!core) {
+        free(storage);
+    }
+    return core;
+}
+
+SSKParticleCore *SSKParticleCoreCreateWithStorage(uint32_t capacity, void *storage, size_t length) {
+    if (capacity == 0 || !storage || length < SSKParticleCoreStorageSize(capacity)) {
+        return NULL;
+    }
+    if (((uintptr_t)storage % kSSKParticleStreamAlignment) != 0) {
+        return NULL;
+    }
+    return SSKParticleCoreAllocate(capacity, storage, false);
+}
+
+void SSKParticleCoreDestroy(SSKParticleCore *core) {
+    if (!core) { return; }
+    if (core->ownsStorage) {
+        free(core->storage);
+    }
+    free(core->aliveList);
+    SSKSlotAllocatorDestroy(&core->slots);
+    free(core);
+}
+
+void SSKParticleCoreResetSlot(SSKParticleCore *core, uint32_t slot) {
+    core->position[slot] = SSKFloat2Make(0.0f, 0.0f);
+    core->velocity[slot] = SSKFloat2Make(0.0f, 0.0f);
+    core->userVector[slot] = SSKFloat2Make(0.0f, 0.0f);
+    core->sizeRange[slot] = SSKFloat2Make(1.0f, 1.0f);
+    core->color[slot] = SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+    core->baseColor[slot] = SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+    core->life[slot] = 0.0f;
+    core->maxLife[slot] = 1.0f;
+    core->size[slot] = 1.0f;
+    core->baseSize[slot] = 1.0f;
+    core->sizeVelocity[slot] = 0.0f;
+    core->rotation[slot] = 0.0f;
+    core->rotationVelocity[slot] = 0.0f;
+    core->damping[slot] = 0.0f;
+    core->behaviorFlags[slot] = 0u;
+    core->alive[slot] = 0u;
+    core->userScalar[slot] = 0.0f;
+}
+
+void SSKParticleCoreReset(SSKParticleCore *core) {
+    if (!core) { return; }
+    // Padding slots stay dead forever; the vector kernels read them as masked lanes.
+    uint32_t padded = SSKParticleCorePaddedCapacity(core->capacity);
+    for (uint32_t slot = 0; slot < padded; slot++) {
+        SSKParticleCoreResetSlot(core, slot);
+    }
+    core->aliveCount = 0;
+    core->highWater = 0;
+    core->usedBehaviorFlags = 0u;
+    core->usedDamping = false;
+    SSKSlotAllocatorReset(&core->slots);
+}
+
+uint32_t SSKParticleCoreSpawn(SSKParticleCore *core, uint32_t count, uint32_t *outSlots) {
+    if (!core || count == 0) { return 0; }
+    // The claimed slots land directly at the tail of the alive list.
+    uint32_t *claimed = core->aliveList + core->aliveCount;
+    uint32_t emitted = SSKSlotAllocatorAcquire(&core->slots, count, claimed);
+    uint32_t highWater = core->highWater;
+    for (uint32_t i = 0; i < emitted; i++) {
+        uint32_t slot = claimed[i];
+        SSKParticleCoreResetSlot(core, slot);
+        core->alive[slot] = 1u;
+        if (slot >= highWater) {
+            highWater = slot + 1;
+        }
+    }
+    core->aliveCount += emitted;
+    core->highWater = highWater;
+    if (outSlots && emitted > 0) {
+        memcpy(outSlots, claimed, sizeof(uint32_t) * emitted);
+    }
+    return emitted;
+}
+
+void SSKParticleCoreExpire(SSKParticleCore *core, float dt) {
+    uint32_t *list = core->aliveList;
+    float *life = core->life;
+    const float *maxLife = core->maxLife;
+    uint32_t *alive = core->alive;
+    uint32_t count = core->aliveCount;
+    uint32_t kept = 0;
+    uint32_t highWater = 0;
+
+    // Stable in-place compaction keeps the alive list in spawn order.
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = list[i];
+        if (alive[slot]) {
+            float value = life[slot] + dt;
+            life[slot] = value;
+            if (value < maxLife[slot]) {
+                list[kept++] = slot;
+                if (slot >= highWater) { highWater = slot + 1; }
+                continue;
+            }
+            alive[slot] = 0u;
+        }
+        SSKSlotAllocatorReleaseOne(&core->slots, slot);
+    }
+    core->aliveCount = kept;
+    core->highWater = highWater;
+}
+
+void SSKParticleCoreCompactAliveList(SSKParticleCore *core) {
+    uint32_t *list = core->aliveList;
+    const uint32_t *alive = core->alive;
+    uint32_t count = core->aliveCount;
+    uint32_t kept = 0;
+    uint32_t highWater = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = list[i];
+        if (alive[slot]) {
+            list[kept++] = slot;
+            if (slot >= highWater) { highWater = slot + 1; }
+        } else {
+            SSKSlotAllocatorReleaseOne(&core->slots, slot);
+        }
+    }
+    core->aliveCount = kept;
+    core->highWater = highWater;
+}
+
+// Per-slot steps shared by the phase loops and SSKParticleCoreAdvanceSlots so
+// both produce bit-identical results.
+
+static inline void SSKParticleApplyForcesToSlot(SSKParticleCore *core, uint32_t slot,
+                                                const SSKParticleSimParams *params,
+                                                SSKFloat2 gravityStep, bool hasGravity) {
+    SSKFloat2 v = core->velocity[slot];
+    if (hasGravity) {
+        v.x += gravityStep.x;
+        v.y += gravityStep.y;
+    }
+    float combined = fmaxf(0.0f, core->damping[slot] + params->globalDamping);
+    if (combined > 0.0f) {
+        float factor = powf(fmaxf(0.0f, 1.0f - combined), params->dt);
+        v.x *= factor;
+        v.y *= factor;
+    }
+    core->velocity[slot] = v;
+}
+
+static inline void SSKParticleApplyBehavioursToSlot(SSKParticleCore *core, uint32_t slot, float dt) {
+    float sizeVelocity = core->sizeVelocity[slot];
+    if (fabsf(sizeVelocity) > 0.0001f) {
+        core->size[slot] = fmaxf(0.0f, core->size[slot] + sizeVelocity * dt);
+    }
+
+    uint32_t flags = core->behaviorFlags[slot];
+    if (flags == 0u) { return; }
+
+    float maxLife = core->maxLife[slot];
+    float normalized = (maxLife > 0.0f) ? fminf(fmaxf(core->life[slot] / maxLife, 0.0f), 1.0f) : 0.0f;
+
+    if ((flags & SSKParticleCoreBehaviorFadeAlpha) != 0u) {
+        SSKFloat4 base = core->baseColor[slot];
+        core->color[slot] = SSKFloat4Make(base.x, base.y, base.z, base.w * (1.0f - normalized));
+    }
+
+    if ((flags & SSKParticleCoreBehaviorFadeSize) != 0u) {
+        SSKFloat2 range = core->sizeRange[slot];
+        float multiplier = range.x + (range.y - range.x) * normalized;
+        core->size[slot] = fmaxf(0.0f, core->baseSize[slot] * multiplier);
+    }
+}
+
+static inline void SSKParticleIntegrateSlot(SSKParticleCore *core, uint32_t slot, float dt) {
+    core->position[slot].x += core->velocity[slot].x * dt;
+    core->position[slot].y += core->velocity[slot].y * dt;
+    core->rotation[slot] += core->rotationVelocity[slot] * dt;
+}
+
+static inline void SSKParticleUpdateDirectionOfSlot(SSKParticleCore *core, uint32_t slot) {
+    SSKFloat2 v = core->velocity[slot];
+    float lengthSquared = v.x * v.x + v.y * v.y;
+    if (lengthSquared > 0.0001f) {
+        float inverseLength = 1.0f / sqrtf(lengthSquared);
+        core->userVector[slot] = SSKFloat2Make(v.x * inverseLength, v.y * inverseLength);
+    }
+}
+
+void SSKParticleCoreApplyForces(SSKParticleCore *core, const SSKParticleSimParams *params) {
+    const uint32_t *list = core->aliveList;
+    uint32_t count = core->aliveCount;
+    float dt = params->dt;
+    SSKFloat2 gravityStep = SSKFloat2Make(params->gravity.x * dt, params->gravity.y * dt);
+    bool hasGravity = (params->gravity.x != 0.0f || params->gravity.y != 0.0f);
+
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleApplyForcesToSlot(core, list[i], params, gravityStep, hasGravity);
+    }
+}
+
+void SSKParticleCoreApplyBehaviours(SSKParticleCore *core, float dt) {
+    const uint32_t *list = core->aliveList;
+    uint32_t count = core->aliveCount;
+
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleApplyBehavioursToSlot(core, list[i], dt);
+    }
+}
+
+void SSKParticleCoreIntegrate(SSKParticleCore *core, float dt) {
+    const uint32_t *list = core->aliveList;
+    uint32_t count = core->aliveCount;
+
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleIntegrateSlot(core, list[i], dt);
+    }
+}
+
+void SSKParticleCoreUpdateDirections(SSKParticleCore *core) {
+    const uint32_t *list = core->aliveList;
+    uint32_t count = core->aliveCount;
+
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleUpdateDirectionOfSlot(core, list[i]);
+    }
+}
+
+uint32_t SSKParticleCoreAdvanceSlots(SSKParticleCore *core, const SSKParticleSimParams *params,
+                                     uint32_t begin, uint32_t end, uint32_t *deadSlots) {
+    float dt = params->dt;
+    SSKFloat2 gravityStep = SSKFloat2Make(params->gravity.x * dt, params->gravity.y * dt);
+    bool hasGravity = (params->gravity.x != 0.0f || params->gravity.y != 0.0f);
+    uint32_t deadCount = 0;
+
+    for (uint32_t slot = begin; slot < end; slot++) {
+        if (!core->alive[slot]) { continue; }
+        float life = core->life[slot] + dt;
+        core->life[slot] = life;
+        if (life >= core->maxLife[slot]) {
+            core->alive[slot] = 0u;
+            if (deadSlots) {
+                deadSlots[deadCount] = slot;
+            }
+            deadCount++;
+            continue;
+        }
+        SSKParticleApplyForcesToSlot(core, slot, params, gravityStep, hasGravity);
+        SSKParticleApplyBehavioursToSlot(core, slot, dt);
+        SSKParticleIntegrateSlot(core, slot, dt);
+        SSKParticleUpdateDirectionOfSlot(core, slot);
+    }
+    return deadCount;
+}
+
+void SSKParticleCoreAdvance(SSKParticleCore *core, const SSKParticleSimParams *params) {
+    if (!core || !params || params->dt <= 0.0f) { return; }
+    if (SSKParticleSIMDAdvance(core, params, core->simdLevel)) {
+        return;
+    }
+    SSKParticleCoreExpire(core, params->dt);
+    SSKParticleCoreApplyForces(core, params);
+    SSKParticleCoreApplyBehaviours(core, params->dt);
+    SSKParticleCoreIntegrate(core, params->dt);
+    SSKParticleCoreUpdateDirections(core);
+}
+
+void SSKParticleCoreRetireSlots(SSKParticleCore *core, const uint32_t *slots, uint32_t count) {
+    if (!core || !slots || count == 0) { return; }
+    if (SSKSlotAllocatorRelease(&core->slots, slots, count) == 0) { return; }
+
+    // Filter on the allocator rather than the `alive` flag: a GPU step still in
+    // flight may already have cleared flags for slots that are not released yet.
+    uint32_t *list = core->aliveList;
+    uint32_t kept = 0;
+    uint32_t highWater = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = list[i];
+        if (SSKSlotAllocatorIsHeld(&core->slots, slot)) {
+            list[kept++] = slot;
+            if (slot >= highWater) { highWater = slot + 1; }
+        }
+    }
+    core->aliveCount = kept;
+    core->highWater = highWater;
+}
+
+void SSKParticleCoreRebuildAliveList(SSKParticleCore *core) {
+    if (!core) { return; }
+    SSKSlotAllocatorRebuild(&core->slots, core->alive);
+    core->aliveCount = 0;
+    core->highWater = 0;
+    for (uint32_t slot = 0; slot < core->capacity; slot++) {
+        if (core->alive[slot]) {
+            core->aliveList[core->aliveCount++] = slot;
+            core->highWater = slot + 1;
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#ifndef SSKParticleCore_h
+#define SSKParticleCore_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKSIMD.h"
+#include "SSKSlotAllocator.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Behaviour flag values. Mirrors `SSKParticleBehaviorOptions` and the Metal kernel.
+enum {
+    SSKParticleCoreBehaviorFadeAlpha = 1u << 0,
+    SSKParticleCoreBehaviorFadeSize  = 1u << 1,
+};
+
+/// Identifies one attribute stream inside the core's storage block. The first
+/// `SSKParticleStreamSimulatedCount` entries are the streams read or written by
+/// the Metal simulation kernel, in the kernel's `[[buffer(n)]]` order.
+typedef enum {
+    SSKParticleStreamPosition = 0,      // SSKFloat2
+    SSKParticleStreamVelocity,          // SSKFloat2
+    SSKParticleStreamUserVector,        // SSKFloat2, normalised velocity after each step
+    SSKParticleStreamSizeRange,         // SSKFloat2, start/end multipliers for FadeSize
+    SSKParticleStreamColor,             // SSKFloat4
+    SSKParticleStreamBaseColor,         // SSKFloat4
+    SSKParticleStreamLife,              // float
+    SSKParticleStreamMaxLife,           // float
+    SSKParticleStreamSize,              // float
+    SSKParticleStreamBaseSize,          // float
+    SSKParticleStreamSizeVelocity,      // float
+    SSKParticleStreamRotation,          // float
+    SSKParticleStreamRotationVelocity,  // float
+    SSKParticleStreamDamping,           // float
+    SSKParticleStreamBehaviorFlags,     // uint32_t
+    SSKParticleStreamAlive,             // uint32_t, 0 or 1
+    SSKParticleStreamSimulatedCount,
+    SSKParticleStreamUserScalar = SSKParticleStreamSimulatedCount, // float, CPU only
+    SSKParticleStreamCount
+} SSKParticleStream;
+
+/// Structure-of-arrays particle storage.
+///
+/// Every attribute lives in its own contiguous stream indexed by slot, so each
+/// update phase only pulls the cache lines it actually needs. Slots never move
+/// while a particle is alive (the Metal kernel and `SSKParticle` handles rely
+/// on that); `aliveList` holds the dense list of live slots the CPU phases walk
+/// instead of scanning the full capacity.
+typedef struct SSKParticleCore {
+    uint32_t capacity;
+
+    SSKFloat2 *position;
+    SSKFloat2 *velocity;
+    SSKFloat2 *userVector;
+    SSKFloat2 *sizeRange;
+    SSKFloat4 *color;
+    SSKFloat4 *baseColor;
+    float *life;
+    float *maxLife;
+    float *size;
+    float *baseSize;
+    float *sizeVelocity;
+    float *rotation;
+    float *rotationVelocity;
+    float *damping;
+    uint32_t *behaviorFlags;
+    uint32_t *alive;
+    float *userScalar;
+
+    /// Dense list of live slots, `aliveCount` entries long.
+    uint32_t *aliveList;
+    uint32_t aliveCount;
+
+    /// Free-slot stack plus occupancy bits. A slot is held from spawn until it
+    /// is released back here, which may lag the `alive` flag while a GPU step
+    /// that retired it is still in flight.
+    SSKSlotAllocator slots;
+
+    /// One past the highest live slot. The vector kernels sweep `[0, highWater)`.
+    uint32_t highWater;
+
+    /// Behaviour flags written to any slot since the last reset, OR'd together,
+    /// and whether any slot was given its own damping. They only grow, so they
+    /// bound what the live particles use; the Metal step picks a specialised
+    /// kernel from them (see `SSKParticleKernelVariant.h`).
+    uint32_t usedBehaviorFlags;
+    bool usedDamping;
+
+    /// Kernel level used by `SSKParticleCoreAdvance`. Defaults to the best level
+    /// the CPU supports; set to `SSKSIMDLevelScalar` to force the phase loops.
+    SSKSIMDLevel simdLevel;
+
+    void *storage;
+    bool ownsStorage;
+} SSKParticleCore;
+
+/// Per-step simulation parameters shared by every live particle.
+typedef struct {
+    SSKFloat2 gravity;
+    float dt;
+    float globalDamping;
+} SSKParticleSimParams;
+
+/// `capacity` rounded up to a multiple of 16. Streams are sized for the padded
+/// count so vector kernels can load whole lanes past the last real slot.
+uint32_t SSKParticleCorePaddedCapacity(uint32_t capacity);
+
+/// Number of bytes required to hold every stream for `capacity` particles.
+size_t SSKParticleCoreStorageSize(uint32_t capacity);
+
+/// Byte offset of `stream` within a storage block sized for `capacity`.
+/// Offsets are 64-byte aligned so streams can be bound individually on the GPU.
+size_t SSKParticleCoreStreamOffset(uint32_t capacity, SSKParticleStream stream);
+
+/// Creates a core that owns its stream storage. Returns NULL on allocation failure.
+SSKParticleCore *SSKParticleCoreCreate(uint32_t capacity);
+
+/// Creates a core whose streams live in caller-provided memory (for example the
+/// contents of a shared `MTLBuffer`). `length` must be at least
+/// `SSKParticleCoreStorageSize(capacity)`. The storage is not freed on destroy.
+SSKParticleCore *SSKParticleCoreCreateWithStorage(uint32_t capacity, void *storage, size_t length);
+
+void SSKParticleCoreDestroy(SSKParticleCore *core);
+
+/// Resets every slot to its defaults and marks all slots free.
+void SSKParticleCoreReset(SSKParticleCore *core);
+
+/// Writes default values into `slot` (white, size 1, one second of life, dead).
+void SSKParticleCoreResetSlot(SSKParticleCore *core, uint32_t slot);
+
+/// Claims up to `count` free slots, resets them, marks them alive and appends
+/// them to the alive list. Slot indices are written to `outSlots` (which must
+/// hold `count` entries). Returns the number of slots claimed.
+uint32_t SSKParticleCoreSpawn(SSKParticleCore *core, uint32_t count, uint32_t *outSlots);
+
+/// Phase 1: ages live particles and retires the ones whose life ran out.
+/// Touches `life`, `maxLife` and `alive` only.
+void SSKParticleCoreExpire(SSKParticleCore *core, float dt);
+
+/// Phase 2: gravity and damping. Touches `velocity` and `damping` only.
+void SSKParticleCoreApplyForces(SSKParticleCore *core, const SSKParticleSimParams *params);
+
+/// Phase 3: size velocity plus the FadeAlpha/FadeSize behaviours.
+void SSKParticleCoreApplyBehaviours(SSKParticleCore *core, float dt);
+
+/// Phase 4: integrates position and rotation.
+void SSKParticleCoreIntegrate(SSKParticleCore *core, float dt);
+
+/// Phase 5: stores the normalised velocity in `userVector` for oriented rendering.
+void SSKParticleCoreUpdateDirections(SSKParticleCore *core);
+
+/// Fused scalar step over the slot range `[begin, end)`: every phase, applied
+/// slot by slot to the live slots in the range. Does not touch `aliveList` or
+/// the slot allocator; slots that expire get their flag cleared and, when
+/// `deadSlots` is non-NULL, are written to it in ascending order. Returns how
+/// many expired.
+/// Disjoint ranges may run concurrently.
+uint32_t SSKParticleCoreAdvanceSlots(SSKParticleCore *core, const SSKParticleSimParams *params,
+                                     uint32_t begin, uint32_t end, uint32_t *deadSlots);
+
+/// Drops slots whose `alive` flag is clear from `aliveList` (keeping order) and
+/// releases them to the slot allocator. Used after kernels that retire
+/// particles by clearing the flag instead of maintaining the list themselves.
+void SSKParticleCoreCompactAliveList(SSKParticleCore *core);
+
+/// Runs every phase in order. Equivalent to the legacy per-particle CPU loop.
+/// Dispatches to the fused vector kernel for `simdLevel` when it applies.
+void SSKParticleCoreAdvance(SSKParticleCore *core, const SSKParticleSimParams *params);
+
+/// Releases `count` retired slots (their `alive` flag already cleared) to the
+/// allocator in order and drops them from `aliveList`, keeping spawn order.
+/// Slots that are not held are ignored. Costs `O(count)` plus one pass over
+/// the alive list when anything was released, never a scan of the capacity;
+/// this is how dead lists written by the GPU kernel are fed back.
+void SSKParticleCoreRetireSlots(SSKParticleCore *core, const uint32_t *slots, uint32_t count);
+
+/// Rebuilds `aliveList` and the slot allocator from the `alive` stream. Use
+/// after an external writer changed liveness without reporting which slots.
+void SSKParticleCoreRebuildAliveList(SSKParticleCore *core);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleCore_h */
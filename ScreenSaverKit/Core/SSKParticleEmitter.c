@@ -0,0 +1,120 @@
+#include "SSKParticleEmitter.h"
+
+#include <math.h>
+#include <string.h>
+
+SSKParticleEmitter SSKParticleEmitterDefault(void) {
+    SSKParticleEmitter emitter;
+    memset(&emitter, 0, sizeof(emitter));
+    emitter.maxLife = SSKFloatRangeMake(1.0f, 1.0f);
+    emitter.size = SSKFloatRangeMake(1.0f, 1.0f);
+    emitter.sizeOverLife = SSKFloat2Make(1.0f, 1.0f);
+    emitter.colorStart = SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+    emitter.colorEnd = emitter.colorStart;
+    return emitter;
+}
+
+static inline float SSKEmitterSample(SSKRandom *random, SSKFloatRange range) {
+    // Constant ranges are common (damping-like fields, fixed colours); skip the draw.
+    if (range.min == range.max) { return range.min; }
+    return SSKRandomNextRange(random, range.min, range.max);
+}
+
+/// Records what the emitted particles use, for `usedBehaviorFlags`/`usedDamping`.
+static inline void SSKParticleEmitterMarkUsed(SSKParticleCore *core, const SSKParticleEmitter *emitter) {
+    core->usedBehaviorFlags |= emitter->behaviorFlags;
+    core->usedDamping |= emitter->damping != 0.0f;
+}
+
+/// Writes every stream of `slot` from `e` and marks it alive. The flags
+/// only depend on the emitter, so batch callers compute them once.
+static inline void SSKParticleEmitterFillSlot(SSKParticleCore *core, const SSKParticleEmitter *e, uint32_t slot,
+                                              SSKRandom *random, bool jitterX, bool jitterY, bool sameColor) {
+    float angle = SSKEmitterSample(random, e->angle);
+    float dirX = cosf(angle);
+    float dirY = sinf(angle);
+    float radius = SSKEmitterSample(random, e->radius);
+    float speed = SSKEmitterSample(random, e->speed);
+
+    SSKFloat2 position = SSKFloat2Make(e->origin.x + dirX * radius, e->origin.y + dirY * radius);
+    if (jitterX) { position.x += SSKRandomNextRange(random, -e->originJitter.x, e->originJitter.x); }
+    if (jitterY) { position.y += SSKRandomNextRange(random, -e->originJitter.y, e->originJitter.y); }
+    SSKFloat2 velocity = SSKFloat2Make(e->baseVelocity.x + dirX * speed, e->baseVelocity.y + dirY * speed);
+
+    float lengthSquared = velocity.x * velocity.x + velocity.y * velocity.y;
+    SSKFloat2 direction = SSKFloat2Make(0.0f, 0.0f);
+    if (lengthSquared > 0.0001f) {
+        float inverseLength = 1.0f / sqrtf(lengthSquared);
+        direction = SSKFloat2Make(velocity.x * inverseLength, velocity.y * inverseLength);
+    }
+
+    SSKFloat4 color = e->colorStart;
+    if (!sameColor) {
+        float t = SSKRandomNextUnit(random);
+        color.x += (e->colorEnd.x - e->colorStart.x) * t;
+        color.y += (e->colorEnd.y - e->colorStart.y) * t;
+        color.z += (e->colorEnd.z - e->colorStart.z) * t;
+        color.w += (e->colorEnd.w - e->colorStart.w) * t;
+    }
+
+    float size = SSKEmitterSample(random, e->size);
+
+    core->position[slot] = position;
+    core->velocity[slot] = velocity;
+    core->userVector[slot] = direction;
+    core->sizeRange[slot] = e->sizeOverLife;
+    core->color[slot] = color;
+    core->baseColor[slot] = color;
+    core->life[slot] = 0.0f;
+    core->maxLife[slot] = SSKEmitterSample(random, e->maxLife);
+    core->size[slot] = size;
+    core->baseSize[slot] = size;
+    core->sizeVelocity[slot] = SSKEmitterSample(random, e->sizeVelocity);
+    core->rotation[slot] = SSKEmitterSample(random, e->rotation);
+    core->rotationVelocity[slot] = SSKEmitterSample(random, e->rotationVelocity);
+    core->damping[slot] = e->damping;
+    core->behaviorFlags[slot] = e->behaviorFlags;
+    core->alive[slot] = 1u;
+    core->userScalar[slot] = e->userScalar;
+}
+
+uint32_t SSKParticleCoreEmit(SSKParticleCore *core, const SSKParticleEmitter *emitter, uint32_t count,
+                             SSKRandom *random, uint32_t *outSlots) {
+    if (!core || !emitter || !random || count == 0) { return 0; }
+
+    // Slots are acquired straight onto the tail of the alive list; each one is
+    // then written exactly once per stream, with no intermediate reset.
+    uint32_t *claimed = core->aliveList + core->aliveCount;
+    uint32_t emitted = SSKSlotAllocatorAcquire(&core->slots, count, claimed);
+    SSKParticleEmitterMarkUsed(core, emitter);
+
+    const SSKParticleEmitter e = *emitter;
+    const bool jitterX = e.originJitter.x != 0.0f;
+    const bool jitterY = e.originJitter.y != 0.0f;
+    const bool sameColor = memcmp(&e.colorStart, &e.colorEnd, sizeof(SSKFloat4)) == 0;
+    uint32_t highWater = core->highWater;
+
+    for (uint32_t i = 0; i < emitted; i++) {
+        uint32_t slot = claimed[i];
+        SSKParticleEmitterFillSlot(core, &e, slot, random, jitterX, jitterY, sameColor);
+        if (slot >= highWater) {
+            highWater = slot + 1;
+        }
+    }
+
+    core->aliveCount += emitted;
+    core->highWater = highWater;
+    if (outSlots && emitted > 0) {
+        memcpy(outSlots, claimed, sizeof(uint32_t) * emitted);
+    }
+    return emitted;
+}
+
+void SSKParticleEmitterWriteSlot(SSKParticleCore *core, const SSKParticleEmitter *emitter, uint32_t slot,
+                                 SSKRandom *random) {
+    if (!core || !emitter || !random || slot >= core->capacity) { return; }
+    SSKParticleEmitterMarkUsed(core, emitter);
+    bool sameColor = memcmp(&emitter->colorStart, &emitter->colorEnd, sizeof(SSKFloat4)) == 0;
+    SSKParticleEmitterFillSlot(core, emitter, slot, random, emitter->originJitter.x != 0.0f,
+                               emitter->originJitter.y != 0.0f, sameColor);
+}
@@ -0,0 +1,73 @@
+#ifndef SSKParticleEmitter_h
+#define SSKParticleEmitter_h
+
+#include <stdint.h>
+
+#include "SSKParticleCore.h"
+#include "SSKRandom.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Closed range `[min, max]` sampled uniformly. Equal bounds give a constant.
+typedef struct {
+    float min;
+    float max;
+} SSKFloatRange;
+
+static inline SSKFloatRange SSKFloatRangeMake(float min, float max) {
+    SSKFloatRange range = {min, max};
+    return range;
+}
+
+/// Describes how a batch of particles is initialised.
+///
+/// Every field is sampled per particle with the caller's `SSKRandom`, and the
+/// result is written straight into the core's streams, so emitting a batch
+/// allocates nothing and never calls back into the caller.
+typedef struct {
+    /// Spawn centre plus a uniform box of half-extents `originJitter` around it.
+    SSKFloat2 origin;
+    SSKFloat2 originJitter;
+    /// Radial offset from the origin along the emission angle, e.g. to spawn on a ring.
+    SSKFloatRange radius;
+    /// Emission direction in radians and speed along it.
+    SSKFloatRange angle;
+    SSKFloatRange speed;
+    /// Added to every particle's velocity, e.g. the emitter's own motion.
+    SSKFloat2 baseVelocity;
+    SSKFloatRange maxLife;
+    SSKFloatRange size;
+    SSKFloatRange sizeVelocity;
+    /// Start/end multipliers for `SSKParticleCoreBehaviorFadeSize`.
+    SSKFloat2 sizeOverLife;
+    SSKFloatRange rotation;
+    SSKFloatRange rotationVelocity;
+    float damping;
+    /// Each particle gets a uniform mix of the two colours (already in the
+    /// extended sRGB space the streams use). Equal colours give a constant.
+    SSKFloat4 colorStart;
+    SSKFloat4 colorEnd;
+    float userScalar;
+    uint32_t behaviorFlags;
+} SSKParticleEmitter;
+
+/// An emitter at the origin that spawns white, size 1, one second particles
+/// at rest; adjust the fields that matter.
+SSKParticleEmitter SSKParticleEmitterDefault(void);
+
+/// Claims up to `count` slots and initialises them from `emitter`, drawing from
+/// `random`. Claimed slots are appended to the alive list; when `outSlots` is
+/// non-NULL they are also written there. Returns the number emitted.
+uint32_t SSKParticleCoreEmit(SSKParticleCore *core, const SSKParticleEmitter *emitter, uint32_t count,
+                             SSKRandom *random, uint32_t *outSlots);
+
+/// Initialises `slot` alone from `emitter` and marks it alive, leaving the
+/// alive list and slot allocator untouched. Draws from `random` in the same
+/// order as `SSKParticleCoreEmit` does per particle; the GPU-resident emit
+/// kernel runs the same sampling with one generator per thread.
+void SSKParticleEmitterWriteSlot(SSKParticleCore *core, const SSKParticleEmitter *emitter, uint32_t slot,
+                                 SSKRandom *random);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleEmitter_h */
@@ -0,0 +1,156 @@
+#include "SSKParticleInstances.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(sizeof(SSKParticleInstance) == 64, "SSKParticleInstance must match the Metal InstanceData layout");
+_Static_assert(offsetof(SSKParticleInstance, reserved) == 24 && offsetof(SSKParticleInstance, color) == 32 &&
+               offsetof(SSKParticleInstance, softness) == 48,
+               "SSKParticleInstance must have no unnamed padding");
+
+SSKParticleInstanceStyle SSKParticleInstanceStyleDefault(void) {
+    SSKParticleInstanceStyle style = { 1.0f, 12.0f };
+    return style;
+}
+
+static inline void SSKParticleStoreInstance(SSKParticleInstance *instance, SSKFloat2 position,
+                                            float dirX, float dirY, float width, float length,
+                                            SSKFloat4 color, float softness) {
+    instance->position = position;
+    instance->direction = SSKFloat2Make(dirX, dirY);
+    instance->width = width;
+    instance->length = length;
+    instance->reserved[0] = 0.0f;
+    instance->reserved[1] = 0.0f;
+    instance->color = color;
+    instance->softness = softness;
+    instance->padding[0] = 0.0f;
+    instance->padding[1] = 0.0f;
+    instance->padding[2] = 0.0f;
+}
+
+// Per-slot transform shared by the scalar path and the vector tail so both
+// produce bit-identical instances.
+static inline void SSKParticleWriteInstanceForSlot(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                                   uint32_t slot, SSKParticleInstance *instance) {
+    SSKFloat2 dir = core->userVector[slot];
+    float length = sqrtf(dir.x * dir.x + dir.y * dir.y);
+    float dirX = 1.0f;
+    float dirY = 0.0f;
+    if (length >= 0.0001f) {
+        dirX = dir.x / length;
+        dirY = dir.y / length;
+    }
+    float width = fmaxf(style->minWidth, core->size[slot]);
+    float softness = core->userScalar[slot];
+    if (!isfinite(softness) || softness < 0.0f) {
+        softness = 0.0f;
+    }
+    SSKParticleStoreInstance(instance, core->position[slot], dirX, dirY, width, width * style->lengthScale,
+                             core->color[slot], softness);
+}
+
+void SSKParticleCoreWriteInstance(const SSKParticleCore *core, const SSKParticleInstanceStyle *style, uint32_t slot,
+                                  SSKParticleInstance *out) {
+    if (!core || !style || !out || slot >= core->capacity) { return; }
+    SSKParticleWriteInstanceForSlot(core, style, slot, out);
+}
+
+uint32_t SSKParticleCoreWriteInstancesScalar(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                             SSKParticleInstance *out, uint32_t maxCount) {
+    if (!core || !style || !out) { return 0; }
+    uint32_t written = 0;
+    for (uint32_t slot = 0; slot < core->highWater && written < maxCount; slot++) {
+        if (!core->alive[slot]) { continue; }
+        SSKParticleWriteInstanceForSlot(core, style, slot, &out[written++]);
+    }
+    return written;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+
+// SSE2 and NEON are the baseline on the two architectures we ship, so four
+// lanes need no runtime dispatch. The work per slot is a handful of flops;
+// the win is loading each stream once per block and storing straight into
+// the destination.
+typedef float SSKInstanceVec __attribute__((vector_size(16)));
+typedef int32_t SSKInstanceMask __attribute__((vector_size(16)));
+typedef uint32_t SSKInstanceBits __attribute__((vector_size(16)));
+
+static inline SSKInstanceVec SSKInstanceLoad(const float *p) {
+    SSKInstanceVec v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// Bitwise lane select: `mask ? a : b` for all-ones/all-zeros masks.
+static inline SSKInstanceVec SSKInstanceSelect(SSKInstanceMask mask, SSKInstanceVec a, SSKInstanceVec b) {
+    return (SSKInstanceVec)((mask & (SSKInstanceMask)a) | (~mask & (SSKInstanceMask)b));
+}
+
+uint32_t SSKParticleCoreWriteInstances(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                       SSKParticleInstance *out, uint32_t maxCount) {
+    if (!core || !style || !out) { return 0; }
+    const uint32_t end = core->highWater;
+    const SSKInstanceVec minWidth = { style->minWidth, style->minWidth, style->minWidth, style->minWidth };
+    const SSKInstanceVec lengthScale = { style->lengthScale, style->lengthScale, style->lengthScale, style->lengthScale };
+    const SSKInstanceVec zero = { 0.0f, 0.0f, 0.0f, 0.0f };
+    const SSKInstanceVec one = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const SSKInstanceVec epsilon = { 0.0001f, 0.0001f, 0.0001f, 0.0001f };
+    const SSKInstanceVec infinity = { INFINITY, INFINITY, INFINITY, INFINITY };
+    uint32_t written = 0;
+    uint32_t slot = 0;
+
+    // Streams are padded to 16 slots, so whole-block loads past highWater stay in bounds.
+    for (; slot < end && maxCount - written >= 4; slot += 4) {
+        SSKInstanceBits alive;
+        memcpy(&alive, core->alive + slot, sizeof(alive));
+        if ((alive[0] | alive[1] | alive[2] | alive[3]) == 0u) { continue; }
+
+        SSKInstanceVec lo = SSKInstanceLoad(&core->userVector[slot].x);
+        SSKInstanceVec hi = SSKInstanceLoad(&core->userVector[slot + 2].x);
+        SSKInstanceVec vx = __builtin_shufflevector(lo, hi, 0, 2, 4, 6);
+        SSKInstanceVec vy = __builtin_shufflevector(lo, hi, 1, 3, 5, 7);
+        SSKInstanceVec length;
+        for (int i = 0; i < 4; i++) {
+            length[i] = sqrtf(vx[i] * vx[i] + vy[i] * vy[i]);
+        }
+        SSKInstanceMask moving = length >= epsilon;
+        SSKInstanceVec safeLength = SSKInstanceSelect(moving, length, one);
+        SSKInstanceVec dirX = SSKInstanceSelect(moving, vx / safeLength, one);
+        SSKInstanceVec dirY = SSKInstanceSelect(moving, vy / safeLength, zero);
+
+        SSKInstanceVec size = SSKInstanceLoad(core->size + slot);
+        // Matches fmaxf, which also picks `minWidth` when the size is NaN.
+        SSKInstanceVec width = SSKInstanceSelect(size > minWidth, size, minWidth);
+        SSKInstanceVec quadLength = width * lengthScale;
+
+        SSKInstanceVec softness = SSKInstanceLoad(core->userScalar + slot);
+        // NaN and negative values fail `>= 0`; +inf fails `< inf`.
+        softness = SSKInstanceSelect((softness >= zero) & (softness < infinity), softness, zero);
+
+        for (int lane = 0; lane < 4; lane++) {
+            if (!alive[lane] || slot + (uint32_t)lane >= end) { continue; }
+            uint32_t s = slot + (uint32_t)lane;
+            SSKParticleStoreInstance(&out[written++], core->position[s], dirX[lane], dirY[lane],
+                                     width[lane], quadLength[lane], core->color[s], softness[lane]);
+        }
+    }
+
+    // Fewer than four destination entries left: finish slot by slot.
+    for (; slot < end && written < maxCount; slot++) {
+        if (!core->alive[slot]) { continue; }
+        SSKParticleWriteInstanceForSlot(core, style, slot, &out[written++]);
+    }
+    return written;
+}
+
+#else
+
+uint32_t SSKParticleCoreWriteInstances(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                       SSKParticleInstance *out, uint32_t maxCount) {
+    return SSKParticleCoreWriteInstancesScalar(core, style, out, maxCount);
+}
+
+#endif
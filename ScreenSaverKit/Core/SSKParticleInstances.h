@@ -0,0 +1,60 @@
+#ifndef SSKParticleInstances_h
+#define SSKParticleInstances_h
+
+#include <stdint.h>
+
+#include "SSKParticleCore.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// One particle quad as consumed by `particleVertex` in `SSKParticleShaders.metal`
+/// (`InstanceData`). 64 bytes, laid out to match the Metal struct exactly.
+/// `reserved` fills the gap before the 16-byte aligned `color`; it and
+/// `padding` are always written as zero, so instances compare with `memcmp`.
+typedef struct {
+    SSKFloat2 position;
+    SSKFloat2 direction;   ///< Unit length; (1, 0) when the particle is at rest.
+    float width;
+    float length;
+    float reserved[2];
+    SSKFloat4 color;
+    float softness;        ///< `userScalar`, clamped to finite non-negative values.
+    float padding[3];
+} SSKParticleInstance;
+
+/// How particle attributes map onto quads.
+typedef struct {
+    /// Quads are never thinner than this many points.
+    float minWidth;
+    /// Quad length as a multiple of its width.
+    float lengthScale;
+} SSKParticleInstanceStyle;
+
+/// The mapping used by `SSKMetalParticlePass`: width `max(1, size)`, length 12x width.
+SSKParticleInstanceStyle SSKParticleInstanceStyleDefault(void);
+
+/// Writes one instance per live particle into `out`, in slot order, and
+/// returns how many were written (at most `maxCount`).
+///
+/// Sweeps `[0, highWater)` four slots at a time: the attribute transform runs
+/// on whole vectors and live lanes are compacted into `out` as they are
+/// stored, so there is no separate gather pass. Slots already retired by a
+/// GPU step (flag cleared, not yet released) are skipped. `out` may be mapped
+/// GPU memory; it is only written, never read.
+uint32_t SSKParticleCoreWriteInstances(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                       SSKParticleInstance *out, uint32_t maxCount);
+
+/// Scalar reference for `SSKParticleCoreWriteInstances`, one slot at a time.
+/// Produces identical output; used by the benchmark and as the portable fallback.
+uint32_t SSKParticleCoreWriteInstancesScalar(const SSKParticleCore *core, const SSKParticleInstanceStyle *style,
+                                             SSKParticleInstance *out, uint32_t maxCount);
+
+/// Writes the instance for `slot` alone, whether or not it is alive. Used where
+/// instances are not produced in slot order, e.g. by the GPU-resident
+/// lifecycle which writes them at their position in the compacted alive list.
+void SSKParticleCoreWriteInstance(const SSKParticleCore *core, const SSKParticleInstanceStyle *style, uint32_t slot,
+                                  SSKParticleInstance *out);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleInstances_h */
@@ -0,0 +1,36 @@
+#include "SSKParticleKernelVariant.h"
+
+_Static_assert((uint32_t)SSKParticleKernelFeatureFadeAlpha == (uint32_t)SSKParticleCoreBehaviorFadeAlpha &&
+                   (uint32_t)SSKParticleKernelFeatureFadeSize == (uint32_t)SSKParticleCoreBehaviorFadeSize,
+               "behaviour features reuse the behaviour flag bits");
+_Static_assert(SSKParticleKernelVariantCount <= 32, "ready variants are tracked in a uint32_t");
+
+uint32_t SSKParticleKernelFeaturesForStep(const SSKParticleCore *core, const SSKParticleSimParams *params) {
+    if (!core || !params) { return SSKParticleKernelFeatureAll; }
+    uint32_t features = core->usedBehaviorFlags & (SSKParticleKernelFeatureFadeAlpha | SSKParticleKernelFeatureFadeSize);
+    if (params->gravity.x != 0.0f || params->gravity.y != 0.0f) {
+        features |= SSKParticleKernelFeatureGravity;
+    }
+    // The kernel damps by `max(0, damping + globalDamping)`, which is zero for
+    // every particle only when none has its own damping and the global one is
+    // not positive.
+    if (core->usedDamping || params->globalDamping > 0.0f) {
+        features |= SSKParticleKernelFeatureDamping;
+    }
+    return features;
+}
+
+uint32_t SSKParticleKernelSelectVariant(uint32_t features, uint32_t readyVariants) {
+    features &= SSKParticleKernelFeatureAll;
+    uint32_t best = SSKParticleKernelNoVariant;
+    int bestCount = SSKParticleKernelFeatureCount + 1;
+    for (uint32_t variant = features; variant < SSKParticleKernelVariantCount; variant = (variant + 1) | features) {
+        if (!(readyVariants & (1u << variant))) { continue; }
+        int count = __builtin_popcount(variant);
+        if (count < bestCount) {
+            best = variant;
+            bestCount = count;
+        }
+    }
+    return best;
+}
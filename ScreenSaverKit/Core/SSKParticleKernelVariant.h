@@ -0,0 +1,50 @@
+#ifndef SSKParticleKernelVariant_h
+#define SSKParticleKernelVariant_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKParticleCore.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Work the particle step kernels can be specialised on. Each bit is the bool
+/// function constant of the same index in `SSKParticleShaders.metal`. A
+/// variant with a feature off skips that work outright, so it is only correct
+/// while nothing needs it; a variant with extra features on is always correct,
+/// just slower.
+typedef enum {
+    /// Some particle may carry `SSKParticleCoreBehaviorFadeAlpha`.
+    SSKParticleKernelFeatureFadeAlpha = 1u << 0,
+    /// Some particle may carry `SSKParticleCoreBehaviorFadeSize`.
+    SSKParticleKernelFeatureFadeSize = 1u << 1,
+    /// The step has non-zero gravity.
+    SSKParticleKernelFeatureGravity = 1u << 2,
+    /// Some particle may be damped, by its own damping or the global one.
+    SSKParticleKernelFeatureDamping = 1u << 3,
+    /// The generic variant, valid for every step.
+    SSKParticleKernelFeatureAll = (1u << 4) - 1u,
+} SSKParticleKernelFeature;
+
+enum {
+    /// Function constants per specialised kernel, one per feature bit.
+    SSKParticleKernelFeatureCount = 4,
+    /// Distinct variants of one kernel.
+    SSKParticleKernelVariantCount = 1 << SSKParticleKernelFeatureCount,
+    /// Returned by `SSKParticleKernelSelectVariant` when no ready variant fits.
+    SSKParticleKernelNoVariant = UINT32_MAX,
+};
+
+/// Features a step of `core` with `params` needs, from the flags the core
+/// tracks for its particles (`usedBehaviorFlags`, `usedDamping`).
+uint32_t SSKParticleKernelFeaturesForStep(const SSKParticleCore *core, const SSKParticleSimParams *params);
+
+/// Picks the variant to run for `features` from `readyVariants`, where bit `v`
+/// is set once variant `v` is built: the ready variant with the fewest
+/// features that still covers `features`, the lowest on a tie. Returns
+/// `SSKParticleKernelNoVariant` when none covers them.
+uint32_t SSKParticleKernelSelectVariant(uint32_t features, uint32_t readyVariants);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleKernelVariant_h */
@@ -0,0 +1,149 @@
+#include "SSKParticleLifecycle.h"
+
+_Static_assert(sizeof(SSKParticleLifecycleState) == 48, "SSKParticleLifecycleState must match the Metal LifecycleState");
+
+void SSKParticleLifecycleLoad(SSKParticleLifecycle *lifecycle, const uint32_t *aliveFlags) {
+    if (!lifecycle || !aliveFlags) { return; }
+    SSKParticleLifecycleState *state = lifecycle->state;
+    uint32_t aliveCount = 0;
+    uint32_t freeCount = 0;
+    for (uint32_t slot = 0; slot < lifecycle->capacity; slot++) {
+        if (aliveFlags[slot]) {
+            lifecycle->aliveLists[0][aliveCount++] = slot;
+        }
+    }
+    for (uint32_t slot = lifecycle->capacity; slot-- > 0;) {
+        if (!aliveFlags[slot]) {
+            lifecycle->freeSlots[freeCount++] = slot;
+        }
+    }
+    state->freeCount = freeCount;
+    state->aliveCount[0] = aliveCount;
+    state->aliveCount[1] = 0;
+    state->dispatchArgs[0] = 0;
+    state->dispatchArgs[1] = 1;
+    state->dispatchArgs[2] = 1;
+    state->drawArgs[0] = 4;
+    state->drawArgs[1] = aliveCount;
+    state->drawArgs[2] = 0;
+    state->drawArgs[3] = 0;
+}
+
+bool SSKParticleLifecycleEmitThread(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t thread,
+                                    uint32_t *outSlot) {
+    const SSKParticleLifecycleState *state = lifecycle->state;
+    if (thread >= state->freeCount) { return false; }
+    uint32_t slot = lifecycle->freeSlots[state->freeCount - 1 - thread];
+    lifecycle->aliveLists[list][state->aliveCount[list] + thread] = slot;
+    *outSlot = slot;
+    return true;
+}
+
+uint32_t SSKParticleLifecycleCommitEmission(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t count) {
+    SSKParticleLifecycleState *state = lifecycle->state;
+    uint32_t emitted = count < state->freeCount ? count : state->freeCount;
+    state->freeCount -= emitted;
+    state->aliveCount[list] += emitted;
+    return emitted;
+}
+
+void SSKParticleLifecyclePrepare(SSKParticleLifecycle *lifecycle, uint32_t list) {
+    SSKParticleLifecycleState *state = lifecycle->state;
+    state->aliveCount[list ^ 1u] = 0;
+    uint32_t width = SSKParticleLifecycleThreadgroupWidth;
+    state->dispatchArgs[0] = (state->aliveCount[list] + width - 1) / width;
+    state->dispatchArgs[1] = 1;
+    state->dispatchArgs[2] = 1;
+}
+
+uint32_t SSKParticleLifecycleSlotForThread(const SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t thread) {
+    if (thread >= lifecycle->state->aliveCount[list]) { return SSKParticleLifecycleNoSlot; }
+    return lifecycle->aliveLists[list][thread];
+}
+
+uint32_t SSKParticleLifecycleKeep(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t slot) {
+    uint32_t index = lifecycle->state->aliveCount[list ^ 1u]++;
+    lifecycle->aliveLists[list ^ 1u][index] = slot;
+    return index;
+}
+
+void SSKParticleLifecycleRelease(SSKParticleLifecycle *lifecycle, uint32_t slot) {
+    lifecycle->freeSlots[lifecycle->state->freeCount++] = slot;
+}
+
+void SSKParticleLifecycleFinalize(SSKParticleLifecycle *lifecycle, uint32_t list) {
+    SSKParticleLifecycleState *state = lifecycle->state;
+    state->drawArgs[0] = 4;
+    state->drawArgs[1] = state->aliveCount[list ^ 1u];
+    state->drawArgs[2] = 0;
+    state->drawArgs[3] = 0;
+}
+
+/// Visits `[0, count)` as `(offset + i * stride) % count` with a stride
+/// coprime to `count`, which is a permutation, so no order array is needed.
+typedef struct {
+    uint64_t offset;
+    uint64_t stride;
+    uint64_t count;
+} SSKLifecycleSchedule;
+
+static uint32_t SSKLifecycleGCD(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static SSKLifecycleSchedule SSKLifecycleScheduleMake(uint32_t count, SSKRandom *random) {
+    SSKLifecycleSchedule schedule = {0, 1, count};
+    if (!random || count < 2) { return schedule; }
+    schedule.offset = SSKRandomNext(random) % count;
+    uint32_t stride;
+    do {
+        stride = 1 + SSKRandomNext(random) % (count - 1);
+    } while (SSKLifecycleGCD(stride, count) != 1);
+    schedule.stride = stride;
+    return schedule;
+}
+
+static inline uint32_t SSKLifecycleScheduleThread(const SSKLifecycleSchedule *schedule, uint32_t i) {
+    return (uint32_t)((schedule->offset + i * schedule->stride) % schedule->count);
+}
+
+uint32_t SSKParticleLifecycleEmit(SSKParticleLifecycle *lifecycle, SSKParticleCore *core, uint32_t list,
+                                  const SSKParticleEmitter *emitter, uint32_t count, uint64_t seed,
+                                  SSKRandom *schedule) {
+    if (!lifecycle || !core || !emitter || count == 0) { return 0; }
+    SSKLifecycleSchedule order = SSKLifecycleScheduleMake(count, schedule);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t thread = SSKLifecycleScheduleThread(&order, i);
+        uint32_t slot;
+        if (!SSKParticleLifecycleEmitThread(lifecycle, list, thread, &slot)) { continue; }
+        SSKRandom random = SSKRandomMake(seed + thread);
+        SSKParticleEmitterWriteSlot(core, emitter, slot, &random);
+    }
+    return SSKParticleLifecycleCommitEmission(lifecycle, list, count);
+}
+
+uint32_t SSKParticleLifecycleSimulate(SSKParticleLifecycle *lifecycle, SSKParticleCore *core, uint32_t list,
+                                      const SSKParticleSimParams *params, const SSKParticleInstanceStyle *style,
+                                      SSKParticleInstance *instances, SSKRandom *schedule) {
+    if (!lifecycle || !core || !params || !style || !instances) { return list; }
+    SSKParticleLifecyclePrepare(lifecycle, list);
+    uint32_t threads = lifecycle->state->dispatchArgs[0] * SSKParticleLifecycleThreadgroupWidth;
+    SSKLifecycleSchedule order = SSKLifecycleScheduleMake(threads, schedule);
+    for (uint32_t i = 0; i < threads; i++) {
+        uint32_t slot = SSKParticleLifecycleSlotForThread(lifecycle, list, SSKLifecycleScheduleThread(&order, i));
+        if (slot == SSKParticleLifecycleNoSlot) { continue; }
+        if (SSKParticleCoreAdvanceSlots(core, params, slot, slot + 1, NULL) > 0) {
+            SSKParticleLifecycleRelease(lifecycle, slot);
+            continue;
+        }
+        uint32_t index = SSKParticleLifecycleKeep(lifecycle, list, slot);
+        SSKParticleCoreWriteInstance(core, style, slot, &instances[index]);
+    }
+    SSKParticleLifecycleFinalize(lifecycle, list);
+    return list ^ 1u;
+}
@@ -0,0 +1,123 @@
+#ifndef SSKParticleLifecycle_h
+#define SSKParticleLifecycle_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKParticleCore.h"
+#include "SSKParticleEmitter.h"
+#include "SSKParticleInstances.h"
+#include "SSKRandom.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Threads per threadgroup of the resident simulate dispatch. `Prepare` sizes
+/// the indirect dispatch with it, so the Metal layer must use the same width.
+enum { SSKParticleLifecycleThreadgroupWidth = 64 };
+
+/// Returned by `SSKParticleLifecycleSlotForThread` for threads past the list.
+enum { SSKParticleLifecycleNoSlot = UINT32_MAX };
+
+/// Counters and indirect arguments shared by the lifecycle kernels. One of
+/// these lives in a GPU buffer and matches `LifecycleState` in
+/// `SSKParticleShaders.metal`; the kernels update the counters with atomics.
+typedef struct {
+    /// Entries on the free stack.
+    uint32_t freeCount;
+    /// Entries in each of the two alive lists.
+    uint32_t aliveCount[2];
+    uint32_t padding0;
+    /// `MTLDispatchThreadgroupsIndirectArguments` for the simulate dispatch.
+    uint32_t dispatchArgs[3];
+    uint32_t padding1;
+    /// `MTLDrawPrimitivesIndirectArguments` for the particle pass: vertex
+    /// count, instance count (the live particles), vertex start, base instance.
+    uint32_t drawArgs[4];
+} SSKParticleLifecycleState;
+
+/// GPU-resident particle lifecycle: which slots are alive and which are free
+/// is kept on the GPU, so nothing per particle crosses back to the CPU.
+///
+/// Each step reads one alive list and writes the other (the CPU flips
+/// `list` between steps; it never needs the counts to do so):
+///
+/// 1. Emit, one thread per requested particle: thread `i` takes the `i`th
+///    slot from the top of the free stack and writes it `i` entries past the
+///    end of the input list; threads past the free count do nothing. The
+///    counters are left alone, so which thread gets which slot does not
+///    depend on scheduling and a seed reproduces the same particles. A
+///    single-thread commit then moves both counters by the emitted count.
+/// 2. Prepare, one thread: clear the output count and write the simulate
+///    dispatch for the input count.
+/// 3. Simulate, dispatched indirectly: survivors are appended to the output
+///    list and write their instance at the same index; expired slots are
+///    pushed back on the free stack.
+/// 4. Finalize, one thread: write the draw arguments for the output count.
+///
+/// Every slot is always in exactly one of the free stack and the output list.
+/// The functions below are CPU versions of single kernel threads, with each
+/// atomic as a plain read-modify-write, plus whole-step drivers that run the
+/// threads one at a time in a shuffled order. They exist so the scheduling
+/// and the invariants can be tested without a GPU; the struct is only a view
+/// of buffers owned elsewhere.
+typedef struct {
+    SSKParticleLifecycleState *state;
+    /// Two lists of `capacity` slots each.
+    uint32_t *aliveLists[2];
+    /// Free stack of `capacity` slots, popped from the end.
+    uint32_t *freeSlots;
+    uint32_t capacity;
+} SSKParticleLifecycle;
+
+/// Fills the lists from an `alive` stream: live slots go to list 0 in slot
+/// order and the rest onto the free stack, lowest slot on top. The output
+/// count and the draw arguments are set as if a step had just finished.
+void SSKParticleLifecycleLoad(SSKParticleLifecycle *lifecycle, const uint32_t *aliveFlags);
+
+/// Emit thread `thread`: claims its free slot into `outSlot` and places it
+/// after the end of `list`. Returns false when the free stack is too short.
+bool SSKParticleLifecycleEmitThread(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t thread,
+                                    uint32_t *outSlot);
+
+/// Commit thread, run after an emit dispatch of `count` threads. Returns how
+/// many were emitted, `min(count, freeCount)`.
+uint32_t SSKParticleLifecycleCommitEmission(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t count);
+
+/// Prepare thread, run between emission and simulation.
+void SSKParticleLifecyclePrepare(SSKParticleLifecycle *lifecycle, uint32_t list);
+
+/// Slot a simulate thread works on, or `SSKParticleLifecycleNoSlot` for the
+/// tail threads of the last threadgroup.
+uint32_t SSKParticleLifecycleSlotForThread(const SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t thread);
+
+/// Simulate thread, survivor: appends `slot` to the output list of `list` and
+/// returns its index there, where its instance goes.
+uint32_t SSKParticleLifecycleKeep(SSKParticleLifecycle *lifecycle, uint32_t list, uint32_t slot);
+
+/// Simulate thread, expired: pushes `slot` back on the free stack.
+void SSKParticleLifecycleRelease(SSKParticleLifecycle *lifecycle, uint32_t slot);
+
+/// Finalize thread, run after simulation.
+void SSKParticleLifecycleFinalize(SSKParticleLifecycle *lifecycle, uint32_t list);
+
+/// Runs `count` emit threads against `core` and the commit, initialising each
+/// claimed slot with `SSKParticleEmitterWriteSlot` and a generator seeded from
+/// `seed` plus the thread index (the kernel does the same). Threads run in an
+/// order drawn from `schedule`, or in index order when it is NULL. Returns how
+/// many particles were emitted.
+uint32_t SSKParticleLifecycleEmit(SSKParticleLifecycle *lifecycle, SSKParticleCore *core, uint32_t list,
+                                  const SSKParticleEmitter *emitter, uint32_t count, uint64_t seed,
+                                  SSKRandom *schedule);
+
+/// Runs prepare, every simulate thread of the indirect dispatch (stepping each
+/// slot with `SSKParticleCoreAdvanceSlots`) and finalize. Survivors' instances
+/// are written to `instances`, which must hold `capacity` entries. Threads run
+/// in an order drawn from `schedule`, or in index order when it is NULL.
+/// Returns the list the next step reads.
+uint32_t SSKParticleLifecycleSimulate(SSKParticleLifecycle *lifecycle, SSKParticleCore *core, uint32_t list,
+                                      const SSKParticleSimParams *params, const SSKParticleInstanceStyle *style,
+                                      SSKParticleInstance *instances, SSKRandom *schedule);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleLifecycle_h */
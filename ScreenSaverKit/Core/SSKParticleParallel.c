@@ -0,0 +1,140 @@
+#include "SSKParticleParallel.h"
+#include "SSKParticleSIMD.h"
+
+#include <stdlib.h>
+
+typedef struct {
+    SSKParticleParallel *parallel;
+    SSKParticleCore *core;
+    const SSKParticleSimParams *params;
+    uint32_t end;
+} SSKParticleParallelJob;
+
+static void SSKParticleParallelRunChunk(void *context, uint32_t chunk, uint32_t worker) {
+    (void)worker;
+    SSKParticleParallelJob *job = context;
+    uint32_t begin = chunk * SSKParticleParallelChunkSize;
+    uint32_t end = begin + SSKParticleParallelChunkSize;
+    if (end > job->end) {
+        end = job->end;
+    }
+    job->parallel->deadCounts[chunk] = SSKParticleSIMDAdvanceRange(job->core, job->params, job->core->simdLevel,
+                                                                   begin, end, job->parallel->deadSlots + begin);
+}
+
+SSKParticleParallel *SSKParticleParallelCreate(uint32_t capacity, uint32_t workerCount) {
+    if (capacity == 0) { return NULL; }
+    SSKParticleParallel *parallel = calloc(1, sizeof(SSKParticleParallel));
+    if (!parallel) { return NULL; }
+
+    uint32_t padded = SSKParticleCorePaddedCapacity(capacity);
+    parallel->serialThreshold = SSKParticleParallelDefaultSerialThreshold;
+    parallel->chunkCapacity = (padded + SSKParticleParallelChunkSize - 1) / SSKParticleParallelChunkSize;
+    parallel->deadSlots = malloc(sizeof(uint32_t) * padded);
+    parallel->deadCounts = calloc(parallel->chunkCapacity, sizeof(uint32_t));
+    parallel->pool = SSKTaskPoolCreate(workerCount);
+    if (!parallel->deadSlots || !parallel->deadCounts || !parallel->pool) {
+        SSKParticleParallelDestroy(parallel);
+        return NULL;
+    }
+    return parallel;
+}
+
+void SSKParticleParallelDestroy(SSKParticleParallel *parallel) {
+    if (!parallel) { return; }
+    SSKTaskPoolDestroy(parallel->pool);
+    free(parallel->deadSlots);
+    free(parallel->deadCounts);
+    free(parallel);
+}
+
+void SSKParticleParallelAdvance(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                const SSKParticleSimParams *params) {
+    if (!core || !params || params->dt <= 0.0f) { return; }
+    uint32_t end = SSKParticleCorePaddedCapacity(core->highWater);
+    uint32_t chunkCount = (end + SSKParticleParallelChunkSize - 1) / SSKParticleParallelChunkSize;
+    if (!parallel || chunkCount > parallel->chunkCapacity) {
+        SSKParticleCoreAdvance(core, params);
+        return;
+    }
+
+    SSKParticleParallelJob job = { parallel, core, params, end };
+    if (core->aliveCount < parallel->serialThreshold || chunkCount < 2) {
+        // Same chunks, kernel and merge as the pool, so staying on this
+        // thread never changes the result.
+        for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+            SSKParticleParallelRunChunk(&job, chunk, 0);
+        }
+    } else {
+        SSKTaskPoolParallelFor(parallel->pool, chunkCount, SSKParticleParallelRunChunk, &job);
+    }
+
+    // Merge the per-chunk dead lists in chunk order. Only this thread touches
+    // the allocator, and the order does not depend on which worker ran what.
+    uint32_t deadTotal = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+        const uint32_t *dead = parallel->deadSlots + chunk * SSKParticleParallelChunkSize;
+        deadTotal += SSKSlotAllocatorRelease(&core->slots, dead, parallel->deadCounts[chunk]);
+    }
+    if (deadTotal == 0) { return; }
+
+    // Drop the retired slots from the alive list, keeping spawn order.
+    uint32_t *list = core->aliveList;
+    uint32_t kept = 0;
+    uint32_t highWater = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = list[i];
+        if (core->alive[slot]) {
+            list[kept++] = slot;
+            if (slot >= highWater) { highWater = slot + 1; }
+        }
+    }
+    core->aliveCount = kept;
+    core->highWater = highWater;
+}
+
+typedef void (*SSKParticleParallelFieldFunction)(SSKParticleCore *core, const SSKForceFieldParams *params,
+                                                 uint32_t begin, uint32_t end);
+
+typedef struct {
+    SSKParticleCore *core;
+    const SSKForceFieldParams *params;
+    SSKParticleParallelFieldFunction function;
+    uint32_t end;
+} SSKParticleParallelFieldJob;
+
+static void SSKParticleParallelRunFieldChunk(void *context, uint32_t chunk, uint32_t worker) {
+    (void)worker;
+    SSKParticleParallelFieldJob *job = context;
+    uint32_t begin = chunk * SSKParticleParallelChunkSize;
+    uint32_t end = begin + SSKParticleParallelChunkSize;
+    if (end > job->end) {
+        end = job->end;
+    }
+    job->function(job->core, job->params, begin, end);
+}
+
+static void SSKParticleParallelRunFields(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                         const SSKForceFieldParams *params,
+                                         SSKParticleParallelFieldFunction function) {
+    if (!core || !params || params->count == 0) { return; }
+    uint32_t end = core->highWater;
+    uint32_t chunkCount = (end + SSKParticleParallelChunkSize - 1) / SSKParticleParallelChunkSize;
+    if (!parallel || core->aliveCount < parallel->serialThreshold || chunkCount < 2) {
+        function(core, params, 0, end);
+        return;
+    }
+    // Fields only touch their own slots, so chunks need no merge step.
+    SSKParticleParallelFieldJob job = { core, params, function, end };
+    SSKTaskPoolParallelFor(parallel->pool, chunkCount, SSKParticleParallelRunFieldChunk, &job);
+}
+
+void SSKParticleParallelApplyForceFields(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                         const SSKForceFieldParams *params) {
+    SSKParticleParallelRunFields(parallel, core, params, SSKParticleCoreApplyForceFields);
+}
+
+void SSKParticleParallelResolveForceFieldBounds(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                                const SSKForceFieldParams *params) {
+    SSKParticleParallelRunFields(parallel, core, params, SSKParticleCoreResolveForceFieldBounds);
+}
@@ -0,0 +1,65 @@
+#ifndef SSKParticleParallel_h
+#define SSKParticleParallel_h
+
+#include <stdint.h>
+
+#include "SSKForceField.h"
+#include "SSKParticleCore.h"
+#include "SSKTaskPool.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Slots per chunk. A multiple of every SIMD width, and large enough (about
+/// 400 KB of streams) that claiming a chunk is noise next to simulating it.
+enum { SSKParticleParallelChunkSize = 4096 };
+
+/// Below this many live particles `SSKParticleParallelAdvance` runs its chunks
+/// on the calling thread.
+enum { SSKParticleParallelDefaultSerialThreshold = 16384 };
+
+/// Runs `SSKParticleCore` steps in fixed-size slot chunks on a task pool.
+///
+/// Chunk boundaries depend only on the slot range, never on the worker count,
+/// and each chunk writes only its own slots plus its own slice of the dead
+/// buffer. Dead slots are released to the slot allocator in chunk order after
+/// the join, so the result is identical for any number of workers.
+typedef struct SSKParticleParallel {
+    SSKTaskPool *pool;
+    uint32_t serialThreshold;
+
+    /// Dead slots per chunk; chunk `c` writes from `c * SSKParticleParallelChunkSize`.
+    uint32_t *deadSlots;
+    /// Dead count per chunk.
+    uint32_t *deadCounts;
+    uint32_t chunkCapacity;
+} SSKParticleParallel;
+
+/// Creates a scheduler for cores of up to `capacity` particles with
+/// `workerCount` participants (0 = one per CPU). Returns NULL on failure.
+SSKParticleParallel *SSKParticleParallelCreate(uint32_t capacity, uint32_t workerCount);
+
+void SSKParticleParallelDestroy(SSKParticleParallel *parallel);
+
+/// Advances `core` by one step: every chunk runs the `core->simdLevel` kernel
+/// and dead slots are released in slot order. Chunks run concurrently unless
+/// fewer than `serialThreshold` particles are alive or the range fits in a
+/// single chunk, in which case they run on the calling thread with the same
+/// result. With a NULL `parallel` (or a core larger than it was created for)
+/// this is `SSKParticleCoreAdvance`, whose results differ in rounding and slot
+/// reuse. `aliveList` must agree with the `alive` stream on entry (it always does on
+/// the CPU path; call `SSKParticleCoreRebuildAliveList` after GPU updates).
+void SSKParticleParallelAdvance(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                const SSKParticleSimParams *params);
+
+/// `SSKParticleCoreApplyForceFields` over every live slot, split into the
+/// same chunks as `SSKParticleParallelAdvance` and under the same threshold.
+void SSKParticleParallelApplyForceFields(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                         const SSKForceFieldParams *params);
+
+/// `SSKParticleCoreResolveForceFieldBounds` over every live slot, chunked the same way.
+void SSKParticleParallelResolveForceFieldBounds(SSKParticleParallel *parallel, SSKParticleCore *core,
+                                                const SSKForceFieldParams *params);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleParallel_h */
@@ -0,0 +1,313 @@
+#include "SSKParticleRaster.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The quad and fragment maths mirror `particleVertex` / `particleFragment` in
+// SSKParticleShaders.metal; keep them in sync.
+
+/// One instance set up in pixel space. At the pixel centre (x, y) the quad
+/// coordinate (`quad` in the shader, within [-0.5, 0.5) on both axes inside
+/// the quad) is `(ax * x + ay * y + a0, bx * x + by * y + b0)`.
+typedef struct SSKParticleRasterQuad {
+    float ax, ay, a0;
+    float bx, by, b0;
+    SSKFloat4 color;
+    float softness;
+    /// Pixel bounds clipped to the target, `[x0, x1) x [y0, y1)`.
+    int32_t x0, y0, x1, y1;
+} SSKParticleRasterQuad;
+
+void SSKParticleRasterizerInit(SSKParticleRasterizer *rasterizer, uint32_t tileSize) {
+    memset(rasterizer, 0, sizeof(*rasterizer));
+    rasterizer->tileSize = tileSize > 0 ? tileSize : SSKParticleRasterDefaultTileSize;
+}
+
+void SSKParticleRasterizerDestroy(SSKParticleRasterizer *rasterizer) {
+    if (!rasterizer) { return; }
+    free(rasterizer->quads);
+    free(rasterizer->binStart);
+    free(rasterizer->binEntries);
+    uint32_t tileSize = rasterizer->tileSize;
+    memset(rasterizer, 0, sizeof(*rasterizer));
+    rasterizer->tileSize = tileSize;
+}
+
+/// Grows `*buffer` to hold at least `needed` elements of `size` bytes.
+static bool SSKRasterReserve(void **buffer, uint32_t *capacity, uint32_t needed, size_t size) {
+    if (needed <= *capacity) { return true; }
+    uint32_t grown = *capacity > 0 ? *capacity : 64;
+    while (grown < needed) {
+        grown = grown > UINT32_MAX / 2 ? needed : grown * 2;
+    }
+    void *resized = realloc(*buffer, size * grown);
+    if (!resized) { return false; }
+    *buffer = resized;
+    *capacity = grown;
+    return true;
+}
+
+/// Clamps to [0, 1] and rounds to 8 bits. Non-negative, so truncation is
+/// floor without a libm call.
+static inline uint8_t SSKRasterToUnorm8(float value) {
+    value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    return (uint8_t)(int32_t)(value * 255.0f + 0.5f);
+}
+
+void SSKRasterTargetClear(const SSKRasterTarget *target, SSKFloat4 color) {
+    if (!target || !target->pixels) { return; }
+    uint8_t *row = target->pixels;
+    if (target->format == SSKRasterFormatRGBA8) {
+        uint8_t rgba[4] = {SSKRasterToUnorm8(color.x), SSKRasterToUnorm8(color.y), SSKRasterToUnorm8(color.z),
+                           SSKRasterToUnorm8(color.w)};
+        for (uint32_t y = 0; y < target->height; y++, row += target->rowBytes) {
+            for (uint32_t x = 0; x < target->width; x++) { memcpy(row + x * 4, rgba, 4); }
+        }
+    } else {
+        for (uint32_t y = 0; y < target->height; y++, row += target->rowBytes) {
+            SSKFloat4 *pixels = (SSKFloat4 *)(void *)row;
+            for (uint32_t x = 0; x < target->width; x++) { pixels[x] = color; }
+        }
+    }
+}
+
+static inline int32_t SSKRasterClampPixel(double value, int32_t limit) {
+    if (!(value > 0.0)) { return 0; }
+    if (value >= (double)limit) { return limit; }
+    return (int32_t)value;
+}
+
+/// Pixel-space setup for one instance; leaves the bounds empty when the quad
+/// is degenerate or off-target.
+static void SSKRasterSetupQuad(SSKParticleRasterQuad *quad, const SSKParticleInstance *instance,
+                               const SSKRasterTarget *target, const SSKParticleRasterParams *params) {
+    quad->x0 = quad->y0 = quad->x1 = quad->y1 = 0;
+    float width = instance->width;
+    float length = instance->length;
+    if (!(width > 0.0f) || !(length > 0.0f) || !isfinite(width) || !isfinite(length) ||
+        !isfinite(instance->position.x) || !isfinite(instance->position.y)) {
+        return;
+    }
+    double dirLength = sqrt((double)instance->direction.x * instance->direction.x +
+                            (double)instance->direction.y * instance->direction.y);
+    double fx = instance->direction.x / dirLength;
+    double fy = instance->direction.y / dirLength;
+    if (!isfinite(fx) || !isfinite(fy)) {
+        fx = 1.0;
+        fy = 0.0;
+    }
+    double rx = -fy, ry = fx;
+
+    // Particle units per pixel, and the pixel position of the quad centre.
+    double kx = (double)params->size.x / target->width;
+    double ky = (double)params->size.y / target->height;
+    double ox = (double)params->origin.x - instance->position.x;
+    double oy = (double)params->origin.y - instance->position.y;
+    quad->ax = (float)(rx * kx / width);
+    quad->ay = (float)(ry * ky / width);
+    quad->a0 = (float)((rx * ox + ry * oy) / width);
+    quad->bx = (float)(fx * kx / length);
+    quad->by = (float)(fy * ky / length);
+    quad->b0 = (float)((fx * ox + fy * oy) / length);
+    quad->color = instance->color;
+    quad->softness = instance->softness;
+
+    // Bounds of the four corners, padded a pixel for rounding; the per-pixel
+    // test is exact.
+    double halfX = fabs(rx) * width * 0.5 + fabs(fx) * length * 0.5;
+    double halfY = fabs(ry) * width * 0.5 + fabs(fy) * length * 0.5;
+    double cx = -ox / kx, cy = -oy / ky;
+    double ex = halfX / kx, ey = halfY / ky;
+    quad->x0 = SSKRasterClampPixel(floor(cx - ex) - 1.0, (int32_t)target->width);
+    quad->x1 = SSKRasterClampPixel(ceil(cx + ex) + 1.0, (int32_t)target->width);
+    quad->y0 = SSKRasterClampPixel(floor(cy - ey) - 1.0, (int32_t)target->height);
+    quad->y1 = SSKRasterClampPixel(ceil(cy + ey) + 1.0, (int32_t)target->height);
+}
+
+typedef struct {
+    SSKParticleRasterizer *rasterizer;
+    const SSKRasterTarget *target;
+    SSKRasterBlend blend;
+    uint32_t columns;
+} SSKRasterJob;
+
+/// Columns `[*begin, *end)` of the row where `offset + step * (x + 0.5)` may
+/// lie in [-0.5, 0.5], padded by a pixel either side.
+static inline void SSKRasterNarrowSpan(float step, float offset, int32_t *begin, int32_t *end) {
+    if (fabsf(step) < 1e-12f) {
+        if (!(offset >= -0.5f && offset < 0.5f)) { *end = *begin; }
+        return;
+    }
+    float a = (-0.5f - offset) / step - 0.5f;
+    float b = (0.5f - offset) / step - 0.5f;
+    float lo = fminf(a, b), hi = fmaxf(a, b);
+    if (lo - 1.0f > (float)*begin) { *begin = lo - 1.0f < (float)*end ? (int32_t)(lo - 1.0f) : *end; }
+    if (hi + 2.0f < (float)*end) { *end = hi + 2.0f > (float)*begin ? (int32_t)(hi + 2.0f) : *begin; }
+}
+
+/// Shades and blends columns `[x0, x1)` of pixel row `y` for one quad. Always
+/// inlined with constant `format` and `blend`, so each combination gets its
+/// own branch-free inner loop.
+static inline __attribute__((always_inline)) void SSKRasterShadeSpan(const SSKParticleRasterQuad *quad, uint8_t *row,
+                                                                     int32_t x0, int32_t x1, float rowA, float rowB,
+                                                                     SSKRasterFormat format, SSKRasterBlend blend) {
+    bool soft = quad->softness > 0.01f;
+    float falloff = -quad->softness * 4.0f;
+    SSKFloat4 color = quad->color;
+    for (int32_t x = x0; x < x1; x++) {
+        float px = (float)x + 0.5f;
+        float qa = quad->ax * px + rowA;
+        float qb = quad->bx * px + rowB;
+        if (!(qa >= -0.5f && qa < 0.5f && qb >= -0.5f && qb < 0.5f)) { continue; }
+        float alpha = color.w;
+        if (soft) {
+            alpha *= expf(falloff * (qa * qa + qb * qb));
+        }
+        SSKFloat4 d;
+        uint8_t *unorm = row + (size_t)x * 4;
+        SSKFloat4 *wide = (SSKFloat4 *)(void *)row + x;
+        if (format == SSKRasterFormatRGBA8) {
+            d = (SSKFloat4){unorm[0] * (1.0f / 255.0f), unorm[1] * (1.0f / 255.0f), unorm[2] * (1.0f / 255.0f),
+                            unorm[3] * (1.0f / 255.0f)};
+        } else {
+            d = *wide;
+        }
+        if (blend == SSKRasterBlendAdditive) {
+            d.x += color.x;
+            d.y += color.y;
+            d.z += color.z;
+            d.w += alpha;
+        } else {
+            float inverse = 1.0f - alpha;
+            d.x = color.x * alpha + d.x * inverse;
+            d.y = color.y * alpha + d.y * inverse;
+            d.z = color.z * alpha + d.z * inverse;
+            d.w = alpha * alpha + d.w * inverse;
+        }
+        if (format == SSKRasterFormatRGBA8) {
+            unorm[0] = SSKRasterToUnorm8(d.x);
+            unorm[1] = SSKRasterToUnorm8(d.y);
+            unorm[2] = SSKRasterToUnorm8(d.z);
+            unorm[3] = SSKRasterToUnorm8(d.w);
+        } else {
+            *wide = d;
+        }
+    }
+}
+
+/// Blends every quad binned to `tile`, in submission order, straight into
+/// the target. A tile of the target fits in L1/L2, so there is no separate
+/// tile buffer to load and store back.
+static void SSKRasterShadeTile(void *context, uint32_t tile, uint32_t worker) {
+    (void)worker;
+    SSKRasterJob *job = context;
+    SSKParticleRasterizer *rasterizer = job->rasterizer;
+    const SSKRasterTarget *target = job->target;
+    uint32_t tileSize = rasterizer->tileSize;
+    int32_t tx0 = (int32_t)((tile % job->columns) * tileSize);
+    int32_t ty0 = (int32_t)((tile / job->columns) * tileSize);
+    int32_t tx1 = tx0 + (int32_t)tileSize < (int32_t)target->width ? tx0 + (int32_t)tileSize : (int32_t)target->width;
+    int32_t ty1 = ty0 + (int32_t)tileSize < (int32_t)target->height ? ty0 + (int32_t)tileSize : (int32_t)target->height;
+
+    for (uint32_t e = rasterizer->binStart[tile]; e < rasterizer->binStart[tile + 1]; e++) {
+        const SSKParticleRasterQuad *quad = &rasterizer->quads[rasterizer->binEntries[e]];
+        int32_t y0 = quad->y0 > ty0 ? quad->y0 : ty0;
+        int32_t y1 = quad->y1 < ty1 ? quad->y1 : ty1;
+        for (int32_t y = y0; y < y1; y++) {
+            float py = (float)y + 0.5f;
+            float rowA = quad->ay * py + quad->a0;
+            float rowB = quad->by * py + quad->b0;
+            int32_t x0 = quad->x0 > tx0 ? quad->x0 : tx0;
+            int32_t x1 = quad->x1 < tx1 ? quad->x1 : tx1;
+            SSKRasterNarrowSpan(quad->ax, rowA, &x0, &x1);
+            SSKRasterNarrowSpan(quad->bx, rowB, &x0, &x1);
+            uint8_t *row = (uint8_t *)target->pixels + (size_t)y * target->rowBytes;
+            if (target->format == SSKRasterFormatRGBA8) {
+                if (job->blend == SSKRasterBlendAdditive) {
+                    SSKRasterShadeSpan(quad, row, x0, x1, rowA, rowB, SSKRasterFormatRGBA8, SSKRasterBlendAdditive);
+                } else {
+                    SSKRasterShadeSpan(quad, row, x0, x1, rowA, rowB, SSKRasterFormatRGBA8, SSKRasterBlendAlpha);
+                }
+            } else {
+                if (job->blend == SSKRasterBlendAdditive) {
+                    SSKRasterShadeSpan(quad, row, x0, x1, rowA, rowB, SSKRasterFormatFloat, SSKRasterBlendAdditive);
+                } else {
+                    SSKRasterShadeSpan(quad, row, x0, x1, rowA, rowB, SSKRasterFormatFloat, SSKRasterBlendAlpha);
+                }
+            }
+        }
+    }
+}
+
+bool SSKParticleRasterizerDraw(SSKParticleRasterizer *rasterizer, SSKTaskPool *pool,
+                               const SSKRasterTarget *target, const SSKParticleRasterParams *params,
+                               const SSKParticleInstance *instances, uint32_t count) {
+    if (!rasterizer || !target || !target->pixels || !params || target->width == 0 || target->height == 0 ||
+        !(params->size.x > 0.0f) || !(params->size.y > 0.0f)) {
+        return true;
+    }
+    if (count == 0) { return true; }
+    uint32_t tileSize = rasterizer->tileSize;
+    uint32_t columns = (target->width + tileSize - 1) / tileSize;
+    uint32_t rows = (target->height + tileSize - 1) / tileSize;
+    uint32_t tileCount = columns * rows;
+
+    if (!SSKRasterReserve((void **)&rasterizer->quads, &rasterizer->quadCapacity, count,
+                          sizeof(SSKParticleRasterQuad)) ||
+        !SSKRasterReserve((void **)&rasterizer->binStart, &rasterizer->tileCapacity, tileCount + 1,
+                          sizeof(uint32_t))) {
+        return false;
+    }
+
+    // Set up every quad and count its tiles.
+    uint32_t *binStart = rasterizer->binStart;
+    memset(binStart, 0, sizeof(uint32_t) * (tileCount + 1));
+    uint64_t entries = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        SSKParticleRasterQuad *quad = &rasterizer->quads[i];
+        SSKRasterSetupQuad(quad, &instances[i], target, params);
+        if (quad->x0 >= quad->x1 || quad->y0 >= quad->y1) { continue; }
+        uint32_t cx0 = (uint32_t)quad->x0 / tileSize, cx1 = (uint32_t)(quad->x1 - 1) / tileSize;
+        uint32_t cy0 = (uint32_t)quad->y0 / tileSize, cy1 = (uint32_t)(quad->y1 - 1) / tileSize;
+        for (uint32_t cy = cy0; cy <= cy1; cy++) {
+            for (uint32_t cx = cx0; cx <= cx1; cx++) { binStart[cy * columns + cx]++; }
+        }
+        entries += (uint64_t)(cx1 - cx0 + 1) * (cy1 - cy0 + 1);
+    }
+    if (entries > UINT32_MAX ||
+        !SSKRasterReserve((void **)&rasterizer->binEntries, &rasterizer->entryCapacity, (uint32_t)entries,
+                          sizeof(uint32_t))) {
+        return false;
+    }
+
+    // Prefix sum, then scatter in instance order so every tile blends its
+    // instances in submission order (the same shift trick as SSKSpatialGrid).
+    uint32_t running = 0;
+    for (uint32_t t = 0; t < tileCount; t++) {
+        uint32_t tileEntries = binStart[t];
+        binStart[t] = running;
+        running += tileEntries;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const SSKParticleRasterQuad *quad = &rasterizer->quads[i];
+        if (quad->x0 >= quad->x1 || quad->y0 >= quad->y1) { continue; }
+        uint32_t cx0 = (uint32_t)quad->x0 / tileSize, cx1 = (uint32_t)(quad->x1 - 1) / tileSize;
+        uint32_t cy0 = (uint32_t)quad->y0 / tileSize, cy1 = (uint32_t)(quad->y1 - 1) / tileSize;
+        for (uint32_t cy = cy0; cy <= cy1; cy++) {
+            for (uint32_t cx = cx0; cx <= cx1; cx++) {
+                rasterizer->binEntries[binStart[cy * columns + cx]++] = i;
+            }
+        }
+    }
+    memmove(binStart + 1, binStart, sizeof(uint32_t) * tileCount);
+    binStart[0] = 0;
+
+    SSKRasterJob job = {rasterizer, target, params->blend, columns};
+    if (!pool || SSKTaskPoolWorkerCount(pool) < 2 || tileCount < 2) {
+        for (uint32_t t = 0; t < tileCount; t++) { SSKRasterShadeTile(&job, t, 0); }
+    } else {
+        SSKTaskPoolParallelFor(pool, tileCount, SSKRasterShadeTile, &job);
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+#ifndef SSKParticleRaster_h
+#define SSKParticleRaster_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKParticleInstances.h"
+#include "SSKTaskPool.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+typedef enum {
+    /// 8-bit RGBA, one `uint8_t[4]` per pixel. Every blend is clamped to
+    /// [0, 1] and rounded to 8 bits, as a unorm render target would.
+    SSKRasterFormatRGBA8 = 0,
+    /// 32-bit float RGBA, one `SSKFloat4` per pixel. Blends are not clamped.
+    SSKRasterFormatFloat,
+} SSKRasterFormat;
+
+/// Caller-owned framebuffer. Row 0 is the top row.
+typedef struct {
+    void *pixels;
+    uint32_t width;
+    uint32_t height;
+    size_t rowBytes;
+    SSKRasterFormat format;
+} SSKRasterTarget;
+
+typedef enum {
+    /// `src * srcAlpha + dst * (1 - srcAlpha)`, the alpha pipeline of `SSKMetalParticlePass`.
+    SSKRasterBlendAlpha = 0,
+    /// `src + dst`, the additive pipeline.
+    SSKRasterBlendAdditive,
+} SSKRasterBlend;
+
+/// Maps particle space onto a target, like the `viewport` argument of
+/// `particleVertex`: `origin` lands on the top-left corner of the target and
+/// `size` spans all of it, so the target may be larger than the viewport
+/// (e.g. a Retina backing store).
+typedef struct {
+    SSKFloat2 origin;
+    SSKFloat2 size;
+    SSKRasterBlend blend;
+} SSKParticleRasterParams;
+
+/// Tiled software rasterizer for particle quads.
+///
+/// Reproduces `particleVertex` and `particleFragment` from
+/// `SSKParticleShaders.metal`: each `SSKParticleInstance` becomes an oriented
+/// quad, pixels whose centre lies inside it get the instance colour with the
+/// same Gaussian softness falloff, and the result is blended like the Metal
+/// pipelines. Instances are binned into square tiles in submission order and
+/// tiles are shaded independently (in parallel when a pool is supplied), so
+/// every pixel sees the same blend sequence whatever the tile or worker count
+/// and the output is deterministic.
+///
+/// Runs headless on any platform: it is the CPU fallback for
+/// `-[SSKParticleSystem drawInContext:]` and a reference renderer for tests.
+typedef struct {
+    uint32_t tileSize;
+
+    /// Per-instance pixel-space setup, `quadCapacity` entries.
+    struct SSKParticleRasterQuad *quads;
+    uint32_t quadCapacity;
+
+    /// Tile bins: tile `t` owns `binEntries[binStart[t] ..< binStart[t + 1]]`.
+    uint32_t *binStart;
+    uint32_t tileCapacity;
+    uint32_t *binEntries;
+    uint32_t entryCapacity;
+} SSKParticleRasterizer;
+
+/// Default tile edge in pixels: a tile of the target stays in L2 while it is shaded.
+enum { SSKParticleRasterDefaultTileSize = 64 };
+
+/// `tileSize` of 0 means `SSKParticleRasterDefaultTileSize`. Bins grow on
+/// demand, so Init only records the tile size.
+void SSKParticleRasterizerInit(SSKParticleRasterizer *rasterizer, uint32_t tileSize);
+
+void SSKParticleRasterizerDestroy(SSKParticleRasterizer *rasterizer);
+
+/// Fills every pixel of `target` with `color`.
+void SSKRasterTargetClear(const SSKRasterTarget *target, SSKFloat4 color);
+
+/// Blends `count` instances into `target` in order. `pool` may be NULL to run
+/// on the calling thread. Returns false (leaving `target` untouched) if
+/// scratch storage could not be allocated.
+bool SSKParticleRasterizerDraw(SSKParticleRasterizer *rasterizer, SSKTaskPool *pool,
+                               const SSKRasterTarget *target, const SSKParticleRasterParams *params,
+                               const SSKParticleInstance *instances, uint32_t count);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleRaster_h */
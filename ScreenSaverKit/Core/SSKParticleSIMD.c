@@ -0,0 +1,103 @@
+#include "SSKParticleSIMD.h"
+
+#include <string.h>
+
+// Each ISA instantiates SSKParticleSIMDKernel.inc once. The kernel is written
+// with GCC/Clang vector extensions, so the per-ISA part is only the lane count,
+// the target attribute and the constant shuffle patterns (which must be
+// literal). Every helper inside the include carries the same target attribute
+// so it inlines into the kernel instead of tripping an ABI mismatch.
+
+#if defined(__x86_64__)
+
+#define SSK_SIMD_WIDTH 4
+#define SSK_SIMD_SUFFIX SSE2
+#define SSK_SIMD_TARGET __attribute__((target("sse2")))
+#define SSK_SIMD_EVEN(a, b) __builtin_shufflevector(a, b, 0, 2, 4, 6)
+#define SSK_SIMD_ODD(a, b) __builtin_shufflevector(a, b, 1, 3, 5, 7)
+#define SSK_SIMD_DUP_LO(v) __builtin_shufflevector(v, v, 0, 0, 1, 1)
+#define SSK_SIMD_DUP_HI(v) __builtin_shufflevector(v, v, 2, 2, 3, 3)
+#include "SSKParticleSIMDKernel.inc"
+
+#define SSK_SIMD_WIDTH 8
+#define SSK_SIMD_SUFFIX AVX2
+#define SSK_SIMD_TARGET __attribute__((target("avx2,fma")))
+#define SSK_SIMD_EVEN(a, b) __builtin_shufflevector(a, b, 0, 2, 4, 6, 8, 10, 12, 14)
+#define SSK_SIMD_ODD(a, b) __builtin_shufflevector(a, b, 1, 3, 5, 7, 9, 11, 13, 15)
+#define SSK_SIMD_DUP_LO(v) __builtin_shufflevector(v, v, 0, 0, 1, 1, 2, 2, 3, 3)
+#define SSK_SIMD_DUP_HI(v) __builtin_shufflevector(v, v, 4, 4, 5, 5, 6, 6, 7, 7)
+#include "SSKParticleSIMDKernel.inc"
+
+#define SSK_SIMD_WIDTH 16
+#define SSK_SIMD_SUFFIX AVX512
+#define SSK_SIMD_TARGET __attribute__((target("avx512f")))
+#define SSK_SIMD_EVEN(a, b) __builtin_shufflevector(a, b, 0, 2, 4, 6, 8, 10, 12, 14, \
+                                                    16, 18, 20, 22, 24, 26, 28, 30)
+#define SSK_SIMD_ODD(a, b) __builtin_shufflevector(a, b, 1, 3, 5, 7, 9, 11, 13, 15, \
+                                                   17, 19, 21, 23, 25, 27, 29, 31)
+#define SSK_SIMD_DUP_LO(v) __builtin_shufflevector(v, v, 0, 0, 1, 1, 2, 2, 3, 3, \
+                                                   4, 4, 5, 5, 6, 6, 7, 7)
+#define SSK_SIMD_DUP_HI(v) __builtin_shufflevector(v, v, 8, 8, 9, 9, 10, 10, 11, 11, \
+                                                   12, 12, 13, 13, 14, 14, 15, 15)
+#include "SSKParticleSIMDKernel.inc"
+
+#endif
+
+#if defined(__aarch64__)
+
+#define SSK_SIMD_WIDTH 4
+#define SSK_SIMD_SUFFIX NEON
+#define SSK_SIMD_TARGET
+#define SSK_SIMD_EVEN(a, b) __builtin_shufflevector(a, b, 0, 2, 4, 6)
+#define SSK_SIMD_ODD(a, b) __builtin_shufflevector(a, b, 1, 3, 5, 7)
+#define SSK_SIMD_DUP_LO(v) __builtin_shufflevector(v, v, 0, 0, 1, 1)
+#define SSK_SIMD_DUP_HI(v) __builtin_shufflevector(v, v, 2, 2, 3, 3)
+#include "SSKParticleSIMDKernel.inc"
+
+#endif
+
+typedef uint32_t (*SSKParticleSIMDKernel)(SSKParticleCore *core, const SSKParticleSimParams *params,
+                                          uint32_t begin, uint32_t end, uint32_t *deadSlots);
+
+static SSKParticleSIMDKernel SSKParticleSIMDKernelForLevel(SSKSIMDLevel level) {
+    switch (level) {
+#if defined(__x86_64__)
+        case SSKSIMDLevelSSE2:   return SSKParticleSIMDAdvanceRangeSSE2;
+        case SSKSIMDLevelAVX2:   return SSKParticleSIMDAdvanceRangeAVX2;
+        case SSKSIMDLevelAVX512: return SSKParticleSIMDAdvanceRangeAVX512;
+#endif
+#if defined(__aarch64__)
+        case SSKSIMDLevelNEON:   return SSKParticleSIMDAdvanceRangeNEON;
+#endif
+        default:                 return NULL;
+    }
+}
+
+uint32_t SSKParticleSIMDAdvanceRange(SSKParticleCore *core, const SSKParticleSimParams *params,
+                                     SSKSIMDLevel level, uint32_t begin, uint32_t end, uint32_t *deadSlots) {
+    SSKParticleSIMDKernel kernel = SSKSIMDLevelIsSupported(level) ? SSKParticleSIMDKernelForLevel(level) : NULL;
+    uint32_t width = SSKSIMDLevelWidth(level);
+    if (!kernel || (begin % width) != 0 || (end % width) != 0) {
+        return SSKParticleCoreAdvanceSlots(core, params, begin, end, deadSlots);
+    }
+    return kernel(core, params, begin, end, deadSlots);
+}
+
+bool SSKParticleSIMDAdvance(SSKParticleCore *core, const SSKParticleSimParams *params, SSKSIMDLevel level) {
+    if (!core || !params || params->dt <= 0.0f) { return false; }
+    if (!SSKSIMDLevelIsSupported(level)) { return false; }
+    SSKParticleSIMDKernel kernel = SSKParticleSIMDKernelForLevel(level);
+    if (!kernel) { return false; }
+
+    uint32_t width = SSKSIMDLevelWidth(level);
+    uint32_t end = (core->highWater + width - 1) / width * width;
+    // The sweep also pays for dead lanes below the high-water mark; when more
+    // than half of them are dead the alive-list loops are cheaper.
+    if (core->aliveCount == 0 || (uint64_t)core->aliveCount * 2 < end) {
+        return false;
+    }
+
+    kernel(core, params, 0, end, NULL);
+    SSKParticleCoreCompactAliveList(core);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef SSKParticleSIMD_h
+#define SSKParticleSIMD_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKParticleCore.h"
+#include "SSKSIMD.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Runs one fused simulation step (expire, forces, behaviours, integrate,
+/// directions) with the vector kernel for `level`.
+///
+/// The kernel sweeps slots `[0, highWater)` in lane-sized blocks, using the
+/// `alive` stream as a lane mask, and then compacts `aliveList`. Results match
+/// the scalar phases to within float rounding; liveness is bit-identical.
+///
+/// Returns false without touching the core when the level is scalar or not
+/// supported, or when live slots are too sparse for a sweep to pay off. The
+/// caller should then run the scalar phases.
+bool SSKParticleSIMDAdvance(SSKParticleCore *core, const SSKParticleSimParams *params, SSKSIMDLevel level);
+
+/// Runs the fused step for `level` over slots `[begin, end)` without touching
+/// `aliveList` or the slot allocator, like `SSKParticleCoreAdvanceSlots`. Slots
+/// that expire are written to `deadSlots` (if non-NULL) in ascending order; returns
+/// their count. Falls back to the scalar range loop when the level is not
+/// available or the bounds are not multiples of its width. `end` may extend
+/// up to `SSKParticleCorePaddedCapacity`. Disjoint ranges may run concurrently.
+uint32_t SSKParticleSIMDAdvanceRange(SSKParticleCore *core, const SSKParticleSimParams *params,
+                                     SSKSIMDLevel level, uint32_t begin, uint32_t end, uint32_t *deadSlots);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKParticleSIMD_h */
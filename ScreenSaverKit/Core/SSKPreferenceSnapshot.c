@@ -0,0 +1,74 @@
+#include "SSKPreferenceSnapshot.h"
+
+#include <math.h>
+#include <string.h>
+
+void SSKPreferenceSnapshotInit(SSKPreferenceSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof *snapshot);
+}
+
+/// `value` made valid for `spec`; `fallback` stands in for NaN.
+static double SSKPreferenceSanitize(const SSKPreferenceKeySpec *spec, double value, double fallback) {
+    if (isnan(value)) { value = fallback; }
+    switch (spec->type) {
+        case SSKPreferenceTypeBool:
+            return value != 0.0 ? 1.0 : 0.0;
+        case SSKPreferenceTypeInteger:
+        case SSKPreferenceTypeChoice:
+            value = round(value);
+            break;
+        case SSKPreferenceTypeDouble:
+            break;
+        case SSKPreferenceTypeObject:
+            return 0.0;
+    }
+    return fmin(fmax(value, spec->minimum), spec->maximum);
+}
+
+int32_t SSKPreferenceSnapshotAddKey(SSKPreferenceSnapshot *snapshot, const SSKPreferenceKeySpec *spec) {
+    if (!spec || snapshot->count >= SSKPreferenceSnapshotMaxKeys) { return -1; }
+    uint32_t key = snapshot->count++;
+    SSKPreferenceKeySpec *stored = &snapshot->specs[key];
+    *stored = *spec;
+    if (isnan(stored->minimum)) { stored->minimum = -INFINITY; }
+    if (isnan(stored->maximum)) { stored->maximum = INFINITY; }
+    if (stored->minimum > stored->maximum) {
+        double swap = stored->minimum;
+        stored->minimum = stored->maximum;
+        stored->maximum = swap;
+    }
+    double fallback = isnan(spec->defaultValue) ? fmax(stored->minimum, fmin(0.0, stored->maximum)) : spec->defaultValue;
+    stored->defaultValue = SSKPreferenceSanitize(stored, fallback, fallback);
+    snapshot->values[key] = stored->defaultValue;
+    snapshot->dirty |= UINT64_C(1) << key;
+    return (int32_t)key;
+}
+
+void SSKPreferenceSnapshotBeginIngest(SSKPreferenceSnapshot *snapshot) {
+    snapshot->dirty = 0;
+}
+
+bool SSKPreferenceSnapshotSet(SSKPreferenceSnapshot *snapshot, uint32_t key, double value) {
+    if (key >= snapshot->count) { return false; }
+    const SSKPreferenceKeySpec *spec = &snapshot->specs[key];
+    double sanitized = SSKPreferenceSanitize(spec, value, spec->defaultValue);
+    if (sanitized == snapshot->values[key]) { return false; }
+    snapshot->values[key] = sanitized;
+    snapshot->dirty |= UINT64_C(1) << key;
+    return true;
+}
+
+bool SSKPreferenceSnapshotSetDefault(SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    if (key >= snapshot->count) { return false; }
+    return SSKPreferenceSnapshotSet(snapshot, key, snapshot->specs[key].defaultValue);
+}
+
+void SSKPreferenceSnapshotMarkDirty(SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    if (key >= snapshot->count) { return; }
+    snapshot->dirty |= UINT64_C(1) << key;
+}
+
+uint64_t SSKPreferenceSnapshotEndIngest(SSKPreferenceSnapshot *snapshot) {
+    if (snapshot->dirty) { snapshot->version++; }
+    return snapshot->dirty;
+}
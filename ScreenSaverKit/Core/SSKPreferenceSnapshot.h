@@ -0,0 +1,98 @@
+#ifndef SSKPreferenceSnapshot_h
+#define SSKPreferenceSnapshot_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Typed preference values in a flat array.
+///
+/// Keys are declared once, with a type, default and range, and addressed by
+/// the index they were added at. Values are validated and clamped when they
+/// are ingested, so readers get plain numbers in O(1) with no dictionary
+/// lookups, boxing or per-setter checks. Each ingest batch records which keys
+/// it changed in `dirty` and bumps `version` when any did, so a view can
+/// rebuild only what depends on those keys.
+///
+/// Every value is held as a double: booleans as 0 or 1, integers and choice
+/// indices as whole numbers (exact up to 2^53). Object keys (strings,
+/// colours) keep their values on the Objective-C side; the snapshot only
+/// tracks whether they changed.
+
+enum { SSKPreferenceSnapshotMaxKeys = 64 };
+
+typedef enum {
+    SSKPreferenceTypeBool,
+    SSKPreferenceTypeInteger,
+    SSKPreferenceTypeDouble,
+    /// An integer index into a list of allowed values.
+    SSKPreferenceTypeChoice,
+    SSKPreferenceTypeObject,
+} SSKPreferenceType;
+
+typedef struct {
+    SSKPreferenceType type;
+    double defaultValue;
+    /// Inclusive range. Ignored for booleans and objects.
+    double minimum;
+    double maximum;
+} SSKPreferenceKeySpec;
+
+typedef struct {
+    uint32_t count;
+    /// Ingest batches that changed at least one key.
+    uint64_t version;
+    /// Bit `i` is set when key `i` changed in the last ingest batch. New keys
+    /// start dirty so the first batch reports everything.
+    uint64_t dirty;
+    SSKPreferenceKeySpec specs[SSKPreferenceSnapshotMaxKeys];
+    double values[SSKPreferenceSnapshotMaxKeys];
+} SSKPreferenceSnapshot;
+
+void SSKPreferenceSnapshotInit(SSKPreferenceSnapshot *snapshot);
+
+/// Appends a key at its (clamped) default and returns its index, or -1 when
+/// the snapshot is full. Ranges given backwards are swapped.
+int32_t SSKPreferenceSnapshotAddKey(SSKPreferenceSnapshot *snapshot, const SSKPreferenceKeySpec *spec);
+
+/// Clears `dirty` before a batch of sets.
+void SSKPreferenceSnapshotBeginIngest(SSKPreferenceSnapshot *snapshot);
+
+/// Stores `value` for `key` after validating it for the key's type: NaN
+/// falls back to the default, numbers are clamped to the range, integers and
+/// choices rounded, booleans reduced to 0 or 1. Sets the key's dirty bit and
+/// returns true when the stored value changed.
+bool SSKPreferenceSnapshotSet(SSKPreferenceSnapshot *snapshot, uint32_t key, double value);
+
+/// Restores `key` to its default, e.g. when the stored value was removed or
+/// has the wrong type.
+bool SSKPreferenceSnapshotSetDefault(SSKPreferenceSnapshot *snapshot, uint32_t key);
+
+/// Flags an object key whose value changed.
+void SSKPreferenceSnapshotMarkDirty(SSKPreferenceSnapshot *snapshot, uint32_t key);
+
+/// Closes a batch: bumps `version` if anything changed and returns `dirty`.
+uint64_t SSKPreferenceSnapshotEndIngest(SSKPreferenceSnapshot *snapshot);
+
+static inline bool SSKPreferenceSnapshotIsDirty(const SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    return key < SSKPreferenceSnapshotMaxKeys && ((snapshot->dirty >> key) & 1u);
+}
+
+static inline bool SSKPreferenceSnapshotBool(const SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    return snapshot->values[key] != 0.0;
+}
+
+static inline int64_t SSKPreferenceSnapshotInteger(const SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    return (int64_t)snapshot->values[key];
+}
+
+static inline double SSKPreferenceSnapshotDouble(const SSKPreferenceSnapshot *snapshot, uint32_t key) {
+    return snapshot->values[key];
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKPreferenceSnapshot_h */
@@ -0,0 +1,363 @@
+#define _POSIX_C_SOURCE 200112L
+#if defined(__APPLE__)
+#define _DARWIN_C_SOURCE
+#endif
+
+#include "SSKProfiler.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const uint32_t kSSKProfilerDefaultRingCapacity = 4096;
+static const uint32_t kSSKProfilerDefaultWindowSize = 240;
+static const uint32_t kSSKProfilerDefaultTraceCapacity = 16384;
+
+enum { SSKProfilerPhaseNameLength = 48 };
+
+static pthread_mutex_t gSSKProfilerPhaseLock = PTHREAD_MUTEX_INITIALIZER;
+static char gSSKProfilerPhaseNames[SSKProfilerMaxPhases][SSKProfilerPhaseNameLength];
+static atomic_uint gSSKProfilerPhaseCount;
+
+/// One recording thread's samples. The owner advances `head`, the collector
+/// `tail`; they sit on separate cache lines so neither side bounces the
+/// other's.
+typedef struct SSKProfilerRing {
+    _Alignas(64) _Atomic(uint64_t) head;
+    _Atomic(uint64_t) dropped;
+    _Alignas(64) _Atomic(uint64_t) tail;
+    struct SSKProfilerRing *next;
+    pthread_t owner;
+    uint32_t mask;
+    uint16_t thread;
+    SSKProfilerSample *samples;
+} SSKProfilerRing;
+
+/// The most recent durations of one phase on one clock.
+typedef struct {
+    uint32_t count;
+    uint32_t next;
+    uint64_t durations[];
+} SSKProfilerWindow;
+
+struct SSKProfiler {
+    uint64_t serial;
+    atomic_bool enabled;
+    uint32_t ringCapacity;
+    _Atomic(SSKProfilerRing *) rings;
+    atomic_uint ringCount;
+
+    uint32_t windowSize;
+    SSKProfilerWindow *windows[SSKProfilerMaxPhases][2];
+    uint64_t *scratch;
+
+    SSKProfilerSample *trace;
+    uint32_t traceCapacity;
+    uint64_t traceCount;
+};
+
+static _Atomic(uint64_t) gSSKProfilerSerial;
+
+/// The ring the current thread last recorded into, tagged with its profiler's
+/// serial so a destroyed profiler's address being reused cannot alias it.
+static _Thread_local uint64_t tSSKProfilerCachedSerial;
+static _Thread_local SSKProfilerRing *tSSKProfilerCachedRing;
+
+uint32_t SSKProfilerRegisterPhase(const char *name) {
+    if (!name || !name[0]) { return 0; }
+    pthread_mutex_lock(&gSSKProfilerPhaseLock);
+    uint32_t count = atomic_load_explicit(&gSSKProfilerPhaseCount, memory_order_relaxed);
+    uint32_t phase = 0;
+    for (uint32_t i = 1; i <= count; i++) {
+        if (strncmp(gSSKProfilerPhaseNames[i], name, SSKProfilerPhaseNameLength - 1) == 0) {
+            phase = i;
+            break;
+        }
+    }
+    if (phase == 0 && count + 1 < SSKProfilerMaxPhases) {
+        phase = count + 1;
+        strncpy(gSSKProfilerPhaseNames[phase], name, SSKProfilerPhaseNameLength - 1);
+        atomic_store_explicit(&gSSKProfilerPhaseCount, phase, memory_order_release);
+    }
+    pthread_mutex_unlock(&gSSKProfilerPhaseLock);
+    return phase;
+}
+
+const char *SSKProfilerPhaseName(uint32_t phase) {
+    if (phase == 0 || phase > atomic_load_explicit(&gSSKProfilerPhaseCount, memory_order_acquire)) { return "?"; }
+    return gSSKProfilerPhaseNames[phase];
+}
+
+uint32_t SSKProfilerPhaseCount(void) {
+    return atomic_load_explicit(&gSSKProfilerPhaseCount, memory_order_acquire);
+}
+
+uint64_t SSKProfilerNow(void) {
+#if defined(__APPLE__)
+    // The host clock Metal's GPU timestamps and CACurrentMediaTime use.
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static uint32_t SSKProfilerRoundUpPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result < (1u << 31)) {
+        result <<= 1;
+    }
+    return result;
+}
+
+SSKProfiler *SSKProfilerCreate(uint32_t ringCapacity, uint32_t windowSize, uint32_t traceCapacity) {
+    SSKProfiler *profiler = calloc(1, sizeof(SSKProfiler));
+    if (!profiler) { return NULL; }
+    profiler->serial = atomic_fetch_add(&gSSKProfilerSerial, 1) + 1;
+    atomic_init(&profiler->enabled, false);
+    atomic_init(&profiler->rings, NULL);
+    atomic_init(&profiler->ringCount, 0);
+    profiler->ringCapacity = SSKProfilerRoundUpPowerOfTwo(ringCapacity > 0 ? ringCapacity
+                                                                            : kSSKProfilerDefaultRingCapacity);
+    profiler->windowSize = windowSize > 0 ? windowSize : kSSKProfilerDefaultWindowSize;
+    profiler->traceCapacity = traceCapacity > 0 ? traceCapacity : kSSKProfilerDefaultTraceCapacity;
+    profiler->scratch = malloc(sizeof(uint64_t) * profiler->windowSize);
+    profiler->trace = malloc(sizeof(SSKProfilerSample) * profiler->traceCapacity);
+    if (!profiler->scratch || !profiler->trace) {
+        SSKProfilerDestroy(profiler);
+        return NULL;
+    }
+    return profiler;
+}
+
+void SSKProfilerDestroy(SSKProfiler *profiler) {
+    if (!profiler) { return; }
+    SSKProfilerRing *ring = atomic_load(&profiler->rings);
+    while (ring) {
+        SSKProfilerRing *next = ring->next;
+        free(ring->samples);
+        free(ring);
+        ring = next;
+    }
+    for (uint32_t phase = 0; phase < SSKProfilerMaxPhases; phase++) {
+        free(profiler->windows[phase][SSKProfilerClockCPU]);
+        free(profiler->windows[phase][SSKProfilerClockGPU]);
+    }
+    free(profiler->scratch);
+    free(profiler->trace);
+    free(profiler);
+}
+
+void SSKProfilerSetEnabled(SSKProfiler *profiler, bool enabled) {
+    if (!profiler) { return; }
+    atomic_store_explicit(&profiler->enabled, enabled, memory_order_relaxed);
+}
+
+bool SSKProfilerIsEnabled(const SSKProfiler *profiler) {
+    return profiler && atomic_load_explicit(&((SSKProfiler *)profiler)->enabled, memory_order_relaxed);
+}
+
+/// The calling thread's ring, created on its first sample. Rings are only
+/// ever pushed onto the list, so the walk needs no lock.
+static SSKProfilerRing *SSKProfilerThreadRing(SSKProfiler *profiler) {
+    if (tSSKProfilerCachedSerial == profiler->serial) { return tSSKProfilerCachedRing; }
+
+    pthread_t self = pthread_self();
+    SSKProfilerRing *ring = atomic_load_explicit(&profiler->rings, memory_order_acquire);
+    while (ring && !pthread_equal(ring->owner, self)) {
+        ring = ring->next;
+    }
+    if (!ring) {
+        void *storage = NULL;
+        if (posix_memalign(&storage, 64, sizeof(SSKProfilerRing)) != 0) { storage = NULL; }
+        ring = storage;
+        SSKProfilerSample *samples = malloc(sizeof(SSKProfilerSample) * profiler->ringCapacity);
+        if (!ring || !samples) {
+            free(ring);
+            free(samples);
+            return NULL;
+        }
+        memset(ring, 0, sizeof(SSKProfilerRing));
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->dropped, 0);
+        ring->owner = self;
+        ring->mask = profiler->ringCapacity - 1;
+        ring->thread = (uint16_t)atomic_fetch_add(&profiler->ringCount, 1);
+        ring->samples = samples;
+        SSKProfilerRing *head = atomic_load_explicit(&profiler->rings, memory_order_relaxed);
+        do {
+            ring->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&profiler->rings, &head, ring, memory_order_release,
+                                                        memory_order_relaxed));
+    }
+    tSSKProfilerCachedSerial = profiler->serial;
+    tSSKProfilerCachedRing = ring;
+    return ring;
+}
+
+void SSKProfilerRecord(SSKProfiler *profiler, uint32_t phase, SSKProfilerClock clock, uint64_t start, uint64_t end) {
+    if (!profiler || !atomic_load_explicit(&profiler->enabled, memory_order_relaxed)) { return; }
+    SSKProfilerRing *ring = SSKProfilerThreadRing(profiler);
+    if (!ring) { return; }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    SSKProfilerSample *sample = &ring->samples[head & ring->mask];
+    sample->start = start;
+    sample->duration = end > start ? end - start : 0;
+    sample->phase = phase < SSKProfilerMaxPhases ? phase : 0;
+    sample->thread = ring->thread;
+    sample->clock = (uint16_t)clock;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+uint64_t SSKProfilerDroppedCount(const SSKProfiler *profiler) {
+    if (!profiler) { return 0; }
+    uint64_t dropped = 0;
+    SSKProfilerRing *ring = atomic_load_explicit(&((SSKProfiler *)profiler)->rings, memory_order_acquire);
+    for (; ring; ring = ring->next) {
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
+
+static void SSKProfilerAccumulate(SSKProfiler *profiler, const SSKProfilerSample *sample) {
+    uint32_t clock = sample->clock == SSKProfilerClockGPU ? SSKProfilerClockGPU : SSKProfilerClockCPU;
+    SSKProfilerWindow *window = profiler->windows[sample->phase][clock];
+    if (!window) {
+        window = calloc(1, sizeof(SSKProfilerWindow) + sizeof(uint64_t) * profiler->windowSize);
+        profiler->windows[sample->phase][clock] = window;
+    }
+    if (window) {
+        window->durations[window->next] = sample->duration;
+        window->next = (window->next + 1) % profiler->windowSize;
+        if (window->count < profiler->windowSize) { window->count++; }
+    }
+    profiler->trace[profiler->traceCount % profiler->traceCapacity] = *sample;
+    profiler->traceCount++;
+}
+
+uint32_t SSKProfilerCollect(SSKProfiler *profiler, SSKProfilerSampleFunction function, void *context) {
+    if (!profiler) { return 0; }
+    uint32_t drained = 0;
+    SSKProfilerRing *ring = atomic_load_explicit(&profiler->rings, memory_order_acquire);
+    for (; ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        for (; tail != head; tail++) {
+            SSKProfilerSample sample = ring->samples[tail & ring->mask];
+            SSKProfilerAccumulate(profiler, &sample);
+            if (function) { function(context, &sample); }
+            drained++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return drained;
+}
+
+static int SSKProfilerCompareDurations(const void *a, const void *b) {
+    uint64_t lhs = *(const uint64_t *)a;
+    uint64_t rhs = *(const uint64_t *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/// Nearest-rank percentile of `count` sorted durations, in milliseconds.
+static double SSKProfilerPercentile(const uint64_t *sorted, uint32_t count, double fraction) {
+    double rank = ceil(fraction * (double)count);
+    uint32_t index = rank < 1.0 ? 0 : (uint32_t)rank - 1;
+    if (index >= count) { index = count - 1; }
+    return (double)sorted[index] / 1.0e6;
+}
+
+bool SSKProfilerPhaseStats(SSKProfiler *profiler, uint32_t phase, SSKProfilerClock clock, SSKProfilerStats *stats) {
+    if (!profiler || !stats || phase >= SSKProfilerMaxPhases) { return false; }
+    SSKProfilerWindow *window = profiler->windows[phase][clock == SSKProfilerClockGPU ? 1 : 0];
+    if (!window || window->count == 0) { return false; }
+
+    uint32_t count = window->count;
+    memcpy(profiler->scratch, window->durations, sizeof(uint64_t) * count);
+    qsort(profiler->scratch, count, sizeof(uint64_t), SSKProfilerCompareDurations);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += profiler->scratch[i];
+    }
+    stats->count = count;
+    stats->mean = (double)total / (double)count / 1.0e6;
+    stats->p50 = SSKProfilerPercentile(profiler->scratch, count, 0.50);
+    stats->p95 = SSKProfilerPercentile(profiler->scratch, count, 0.95);
+    stats->p99 = SSKProfilerPercentile(profiler->scratch, count, 0.99);
+    stats->max = (double)profiler->scratch[count - 1] / 1.0e6;
+    return true;
+}
+
+void SSKProfilerReset(SSKProfiler *profiler) {
+    if (!profiler) { return; }
+    for (uint32_t phase = 0; phase < SSKProfilerMaxPhases; phase++) {
+        for (uint32_t clock = 0; clock < 2; clock++) {
+            SSKProfilerWindow *window = profiler->windows[phase][clock];
+            if (window) {
+                window->count = 0;
+                window->next = 0;
+            }
+        }
+    }
+    profiler->traceCount = 0;
+}
+
+static void SSKProfilerWriteJSONString(FILE *file, const char *string) {
+    fputc('"', file);
+    for (const unsigned char *c = (const unsigned char *)string; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if (*c < 0x20) {
+            fprintf(file, "\\u%04x", *c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+bool SSKProfilerWriteChromeTrace(const SSKProfiler *profiler, FILE *file) {
+    if (!profiler || !file) { return false; }
+    uint64_t count = profiler->traceCount < profiler->traceCapacity ? profiler->traceCount : profiler->traceCapacity;
+    uint64_t first = profiler->traceCount - count;
+
+    // Timestamps are microseconds from the earliest sample kept, which keeps
+    // them short without losing precision.
+    uint64_t origin = UINT64_MAX;
+    for (uint64_t i = first; i < profiler->traceCount; i++) {
+        uint64_t start = profiler->trace[i % profiler->traceCapacity].start;
+        if (start < origin) { origin = start; }
+    }
+
+    // Track 0 is the GPU; CPU threads follow from 1.
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}", file);
+    uint32_t threads = atomic_load_explicit(&((SSKProfiler *)profiler)->ringCount, memory_order_acquire);
+    for (uint32_t thread = 0; thread < threads; thread++) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"CPU %u\"}}",
+                thread + 1, thread);
+    }
+    for (uint64_t i = first; i < profiler->traceCount; i++) {
+        const SSKProfilerSample *sample = &profiler->trace[i % profiler->traceCapacity];
+        bool gpu = sample->clock == SSKProfilerClockGPU;
+        fputs(",\n{\"name\":", file);
+        SSKProfilerWriteJSONString(file, SSKProfilerPhaseName(sample->phase));
+        fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                gpu ? "gpu" : "cpu", (double)(sample->start - origin) / 1000.0, (double)sample->duration / 1000.0,
+                gpu ? 0u : (uint32_t)sample->thread + 1);
+    }
+    fputs("\n]}\n", file);
+    return ferror(file) == 0;
+}
@@ -0,0 +1,152 @@
+#ifndef SSKProfiler_h
+#define SSKProfiler_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Frame-phase profiler.
+///
+/// Any thread records timed samples of named phases. Each thread writes into
+/// its own single-producer ring, so recording takes no lock and never waits
+/// on the reader: a full ring drops the sample and counts it instead. One
+/// collector thread (usually the one drawing the diagnostics overlay) drains
+/// every ring once per frame into a rolling window per phase, from which the
+/// percentiles are read, and into a trace buffer that can be written out as
+/// Chrome trace JSON (chrome://tracing, Perfetto).
+///
+/// While disabled, recording is one load and a branch.
+typedef struct SSKProfiler SSKProfiler;
+
+/// Phase ids are process-wide and start at 1; 0 is "no phase".
+enum { SSKProfilerMaxPhases = 128 };
+
+/// Which clock a sample was measured on. GPU samples are converted to the
+/// CPU timeline by the caller and are kept apart from CPU samples of the same
+/// phase.
+typedef enum {
+    SSKProfilerClockCPU = 0,
+    SSKProfilerClockGPU = 1,
+} SSKProfilerClock;
+
+typedef struct {
+    /// Nanoseconds on the `SSKProfilerNow` clock.
+    uint64_t start;
+    uint64_t duration;
+    uint32_t phase;
+    /// Recording thread, numbered per profiler from 0.
+    uint16_t thread;
+    uint16_t clock;
+} SSKProfilerSample;
+
+/// Durations of a phase's recent samples, in milliseconds.
+typedef struct {
+    uint32_t count;
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} SSKProfilerStats;
+
+/// Returns the id for `name`, registering it on first use (names longer than
+/// 47 bytes are truncated). Returns 0 once `SSKProfilerMaxPhases` are taken.
+uint32_t SSKProfilerRegisterPhase(const char *name);
+
+/// Name of a registered phase, or "?".
+const char *SSKProfilerPhaseName(uint32_t phase);
+
+/// Highest phase id registered so far.
+uint32_t SSKProfilerPhaseCount(void);
+
+/// `SSKProfilerRegisterPhase` memoised in `*cache`, which starts at 0.
+static inline uint32_t SSKProfilerPhaseCached(uint32_t *cache, const char *name) {
+    uint32_t phase = __atomic_load_n(cache, __ATOMIC_ACQUIRE);
+    if (phase == 0) {
+        phase = SSKProfilerRegisterPhase(name);
+        __atomic_store_n(cache, phase, __ATOMIC_RELEASE);
+    }
+    return phase;
+}
+
+/// Monotonic time in nanoseconds.
+uint64_t SSKProfilerNow(void);
+
+/// `ringCapacity` is per recording thread (rounded up to a power of two),
+/// `windowSize` the samples per phase the statistics cover and
+/// `traceCapacity` the most recent samples kept for export. Zero picks 4096,
+/// 240 and 16384. Starts disabled. Returns NULL on failure.
+SSKProfiler *SSKProfilerCreate(uint32_t ringCapacity, uint32_t windowSize, uint32_t traceCapacity);
+void SSKProfilerDestroy(SSKProfiler *profiler);
+
+void SSKProfilerSetEnabled(SSKProfiler *profiler, bool enabled);
+bool SSKProfilerIsEnabled(const SSKProfiler *profiler);
+
+/// Records `phase` running from `start` to `end`. Safe from any thread.
+void SSKProfilerRecord(SSKProfiler *profiler, uint32_t phase, SSKProfilerClock clock, uint64_t start, uint64_t end);
+
+/// Samples dropped because a thread's ring was full.
+uint64_t SSKProfilerDroppedCount(const SSKProfiler *profiler);
+
+/// The functions below belong to the collector and must all be called from
+/// one thread at a time.
+
+typedef void (*SSKProfilerSampleFunction)(void *context, const SSKProfilerSample *sample);
+
+/// Drains every thread's ring into the statistics and the trace buffer, and
+/// passes each sample to `function` if it is not NULL. Samples of one thread
+/// arrive in the order they were recorded. Returns the number drained.
+uint32_t SSKProfilerCollect(SSKProfiler *profiler, SSKProfilerSampleFunction function, void *context);
+
+/// Statistics over the last `windowSize` samples of `phase` on `clock`.
+/// Returns false when there are none.
+bool SSKProfilerPhaseStats(SSKProfiler *profiler, uint32_t phase, SSKProfilerClock clock, SSKProfilerStats *stats);
+
+/// Forgets collected statistics and trace samples.
+void SSKProfilerReset(SSKProfiler *profiler);
+
+/// Writes the trace buffer as Chrome trace JSON: one complete event per
+/// sample, CPU samples on one track per thread and GPU samples on their own.
+bool SSKProfilerWriteChromeTrace(const SSKProfiler *profiler, FILE *file);
+
+/// A CPU sample that ends when the scope does; see `SSK_PROFILE_SCOPE`.
+typedef struct {
+    SSKProfiler *profiler;
+    uint32_t phase;
+    uint64_t start;
+} SSKProfilerScope;
+
+static inline SSKProfilerScope SSKProfilerScopeBegin(SSKProfiler *profiler, uint32_t phase) {
+    SSKProfilerScope scope = {NULL, phase, 0};
+    if (profiler && SSKProfilerIsEnabled(profiler)) {
+        scope.profiler = profiler;
+        scope.start = SSKProfilerNow();
+    }
+    return scope;
+}
+
+static inline void SSKProfilerScopeEnd(SSKProfilerScope *scope) {
+    if (!scope->profiler) { return; }
+    SSKProfilerRecord(scope->profiler, scope->phase, SSKProfilerClockCPU, scope->start, SSKProfilerNow());
+    scope->profiler = NULL;
+}
+
+#define SSK_PROFILE_CONCAT_(a, b) a##b
+#define SSK_PROFILE_CONCAT(a, b) SSK_PROFILE_CONCAT_(a, b)
+
+/// Times the rest of the enclosing block as phase `name` (a string literal)
+/// on `profiler`, which may be NULL. The phase id is looked up once per call
+/// site.
+#define SSK_PROFILE_SCOPE(profiler, name)                                                            \
+    static uint32_t SSK_PROFILE_CONCAT(sskProfilePhase, __LINE__);                                   \
+    SSKProfilerScope SSK_PROFILE_CONCAT(sskProfileScope, __LINE__)                                   \
+        __attribute__((cleanup(SSKProfilerScopeEnd))) = SSKProfilerScopeBegin(                       \
+            (profiler), SSKProfilerPhaseCached(&SSK_PROFILE_CONCAT(sskProfilePhase, __LINE__), (name)))
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKProfiler_h */
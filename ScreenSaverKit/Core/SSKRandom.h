@@ -0,0 +1,48 @@
+#ifndef SSKRandom_h
+#define SSKRandom_h
+
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Small seeded generator (xorshift64*) for hot loops that need many cheap
+/// random numbers with a reproducible sequence. Not for anything security
+/// related. The state must never be zero; use `SSKRandomMake` to seed it.
+typedef struct {
+    uint64_t state;
+} SSKRandom;
+
+static inline SSKRandom SSKRandomMake(uint64_t seed) {
+    // One splitmix64 round spreads small seeds across the whole state.
+    uint64_t z = seed + UINT64_C(0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    z ^= z >> 31;
+    SSKRandom random = { z ? z : UINT64_C(0x9E3779B97F4A7C15) };
+    return random;
+}
+
+static inline uint32_t SSKRandomNext(SSKRandom *random) {
+    uint64_t x = random->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    random->state = x;
+    return (uint32_t)((x * UINT64_C(0x2545F4914F6CDD1D)) >> 32);
+}
+
+/// Uniform float in `[0, 1)` with 24 bits of precision.
+static inline float SSKRandomNextUnit(SSKRandom *random) {
+    return (float)(SSKRandomNext(random) >> 8) * (1.0f / 16777216.0f);
+}
+
+/// Uniform float in `[lo, hi)`; returns `lo` when the range is empty.
+static inline float SSKRandomNextRange(SSKRandom *random, float lo, float hi) {
+    return lo + (hi - lo) * SSKRandomNextUnit(random);
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKRandom_h */
@@ -0,0 +1,324 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKReplay.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t kSSKReplayMagic[8] = {'S', 'S', 'K', 'R', 'P', 'L', 'A', 'Y'};
+static const uint64_t kSSKReplayChecksumBasis = UINT64_C(0xcbf29ce484222325);
+static const uint64_t kSSKReplayChecksumPrime = UINT64_C(0x100000001b3);
+
+enum {
+    SSKReplayHeaderSize = 8 + 4 + 8 + 8 + 8,
+    SSKReplayWriterBufferSize = 4096,
+    /// Longest varint: ten bytes of seven bits.
+    SSKReplayMaxVarint = 10,
+};
+
+struct SSKReplayWriter {
+    FILE *file;
+    uint64_t previousBits;
+    uint64_t frameCount;
+    uint32_t used;
+    bool failed;
+    uint8_t buffer[SSKReplayWriterBufferSize];
+};
+
+static uint64_t SSKReplayDoubleBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+static double SSKReplayBitsDouble(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+static void SSKReplayStore64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) { out[i] = (uint8_t)(value >> (8 * i)); }
+}
+
+static uint64_t SSKReplayLoad64(const uint8_t *in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) { value |= (uint64_t)in[i] << (8 * i); }
+    return value;
+}
+
+static uint32_t SSKReplayPutVarint(uint8_t *out, uint64_t value) {
+    uint32_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+static bool SSKReplayGetVarint(SSKReplayReader *reader, uint64_t *value) {
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (reader->cursor == reader->end) { return false; }
+        uint8_t byte = *reader->cursor++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+SSKReplayWriter *SSKReplayWriterCreate(FILE *file, const SSKReplayHeader *header) {
+    if (!file || !header) { return NULL; }
+    SSKReplayWriter *writer = calloc(1, sizeof(SSKReplayWriter));
+    if (!writer) { return NULL; }
+    writer->file = file;
+    uint8_t *out = writer->buffer;
+    memcpy(out, kSSKReplayMagic, sizeof kSSKReplayMagic);
+    uint32_t version = SSKReplayVersion;
+    for (int i = 0; i < 4; i++) { out[8 + i] = (uint8_t)(version >> (8 * i)); }
+    SSKReplayStore64(out + 12, header->seed);
+    SSKReplayStore64(out + 20, SSKReplayDoubleBits(header->viewWidth));
+    SSKReplayStore64(out + 28, SSKReplayDoubleBits(header->viewHeight));
+    writer->used = SSKReplayHeaderSize;
+    return writer;
+}
+
+bool SSKReplayWriterFlush(SSKReplayWriter *writer) {
+    if (!writer) { return false; }
+    if (!writer->failed && writer->used > 0) {
+        writer->failed = fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used ||
+            fflush(writer->file) != 0;
+    }
+    writer->used = 0;
+    return !writer->failed;
+}
+
+bool SSKReplayWriterDestroy(SSKReplayWriter *writer) {
+    if (!writer) { return false; }
+    bool ok = SSKReplayWriterFlush(writer);
+    free(writer);
+    return ok;
+}
+
+/// Makes room for `length` bytes, flushing when the buffer would overflow.
+static uint8_t *SSKReplayWriterReserve(SSKReplayWriter *writer, uint32_t length) {
+    if (writer->failed) { return NULL; }
+    if (writer->used + length > SSKReplayWriterBufferSize && !SSKReplayWriterFlush(writer)) { return NULL; }
+    return writer->buffer + writer->used;
+}
+
+static bool SSKReplayWriterTimestamp(SSKReplayWriter *writer, SSKReplayEventType type, double timestamp) {
+    if (!writer) { return false; }
+    uint8_t *out = SSKReplayWriterReserve(writer, 1 + SSKReplayMaxVarint);
+    if (!out) { return false; }
+    uint64_t bits = SSKReplayDoubleBits(timestamp);
+    out[0] = (uint8_t)type;
+    writer->used += 1 + SSKReplayPutVarint(out + 1, bits ^ writer->previousBits);
+    writer->previousBits = bits;
+    return true;
+}
+
+bool SSKReplayWriterClockReset(SSKReplayWriter *writer, double timestamp) {
+    return SSKReplayWriterTimestamp(writer, SSKReplayEventClockReset, timestamp);
+}
+
+bool SSKReplayWriterFrame(SSKReplayWriter *writer, double timestamp) {
+    if (!SSKReplayWriterTimestamp(writer, SSKReplayEventFrame, timestamp)) { return false; }
+    writer->frameCount++;
+    return true;
+}
+
+bool SSKReplayWriterPreferences(SSKReplayWriter *writer, const void *payload, uint32_t length) {
+    if (!writer || (!payload && length > 0)) { return false; }
+    uint8_t *out = SSKReplayWriterReserve(writer, 1 + SSKReplayMaxVarint);
+    if (!out) { return false; }
+    out[0] = (uint8_t)SSKReplayEventPreferences;
+    writer->used += 1 + SSKReplayPutVarint(out + 1, length);
+    if (length <= SSKReplayWriterBufferSize - writer->used) {
+        memcpy(writer->buffer + writer->used, payload, length);
+        writer->used += length;
+        return true;
+    }
+    // Larger than what is left of the buffer: write it straight through.
+    if (!SSKReplayWriterFlush(writer)) { return false; }
+    writer->failed = fwrite(payload, 1, length, writer->file) != length;
+    return !writer->failed;
+}
+
+uint64_t SSKReplayWriterFrameCount(const SSKReplayWriter *writer) {
+    return writer ? writer->frameCount : 0;
+}
+
+bool SSKReplayReaderInit(SSKReplayReader *reader, const void *data, size_t length) {
+    if (!reader) { return false; }
+    memset(reader, 0, sizeof *reader);
+    const uint8_t *bytes = data;
+    if (!bytes || length < SSKReplayHeaderSize || memcmp(bytes, kSSKReplayMagic, sizeof kSSKReplayMagic) != 0) {
+        reader->failed = true;
+        return false;
+    }
+    uint32_t version = 0;
+    for (int i = 0; i < 4; i++) { version |= (uint32_t)bytes[8 + i] << (8 * i); }
+    if (version != SSKReplayVersion) {
+        reader->failed = true;
+        return false;
+    }
+    reader->header.seed = SSKReplayLoad64(bytes + 12);
+    reader->header.viewWidth = SSKReplayBitsDouble(SSKReplayLoad64(bytes + 20));
+    reader->header.viewHeight = SSKReplayBitsDouble(SSKReplayLoad64(bytes + 28));
+    reader->cursor = bytes + SSKReplayHeaderSize;
+    reader->end = bytes + length;
+    return true;
+}
+
+bool SSKReplayReaderNext(SSKReplayReader *reader, SSKReplayEvent *event) {
+    if (!reader || reader->failed || reader->cursor == reader->end) { return false; }
+    memset(event, 0, sizeof *event);
+    uint8_t type = *reader->cursor++;
+    uint64_t value = 0;
+    if (!SSKReplayGetVarint(reader, &value)) {
+        reader->failed = true;
+        return false;
+    }
+    switch (type) {
+        case SSKReplayEventClockReset:
+        case SSKReplayEventFrame:
+            reader->previousBits ^= value;
+            event->timestamp = SSKReplayBitsDouble(reader->previousBits);
+            break;
+        case SSKReplayEventPreferences:
+            if (value > (uint64_t)(reader->end - reader->cursor) || value > UINT32_MAX) {
+                reader->failed = true;
+                return false;
+            }
+            event->payload = reader->cursor;
+            event->payloadLength = (uint32_t)value;
+            reader->cursor += value;
+            break;
+        default:
+            reader->failed = true;
+            return false;
+    }
+    event->type = (SSKReplayEventType)type;
+    return true;
+}
+
+uint64_t SSKReplayChecksum(uint64_t hash, const void *data, size_t length) {
+    // FNV-1a over 64-bit words, with the byte count mixed in so runs of
+    // zeros of different lengths differ.
+    hash ^= kSSKReplayChecksumBasis ^ (uint64_t)length;
+    const uint8_t *bytes = data;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof word);
+        hash = (hash ^ word) * kSSKReplayChecksumPrime;
+        hash ^= hash >> 29;
+    }
+    for (; i < length; i++) { hash = (hash ^ bytes[i]) * kSSKReplayChecksumPrime; }
+    return hash;
+}
+
+void SSKReplayTraceInit(SSKReplayTrace *trace) {
+    if (!trace) { return; }
+    memset(trace, 0, sizeof *trace);
+}
+
+void SSKReplayTraceDestroy(SSKReplayTrace *trace) {
+    if (!trace) { return; }
+    free(trace->frames);
+    memset(trace, 0, sizeof *trace);
+}
+
+bool SSKReplayTraceAppend(SSKReplayTrace *trace, const SSKReplayFrame *frame) {
+    if (!trace || !frame) { return false; }
+    if (trace->count == trace->capacity) {
+        if (trace->capacity > UINT32_MAX / 2) { return false; }
+        uint32_t capacity = trace->capacity ? trace->capacity * 2 : 1024;
+        SSKReplayFrame *frames = realloc(trace->frames, capacity * sizeof(SSKReplayFrame));
+        if (!frames) { return false; }
+        trace->frames = frames;
+        trace->capacity = capacity;
+    }
+    trace->frames[trace->count++] = *frame;
+    return true;
+}
+
+bool SSKReplayTraceWrite(const SSKReplayTrace *trace, FILE *file) {
+    if (!trace || !file) { return false; }
+    bool ok = fputs("# frame costNs steps checksum\n", file) >= 0;
+    for (uint32_t i = 0; ok && i < trace->count; i++) {
+        const SSKReplayFrame *frame = &trace->frames[i];
+        ok = fprintf(file, "%u %" PRIu64 " %u %016" PRIx64 "\n", i, frame->costNs, frame->steps,
+                     frame->checksum) > 0;
+    }
+    return ok;
+}
+
+bool SSKReplayTraceRead(SSKReplayTrace *trace, FILE *file) {
+    if (!trace || !file) { return false; }
+    char line[128];
+    while (fgets(line, sizeof line, file)) {
+        if (line[0] == '#' || line[0] == '\n') { continue; }
+        unsigned index = 0;
+        unsigned steps = 0;
+        SSKReplayFrame frame = {0, 0, 0};
+        if (sscanf(line, "%u %" SCNu64 " %u %" SCNx64, &index, &frame.costNs, &steps, &frame.checksum) != 4) {
+            return false;
+        }
+        frame.steps = steps;
+        if (!SSKReplayTraceAppend(trace, &frame)) { return false; }
+    }
+    return !ferror(file);
+}
+
+static int SSKReplayCompareCosts(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/// Median and 95th percentile (nearest rank) of the first `count` frame costs.
+static void SSKReplayCostPercentiles(const SSKReplayTrace *trace, uint32_t count, uint64_t *scratch,
+                                     double *median, double *p95) {
+    *median = 0.0;
+    *p95 = 0.0;
+    if (count == 0) { return; }
+    for (uint32_t i = 0; i < count; i++) { scratch[i] = trace->frames[i].costNs; }
+    qsort(scratch, count, sizeof(uint64_t), SSKReplayCompareCosts);
+    *median = count % 2 ? (double)scratch[count / 2] : 0.5 * ((double)scratch[count / 2 - 1] + scratch[count / 2]);
+    uint32_t rank = (uint32_t)ceil(0.95 * count);
+    *p95 = (double)scratch[rank > 0 ? rank - 1 : 0];
+}
+
+SSKReplayComparison SSKReplayTraceCompare(const SSKReplayTrace *baseline, const SSKReplayTrace *current) {
+    SSKReplayComparison comparison = {UINT32_MAX, 0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (!baseline || !current) { return comparison; }
+    uint32_t count = baseline->count < current->count ? baseline->count : current->count;
+    comparison.comparedFrames = count;
+    for (uint32_t i = 0; i < count; i++) {
+        if (baseline->frames[i].checksum != current->frames[i].checksum) {
+            comparison.firstDivergentFrame = i;
+            break;
+        }
+    }
+    if (comparison.firstDivergentFrame == UINT32_MAX && baseline->count != current->count) {
+        comparison.firstDivergentFrame = count;
+    }
+    uint64_t *scratch = count > 0 ? malloc(count * sizeof(uint64_t)) : NULL;
+    if (scratch) {
+        SSKReplayCostPercentiles(baseline, count, scratch, &comparison.baselineMedianNs, &comparison.baselineP95Ns);
+        SSKReplayCostPercentiles(current, count, scratch, &comparison.currentMedianNs, &comparison.currentP95Ns);
+        free(scratch);
+    }
+    if (comparison.baselineMedianNs > 0.0) {
+        comparison.change = (comparison.currentMedianNs / comparison.baselineMedianNs - 1.0) * 100.0;
+    }
+    return comparison;
+}
@@ -0,0 +1,143 @@
+#ifndef SSKReplay_h
+#define SSKReplay_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Record and replay of a saver's inputs.
+///
+/// A replay log holds everything that makes two runs of a simulation differ:
+/// the random seed, the view size, every clock timestamp the saver read and
+/// every preference change it was handed, in order. Replaying the log against
+/// a fresh view runs the same steps with the same deltas, so per-frame cost
+/// and state checksums can be compared between builds.
+///
+/// Layout: an 8-byte magic, a version and the header fields, then events of
+/// one tag byte each. Timestamps are stored exactly, as a varint of their
+/// bits XOR the previous timestamp's bits; consecutive frames share the sign,
+/// exponent and top of the mantissa, so a frame costs four or five bytes.
+/// Preference payloads are opaque to the log (the Objective-C recorder stores
+/// a binary property list). Integers are little endian.
+
+enum { SSKReplayVersion = 1 };
+
+typedef enum {
+    /// The clock restarted at `timestamp`, e.g. when animation starts.
+    SSKReplayEventClockReset = 1,
+    /// The saver read the clock at `timestamp` to advance one frame.
+    SSKReplayEventFrame = 2,
+    /// Preferences changed; `payload` describes how.
+    SSKReplayEventPreferences = 3,
+} SSKReplayEventType;
+
+typedef struct {
+    uint64_t seed;
+    /// View size in points.
+    double viewWidth;
+    double viewHeight;
+} SSKReplayHeader;
+
+typedef struct {
+    SSKReplayEventType type;
+    /// Seconds on the recording clock; clock resets and frames only.
+    double timestamp;
+    /// Preference events only. Points into the reader's buffer.
+    const uint8_t *payload;
+    uint32_t payloadLength;
+} SSKReplayEvent;
+
+/// Appends events to a log file through a small buffer.
+typedef struct SSKReplayWriter SSKReplayWriter;
+
+/// Writes the header to `file`, which stays the caller's to close after
+/// `SSKReplayWriterDestroy`. Returns NULL on failure.
+SSKReplayWriter *SSKReplayWriterCreate(FILE *file, const SSKReplayHeader *header);
+
+/// Flushes and frees the writer. Returns false if any write failed.
+bool SSKReplayWriterDestroy(SSKReplayWriter *writer);
+
+/// Each returns false once a write has failed; later events are dropped.
+bool SSKReplayWriterClockReset(SSKReplayWriter *writer, double timestamp);
+bool SSKReplayWriterFrame(SSKReplayWriter *writer, double timestamp);
+bool SSKReplayWriterPreferences(SSKReplayWriter *writer, const void *payload, uint32_t length);
+bool SSKReplayWriterFlush(SSKReplayWriter *writer);
+
+/// Frames written so far.
+uint64_t SSKReplayWriterFrameCount(const SSKReplayWriter *writer);
+
+/// Reads a log held in memory. Plain struct; no cleanup needed.
+typedef struct {
+    SSKReplayHeader header;
+    const uint8_t *cursor;
+    const uint8_t *end;
+    uint64_t previousBits;
+    /// Set when the log is truncated or holds an unknown event.
+    bool failed;
+} SSKReplayReader;
+
+/// Parses the header of the `length` bytes at `data`, which must outlive the
+/// reader. Returns false if they are not a log of this version.
+bool SSKReplayReaderInit(SSKReplayReader *reader, const void *data, size_t length);
+
+/// Reads the next event. Returns false at the end of the log or on an error
+/// (see `failed`).
+bool SSKReplayReaderNext(SSKReplayReader *reader, SSKReplayEvent *event);
+
+/// Extends `hash` with `length` bytes. Start from 0. Reads eight bytes at a
+/// time, so it keeps up with state arrays of a few megabytes per frame; not
+/// for anything security related.
+uint64_t SSKReplayChecksum(uint64_t hash, const void *data, size_t length);
+
+/// What one replayed frame cost and left behind.
+typedef struct {
+    /// Time spent in simulation steps during the frame, in nanoseconds.
+    uint64_t costNs;
+    /// Simulation state after the frame.
+    uint64_t checksum;
+    /// Steps the frame ran (fixed-timestep savers may run several or none).
+    uint32_t steps;
+} SSKReplayFrame;
+
+typedef struct {
+    SSKReplayFrame *frames;
+    uint32_t count;
+    uint32_t capacity;
+} SSKReplayTrace;
+
+void SSKReplayTraceInit(SSKReplayTrace *trace);
+void SSKReplayTraceDestroy(SSKReplayTrace *trace);
+bool SSKReplayTraceAppend(SSKReplayTrace *trace, const SSKReplayFrame *frame);
+
+/// One line per frame ("frame costNs steps checksum", checksum in hex) after
+/// a `#` comment line, easy to diff or plot.
+bool SSKReplayTraceWrite(const SSKReplayTrace *trace, FILE *file);
+
+/// Reads what `SSKReplayTraceWrite` wrote, appending to `trace`.
+bool SSKReplayTraceRead(SSKReplayTrace *trace, FILE *file);
+
+typedef struct {
+    /// First frame whose checksum differs, or where the shorter trace ends
+    /// when the lengths differ; `UINT32_MAX` when the traces agree.
+    uint32_t firstDivergentFrame;
+    /// Frames present in both.
+    uint32_t comparedFrames;
+    /// Per-frame cost over the compared frames, in nanoseconds.
+    double baselineMedianNs;
+    double currentMedianNs;
+    double baselineP95Ns;
+    double currentP95Ns;
+    /// Change of the median in percent.
+    double change;
+} SSKReplayComparison;
+
+SSKReplayComparison SSKReplayTraceCompare(const SSKReplayTrace *baseline, const SSKReplayTrace *current);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKReplay_h */
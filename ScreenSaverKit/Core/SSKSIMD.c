@@ -0,0 +1,82 @@
+#include "SSKSIMD.h"
+
+#include <stdatomic.h>
+
+static bool SSKSIMDDetect(SSKSIMDLevel level) {
+    switch (level) {
+        case SSKSIMDLevelScalar:
+            return true;
+#if defined(__x86_64__)
+        case SSKSIMDLevelSSE2:
+            return true;
+        case SSKSIMDLevelAVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SSKSIMDLevelAVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f");
+#endif
+#if defined(__aarch64__)
+        case SSKSIMDLevelNEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+bool SSKSIMDLevelIsSupported(SSKSIMDLevel level) {
+    static _Atomic(int) cache[SSKSIMDLevelCount];
+    if (level < SSKSIMDLevelScalar || level >= SSKSIMDLevelCount) {
+        return false;
+    }
+    // 0 = unknown, 1 = supported, 2 = unsupported. Pool workers call this
+    // concurrently; detection is idempotent, so two threads that both miss
+    // store the same answer and relaxed ordering is enough.
+    int state = atomic_load_explicit(&cache[level], memory_order_relaxed);
+    if (state == 0) {
+        state = SSKSIMDDetect(level) ? 1 : 2;
+        atomic_store_explicit(&cache[level], state, memory_order_relaxed);
+    }
+    return state == 1;
+}
+
+SSKSIMDLevel SSKSIMDBestLevel(void) {
+    static const SSKSIMDLevel preference[] = {
+        SSKSIMDLevelAVX512,
+        SSKSIMDLevelAVX2,
+        SSKSIMDLevelNEON,
+        SSKSIMDLevelSSE2,
+    };
+    for (unsigned i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+        if (SSKSIMDLevelIsSupported(preference[i])) {
+            return preference[i];
+        }
+    }
+    return SSKSIMDLevelScalar;
+}
+
+uint32_t SSKSIMDLevelWidth(SSKSIMDLevel level) {
+    switch (level) {
+        case SSKSIMDLevelSSE2:
+        case SSKSIMDLevelNEON:
+            return 4;
+        case SSKSIMDLevelAVX2:
+            return 8;
+        case SSKSIMDLevelAVX512:
+            return 16;
+        default:
+            return 1;
+    }
+}
+
+const char *SSKSIMDLevelName(SSKSIMDLevel level) {
+    switch (level) {
+        case SSKSIMDLevelScalar: return "scalar";
+        case SSKSIMDLevelSSE2:   return "sse2";
+        case SSKSIMDLevelAVX2:   return "avx2";
+        case SSKSIMDLevelAVX512: return "avx512";
+        case SSKSIMDLevelNEON:   return "neon";
+        default:                 return "unknown";
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef SSKSIMD_h
+#define SSKSIMD_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Instruction set levels the vectorised core kernels are built for. Levels are
+/// compiled per function with target attributes and chosen at runtime, so a
+/// single binary (including macOS universal builds) runs everywhere.
+typedef enum {
+    SSKSIMDLevelScalar = 0,
+    SSKSIMDLevelSSE2,    ///< 4 lanes, x86_64 baseline.
+    SSKSIMDLevelAVX2,    ///< 8 lanes, requires AVX2 + FMA.
+    SSKSIMDLevelAVX512,  ///< 16 lanes, requires AVX-512F.
+    SSKSIMDLevelNEON,    ///< 4 lanes, arm64 baseline.
+    SSKSIMDLevelCount
+} SSKSIMDLevel;
+
+/// Widest level supported by the running CPU. Detected once and cached.
+SSKSIMDLevel SSKSIMDBestLevel(void);
+
+/// Returns true when kernels for `level` are compiled in and the CPU supports them.
+bool SSKSIMDLevelIsSupported(SSKSIMDLevel level);
+
+/// Number of float lanes processed per iteration at `level` (1 for scalar).
+uint32_t SSKSIMDLevelWidth(SSKSIMDLevel level);
+
+/// Short human readable name, e.g. "avx2".
+const char *SSKSIMDLevelName(SSKSIMDLevel level);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKSIMD_h */
@@ -0,0 +1,84 @@
+#include "SSKSlotAllocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t SSKSlotAllocatorWordCount(uint32_t capacity) {
+    return (capacity + 63u) / 64u;
+}
+
+bool SSKSlotAllocatorInit(SSKSlotAllocator *allocator, uint32_t capacity) {
+    memset(allocator, 0, sizeof(*allocator));
+    if (capacity == 0) { return false; }
+    allocator->capacity = capacity;
+    allocator->freeStack = malloc(sizeof(uint32_t) * capacity);
+    allocator->occupied = calloc(SSKSlotAllocatorWordCount(capacity), sizeof(uint64_t));
+    if (!allocator->freeStack || !allocator->occupied) {
+        return false;
+    }
+    SSKSlotAllocatorReset(allocator);
+    return true;
+}
+
+void SSKSlotAllocatorDestroy(SSKSlotAllocator *allocator) {
+    if (!allocator) { return; }
+    free(allocator->freeStack);
+    free(allocator->occupied);
+    memset(allocator, 0, sizeof(*allocator));
+}
+
+void SSKSlotAllocatorReset(SSKSlotAllocator *allocator) {
+    uint32_t capacity = allocator->capacity;
+    memset(allocator->occupied, 0, sizeof(uint64_t) * SSKSlotAllocatorWordCount(capacity));
+    // Push in reverse so the lowest slots are handed out first.
+    allocator->freeCount = capacity;
+    for (uint32_t i = 0; i < capacity; i++) {
+        allocator->freeStack[i] = capacity - 1 - i;
+    }
+}
+
+uint32_t SSKSlotAllocatorAcquire(SSKSlotAllocator *allocator, uint32_t count, uint32_t *outSlots) {
+    if (count > allocator->freeCount) {
+        count = allocator->freeCount;
+    }
+    uint32_t *top = allocator->freeStack + allocator->freeCount;
+    uint64_t *occupied = allocator->occupied;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = *--top;
+        occupied[slot >> 6] |= UINT64_C(1) << (slot & 63u);
+        outSlots[i] = slot;
+    }
+    allocator->freeCount -= count;
+    return count;
+}
+
+uint32_t SSKSlotAllocatorRelease(SSKSlotAllocator *allocator, const uint32_t *slots, uint32_t count) {
+    uint64_t *occupied = allocator->occupied;
+    uint32_t *stack = allocator->freeStack;
+    uint32_t freeCount = allocator->freeCount;
+    uint32_t released = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = slots[i];
+        if (slot >= allocator->capacity) { continue; }
+        uint64_t bit = UINT64_C(1) << (slot & 63u);
+        if ((occupied[slot >> 6] & bit) == 0) { continue; }
+        occupied[slot >> 6] &= ~bit;
+        stack[freeCount++] = slot;
+        released++;
+    }
+    allocator->freeCount = freeCount;
+    return released;
+}
+
+void SSKSlotAllocatorRebuild(SSKSlotAllocator *allocator, const uint32_t *heldFlags) {
+    uint32_t capacity = allocator->capacity;
+    memset(allocator->occupied, 0, sizeof(uint64_t) * SSKSlotAllocatorWordCount(capacity));
+    allocator->freeCount = 0;
+    for (uint32_t slot = capacity; slot-- > 0;) {
+        if (heldFlags[slot]) {
+            allocator->occupied[slot >> 6] |= UINT64_C(1) << (slot & 63u);
+        } else {
+            allocator->freeStack[allocator->freeCount++] = slot;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SSKSlotAllocator_h
+#define SSKSlotAllocator_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Fixed-capacity allocator for slot indices in `[0, capacity)`.
+///
+/// Free slots live on a stack, so acquiring or releasing a batch of `n` slots
+/// is `O(n)` with no searching. A parallel occupancy bitset records which slots
+/// are held; it makes membership tests `O(1)` and lets `Release` ignore slots
+/// that are already free, which keeps it safe to feed with dead lists that may
+/// overlap a rebuild.
+typedef struct {
+    uint32_t capacity;
+    /// Free slots, `freeCount` entries long. Acquired from the end.
+    uint32_t *freeStack;
+    uint32_t freeCount;
+    /// One bit per slot, set while the slot is held.
+    uint64_t *occupied;
+} SSKSlotAllocator;
+
+/// Allocates storage for `capacity` slots and marks every slot free. Returns
+/// false on allocation failure (the allocator is then safe to destroy).
+bool SSKSlotAllocatorInit(SSKSlotAllocator *allocator, uint32_t capacity);
+
+void SSKSlotAllocatorDestroy(SSKSlotAllocator *allocator);
+
+/// Marks every slot free. Slots are handed out lowest first afterwards.
+void SSKSlotAllocatorReset(SSKSlotAllocator *allocator);
+
+/// Acquires up to `count` slots, writing them to `outSlots`. Returns how many
+/// were acquired. Slots come back in the reverse order they were released.
+uint32_t SSKSlotAllocatorAcquire(SSKSlotAllocator *allocator, uint32_t count, uint32_t *outSlots);
+
+/// Returns `count` slots to the free stack in order. Slots that are not held
+/// are skipped. Returns how many were actually released.
+uint32_t SSKSlotAllocatorRelease(SSKSlotAllocator *allocator, const uint32_t *slots, uint32_t count);
+
+/// Rebuilds the free stack and bitset from a per-slot flag array, treating
+/// non-zero entries as held. Free slots are stacked so the lowest comes first.
+void SSKSlotAllocatorRebuild(SSKSlotAllocator *allocator, const uint32_t *heldFlags);
+
+static inline bool SSKSlotAllocatorIsHeld(const SSKSlotAllocator *allocator, uint32_t slot) {
+    return (allocator->occupied[slot >> 6] >> (slot & 63u)) & 1u;
+}
+
+/// Single-slot release for hot loops that retire one slot at a time.
+/// The caller guarantees `slot` is held.
+static inline void SSKSlotAllocatorReleaseOne(SSKSlotAllocator *allocator, uint32_t slot) {
+    allocator->occupied[slot >> 6] &= ~(UINT64_C(1) << (slot & 63u));
+    allocator->freeStack[allocator->freeCount++] = slot;
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKSlotAllocator_h */
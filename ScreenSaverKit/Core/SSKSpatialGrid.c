@@ -0,0 +1,235 @@
+#include "SSKSpatialGrid.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool SSKSpatialGridInit(SSKSpatialGrid *grid, uint32_t capacity) {
+    memset(grid, 0, sizeof(*grid));
+    if (capacity == 0) { return false; }
+    grid->capacity = capacity;
+    // Two cells per particle is plenty for any density worth indexing and
+    // bounds the prefix sum when particles are spread out.
+    grid->maxCells = capacity * 2u;
+    grid->cellStart = malloc(sizeof(uint32_t) * ((size_t)grid->maxCells + 1));
+    grid->slots = malloc(sizeof(uint32_t) * capacity);
+    grid->positions = malloc(sizeof(SSKFloat2) * capacity);
+    grid->entryCell = malloc(sizeof(uint32_t) * capacity);
+    grid->scratch = malloc(sizeof(SSKFloat2) * capacity);
+    if (!grid->cellStart || !grid->slots || !grid->positions || !grid->entryCell || !grid->scratch) {
+        return false;
+    }
+    grid->cellStart[0] = 0;
+    return true;
+}
+
+void SSKSpatialGridDestroy(SSKSpatialGrid *grid) {
+    if (!grid) { return; }
+    free(grid->cellStart);
+    free(grid->slots);
+    free(grid->positions);
+    free(grid->entryCell);
+    free(grid->scratch);
+    memset(grid, 0, sizeof(*grid));
+}
+
+static inline bool SSKSpatialGridIndexes(const SSKParticleCore *core, uint32_t slot) {
+    return core->alive[slot] && isfinite(core->position[slot].x) && isfinite(core->position[slot].y);
+}
+
+/// Cell coordinate of `value` along one axis, clamped to `[0, limit)`.
+static inline uint32_t SSKSpatialGridAxisCell(float value, float origin, float inverseCellSize, uint32_t limit) {
+    float cell = (value - origin) * inverseCellSize;
+    if (!(cell > 0.0f)) { return 0; }
+    if (cell >= (float)limit) { return limit - 1; }
+    return (uint32_t)cell;
+}
+
+void SSKSpatialGridBuild(SSKSpatialGrid *grid, const SSKParticleCore *core, float cellSize) {
+    grid->count = 0;
+    grid->cellCount = 0;
+    grid->columns = 0;
+    grid->rows = 0;
+    grid->cellStart[0] = 0;
+
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = core->aliveList[i];
+        if (!SSKSpatialGridIndexes(core, slot)) { continue; }
+        SSKFloat2 p = core->position[slot];
+        minX = fminf(minX, p.x);
+        minY = fminf(minY, p.y);
+        maxX = fmaxf(maxX, p.x);
+        maxY = fmaxf(maxY, p.y);
+        count++;
+    }
+    if (count == 0) { return; }
+
+    // Double the cell size until the bounding box fits in `maxCells`. Queries
+    // stay exact either way; they just scan fuller cells.
+    if (!(cellSize > 0.0f)) { cellSize = 1.0f; }
+    double columns, rows;
+    for (;;) {
+        columns = floor((double)(maxX - minX) / cellSize) + 1.0;
+        rows = floor((double)(maxY - minY) / cellSize) + 1.0;
+        if (columns * rows <= (double)grid->maxCells) { break; }
+        cellSize *= 2.0f;
+    }
+    grid->cellSize = cellSize;
+    grid->inverseCellSize = 1.0f / cellSize;
+    grid->origin = SSKFloat2Make(minX, minY);
+    grid->columns = (uint32_t)columns;
+    grid->rows = (uint32_t)rows;
+    grid->cellCount = grid->columns * grid->rows;
+    grid->count = count;
+
+    // Counting sort: histogram, exclusive prefix sum, scatter.
+    uint32_t *cellStart = grid->cellStart;
+    uint32_t *entryCell = grid->entryCell;
+    memset(cellStart, 0, sizeof(uint32_t) * ((size_t)grid->cellCount + 1));
+    uint32_t entry = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = core->aliveList[i];
+        if (!SSKSpatialGridIndexes(core, slot)) { continue; }
+        SSKFloat2 p = core->position[slot];
+        uint32_t cx = SSKSpatialGridAxisCell(p.x, minX, grid->inverseCellSize, grid->columns);
+        uint32_t cy = SSKSpatialGridAxisCell(p.y, minY, grid->inverseCellSize, grid->rows);
+        uint32_t cell = cy * grid->columns + cx;
+        entryCell[entry++] = cell;
+        cellStart[cell]++;
+    }
+    uint32_t running = 0;
+    for (uint32_t c = 0; c < grid->cellCount; c++) {
+        uint32_t cellCount = cellStart[c];
+        cellStart[c] = running;
+        running += cellCount;
+    }
+    // Scattering advances each cell's start to its end, i.e. the next cell's
+    // start; shifting by one afterwards restores the prefix offsets.
+    entry = 0;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t slot = core->aliveList[i];
+        if (!SSKSpatialGridIndexes(core, slot)) { continue; }
+        uint32_t target = cellStart[entryCell[entry++]]++;
+        grid->slots[target] = slot;
+        grid->positions[target] = core->position[slot];
+    }
+    memmove(cellStart + 1, cellStart, sizeof(uint32_t) * grid->cellCount);
+    cellStart[0] = 0;
+}
+
+/// Cell rectangle covering the square of half-size `radius` around `center`.
+typedef struct {
+    uint32_t x0, x1, y0, y1;
+} SSKSpatialGridRect;
+
+static inline SSKSpatialGridRect SSKSpatialGridRectAround(const SSKSpatialGrid *grid, SSKFloat2 center, float radius) {
+    SSKSpatialGridRect rect;
+    float inverse = grid->inverseCellSize;
+    rect.x0 = SSKSpatialGridAxisCell(center.x - radius, grid->origin.x, inverse, grid->columns);
+    rect.x1 = SSKSpatialGridAxisCell(center.x + radius, grid->origin.x, inverse, grid->columns);
+    rect.y0 = SSKSpatialGridAxisCell(center.y - radius, grid->origin.y, inverse, grid->rows);
+    rect.y1 = SSKSpatialGridAxisCell(center.y + radius, grid->origin.y, inverse, grid->rows);
+    return rect;
+}
+
+void SSKSpatialGridForEachNeighbour(const SSKSpatialGrid *grid, SSKFloat2 center, float radius,
+                                    SSKSpatialGridVisitor visitor, void *context) {
+    if (!grid || !visitor || grid->count == 0 || !(radius >= 0.0f)) { return; }
+    float radiusSquared = radius * radius;
+    SSKSpatialGridRect rect = SSKSpatialGridRectAround(grid, center, radius);
+    for (uint32_t cy = rect.y0; cy <= rect.y1; cy++) {
+        // Cells along a row are adjacent in the sorted order, so one row of
+        // the query rectangle is a single contiguous run of entries.
+        uint32_t row = cy * grid->columns;
+        uint32_t end = grid->cellStart[row + rect.x1 + 1];
+        for (uint32_t e = grid->cellStart[row + rect.x0]; e < end; e++) {
+            SSKFloat2 offset = SSKFloat2Make(grid->positions[e].x - center.x, grid->positions[e].y - center.y);
+            float distanceSquared = offset.x * offset.x + offset.y * offset.y;
+            if (distanceSquared > radiusSquared) { continue; }
+            if (!visitor(context, grid->slots[e], offset, distanceSquared)) { return; }
+        }
+    }
+}
+
+typedef struct {
+    uint32_t *slots;
+    uint32_t count;
+    uint32_t maxCount;
+} SSKSpatialGridQueryState;
+
+static bool SSKSpatialGridCollect(void *context, uint32_t slot, SSKFloat2 offset, float distanceSquared) {
+    (void)offset;
+    (void)distanceSquared;
+    SSKSpatialGridQueryState *state = context;
+    state->slots[state->count++] = slot;
+    return state->count < state->maxCount;
+}
+
+uint32_t SSKSpatialGridQuery(const SSKSpatialGrid *grid, SSKFloat2 center, float radius,
+                             uint32_t *outSlots, uint32_t maxCount) {
+    if (maxCount == 0) { return 0; }
+    SSKSpatialGridQueryState state = {outSlots, 0, maxCount};
+    SSKSpatialGridForEachNeighbour(grid, center, radius, SSKSpatialGridCollect, &state);
+    return state.count;
+}
+
+void SSKParticleCoreApplyFlocking(SSKParticleCore *core, SSKSpatialGrid *grid,
+                                  const SSKParticleFlockingParams *params, float dt) {
+    if (!core || !grid || !params || grid->count == 0) { return; }
+    float radius = fmaxf(params->radius, 0.0f);
+    float separationRadius = fmaxf(params->separationRadius, 0.0f);
+    float reach = fmaxf(radius, separationRadius);
+    if (!(reach > 0.0f)) { return; }
+    float radiusSquared = radius * radius;
+    float separationSquared = separationRadius * separationRadius;
+    float inverseSeparation = separationRadius > 0.0f ? 1.0f / separationRadius : 0.0f;
+
+    // Walk the grid in sorted order so neighbouring particles, and the cells
+    // they scan, stay hot in cache from one particle to the next.
+    const SSKFloat2 *positions = grid->positions;
+    SSKFloat2 *steering = grid->scratch;
+    for (uint32_t e = 0; e < grid->count; e++) {
+        SSKFloat2 p = positions[e];
+        SSKSpatialGridRect rect = SSKSpatialGridRectAround(grid, p, reach);
+        float pushX = 0.0f, pushY = 0.0f;
+        float sumX = 0.0f, sumY = 0.0f;
+        uint32_t neighbours = 0;
+        for (uint32_t cy = rect.y0; cy <= rect.y1; cy++) {
+            uint32_t row = cy * grid->columns;
+            uint32_t end = grid->cellStart[row + rect.x1 + 1];
+            for (uint32_t j = grid->cellStart[row + rect.x0]; j < end; j++) {
+                if (j == e) { continue; }
+                float dx = positions[j].x - p.x;
+                float dy = positions[j].y - p.y;
+                float distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared < separationSquared && distanceSquared > 0.0f) {
+                    float distance = sqrtf(distanceSquared);
+                    float weight = (1.0f - distance * inverseSeparation) / distance;
+                    pushX -= dx * weight;
+                    pushY -= dy * weight;
+                }
+                if (distanceSquared <= radiusSquared) {
+                    sumX += dx;
+                    sumY += dy;
+                    neighbours++;
+                }
+            }
+        }
+        float steerX = pushX * params->separation;
+        float steerY = pushY * params->separation;
+        if (neighbours > 0) {
+            float inverseCount = 1.0f / (float)neighbours;
+            steerX += sumX * inverseCount * params->cohesion;
+            steerY += sumY * inverseCount * params->cohesion;
+        }
+        steering[e] = SSKFloat2Make(steerX, steerY);
+    }
+
+    for (uint32_t e = 0; e < grid->count; e++) {
+        uint32_t slot = grid->slots[e];
+        core->velocity[slot].x += steering[e].x * dt;
+        core->velocity[slot].y += steering[e].y * dt;
+    }
+}
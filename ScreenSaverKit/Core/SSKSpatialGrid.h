@@ -0,0 +1,92 @@
+#ifndef SSKSpatialGrid_h
+#define SSKSpatialGrid_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKParticleCore.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Uniform-grid spatial index over the live particles of an `SSKParticleCore`.
+///
+/// `Build` bins every live slot into square cells with a counting sort (count
+/// per cell, prefix sum, scatter), so a rebuild is `O(n + cells)` with no
+/// comparisons and no per-cell allocations. Afterwards the slots of cell `c`
+/// are `slots[cellStart[c] .. cellStart[c + 1])`, and `positions` holds their
+/// positions in the same order so queries stream through contiguous memory
+/// instead of gathering from the position stream.
+///
+/// The grid covers the bounding box of the particles it was built from and is
+/// a snapshot: it does not follow later moves, spawns or deaths.
+typedef struct {
+    uint32_t capacity;
+    /// Cell edge length used by the last build. It can exceed the requested size
+    /// when the particles are spread so thinly that the grid would need more than
+    /// `maxCells` cells.
+    float cellSize;
+    float inverseCellSize;
+    SSKFloat2 origin;
+    uint32_t columns;
+    uint32_t rows;
+    uint32_t cellCount;
+    uint32_t maxCells;
+    /// `cellCount + 1` prefix offsets into `slots`.
+    uint32_t *cellStart;
+    /// Indexed slots sorted by cell, `count` entries long.
+    uint32_t *slots;
+    /// Positions of `slots`, in the same order.
+    SSKFloat2 *positions;
+    uint32_t count;
+    /// Per-entry cell index, used while sorting.
+    uint32_t *entryCell;
+    /// Per-entry scratch for behaviours that accumulate before writing back.
+    SSKFloat2 *scratch;
+} SSKSpatialGrid;
+
+/// Allocates a grid able to index `capacity` particles. Returns false on
+/// allocation failure (the grid is then safe to destroy).
+bool SSKSpatialGridInit(SSKSpatialGrid *grid, uint32_t capacity);
+
+void SSKSpatialGridDestroy(SSKSpatialGrid *grid);
+
+/// Re-bins every live particle of `core` into cells of roughly `cellSize`
+/// points. A cell size close to the usual query radius keeps queries to a
+/// 3x3 block of cells.
+void SSKSpatialGridBuild(SSKSpatialGrid *grid, const SSKParticleCore *core, float cellSize);
+
+/// Called once per indexed particle within the query radius. `offset` is the
+/// particle's position minus the query centre. Return false to stop early.
+typedef bool (*SSKSpatialGridVisitor)(void *context, uint32_t slot, SSKFloat2 offset, float distanceSquared);
+
+/// Visits every indexed particle within `radius` of `center`, cell by cell.
+void SSKSpatialGridForEachNeighbour(const SSKSpatialGrid *grid, SSKFloat2 center, float radius,
+                                    SSKSpatialGridVisitor visitor, void *context);
+
+/// Writes up to `maxCount` slots within `radius` of `center` to `outSlots`
+/// and returns how many were written.
+uint32_t SSKSpatialGridQuery(const SSKSpatialGrid *grid, SSKFloat2 center, float radius,
+                             uint32_t *outSlots, uint32_t maxCount);
+
+/// Separation/cohesion steering. Neighbours closer than `separationRadius`
+/// push a particle away, more strongly the closer they are; neighbours within
+/// `radius` pull it towards their centroid. Both terms are accelerations in
+/// points per second squared per unit of strength.
+typedef struct {
+    float radius;
+    float separationRadius;
+    float separation;
+    float cohesion;
+} SSKParticleFlockingParams;
+
+/// Applies flocking to the velocity of every particle indexed by `grid`,
+/// which must have been built from `core`. Steering is accumulated for all
+/// particles before any velocity changes, so the result does not depend on
+/// iteration order. `O(n * k)` for `k` neighbours per particle.
+void SSKParticleCoreApplyFlocking(SSKParticleCore *core, SSKSpatialGrid *grid,
+                                  const SSKParticleFlockingParams *params, float dt);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKSpatialGrid_h */
@@ -0,0 +1,229 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKStarfield.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The vector kernels promise the same bits as the scalar loops, so no
+// multiply-add may be fused in one and not the other. GCC already keeps them
+// apart in ISO C mode.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+static const size_t kSSKStarfieldStreamAlignment = 64;
+static const uint32_t kSSKStarfieldPadding = 16;
+static const uint32_t kSSKStarfieldStreamCount = 6;
+
+/// One star after projection: its current and previous screen points and
+/// the size and grey level of its quad.
+typedef struct {
+    float px;
+    float py;
+    float qx;
+    float qy;
+    float radius;
+    float brightness;
+} SSKStarfieldPoint;
+
+static void SSKStarfieldSpawn(SSKStarfield *field, uint32_t i) {
+    float angle = SSKRandomNextUnit(&field->random) * 6.28318531f;
+    float radius = sqrtf(SSKRandomNextUnit(&field->random)) * 1.6f;
+    float x = cosf(angle) * radius;
+    float y = sinf(angle) * radius;
+    float z = 1.0f + SSKRandomNextUnit(&field->random) * 1.9f;
+    field->x[i] = field->prevX[i] = x;
+    field->y[i] = field->prevY[i] = y;
+    field->z[i] = field->prevZ[i] = z;
+}
+
+/// Writes the star quad and, when it is long enough to see, the streak from
+/// the star back along its screen motion. Returns how many were written.
+static inline uint32_t SSKStarfieldEmit(const SSKStarfieldProjection *projection, const SSKStarfieldPoint *point,
+                                 SSKParticleInstance *out, uint32_t remaining) {
+    if (remaining == 0) { return 0; }
+    SSKFloat4 color = SSKFloat4Make(point->brightness, point->brightness, point->brightness, 1.0f);
+    float diameter = point->radius * 2.0f;
+    // A soft falloff rounds the quad into a disc.
+    out[0] = (SSKParticleInstance){
+        SSKFloat2Make(point->px, point->py), SSKFloat2Make(1.0f, 0.0f), diameter, diameter, {0}, color, 2.0f, {0},
+    };
+    if (projection->tail <= 0.01f || remaining < 2) { return 1; }
+    float dx = (point->qx - point->px) * projection->tail;
+    float dy = (point->qy - point->py) * projection->tail;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < 0.5f) { return 1; }
+    color.w = 0.55f;
+    out[1] = (SSKParticleInstance){
+        SSKFloat2Make(point->px + dx * 0.5f, point->py + dy * 0.5f),
+        SSKFloat2Make(dx / length, dy / length),
+        fmaxf(0.6f, point->radius * 0.6f),
+        length,
+        {0},
+        color,
+        0.0f,
+        {0},
+    };
+    return 2;
+}
+
+#if defined(__x86_64__)
+
+#define SSK_STAR_WIDTH 4
+#define SSK_STAR_SUFFIX SSE2
+#define SSK_STAR_TARGET __attribute__((target("sse2")))
+#include "SSKStarfieldKernel.inc"
+
+#define SSK_STAR_WIDTH 8
+#define SSK_STAR_SUFFIX AVX2
+#define SSK_STAR_TARGET __attribute__((target("avx2,fma")))
+#include "SSKStarfieldKernel.inc"
+
+#define SSK_STAR_WIDTH 16
+#define SSK_STAR_SUFFIX AVX512
+#define SSK_STAR_TARGET __attribute__((target("avx512f")))
+#include "SSKStarfieldKernel.inc"
+
+#endif
+
+#if defined(__aarch64__)
+
+#define SSK_STAR_WIDTH 4
+#define SSK_STAR_SUFFIX NEON
+#define SSK_STAR_TARGET
+#include "SSKStarfieldKernel.inc"
+
+#endif
+
+typedef uint32_t (*SSKStarfieldStepKernel)(SSKStarfield *field, const SSKStarfieldStepParams *params);
+typedef uint32_t (*SSKStarfieldProjectKernel)(const SSKStarfield *field, const SSKStarfieldProjection *projection,
+                                              SSKParticleInstance *out, uint32_t maxCount, uint32_t *written);
+
+static SSKStarfieldStepKernel SSKStarfieldStepKernelForLevel(SSKSIMDLevel level) {
+    if (!SSKSIMDLevelIsSupported(level)) { return NULL; }
+    switch (level) {
+#if defined(__x86_64__)
+        case SSKSIMDLevelSSE2:   return SSKStarfieldStepBlocksSSE2;
+        case SSKSIMDLevelAVX2:   return SSKStarfieldStepBlocksAVX2;
+        case SSKSIMDLevelAVX512: return SSKStarfieldStepBlocksAVX512;
+#endif
+#if defined(__aarch64__)
+        case SSKSIMDLevelNEON:   return SSKStarfieldStepBlocksNEON;
+#endif
+        default:                 return NULL;
+    }
+}
+
+static SSKStarfieldProjectKernel SSKStarfieldProjectKernelForLevel(SSKSIMDLevel level) {
+    if (!SSKSIMDLevelIsSupported(level)) { return NULL; }
+    switch (level) {
+#if defined(__x86_64__)
+        case SSKSIMDLevelSSE2:   return SSKStarfieldProjectBlocksSSE2;
+        case SSKSIMDLevelAVX2:   return SSKStarfieldProjectBlocksAVX2;
+        case SSKSIMDLevelAVX512: return SSKStarfieldProjectBlocksAVX512;
+#endif
+#if defined(__aarch64__)
+        case SSKSIMDLevelNEON:   return SSKStarfieldProjectBlocksNEON;
+#endif
+        default:                 return NULL;
+    }
+}
+
+static uint32_t SSKStarfieldPaddedCapacity(uint32_t count) {
+    return (count + kSSKStarfieldPadding - 1) / kSSKStarfieldPadding * kSSKStarfieldPadding;
+}
+
+SSKStarfield *SSKStarfieldCreate(uint32_t count, uint64_t seed) {
+    if (count == 0) { return NULL; }
+    SSKStarfield *field = calloc(1, sizeof(SSKStarfield));
+    if (!field) { return NULL; }
+    field->random = SSKRandomMake(seed);
+    field->simdLevel = SSKSIMDBestLevel();
+    if (!SSKStarfieldSetCount(field, count)) {
+        free(field);
+        return NULL;
+    }
+    return field;
+}
+
+void SSKStarfieldDestroy(SSKStarfield *field) {
+    if (!field) { return; }
+    free(field->storage);
+    free(field);
+}
+
+bool SSKStarfieldSetCount(SSKStarfield *field, uint32_t count) {
+    if (!field || count == 0 || count > UINT32_MAX - kSSKStarfieldPadding) { return false; }
+    if (count > field->capacity) {
+        uint32_t capacity = SSKStarfieldPaddedCapacity(count);
+        size_t streamLength = (size_t)capacity * sizeof(float);
+        void *storage = NULL;
+        if (posix_memalign(&storage, kSSKStarfieldStreamAlignment, streamLength * kSSKStarfieldStreamCount) != 0) {
+            return false;
+        }
+        free(field->storage);
+        field->storage = storage;
+        field->capacity = capacity;
+        float *base = storage;
+        field->x = base;
+        field->y = base + capacity;
+        field->z = base + 2 * (size_t)capacity;
+        field->prevX = base + 3 * (size_t)capacity;
+        field->prevY = base + 4 * (size_t)capacity;
+        field->prevZ = base + 5 * (size_t)capacity;
+    }
+    field->count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        SSKStarfieldSpawn(field, i);
+    }
+    return true;
+}
+
+void SSKStarfieldStep(SSKStarfield *field, const SSKStarfieldStepParams *params) {
+    if (!field || !params) { return; }
+    SSKStarfieldStepKernel kernel = SSKStarfieldStepKernelForLevel(field->simdLevel);
+    uint32_t i = kernel ? kernel(field, params) : 0;
+    for (; i < field->count; i++) {
+        field->prevX[i] = field->x[i];
+        field->prevY[i] = field->y[i];
+        field->prevZ[i] = field->z[i];
+        float z = field->z[i] - params->depthVelocity;
+        float x = field->x[i] + params->drift.x;
+        float y = field->y[i] + params->drift.y;
+        field->x[i] = x;
+        field->y[i] = y;
+        field->z[i] = z;
+        if (z <= 0.15f || fabsf(x) > 2.5f || fabsf(y) > 2.5f) {
+            SSKStarfieldSpawn(field, i);
+        }
+    }
+}
+
+uint32_t SSKStarfieldWriteInstances(const SSKStarfield *field, const SSKStarfieldProjection *projection,
+                                    SSKParticleInstance *out, uint32_t maxCount) {
+    if (!field || !projection || !out) { return 0; }
+    SSKStarfieldProjectKernel kernel = SSKStarfieldProjectKernelForLevel(field->simdLevel);
+    uint32_t count = 0;
+    uint32_t i = kernel ? kernel(field, projection, out, maxCount, &count) : 0;
+    for (; i < field->count && count < maxCount; i++) {
+        float z = field->z[i];
+        float depthScale = 1.0f / fmaxf(z, 0.05f);
+        float prevDepthScale = 1.0f / fmaxf(field->prevZ[i], 0.05f);
+        SSKStarfieldPoint point;
+        point.px = projection->center.x + field->x[i] * projection->scale.x * depthScale;
+        point.py = projection->center.y + field->y[i] * projection->scale.y * depthScale;
+        point.qx = projection->center.x + field->prevX[i] * projection->scale.x * prevDepthScale;
+        point.qy = projection->center.y + field->prevY[i] * projection->scale.y * prevDepthScale;
+        if (!(z > 0.02f && point.px >= projection->boundsMin.x && point.px < projection->boundsMax.x &&
+              point.py >= projection->boundsMin.y && point.py < projection->boundsMax.y)) {
+            continue;
+        }
+        float inverseDepth = 1.0f / fmaxf(z, 0.2f);
+        point.radius = (projection->baseRadius + inverseDepth * 7.0f) * projection->sizeScale;
+        point.brightness = fminf(0.25f + inverseDepth * 1.8f, 1.0f);
+        count += SSKStarfieldEmit(projection, &point, out + count, maxCount - count);
+    }
+    return count;
+}
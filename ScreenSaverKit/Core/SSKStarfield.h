@@ -0,0 +1,90 @@
+#ifndef SSKStarfield_h
+#define SSKStarfield_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKParticleInstances.h"
+#include "SSKRandom.h"
+#include "SSKSIMD.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Stars flying towards the camera, stored structure-of-arrays.
+///
+/// A star sits at `(x, y)` in the field plane and `z` in front of the camera;
+/// each step moves it closer and sideways and respawns it once it gets too
+/// close or drifts out of the field. Respawns draw from `random` in star
+/// order, so a seed reproduces the same field whatever the SIMD level.
+typedef struct {
+    float *x;
+    float *y;
+    float *z;
+    /// Position before the last step, for motion streaks.
+    float *prevX;
+    float *prevY;
+    float *prevZ;
+    uint32_t count;
+    uint32_t capacity;
+    SSKRandom random;
+    /// Kernels used by step and projection. Defaults to `SSKSIMDBestLevel()`;
+    /// `SSKSIMDLevelScalar` forces the scalar loops. Every level produces the
+    /// same bits.
+    SSKSIMDLevel simdLevel;
+    void *storage;
+} SSKStarfield;
+
+/// Motion of one step, shared by every star.
+typedef struct {
+    /// How far each star moves towards the camera.
+    float depthVelocity;
+    /// How far each star moves in the field plane.
+    SSKFloat2 drift;
+} SSKStarfieldStepParams;
+
+/// How stars map onto particle quads.
+typedef struct {
+    /// Where a star on the axis lands.
+    SSKFloat2 center;
+    /// Offset of a star at `(1, 1)` and depth 1 from `center`. Screen offsets
+    /// shrink with `1 / z`; a negative `y` flips the field for y-down targets.
+    SSKFloat2 scale;
+    /// Stars whose current point falls outside `[boundsMin, boundsMax)` are culled.
+    SSKFloat2 boundsMin;
+    SSKFloat2 boundsMax;
+    /// Radius of a star at infinity; stars grow by 7 points per unit of `1 / z`.
+    float baseRadius;
+    /// Multiplies every radius.
+    float sizeScale;
+    /// Streak length as a fraction of the star's screen motion over the last
+    /// step; 0 draws no streaks.
+    float tail;
+} SSKStarfieldProjection;
+
+/// A star is a round quad plus, with `tail`, a streak quad behind it.
+enum { SSKStarfieldMaxInstancesPerStar = 2 };
+
+/// Creates a field of `count` random stars seeded with `seed`. Returns NULL
+/// when `count` is 0 or storage cannot be allocated.
+SSKStarfield *SSKStarfieldCreate(uint32_t count, uint64_t seed);
+
+void SSKStarfieldDestroy(SSKStarfield *field);
+
+/// Changes the star count and respawns every star. Storage only grows.
+/// Returns false (leaving the field as it was) if it cannot.
+bool SSKStarfieldSetCount(SSKStarfield *field, uint32_t count);
+
+/// Moves every star by `params` and respawns those that left the field.
+void SSKStarfieldStep(SSKStarfield *field, const SSKStarfieldStepParams *params);
+
+/// Writes the quads of every visible star into `out`, in star order, and
+/// returns how many were written (at most `maxCount`, which should be
+/// `count * SSKStarfieldMaxInstancesPerStar` for a full frame). `out` may be
+/// mapped GPU memory; it is only written, never read.
+uint32_t SSKStarfieldWriteInstances(const SSKStarfield *field, const SSKStarfieldProjection *projection,
+                                    SSKParticleInstance *out, uint32_t maxCount);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKStarfield_h */
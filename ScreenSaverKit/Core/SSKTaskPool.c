@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKTaskPool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/// One participant's run of chunks. Padded to a cache line so claims on one
+/// run do not bounce the lines of its neighbours.
+typedef struct {
+    _Alignas(64) atomic_uint next;
+    uint32_t end;
+} SSKTaskPoolRun;
+
+typedef struct {
+    SSKTaskPool *pool;
+    uint32_t index;
+} SSKTaskPoolWorker;
+
+struct SSKTaskPool {
+    uint32_t workerCount;
+    SSKTaskPoolRun *runs;
+    SSKTaskPoolWorker *workers;
+    pthread_t *threads;
+    uint32_t threadCount;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    uint64_t generation;
+    uint32_t pending;
+    bool stopping;
+
+    SSKTaskPoolChunkFunction function;
+    void *context;
+};
+
+uint32_t SSKTaskPoolHardwareConcurrency(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1u;
+}
+
+static void SSKTaskPoolDrain(SSKTaskPool *pool, uint32_t worker) {
+    uint32_t count = pool->workerCount;
+    // Own run first, then every other run starting with the next neighbour.
+    for (uint32_t offset = 0; offset < count; offset++) {
+        SSKTaskPoolRun *run = &pool->runs[(worker + offset) % count];
+        for (;;) {
+            uint32_t chunk = atomic_fetch_add_explicit(&run->next, 1u, memory_order_relaxed);
+            if (chunk >= run->end) { break; }
+            pool->function(pool->context, chunk, worker);
+        }
+    }
+}
+
+static void *SSKTaskPoolThreadMain(void *argument) {
+    SSKTaskPoolWorker *worker = argument;
+    SSKTaskPool *pool = worker->pool;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        }
+        if (pool->stopping) { break; }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        SSKTaskPoolDrain(pool, worker->index);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+SSKTaskPool *SSKTaskPoolCreate(uint32_t workerCount) {
+    if (workerCount == 0) {
+        workerCount = SSKTaskPoolHardwareConcurrency();
+    }
+    SSKTaskPool *pool = calloc(1, sizeof(SSKTaskPool));
+    if (!pool) { return NULL; }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->workerCount = workerCount;
+    void *runs = NULL;
+    if (posix_memalign(&runs, 64, sizeof(SSKTaskPoolRun) * workerCount) == 0) {
+        pool->runs = runs;
+    }
+    pool->workers = calloc(workerCount, sizeof(SSKTaskPoolWorker));
+    pool->threads = calloc(workerCount, sizeof(pthread_t));
+    if (!pool->runs || !pool->workers || !pool->threads) {
+        SSKTaskPoolDestroy(pool);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < workerCount; i++) {
+        atomic_init(&pool->runs[i].next, 0u);
+        pool->runs[i].end = 0;
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+    }
+
+    for (uint32_t i = 1; i < workerCount; i++) {
+        if (pthread_create(&pool->threads[pool->threadCount], NULL, SSKTaskPoolThreadMain, &pool->workers[i]) != 0) {
+            SSKTaskPoolDestroy(pool);
+            return NULL;
+        }
+        pool->threadCount++;
+    }
+    return pool;
+}
+
+void SSKTaskPoolDestroy(SSKTaskPool *pool) {
+    if (!pool) { return; }
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+    for (uint32_t i = 0; i < pool->threadCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+    free(pool->runs);
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
+
+uint32_t SSKTaskPoolWorkerCount(const SSKTaskPool *pool) {
+    return pool ? pool->workerCount : 1u;
+}
+
+void SSKTaskPoolParallelFor(SSKTaskPool *pool, uint32_t chunkCount,
+                            SSKTaskPoolChunkFunction function, void *context) {
+    if (chunkCount == 0 || !function) { return; }
+    if (!pool || pool->threadCount == 0 || chunkCount == 1) {
+        for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+            function(context, chunk, 0);
+        }
+        return;
+    }
+
+    // Split the chunks into one contiguous run per participant.
+    uint32_t count = pool->workerCount;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t begin = (uint32_t)((uint64_t)chunkCount * i / count);
+        uint32_t end = (uint32_t)((uint64_t)chunkCount * (i + 1) / count);
+        atomic_store_explicit(&pool->runs[i].next, begin, memory_order_relaxed);
+        pool->runs[i].end = end;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->function = function;
+    pool->context = context;
+    pool->pending = pool->threadCount;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    SSKTaskPoolDrain(pool, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
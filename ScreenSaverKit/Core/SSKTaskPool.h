@@ -0,0 +1,42 @@
+#ifndef SSKTaskPool_h
+#define SSKTaskPool_h
+
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Fixed-size pool of worker threads running parallel-for loops over chunks.
+///
+/// Each participant owns a contiguous run of chunk indices and claims them one
+/// at a time from the front; once its own run is empty it steals from the
+/// other runs the same way. Claiming is a single atomic increment, so there
+/// are no locks on the hot path. The calling thread always takes part as
+/// worker 0, so a pool of one worker spawns no threads at all.
+typedef struct SSKTaskPool SSKTaskPool;
+
+/// Work callback. `worker` is in `[0, SSKTaskPoolWorkerCount)` and can index
+/// per-worker scratch; `chunk` is in `[0, chunkCount)`. Each chunk runs once.
+typedef void (*SSKTaskPoolChunkFunction)(void *context, uint32_t chunk, uint32_t worker);
+
+/// Number of online CPUs (at least 1).
+uint32_t SSKTaskPoolHardwareConcurrency(void);
+
+/// Creates a pool with `workerCount` participants including the caller.
+/// Zero means `SSKTaskPoolHardwareConcurrency()`. Returns NULL on failure.
+SSKTaskPool *SSKTaskPoolCreate(uint32_t workerCount);
+
+/// Stops and joins the workers.
+void SSKTaskPoolDestroy(SSKTaskPool *pool);
+
+uint32_t SSKTaskPoolWorkerCount(const SSKTaskPool *pool);
+
+/// Runs `function` for every chunk in `[0, chunkCount)` and returns once all
+/// of them finished. Not reentrant: one loop per pool at a time.
+void SSKTaskPoolParallelFor(SSKTaskPool *pool, uint32_t chunkCount,
+                            SSKTaskPoolChunkFunction function, void *context);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKTaskPool_h */
@@ -0,0 +1,264 @@
+#include "SSKTexturePool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum { SSKTexturePoolNone = UINT32_MAX, SSKTexturePoolInitialBuckets = 16 };
+
+/// One idle texture. Entries live in a slab and link to each other by index:
+/// `lruPrev`/`lruNext` order them by release time (head is the most recent),
+/// `chainPrev`/`chainNext` link the entries of one hash bucket. Free entries
+/// reuse `lruNext` as the free list.
+typedef struct {
+    SSKTexturePoolKey key;
+    void *handle;
+    uint64_t bytes;
+    uint64_t releasedFrame;
+    uint32_t hash;
+    uint32_t lruPrev;
+    uint32_t lruNext;
+    uint32_t chainPrev;
+    uint32_t chainNext;
+} SSKTexturePoolEntry;
+
+struct SSKTexturePool {
+    SSKTexturePoolDevice device;
+    uint64_t budgetBytes;
+    uint32_t maxIdleFrames;
+    uint64_t frame;
+
+    SSKTexturePoolEntry *entries;
+    uint32_t entryCapacity;
+    uint32_t freeEntry;
+
+    /// Bucket heads; the count is a power of two kept at least `pooledCount`.
+    uint32_t *buckets;
+    uint32_t bucketCount;
+
+    uint32_t lruHead;
+    uint32_t lruTail;
+
+    SSKTexturePoolStats stats;
+};
+
+static uint32_t SSKTexturePoolHash(const SSKTexturePoolKey *key) {
+    uint64_t h = ((uint64_t)key->width << 32 | key->height) * 0x9E3779B97F4A7C15ull;
+    h ^= ((uint64_t)key->format << 32 | key->usage) + 0xBF58476D1CE4E5B9ull + (h << 6) + (h >> 2);
+    h ^= key->bytesPerPixel;
+    h ^= h >> 31;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    return (uint32_t)h;
+}
+
+static bool SSKTexturePoolRehash(SSKTexturePool *pool, uint32_t bucketCount) {
+    uint32_t *buckets = malloc(sizeof(uint32_t) * bucketCount);
+    if (!buckets) { return false; }
+    memset(buckets, 0xFF, sizeof(uint32_t) * bucketCount);
+    // Oldest first, so each chain ends up most recent first again.
+    for (uint32_t index = pool->lruTail; index != SSKTexturePoolNone; index = pool->entries[index].lruPrev) {
+        SSKTexturePoolEntry *entry = &pool->entries[index];
+        uint32_t *head = &buckets[entry->hash & (bucketCount - 1)];
+        entry->chainPrev = SSKTexturePoolNone;
+        entry->chainNext = *head;
+        if (*head != SSKTexturePoolNone) {
+            pool->entries[*head].chainPrev = index;
+        }
+        *head = index;
+    }
+    free(pool->buckets);
+    pool->buckets = buckets;
+    pool->bucketCount = bucketCount;
+    return true;
+}
+
+/// Pops a free entry, growing the slab when it is exhausted.
+static uint32_t SSKTexturePoolAllocateEntry(SSKTexturePool *pool) {
+    if (pool->freeEntry == SSKTexturePoolNone) {
+        uint32_t capacity = pool->entryCapacity ? pool->entryCapacity * 2 : SSKTexturePoolInitialBuckets;
+        SSKTexturePoolEntry *entries = realloc(pool->entries, sizeof(SSKTexturePoolEntry) * capacity);
+        if (!entries) { return SSKTexturePoolNone; }
+        for (uint32_t i = pool->entryCapacity; i < capacity; i++) {
+            entries[i].lruNext = i + 1 < capacity ? i + 1 : SSKTexturePoolNone;
+        }
+        pool->freeEntry = pool->entryCapacity;
+        pool->entries = entries;
+        pool->entryCapacity = capacity;
+    }
+    uint32_t index = pool->freeEntry;
+    pool->freeEntry = pool->entries[index].lruNext;
+    return index;
+}
+
+/// Removes an idle entry from its bucket and the LRU list and frees it.
+/// Returns its handle, which the caller now owns.
+static void *SSKTexturePoolUnlink(SSKTexturePool *pool, uint32_t index) {
+    SSKTexturePoolEntry *entry = &pool->entries[index];
+    if (entry->chainPrev != SSKTexturePoolNone) {
+        pool->entries[entry->chainPrev].chainNext = entry->chainNext;
+    } else {
+        pool->buckets[entry->hash & (pool->bucketCount - 1)] = entry->chainNext;
+    }
+    if (entry->chainNext != SSKTexturePoolNone) {
+        pool->entries[entry->chainNext].chainPrev = entry->chainPrev;
+    }
+    if (entry->lruPrev != SSKTexturePoolNone) {
+        pool->entries[entry->lruPrev].lruNext = entry->lruNext;
+    } else {
+        pool->lruHead = entry->lruNext;
+    }
+    if (entry->lruNext != SSKTexturePoolNone) {
+        pool->entries[entry->lruNext].lruPrev = entry->lruPrev;
+    } else {
+        pool->lruTail = entry->lruPrev;
+    }
+    pool->stats.pooledCount -= 1;
+    pool->stats.pooledBytes -= entry->bytes;
+
+    void *handle = entry->handle;
+    entry->handle = NULL;
+    entry->lruNext = pool->freeEntry;
+    pool->freeEntry = index;
+    return handle;
+}
+
+static void SSKTexturePoolEvictTail(SSKTexturePool *pool) {
+    void *handle = SSKTexturePoolUnlink(pool, pool->lruTail);
+    pool->device.destroyTexture(pool->device.context, handle);
+    pool->stats.evictions += 1;
+}
+
+SSKTexturePool *SSKTexturePoolCreate(const SSKTexturePoolDevice *device, uint64_t budgetBytes) {
+    if (!device || !device->createTexture || !device->destroyTexture) { return NULL; }
+    SSKTexturePool *pool = calloc(1, sizeof(SSKTexturePool));
+    if (!pool) { return NULL; }
+    pool->device = *device;
+    pool->budgetBytes = budgetBytes;
+    pool->maxIdleFrames = SSKTexturePoolDefaultMaxIdleFrames;
+    pool->freeEntry = SSKTexturePoolNone;
+    pool->lruHead = SSKTexturePoolNone;
+    pool->lruTail = SSKTexturePoolNone;
+    if (!SSKTexturePoolRehash(pool, SSKTexturePoolInitialBuckets)) {
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void SSKTexturePoolDestroy(SSKTexturePool *pool) {
+    if (!pool) { return; }
+    SSKTexturePoolTrimToCount(pool, 0);
+    free(pool->entries);
+    free(pool->buckets);
+    free(pool);
+}
+
+void *SSKTexturePoolAcquire(SSKTexturePool *pool, const SSKTexturePoolKey *key) {
+    if (!pool || !key || key->width == 0 || key->height == 0) { return NULL; }
+    uint32_t hash = SSKTexturePoolHash(key);
+    for (uint32_t index = pool->buckets[hash & (pool->bucketCount - 1)]; index != SSKTexturePoolNone;
+         index = pool->entries[index].chainNext) {
+        const SSKTexturePoolEntry *entry = &pool->entries[index];
+        if (entry->hash == hash && SSKTexturePoolKeyEqual(&entry->key, key)) {
+            pool->stats.hits += 1;
+            return SSKTexturePoolUnlink(pool, index);
+        }
+    }
+    pool->stats.misses += 1;
+    return pool->device.createTexture(pool->device.context, key);
+}
+
+void SSKTexturePoolRelease(SSKTexturePool *pool, const SSKTexturePoolKey *key, void *handle) {
+    if (!pool || !handle) { return; }
+    uint64_t bytes = key ? SSKTexturePoolKeyBytes(key) : 0;
+    if (!key || bytes == 0 || bytes > pool->budgetBytes) {
+        pool->device.destroyTexture(pool->device.context, handle);
+        pool->stats.evictions += 1;
+        return;
+    }
+    while (pool->stats.pooledBytes + bytes > pool->budgetBytes) {
+        SSKTexturePoolEvictTail(pool);
+    }
+    if (pool->stats.pooledCount >= pool->bucketCount) {
+        // A failed rehash only lengthens the chains.
+        SSKTexturePoolRehash(pool, pool->bucketCount * 2);
+    }
+    uint32_t index = SSKTexturePoolAllocateEntry(pool);
+    if (index == SSKTexturePoolNone) {
+        pool->device.destroyTexture(pool->device.context, handle);
+        pool->stats.evictions += 1;
+        return;
+    }
+
+    SSKTexturePoolEntry *entry = &pool->entries[index];
+    entry->key = *key;
+    entry->handle = handle;
+    entry->bytes = bytes;
+    entry->releasedFrame = pool->frame;
+    entry->hash = SSKTexturePoolHash(key);
+
+    uint32_t *head = &pool->buckets[entry->hash & (pool->bucketCount - 1)];
+    entry->chainPrev = SSKTexturePoolNone;
+    entry->chainNext = *head;
+    if (*head != SSKTexturePoolNone) {
+        pool->entries[*head].chainPrev = index;
+    }
+    *head = index;
+
+    entry->lruPrev = SSKTexturePoolNone;
+    entry->lruNext = pool->lruHead;
+    if (pool->lruHead != SSKTexturePoolNone) {
+        pool->entries[pool->lruHead].lruPrev = index;
+    } else {
+        pool->lruTail = index;
+    }
+    pool->lruHead = index;
+
+    pool->stats.pooledCount += 1;
+    pool->stats.pooledBytes += bytes;
+}
+
+void SSKTexturePoolAdvanceFrame(SSKTexturePool *pool) {
+    if (!pool) { return; }
+    pool->frame += 1;
+    if (pool->maxIdleFrames == 0) { return; }
+    // The tail is the oldest release, so aging stops at the first young entry.
+    while (pool->lruTail != SSKTexturePoolNone &&
+           pool->frame - pool->entries[pool->lruTail].releasedFrame > pool->maxIdleFrames) {
+        SSKTexturePoolEvictTail(pool);
+    }
+}
+
+void SSKTexturePoolSetBudget(SSKTexturePool *pool, uint64_t budgetBytes) {
+    if (!pool) { return; }
+    pool->budgetBytes = budgetBytes;
+    SSKTexturePoolTrimToBytes(pool, budgetBytes);
+}
+
+uint64_t SSKTexturePoolBudget(const SSKTexturePool *pool) {
+    return pool ? pool->budgetBytes : 0;
+}
+
+void SSKTexturePoolSetMaxIdleFrames(SSKTexturePool *pool, uint32_t frames) {
+    if (!pool) { return; }
+    pool->maxIdleFrames = frames;
+}
+
+void SSKTexturePoolTrimToCount(SSKTexturePool *pool, uint32_t count) {
+    if (!pool) { return; }
+    while (pool->stats.pooledCount > count) {
+        SSKTexturePoolEvictTail(pool);
+    }
+}
+
+void SSKTexturePoolTrimToBytes(SSKTexturePool *pool, uint64_t bytes) {
+    if (!pool) { return; }
+    while (pool->stats.pooledBytes > bytes) {
+        SSKTexturePoolEvictTail(pool);
+    }
+}
+
+SSKTexturePoolStats SSKTexturePoolGetStats(const SSKTexturePool *pool) {
+    SSKTexturePoolStats stats = {0};
+    return pool ? pool->stats : stats;
+}
@@ -0,0 +1,107 @@
+#ifndef SSKTexturePool_h
+#define SSKTexturePool_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// Identifies interchangeable textures. Every field takes part in lookups, so
+/// two keys only match when they are equal field by field. The pool never
+/// interprets `format` or `usage` (the Metal layer stores `MTLPixelFormat` and
+/// `MTLTextureUsage`).
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t usage;
+    /// Used for the byte budget only.
+    uint32_t bytesPerPixel;
+} SSKTexturePoolKey;
+
+/// Texture provider behind an `SSKTexturePool`. The Metal layer creates
+/// private-storage `MTLTexture`s; headless code and tests can use `malloc`.
+typedef struct {
+    void *context;
+    /// Creates a texture matching `key` and returns an opaque handle (e.g. a
+    /// retained `id<MTLTexture>`), or NULL on failure.
+    void *(*createTexture)(void *context, const SSKTexturePoolKey *key);
+    /// Releases a handle returned by `createTexture` or handed to `Release`.
+    void (*destroyTexture)(void *context, void *handle);
+} SSKTexturePoolDevice;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    /// Idle textures destroyed to honour the budget, the idle age limit or a trim.
+    uint64_t evictions;
+    /// Idle textures currently held and their total size.
+    uint32_t pooledCount;
+    uint64_t pooledBytes;
+} SSKTexturePoolStats;
+
+/// Pool of idle textures with a byte budget and least-recently-used eviction.
+///
+/// Textures handed out by `Acquire` belong to the caller until `Release`
+/// gives them back; only idle textures count against the budget and can be
+/// evicted. Idle textures sit in a hash table keyed by the full key (chained,
+/// so exact matches are found in constant expected time) and on an intrusive
+/// LRU list, so acquire, release and each eviction are O(1). A release that
+/// pushes the pool over budget evicts from the cold end of the list;
+/// `AdvanceFrame` additionally evicts textures idle for more than
+/// `maxIdleFrames` frames, so a window resize does not leave stale sizes
+/// pinned for hours. Not thread safe.
+typedef struct SSKTexturePool SSKTexturePool;
+
+/// Creates a pool holding at most `budgetBytes` of idle textures. Returns
+/// NULL on failure.
+SSKTexturePool *SSKTexturePoolCreate(const SSKTexturePoolDevice *device, uint64_t budgetBytes);
+
+/// Destroys every idle texture. Textures still held by callers are theirs to free.
+void SSKTexturePoolDestroy(SSKTexturePool *pool);
+
+/// Returns the most recently released idle texture matching `key`, or a new
+/// one from the device. Returns NULL if the device fails or the key is empty.
+void *SSKTexturePoolAcquire(SSKTexturePool *pool, const SSKTexturePoolKey *key);
+
+/// Hands `handle` (described by `key`) to the pool, which then owns it. It is
+/// destroyed straight away if it alone exceeds the budget.
+void SSKTexturePoolRelease(SSKTexturePool *pool, const SSKTexturePoolKey *key, void *handle);
+
+/// Starts a new frame and evicts textures idle for more than `maxIdleFrames`.
+void SSKTexturePoolAdvanceFrame(SSKTexturePool *pool);
+
+/// Changes the budget, evicting as needed.
+void SSKTexturePoolSetBudget(SSKTexturePool *pool, uint64_t budgetBytes);
+
+uint64_t SSKTexturePoolBudget(const SSKTexturePool *pool);
+
+/// Idle age limit in frames; 0 disables aging. Defaults to
+/// `SSKTexturePoolDefaultMaxIdleFrames`.
+void SSKTexturePoolSetMaxIdleFrames(SSKTexturePool *pool, uint32_t frames);
+
+/// Evicts least recently used textures until at most `count` remain.
+void SSKTexturePoolTrimToCount(SSKTexturePool *pool, uint32_t count);
+
+/// Evicts least recently used textures until at most `bytes` remain.
+void SSKTexturePoolTrimToBytes(SSKTexturePool *pool, uint64_t bytes);
+
+SSKTexturePoolStats SSKTexturePoolGetStats(const SSKTexturePool *pool);
+
+enum { SSKTexturePoolDefaultMaxIdleFrames = 300 };
+
+static inline uint64_t SSKTexturePoolKeyBytes(const SSKTexturePoolKey *key) {
+    return (uint64_t)key->width * key->height * key->bytesPerPixel;
+}
+
+static inline bool SSKTexturePoolKeyEqual(const SSKTexturePoolKey *a, const SSKTexturePoolKey *b) {
+    return a->width == b->width && a->height == b->height && a->format == b->format && a->usage == b->usage &&
+           a->bytesPerPixel == b->bytesPerPixel;
+}
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKTexturePool_h */
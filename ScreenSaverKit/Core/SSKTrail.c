@@ -0,0 +1,376 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "SSKTrail.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The edge coverage mirrors `trailFragment` in SSKParticleShaders.metal; keep
+// them in sync.
+
+static const size_t kSSKTrailStreamAlignment = 64;
+/// Pushes closer than this to the newest point are dropped.
+static const float kSSKTrailMinSegmentLength = 0.01f;
+/// Below this squared length the two normals of a join cancel out: the trail
+/// doubles back on itself and the join keeps the incoming normal.
+static const float kSSKTrailCuspThreshold = 1e-6f;
+
+SSKTrailMeshParams SSKTrailMeshParamsDefault(void) {
+    SSKTrailMeshParams params = {1.0f, 4.0f, 0.0f};
+    return params;
+}
+
+SSKTrailSet *SSKTrailSetCreate(uint32_t trailCount, uint32_t capacity) {
+    if (trailCount == 0 || capacity < 2 || (uint64_t)trailCount * capacity > UINT32_MAX / 2) { return NULL; }
+    SSKTrailSet *set = calloc(1, sizeof(SSKTrailSet));
+    if (!set) { return NULL; }
+    size_t points = (size_t)trailCount * capacity;
+    size_t coordinateLength = (points * sizeof(float) + kSSKTrailStreamAlignment - 1) / kSSKTrailStreamAlignment *
+                              kSSKTrailStreamAlignment;
+    size_t counterLength = (trailCount * sizeof(uint32_t) + kSSKTrailStreamAlignment - 1) /
+                           kSSKTrailStreamAlignment * kSSKTrailStreamAlignment;
+    size_t length = 2 * coordinateLength + 2 * counterLength + trailCount * sizeof(SSKTrailStyle);
+    if (posix_memalign(&set->storage, kSSKTrailStreamAlignment, length) != 0) {
+        free(set);
+        return NULL;
+    }
+    memset(set->storage, 0, length);
+    uint8_t *base = set->storage;
+    set->x = (float *)(void *)base;
+    set->y = (float *)(void *)(base + coordinateLength);
+    set->head = (uint32_t *)(void *)(base + 2 * coordinateLength);
+    set->length = (uint32_t *)(void *)(base + 2 * coordinateLength + counterLength);
+    set->styles = (SSKTrailStyle *)(void *)(base + 2 * coordinateLength + 2 * counterLength);
+    set->trailCount = trailCount;
+    set->capacity = capacity;
+    SSKTrailStyle style = {1.0f, 1.0f, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+    for (uint32_t t = 0; t < trailCount; t++) {
+        set->styles[t] = style;
+    }
+    return set;
+}
+
+void SSKTrailSetDestroy(SSKTrailSet *set) {
+    if (!set) { return; }
+    free(set->storage);
+    free(set);
+}
+
+bool SSKTrailSetPush(SSKTrailSet *set, uint32_t trail, SSKFloat2 point) {
+    if (!set || trail >= set->trailCount) { return false; }
+    float *xs = set->x + (size_t)trail * set->capacity;
+    float *ys = set->y + (size_t)trail * set->capacity;
+    uint32_t head = set->head[trail];
+    if (set->length[trail] > 0) {
+        uint32_t newest = head == 0 ? set->capacity - 1 : head - 1;
+        float dx = point.x - xs[newest];
+        float dy = point.y - ys[newest];
+        if (dx * dx + dy * dy < kSSKTrailMinSegmentLength * kSSKTrailMinSegmentLength) { return false; }
+    }
+    xs[head] = point.x;
+    ys[head] = point.y;
+    set->head[trail] = head + 1 == set->capacity ? 0 : head + 1;
+    if (set->length[trail] < set->capacity) {
+        set->length[trail]++;
+    }
+    return true;
+}
+
+bool SSKTrailSetMoveHead(SSKTrailSet *set, uint32_t trail, SSKFloat2 point) {
+    if (!set || trail >= set->trailCount || set->length[trail] == 0) { return false; }
+    float *xs = set->x + (size_t)trail * set->capacity;
+    float *ys = set->y + (size_t)trail * set->capacity;
+    uint32_t head = set->head[trail];
+    uint32_t newest = head == 0 ? set->capacity - 1 : head - 1;
+    if (set->length[trail] > 1) {
+        uint32_t previous = newest == 0 ? set->capacity - 1 : newest - 1;
+        float dx = point.x - xs[previous];
+        float dy = point.y - ys[previous];
+        if (dx * dx + dy * dy < kSSKTrailMinSegmentLength * kSSKTrailMinSegmentLength) { return false; }
+    }
+    xs[newest] = point.x;
+    ys[newest] = point.y;
+    return true;
+}
+
+void SSKTrailSetClear(SSKTrailSet *set, uint32_t trail) {
+    if (!set || trail >= set->trailCount) { return; }
+    set->head[trail] = 0;
+    set->length[trail] = 0;
+}
+
+SSKFloat2 SSKTrailSetPoint(const SSKTrailSet *set, uint32_t trail, uint32_t index) {
+    if (!set || trail >= set->trailCount || index >= set->length[trail]) { return SSKFloat2Make(0.0f, 0.0f); }
+    uint32_t slot = (set->head[trail] + set->capacity - set->length[trail] + index) % set->capacity;
+    size_t offset = (size_t)trail * set->capacity + slot;
+    return SSKFloat2Make(set->x[offset], set->y[offset]);
+}
+
+uint32_t SSKTrailSetMaxVertexCount(const SSKTrailSet *set) {
+    return set ? set->trailCount * set->capacity * 2 : 0;
+}
+
+uint32_t SSKTrailSetMaxIndexCount(const SSKTrailSet *set) {
+    return set ? set->trailCount * (set->capacity - 1) * 6 : 0;
+}
+
+/// Unit normal of the segment `a` to `b`, pointing left of its direction.
+/// Segments are never shorter than `kSSKTrailMinSegmentLength`.
+static inline SSKFloat2 SSKTrailSegmentNormal(float ax, float ay, float bx, float by) {
+    float dx = bx - ax;
+    float dy = by - ay;
+    float inverseLength = 1.0f / sqrtf(dx * dx + dy * dy);
+    return SSKFloat2Make(-dy * inverseLength, dx * inverseLength);
+}
+
+static inline SSKFloat4 SSKTrailLerpColor(SSKFloat4 a, SSKFloat4 b, float f) {
+    return SSKFloat4Make(a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f, a.z + (b.z - a.z) * f,
+                         a.w + (b.w - a.w) * f);
+}
+
+/// Writes the two vertices and (but for the last point) the six indices of
+/// every point of one trail, oldest first.
+static void SSKTrailTessellateOne(const SSKTrailSet *set, uint32_t trail, const SSKTrailMeshParams *params,
+                                  SSKTrailVertex *vertices, uint32_t firstVertex, uint32_t *indices) {
+    uint32_t capacity = set->capacity;
+    uint32_t count = set->length[trail];
+    const float *xs = set->x + (size_t)trail * capacity;
+    const float *ys = set->y + (size_t)trail * capacity;
+    const SSKTrailStyle *style = &set->styles[trail];
+    float margin = (params->feather > 0.0f ? params->feather : 0.0f) +
+                   (params->softness > 0.0f ? params->softness * 0.5f : 0.0f);
+    float miterLimit = params->miterLimit > 1.0f ? params->miterLimit : 1.0f;
+    float step = 1.0f / (float)(count - 1);
+
+    uint32_t slot = (set->head[trail] + capacity - count) % capacity;
+    uint32_t nextSlot = slot + 1 == capacity ? 0 : slot + 1;
+    float px = xs[slot];
+    float py = ys[slot];
+    float nx = xs[nextSlot];
+    float ny = ys[nextSlot];
+    SSKFloat2 normalIn = SSKFloat2Make(0.0f, 0.0f);
+    SSKFloat2 normalOut = SSKTrailSegmentNormal(px, py, nx, ny);
+    for (uint32_t i = 0; i < count; i++) {
+        SSKFloat2 normal;
+        float miter = 1.0f;
+        if (i == 0) {
+            normal = normalOut;
+        } else if (i + 1 == count) {
+            normal = normalIn;
+        } else {
+            float sx = normalIn.x + normalOut.x;
+            float sy = normalIn.y + normalOut.y;
+            float lengthSquared = sx * sx + sy * sy;
+            if (lengthSquared < kSSKTrailCuspThreshold) {
+                normal = normalIn;
+            } else {
+                float inverseLength = 1.0f / sqrtf(lengthSquared);
+                normal = SSKFloat2Make(sx * inverseLength, sy * inverseLength);
+                // The miter meets both offset edges when it is 1 / cos of half the turn.
+                float cosine = normal.x * normalIn.x + normal.y * normalIn.y;
+                miter = cosine * miterLimit > 1.0f ? 1.0f / cosine : miterLimit;
+            }
+        }
+
+        float f = (float)i * step;
+        float halfWidth = (style->tailWidth + (style->headWidth - style->tailWidth) * f) * 0.5f;
+        if (halfWidth < 0.0f) { halfWidth = 0.0f; }
+        float extent = halfWidth + margin;
+        float ox = normal.x * extent * miter;
+        float oy = normal.y * extent * miter;
+        SSKFloat4 color = SSKTrailLerpColor(style->tailColor, style->headColor, f);
+        uint32_t v = firstVertex + 2 * i;
+        vertices[2 * i] = (SSKTrailVertex){SSKFloat2Make(px + ox, py + oy), extent, halfWidth, color};
+        vertices[2 * i + 1] = (SSKTrailVertex){SSKFloat2Make(px - ox, py - oy), -extent, halfWidth, color};
+
+        if (i + 1 == count) { break; }
+        uint32_t *quad = indices + 6 * i;
+        quad[0] = v;
+        quad[1] = v + 1;
+        quad[2] = v + 2;
+        quad[3] = v + 1;
+        quad[4] = v + 3;
+        quad[5] = v + 2;
+
+        px = nx;
+        py = ny;
+        normalIn = normalOut;
+        if (i + 2 < count) {
+            nextSlot = nextSlot + 1 == capacity ? 0 : nextSlot + 1;
+            nx = xs[nextSlot];
+            ny = ys[nextSlot];
+            normalOut = SSKTrailSegmentNormal(px, py, nx, ny);
+        }
+    }
+}
+
+SSKTrailMeshCounts SSKTrailSetTessellate(const SSKTrailSet *set, const SSKTrailMeshParams *params,
+                                         SSKTrailVertex *vertices, uint32_t maxVertices, uint32_t *indices,
+                                         uint32_t maxIndices) {
+    SSKTrailMeshCounts counts = {0, 0};
+    if (!set || !params || !vertices || !indices) { return counts; }
+    for (uint32_t t = 0; t < set->trailCount; t++) {
+        uint32_t count = set->length[t];
+        if (count < 2) { continue; }
+        uint32_t trailVertices = count * 2;
+        uint32_t trailIndices = (count - 1) * 6;
+        if (trailVertices > maxVertices - counts.vertexCount || trailIndices > maxIndices - counts.indexCount) {
+            break;
+        }
+        SSKTrailTessellateOne(set, t, params, vertices + counts.vertexCount, counts.vertexCount,
+                              indices + counts.indexCount);
+        counts.vertexCount += trailVertices;
+        counts.indexCount += trailIndices;
+    }
+    return counts;
+}
+
+/// Clamps to [0, 1] and rounds to 8 bits, as `SSKParticleRaster.c` does.
+static inline uint8_t SSKTrailToUnorm8(float value) {
+    value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    return (uint8_t)(int32_t)(value * 255.0f + 0.5f);
+}
+
+/// Edge function of `u -> v` at `p`: positive on its left in pixel space.
+/// Both triangles sharing an edge evaluate it from the same endpoint, so
+/// their values are exact negatives and the edge's pixels go to exactly one.
+static inline float SSKTrailEdgeFunction(SSKFloat2 u, SSKFloat2 v, float px, float py) {
+    bool swapped = u.y > v.y || (u.y == v.y && u.x > v.x);
+    SSKFloat2 a = swapped ? v : u;
+    SSKFloat2 b = swapped ? u : v;
+    float value = (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+    return swapped ? -value : value;
+}
+
+/// Top-left style tie break: a pixel centre exactly on an edge belongs to the
+/// one of its two directions picked here.
+static inline bool SSKTrailEdgeOwnsTies(SSKFloat2 u, SSKFloat2 v) {
+    float dx = v.x - u.x;
+    float dy = v.y - u.y;
+    return dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+}
+
+static inline int32_t SSKTrailClampPixel(float value, int32_t limit) {
+    if (!(value > 0.0f)) { return 0; }
+    if (value >= (float)limit) { return limit; }
+    return (int32_t)value;
+}
+
+static void SSKTrailRasterizeTriangle(const SSKRasterTarget *target, const SSKTrailVertex *vertices,
+                                      const SSKFloat2 *pixels, const uint32_t *triangle, float inverseRamp,
+                                      SSKRasterBlend blend) {
+    uint32_t i0 = triangle[0];
+    uint32_t i1 = triangle[1];
+    uint32_t i2 = triangle[2];
+    SSKFloat2 a = pixels[0];
+    SSKFloat2 b = pixels[1];
+    SSKFloat2 c = pixels[2];
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (!(area != 0.0f) || !isfinite(area)) { return; }
+    if (area < 0.0f) {
+        SSKFloat2 swap = b;
+        b = c;
+        c = swap;
+        uint32_t swapIndex = i1;
+        i1 = i2;
+        i2 = swapIndex;
+        area = -area;
+    }
+    bool tie0 = SSKTrailEdgeOwnsTies(b, c);
+    bool tie1 = SSKTrailEdgeOwnsTies(c, a);
+    bool tie2 = SSKTrailEdgeOwnsTies(a, b);
+
+    float minX = fminf(a.x, fminf(b.x, c.x));
+    float maxX = fmaxf(a.x, fmaxf(b.x, c.x));
+    float minY = fminf(a.y, fminf(b.y, c.y));
+    float maxY = fmaxf(a.y, fmaxf(b.y, c.y));
+    // Pixel x is sampled at x + 0.5.
+    int32_t x0 = SSKTrailClampPixel(ceilf(minX - 0.5f), (int32_t)target->width);
+    int32_t x1 = SSKTrailClampPixel(floorf(maxX - 0.5f) + 1.0f, (int32_t)target->width);
+    int32_t y0 = SSKTrailClampPixel(ceilf(minY - 0.5f), (int32_t)target->height);
+    int32_t y1 = SSKTrailClampPixel(floorf(maxY - 0.5f) + 1.0f, (int32_t)target->height);
+
+    const SSKTrailVertex *va = &vertices[i0];
+    const SSKTrailVertex *vb = &vertices[i1];
+    const SSKTrailVertex *vc = &vertices[i2];
+    float inverseArea = 1.0f / area;
+    uint8_t *row = (uint8_t *)target->pixels + (size_t)y0 * target->rowBytes;
+    for (int32_t y = y0; y < y1; y++, row += target->rowBytes) {
+        float py = (float)y + 0.5f;
+        for (int32_t x = x0; x < x1; x++) {
+            float px = (float)x + 0.5f;
+            float w0 = SSKTrailEdgeFunction(b, c, px, py);
+            float w1 = SSKTrailEdgeFunction(c, a, px, py);
+            float w2 = SSKTrailEdgeFunction(a, b, px, py);
+            if (!((w0 > 0.0f || (w0 == 0.0f && tie0)) && (w1 > 0.0f || (w1 == 0.0f && tie1)) &&
+                  (w2 > 0.0f || (w2 == 0.0f && tie2)))) {
+                continue;
+            }
+            float l0 = w0 * inverseArea;
+            float l1 = w1 * inverseArea;
+            float l2 = w2 * inverseArea;
+            float edge = va->edge * l0 + vb->edge * l1 + vc->edge * l2;
+            float halfWidth = va->halfWidth * l0 + vb->halfWidth * l1 + vc->halfWidth * l2;
+            float coverage = (halfWidth - fabsf(edge)) * inverseRamp + 0.5f;
+            if (!(coverage > 0.0f)) { continue; }
+            if (coverage > 1.0f) { coverage = 1.0f; }
+            SSKFloat4 color = SSKFloat4Make(va->color.x * l0 + vb->color.x * l1 + vc->color.x * l2,
+                                            va->color.y * l0 + vb->color.y * l1 + vc->color.y * l2,
+                                            va->color.z * l0 + vb->color.z * l1 + vc->color.z * l2,
+                                            va->color.w * l0 + vb->color.w * l1 + vc->color.w * l2);
+            float alpha = color.w * coverage;
+
+            SSKFloat4 d;
+            uint8_t *unorm = row + (size_t)x * 4;
+            SSKFloat4 *wide = (SSKFloat4 *)(void *)row + x;
+            if (target->format == SSKRasterFormatRGBA8) {
+                d = SSKFloat4Make(unorm[0] * (1.0f / 255.0f), unorm[1] * (1.0f / 255.0f), unorm[2] * (1.0f / 255.0f),
+                                  unorm[3] * (1.0f / 255.0f));
+            } else {
+                d = *wide;
+            }
+            if (blend == SSKRasterBlendAdditive) {
+                d.x += color.x * alpha;
+                d.y += color.y * alpha;
+                d.z += color.z * alpha;
+                d.w += alpha;
+            } else {
+                float inverse = 1.0f - alpha;
+                d.x = color.x * alpha + d.x * inverse;
+                d.y = color.y * alpha + d.y * inverse;
+                d.z = color.z * alpha + d.z * inverse;
+                d.w = alpha + d.w * inverse;
+            }
+            if (target->format == SSKRasterFormatRGBA8) {
+                unorm[0] = SSKTrailToUnorm8(d.x);
+                unorm[1] = SSKTrailToUnorm8(d.y);
+                unorm[2] = SSKTrailToUnorm8(d.z);
+                unorm[3] = SSKTrailToUnorm8(d.w);
+            } else {
+                *wide = d;
+            }
+        }
+    }
+}
+
+void SSKTrailRasterize(const SSKRasterTarget *target, const SSKParticleRasterParams *params,
+                       const SSKTrailMeshParams *meshParams, const SSKTrailVertex *vertices,
+                       const uint32_t *indices, uint32_t indexCount) {
+    if (!target || !target->pixels || !params || !vertices || !indices) { return; }
+    if (target->width == 0 || target->height == 0 || params->size.x == 0.0f || params->size.y == 0.0f) { return; }
+    float scaleX = (float)target->width / params->size.x;
+    float scaleY = (float)target->height / params->size.y;
+    // Edges fade over the softness, in points, or one pixel if that is wider.
+    float pointsPerPixel = 1.0f / fabsf(scaleX);
+    float softness = meshParams ? meshParams->softness : 0.0f;
+    float inverseRamp = 1.0f / (softness > pointsPerPixel ? softness : pointsPerPixel);
+    for (uint32_t i = 0; i + 3 <= indexCount; i += 3) {
+        SSKFloat2 pixels[3];
+        for (uint32_t k = 0; k < 3; k++) {
+            SSKFloat2 p = vertices[indices[i + k]].position;
+            pixels[k] = SSKFloat2Make((p.x - params->origin.x) * scaleX, (p.y - params->origin.y) * scaleY);
+        }
+        SSKTrailRasterizeTriangle(target, vertices, pixels, indices + i, inverseRamp, params->blend);
+    }
+}
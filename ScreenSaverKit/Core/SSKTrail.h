@@ -0,0 +1,136 @@
+#ifndef SSKTrail_h
+#define SSKTrail_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SSKCoreTypes.h"
+#include "SSKParticleRaster.h"
+
+SSK_CORE_EXTERN_C_BEGIN
+
+/// One vertex of a tessellated trail, as consumed by `trailVertex` in
+/// `SSKParticleShaders.metal` (`TrailVertex`). 32 bytes, laid out to match
+/// the Metal struct exactly.
+typedef struct {
+    SSKFloat2 position;
+    /// Signed distance from the centre line in points: `+extent` on the left
+    /// edge of the strip, `-extent` on the right, where `extent` is
+    /// `halfWidth` plus the feather margin and half the softness.
+    /// Interpolated across the strip, it is what the fragment stage fades
+    /// the edge against.
+    float edge;
+    /// Half the visible width at this vertex.
+    float halfWidth;
+    SSKFloat4 color;
+} SSKTrailVertex;
+
+/// How one trail is drawn. Width and colour run linearly from the oldest
+/// point (tail) to the newest (head); colours are straight (not
+/// premultiplied) RGBA.
+typedef struct {
+    float headWidth;
+    float tailWidth;
+    SSKFloat4 headColor;
+    SSKFloat4 tailColor;
+} SSKTrailStyle;
+
+/// Point histories of many trails, stored structure-of-arrays.
+///
+/// Each trail owns `capacity` consecutive slots of `x` and `y` used as a ring:
+/// pushing onto a full trail drops its oldest point. Nothing is allocated
+/// after `SSKTrailSetCreate`, so trails can be pushed every frame.
+typedef struct {
+    /// `trailCount * capacity` coordinates; trail `t` owns `[t * capacity, (t + 1) * capacity)`.
+    float *x;
+    float *y;
+    /// Slot the next point of each trail is written to.
+    uint32_t *head;
+    /// Points held by each trail, at most `capacity`.
+    uint32_t *length;
+    /// One per trail; written directly by the caller.
+    SSKTrailStyle *styles;
+    uint32_t trailCount;
+    uint32_t capacity;
+    void *storage;
+} SSKTrailSet;
+
+/// Shared by every trail of one tessellation.
+typedef struct {
+    /// Strips reach this many points past `halfWidth` on each side so the
+    /// fragment stage has room to fade the edge. It must cover one pixel: 1
+    /// point is enough for 1x and 2x backing stores.
+    float feather;
+    /// Longest miter, as a multiple of the strip's half extent, before a
+    /// sharp join is clamped.
+    float miterLimit;
+    /// Width in points of the fade across each visible edge, centred on it.
+    /// Below one pixel the edge is simply anti-aliased.
+    float softness;
+} SSKTrailMeshParams;
+
+/// Vertex and index counts of a tessellation.
+typedef struct {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+} SSKTrailMeshCounts;
+
+/// Feather of 1 point, a miter limit of 4 and hard (anti-aliased) edges.
+SSKTrailMeshParams SSKTrailMeshParamsDefault(void);
+
+/// Creates `trailCount` empty trails of `capacity` points each, styled 1 point
+/// wide and opaque white. Returns NULL when either is 0, `capacity` is below
+/// 2 or storage cannot be allocated.
+SSKTrailSet *SSKTrailSetCreate(uint32_t trailCount, uint32_t capacity);
+
+void SSKTrailSetDestroy(SSKTrailSet *set);
+
+/// Appends `point` as the newest point of `trail`, dropping the oldest once
+/// the trail is full. A point within 0.01 points of the newest one is dropped
+/// (returning false), so every segment is long enough to have a direction.
+bool SSKTrailSetPush(SSKTrailSet *set, uint32_t trail, SSKFloat2 point);
+
+/// Moves the newest point of `trail` to `point`, so the live end of a trail
+/// can follow its emitter between samples pushed at a coarser spacing.
+/// Returns false, leaving the trail unchanged, when it is empty or `point` is
+/// within 0.01 points of the point before the newest.
+bool SSKTrailSetMoveHead(SSKTrailSet *set, uint32_t trail, SSKFloat2 point);
+
+/// Empties `trail`; its style is kept.
+void SSKTrailSetClear(SSKTrailSet *set, uint32_t trail);
+
+/// Point `index` of `trail`, counting from the oldest.
+SSKFloat2 SSKTrailSetPoint(const SSKTrailSet *set, uint32_t trail, uint32_t index);
+
+/// Buffer sizes that hold a tessellation of every trail at full length.
+uint32_t SSKTrailSetMaxVertexCount(const SSKTrailSet *set);
+uint32_t SSKTrailSetMaxIndexCount(const SSKTrailSet *set);
+
+/// Tessellates every trail into one indexed triangle list, in trail order.
+///
+/// Each point of a trail becomes two vertices, offset along the miter of its
+/// two segments (the segment normal at the ends), and each segment two
+/// triangles. The whole mesh is drawn with one call. Trails with fewer than
+/// two points are skipped; a trail that does not fit in what is left of
+/// `maxVertices` or `maxIndices` ends the mesh, so a short buffer always
+/// receives a prefix of the full output. `vertices` and `indices` may be
+/// mapped GPU memory; they are only written, never read.
+SSKTrailMeshCounts SSKTrailSetTessellate(const SSKTrailSet *set, const SSKTrailMeshParams *params,
+                                         SSKTrailVertex *vertices, uint32_t maxVertices, uint32_t *indices,
+                                         uint32_t maxIndices);
+
+/// Software version of the trail pipelines of `SSKMetalTrailPass`, for the
+/// CPU fallback and for tests. Triangles are filled in index order with a
+/// top-left rule, so edges shared by two triangles are covered once; each
+/// pixel centre gets the interpolated colour with the same edge coverage as
+/// `trailFragment`, faded over `meshParams->softness` or one pixel, whichever
+/// is wider. `SSKRasterBlendAlpha` blends `src * a + dst * (1 - a)` (alpha
+/// `a + dst * (1 - a)`); `SSKRasterBlendAdditive` adds `src * a`. `params`
+/// maps trail space onto the target as for particles.
+void SSKTrailRasterize(const SSKRasterTarget *target, const SSKParticleRasterParams *params,
+                       const SSKTrailMeshParams *meshParams, const SSKTrailVertex *vertices,
+                       const uint32_t *indices, uint32_t indexCount);
+
+SSK_CORE_EXTERN_C_END
+
+#endif /* SSKTrail_h */
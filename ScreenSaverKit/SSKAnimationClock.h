@@ -21,6 +21,44 @@ NS_ASSUME_NONNULL_BEGIN
 /// returns the calculated delta.
 - (NSTimeInterval)stepWithTimestamp:(NSTimeInterval)timestamp;
 
+/// When enabled, each `stepWithTimestamp:` also accumulates the real elapsed
+/// time and sets `pendingSteps` to the number of fixed ticks now due. Run the
+/// simulation once per tick with `fixedDeltaTime` (see
+/// `runPendingStepsUsingBlock:`) and its cost per second and its results no
+/// longer depend on the display rate. Defaults to NO.
+@property (nonatomic, getter=isFixedTimestepEnabled) BOOL fixedTimestepEnabled;
+
+/// Simulation ticks per second in fixed-timestep mode (default 60). Changing it
+/// restarts `tickCount`.
+@property (nonatomic) double tickRate;
+
+/// Most ticks a single frame may run (default 5). Time beyond that is dropped
+/// instead of carried over, so a hitch costs one bounded catch-up frame rather
+/// than a spiral of ever longer frames. Changing it restarts `tickCount`.
+@property (nonatomic) NSUInteger maxStepsPerFrame;
+
+/// Seconds per tick, `1 / tickRate`.
+@property (nonatomic, readonly) NSTimeInterval fixedDeltaTime;
+
+/// Ticks due this frame and not yet run. Zero when fixed-timestep mode is off.
+@property (nonatomic, readonly) NSUInteger pendingSteps;
+
+/// Fraction of a tick accumulated but not yet simulated, in [0, 1). Renderers
+/// can blend the last two simulated states (or extrapolate the last one by
+/// `interpolationAlpha * fixedDeltaTime`) to stay smooth between ticks.
+@property (nonatomic, readonly) double interpolationAlpha;
+
+/// Ticks scheduled since fixed-timestep mode was enabled. Equal tick counts mean
+/// equal simulation time, whatever the frame rate was.
+@property (nonatomic, readonly) uint64_t tickCount;
+
+/// Ticks discarded by `maxStepsPerFrame` since fixed-timestep mode was enabled.
+@property (nonatomic, readonly) uint64_t droppedTickCount;
+
+/// Calls `block` once per pending tick with `fixedDeltaTime`, clears
+/// `pendingSteps` and returns how many ticks ran.
+- (NSUInteger)runPendingStepsUsingBlock:(void (NS_NOESCAPE ^)(NSTimeInterval dt))block;
+
 /// Convenience to pause without losing accumulated timing.
 - (void)pause;
 
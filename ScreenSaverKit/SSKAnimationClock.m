@@ -1,17 +1,24 @@
 #import "SSKAnimationClock.h"
 
+#import "Core/SSKFixedStep.h"
+
 static const NSTimeInterval kSSKMinDelta = 1.0 / 240.0;  // cap at 240fps
 static const NSTimeInterval kSSKMaxDelta = 1.0 / 10.0;   // floor around 10fps to avoid huge jumps
 static const double kSSKSmoothingFactor = 0.15;          // exponential moving average
+static const double kSSKDefaultTickRate = 60.0;
+static const NSUInteger kSSKDefaultMaxStepsPerFrame = 5;
 
 @interface SSKAnimationClock ()
 @property (nonatomic) NSTimeInterval lastTimestamp;
 @property (nonatomic, readwrite) NSTimeInterval deltaTime;
 @property (nonatomic) double smoothedDelta;
 @property (nonatomic, readwrite) double framesPerSecond;
+@property (nonatomic, readwrite) NSUInteger pendingSteps;
 @end
 
-@implementation SSKAnimationClock
+@implementation SSKAnimationClock {
+    SSKFixedStep _fixedStep;
+}
 
 - (instancetype)init {
     if ((self = [super init])) {
@@ -19,6 +26,9 @@ static const double kSSKSmoothingFactor = 0.15;          // exponential moving a
         _deltaTime = 1.0 / 60.0;
         _smoothedDelta = _deltaTime;
         _framesPerSecond = 60.0;
+        _tickRate = kSSKDefaultTickRate;
+        _maxStepsPerFrame = kSSKDefaultMaxStepsPerFrame;
+        SSKFixedStepInit(&_fixedStep, _tickRate, (uint32_t)_maxStepsPerFrame);
     }
     return self;
 }
@@ -28,22 +38,30 @@ static const double kSSKSmoothingFactor = 0.15;          // exponential moving a
     self.deltaTime = 1.0 / 60.0;
     self.smoothedDelta = self.deltaTime;
     self.framesPerSecond = 60.0;
+    // Ticks keep counting across resets; only the partial tick is forgotten.
+    _fixedStep.accumulator = 0.0;
+    self.pendingSteps = 0;
 }
 
 - (NSTimeInterval)stepWithTimestamp:(NSTimeInterval)timestamp {
     if (self.isPaused) {
         self.lastTimestamp = timestamp;
         self.deltaTime = 0;
+        self.pendingSteps = 0;
         return 0;
     }
     
     if (self.lastTimestamp <= 0) {
         [self resetWithTimestamp:timestamp];
+        [self accumulateFixedTime:self.deltaTime];
         return self.deltaTime;
     }
     
     NSTimeInterval raw = timestamp - self.lastTimestamp;
     self.lastTimestamp = timestamp;
+    // The accumulator sees the unclamped time: it has its own catch-up limit,
+    // and clamping short frames up to the minimum would run the simulation fast.
+    [self accumulateFixedTime:raw];
     
     NSTimeInterval clamped = MAX(kSSKMinDelta, MIN(raw, kSSKMaxDelta));
     self.deltaTime = clamped;
@@ -57,6 +75,66 @@ static const double kSSKSmoothingFactor = 0.15;          // exponential moving a
     return clamped;
 }
 
+- (void)accumulateFixedTime:(NSTimeInterval)elapsed {
+    if (!self.isFixedTimestepEnabled) {
+        self.pendingSteps = 0;
+        return;
+    }
+    // Steps left over from a frame that did not run them are dropped rather
+    // than stacked on top of this frame's.
+    self.pendingSteps = SSKFixedStepAccumulate(&_fixedStep, elapsed);
+}
+
+- (void)setFixedTimestepEnabled:(BOOL)fixedTimestepEnabled {
+    if (_fixedTimestepEnabled == fixedTimestepEnabled) {
+        return;
+    }
+    _fixedTimestepEnabled = fixedTimestepEnabled;
+    SSKFixedStepReset(&_fixedStep);
+    self.pendingSteps = 0;
+}
+
+- (void)setTickRate:(double)tickRate {
+    _tickRate = tickRate > 0.0 ? tickRate : kSSKDefaultTickRate;
+    SSKFixedStepInit(&_fixedStep, _tickRate, (uint32_t)MIN(self.maxStepsPerFrame, (NSUInteger)UINT32_MAX));
+    self.pendingSteps = 0;
+}
+
+- (void)setMaxStepsPerFrame:(NSUInteger)maxStepsPerFrame {
+    _maxStepsPerFrame = MAX(maxStepsPerFrame, (NSUInteger)1);
+    SSKFixedStepInit(&_fixedStep, self.tickRate, (uint32_t)MIN(_maxStepsPerFrame, (NSUInteger)UINT32_MAX));
+    self.pendingSteps = 0;
+}
+
+- (NSTimeInterval)fixedDeltaTime {
+    return _fixedStep.step;
+}
+
+- (double)interpolationAlpha {
+    return self.isFixedTimestepEnabled ? SSKFixedStepAlpha(&_fixedStep) : 0.0;
+}
+
+- (uint64_t)tickCount {
+    return _fixedStep.tick;
+}
+
+- (uint64_t)droppedTickCount {
+    return _fixedStep.droppedTicks;
+}
+
+- (NSUInteger)runPendingStepsUsingBlock:(void (NS_NOESCAPE ^)(NSTimeInterval dt))block {
+    NSUInteger steps = self.pendingSteps;
+    self.pendingSteps = 0;
+    if (!block) {
+        return 0;
+    }
+    NSTimeInterval dt = self.fixedDeltaTime;
+    for (NSUInteger i = 0; i < steps; i++) {
+        block(dt);
+    }
+    return steps;
+}
+
 - (void)pause {
     self.paused = YES;
 }
@@ -1,5 +1,7 @@
 #import <AppKit/AppKit.h>
 
+#import "Core/SSKPalette.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 /// Simple wrapper describing a palette of NSColor instances with an identifier and display name.
@@ -14,6 +16,14 @@ NS_ASSUME_NONNULL_BEGIN
 /// Ordered list of colours used when interpolating along the palette.
 @property (nonatomic, copy, readonly) NSArray<NSColor *> *colors;
 
+/// `colors` compiled to a lookup table, built on first use and kept for the
+/// palette's lifetime. Tables are never modified once returned, so they can
+/// be sampled from any thread with `SSKPaletteLUTSample` or
+/// `SSKPaletteLUTSampleBatch`. Returns NULL only if the table could not be
+/// allocated.
+- (nullable const SSKPaletteLUT *)lookupTableForWrap:(SSKPaletteWrap)wrap
+                                            encoding:(SSKPaletteEncoding)encoding NS_RETURNS_INNER_POINTER;
+
 - (instancetype)initWithIdentifier:(NSString *)identifier
                        displayName:(NSString *)displayName
                             colors:(NSArray<NSColor *> *)colors NS_DESIGNATED_INITIALIZER;
@@ -1,6 +1,15 @@
 #import "SSKColorPalette.h"
 
-@implementation SSKColorPalette
+#import <stdatomic.h>
+
+@implementation SSKColorPalette {
+    /// sRGB-encoded straight RGBA of `colors`, the input to every table.
+    SSKFloat4 *_stops;
+    uint32_t _stopCount;
+    /// Indexed by wrap, then encoding. Published with a compare-and-swap so
+    /// concurrent first lookups never block; the loser frees its copy.
+    _Atomic(SSKPaletteLUT *) _lookupTables[2][2];
+}
 
 - (instancetype)initWithIdentifier:(NSString *)identifier
                        displayName:(NSString *)displayName
@@ -11,6 +20,15 @@
         _identifier = [identifier copy];
         _displayName = [displayName copy];
         _colors = [colors copy] ?: @[];
+        _stops = calloc(MAX(_colors.count, (NSUInteger)1), sizeof(SSKFloat4));
+        if (_stops) {
+            NSColorSpace *sRGB = [NSColorSpace sRGBColorSpace];
+            for (NSColor *color in _colors) {
+                NSColor *rgb = [color colorUsingColorSpace:sRGB] ?: [NSColor whiteColor];
+                _stops[_stopCount++] = SSKFloat4Make((float)rgb.redComponent, (float)rgb.greenComponent,
+                                                     (float)rgb.blueComponent, (float)rgb.alphaComponent);
+            }
+        }
     }
     return self;
 }
@@ -21,4 +39,31 @@
     return [[self alloc] initWithIdentifier:identifier displayName:displayName colors:colors];
 }
 
+- (void)dealloc {
+    for (int wrap = 0; wrap < 2; wrap++) {
+        for (int encoding = 0; encoding < 2; encoding++) {
+            free(atomic_load_explicit(&_lookupTables[wrap][encoding], memory_order_relaxed));
+        }
+    }
+    free(_stops);
+}
+
+- (const SSKPaletteLUT *)lookupTableForWrap:(SSKPaletteWrap)wrap encoding:(SSKPaletteEncoding)encoding {
+    _Atomic(SSKPaletteLUT *) *slot = &_lookupTables[wrap == SSKPaletteWrapClamp][encoding == SSKPaletteEncodingSRGB];
+    SSKPaletteLUT *table = atomic_load_explicit(slot, memory_order_acquire);
+    if (table) {
+        return table;
+    }
+    SSKPaletteLUT *built = malloc(sizeof(SSKPaletteLUT));
+    if (!built) {
+        return NULL;
+    }
+    SSKPaletteLUTBuild(built, _stops, _stopCount, wrap, encoding);
+    if (!atomic_compare_exchange_strong_explicit(slot, &table, built, memory_order_acq_rel, memory_order_acquire)) {
+        free(built);
+        return table;
+    }
+    return built;
+}
+
 @end
@@ -106,12 +106,14 @@
 
 - (void)handleOK:(id)sender {
     [self.preferenceBinder synchronize];
+    [self.saverView notifyPreferencesChanged];
     [NSApp endSheet:self.window returnCode:NSModalResponseOK];
     [self.window orderOut:nil];
 }
 
 - (void)handleCancel:(id)sender {
     [self.preferenceBinder restoreInitialValues];
+    [self.saverView notifyPreferencesChanged];
     [NSApp endSheet:self.window returnCode:NSModalResponseCancel];
     [self.window orderOut:nil];
 }
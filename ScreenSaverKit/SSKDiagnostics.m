@@ -23,16 +23,30 @@ static BOOL SSKDiagnosticsEnabled = NO;
 
 + (void)drawOverlayInView:(NSView *)view text:(NSString *)text framesPerSecond:(double)fps {
     if (!SSKDiagnosticsEnabled || !view) { return; }
+    static NSDictionary *attrs;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        attrs = @{
+            NSFontAttributeName: [NSFont monospacedDigitSystemFontOfSize:12 weight:NSFontWeightMedium],
+            NSForegroundColorAttributeName: [NSColor colorWithWhite:1 alpha:0.95]
+        };
+    });
     NSString *overlay = text.length ? [NSString stringWithFormat:@"%@\nFPS: %.1f", text, fps] :
     [NSString stringWithFormat:@"FPS: %.1f", fps];
-    
-    NSDictionary *attrs = @{
-        NSFontAttributeName: [NSFont monospacedDigitSystemFontOfSize:12 weight:NSFontWeightMedium],
-        NSForegroundColorAttributeName: [NSColor colorWithWhite:1 alpha:0.95]
-    };
-    
+
+    // Digits are monospaced, so the panel is measured against a widest-case
+    // FPS and only when the text above it changes, not on every frame.
+    static NSString *measuredText;
+    static NSSize measuredSize;
+    NSString *key = text ?: @"";
+    if (!measuredText || ![measuredText isEqualToString:key]) {
+        NSString *widest = key.length ? [key stringByAppendingString:@"\nFPS: 000.0"] : @"FPS: 000.0";
+        measuredSize = [widest sizeWithAttributes:attrs];
+        measuredText = [key copy];
+    }
+
     NSRect bounds = view.bounds;
-    NSSize size = [overlay sizeWithAttributes:attrs];
+    NSSize size = measuredSize;
     NSRect panel = NSMakeRect(NSMinX(bounds) + 12,
                               NSMaxY(bounds) - size.height - 20,
                               size.width + 16,
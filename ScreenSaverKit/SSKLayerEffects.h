@@ -8,6 +8,18 @@ NS_ASSUME_NONNULL_BEGIN
 /// Passing a radius <= 0 removes the blur.
 + (void)applyGaussianBlurWithRadius:(CGFloat)radius toLayer:(CALayer *)layer;
 
+/// Blurs an 8-bit RGBA bitmap context in place on the CPU with the same kernel
+/// as `SSKMetalBlurPass` (radius is the Gaussian sigma in pixels). Radii too
+/// large for the Metal kernel are blurred at reduced resolution. Returns NO if
+/// the context is not a 32-bit RGBA bitmap.
++ (BOOL)applyGaussianBlurWithRadius:(CGFloat)radius toBitmapContext:(CGContextRef)context;
+
+/// CPU version of `SSKMetalBloomPass` for an 8-bit RGBA bitmap context.
++ (BOOL)applyBloomWithThreshold:(CGFloat)threshold
+                      intensity:(CGFloat)intensity
+                      blurSigma:(CGFloat)blurSigma
+                toBitmapContext:(CGContextRef)context;
+
 @end
 
 NS_ASSUME_NONNULL_END
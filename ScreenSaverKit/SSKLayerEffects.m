@@ -2,6 +2,15 @@
 
 #import <CoreImage/CoreImage.h>
 
+#import "Core/SSKBlur.h"
+
+/// Shared CPU blur state. The pool runs one loop at a time, so callers hold
+/// the lock for the whole filter.
+static NSLock *SSKLayerEffectsLock;
+static SSKTaskPool *SSKLayerEffectsPool;
+static SSKBlurContext SSKLayerEffectsBlurContext;
+static NSMutableData *SSKLayerEffectsPixels;
+
 @implementation SSKLayerEffects
 
 + (void)applyGaussianBlurWithRadius:(CGFloat)radius toLayer:(CALayer *)layer {
@@ -16,4 +25,62 @@
     layer.backgroundFilters = @[filter];
 }
 
++ (BOOL)applyGaussianBlurWithRadius:(CGFloat)radius toBitmapContext:(CGContextRef)context {
+    float sigma = (float)radius;
+    uint32_t levels = sigma * 3.0f > SSKBlurMaxRadius ? SSKBlurLevelsForSigma(sigma) : 0;
+    return [self filterBitmapContext:context usingBlock:^BOOL(SSKBlurContext *blur, SSKTaskPool *pool, const SSKFloatImage *image) {
+        return SSKBlurGaussianDownsampled(blur, pool, image, image, sigma, levels);
+    }];
+}
+
++ (BOOL)applyBloomWithThreshold:(CGFloat)threshold
+                      intensity:(CGFloat)intensity
+                      blurSigma:(CGFloat)blurSigma
+                toBitmapContext:(CGContextRef)context {
+    SSKBloomParams params = {(float)threshold, (float)intensity, (float)blurSigma, 0};
+    return [self filterBitmapContext:context usingBlock:^BOOL(SSKBlurContext *blur, SSKTaskPool *pool, const SSKFloatImage *image) {
+        return SSKBloomApply(blur, pool, image, &params);
+    }];
+}
+
+#pragma mark - Helpers
+
++ (BOOL)filterBitmapContext:(CGContextRef)context
+                 usingBlock:(BOOL (^)(SSKBlurContext *blur, SSKTaskPool *pool, const SSKFloatImage *image))block {
+    if (!context || CGContextGetType(context) != kCGContextTypeBitmap) { return NO; }
+    uint8_t *data = CGBitmapContextGetData(context);
+    size_t width = CGBitmapContextGetWidth(context);
+    size_t height = CGBitmapContextGetHeight(context);
+    size_t rowBytes = CGBitmapContextGetBytesPerRow(context);
+    CGImageAlphaInfo alphaInfo = CGBitmapContextGetAlphaInfo(context);
+    BOOL rgba = (alphaInfo == kCGImageAlphaPremultipliedLast || alphaInfo == kCGImageAlphaNoneSkipLast) &&
+                (CGBitmapContextGetBitmapInfo(context) & kCGBitmapByteOrderMask) == kCGBitmapByteOrderDefault;
+    if (!data || width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX || !rgba ||
+        CGBitmapContextGetBitsPerComponent(context) != 8 || CGBitmapContextGetBitsPerPixel(context) != 32) {
+        return NO;
+    }
+
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        SSKLayerEffectsLock = [[NSLock alloc] init];
+        SSKLayerEffectsPool = SSKTaskPoolCreate(0);
+        SSKBlurContextInit(&SSKLayerEffectsBlurContext);
+        SSKLayerEffectsPixels = [NSMutableData data];
+    });
+
+    [SSKLayerEffectsLock lock];
+    NSUInteger length = width * height * sizeof(SSKFloat4);
+    if (SSKLayerEffectsPixels.length < length) {
+        SSKLayerEffectsPixels.length = length;
+    }
+    SSKFloatImage image = {SSKLayerEffectsPixels.mutableBytes, (uint32_t)width, (uint32_t)height, (uint32_t)width};
+    SSKFloatImageLoadRGBA8(&image, data, rowBytes);
+    BOOL success = block(&SSKLayerEffectsBlurContext, SSKLayerEffectsPool, &image);
+    if (success) {
+        SSKFloatImageStoreRGBA8(&image, data, rowBytes);
+    }
+    [SSKLayerEffectsLock unlock];
+    return success;
+}
+
 @end
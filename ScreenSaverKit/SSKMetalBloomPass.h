@@ -1,17 +1,38 @@
 #import "SSKMetalPass.h"
+#import "Core/SSKFrameGraph.h"
 
 @class SSKMetalBlurPass;
+@class SSKMetalFrameGraph;
 @class SSKMetalTextureCache;
 
 NS_ASSUME_NONNULL_BEGIN
 
+typedef NS_ENUM(NSInteger, SSKMetalBloomMode) {
+    /// Full-resolution threshold, separable Gaussian blur and composite.
+    SSKMetalBloomModeGaussian = 0,
+    /// Dual Kawase chain: the bright pass is folded into a half-resolution
+    /// downsample, further levels halve again and are upsampled back. The glow
+    /// radius doubles per level while the cost stays close to one
+    /// full-resolution pass, so wide glows are much cheaper than the Gaussian.
+    SSKMetalBloomModeMipChain,
+};
+
 /// Brightness threshold filter + separable blur used for bloom/glow effects.
 @interface SSKMetalBloomPass : SSKMetalPass
 
 @property (nonatomic) CGFloat threshold;
 @property (nonatomic) CGFloat intensity;
+/// Gaussian mode only.
 @property (nonatomic) CGFloat blurSigma;
 
+/// Defaults to `SSKMetalBloomModeGaussian`. Falls back to Gaussian when the
+/// library lacks the Kawase kernels.
+@property (nonatomic) SSKMetalBloomMode mode;
+
+/// Mip chain mode only: number of half-resolution levels (1-8, default 5).
+/// Clamped further so the smallest level stays at least 2 pixels across.
+@property (nonatomic) NSUInteger mipLevels;
+
 - (BOOL)setupWithDevice:(id<MTLDevice>)device
                 library:(id<MTLLibrary>)library;
 
@@ -24,6 +45,13 @@ NS_ASSUME_NONNULL_BEGIN
                         renderTarget:(id<MTLTexture>)renderTarget
                         textureCache:(SSKMetalTextureCache *)textureCache;
 
+/// Records the bloom into `graph` as compute passes over transient textures.
+/// The Gaussian bright and blurred textures end up sharing storage with the
+/// blur scratch, and the passes join any neighbouring compute batch.
+- (BOOL)addBloomToFrameGraph:(SSKMetalFrameGraph *)graph
+                      source:(SSKFrameGraphResource)source
+                renderTarget:(SSKFrameGraphResource)renderTarget;
+
 @end
 
 NS_ASSUME_NONNULL_END
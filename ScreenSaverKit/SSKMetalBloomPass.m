@@ -1,16 +1,22 @@
 #import "SSKMetalBloomPass.h"
 
 #import <TargetConditionals.h>
+#import <math.h>
 
 #import "SSKDiagnostics.h"
 #import "SSKMetalBlurPass.h"
+#import "SSKMetalFrameGraph.h"
 #import "SSKMetalTextureCache.h"
+#import "Core/SSKBlur.h"
 
 @interface SSKMetalBloomPass ()
 @property (nonatomic, strong) id<MTLDevice> device;
 @property (nonatomic, strong) id<MTLLibrary> library;
 @property (nonatomic, strong) id<MTLComputePipelineState> thresholdPipeline;
 @property (nonatomic, strong) id<MTLComputePipelineState> compositePipeline;
+@property (nonatomic, strong, nullable) id<MTLComputePipelineState> kawaseDownsamplePipeline;
+@property (nonatomic, strong, nullable) id<MTLComputePipelineState> kawaseUpsamplePipeline;
+@property (nonatomic, strong, nullable) id<MTLComputePipelineState> kawaseCompositePipeline;
 @property (nonatomic, strong, nullable) SSKMetalBlurPass *sharedBlurPass;
 @property (nonatomic, strong, nullable) SSKMetalBlurPass *fallbackBlurPass;
 @end
@@ -22,6 +28,8 @@
         _threshold = 0.8;
         _intensity = 1.0;
         _blurSigma = 3.0;
+        _mode = SSKMetalBloomModeGaussian;
+        _mipLevels = 5;
     }
     return self;
 }
@@ -64,9 +72,42 @@
         return NO;
     }
 
+    [self setupKawasePipelinesWithDevice:device library:library];
     return YES;
 }
 
+/// The mip chain kernels are optional: libraries built before they existed
+/// still get the Gaussian bloom.
+- (void)setupKawasePipelinesWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library {
+    id<MTLFunction> downsampleFunc = [library newFunctionWithName:@"bloomKawaseDownsample"];
+    id<MTLFunction> upsampleFunc = [library newFunctionWithName:@"bloomKawaseUpsample"];
+    id<MTLFunction> compositeFunc = [library newFunctionWithName:@"bloomKawaseComposite"];
+    if (!downsampleFunc || !upsampleFunc || !compositeFunc) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalBloomPass: Kawase kernels missing – mip chain mode will use the Gaussian bloom."];
+        }
+        return;
+    }
+
+    NSError *error = nil;
+    id<MTLComputePipelineState> downsample = [device newComputePipelineStateWithFunction:downsampleFunc error:&error];
+    id<MTLComputePipelineState> upsample = downsample ? [device newComputePipelineStateWithFunction:upsampleFunc error:&error] : nil;
+    id<MTLComputePipelineState> composite = upsample ? [device newComputePipelineStateWithFunction:compositeFunc error:&error] : nil;
+    if (!composite) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalBloomPass: failed to create Kawase pipelines: %@", error.localizedDescription];
+        }
+        return;
+    }
+    self.kawaseDownsamplePipeline = downsample;
+    self.kawaseUpsamplePipeline = upsample;
+    self.kawaseCompositePipeline = composite;
+}
+
+- (void)setMipLevels:(NSUInteger)mipLevels {
+    _mipLevels = MIN(MAX(mipLevels, (NSUInteger)1), (NSUInteger)8);
+}
+
 - (void)setSharedBlurPass:(SSKMetalBlurPass *)blurPass {
     _sharedBlurPass = blurPass;
     if (blurPass) {
@@ -103,6 +144,13 @@
         return NO;
     }
 
+    if (self.mode == SSKMetalBloomModeMipChain && self.kawaseCompositePipeline) {
+        return [self encodeMipChainWithCommandBuffer:commandBuffer
+                                              source:source
+                                        renderTarget:renderTarget
+                                        textureCache:textureCache];
+    }
+
     SSKMetalBlurPass *blurPass = [self resolvedBlurPass];
     if (!blurPass) {
         if ([SSKDiagnostics isEnabled]) {
@@ -175,4 +223,220 @@
     return YES;
 }
 
+#pragma mark - Mip chain
+
+- (void)dispatchPipeline:(id<MTLComputePipelineState>)pipeline
+                 encoder:(id<MTLComputeCommandEncoder>)encoder
+                  source:(id<MTLTexture>)source
+             destination:(id<MTLTexture>)destination
+                   value:(const float *)value {
+    MTLSize threadsPerGroup = MTLSizeMake(16, 16, 1);
+    MTLSize threadGroups = MTLSizeMake((destination.width + threadsPerGroup.width - 1) / threadsPerGroup.width,
+                                       (destination.height + threadsPerGroup.height - 1) / threadsPerGroup.height,
+                                       1);
+    [encoder setComputePipelineState:pipeline];
+    [encoder setTexture:source atIndex:0];
+    [encoder setTexture:destination atIndex:1];
+    if (value) {
+        [encoder setBytes:value length:sizeof(float) atIndex:0];
+    }
+    [encoder dispatchThreadgroups:threadGroups threadsPerThreadgroup:threadsPerGroup];
+}
+
+/// Downsamples `source` through `levels` cached textures (the first with the
+/// bright pass), upsamples back up in place and composites the last upsample
+/// into `renderTarget`. `SSKBloomApply` in `SSKBloomModeMipChain` computes the
+/// same image on the CPU.
+- (BOOL)encodeMipChainWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                                 source:(id<MTLTexture>)source
+                           renderTarget:(id<MTLTexture>)renderTarget
+                           textureCache:(SSKMetalTextureCache *)textureCache {
+    uint32_t levels = SSKBloomMipChainLevels((uint32_t)source.width, (uint32_t)source.height, (uint32_t)self.mipLevels);
+    if (levels == 0) {
+        return YES;
+    }
+
+    MTLTextureUsage usage = MTLTextureUsageShaderRead | MTLTextureUsageShaderWrite;
+    NSMutableArray<id<MTLTexture>> *chain = [NSMutableArray arrayWithCapacity:levels];
+    for (uint32_t level = 1; level <= levels; level++) {
+        CGSize size = CGSizeMake(SSKBloomMipExtent((uint32_t)source.width, level),
+                                 SSKBloomMipExtent((uint32_t)source.height, level));
+        id<MTLTexture> texture = [textureCache acquireTextureWithSize:size pixelFormat:source.pixelFormat usage:usage];
+        if (!texture) {
+            for (id<MTLTexture> acquired in chain) {
+                [textureCache releaseTexture:acquired];
+            }
+            if ([SSKDiagnostics isEnabled]) {
+                [SSKDiagnostics log:@"SSKMetalBloomPass: failed to acquire mip level %u from cache.", level];
+            }
+            return NO;
+        }
+        [chain addObject:texture];
+    }
+
+    id<MTLComputeCommandEncoder> encoder = [commandBuffer computeCommandEncoder];
+    if (!encoder) {
+        for (id<MTLTexture> texture in chain) {
+            [textureCache releaseTexture:texture];
+        }
+        return NO;
+    }
+
+    // Dispatches in one encoder run in order, so each level sees the previous
+    // one complete.
+    float thresholdValue = (float)MIN(MAX(self.threshold, 0.0), 1.0);
+    float noThreshold = -1.0f;
+    [self dispatchPipeline:self.kawaseDownsamplePipeline
+                   encoder:encoder
+                    source:source
+               destination:chain[0]
+                     value:&thresholdValue];
+    for (NSUInteger level = 1; level < levels; level++) {
+        [self dispatchPipeline:self.kawaseDownsamplePipeline
+                       encoder:encoder
+                        source:chain[level - 1]
+                   destination:chain[level]
+                         value:&noThreshold];
+    }
+    for (NSUInteger level = levels - 1; level > 0; level--) {
+        [self dispatchPipeline:self.kawaseUpsamplePipeline
+                       encoder:encoder
+                        source:chain[level]
+                   destination:chain[level - 1]
+                         value:NULL];
+    }
+    float compositeIntensity = (float)MAX(0.0, self.intensity);
+    [self dispatchPipeline:self.kawaseCompositePipeline
+                   encoder:encoder
+                    source:chain[0]
+               destination:renderTarget
+                     value:&compositeIntensity];
+    [encoder endEncoding];
+
+    for (id<MTLTexture> texture in chain) {
+        [textureCache releaseTexture:texture];
+    }
+    return YES;
+}
+
+#pragma mark - Frame graph
+
+- (BOOL)addBloomToFrameGraph:(SSKMetalFrameGraph *)graph
+                      source:(SSKFrameGraphResource)source
+                renderTarget:(SSKFrameGraphResource)renderTarget {
+    if (!graph || source == SSKFrameGraphInvalid || renderTarget == SSKFrameGraphInvalid || !self.device ||
+        !self.thresholdPipeline || !self.compositePipeline) {
+        return NO;
+    }
+
+    float compositeIntensity = (float)MAX(0.0, self.intensity);
+    float thresholdValue = (float)MIN(MAX(self.threshold, 0.0), 1.0);
+    if (self.mode == SSKMetalBloomModeMipChain && self.kawaseCompositePipeline) {
+        uint32_t width = (uint32_t)[graph widthOfResource:source];
+        uint32_t height = (uint32_t)[graph heightOfResource:source];
+        uint32_t levels = SSKBloomMipChainLevels(width, height, (uint32_t)self.mipLevels);
+        if (levels == 0) {
+            return YES;
+        }
+        MTLPixelFormat pixelFormat = [graph pixelFormatOfResource:source];
+        MTLTextureUsage usage = MTLTextureUsageShaderRead | MTLTextureUsageShaderWrite;
+        SSKFrameGraphResource chain[8];
+        for (uint32_t level = 1; level <= levels; level++) {
+            chain[level - 1] = [graph createTextureWithWidth:SSKBloomMipExtent(width, level)
+                                                      height:SSKBloomMipExtent(height, level)
+                                                 pixelFormat:pixelFormat
+                                                       usage:usage
+                                                        name:@"bloom.mip"];
+        }
+
+        float noThreshold = -1.0f;
+        BOOL added = [self addDispatchToFrameGraph:graph
+                                              name:@"bloom.downsample"
+                                          pipeline:self.kawaseDownsamplePipeline
+                                            source:source
+                                       destination:chain[0]
+                                        accumulate:NO
+                                             value:thresholdValue];
+        for (uint32_t level = 1; added && level < levels; level++) {
+            added = [self addDispatchToFrameGraph:graph
+                                             name:@"bloom.downsample"
+                                         pipeline:self.kawaseDownsamplePipeline
+                                           source:chain[level - 1]
+                                      destination:chain[level]
+                                       accumulate:NO
+                                            value:noThreshold];
+        }
+        for (uint32_t level = levels - 1; added && level > 0; level--) {
+            added = [self addDispatchToFrameGraph:graph
+                                             name:@"bloom.upsample"
+                                         pipeline:self.kawaseUpsamplePipeline
+                                           source:chain[level]
+                                      destination:chain[level - 1]
+                                       accumulate:NO
+                                            value:NAN];
+        }
+        return added && [self addDispatchToFrameGraph:graph
+                                                 name:@"bloom.composite"
+                                             pipeline:self.kawaseCompositePipeline
+                                               source:chain[0]
+                                          destination:renderTarget
+                                           accumulate:YES
+                                                value:compositeIntensity];
+    }
+
+    SSKMetalBlurPass *blurPass = [self resolvedBlurPass];
+    if (!blurPass) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalBloomPass: blur pass unavailable – skipping bloom."];
+        }
+        return NO;
+    }
+    SSKFrameGraphResource bright = [graph createTextureLike:source name:@"bloom.bright"];
+    SSKFrameGraphResource blurred = [graph createTextureLike:source name:@"bloom.blurred"];
+    blurPass.radius = (self.blurSigma > 0.01) ? self.blurSigma : 3.0;
+    return [self addDispatchToFrameGraph:graph
+                                    name:@"bloom.threshold"
+                                pipeline:self.thresholdPipeline
+                                  source:source
+                             destination:bright
+                              accumulate:NO
+                                   value:thresholdValue] &&
+           [blurPass addBlurToFrameGraph:graph source:bright destination:blurred] &&
+           [self addDispatchToFrameGraph:graph
+                                    name:@"bloom.composite"
+                                pipeline:self.compositePipeline
+                                  source:blurred
+                             destination:renderTarget
+                              accumulate:YES
+                                   value:compositeIntensity];
+}
+
+/// One source-to-destination dispatch as a graph pass. `accumulate` marks
+/// kernels that read the destination back (the composites); `value` is bound
+/// at buffer 0 unless it is NaN.
+- (BOOL)addDispatchToFrameGraph:(SSKMetalFrameGraph *)graph
+                           name:(NSString *)name
+                       pipeline:(id<MTLComputePipelineState>)pipeline
+                         source:(SSKFrameGraphResource)source
+                    destination:(SSKFrameGraphResource)destination
+                     accumulate:(BOOL)accumulate
+                          value:(float)value {
+    if (source == SSKFrameGraphInvalid || destination == SSKFrameGraphInvalid) {
+        return NO;
+    }
+    NSArray<NSNumber *> *reads = accumulate ? @[ @(source), @(destination) ] : @[ @(source) ];
+    __weak typeof(self) weakSelf = self;
+    return [graph addComputePassNamed:name
+                                reads:reads
+                               writes:@[ @(destination) ]
+                                block:^(SSKMetalFrameGraph *frameGraph, id<MTLComputeCommandEncoder> encoder) {
+        float bytes = value;
+        [weakSelf dispatchPipeline:pipeline
+                           encoder:encoder
+                            source:[frameGraph textureForResource:source]
+                       destination:[frameGraph textureForResource:destination]
+                             value:isnan(value) ? NULL : &bytes];
+    }];
+}
+
 @end
@@ -1,5 +1,7 @@
 #import "SSKMetalPass.h"
+#import "Core/SSKFrameGraph.h"
 
+@class SSKMetalFrameGraph;
 @class SSKMetalTextureCache;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -19,6 +21,13 @@ NS_ASSUME_NONNULL_BEGIN
       commandBuffer:(id<MTLCommandBuffer>)commandBuffer
        textureCache:(SSKMetalTextureCache *)textureCache;
 
+/// Records the blur as two compute passes (horizontal into a transient
+/// scratch, vertical into `destination`) so the graph can share their encoder
+/// with neighbouring passes and alias the scratch texture.
+- (BOOL)addBlurToFrameGraph:(SSKMetalFrameGraph *)graph
+                     source:(SSKFrameGraphResource)source
+                destination:(SSKFrameGraphResource)destination;
+
 @end
 
 NS_ASSUME_NONNULL_END
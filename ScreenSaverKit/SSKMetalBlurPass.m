@@ -4,29 +4,20 @@
 #import <math.h>
 
 #import "SSKDiagnostics.h"
+#import "SSKMetalFrameGraph.h"
 #import "SSKMetalTextureCache.h"
-
-static const uint32_t kSSKMetalBlurMaxRadius = 32u;
+#import "Core/SSKBlur.h"
 
 @interface SSKMetalBlurPass ()
 @property (nonatomic, strong) id<MTLDevice> device;
 @property (nonatomic, strong) id<MTLComputePipelineState> blurPipelineHorizontal;
 @property (nonatomic, strong) id<MTLComputePipelineState> blurPipelineVertical;
 @property (nonatomic, strong, nullable) id<MTLBuffer> weightsBuffer;
-@property (nonatomic) float cachedSigma;
-@property (nonatomic) uint32_t cachedRadius;
+@property (nonatomic) SSKBlurWeights cachedWeights;
 @end
 
 @implementation SSKMetalBlurPass
 
-- (instancetype)init {
-    if ((self = [super init])) {
-        _cachedSigma = -1.0f;
-        _cachedRadius = 0;
-    }
-    return self;
-}
-
 - (BOOL)setupWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library {
     NSParameterAssert(device);
     NSParameterAssert(library);
@@ -92,10 +83,10 @@ static const uint32_t kSSKMetalBlurMaxRadius = 32u;
         return NO;
     }
 
-    float sigma = MAX(0.5f, (float)self.radius);
-    uint32_t radius = (uint32_t)ceilf(MAX(1.0f, sigma * 3.0f));
-    radius = MIN(radius, kSSKMetalBlurMaxRadius);
-    if (![self prepareWeightsForSigma:sigma radius:radius]) {
+    // Same taps as the CPU blur in Core/SSKBlur.h.
+    SSKBlurWeights weights = SSKBlurWeightsForSigma((float)self.radius);
+    uint32_t radius = weights.radius;
+    if (![self prepareWeights:&weights]) {
         [textureCache releaseTexture:scratch];
         return NO;
     }
@@ -142,36 +133,82 @@ static const uint32_t kSSKMetalBlurMaxRadius = 32u;
     return YES;
 }
 
-#pragma mark - Helpers
-
-- (BOOL)prepareWeightsForSigma:(float)sigma radius:(uint32_t)radius {
-    if (self.weightsBuffer && fabsf(self.cachedSigma - sigma) < 0.001f && self.cachedRadius == radius) {
+- (BOOL)addBlurToFrameGraph:(SSKMetalFrameGraph *)graph
+                     source:(SSKFrameGraphResource)source
+                destination:(SSKFrameGraphResource)destination {
+    if (!graph || source == SSKFrameGraphInvalid || destination == SSKFrameGraphInvalid) {
+        return NO;
+    }
+    if (self.radius <= 0.01f) {
         return YES;
     }
-    if (radius == 0 || radius > kSSKMetalBlurMaxRadius) {
+    if (!self.blurPipelineHorizontal || !self.blurPipelineVertical || !self.device) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalBlurPass: blur pipelines unavailable."];
+        }
         return NO;
     }
 
-    float weights[kSSKMetalBlurMaxRadius + 1] = {0.0f};
-    float sum = 0.0f;
-    weights[0] = 1.0f;
-    sum += weights[0];
-    float doubleSigmaSq = 2.0f * sigma * sigma;
-    for (uint32_t i = 1; i <= radius; ++i) {
-        float weight = expf(-(float)(i * i) / doubleSigmaSq);
-        weights[i] = weight;
-        sum += 2.0f * weight;
+    SSKBlurWeights weights = SSKBlurWeightsForSigma((float)self.radius);
+    if (![self prepareWeights:&weights]) {
+        return NO;
     }
-    float invSum = sum > 0.00001f ? (1.0f / sum) : 1.0f;
-    for (uint32_t i = 0; i <= radius; ++i) {
-        weights[i] *= invSum;
+    SSKFrameGraphResource scratch = [graph createTextureLike:source name:@"blur.scratch"];
+    if (scratch == SSKFrameGraphInvalid) {
+        return NO;
     }
 
-    float normalized[kSSKMetalBlurMaxRadius + 1] = {0.0f};
-    memcpy(normalized, weights, sizeof(float) * (radius + 1));
+    // The weights buffer is replaced rather than rewritten when the radius
+    // changes, so capturing it here keeps the taps this frame was recorded with.
+    id<MTLBuffer> weightsBuffer = self.weightsBuffer;
+    uint32_t radiusValue = weights.radius;
+    id<MTLComputePipelineState> horizontal = self.blurPipelineHorizontal;
+    id<MTLComputePipelineState> vertical = self.blurPipelineVertical;
+    MTLSize horizontalThreads = [self threadgroupSizeForPipeline:horizontal];
+    MTLSize verticalThreads = [self threadgroupSizeForPipeline:vertical];
+    MTLSize horizontalGroups = [self threadgroupCountForWidth:[graph widthOfResource:scratch]
+                                                       height:[graph heightOfResource:scratch]
+                                             threadsPerGroup:horizontalThreads];
+    MTLSize verticalGroups = [self threadgroupCountForWidth:[graph widthOfResource:destination]
+                                                     height:[graph heightOfResource:destination]
+                                           threadsPerGroup:verticalThreads];
+
+    BOOL added = [graph addComputePassNamed:@"blur.horizontal"
+                                      reads:@[ @(source) ]
+                                     writes:@[ @(scratch) ]
+                                      block:^(SSKMetalFrameGraph *frameGraph, id<MTLComputeCommandEncoder> encoder) {
+        uint32_t radius = radiusValue;
+        [encoder setComputePipelineState:horizontal];
+        [encoder setTexture:[frameGraph textureForResource:source] atIndex:0];
+        [encoder setTexture:[frameGraph textureForResource:scratch] atIndex:1];
+        [encoder setBuffer:weightsBuffer offset:0 atIndex:0];
+        [encoder setBytes:&radius length:sizeof(uint32_t) atIndex:1];
+        [encoder dispatchThreadgroups:horizontalGroups threadsPerThreadgroup:horizontalThreads];
+    }];
+    return added && [graph addComputePassNamed:@"blur.vertical"
+                                         reads:@[ @(scratch) ]
+                                        writes:@[ @(destination) ]
+                                         block:^(SSKMetalFrameGraph *frameGraph, id<MTLComputeCommandEncoder> encoder) {
+        uint32_t radius = radiusValue;
+        [encoder setComputePipelineState:vertical];
+        [encoder setTexture:[frameGraph textureForResource:scratch] atIndex:0];
+        [encoder setTexture:[frameGraph textureForResource:destination] atIndex:1];
+        [encoder setBuffer:weightsBuffer offset:0 atIndex:0];
+        [encoder setBytes:&radius length:sizeof(uint32_t) atIndex:1];
+        [encoder dispatchThreadgroups:verticalGroups threadsPerThreadgroup:verticalThreads];
+    }];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)prepareWeights:(const SSKBlurWeights *)weights {
+    SSKBlurWeights cached = self.cachedWeights;
+    if (self.weightsBuffer && memcmp(&cached, weights, sizeof(SSKBlurWeights)) == 0) {
+        return YES;
+    }
 
-    NSUInteger bufferLength = sizeof(float) * (radius + 1);
-    id<MTLBuffer> buffer = [self.device newBufferWithBytes:normalized
+    NSUInteger bufferLength = sizeof(float) * (weights->radius + 1);
+    id<MTLBuffer> buffer = [self.device newBufferWithBytes:weights->weights
                                                    length:bufferLength
                                                   options:MTLResourceStorageModeShared];
     if (!buffer) {
@@ -179,8 +216,7 @@ static const uint32_t kSSKMetalBlurMaxRadius = 32u;
     }
 
     self.weightsBuffer = buffer;
-    self.cachedSigma = sigma;
-    self.cachedRadius = radius;
+    self.cachedWeights = *weights;
     return YES;
 }
 
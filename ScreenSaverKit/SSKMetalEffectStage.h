@@ -2,9 +2,11 @@
 #import <Metal/Metal.h>
 
 #import "SSKMetalPass.h"
+#import "Core/SSKFrameGraph.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class SSKMetalFrameGraph;
 @class SSKMetalRenderer;
 
 /// Block invoked when an effect stage should encode its work into the current
@@ -15,6 +17,15 @@ typedef BOOL (^SSKMetalEffectStageHandler)(SSKMetalRenderer *renderer,
                                            id<MTLTexture> renderTarget,
                                            NSDictionary *parameters);
 
+/// Block invoked instead of the handler when the renderer records its effects
+/// into a frame graph (`SSKMetalRenderer.usesFrameGraph`). It adds passes that
+/// read and write `renderTarget` rather than encoding anything itself.
+typedef BOOL (^SSKMetalEffectStageGraphHandler)(SSKMetalRenderer *renderer,
+                                                SSKMetalPass *pass,
+                                                SSKMetalFrameGraph *graph,
+                                                SSKFrameGraphResource renderTarget,
+                                                NSDictionary *parameters);
+
 /// Describes a single post-process stage that can be registered with
 /// `SSKMetalRenderer`. Each stage wraps a concrete `SSKMetalPass` instance and
 /// a handler block that knows how to invoke it.
@@ -29,10 +40,19 @@ typedef BOOL (^SSKMetalEffectStageHandler)(SSKMetalRenderer *renderer,
 /// Block responsible for encoding the effect.
 @property (nonatomic, copy, readonly) SSKMetalEffectStageHandler handler;
 
+/// Optional frame graph variant of `handler`. Stages without one still work
+/// in a frame graph: their handler runs as a single opaque pass.
+@property (nonatomic, copy, readonly, nullable) SSKMetalEffectStageGraphHandler graphHandler;
+
+- (instancetype)initWithIdentifier:(NSString *)identifier
+                              pass:(SSKMetalPass *)pass
+                           handler:(SSKMetalEffectStageHandler)handler;
+
 /// Designated initialiser.
 - (instancetype)initWithIdentifier:(NSString *)identifier
                               pass:(SSKMetalPass *)pass
-                           handler:(SSKMetalEffectStageHandler)handler NS_DESIGNATED_INITIALIZER;
+                           handler:(SSKMetalEffectStageHandler)handler
+                      graphHandler:(nullable SSKMetalEffectStageGraphHandler)graphHandler NS_DESIGNATED_INITIALIZER;
 
 - (instancetype)init NS_UNAVAILABLE;
 + (instancetype)new NS_UNAVAILABLE;
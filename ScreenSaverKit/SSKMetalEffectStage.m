@@ -4,6 +4,7 @@
 @property (nonatomic, copy, readwrite) NSString *identifier;
 @property (nonatomic, strong, readwrite) SSKMetalPass *pass;
 @property (nonatomic, copy, readwrite) SSKMetalEffectStageHandler handler;
+@property (nonatomic, copy, readwrite, nullable) SSKMetalEffectStageGraphHandler graphHandler;
 @end
 
 @implementation SSKMetalEffectStage
@@ -11,6 +12,13 @@
 - (instancetype)initWithIdentifier:(NSString *)identifier
                               pass:(SSKMetalPass *)pass
                            handler:(SSKMetalEffectStageHandler)handler {
+    return [self initWithIdentifier:identifier pass:pass handler:handler graphHandler:nil];
+}
+
+- (instancetype)initWithIdentifier:(NSString *)identifier
+                              pass:(SSKMetalPass *)pass
+                           handler:(SSKMetalEffectStageHandler)handler
+                      graphHandler:(SSKMetalEffectStageGraphHandler)graphHandler {
     NSParameterAssert(identifier.length > 0);
     NSParameterAssert(pass);
     NSParameterAssert(handler);
@@ -18,6 +26,7 @@
         _identifier = [identifier copy];
         _pass = pass;
         _handler = [handler copy];
+        _graphHandler = [graphHandler copy];
     }
     return self;
 }
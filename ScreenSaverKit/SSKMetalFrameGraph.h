@@ -0,0 +1,89 @@
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+#import "Core/SSKFrameGraph.h"
+
+@class SSKMetalFrameGraph;
+@class SSKMetalTextureCache;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Encodes one compute pass into the batch's shared encoder. Resolve textures
+/// with `-textureForResource:`; do not end the encoder.
+typedef void (^SSKMetalFrameGraphComputeBlock)(SSKMetalFrameGraph *graph, id<MTLComputeCommandEncoder> encoder);
+
+/// Encodes a pass that opens its own encoders. Returning `NO` marks the frame
+/// as failed but later passes still run.
+typedef BOOL (^SSKMetalFrameGraphEncoderBlock)(SSKMetalFrameGraph *graph, id<MTLCommandBuffer> commandBuffer);
+
+/// Metal front end for `SSKFrameGraph`: records passes with their texture
+/// reads and writes during the frame, then compiles the graph and encodes the
+/// live passes in one go. Consecutive compute passes share a single compute
+/// encoder (with a memory barrier where one depends on the previous), and
+/// transient textures are backed by as few `SSKMetalTextureCache` textures as
+/// their lifetimes allow.
+@interface SSKMetalFrameGraph : NSObject
+
+/// Drops every recorded pass and texture. Called once per frame.
+- (void)reset;
+
+/// Declares a texture that outlives the frame (e.g. the drawable). Its final
+/// contents are the graph's output. Importing the same texture again returns
+/// the existing resource.
+- (SSKFrameGraphResource)importTexture:(id<MTLTexture>)texture name:(NSString *)name;
+
+/// Declares a frame-local texture. It has no contents until a pass writes it.
+- (SSKFrameGraphResource)createTextureWithWidth:(NSUInteger)width
+                                         height:(NSUInteger)height
+                                    pixelFormat:(MTLPixelFormat)pixelFormat
+                                          usage:(MTLTextureUsage)usage
+                                           name:(NSString *)name;
+
+/// Frame-local texture with the size and format of `resource`, readable and
+/// writable from shaders.
+- (SSKFrameGraphResource)createTextureLike:(SSKFrameGraphResource)resource name:(NSString *)name;
+
+- (NSUInteger)widthOfResource:(SSKFrameGraphResource)resource;
+- (NSUInteger)heightOfResource:(SSKFrameGraphResource)resource;
+- (MTLPixelFormat)pixelFormatOfResource:(SSKFrameGraphResource)resource;
+
+/// Adds a pass made only of compute dispatches. `reads` and `writes` hold
+/// `SSKFrameGraphResource` numbers; list a texture updated in place in both.
+/// Returns `NO` for undeclared textures or lists longer than
+/// `SSKFrameGraphMaxPassResources`.
+- (BOOL)addComputePassNamed:(NSString *)name
+                      reads:(NSArray<NSNumber *> *)reads
+                     writes:(NSArray<NSNumber *> *)writes
+                      block:(SSKMetalFrameGraphComputeBlock)block;
+
+/// Adds a pass that encodes against the command buffer itself (render
+/// passes, legacy effect stages). `sideEffect` keeps it even when nothing
+/// reads its output.
+- (BOOL)addEncoderPassNamed:(NSString *)name
+                      reads:(NSArray<NSNumber *> *)reads
+                     writes:(NSArray<NSNumber *> *)writes
+                 sideEffect:(BOOL)sideEffect
+                      block:(SSKMetalFrameGraphEncoderBlock)block;
+
+/// Texture behind `resource`. Only valid inside pass blocks while executing.
+- (nullable id<MTLTexture>)textureForResource:(SSKFrameGraphResource)resource;
+
+/// Compiles the recorded passes, acquires the physical textures from
+/// `textureCache`, encodes every live pass into `commandBuffer` and returns
+/// the textures to the cache. Pass blocks are released afterwards.
+- (BOOL)executeWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                    textureCache:(SSKMetalTextureCache *)textureCache;
+
+/// Number of passes recorded since the last reset.
+@property (nonatomic, readonly) NSUInteger passCount;
+
+/// Figures from the last execute: passes encoded, encoders opened, and the
+/// bytes of the transient textures with and without aliasing.
+@property (nonatomic, readonly) NSUInteger livePassCount;
+@property (nonatomic, readonly) NSUInteger encoderCount;
+@property (nonatomic, readonly) uint64_t transientBytes;
+@property (nonatomic, readonly) uint64_t physicalBytes;
+
+@end
+
+NS_ASSUME_NONNULL_END
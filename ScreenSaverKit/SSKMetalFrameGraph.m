@@ -0,0 +1,296 @@
+#import "SSKMetalFrameGraph.h"
+
+#import "SSKDiagnostics.h"
+#import "SSKMetalTextureCache.h"
+
+static uint32_t SSKMetalFrameGraphBytesPerPixel(MTLPixelFormat pixelFormat) {
+    return (uint32_t)[SSKMetalTextureCache bytesPerPixelForPixelFormat:pixelFormat];
+}
+
+@interface SSKMetalFrameGraph () {
+    SSKFrameGraph _graph;
+}
+@property (nonatomic, strong) NSMutableArray<NSString *> *passNames;
+@property (nonatomic, strong) NSMutableArray *passBlocks;
+/// Imported texture per resource, `NSNull` for transients.
+@property (nonatomic, strong) NSMutableArray *importedTextures;
+@property (nonatomic, strong) NSMutableArray<id<MTLTexture>> *physicalTextures;
+@property (nonatomic, readwrite) NSUInteger livePassCount;
+@property (nonatomic, readwrite) NSUInteger encoderCount;
+@property (nonatomic, readwrite) uint64_t transientBytes;
+@property (nonatomic, readwrite) uint64_t physicalBytes;
+@end
+
+@implementation SSKMetalFrameGraph
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        SSKFrameGraphInit(&_graph);
+        _passNames = [NSMutableArray array];
+        _passBlocks = [NSMutableArray array];
+        _importedTextures = [NSMutableArray array];
+        _physicalTextures = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    SSKFrameGraphDestroy(&_graph);
+}
+
+- (void)reset {
+    SSKFrameGraphReset(&_graph);
+    [self.passNames removeAllObjects];
+    [self.passBlocks removeAllObjects];
+    [self.importedTextures removeAllObjects];
+    [self.physicalTextures removeAllObjects];
+}
+
+- (NSUInteger)passCount {
+    return _graph.passCount;
+}
+
+- (SSKFrameGraphResource)importTexture:(id<MTLTexture>)texture name:(NSString *)name {
+    (void)name;
+    if (!texture) {
+        return SSKFrameGraphInvalid;
+    }
+    for (uint32_t resource = 0; resource < _graph.resourceCount; resource++) {
+        if (self.importedTextures[resource] == texture) {
+            return resource;
+        }
+    }
+    SSKFrameGraphTextureDesc desc = {
+        (uint32_t)texture.width, (uint32_t)texture.height, (uint32_t)texture.pixelFormat, (uint32_t)texture.usage,
+        SSKMetalFrameGraphBytesPerPixel(texture.pixelFormat),
+    };
+    SSKFrameGraphResource resource = SSKFrameGraphImport(&_graph, NULL, &desc, NULL);
+    if (resource != SSKFrameGraphInvalid) {
+        [self.importedTextures addObject:texture];
+    }
+    return resource;
+}
+
+- (SSKFrameGraphResource)createTextureWithWidth:(NSUInteger)width
+                                         height:(NSUInteger)height
+                                    pixelFormat:(MTLPixelFormat)pixelFormat
+                                          usage:(MTLTextureUsage)usage
+                                           name:(NSString *)name {
+    (void)name;
+    if (width == 0 || height == 0) {
+        return SSKFrameGraphInvalid;
+    }
+    SSKFrameGraphTextureDesc desc = {
+        (uint32_t)width, (uint32_t)height, (uint32_t)pixelFormat, (uint32_t)usage,
+        SSKMetalFrameGraphBytesPerPixel(pixelFormat),
+    };
+    SSKFrameGraphResource resource = SSKFrameGraphCreate(&_graph, NULL, &desc);
+    if (resource != SSKFrameGraphInvalid) {
+        [self.importedTextures addObject:[NSNull null]];
+    }
+    return resource;
+}
+
+- (SSKFrameGraphResource)createTextureLike:(SSKFrameGraphResource)resource name:(NSString *)name {
+    if (resource >= _graph.resourceCount) {
+        return SSKFrameGraphInvalid;
+    }
+    SSKFrameGraphTextureDesc desc = _graph.resources[resource].desc;
+    return [self createTextureWithWidth:desc.width
+                                 height:desc.height
+                            pixelFormat:(MTLPixelFormat)desc.format
+                                  usage:MTLTextureUsageShaderRead | MTLTextureUsageShaderWrite
+                                   name:name];
+}
+
+- (NSUInteger)widthOfResource:(SSKFrameGraphResource)resource {
+    return resource < _graph.resourceCount ? _graph.resources[resource].desc.width : 0;
+}
+
+- (NSUInteger)heightOfResource:(SSKFrameGraphResource)resource {
+    return resource < _graph.resourceCount ? _graph.resources[resource].desc.height : 0;
+}
+
+- (MTLPixelFormat)pixelFormatOfResource:(SSKFrameGraphResource)resource {
+    return resource < _graph.resourceCount ? (MTLPixelFormat)_graph.resources[resource].desc.format : MTLPixelFormatInvalid;
+}
+
+- (BOOL)addComputePassNamed:(NSString *)name
+                      reads:(NSArray<NSNumber *> *)reads
+                     writes:(NSArray<NSNumber *> *)writes
+                      block:(SSKMetalFrameGraphComputeBlock)block {
+    return [self addPassNamed:name kind:SSKFrameGraphPassCompute flags:SSKFrameGraphPassFlagNone reads:reads writes:writes block:block];
+}
+
+- (BOOL)addEncoderPassNamed:(NSString *)name
+                      reads:(NSArray<NSNumber *> *)reads
+                     writes:(NSArray<NSNumber *> *)writes
+                 sideEffect:(BOOL)sideEffect
+                      block:(SSKMetalFrameGraphEncoderBlock)block {
+    uint32_t flags = sideEffect ? SSKFrameGraphPassFlagSideEffect : SSKFrameGraphPassFlagNone;
+    return [self addPassNamed:name kind:SSKFrameGraphPassEncoder flags:flags reads:reads writes:writes block:block];
+}
+
+- (nullable id<MTLTexture>)textureForResource:(SSKFrameGraphResource)resource {
+    if (resource >= _graph.resourceCount) {
+        return nil;
+    }
+    const SSKFrameGraphResourceInfo *info = &_graph.resources[resource];
+    if (info->imported) {
+        return self.importedTextures[resource];
+    }
+    if (info->physical >= self.physicalTextures.count) {
+        return nil;
+    }
+    return self.physicalTextures[info->physical];
+}
+
+- (BOOL)executeWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                    textureCache:(SSKMetalTextureCache *)textureCache {
+    self.livePassCount = 0;
+    self.encoderCount = 0;
+    if (!commandBuffer || !textureCache) {
+        [self releaseBlocks];
+        return NO;
+    }
+    SSKFrameGraphStatus status = SSKFrameGraphCompile(&_graph);
+    if (status != SSKFrameGraphOK) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalFrameGraph: compile failed (%@).",
+                                status == SSKFrameGraphErrorReadBeforeWrite ? @"a pass reads a texture nothing wrote" : @"out of memory"];
+        }
+        [self releaseBlocks];
+        return NO;
+    }
+    self.transientBytes = _graph.transientBytes;
+    self.physicalBytes = _graph.physicalBytes;
+
+    if (![self acquirePhysicalTexturesFromCache:textureCache]) {
+        [self releaseBlocks];
+        return NO;
+    }
+
+    BOOL success = YES;
+    id<MTLComputeCommandEncoder> encoder = nil;
+    uint32_t encoderBatch = SSKFrameGraphInvalid;
+    for (uint32_t k = 0; k < _graph.orderCount; k++) {
+        uint32_t index = _graph.order[k];
+        const SSKFrameGraphPass *pass = &_graph.passes[index];
+        if (pass->kind == SSKFrameGraphPassCompute) {
+            if (!encoder || pass->batch != encoderBatch) {
+                [encoder endEncoding];
+                encoder = [commandBuffer computeCommandEncoder];
+                encoderBatch = pass->batch;
+                if (!encoder) {
+                    success = NO;
+                    break;
+                }
+                self.encoderCount += 1;
+            } else if (pass->barrier) {
+                [self encodeBarrierForPass:pass encoder:encoder];
+            }
+            SSKMetalFrameGraphComputeBlock block = self.passBlocks[index];
+            block(self, encoder);
+        } else {
+            [encoder endEncoding];
+            encoder = nil;
+            SSKMetalFrameGraphEncoderBlock block = self.passBlocks[index];
+            if (!block(self, commandBuffer)) {
+                success = NO;
+                if ([SSKDiagnostics isEnabled]) {
+                    [SSKDiagnostics log:@"SSKMetalFrameGraph: pass '%@' failed to encode.", self.passNames[index]];
+                }
+            }
+            self.encoderCount += 1;
+        }
+        self.livePassCount += 1;
+    }
+    [encoder endEncoding];
+
+    for (id<MTLTexture> texture in self.physicalTextures) {
+        [textureCache releaseTexture:texture];
+    }
+    [self.physicalTextures removeAllObjects];
+    [self releaseBlocks];
+    return success;
+}
+
+#pragma mark - Helpers
+
+- (BOOL)addPassNamed:(NSString *)name
+                kind:(SSKFrameGraphPassKind)kind
+               flags:(uint32_t)flags
+               reads:(NSArray<NSNumber *> *)reads
+              writes:(NSArray<NSNumber *> *)writes
+               block:(id)block {
+    if (!block || reads.count > SSKFrameGraphMaxPassResources || writes.count > SSKFrameGraphMaxPassResources) {
+        return NO;
+    }
+    SSKFrameGraphResource readList[SSKFrameGraphMaxPassResources];
+    SSKFrameGraphResource writeList[SSKFrameGraphMaxPassResources];
+    for (NSUInteger i = 0; i < reads.count; i++) {
+        readList[i] = reads[i].unsignedIntValue;
+    }
+    for (NSUInteger i = 0; i < writes.count; i++) {
+        writeList[i] = writes[i].unsignedIntValue;
+    }
+    uint32_t index = SSKFrameGraphAddPass(&_graph, NULL, kind, flags, readList, (uint32_t)reads.count, writeList,
+                                          (uint32_t)writes.count, NULL);
+    if (index == SSKFrameGraphInvalid) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalFrameGraph: rejected pass '%@'.", name];
+        }
+        return NO;
+    }
+    [self.passNames addObject:name ?: @""];
+    [self.passBlocks addObject:[block copy]];
+    return YES;
+}
+
+- (BOOL)acquirePhysicalTexturesFromCache:(SSKMetalTextureCache *)textureCache {
+    [self.physicalTextures removeAllObjects];
+    for (uint32_t p = 0; p < _graph.physicalCount; p++) {
+        const SSKFrameGraphTextureDesc *desc = &_graph.physical[p];
+        id<MTLTexture> texture = [textureCache acquireTextureWithSize:CGSizeMake(desc->width, desc->height)
+                                                          pixelFormat:(MTLPixelFormat)desc->format
+                                                                usage:(MTLTextureUsage)desc->usage];
+        if (!texture) {
+            if ([SSKDiagnostics isEnabled]) {
+                [SSKDiagnostics log:@"SSKMetalFrameGraph: failed to acquire a %ux%u transient texture.", desc->width, desc->height];
+            }
+            for (id<MTLTexture> acquired in self.physicalTextures) {
+                [textureCache releaseTexture:acquired];
+            }
+            [self.physicalTextures removeAllObjects];
+            return NO;
+        }
+        [self.physicalTextures addObject:texture];
+    }
+    return YES;
+}
+
+- (void)encodeBarrierForPass:(const SSKFrameGraphPass *)pass encoder:(id<MTLComputeCommandEncoder>)encoder {
+    if (![encoder respondsToSelector:@selector(memoryBarrierWithResources:count:)]) {
+        [encoder memoryBarrierWithScope:MTLBarrierScopeTextures];
+        return;
+    }
+    id<MTLResource> textures[2 * SSKFrameGraphMaxPassResources];
+    NSUInteger count = 0;
+    for (uint32_t i = 0; i < pass->readCount + pass->writeCount; i++) {
+        SSKFrameGraphResource resource = i < pass->readCount ? pass->reads[i] : pass->writes[i - pass->readCount];
+        id<MTLTexture> texture = [self textureForResource:resource];
+        if (texture) {
+            textures[count++] = texture;
+        }
+    }
+    [encoder memoryBarrierWithResources:textures count:count];
+}
+
+/// Blocks capture their encoders' state (and often the renderer), so they do
+/// not outlive the frame.
+- (void)releaseBlocks {
+    [self.passBlocks removeAllObjects];
+    [self.passNames removeAllObjects];
+}
+
+@end
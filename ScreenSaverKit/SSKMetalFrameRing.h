@@ -0,0 +1,48 @@
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+#import "Core/SSKFrameRing.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Metal backing for `SSKFrameRing`: every arena is a shared-storage
+/// `MTLBuffer`, and allocation handles are retained `id<MTLBuffer>`s.
+
+NS_INLINE void *_Nullable SSKMetalFrameRingCreateBuffer(void *context, size_t length, void *_Nullable *_Nonnull outHandle) {
+    id<MTLDevice> device = (__bridge id<MTLDevice>)context;
+    id<MTLBuffer> buffer = [device newBufferWithLength:length options:MTLResourceStorageModeShared];
+    if (!buffer) { return NULL; }
+    *outHandle = (__bridge_retained void *)buffer;
+    return buffer.contents;
+}
+
+NS_INLINE void SSKMetalFrameRingDestroyBuffer(__unused void *context, void *handle) {
+    id<MTLBuffer> buffer = (__bridge_transfer id<MTLBuffer>)handle;
+    (void)buffer;
+}
+
+/// Creates a ring whose buffers come from `device`. The device is not retained;
+/// the owner keeps it alive for the lifetime of the ring.
+NS_INLINE SSKFrameRing *_Nullable SSKMetalFrameRingCreate(id<MTLDevice> device, NSUInteger frameCount, NSUInteger initialArenaLength) {
+    SSKFrameRingDevice ringDevice = {
+        .context = (__bridge void *)device,
+        .createBuffer = SSKMetalFrameRingCreateBuffer,
+        .destroyBuffer = SSKMetalFrameRingDestroyBuffer,
+    };
+    return SSKFrameRingCreate(&ringDevice, (uint32_t)MIN(frameCount, (NSUInteger)UINT32_MAX), initialArenaLength);
+}
+
+NS_INLINE id<MTLBuffer> SSKMetalFrameAllocationBuffer(SSKFrameAllocation allocation) {
+    return (__bridge id<MTLBuffer>)allocation.handle;
+}
+
+/// Retires `frame` when `commandBuffer` completes. The command buffer must be
+/// committed even if nothing ends up encoded into it, otherwise the frame
+/// never retires and the ring eventually stalls.
+NS_INLINE void SSKMetalFrameRingRetireOnCompletion(SSKFrameRing *ring, uint64_t frame, id<MTLCommandBuffer> commandBuffer) {
+    [commandBuffer addCompletedHandler:^(__unused id<MTLCommandBuffer> buffer) {
+        SSKFrameRingRetire(ring, frame);
+    }];
+}
+
+NS_ASSUME_NONNULL_END
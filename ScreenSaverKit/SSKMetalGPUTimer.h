@@ -0,0 +1,44 @@
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+#import "Core/SSKProfiler.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class SSKMetalRenderDiagnostics;
+
+/// Measures a frame's command buffer on the GPU and records the results into
+/// a diagnostics object's profiler, on the GPU clock and converted to the
+/// `SSKProfilerNow` timeline.
+///
+/// Every frame records `frame`, the command buffer's time on the GPU.
+/// Where the device samples timestamps at stage boundaries (macOS 11), the
+/// stages bracketed with `beginStage:commandBuffer:` and
+/// `endStageWithCommandBuffer:` are timed as well. Each boundary encodes an
+/// empty blit pass that samples the GPU clock as it starts, so only profiled
+/// frames pay for them. Results arrive a frame or two late, from the command
+/// buffer's completion handler.
+@interface SSKMetalGPUTimer : NSObject
+
+- (instancetype)initWithDevice:(id<MTLDevice>)device
+                   diagnostics:(SSKMetalRenderDiagnostics *)diagnostics NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, strong, readonly) SSKMetalRenderDiagnostics *diagnostics;
+
+/// Whether stages are timed, or only whole command buffers.
+@property (nonatomic, readonly) BOOL supportsStageTimestamps;
+
+- (void)beginFrameWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer;
+
+/// Brackets the GPU work encoded into `commandBuffer` until the matching
+/// `endStageWithCommandBuffer:`. Stages nest.
+- (void)beginStage:(uint32_t)phase commandBuffer:(id<MTLCommandBuffer>)commandBuffer;
+- (void)endStageWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer;
+
+/// Call before the command buffer is committed.
+- (void)endFrameWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer;
+
+@end
+
+NS_ASSUME_NONNULL_END
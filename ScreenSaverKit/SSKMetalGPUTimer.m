@@ -0,0 +1,247 @@
+#import "SSKMetalGPUTimer.h"
+
+#import <stdatomic.h>
+
+#import "SSKDiagnostics.h"
+#import "SSKMetalRenderDiagnostics.h"
+
+enum {
+    /// Frames whose samples can be in flight at once.
+    SSKMetalGPUTimerFrameCount = 4,
+    SSKMetalGPUTimerMaxStages = 32,
+    SSKMetalGPUTimerSamplesPerFrame = SSKMetalGPUTimerMaxStages * 2,
+};
+
+static const uint32_t kSSKMetalGPUTimerNoSample = UINT32_MAX;
+
+typedef struct {
+    uint32_t phase;
+    uint32_t beginSample;
+    uint32_t endSample;
+} SSKMetalGPUTimerStage;
+
+/// One frame's stages. Written by the encoding thread while the frame is
+/// built, read by the completion handler; `busy` hands it over.
+typedef struct {
+    SSKMetalGPUTimerStage stages[SSKMetalGPUTimerMaxStages];
+    uint32_t stageCount;
+    uint32_t sampleCount;
+    MTLTimestamp cpuStart;
+    MTLTimestamp gpuStart;
+    atomic_bool busy;
+} SSKMetalGPUTimerFrame;
+
+@interface SSKMetalGPUTimer () {
+    SSKMetalGPUTimerFrame _frames[SSKMetalGPUTimerFrameCount];
+    uint32_t _openStages[SSKMetalGPUTimerMaxStages];
+    uint32_t _openStageCount;
+    NSUInteger _frameIndex;
+    BOOL _frameTimesStages;
+    /// `id<MTLCounterSampleBuffer>`, typed loosely so the ivar needs no
+    /// availability annotation.
+    id _sampleBuffer;
+}
+@property (nonatomic, strong) id<MTLDevice> device;
+@property (nonatomic, strong, readwrite) SSKMetalRenderDiagnostics *diagnostics;
+@end
+
+@implementation SSKMetalGPUTimer
+
+- (instancetype)initWithDevice:(id<MTLDevice>)device diagnostics:(SSKMetalRenderDiagnostics *)diagnostics {
+    NSParameterAssert(device);
+    NSParameterAssert(diagnostics);
+    if ((self = [super init])) {
+        _device = device;
+        _diagnostics = diagnostics;
+        for (NSUInteger i = 0; i < SSKMetalGPUTimerFrameCount; i++) {
+            atomic_init(&_frames[i].busy, false);
+        }
+        if (@available(macOS 11.0, *)) {
+            _sampleBuffer = [self newTimestampSampleBuffer];
+        }
+    }
+    return self;
+}
+
+- (id<MTLCounterSampleBuffer>)newTimestampSampleBuffer API_AVAILABLE(macos(11.0)) {
+    if (![self.device supportsCounterSampling:MTLCounterSamplingPointAtStageBoundary]) {
+        return nil;
+    }
+    id<MTLCounterSet> timestampSet = nil;
+    for (id<MTLCounterSet> counterSet in self.device.counterSets) {
+        if ([counterSet.name isEqualToString:MTLCommonCounterSetTimestamp]) {
+            timestampSet = counterSet;
+            break;
+        }
+    }
+    if (!timestampSet) {
+        return nil;
+    }
+    MTLCounterSampleBufferDescriptor *descriptor = [[MTLCounterSampleBufferDescriptor alloc] init];
+    descriptor.counterSet = timestampSet;
+    descriptor.storageMode = MTLStorageModeShared;
+    descriptor.sampleCount = SSKMetalGPUTimerFrameCount * SSKMetalGPUTimerSamplesPerFrame;
+    descriptor.label = @"SSKMetalGPUTimer";
+    NSError *error = nil;
+    id<MTLCounterSampleBuffer> sampleBuffer = [self.device newCounterSampleBufferWithDescriptor:descriptor
+                                                                                         error:&error];
+    if (!sampleBuffer && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalGPUTimer: timestamp sample buffer unavailable (%@); timing whole frames only.",
+         error.localizedDescription ?: @"unknown error"];
+    }
+    return sampleBuffer;
+}
+
+- (BOOL)supportsStageTimestamps {
+    return _sampleBuffer != nil;
+}
+
+- (void)beginFrameWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    (void)commandBuffer;
+    _frameIndex = (_frameIndex + 1) % SSKMetalGPUTimerFrameCount;
+    _openStageCount = 0;
+    SSKMetalGPUTimerFrame *frame = &_frames[_frameIndex];
+    // A frame whose slot is still waiting on the GPU goes untimed rather than
+    // overwrite samples that have not been read.
+    _frameTimesStages = _sampleBuffer && !atomic_load_explicit(&frame->busy, memory_order_acquire);
+    if (!_frameTimesStages) {
+        return;
+    }
+    frame->stageCount = 0;
+    frame->sampleCount = 0;
+    if (@available(macOS 11.0, *)) {
+        [self.device sampleTimestamps:&frame->cpuStart gpuTimestamp:&frame->gpuStart];
+    }
+}
+
+- (uint32_t)encodeMarkerIntoCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    SSKMetalGPUTimerFrame *frame = &_frames[_frameIndex];
+    if (frame->sampleCount >= SSKMetalGPUTimerSamplesPerFrame) {
+        return kSSKMetalGPUTimerNoSample;
+    }
+    uint32_t sample = (uint32_t)(_frameIndex * SSKMetalGPUTimerSamplesPerFrame) + frame->sampleCount;
+    if (@available(macOS 11.0, *)) {
+        MTLBlitPassDescriptor *descriptor = [MTLBlitPassDescriptor blitPassDescriptor];
+        descriptor.sampleBufferAttachments[0].sampleBuffer = _sampleBuffer;
+        descriptor.sampleBufferAttachments[0].startOfEncoderSampleIndex = sample;
+        descriptor.sampleBufferAttachments[0].endOfEncoderSampleIndex = MTLCounterDontSample;
+        id<MTLBlitCommandEncoder> encoder = [commandBuffer blitCommandEncoderWithDescriptor:descriptor];
+        if (!encoder) {
+            return kSSKMetalGPUTimerNoSample;
+        }
+        [encoder endEncoding];
+        frame->sampleCount++;
+        return sample;
+    }
+    return kSSKMetalGPUTimerNoSample;
+}
+
+- (void)beginStage:(uint32_t)phase commandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    if (_openStageCount >= SSKMetalGPUTimerMaxStages) {
+        return;
+    }
+    // Untimed stages still take a place on the stack so ends stay paired.
+    uint32_t stageIndex = kSSKMetalGPUTimerNoSample;
+    SSKMetalGPUTimerFrame *frame = &_frames[_frameIndex];
+    if (_frameTimesStages && commandBuffer && frame->stageCount < SSKMetalGPUTimerMaxStages) {
+        uint32_t sample = [self encodeMarkerIntoCommandBuffer:commandBuffer];
+        if (sample != kSSKMetalGPUTimerNoSample) {
+            stageIndex = frame->stageCount++;
+            frame->stages[stageIndex] = (SSKMetalGPUTimerStage){phase, sample, kSSKMetalGPUTimerNoSample};
+        }
+    }
+    _openStages[_openStageCount++] = stageIndex;
+}
+
+- (void)endStageWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    if (_openStageCount == 0) {
+        return;
+    }
+    uint32_t stageIndex = _openStages[--_openStageCount];
+    if (stageIndex == kSSKMetalGPUTimerNoSample || !commandBuffer) {
+        return;
+    }
+    _frames[_frameIndex].stages[stageIndex].endSample = [self encodeMarkerIntoCommandBuffer:commandBuffer];
+}
+
+- (void)endFrameWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    if (!commandBuffer) {
+        return;
+    }
+    NSUInteger frameIndex = _frameIndex;
+    BOOL timesStages = _frameTimesStages && _frames[frameIndex].stageCount > 0;
+    if (timesStages) {
+        atomic_store_explicit(&_frames[frameIndex].busy, true, memory_order_release);
+    }
+    _frameTimesStages = NO;
+    _openStageCount = 0;
+    // The handler keeps the timer, and through it the profiler, alive until
+    // the frame has been read back.
+    [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+        [self recordCompletedCommandBuffer:buffer frameIndex:frameIndex timesStages:timesStages];
+    }];
+}
+
+- (void)recordCompletedCommandBuffer:(id<MTLCommandBuffer>)buffer
+                          frameIndex:(NSUInteger)frameIndex
+                         timesStages:(BOOL)timesStages {
+    SSKProfiler *profiler = self.diagnostics.profiler;
+    if (buffer.status == MTLCommandBufferStatusCompleted) {
+        if (@available(macOS 10.15, *)) {
+            // Host times in seconds, on the clock `SSKProfilerNow` reads.
+            CFTimeInterval start = buffer.GPUStartTime;
+            CFTimeInterval end = buffer.GPUEndTime;
+            if (start > 0.0 && end > start) {
+                static uint32_t framePhase;
+                SSKProfilerRecord(profiler, SSKProfilerPhaseCached(&framePhase, "frame"), SSKProfilerClockGPU,
+                                  (uint64_t)(start * 1.0e9), (uint64_t)(end * 1.0e9));
+            }
+        }
+        if (timesStages) {
+            if (@available(macOS 11.0, *)) {
+                [self recordStagesOfFrame:&_frames[frameIndex] frameIndex:frameIndex profiler:profiler];
+            }
+        }
+    }
+    if (timesStages) {
+        atomic_store_explicit(&_frames[frameIndex].busy, false, memory_order_release);
+    }
+}
+
+- (void)recordStagesOfFrame:(SSKMetalGPUTimerFrame *)frame
+                 frameIndex:(NSUInteger)frameIndex
+                   profiler:(SSKProfiler *)profiler API_AVAILABLE(macos(11.0)) {
+    id<MTLCounterSampleBuffer> sampleBuffer = _sampleBuffer;
+    NSUInteger firstSample = frameIndex * SSKMetalGPUTimerSamplesPerFrame;
+    NSData *resolved = [sampleBuffer resolveCounterRange:NSMakeRange(firstSample, frame->sampleCount)];
+    if (resolved.length < frame->sampleCount * sizeof(MTLCounterResultTimestamp)) {
+        return;
+    }
+    const MTLCounterResultTimestamp *timestamps = resolved.bytes;
+
+    // GPU ticks map onto CPU nanoseconds through the pairs sampled when the
+    // frame began and now; the GPU clock need not tick in nanoseconds.
+    MTLTimestamp cpuEnd = 0;
+    MTLTimestamp gpuEnd = 0;
+    [self.device sampleTimestamps:&cpuEnd gpuTimestamp:&gpuEnd];
+    double scale = gpuEnd > frame->gpuStart && cpuEnd > frame->cpuStart ?
+        (double)(cpuEnd - frame->cpuStart) / (double)(gpuEnd - frame->gpuStart) : 1.0;
+
+    for (uint32_t i = 0; i < frame->stageCount; i++) {
+        const SSKMetalGPUTimerStage *stage = &frame->stages[i];
+        if (stage->endSample == kSSKMetalGPUTimerNoSample) {
+            continue;
+        }
+        MTLTimestamp begin = timestamps[stage->beginSample - firstSample].timestamp;
+        MTLTimestamp end = timestamps[stage->endSample - firstSample].timestamp;
+        if (begin == MTLCounterErrorValue || end == MTLCounterErrorValue || end < begin) {
+            continue;
+        }
+        double offset = ((double)begin - (double)frame->gpuStart) * scale;
+        uint64_t start = (uint64_t)MAX(0.0, (double)frame->cpuStart + offset);
+        uint64_t duration = (uint64_t)((double)(end - begin) * scale);
+        SSKProfilerRecord(profiler, stage->phase, SSKProfilerClockGPU, start, start + duration);
+    }
+}
+
+@end
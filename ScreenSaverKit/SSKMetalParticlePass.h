@@ -1,14 +1,24 @@
 #import "SSKMetalPass.h"
 
 #import "SSKParticleSystem.h"
+#import "Core/SSKParticleInstances.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Fills `instances` with up to `maxCount` entries and returns how many it wrote.
+typedef NSUInteger (^SSKMetalInstanceWriter)(SSKParticleInstance *instances, NSUInteger maxCount);
+
 /// Render pass responsible for drawing particle instances using Metal.
 @interface SSKMetalParticlePass : SSKMetalPass
 
 - (BOOL)setupWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library;
 
+/// How many command buffers may hold instance data at once (default 3).
+/// Instances are written into a persistently mapped ring, one region per
+/// command buffer; encoding blocks once this many are still on the GPU.
+/// Changing it waits for the GPU to drain before the ring is rebuilt.
+@property (nonatomic) NSUInteger maxFramesInFlight;
+
 - (BOOL)encodeParticles:(NSArray<SSKParticle *> *)particles
               blendMode:(SSKParticleBlendMode)blendMode
            viewportSize:(CGSize)viewportSize
@@ -17,6 +27,28 @@ NS_ASSUME_NONNULL_BEGIN
              loadAction:(MTLLoadAction)loadAction
              clearColor:(MTLClearColor)clearColor;
 
+/// Same as `encodeParticles:...` but fills the instance buffer directly from
+/// the system's particle streams, with no intermediate `SSKParticle` objects.
+- (BOOL)encodeParticleSystem:(SSKParticleSystem *)system
+                   blendMode:(SSKParticleBlendMode)blendMode
+                viewportSize:(CGSize)viewportSize
+               commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                renderTarget:(id<MTLTexture>)renderTarget
+                  loadAction:(MTLLoadAction)loadAction
+                  clearColor:(MTLClearColor)clearColor;
+
+/// Reserves room for `maxCount` instances in the pass's instance buffer and
+/// lets `writer` fill it in place, for callers that keep their own instance
+/// streams. Only the entries `writer` reports are drawn.
+- (BOOL)encodeInstanceCount:(NSUInteger)maxCount
+                     writer:(SSKMetalInstanceWriter)writer
+                  blendMode:(SSKParticleBlendMode)blendMode
+               viewportSize:(CGSize)viewportSize
+              commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+               renderTarget:(id<MTLTexture>)renderTarget
+                 loadAction:(MTLLoadAction)loadAction
+                 clearColor:(MTLClearColor)clearColor;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -5,29 +5,61 @@
 #import <AppKit/AppKit.h>
 
 #import "SSKDiagnostics.h"
+#import "SSKMetalFrameRing.h"
+#import "Core/SSKParticleInstances.h"
+
+/// Room for 4096 instances per frame before an arena has to grow.
+static const NSUInteger kSSKParticlePassInitialArenaLength = 4096 * sizeof(SSKParticleInstance);
+/// Instances are read from the constant address space, which needs 256-byte
+/// aligned buffer offsets on some Macs.
+static const size_t kSSKParticlePassInstanceAlignment = 256;
 
 typedef struct {
     vector_float2 position;
     vector_float2 direction;
     float width;
     float length;
+    float reserved[2];
     vector_float4 color;
     float softness;
     float padding[3];
 } SSKMetalInstanceData;
 
+_Static_assert(sizeof(SSKMetalInstanceData) == sizeof(SSKParticleInstance),
+               "SSKParticleSystem writes instances in the same layout");
+_Static_assert(offsetof(SSKMetalInstanceData, position) == offsetof(SSKParticleInstance, position) &&
+               offsetof(SSKMetalInstanceData, direction) == offsetof(SSKParticleInstance, direction) &&
+               offsetof(SSKMetalInstanceData, width) == offsetof(SSKParticleInstance, width) &&
+               offsetof(SSKMetalInstanceData, length) == offsetof(SSKParticleInstance, length) &&
+               offsetof(SSKMetalInstanceData, color) == offsetof(SSKParticleInstance, color) &&
+               offsetof(SSKMetalInstanceData, softness) == offsetof(SSKParticleInstance, softness),
+               "SSKMetalInstanceData fields must sit where InstanceData expects them");
+
 @interface SSKMetalParticlePass ()
 @property (nonatomic, strong) id<MTLDevice> device;
 @property (nonatomic, strong) id<MTLLibrary> library;
 @property (nonatomic, strong) id<MTLRenderPipelineState> alphaPipeline;
 @property (nonatomic, strong) id<MTLRenderPipelineState> additivePipeline;
 @property (nonatomic, strong) id<MTLBuffer> quadVertexBuffer;
-@property (nonatomic, strong) id<MTLBuffer> instanceBuffer;
-@property (nonatomic) NSUInteger instanceCapacity;
+@property (nonatomic, assign) SSKFrameRing *frameRing;
+/// Command buffer the open ring frame retires with, if any.
+@property (nonatomic, weak) id<MTLCommandBuffer> frameCommandBuffer;
 @end
 
 @implementation SSKMetalParticlePass
 
+- (instancetype)init {
+    if ((self = [super init])) {
+        _maxFramesInFlight = SSKFrameRingDefaultFrameCount;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    SSKFrameRingEndFrame(_frameRing);
+    SSKFrameRingDestroy(_frameRing);
+}
+
 - (BOOL)setupWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library {
     NSParameterAssert(device);
     NSParameterAssert(library);
@@ -36,7 +68,16 @@ typedef struct {
     }
     self.device = device;
     self.library = library;
-    return [self buildQuadBuffer] && [self buildRenderPipelines];
+    return [self buildQuadBuffer] && [self buildFrameRing] && [self buildRenderPipelines];
+}
+
+- (void)setMaxFramesInFlight:(NSUInteger)maxFramesInFlight {
+    maxFramesInFlight = MAX(maxFramesInFlight, (NSUInteger)1);
+    if (_maxFramesInFlight == maxFramesInFlight) { return; }
+    _maxFramesInFlight = maxFramesInFlight;
+    if (_frameRing) {
+        [self buildFrameRing];
+    }
 }
 
 - (BOOL)encodeParticles:(NSArray<SSKParticle *> *)particles
@@ -50,7 +91,176 @@ typedef struct {
         return NO;
     }
 
-    if (particles.count == 0) {
+    NSUInteger count = 0;
+    SSKFrameAllocation allocation = {0};
+    if (particles.count > 0) {
+        if (![self allocateInstanceCount:particles.count commandBuffer:commandBuffer allocation:&allocation]) {
+            return NO;
+        }
+
+        SSKMetalInstanceData *instances = allocation.contents;
+        for (SSKParticle *particle in particles) {
+            SSKMetalInstanceData data = {0};
+            data.position = (vector_float2){(float)particle.position.x, (float)particle.position.y};
+            vector_float2 dir = (vector_float2){(float)particle.userVector.x, (float)particle.userVector.y};
+            float len = simd_length(dir);
+            if (len < 0.0001f) {
+                dir = (vector_float2){1.0f, 0.0f};
+            } else {
+                dir /= len;
+            }
+            data.direction = dir;
+            float width = MAX(1.0f, (float)particle.size);
+            data.width = width;
+            data.length = width * 12.0f;
+
+            data.color = [particle metalColorVector];
+            float softness = (float)particle.userScalar;
+            if (!isfinite(softness) || softness < 0.0f) {
+                softness = 0.0f;
+            }
+            data.softness = softness;
+            instances[count++] = data;
+        }
+    }
+
+    return [self encodeInstances:allocation
+                           count:count
+                       blendMode:blendMode
+                    viewportSize:viewportSize
+                   commandBuffer:commandBuffer
+                    renderTarget:renderTarget
+                      loadAction:loadAction
+                      clearColor:clearColor];
+}
+
+- (BOOL)encodeParticleSystem:(SSKParticleSystem *)system
+                   blendMode:(SSKParticleBlendMode)blendMode
+                viewportSize:(CGSize)viewportSize
+               commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                renderTarget:(id<MTLTexture>)renderTarget
+                  loadAction:(MTLLoadAction)loadAction
+                  clearColor:(MTLClearColor)clearColor {
+    if (!commandBuffer || !renderTarget || !system) {
+        return NO;
+    }
+
+    // Resident particles are drawn straight from the simulation's buffers with
+    // the instance count the GPU wrote, so nothing is copied or read back.
+    id<MTLBuffer> instanceBuffer = nil;
+    id<MTLBuffer> argumentsBuffer = nil;
+    NSUInteger argumentsOffset = 0;
+    if ([system beginResidentDrawWithCommandBuffer:commandBuffer
+                                    instanceBuffer:&instanceBuffer
+                                   argumentsBuffer:&argumentsBuffer
+                                   argumentsOffset:&argumentsOffset]) {
+        BOOL encoded = [self encodeInstanceBuffer:instanceBuffer
+                                           offset:0
+                                            count:0
+                                  argumentsBuffer:argumentsBuffer
+                                  argumentsOffset:argumentsOffset
+                                        blendMode:blendMode
+                                     viewportSize:viewportSize
+                                    commandBuffer:commandBuffer
+                                     renderTarget:renderTarget
+                                       loadAction:loadAction
+                                       clearColor:clearColor];
+        [system endResidentDrawWithCommandBuffer:commandBuffer];
+        return encoded;
+    }
+
+    NSUInteger count = 0;
+    SSKFrameAllocation allocation = {0};
+    NSUInteger aliveCount = system.aliveParticleCount;
+    if (aliveCount > 0) {
+        if (![self allocateInstanceCount:aliveCount commandBuffer:commandBuffer allocation:&allocation]) {
+            return NO;
+        }
+        count = [system writeInstances:allocation.contents maxCount:aliveCount];
+    }
+
+    return [self encodeInstances:allocation
+                           count:count
+                       blendMode:blendMode
+                    viewportSize:viewportSize
+                   commandBuffer:commandBuffer
+                    renderTarget:renderTarget
+                      loadAction:loadAction
+                      clearColor:clearColor];
+}
+
+- (BOOL)encodeInstanceCount:(NSUInteger)maxCount
+                     writer:(SSKMetalInstanceWriter)writer
+                  blendMode:(SSKParticleBlendMode)blendMode
+               viewportSize:(CGSize)viewportSize
+              commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+               renderTarget:(id<MTLTexture>)renderTarget
+                 loadAction:(MTLLoadAction)loadAction
+                 clearColor:(MTLClearColor)clearColor {
+    if (!commandBuffer || !renderTarget || !writer) {
+        return NO;
+    }
+
+    NSUInteger count = 0;
+    SSKFrameAllocation allocation = {0};
+    if (maxCount > 0) {
+        if (![self allocateInstanceCount:maxCount commandBuffer:commandBuffer allocation:&allocation]) {
+            return NO;
+        }
+        count = MIN(writer((SSKParticleInstance *)allocation.contents, maxCount), maxCount);
+    }
+
+    return [self encodeInstances:allocation
+                           count:count
+                       blendMode:blendMode
+                    viewportSize:viewportSize
+                   commandBuffer:commandBuffer
+                    renderTarget:renderTarget
+                      loadAction:loadAction
+                      clearColor:clearColor];
+}
+
+#pragma mark - Private helpers
+
+/// Reserves room for `count` instances in the ring frame tied to
+/// `commandBuffer`. The first allocation for a command buffer closes the
+/// previous frame and opens a new one, blocking while `maxFramesInFlight`
+/// earlier command buffers are still on the GPU; later allocations for the
+/// same command buffer share its frame.
+- (BOOL)allocateInstanceCount:(NSUInteger)count
+                commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                   allocation:(SSKFrameAllocation *)allocation {
+    if (!self.frameRing) {
+        return NO;
+    }
+    if (self.frameCommandBuffer != commandBuffer) {
+        [self endOpenFrame];
+        uint64_t frame = SSKFrameRingBeginFrame(self.frameRing);
+        SSKMetalFrameRingRetireOnCompletion(self.frameRing, frame, commandBuffer);
+        self.frameCommandBuffer = commandBuffer;
+    }
+    return SSKFrameRingAllocate(self.frameRing,
+                                count * sizeof(SSKMetalInstanceData),
+                                kSSKParticlePassInstanceAlignment,
+                                allocation);
+}
+
+- (void)endOpenFrame {
+    SSKFrameRingEndFrame(self.frameRing);
+    self.frameCommandBuffer = nil;
+}
+
+/// Draws the first `count` instances of `allocation`. With no instances only
+/// the clear (if requested) is encoded.
+- (BOOL)encodeInstances:(SSKFrameAllocation)allocation
+                  count:(NSUInteger)count
+              blendMode:(SSKParticleBlendMode)blendMode
+           viewportSize:(CGSize)viewportSize
+          commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+           renderTarget:(id<MTLTexture>)renderTarget
+             loadAction:(MTLLoadAction)loadAction
+             clearColor:(MTLClearColor)clearColor {
+    if (count == 0) {
         if (loadAction == MTLLoadActionClear) {
             MTLRenderPassDescriptor *descriptor = [MTLRenderPassDescriptor renderPassDescriptor];
             descriptor.colorAttachments[0].texture = renderTarget;
@@ -62,38 +272,33 @@ typedef struct {
         }
         return YES;
     }
+    return [self encodeInstanceBuffer:SSKMetalFrameAllocationBuffer(allocation)
+                               offset:allocation.offset
+                                count:count
+                      argumentsBuffer:nil
+                      argumentsOffset:0
+                            blendMode:blendMode
+                         viewportSize:viewportSize
+                        commandBuffer:commandBuffer
+                         renderTarget:renderTarget
+                           loadAction:loadAction
+                           clearColor:clearColor];
+}
 
-    [self ensureInstanceCapacity:particles.count];
-    if (!self.instanceBuffer) {
-        return NO;
-    }
-
-    SSKMetalInstanceData *instances = self.instanceBuffer.contents;
-    NSUInteger index = 0;
-    for (SSKParticle *particle in particles) {
-        SSKMetalInstanceData data;
-        data.position = (vector_float2){(float)particle.position.x, (float)particle.position.y};
-        vector_float2 dir = (vector_float2){(float)particle.userVector.x, (float)particle.userVector.y};
-        float len = simd_length(dir);
-        if (len < 0.0001f) {
-            dir = (vector_float2){1.0f, 0.0f};
-        } else {
-            dir /= len;
-        }
-        data.direction = dir;
-        float width = MAX(1.0f, (float)particle.size);
-        data.width = width;
-        data.length = width * 12.0f;
-
-        data.color = [particle metalColorVector];
-        float softness = (float)particle.userScalar;
-        if (!isfinite(softness) || softness < 0.0f) {
-            softness = 0.0f;
-        }
-        data.softness = softness;
-        instances[index++] = data;
-    }
-
+/// Encodes the particle draw over `instanceBuffer`. With an `argumentsBuffer`
+/// the instance count comes from the `MTLDrawPrimitivesIndirectArguments` at
+/// `argumentsOffset` and `count` is ignored.
+- (BOOL)encodeInstanceBuffer:(id<MTLBuffer>)instanceBuffer
+                      offset:(NSUInteger)offset
+                       count:(NSUInteger)count
+             argumentsBuffer:(nullable id<MTLBuffer>)argumentsBuffer
+             argumentsOffset:(NSUInteger)argumentsOffset
+                   blendMode:(SSKParticleBlendMode)blendMode
+                viewportSize:(CGSize)viewportSize
+               commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                renderTarget:(id<MTLTexture>)renderTarget
+                  loadAction:(MTLLoadAction)loadAction
+                  clearColor:(MTLClearColor)clearColor {
     MTLRenderPassDescriptor *descriptor = [MTLRenderPassDescriptor renderPassDescriptor];
     descriptor.colorAttachments[0].texture = renderTarget;
     descriptor.colorAttachments[0].storeAction = MTLStoreActionStore;
@@ -115,17 +320,21 @@ typedef struct {
     [encoder setViewport:viewport];
     [encoder setRenderPipelineState:pipeline];
     [encoder setVertexBuffer:self.quadVertexBuffer offset:0 atIndex:0];
-    [encoder setVertexBuffer:self.instanceBuffer offset:0 atIndex:1];
+    [encoder setVertexBuffer:instanceBuffer offset:offset atIndex:1];
     vector_float2 viewportPoints = {(float)viewportSize.width, (float)viewportSize.height};
     [encoder setVertexBytes:&viewportPoints length:sizeof(vector_float2) atIndex:2];
-    [encoder drawPrimitives:MTLPrimitiveTypeTriangleStrip vertexStart:0 vertexCount:4 instanceCount:index];
+    if (argumentsBuffer) {
+        [encoder drawPrimitives:MTLPrimitiveTypeTriangleStrip
+                 indirectBuffer:argumentsBuffer
+           indirectBufferOffset:argumentsOffset];
+    } else {
+        [encoder drawPrimitives:MTLPrimitiveTypeTriangleStrip vertexStart:0 vertexCount:4 instanceCount:count];
+    }
     [encoder endEncoding];
 
     return YES;
 }
 
-#pragma mark - Private helpers
-
 - (BOOL)buildQuadBuffer {
     static const vector_float2 quadVertices[] = {
         {-0.5f, -0.5f},
@@ -136,13 +345,22 @@ typedef struct {
     self.quadVertexBuffer = [self.device newBufferWithBytes:quadVertices
                                                     length:sizeof(quadVertices)
                                                    options:MTLResourceStorageModeShared];
-    self.instanceCapacity = 0;
     if (!self.quadVertexBuffer && [SSKDiagnostics isEnabled]) {
         [SSKDiagnostics log:@"SSKMetalParticlePass: failed to create quad vertex buffer."];
     }
     return self.quadVertexBuffer != nil;
 }
 
+- (BOOL)buildFrameRing {
+    [self endOpenFrame];
+    SSKFrameRingDestroy(self.frameRing);
+    self.frameRing = SSKMetalFrameRingCreate(self.device, self.maxFramesInFlight, kSSKParticlePassInitialArenaLength);
+    if (!self.frameRing && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalParticlePass: failed to create instance ring."];
+    }
+    return self.frameRing != NULL;
+}
+
 - (BOOL)buildRenderPipelines {
     NSError *error = nil;
     id<MTLFunction> vertexFunc = [self.library newFunctionWithName:@"particleVertex"];
@@ -188,13 +406,4 @@ typedef struct {
     return YES;
 }
 
-- (void)ensureInstanceCapacity:(NSUInteger)count {
-    if (count <= self.instanceCapacity) {
-        return;
-    }
-    NSUInteger newCapacity = MAX(count, MAX((NSUInteger)128, self.instanceCapacity * 2));
-    self.instanceBuffer = [self.device newBufferWithLength:newCapacity * sizeof(SSKMetalInstanceData)
-                                                   options:MTLResourceStorageModeShared];
-    self.instanceCapacity = newCapacity;
-}
 @end
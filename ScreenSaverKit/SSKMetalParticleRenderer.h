@@ -2,10 +2,13 @@
 #import <QuartzCore/CAMetalLayer.h>
 #import <Metal/Metal.h>
 
+#import "SSKMetalBloomPass.h"
 #import "SSKParticleSystem.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class SSKMetalRenderDiagnostics;
+
 /// Lightweight helper that renders `SSKParticleSystem` data using Metal.
 /// Clients supply a CAMetalLayer (typically backing their saver view) and
 /// call `renderParticles:blendMode:viewportSize:` once per frame.
@@ -23,6 +26,12 @@ NS_ASSUME_NONNULL_BEGIN
               blendMode:(SSKParticleBlendMode)blendMode
            viewportSize:(CGSize)viewportSize;
 
+/// Renders every live particle of `system`, generating instances straight from
+/// its particle streams instead of going through `SSKParticle` objects.
+- (BOOL)renderParticleSystem:(SSKParticleSystem *)system
+                   blendMode:(SSKParticleBlendMode)blendMode
+                viewportSize:(CGSize)viewportSize;
+
 /// Clear colour used when filling the drawable (defaults to opaque black).
 @property (nonatomic) MTLClearColor clearColor;
 
@@ -39,6 +48,18 @@ NS_ASSUME_NONNULL_BEGIN
 /// Sigma used by the bloom blur (controls spread). Defaults to 3.0.
 @property (nonatomic) CGFloat bloomBlurSigma;
 
+/// Bloom algorithm. `SSKMetalBloomModeMipChain` spreads the glow over
+/// `bloomMipLevels` half-resolution levels instead of blurring with
+/// `bloomBlurSigma`. Defaults to `SSKMetalBloomModeGaussian`.
+@property (nonatomic) SSKMetalBloomMode bloomMode;
+
+/// Mip chain length (1-8, default 5); each level doubles the glow radius.
+@property (nonatomic) NSUInteger bloomMipLevels;
+
+/// Diagnostics the underlying renderer profiles into; see
+/// `SSKMetalRenderer.diagnostics`.
+@property (nonatomic, strong, nullable) SSKMetalRenderDiagnostics *diagnostics;
+
 @end
 
 NS_ASSUME_NONNULL_END
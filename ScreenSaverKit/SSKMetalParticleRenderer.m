@@ -40,10 +40,17 @@ static void SSKMetalParticleRendererSetLastErrorMessage(NSString *message) {
         _bloomIntensity = 0.0;
         _bloomThreshold = 0.8f;
         _bloomBlurSigma = 3.0f;
+        _bloomMode = SSKMetalBloomModeGaussian;
+        _bloomMipLevels = 5;
         _renderer.clearColor = _clearColor;
         _renderer.particleBlurRadius = _blurRadius;
         _renderer.bloomThreshold = _bloomThreshold;
         _renderer.bloomBlurSigma = _bloomBlurSigma;
+        _renderer.bloomMode = _bloomMode;
+        _renderer.bloomMipLevels = _bloomMipLevels;
+        // Blur and bloom run back to back every frame, so recording them as one
+        // graph lets their passes share an encoder and their scratch textures.
+        _renderer.usesFrameGraph = YES;
     }
     return self;
 }
@@ -77,9 +84,45 @@ static void SSKMetalParticleRendererSetLastErrorMessage(NSString *message) {
     self.renderer.bloomBlurSigma = _bloomBlurSigma;
 }
 
+- (void)setBloomMode:(SSKMetalBloomMode)bloomMode {
+    _bloomMode = bloomMode;
+    self.renderer.bloomMode = bloomMode;
+}
+
+- (void)setBloomMipLevels:(NSUInteger)bloomMipLevels {
+    _bloomMipLevels = MIN(MAX(bloomMipLevels, (NSUInteger)1), (NSUInteger)8);
+    self.renderer.bloomMipLevels = _bloomMipLevels;
+}
+
+- (SSKMetalRenderDiagnostics *)diagnostics {
+    return self.renderer.diagnostics;
+}
+
+- (void)setDiagnostics:(SSKMetalRenderDiagnostics *)diagnostics {
+    self.renderer.diagnostics = diagnostics;
+}
+
 - (BOOL)renderParticles:(NSArray<SSKParticle *> *)particles
               blendMode:(SSKParticleBlendMode)blendMode
            viewportSize:(CGSize)viewportSize {
+    return [self renderWithViewportSize:viewportSize drawing:^{
+        [self.renderer drawParticles:particles ?: @[]
+                           blendMode:blendMode
+                        viewportSize:viewportSize];
+    }];
+}
+
+- (BOOL)renderParticleSystem:(SSKParticleSystem *)system
+                   blendMode:(SSKParticleBlendMode)blendMode
+                viewportSize:(CGSize)viewportSize {
+    return [self renderWithViewportSize:viewportSize drawing:^{
+        [self.renderer drawParticleSystem:system
+                                blendMode:blendMode
+                             viewportSize:viewportSize];
+    }];
+}
+
+- (BOOL)renderWithViewportSize:(CGSize)viewportSize drawing:(void (^)(void))drawing {
     if (!self.renderer || !self.layer) {
         return NO;
     }
@@ -95,14 +138,14 @@ static void SSKMetalParticleRendererSetLastErrorMessage(NSString *message) {
     self.renderer.particleBlurRadius = self.blurRadius;
     self.renderer.bloomThreshold = self.bloomThreshold;
     self.renderer.bloomBlurSigma = self.bloomBlurSigma;
+    self.renderer.bloomMode = self.bloomMode;
+    self.renderer.bloomMipLevels = self.bloomMipLevels;
 
     if (![self.renderer beginFrame]) {
         return NO;
     }
 
-    [self.renderer drawParticles:particles ?: @[]
-                       blendMode:blendMode
-                    viewportSize:viewportSize];
+    drawing();
     if (self.blurRadius > 0.01) {
         [self.renderer applyBlur:self.blurRadius];
     }
@@ -1,6 +1,8 @@
 #import <Foundation/Foundation.h>
 #import <QuartzCore/QuartzCore.h>
 
+#import "Core/SSKProfiler.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 /// Shared helper that tracks Metal rendering statistics and exposes a reusable
@@ -45,6 +47,25 @@ NS_ASSUME_NONNULL_BEGIN
                     extraLines:(nullable NSArray<NSString *> *)extraLines
                framesPerSecond:(double)fps;
 
+/// Frame-phase profiler owned by the receiver. `SSKMetalRenderer` records its
+/// stages here once it is given the receiver as `diagnostics`; savers can add
+/// their own phases with `SSK_PROFILE_SCOPE(diagnostics.profiler, "name")`.
+@property (nonatomic, readonly, nullable) SSKProfiler *profiler NS_RETURNS_INNER_POINTER;
+
+/// Enables recording into `profiler` and adds per-phase p50/p95/p99 lines to
+/// the overlay. Defaults to `NO`.
+@property (nonatomic) BOOL profilingEnabled;
+
+/// Drains the profiler and returns one line per phase with samples: CPU and
+/// GPU percentiles over the last few seconds, in milliseconds. Empty when
+/// profiling is off. The overlay calls this itself; the lines are refreshed
+/// twice a second so they stay readable.
+- (NSArray<NSString *> *)profileLines;
+
+/// Writes the most recent samples as Chrome trace JSON, for
+/// chrome://tracing or Perfetto. Returns `NO` when the file cannot be written.
+- (BOOL)writeTraceToURL:(NSURL *)url;
+
 /// Returns the full overlay string in case consumer prefers to render it
 /// manually (e.g. via `SSKDiagnostics drawOverlayInView:`).
 - (NSString *)overlayStringWithTitle:(NSString *)title
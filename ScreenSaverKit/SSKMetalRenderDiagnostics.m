@@ -2,12 +2,22 @@
 
 #import <AppKit/AppKit.h>
 
-@interface SSKMetalRenderDiagnostics ()
+#import "SSKDiagnostics.h"
+
+/// How long the profile lines stay up before they are recomputed.
+static const CFTimeInterval kSSKProfileLinesInterval = 0.5;
+
+@interface SSKMetalRenderDiagnostics () {
+    SSKProfiler *_profiler;
+}
 @property (nonatomic, weak, nullable) CAMetalLayer *metalLayer;
 @property (nonatomic, strong, nullable) CATextLayer *overlayLayer;
 @property (nonatomic) NSUInteger metalSuccessCountInternal;
 @property (nonatomic) NSUInteger metalFailureCountInternal;
 @property (nonatomic) BOOL lastAttemptSucceededInternal;
+@property (nonatomic, copy, nullable) NSArray<NSString *> *cachedProfileLines;
+@property (nonatomic) CFTimeInterval profileLinesTimestamp;
+@property (nonatomic) CGSize laidOutLayerSize;
 @end
 
 @implementation SSKMetalRenderDiagnostics
@@ -15,10 +25,15 @@
 - (instancetype)init {
     if ((self = [super init])) {
         _overlayEnabled = YES;
+        _profiler = SSKProfilerCreate(0, 0, 0);
     }
     return self;
 }
 
+- (void)dealloc {
+    SSKProfilerDestroy(_profiler);
+}
+
 - (void)attachToMetalLayer:(CAMetalLayer *)layer {
     if (self.overlayLayer.superlayer) {
         [self.overlayLayer removeFromSuperlayer];
@@ -57,6 +72,23 @@
     }
 }
 
+- (SSKProfiler *)profiler {
+    return _profiler;
+}
+
+- (void)setProfilingEnabled:(BOOL)profilingEnabled {
+    if (_profilingEnabled == profilingEnabled) {
+        return;
+    }
+    _profilingEnabled = profilingEnabled;
+    SSKProfilerSetEnabled(_profiler, profilingEnabled);
+    if (!profilingEnabled) {
+        SSKProfilerCollect(_profiler, NULL, NULL);
+        SSKProfilerReset(_profiler);
+        self.cachedProfileLines = nil;
+    }
+}
+
 - (NSUInteger)metalSuccessCount {
     return self.metalSuccessCountInternal;
 }
@@ -87,6 +119,9 @@
     self.layerStatus = nil;
     self.rendererStatus = nil;
     self.drawableStatus = nil;
+    SSKProfilerCollect(_profiler, NULL, NULL);
+    SSKProfilerReset(_profiler);
+    self.cachedProfileLines = nil;
     [self updateOverlayWithTitle:@"" extraLines:nil framesPerSecond:0];
 }
 
@@ -101,6 +136,60 @@
     return @[device, layer, renderer, drawable, metalStats];
 }
 
+- (NSArray<NSString *> *)profileLines {
+    if (!self.profilingEnabled || !_profiler) {
+        return @[];
+    }
+    // Drain on every call so the rings never fill; format only now and then.
+    SSKProfilerCollect(_profiler, NULL, NULL);
+    CFTimeInterval now = CACurrentMediaTime();
+    if (self.cachedProfileLines && now - self.profileLinesTimestamp < kSSKProfileLinesInterval) {
+        return self.cachedProfileLines;
+    }
+
+    NSMutableArray<NSString *> *lines = [NSMutableArray array];
+    uint32_t phaseCount = SSKProfilerPhaseCount();
+    for (uint32_t phase = 1; phase <= phaseCount; phase++) {
+        for (int clock = SSKProfilerClockCPU; clock <= SSKProfilerClockGPU; clock++) {
+            SSKProfilerStats stats;
+            if (!SSKProfilerPhaseStats(_profiler, phase, (SSKProfilerClock)clock, &stats)) {
+                continue;
+            }
+            [lines addObject:[NSString stringWithFormat:@"%@ %s: %.2f / %.2f / %.2f",
+                              clock == SSKProfilerClockGPU ? @"GPU" : @"CPU", SSKProfilerPhaseName(phase),
+                              stats.p50, stats.p95, stats.p99]];
+        }
+    }
+    if (lines.count > 0) {
+        [lines insertObject:@"Phase p50 / p95 / p99 (ms):" atIndex:0];
+    }
+    uint64_t dropped = SSKProfilerDroppedCount(_profiler);
+    if (dropped > 0) {
+        [lines addObject:[NSString stringWithFormat:@"Profiler samples dropped: %llu", (unsigned long long)dropped]];
+    }
+    self.cachedProfileLines = lines;
+    self.profileLinesTimestamp = now;
+    return lines;
+}
+
+- (BOOL)writeTraceToURL:(NSURL *)url {
+    if (!_profiler || !url.isFileURL) {
+        return NO;
+    }
+    SSKProfilerCollect(_profiler, NULL, NULL);
+    FILE *file = fopen(url.fileSystemRepresentation, "w");
+    if (!file) {
+        [SSKDiagnostics log:@"SSKMetalRenderDiagnostics: cannot open %@ for the trace.", url.path];
+        return NO;
+    }
+    BOOL success = SSKProfilerWriteChromeTrace(_profiler, file);
+    success = fclose(file) == 0 && success;
+    if (!success) {
+        [SSKDiagnostics log:@"SSKMetalRenderDiagnostics: failed to write the trace to %@.", url.path];
+    }
+    return success;
+}
+
 - (NSString *)overlayStringWithTitle:(NSString *)title
                           extraLines:(NSArray<NSString *> *)extraLines
                      framesPerSecond:(double)fps {
@@ -112,6 +201,7 @@
     if (extraLines.count) {
         [lines addObjectsFromArray:extraLines];
     }
+    [lines addObjectsFromArray:[self profileLines]];
     NSString *fpsLine = [NSString stringWithFormat:@"FPS: %.1f", fps];
     [lines addObject:fpsLine];
     return [lines componentsJoinedByString:@"\n"];
@@ -130,6 +220,12 @@
     NSString *overlayString = [self overlayStringWithTitle:title
                                                 extraLines:extraLines
                                            framesPerSecond:fps];
+    // Setting the string redraws the layer and a new string is re-measured,
+    // so leave both alone while nothing has changed.
+    if ([overlayString isEqual:self.overlayLayer.string] &&
+        CGSizeEqualToSize(self.metalLayer.bounds.size, self.laidOutLayerSize)) {
+        return;
+    }
     self.overlayLayer.string = overlayString;
     [self layoutOverlayLayerWithString:overlayString];
 }
@@ -156,6 +252,7 @@
         textSize = bounds.size;
     }
     CGFloat height = MAX(textSize.height + 12.0, 40.0);
+    self.laidOutLayerSize = self.metalLayer.bounds.size;
     self.overlayLayer.frame = CGRectMake(inset,
                                          self.metalLayer.bounds.size.height - height - inset,
                                          maxWidth,
@@ -3,11 +3,15 @@
 #import <QuartzCore/CAMetalLayer.h>
 
 #import "SSKParticleSystem.h"
+#import "SSKMetalBloomPass.h"
+#import "SSKMetalParticlePass.h"
+#import "SSKMetalTrailPass.h"
 #import "SSKMetalEffectStage.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class SSKMetalParticlePass;
+@class SSKMetalFrameGraph;
+@class SSKMetalRenderDiagnostics;
 @class SSKMetalTextureCache;
 
 FOUNDATION_EXPORT NSString * const SSKMetalEffectIdentifierBlur;
@@ -39,6 +43,28 @@ FOUNDATION_EXPORT NSString * const SSKMetalEffectIdentifierColorGrading;
             blendMode:(SSKParticleBlendMode)blendMode
          viewportSize:(CGSize)viewportSize;
 
+/// Renders every live particle of `system`. Instances are written straight
+/// from the system's particle streams into the pass's instance buffer.
+- (void)drawParticleSystem:(SSKParticleSystem *)system
+                 blendMode:(SSKParticleBlendMode)blendMode
+              viewportSize:(CGSize)viewportSize;
+
+/// Renders instances the caller writes itself. `writer` gets room for
+/// `maxCount` `SSKParticleInstance` entries in the particle pass's mapped
+/// instance buffer and returns how many it filled; those are drawn as
+/// particles.
+- (void)drawInstancesWithMaxCount:(NSUInteger)maxCount
+                        blendMode:(SSKParticleBlendMode)blendMode
+                     viewportSize:(CGSize)viewportSize
+                           writer:(SSKMetalInstanceWriter)writer;
+
+/// Tessellates every trail of `trails` and draws them with one indexed draw
+/// call. Does nothing when the trail pass is unavailable.
+- (void)drawTrails:(const SSKTrailSet *)trails
+            params:(const SSKTrailMeshParams *)params
+         blendMode:(SSKParticleBlendMode)blendMode
+      viewportSize:(CGSize)viewportSize;
+
 /// Draws a texture into the current render target.
 - (void)drawTexture:(id<MTLTexture>)texture atRect:(CGRect)rect;
 
@@ -99,6 +125,31 @@ FOUNDATION_EXPORT NSString * const SSKMetalEffectIdentifierColorGrading;
 /// Sigma used for the bloom blur pass. Defaults to 3.0.
 @property (nonatomic) CGFloat bloomBlurSigma;
 
+/// Bloom algorithm. Defaults to `SSKMetalBloomModeGaussian`; the mip chain
+/// reaches much wider glows for the same cost and ignores `bloomBlurSigma`.
+@property (nonatomic) SSKMetalBloomMode bloomMode;
+
+/// Levels of the mip chain bloom (1-8); each doubles the glow radius. Defaults to 5.
+@property (nonatomic) NSUInteger bloomMipLevels;
+
+/// When YES, effects are recorded into `frameGraph` instead of being encoded
+/// straight away. A run of effects is then compiled as one graph before the
+/// next clear or draw (or at `endFrame`): their compute passes share one
+/// encoder and their intermediate textures share storage where lifetimes
+/// allow. Defaults to NO.
+@property (nonatomic) BOOL usesFrameGraph;
+
+/// Graph the effects are recorded into while `usesFrameGraph` is set.
+@property (nonatomic, strong, readonly) SSKMetalFrameGraph *frameGraph;
+
+/// Diagnostics to profile into. While its `profilingEnabled` is set, every
+/// frame records the CPU time from `beginFrame` to the commit in `endFrame`
+/// (`frame`), the wait for a drawable and the encoding of each clear, draw,
+/// effect and frame graph flush, plus the GPU time of the frame and, where
+/// supported, of each of those stages. Effects recorded into the frame graph
+/// are timed together as `frameGraph`.
+@property (nonatomic, strong, nullable) SSKMetalRenderDiagnostics *diagnostics;
+
 @end
 
 NS_ASSUME_NONNULL_END
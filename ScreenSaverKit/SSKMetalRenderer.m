@@ -4,14 +4,21 @@
 #import "SSKParticleSystem.h"
 #import "SSKDiagnostics.h"
 #import "SSKMetalParticlePass.h"
+#import "SSKMetalTrailPass.h"
 #import "SSKMetalBlurPass.h"
 #import "SSKMetalBloomPass.h"
+#import "SSKMetalFrameGraph.h"
+#import "SSKMetalGPUTimer.h"
+#import "SSKMetalRenderDiagnostics.h"
+#import "SSKMetalShaderLibrary.h"
 
 NSString * const SSKMetalEffectIdentifierBlur = @"com.ssk.effects.blur";
 NSString * const SSKMetalEffectIdentifierBloom = @"com.ssk.effects.bloom";
 NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorgrading";
 
-@interface SSKMetalRenderer ()
+@interface SSKMetalRenderer () {
+    SSKProfilerScope _frameScope;
+}
 @property (nonatomic, weak) CAMetalLayer *layer;
 @property (nonatomic, strong, readwrite) id<MTLDevice> device;
 @property (nonatomic, strong) id<MTLCommandQueue> commandQueue;
@@ -19,13 +26,17 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
 @property (nonatomic, strong, nullable) id<CAMetalDrawable> currentDrawable;
 @property (nonatomic, strong) id<MTLTexture> overrideRenderTarget;
 @property (nonatomic, strong, readwrite) SSKMetalTextureCache *textureCache;
+@property (nonatomic, strong, readwrite) SSKMetalFrameGraph *frameGraph;
 @property (nonatomic, readwrite) CGSize drawableSize;
 @property (nonatomic, strong) id<MTLLibrary> shaderLibrary;
 @property (nonatomic, strong) SSKMetalParticlePass *particlePass;
+@property (nonatomic, strong, nullable) SSKMetalTrailPass *trailPass;
 @property (nonatomic, strong, nullable) SSKMetalBlurPass *blurPass;
 @property (nonatomic, strong, nullable) SSKMetalBloomPass *bloomPass;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, SSKMetalEffectStage *> *effectRegistry;
 @property (nonatomic) BOOL needsClearOnNextPass;
+@property (nonatomic, strong, nullable) SSKMetalGPUTimer *gpuTimer;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *effectPhases;
 @end
 
 @implementation SSKMetalRenderer
@@ -57,9 +68,11 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
         }
         _clearColor = MTLClearColorMake(0.0, 0.0, 0.0, 1.0);
         _textureCache = [[SSKMetalTextureCache alloc] initWithDevice:device];
+        _frameGraph = [[SSKMetalFrameGraph alloc] init];
         _effectRegistry = [[NSMutableDictionary alloc] init];
+        _effectPhases = [[NSMutableDictionary alloc] init];
 
-        _shaderLibrary = [self loadDefaultLibraryWithDevice:device];
+        _shaderLibrary = [SSKMetalShaderLibrary libraryForDevice:device];
         if (!_shaderLibrary) {
             [SSKDiagnostics log:@"SSKMetalRenderer: failed to load shader library (SSKParticleShaders.metallib)."];
             return nil;
@@ -70,6 +83,13 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
             [SSKDiagnostics log:@"SSKMetalRenderer: failed to set up particle pass."];
             return nil;
         }
+        _trailPass = [SSKMetalTrailPass new];
+        if (![_trailPass setupWithDevice:device library:_shaderLibrary]) {
+            if ([SSKDiagnostics isEnabled]) {
+                [SSKDiagnostics log:@"SSKMetalRenderer: trail pass unavailable (continuing without trails)."];
+            }
+            _trailPass = nil;
+        }
         _blurPass = [[SSKMetalBlurPass alloc] init];
         if (![_blurPass setupWithDevice:device library:_shaderLibrary]) {
             if ([SSKDiagnostics isEnabled]) {
@@ -90,6 +110,8 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
         _particleBlurRadius = 0.0;
         _bloomThreshold = 0.8f;
         _bloomBlurSigma = 3.0f;
+        _bloomMode = SSKMetalBloomModeGaussian;
+        _bloomMipLevels = 5;
         _needsClearOnNextPass = YES;
     }
     return self;
@@ -113,20 +135,38 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
     self.drawableSize = CGSizeZero;
     self.overrideRenderTarget = nil;
     self.needsClearOnNextPass = YES;
+    [self.frameGraph reset];
+    [self.textureCache advanceFrame];
+
+    static uint32_t framePhase;
+    SSKProfiler *profiler = self.diagnostics.profiler;
+    _frameScope = SSKProfilerScopeBegin(profiler, SSKProfilerPhaseCached(&framePhase, "frame"));
+    if (_frameScope.profiler) {
+        if (!self.gpuTimer) {
+            self.gpuTimer = [[SSKMetalGPUTimer alloc] initWithDevice:self.device diagnostics:self.diagnostics];
+        }
+        [self.gpuTimer beginFrameWithCommandBuffer:self.currentCommandBuffer];
+    }
     return YES;
 }
 
 - (void)endFrame {
     if (!self.currentCommandBuffer) {
+        [self.frameGraph reset];
         self.currentDrawable = nil;
         self.overrideRenderTarget = nil;
         return;
     }
 
+    [self flushFrameGraph];
     if (self.currentDrawable) {
         [self.currentCommandBuffer presentDrawable:self.currentDrawable];
     }
+    if (_frameScope.profiler) {
+        [self.gpuTimer endFrameWithCommandBuffer:self.currentCommandBuffer];
+    }
     [self.currentCommandBuffer commit];
+    SSKProfilerScopeEnd(&_frameScope);
     self.currentCommandBuffer = nil;
     self.currentDrawable = nil;
     self.overrideRenderTarget = nil;
@@ -140,6 +180,7 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
     if (!commandBuffer || !target) {
         return;
     }
+    [self flushFrameGraph];
 
     MTLRenderPassDescriptor *descriptor = [MTLRenderPassDescriptor renderPassDescriptor];
     descriptor.colorAttachments[0].texture = target;
@@ -147,8 +188,11 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
     descriptor.colorAttachments[0].storeAction = MTLStoreActionStore;
     descriptor.colorAttachments[0].clearColor = color;
 
+    static uint32_t clearPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&clearPhase, "clear")];
     id<MTLRenderCommandEncoder> encoder = [commandBuffer renderCommandEncoderWithDescriptor:descriptor];
     [encoder endEncoding];
+    [self endProfiledStage:&scope];
     self.needsClearOnNextPass = NO;
 }
 
@@ -159,9 +203,12 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
     id<MTLCommandBuffer> commandBuffer = self.currentCommandBuffer;
     id<MTLTexture> target = [self activeRenderTarget];
     if (!commandBuffer || !target) { return; }
+    [self flushFrameGraph];
 
     NSArray<SSKParticle *> *liveParticles = particles ?: @[];
     MTLLoadAction loadAction = self.needsClearOnNextPass ? MTLLoadActionClear : MTLLoadActionLoad;
+    static uint32_t particlesPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&particlesPhase, "particles")];
     BOOL success = [self.particlePass encodeParticles:liveParticles
                                             blendMode:blendMode
                                          viewportSize:viewportSize
@@ -169,12 +216,95 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
                                          renderTarget:target
                                            loadAction:loadAction
                                            clearColor:self.clearColor];
+    [self endProfiledStage:&scope];
     if (!success && [SSKDiagnostics isEnabled]) {
         [SSKDiagnostics log:@"SSKMetalRenderer: particle pass failed to encode."];
     }
     self.needsClearOnNextPass = NO;
 }
 
+- (void)drawParticleSystem:(SSKParticleSystem *)system
+                 blendMode:(SSKParticleBlendMode)blendMode
+              viewportSize:(CGSize)viewportSize {
+    if (!self.particlePass || !system) { return; }
+    id<MTLCommandBuffer> commandBuffer = self.currentCommandBuffer;
+    id<MTLTexture> target = [self activeRenderTarget];
+    if (!commandBuffer || !target) { return; }
+    [self flushFrameGraph];
+
+    MTLLoadAction loadAction = self.needsClearOnNextPass ? MTLLoadActionClear : MTLLoadActionLoad;
+    static uint32_t particleSystemPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&particleSystemPhase, "particles")];
+    BOOL success = [self.particlePass encodeParticleSystem:system
+                                                 blendMode:blendMode
+                                              viewportSize:viewportSize
+                                             commandBuffer:commandBuffer
+                                              renderTarget:target
+                                                loadAction:loadAction
+                                                clearColor:self.clearColor];
+    [self endProfiledStage:&scope];
+    if (!success && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalRenderer: particle pass failed to encode."];
+    }
+    self.needsClearOnNextPass = NO;
+}
+
+- (void)drawInstancesWithMaxCount:(NSUInteger)maxCount
+                        blendMode:(SSKParticleBlendMode)blendMode
+                     viewportSize:(CGSize)viewportSize
+                           writer:(SSKMetalInstanceWriter)writer {
+    if (!self.particlePass || !writer) { return; }
+    id<MTLCommandBuffer> commandBuffer = self.currentCommandBuffer;
+    id<MTLTexture> target = [self activeRenderTarget];
+    if (!commandBuffer || !target) { return; }
+    [self flushFrameGraph];
+
+    MTLLoadAction loadAction = self.needsClearOnNextPass ? MTLLoadActionClear : MTLLoadActionLoad;
+    static uint32_t instancesPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&instancesPhase, "instances")];
+    BOOL success = [self.particlePass encodeInstanceCount:maxCount
+                                                   writer:writer
+                                                blendMode:blendMode
+                                             viewportSize:viewportSize
+                                            commandBuffer:commandBuffer
+                                             renderTarget:target
+                                               loadAction:loadAction
+                                               clearColor:self.clearColor];
+    [self endProfiledStage:&scope];
+    if (!success && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalRenderer: particle pass failed to encode."];
+    }
+    self.needsClearOnNextPass = NO;
+}
+
+- (void)drawTrails:(const SSKTrailSet *)trails
+            params:(const SSKTrailMeshParams *)params
+         blendMode:(SSKParticleBlendMode)blendMode
+      viewportSize:(CGSize)viewportSize {
+    if (!self.trailPass || !trails || !params) { return; }
+    id<MTLCommandBuffer> commandBuffer = self.currentCommandBuffer;
+    id<MTLTexture> target = [self activeRenderTarget];
+    if (!commandBuffer || !target) { return; }
+    [self flushFrameGraph];
+
+    MTLLoadAction loadAction = self.needsClearOnNextPass ? MTLLoadActionClear : MTLLoadActionLoad;
+    static uint32_t trailsPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&trailsPhase, "trails")];
+    BOOL success = [self.trailPass encodeTrails:trails
+                                         params:params
+                                      blendMode:blendMode
+                                   viewportSize:viewportSize
+                                  commandBuffer:commandBuffer
+                                   renderTarget:target
+                                     loadAction:loadAction
+                                     clearColor:self.clearColor];
+    [self endProfiledStage:&scope];
+    if (!success && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalRenderer: trail pass failed to encode."];
+    }
+    self.needsClearOnNextPass = NO;
+}
+
 - (void)drawTexture:(id<MTLTexture>)texture atRect:(CGRect)rect {
     (void)texture;
     (void)rect;
@@ -219,6 +349,8 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
         @"intensity": @(clamped),
         @"threshold": @(MAX(0.0, self.bloomThreshold)),
         @"sigma": @(MAX(0.1, self.bloomBlurSigma)),
+        @"mode": @(self.bloomMode),
+        @"levels": @(self.bloomMipLevels),
     };
     BOOL success = [self applyEffectWithIdentifier:SSKMetalEffectIdentifierBloom
                                         parameters:parameters];
@@ -312,7 +444,13 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
         return NO;
     }
     NSDictionary *effectiveParameters = parameters ?: @{};
-    return stage.handler(self, stage.pass, commandBuffer, target, effectiveParameters);
+    if (self.usesFrameGraph) {
+        return [self recordEffectStage:stage renderTarget:target parameters:effectiveParameters];
+    }
+    SSKProfilerScope scope = [self beginProfiledStage:[self profilerPhaseForEffect:identifier]];
+    BOOL success = stage.handler(self, stage.pass, commandBuffer, target, effectiveParameters);
+    [self endProfiledStage:&scope];
+    return success;
 }
 
 - (void)applyEffects:(NSArray<NSString *> *)identifiers
@@ -351,6 +489,15 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
                 [SSKDiagnostics log:@"SSKMetalRenderer: blur pass failed to encode."];
             }
             return success;
+        } graphHandler:^BOOL(SSKMetalRenderer *renderer, SSKMetalPass *pass, SSKMetalFrameGraph *graph, SSKFrameGraphResource renderTarget, NSDictionary *parameters) {
+            (void)renderer;
+            SSKMetalBlurPass *blurPass = (SSKMetalBlurPass *)pass;
+            CGFloat radius = MAX(0.0, [parameters[@"radius"] doubleValue]);
+            if (radius <= 0.01f) {
+                return YES;
+            }
+            blurPass.radius = radius;
+            return [blurPass addBlurToFrameGraph:graph source:renderTarget destination:renderTarget];
         }];
         [self registerEffectStage:blurStage];
     }
@@ -360,17 +507,9 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
                                                                                      pass:self.bloomPass
                                                                                   handler:^BOOL(SSKMetalRenderer *renderer, SSKMetalPass *pass, id<MTLCommandBuffer> commandBuffer, id<MTLTexture> renderTarget, NSDictionary *parameters) {
             SSKMetalBloomPass *bloomPass = (SSKMetalBloomPass *)pass;
-            CGFloat intensity = MAX(0.0, [parameters[@"intensity"] doubleValue]);
-            if (intensity <= 0.01f) {
+            if (![renderer configureBloomPass:bloomPass parameters:parameters]) {
                 return YES;
             }
-            NSNumber *thresholdNumber = parameters[@"threshold"];
-            NSNumber *sigmaNumber = parameters[@"sigma"];
-            CGFloat threshold = thresholdNumber ? thresholdNumber.doubleValue : renderer.bloomThreshold;
-            CGFloat sigma = sigmaNumber ? sigmaNumber.doubleValue : renderer.bloomBlurSigma;
-            bloomPass.intensity = intensity;
-            bloomPass.threshold = MAX(0.0, threshold);
-            bloomPass.blurSigma = MAX(0.1, sigma);
             BOOL success = [bloomPass encodeBloomWithCommandBuffer:commandBuffer
                                                             source:renderTarget
                                                       renderTarget:renderTarget
@@ -379,28 +518,124 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
                 [SSKDiagnostics log:@"SSKMetalRenderer: bloom pass failed to encode."];
             }
             return success;
+        } graphHandler:^BOOL(SSKMetalRenderer *renderer, SSKMetalPass *pass, SSKMetalFrameGraph *graph, SSKFrameGraphResource renderTarget, NSDictionary *parameters) {
+            SSKMetalBloomPass *bloomPass = (SSKMetalBloomPass *)pass;
+            if (![renderer configureBloomPass:bloomPass parameters:parameters]) {
+                return YES;
+            }
+            return [bloomPass addBloomToFrameGraph:graph source:renderTarget renderTarget:renderTarget];
         }];
         [self registerEffectStage:bloomStage];
     }
 }
 
-- (nullable id<MTLLibrary>)loadDefaultLibraryWithDevice:(id<MTLDevice>)device {
-    NSBundle *bundle = [NSBundle bundleForClass:self.class];
-    NSString *metallibPath = [bundle pathForResource:@"SSKParticleShaders" ofType:@"metallib"];
-    NSError *error = nil;
-    if (metallibPath.length > 0) {
-        NSURL *metallibURL = [NSURL fileURLWithPath:metallibPath];
-        id<MTLLibrary> library = [device newLibraryWithURL:metallibURL error:&error];
-        if (library) {
-            return library;
-        }
-        if ([SSKDiagnostics isEnabled]) {
-            [SSKDiagnostics log:@"SSKMetalRenderer: failed to load metallib at %@ (%@).", metallibPath, error.localizedDescription ?: @"unknown error"];
-        }
-    } else if ([SSKDiagnostics isEnabled]) {
-        [SSKDiagnostics log:@"SSKMetalRenderer: SSKParticleShaders.metallib missing from bundle resources."];
+/// Applies the bloom stage parameters, falling back to the renderer's bloom
+/// properties. Returns NO when the intensity is too low to be worth encoding.
+- (BOOL)configureBloomPass:(SSKMetalBloomPass *)bloomPass parameters:(NSDictionary *)parameters {
+    CGFloat intensity = MAX(0.0, [parameters[@"intensity"] doubleValue]);
+    if (intensity <= 0.01f) {
+        return NO;
+    }
+    NSNumber *thresholdNumber = parameters[@"threshold"];
+    NSNumber *sigmaNumber = parameters[@"sigma"];
+    NSNumber *modeNumber = parameters[@"mode"];
+    NSNumber *levelsNumber = parameters[@"levels"];
+    CGFloat threshold = thresholdNumber ? thresholdNumber.doubleValue : self.bloomThreshold;
+    CGFloat sigma = sigmaNumber ? sigmaNumber.doubleValue : self.bloomBlurSigma;
+    bloomPass.intensity = intensity;
+    bloomPass.threshold = MAX(0.0, threshold);
+    bloomPass.blurSigma = MAX(0.1, sigma);
+    bloomPass.mode = modeNumber ? (SSKMetalBloomMode)modeNumber.integerValue : self.bloomMode;
+    bloomPass.mipLevels = levelsNumber ? levelsNumber.unsignedIntegerValue : self.bloomMipLevels;
+    return YES;
+}
+
+/// Records `stage` into the frame graph. Stages without a graph handler run
+/// their regular handler as one opaque pass over the render target.
+- (BOOL)recordEffectStage:(SSKMetalEffectStage *)stage
+             renderTarget:(id<MTLTexture>)renderTarget
+               parameters:(NSDictionary *)parameters {
+    SSKMetalFrameGraph *graph = self.frameGraph;
+    SSKFrameGraphResource target = [graph importTexture:renderTarget name:@"renderTarget"];
+    if (target == SSKFrameGraphInvalid) {
+        return NO;
+    }
+    if (stage.graphHandler) {
+        return stage.graphHandler(self, stage.pass, graph, target, parameters);
+    }
+    __weak typeof(self) weakSelf = self;
+    SSKMetalEffectStageHandler handler = stage.handler;
+    SSKMetalPass *pass = stage.pass;
+    return [graph addEncoderPassNamed:stage.identifier
+                                reads:@[ @(target) ]
+                               writes:@[ @(target) ]
+                           sideEffect:NO
+                                block:^BOOL(SSKMetalFrameGraph *frameGraph, id<MTLCommandBuffer> commandBuffer) {
+        (void)frameGraph;
+        SSKMetalRenderer *renderer = weakSelf;
+        return renderer ? handler(renderer, pass, commandBuffer, renderTarget, parameters) : NO;
+    }];
+}
+
+/// Encodes the effects recorded since the last flush. Clears and draws are
+/// encoded immediately, so they flush first to keep the submission order.
+- (void)flushFrameGraph {
+    if (self.frameGraph.passCount == 0) {
+        return;
+    }
+    id<MTLCommandBuffer> commandBuffer = self.currentCommandBuffer;
+    static uint32_t frameGraphPhase;
+    SSKProfilerScope scope = [self beginProfiledStage:SSKProfilerPhaseCached(&frameGraphPhase, "frameGraph")];
+    BOOL success = commandBuffer && [self.frameGraph executeWithCommandBuffer:commandBuffer
+                                                                 textureCache:self.textureCache];
+    [self endProfiledStage:&scope];
+    if (!success && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalRenderer: frame graph failed to encode."];
+    }
+    [self.frameGraph reset];
+}
+
+- (void)setDiagnostics:(SSKMetalRenderDiagnostics *)diagnostics {
+    if (_diagnostics == diagnostics) {
+        return;
+    }
+    _diagnostics = diagnostics;
+    // The timer records into its diagnostics' profiler; a new one is made on
+    // the next profiled frame.
+    self.gpuTimer = nil;
+}
+
+/// Opens a profiled stage: CPU time until `endProfiledStage:` and, where the
+/// device allows, GPU time of the work encoded in between. Costs one check
+/// while profiling is off.
+- (SSKProfilerScope)beginProfiledStage:(uint32_t)phase {
+    SSKProfilerScope scope = SSKProfilerScopeBegin(self.diagnostics.profiler, phase);
+    if (scope.profiler) {
+        [self.gpuTimer beginStage:phase commandBuffer:self.currentCommandBuffer];
+    }
+    return scope;
+}
+
+- (void)endProfiledStage:(SSKProfilerScope *)scope {
+    if (!scope->profiler) {
+        return;
     }
-    return nil;
+    [self.gpuTimer endStageWithCommandBuffer:self.currentCommandBuffer];
+    SSKProfilerScopeEnd(scope);
+}
+
+/// `effect.<last component of the identifier>`, e.g. `effect.bloom`.
+- (uint32_t)profilerPhaseForEffect:(NSString *)identifier {
+    if (!SSKProfilerIsEnabled(self.diagnostics.profiler)) {
+        return 0;
+    }
+    NSNumber *phase = self.effectPhases[identifier];
+    if (!phase) {
+        NSString *name = [@"effect." stringByAppendingString:[identifier componentsSeparatedByString:@"."].lastObject];
+        phase = @(SSKProfilerRegisterPhase(name.UTF8String));
+        self.effectPhases[identifier] = phase;
+    }
+    return phase.unsignedIntValue;
 }
 
 - (id<MTLTexture>)activeRenderTarget {
@@ -423,7 +658,11 @@ NSString * const SSKMetalEffectIdentifierColorGrading = @"com.ssk.effects.colorg
             self.layer.allowsNextDrawableTimeout = YES;
         }
     }
-    id<CAMetalDrawable> drawable = [self.layer nextDrawable];
+    id<CAMetalDrawable> drawable = nil;
+    {
+        SSK_PROFILE_SCOPE(self.diagnostics.profiler, "drawable.wait");
+        drawable = [self.layer nextDrawable];
+    }
     if (!drawable) {
         return nil;
     }
@@ -0,0 +1,34 @@
+#import <Foundation/Foundation.h>
+#import <Metal/Metal.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Process-wide cache of the kit's precompiled shaders.
+///
+/// `SSKParticleShaders.metallib` is loaded once per device, and compute
+/// pipelines are built once per device, function and specialisation. Several
+/// savers starting together (System Settings previews, one view per display)
+/// then share the same pipelines instead of each compiling its own.
+/// Safe to call from any thread.
+@interface SSKMetalShaderLibrary : NSObject
+
+/// The kit's metallib on `device`, or nil when it is missing from the bundle
+/// or fails to load (logged through `SSKDiagnostics`).
++ (nullable id<MTLLibrary>)libraryForDevice:(id<MTLDevice>)device;
+
+/// Compute pipeline for `name` with bool function constant `i` set to bit `i`
+/// of `constants`, for `i < constantCount` (0 for an unspecialised function).
+/// With `wait`, builds the pipeline on the calling thread if needed. Without,
+/// returns nil until a build started in the background has finished, so a
+/// caller can keep running a more general variant in the meantime.
++ (nullable id<MTLComputePipelineState>)computePipelineForDevice:(id<MTLDevice>)device
+                                                     functionName:(NSString *)name
+                                                    boolConstants:(uint32_t)constants
+                                                    constantCount:(NSUInteger)constantCount
+                                                             wait:(BOOL)wait;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
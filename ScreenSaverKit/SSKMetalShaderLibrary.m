@@ -0,0 +1,171 @@
+#import "SSKMetalShaderLibrary.h"
+
+#import "SSKDiagnostics.h"
+
+/// Everything cached for one device. Guarded by `SSKMetalShaderLibraryLock`.
+@interface SSKMetalShaderLibraryEntry : NSObject
+@property (nonatomic, strong, nullable) id<MTLLibrary> library;
+@property (nonatomic) BOOL libraryLoadFailed;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id<MTLComputePipelineState>> *pipelines;
+/// Keys whose pipeline is being built in the background.
+@property (nonatomic, strong) NSMutableSet<NSString *> *pendingKeys;
+@end
+
+@implementation SSKMetalShaderLibraryEntry
+@end
+
+static NSLock *SSKMetalShaderLibraryLock(void) {
+    static NSLock *lock;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        lock = [NSLock new];
+    });
+    return lock;
+}
+
+@implementation SSKMetalShaderLibrary
+
++ (nullable id<MTLLibrary>)libraryForDevice:(id<MTLDevice>)device {
+    if (!device) { return nil; }
+    NSLock *lock = SSKMetalShaderLibraryLock();
+    [lock lock];
+    SSKMetalShaderLibraryEntry *entry = [self entryForDevice:device];
+    if (!entry.library && !entry.libraryLoadFailed) {
+        entry.library = [self loadLibraryWithDevice:device];
+        entry.libraryLoadFailed = entry.library == nil;
+    }
+    id<MTLLibrary> library = entry.library;
+    [lock unlock];
+    return library;
+}
+
++ (nullable id<MTLComputePipelineState>)computePipelineForDevice:(id<MTLDevice>)device
+                                                     functionName:(NSString *)name
+                                                    boolConstants:(uint32_t)constants
+                                                    constantCount:(NSUInteger)constantCount
+                                                             wait:(BOOL)wait {
+    id<MTLLibrary> library = [self libraryForDevice:device];
+    if (!library || name.length == 0 || constantCount > 32) { return nil; }
+    NSString *key = [NSString stringWithFormat:@"%@/%u/%lu", name, constants, (unsigned long)constantCount];
+
+    NSLock *lock = SSKMetalShaderLibraryLock();
+    [lock lock];
+    SSKMetalShaderLibraryEntry *entry = [self entryForDevice:device];
+    id<MTLComputePipelineState> pipeline = entry.pipelines[key];
+    BOOL pending = [entry.pendingKeys containsObject:key];
+    if (!pipeline && !wait && !pending) {
+        [entry.pendingKeys addObject:key];
+    }
+    [lock unlock];
+    if (pipeline || (!wait && pending)) {
+        return pipeline;
+    }
+
+    MTLFunctionConstantValues *values = [MTLFunctionConstantValues new];
+    for (NSUInteger index = 0; index < constantCount; index++) {
+        bool value = (constants >> index) & 1u;
+        [values setConstantValue:&value type:MTLDataTypeBool atIndex:index];
+    }
+
+    if (!wait) {
+        [library newFunctionWithName:name
+                      constantValues:values
+                   completionHandler:^(id<MTLFunction> function, NSError *error) {
+            if (!function) {
+                [self finishBuildForKey:key device:device pipeline:nil name:name error:error];
+                return;
+            }
+            [device newComputePipelineStateWithFunction:function
+                                      completionHandler:^(id<MTLComputePipelineState> built, NSError *buildError) {
+                [self finishBuildForKey:key device:device pipeline:built name:name error:buildError];
+            }];
+        }];
+        return nil;
+    }
+
+    // Built outside the lock; if two threads race, both pipelines are valid
+    // and the first one stored wins.
+    NSError *error = nil;
+    id<MTLFunction> function = [library newFunctionWithName:name constantValues:values error:&error];
+    id<MTLComputePipelineState> built =
+        function ? [device newComputePipelineStateWithFunction:function error:&error] : nil;
+    if (!built) {
+        [self logFailureForName:name error:error];
+        return nil;
+    }
+    [lock lock];
+    pipeline = entry.pipelines[key];
+    if (!pipeline) {
+        entry.pipelines[key] = built;
+        pipeline = built;
+    }
+    [lock unlock];
+    return pipeline;
+}
+
+#pragma mark - Helpers
+
+/// Must be called with the lock held.
++ (SSKMetalShaderLibraryEntry *)entryForDevice:(id<MTLDevice>)device {
+    static NSMapTable<id<MTLDevice>, SSKMetalShaderLibraryEntry *> *entries;
+    if (!entries) {
+        entries = [NSMapTable strongToStrongObjectsMapTable];
+    }
+    SSKMetalShaderLibraryEntry *entry = [entries objectForKey:device];
+    if (!entry) {
+        entry = [SSKMetalShaderLibraryEntry new];
+        entry.pipelines = [NSMutableDictionary dictionary];
+        entry.pendingKeys = [NSMutableSet set];
+        [entries setObject:entry forKey:device];
+    }
+    return entry;
+}
+
++ (void)finishBuildForKey:(NSString *)key
+                   device:(id<MTLDevice>)device
+                 pipeline:(nullable id<MTLComputePipelineState>)pipeline
+                     name:(NSString *)name
+                    error:(nullable NSError *)error {
+    if (!pipeline) {
+        // Left pending, so a variant that cannot be built is not retried every step.
+        [self logFailureForName:name error:error];
+        return;
+    }
+    NSLock *lock = SSKMetalShaderLibraryLock();
+    [lock lock];
+    SSKMetalShaderLibraryEntry *entry = [self entryForDevice:device];
+    if (!entry.pipelines[key]) {
+        entry.pipelines[key] = pipeline;
+    }
+    [entry.pendingKeys removeObject:key];
+    [lock unlock];
+}
+
++ (void)logFailureForName:(NSString *)name error:(nullable NSError *)error {
+    if ([SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalShaderLibrary: failed to build pipeline '%@' (%@).", name,
+                            error.localizedDescription ?: @"unknown error"];
+    }
+}
+
++ (nullable id<MTLLibrary>)loadLibraryWithDevice:(id<MTLDevice>)device {
+    NSBundle *bundle = [NSBundle bundleForClass:self];
+    NSString *metallibPath = [bundle pathForResource:@"SSKParticleShaders" ofType:@"metallib"];
+    NSError *error = nil;
+    if (metallibPath.length > 0) {
+        NSURL *metallibURL = [NSURL fileURLWithPath:metallibPath];
+        id<MTLLibrary> library = [device newLibraryWithURL:metallibURL error:&error];
+        if (library) {
+            return library;
+        }
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalShaderLibrary: failed to load metallib at %@ (%@).", metallibPath,
+                                error.localizedDescription ?: @"unknown error"];
+        }
+    } else if ([SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalShaderLibrary: SSKParticleShaders.metallib missing from bundle resources."];
+    }
+    return nil;
+}
+
+@end
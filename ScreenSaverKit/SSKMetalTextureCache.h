@@ -3,8 +3,12 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-/// Simple texture pool that reuses intermediate render targets to avoid the
+/// Texture pool that reuses intermediate render targets to avoid the
 /// allocation cost of creating new `MTLTexture` instances every frame.
+///
+/// Idle textures are kept within `byteBudget`, least recently used first out,
+/// and textures left idle for `maxIdleFrames` frames are dropped. Acquire and
+/// release are constant time; the policy lives in `Core/SSKTexturePool.h`.
 @interface SSKMetalTextureCache : NSObject
 
 - (instancetype)initWithDevice:(id<MTLDevice>)device NS_DESIGNATED_INITIALIZER;
@@ -25,9 +29,33 @@ NS_ASSUME_NONNULL_BEGIN
 /// Empties the cache and releases all pooled textures.
 - (void)clearCache;
 
-/// Trims the cache to `maxCount` textures (oldest ones are discarded first).
+/// Trims the cache to `maxCount` textures (least recently used ones are discarded first).
 - (void)trimToSize:(NSUInteger)maxCount;
 
+/// Trims the cache to `maxBytes` of pooled textures.
+- (void)trimToBytes:(NSUInteger)maxBytes;
+
+/// Ages the pooled textures by one frame. `SSKMetalRenderer` calls this from
+/// `beginFrame`.
+- (void)advanceFrame;
+
+/// Most memory the idle textures may hold. Defaults to 256 MB.
+@property (nonatomic) NSUInteger byteBudget;
+
+/// Frames a texture may stay idle before it is released; 0 keeps it until the
+/// budget needs the room. Defaults to 300.
+@property (nonatomic) NSUInteger maxIdleFrames;
+
+/// Lifetime counters and the current contents of the pool.
+@property (nonatomic, readonly) NSUInteger hitCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+@property (nonatomic, readonly) NSUInteger evictionCount;
+@property (nonatomic, readonly) NSUInteger pooledTextureCount;
+@property (nonatomic, readonly) NSUInteger pooledBytes;
+
+/// Bytes per pixel used for the budget; 4 for formats it does not know.
++ (NSUInteger)bytesPerPixelForPixelFormat:(MTLPixelFormat)pixelFormat;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -2,21 +2,43 @@
 
 #import <TargetConditionals.h>
 
-static inline NSNumber *SSKTextureCacheKey(NSUInteger width,
-                                           NSUInteger height,
-                                           MTLPixelFormat format,
-                                           MTLTextureUsage usage) {
-    uint64_t key = ((uint64_t)width << 32) ^
-                   ((uint64_t)height << 16) ^
-                   ((uint64_t)format << 8) ^
-                   (uint64_t)usage;
-    return @(key);
+#import "Core/SSKTexturePool.h"
+
+static const NSUInteger kSSKMetalTextureCacheDefaultBudget = 256u << 20;
+
+static void *SSKMetalTextureCacheCreateTexture(void *context, const SSKTexturePoolKey *key) {
+    id<MTLDevice> device = (__bridge id<MTLDevice>)context;
+    MTLTextureDescriptor *descriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:(MTLPixelFormat)key->format
+                                                                                          width:key->width
+                                                                                         height:key->height
+                                                                                      mipmapped:NO];
+    descriptor.usage = (MTLTextureUsage)key->usage;
+#if TARGET_OS_OSX
+    descriptor.storageMode = MTLStorageModePrivate;
+#endif
+    descriptor.resourceOptions = MTLResourceStorageModePrivate;
+    id<MTLTexture> texture = [device newTextureWithDescriptor:descriptor];
+    return texture ? (__bridge_retained void *)texture : NULL;
+}
+
+static void SSKMetalTextureCacheDestroyTexture(__unused void *context, void *handle) {
+    id<MTLTexture> texture = (__bridge_transfer id<MTLTexture>)handle;
+    (void)texture;
+}
+
+static SSKTexturePoolKey SSKMetalTextureCacheKey(NSUInteger width,
+                                                 NSUInteger height,
+                                                 MTLPixelFormat format,
+                                                 MTLTextureUsage usage) {
+    return (SSKTexturePoolKey){
+        (uint32_t)width, (uint32_t)height, (uint32_t)format, (uint32_t)usage,
+        (uint32_t)[SSKMetalTextureCache bytesPerPixelForPixelFormat:format],
+    };
 }
 
 @interface SSKMetalTextureCache ()
 @property (nonatomic, strong) id<MTLDevice> device;
-@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSHashTable<id<MTLTexture>> *> *textureBuckets;
-@property (nonatomic, strong) NSMutableArray<id<MTLTexture>> *allTexturesInInsertionOrder;
+@property (nonatomic, assign) SSKTexturePool *pool;
 @end
 
 @implementation SSKMetalTextureCache
@@ -25,12 +47,25 @@ static inline NSNumber *SSKTextureCacheKey(NSUInteger width,
     NSParameterAssert(device);
     if ((self = [super init])) {
         _device = device;
-        _textureBuckets = [NSMutableDictionary dictionary];
-        _allTexturesInInsertionOrder = [NSMutableArray array];
+        // The pool does not retain the device; `_device` keeps it alive.
+        SSKTexturePoolDevice poolDevice = {
+            .context = (__bridge void *)device,
+            .createTexture = SSKMetalTextureCacheCreateTexture,
+            .destroyTexture = SSKMetalTextureCacheDestroyTexture,
+        };
+        _pool = SSKTexturePoolCreate(&poolDevice, kSSKMetalTextureCacheDefaultBudget);
+        if (!_pool) {
+            return nil;
+        }
+        _maxIdleFrames = SSKTexturePoolDefaultMaxIdleFrames;
     }
     return self;
 }
 
+- (void)dealloc {
+    SSKTexturePoolDestroy(_pool);
+}
+
 - (id<MTLTexture>)acquireTextureWithSize:(CGSize)size
                              pixelFormat:(MTLPixelFormat)pixelFormat
                                    usage:(MTLTextureUsage)usage {
@@ -43,28 +78,9 @@ static inline NSNumber *SSKTextureCacheKey(NSUInteger width,
     width = MAX(width, 1);
     height = MAX(height, 1);
 
-    NSNumber *key = SSKTextureCacheKey(width, height, pixelFormat, usage);
-    NSHashTable<id<MTLTexture>> *bucket = self.textureBuckets[key];
-    id<MTLTexture> texture = bucket.anyObject;
-    if (texture) {
-        [bucket removeObject:texture];
-        if (bucket.count == 0) {
-            [self.textureBuckets removeObjectForKey:key];
-        }
-        [self.allTexturesInInsertionOrder removeObjectIdenticalTo:texture];
-        return texture;
-    }
-
-    MTLTextureDescriptor *descriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:pixelFormat
-                                                                                          width:width
-                                                                                         height:height
-                                                                                      mipmapped:NO];
-    descriptor.usage = usage;
-#if TARGET_OS_OSX
-    descriptor.storageMode = MTLStorageModePrivate;
-#endif
-    descriptor.resourceOptions = MTLResourceStorageModePrivate;
-    return [self.device newTextureWithDescriptor:descriptor];
+    SSKTexturePoolKey key = SSKMetalTextureCacheKey(width, height, pixelFormat, usage);
+    void *handle = SSKTexturePoolAcquire(self.pool, &key);
+    return handle ? (__bridge_transfer id<MTLTexture>)handle : nil;
 }
 
 - (id<MTLTexture>)acquireTextureMatchingTexture:(id<MTLTexture>)texture
@@ -80,38 +96,80 @@ static inline NSNumber *SSKTextureCacheKey(NSUInteger width,
     NSUInteger height = texture.height;
     if (width == 0 || height == 0) { return; }
 
-    NSNumber *key = SSKTextureCacheKey(width, height, texture.pixelFormat, texture.usage);
-    NSHashTable<id<MTLTexture>> *bucket = self.textureBuckets[key];
-    if (!bucket) {
-        bucket = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
-        self.textureBuckets[key] = bucket;
-    }
-    [bucket addObject:texture];
-    [self.allTexturesInInsertionOrder addObject:texture];
+    SSKTexturePoolKey key = SSKMetalTextureCacheKey(width, height, texture.pixelFormat, texture.usage);
+    SSKTexturePoolRelease(self.pool, &key, (__bridge_retained void *)texture);
 }
 
 - (void)clearCache {
-    [self.textureBuckets removeAllObjects];
-    [self.allTexturesInInsertionOrder removeAllObjects];
+    SSKTexturePoolTrimToCount(self.pool, 0);
 }
 
 - (void)trimToSize:(NSUInteger)maxCount {
-    if (maxCount == 0) {
-        [self clearCache];
-        return;
-    }
+    SSKTexturePoolTrimToCount(self.pool, (uint32_t)MIN(maxCount, (NSUInteger)UINT32_MAX));
+}
+
+- (void)trimToBytes:(NSUInteger)maxBytes {
+    SSKTexturePoolTrimToBytes(self.pool, maxBytes);
+}
 
-    while (self.allTexturesInInsertionOrder.count > maxCount) {
-        id<MTLTexture> texture = self.allTexturesInInsertionOrder.firstObject;
-        [self.allTexturesInInsertionOrder removeObjectAtIndex:0];
-        if (!texture) { continue; }
+- (void)advanceFrame {
+    SSKTexturePoolAdvanceFrame(self.pool);
+}
 
-        NSNumber *key = SSKTextureCacheKey(texture.width, texture.height, texture.pixelFormat, texture.usage);
-        NSHashTable<id<MTLTexture>> *bucket = self.textureBuckets[key];
-        [bucket removeObject:texture];
-        if (bucket.count == 0) {
-            [self.textureBuckets removeObjectForKey:key];
-        }
+- (NSUInteger)byteBudget {
+    return (NSUInteger)SSKTexturePoolBudget(self.pool);
+}
+
+- (void)setByteBudget:(NSUInteger)byteBudget {
+    SSKTexturePoolSetBudget(self.pool, byteBudget);
+}
+
+- (void)setMaxIdleFrames:(NSUInteger)maxIdleFrames {
+    _maxIdleFrames = MIN(maxIdleFrames, (NSUInteger)UINT32_MAX);
+    SSKTexturePoolSetMaxIdleFrames(self.pool, (uint32_t)_maxIdleFrames);
+}
+
+- (NSUInteger)hitCount {
+    return (NSUInteger)SSKTexturePoolGetStats(self.pool).hits;
+}
+
+- (NSUInteger)missCount {
+    return (NSUInteger)SSKTexturePoolGetStats(self.pool).misses;
+}
+
+- (NSUInteger)evictionCount {
+    return (NSUInteger)SSKTexturePoolGetStats(self.pool).evictions;
+}
+
+- (NSUInteger)pooledTextureCount {
+    return SSKTexturePoolGetStats(self.pool).pooledCount;
+}
+
+- (NSUInteger)pooledBytes {
+    return (NSUInteger)SSKTexturePoolGetStats(self.pool).pooledBytes;
+}
+
++ (NSUInteger)bytesPerPixelForPixelFormat:(MTLPixelFormat)pixelFormat {
+    switch (pixelFormat) {
+        case MTLPixelFormatA8Unorm:
+        case MTLPixelFormatR8Unorm:
+            return 1;
+        case MTLPixelFormatR16Float:
+        case MTLPixelFormatRG8Unorm:
+            return 2;
+        case MTLPixelFormatRG16Float:
+        case MTLPixelFormatR32Float:
+        case MTLPixelFormatRGB10A2Unorm:
+        case MTLPixelFormatBGR10A2Unorm:
+        case MTLPixelFormatRG11B10Float:
+            return 4;
+        case MTLPixelFormatRGBA16Float:
+        case MTLPixelFormatRG32Float:
+            return 8;
+        case MTLPixelFormatRGBA32Float:
+            return 16;
+        default:
+            return 4;
     }
 }
 
@@ -0,0 +1,34 @@
+#import "SSKMetalPass.h"
+
+#import "SSKParticleSystem.h"
+#import "Core/SSKTrail.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Render pass that draws every trail of an `SSKTrailSet` as one indexed
+/// triangle list. The set is tessellated straight into the pass's mapped
+/// vertex and index buffers each frame, so trails of any length and count
+/// cost a single draw call.
+@interface SSKMetalTrailPass : SSKMetalPass
+
+- (BOOL)setupWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library;
+
+/// How many command buffers may hold trail geometry at once (default 3).
+/// Changing it waits for the GPU to drain before the ring is rebuilt.
+@property (nonatomic) NSUInteger maxFramesInFlight;
+
+/// Tessellates `trails` with `params` and draws the strips anti-aliased.
+/// `SSKParticleBlendModeAlpha` composites them over the target and
+/// `SSKParticleBlendModeAdditive` adds them, as `SSKTrailRasterize` does.
+- (BOOL)encodeTrails:(const SSKTrailSet *)trails
+              params:(const SSKTrailMeshParams *)params
+           blendMode:(SSKParticleBlendMode)blendMode
+        viewportSize:(CGSize)viewportSize
+       commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+        renderTarget:(id<MTLTexture>)renderTarget
+          loadAction:(MTLLoadAction)loadAction
+          clearColor:(MTLClearColor)clearColor;
+
+@end
+
+NS_ASSUME_NONNULL_END
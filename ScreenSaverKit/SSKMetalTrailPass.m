@@ -0,0 +1,205 @@
+#import "SSKMetalTrailPass.h"
+
+#import <simd/simd.h>
+
+#import "SSKDiagnostics.h"
+#import "SSKMetalFrameRing.h"
+
+/// Room for 256 trails of 64 points per frame before an arena has to grow.
+static const NSUInteger kSSKTrailPassInitialArenaLength =
+    256 * 64 * (2 * sizeof(SSKTrailVertex) + 6 * sizeof(uint32_t));
+static const size_t kSSKTrailPassBufferAlignment = 256;
+
+@interface SSKMetalTrailPass ()
+@property (nonatomic, strong) id<MTLDevice> device;
+@property (nonatomic, strong) id<MTLLibrary> library;
+@property (nonatomic, strong) id<MTLRenderPipelineState> alphaPipeline;
+@property (nonatomic, strong) id<MTLRenderPipelineState> additivePipeline;
+@property (nonatomic, assign) SSKFrameRing *frameRing;
+/// Command buffer the open ring frame retires with, if any.
+@property (nonatomic, weak) id<MTLCommandBuffer> frameCommandBuffer;
+@end
+
+@implementation SSKMetalTrailPass
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        _maxFramesInFlight = SSKFrameRingDefaultFrameCount;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    SSKFrameRingEndFrame(_frameRing);
+    SSKFrameRingDestroy(_frameRing);
+}
+
+- (BOOL)setupWithDevice:(id<MTLDevice>)device library:(id<MTLLibrary>)library {
+    NSParameterAssert(device);
+    NSParameterAssert(library);
+    if (!device || !library) {
+        return NO;
+    }
+    self.device = device;
+    self.library = library;
+    return [self buildFrameRing] && [self buildRenderPipelines];
+}
+
+- (void)setMaxFramesInFlight:(NSUInteger)maxFramesInFlight {
+    maxFramesInFlight = MAX(maxFramesInFlight, (NSUInteger)1);
+    if (_maxFramesInFlight == maxFramesInFlight) { return; }
+    _maxFramesInFlight = maxFramesInFlight;
+    if (_frameRing) {
+        [self buildFrameRing];
+    }
+}
+
+- (BOOL)encodeTrails:(const SSKTrailSet *)trails
+              params:(const SSKTrailMeshParams *)params
+           blendMode:(SSKParticleBlendMode)blendMode
+        viewportSize:(CGSize)viewportSize
+       commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+        renderTarget:(id<MTLTexture>)renderTarget
+          loadAction:(MTLLoadAction)loadAction
+          clearColor:(MTLClearColor)clearColor {
+    if (!commandBuffer || !renderTarget || !trails || !params) {
+        return NO;
+    }
+
+    uint32_t maxVertices = SSKTrailSetMaxVertexCount(trails);
+    uint32_t maxIndices = SSKTrailSetMaxIndexCount(trails);
+    SSKFrameAllocation vertexAllocation = {0};
+    SSKFrameAllocation indexAllocation = {0};
+    if (![self allocateLength:maxVertices * sizeof(SSKTrailVertex)
+                commandBuffer:commandBuffer
+                   allocation:&vertexAllocation] ||
+        ![self allocateLength:maxIndices * sizeof(uint32_t)
+                commandBuffer:commandBuffer
+                   allocation:&indexAllocation]) {
+        return NO;
+    }
+    SSKTrailMeshCounts counts = SSKTrailSetTessellate(trails, params, vertexAllocation.contents, maxVertices,
+                                                      indexAllocation.contents, maxIndices);
+
+    MTLRenderPassDescriptor *descriptor = [MTLRenderPassDescriptor renderPassDescriptor];
+    descriptor.colorAttachments[0].texture = renderTarget;
+    descriptor.colorAttachments[0].storeAction = MTLStoreActionStore;
+    descriptor.colorAttachments[0].clearColor = clearColor;
+    descriptor.colorAttachments[0].loadAction = loadAction;
+    if (counts.indexCount == 0) {
+        if (loadAction == MTLLoadActionClear) {
+            id<MTLRenderCommandEncoder> encoder = [commandBuffer renderCommandEncoderWithDescriptor:descriptor];
+            [encoder endEncoding];
+        }
+        return YES;
+    }
+
+    id<MTLRenderCommandEncoder> encoder = [commandBuffer renderCommandEncoderWithDescriptor:descriptor];
+    if (!encoder) {
+        return NO;
+    }
+
+    id<MTLRenderPipelineState> pipeline = (blendMode == SSKParticleBlendModeAdditive) ? self.additivePipeline : self.alphaPipeline;
+    if (!pipeline) {
+        [encoder endEncoding];
+        return NO;
+    }
+
+    MTLViewport viewport = {0.0, 0.0, (double)renderTarget.width, (double)renderTarget.height, 0.0, 1.0};
+    [encoder setViewport:viewport];
+    [encoder setRenderPipelineState:pipeline];
+    [encoder setVertexBuffer:SSKMetalFrameAllocationBuffer(vertexAllocation) offset:vertexAllocation.offset atIndex:0];
+    vector_float2 viewportPoints = {(float)viewportSize.width, (float)viewportSize.height};
+    [encoder setVertexBytes:&viewportPoints length:sizeof(vector_float2) atIndex:1];
+    float softness = MAX(params->softness, 0.0f);
+    [encoder setFragmentBytes:&softness length:sizeof(float) atIndex:0];
+    [encoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+                        indexCount:counts.indexCount
+                         indexType:MTLIndexTypeUInt32
+                       indexBuffer:SSKMetalFrameAllocationBuffer(indexAllocation)
+                 indexBufferOffset:indexAllocation.offset];
+    [encoder endEncoding];
+
+    return YES;
+}
+
+#pragma mark - Private helpers
+
+/// Reserves `length` bytes in the ring frame tied to `commandBuffer`, opening
+/// a new frame for the first allocation of each command buffer as
+/// `SSKMetalParticlePass` does.
+- (BOOL)allocateLength:(size_t)length
+         commandBuffer:(id<MTLCommandBuffer>)commandBuffer
+            allocation:(SSKFrameAllocation *)allocation {
+    if (!self.frameRing) {
+        return NO;
+    }
+    if (self.frameCommandBuffer != commandBuffer) {
+        [self endOpenFrame];
+        uint64_t frame = SSKFrameRingBeginFrame(self.frameRing);
+        SSKMetalFrameRingRetireOnCompletion(self.frameRing, frame, commandBuffer);
+        self.frameCommandBuffer = commandBuffer;
+    }
+    return SSKFrameRingAllocate(self.frameRing, length, kSSKTrailPassBufferAlignment, allocation);
+}
+
+- (void)endOpenFrame {
+    SSKFrameRingEndFrame(self.frameRing);
+    self.frameCommandBuffer = nil;
+}
+
+- (BOOL)buildFrameRing {
+    [self endOpenFrame];
+    SSKFrameRingDestroy(self.frameRing);
+    self.frameRing = SSKMetalFrameRingCreate(self.device, self.maxFramesInFlight, kSSKTrailPassInitialArenaLength);
+    if (!self.frameRing && [SSKDiagnostics isEnabled]) {
+        [SSKDiagnostics log:@"SSKMetalTrailPass: failed to create geometry ring."];
+    }
+    return self.frameRing != NULL;
+}
+
+- (BOOL)buildRenderPipelines {
+    NSError *error = nil;
+    id<MTLFunction> vertexFunc = [self.library newFunctionWithName:@"trailVertex"];
+    id<MTLFunction> fragmentFunc = [self.library newFunctionWithName:@"trailFragment"];
+    if (!vertexFunc || !fragmentFunc) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalTrailPass: missing trail shader functions in library."];
+        }
+        return NO;
+    }
+
+    // trailFragment returns premultiplied colour.
+    MTLRenderPipelineDescriptor *descriptor = [MTLRenderPipelineDescriptor new];
+    descriptor.vertexFunction = vertexFunc;
+    descriptor.fragmentFunction = fragmentFunc;
+    descriptor.colorAttachments[0].pixelFormat = MTLPixelFormatBGRA8Unorm;
+    descriptor.colorAttachments[0].blendingEnabled = YES;
+    descriptor.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
+    descriptor.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
+
+    descriptor.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorOne;
+    descriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
+    descriptor.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorOne;
+    descriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
+    self.alphaPipeline = [self.device newRenderPipelineStateWithDescriptor:descriptor error:&error];
+    if (!self.alphaPipeline) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalTrailPass: failed to create alpha pipeline: %@", error.localizedDescription];
+        }
+        return NO;
+    }
+
+    descriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOne;
+    descriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOne;
+    self.additivePipeline = [self.device newRenderPipelineStateWithDescriptor:descriptor error:&error];
+    if (!self.additivePipeline) {
+        if ([SSKDiagnostics isEnabled]) {
+            [SSKDiagnostics log:@"SSKMetalTrailPass: failed to create additive pipeline: %@", error.localizedDescription];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+@end
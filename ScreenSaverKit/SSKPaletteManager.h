@@ -6,18 +6,25 @@ NS_ASSUME_NONNULL_BEGIN
 
 typedef NS_ENUM(NSUInteger, SSKPaletteInterpolationMode) {
     /// Loops smoothly from the last colour back to the first.
-    SSKPaletteInterpolationModeLoop,
-    /// Clamps progress to the end of the palette.
-    SSKPaletteInterpolationModeClamp
+    SSKPaletteInterpolationModeLoop = SSKPaletteWrapLoop,
+    /// Clamps progress to `[0, 1]`, running from the first colour to the last.
+    SSKPaletteInterpolationModeClamp = SSKPaletteWrapClamp
 };
 
 /// Registry of colour palettes associated with saver modules.
+///
+/// Registration publishes an immutable snapshot of every module, so lookups
+/// never take a lock or wait on a queue and are cheap enough to call every
+/// frame. Colours come from each palette's lookup tables, blended in linear
+/// light.
 @interface SSKPaletteManager : NSObject
 
 /// Shared singleton manager.
 + (instancetype)sharedManager;
 
 /// Registers palettes for a given module identifier (usually your saver preference domain).
+/// Palettes replace registered ones with the same identifier. The palettes
+/// are visible to lookups on every thread once this returns.
 - (void)registerPalettes:(NSArray<SSKColorPalette *> *)palettes
               forModule:(NSString *)moduleIdentifier;
 
@@ -28,11 +35,21 @@ typedef NS_ENUM(NSUInteger, SSKPaletteInterpolationMode) {
 - (nullable SSKColorPalette *)paletteWithIdentifier:(NSString *)identifier
                                             module:(NSString *)moduleIdentifier;
 
-/// Returns an interpolated colour at `progress` for the given palette.
+/// Returns an interpolated colour at `progress` for the given palette. Use
+/// `sampleColorsForPalette:...` when colouring many things per frame.
 - (NSColor *)colorForPalette:(SSKColorPalette *)palette
                     progress:(CGFloat)progress
             interpolationMode:(SSKPaletteInterpolationMode)mode;
 
+/// Fills `colors` with the palette at each of `count` progress values, as
+/// sRGB-encoded straight RGBA ready for the Metal passes and CoreGraphics.
+/// Allocates nothing once the palette's table is built.
+- (void)sampleColorsForPalette:(SSKColorPalette *)palette
+                      progress:(const float *)progress
+                         count:(NSUInteger)count
+             interpolationMode:(SSKPaletteInterpolationMode)mode
+                        colors:(SSKFloat4 *)colors;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -1,8 +1,25 @@
 #import "SSKPaletteManager.h"
 
-@interface SSKPaletteManager ()
-@property (nonatomic, strong) NSMapTable<NSString *, NSMutableArray<SSKColorPalette *> *> *modulePalettes;
-@property (nonatomic, strong) dispatch_queue_t isolationQueue;
+#import <stdatomic.h>
+
+/// Palettes of one module, in registration order and by identifier.
+@interface SSKPaletteModule : NSObject
+@property (nonatomic, copy) NSArray<SSKColorPalette *> *palettes;
+@property (nonatomic, copy) NSDictionary<NSString *, SSKColorPalette *> *palettesByIdentifier;
+@end
+
+@implementation SSKPaletteModule
+@end
+
+@interface SSKPaletteManager () {
+    /// Current `NSDictionary<NSString *, SSKPaletteModule *>`, read without locking.
+    _Atomic(void *) _modules;
+}
+/// Every snapshot ever published. Readers hold no reference of their own, so
+/// snapshots are kept alive for the manager's lifetime; registration happens
+/// a handful of times per process.
+@property (nonatomic, strong) NSMutableArray<NSDictionary<NSString *, SSKPaletteModule *> *> *publishedModules;
+@property (nonatomic, strong) dispatch_queue_t registrationQueue;
 @end
 
 @implementation SSKPaletteManager
@@ -18,8 +35,10 @@
 
 - (instancetype)initPrivate {
     if ((self = [super init])) {
-        _modulePalettes = [NSMapTable strongToStrongObjectsMapTable];
-        _isolationQueue = dispatch_queue_create("com.screensaverkit.paletteManager", DISPATCH_QUEUE_CONCURRENT);
+        NSDictionary<NSString *, SSKPaletteModule *> *empty = @{};
+        _publishedModules = [NSMutableArray arrayWithObject:empty];
+        atomic_init(&_modules, (__bridge void *)empty);
+        _registrationQueue = dispatch_queue_create("com.screensaverkit.paletteManager", DISPATCH_QUEUE_SERIAL);
     }
     return self;
 }
@@ -30,79 +49,84 @@
                                  userInfo:nil];
 }
 
+- (NSDictionary<NSString *, SSKPaletteModule *> *)currentModules {
+    return (__bridge NSDictionary<NSString *, SSKPaletteModule *> *)atomic_load_explicit(&_modules,
+                                                                                         memory_order_acquire);
+}
+
 - (void)registerPalettes:(NSArray<SSKColorPalette *> *)palettes
               forModule:(NSString *)moduleIdentifier {
     if (moduleIdentifier.length == 0 || palettes.count == 0) { return; }
-    dispatch_barrier_async(self.isolationQueue, ^{
-        NSMutableArray<SSKColorPalette *> *existing = [self.modulePalettes objectForKey:moduleIdentifier];
-        if (!existing) {
-            existing = [NSMutableArray array];
-            [self.modulePalettes setObject:existing forKey:moduleIdentifier];
-        }
+    dispatch_sync(self.registrationQueue, ^{
+        NSDictionary<NSString *, SSKPaletteModule *> *current = [self currentModules];
+        SSKPaletteModule *existing = current[moduleIdentifier];
+        NSMutableArray<SSKColorPalette *> *merged = [existing.palettes mutableCopy] ?: [NSMutableArray array];
+        NSMutableDictionary<NSString *, SSKColorPalette *> *byIdentifier =
+            [existing.palettesByIdentifier mutableCopy] ?: [NSMutableDictionary dictionary];
         // Replace existing palettes with matching identifiers, append new ones.
-        NSMutableDictionary<NSString *, NSNumber *> *lookup = [NSMutableDictionary dictionary];
-        [existing enumerateObjectsUsingBlock:^(SSKColorPalette *palette, NSUInteger idx, BOOL *stop) {
-            (void)stop;
-            lookup[palette.identifier] = @(idx);
-        }];
         for (SSKColorPalette *palette in palettes) {
-            NSNumber *existingIndex = lookup[palette.identifier];
-            if (existingIndex) {
-                existing[existingIndex.unsignedIntegerValue] = palette;
+            SSKColorPalette *previous = byIdentifier[palette.identifier];
+            if (previous) {
+                merged[[merged indexOfObjectIdenticalTo:previous]] = palette;
             } else {
-                [existing addObject:palette];
+                [merged addObject:palette];
             }
+            byIdentifier[palette.identifier] = palette;
         }
+
+        SSKPaletteModule *module = [SSKPaletteModule new];
+        module.palettes = merged;
+        module.palettesByIdentifier = byIdentifier;
+        NSMutableDictionary<NSString *, SSKPaletteModule *> *modules = [current mutableCopy];
+        modules[moduleIdentifier] = module;
+        NSDictionary<NSString *, SSKPaletteModule *> *snapshot = [modules copy];
+        [self.publishedModules addObject:snapshot];
+        atomic_store_explicit(&self->_modules, (__bridge void *)snapshot, memory_order_release);
     });
 }
 
 - (NSArray<SSKColorPalette *> *)palettesForModule:(NSString *)moduleIdentifier {
     if (moduleIdentifier.length == 0) { return @[]; }
-    __block NSArray<SSKColorPalette *> *result = nil;
-    dispatch_sync(self.isolationQueue, ^{
-        result = [[self.modulePalettes objectForKey:moduleIdentifier] copy] ?: @[];
-    });
-    return result;
+    return [self currentModules][moduleIdentifier].palettes ?: @[];
 }
 
 - (SSKColorPalette *)paletteWithIdentifier:(NSString *)identifier
                                     module:(NSString *)moduleIdentifier {
     if (moduleIdentifier.length == 0 || identifier.length == 0) { return nil; }
-    __block SSKColorPalette *found = nil;
-    dispatch_sync(self.isolationQueue, ^{
-        NSArray<SSKColorPalette *> *palettes = [self.modulePalettes objectForKey:moduleIdentifier];
-        for (SSKColorPalette *palette in palettes) {
-            if ([palette.identifier isEqualToString:identifier]) {
-                found = palette;
-                break;
-            }
-        }
-    });
-    return found;
+    return [self currentModules][moduleIdentifier].palettesByIdentifier[identifier];
 }
 
 - (NSColor *)colorForPalette:(SSKColorPalette *)palette
                     progress:(CGFloat)progress
             interpolationMode:(SSKPaletteInterpolationMode)mode {
-    NSArray<NSColor *> *colors = palette.colors;
-    if (colors.count == 0) {
+    const SSKPaletteLUT *table = [palette lookupTableForWrap:(SSKPaletteWrap)mode encoding:SSKPaletteEncodingSRGB];
+    if (!table) {
         return [NSColor whiteColor];
     }
-    if (colors.count == 1) {
-        return colors.firstObject;
+    SSKFloat4 color = SSKPaletteLUTSample(table, (float)progress);
+    return [NSColor colorWithSRGBRed:color.x green:color.y blue:color.z alpha:color.w];
+}
+
+- (void)sampleColorsForPalette:(SSKColorPalette *)palette
+                      progress:(const float *)progress
+                         count:(NSUInteger)count
+             interpolationMode:(SSKPaletteInterpolationMode)mode
+                        colors:(SSKFloat4 *)colors {
+    if (!progress || !colors || count == 0) { return; }
+    const SSKPaletteLUT *table = [palette lookupTableForWrap:(SSKPaletteWrap)mode encoding:SSKPaletteEncodingSRGB];
+    if (!table) {
+        for (NSUInteger i = 0; i < count; i++) {
+            colors[i] = SSKFloat4Make(1.0f, 1.0f, 1.0f, 1.0f);
+        }
+        return;
     }
-    CGFloat wrappedProgress = progress;
-    if (mode == SSKPaletteInterpolationModeLoop) {
-        wrappedProgress = progress - floor(progress);
-    } else {
-        wrappedProgress = fmax(0.0, fmin(1.0, progress));
+    while (count > 0) {
+        uint32_t batch = (uint32_t)MIN(count, (NSUInteger)UINT32_MAX);
+        SSKPaletteLUTSampleBatch(table, progress, colors, batch);
+        progress += batch;
+        colors += batch;
+        count -= batch;
     }
-    CGFloat scaled = wrappedProgress * (CGFloat)colors.count;
-    NSInteger index = (NSInteger)floor(scaled);
-    CGFloat fraction = scaled - (CGFloat)index;
-    NSColor *first = colors[(NSUInteger)(index % colors.count)];
-    NSColor *second = colors[(NSUInteger)((index + 1) % colors.count)];
-    return [first blendedColorWithFraction:fraction ofColor:second];
 }
 
 @end
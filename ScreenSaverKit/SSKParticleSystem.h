@@ -1,6 +1,9 @@
 #import <AppKit/AppKit.h>
 #import <simd/simd.h>
 
+@protocol MTLBuffer;
+@protocol MTLCommandBuffer;
+
 NS_ASSUME_NONNULL_BEGIN
 
 typedef NS_ENUM(NSUInteger, SSKParticleBlendMode) {
@@ -36,6 +39,110 @@ NS_INLINE SSKScalarRange SSKScalarRangeZero(void) {
     return SSKScalarRangeMake(0.0, 0.0);
 }
 
+/// Distribution-based description of a particle burst for `emitParticles:emission:`.
+/// Ranges are sampled uniformly per particle (equal bounds give a constant).
+typedef struct {
+    NSPoint origin;
+    NSSize originJitter;                    ///< Half-extents of a uniform box around `origin`.
+    SSKScalarRange radius;                  ///< Offset from `origin` along the emission angle.
+    SSKScalarRange angle;                   ///< Emission direction in radians.
+    SSKScalarRange speed;                   ///< Speed along the emission direction.
+    NSPoint baseVelocity;                   ///< Added to every particle's velocity.
+    SSKScalarRange maxLife;
+    SSKScalarRange size;
+    SSKScalarRange sizeVelocity;
+    SSKScalarRange sizeOverLifeRange;       ///< Start/end multipliers for `SSKParticleBehaviorOptionFadeSize`.
+    SSKScalarRange rotation;
+    SSKScalarRange rotationVelocity;
+    CGFloat damping;
+    vector_float4 colorStart;               ///< Extended sRGB, see `SSKParticleColorVector`.
+    vector_float4 colorEnd;                 ///< Each particle gets a uniform mix of start and end.
+    CGFloat userScalar;
+    SSKParticleBehaviorOptions behaviorOptions;
+} SSKParticleEmission;
+
+/// Emission at `origin` that spawns white, size 1, one second particles at rest.
+FOUNDATION_EXPORT SSKParticleEmission SSKParticleEmissionMake(NSPoint origin);
+
+/// Built-in separation/cohesion steering, see `SSKParticleSystem.flocking`.
+typedef struct {
+    CGFloat radius;             ///< Neighbours within this distance pull towards their centroid.
+    CGFloat separationRadius;   ///< Neighbours closer than this push apart, harder the closer they are.
+    CGFloat separation;         ///< Push strength, points per second² at contact.
+    CGFloat cohesion;           ///< Pull strength, per second² times the distance to the centroid.
+} SSKParticleFlocking;
+
+NS_INLINE SSKParticleFlocking SSKParticleFlockingMake(CGFloat radius, CGFloat separationRadius,
+                                                      CGFloat separation, CGFloat cohesion) {
+    SSKParticleFlocking flocking;
+    flocking.radius = radius;
+    flocking.separationRadius = separationRadius;
+    flocking.separation = separation;
+    flocking.cohesion = cohesion;
+    return flocking;
+}
+
+typedef NS_ENUM(uint32_t, SSKParticleForceFieldType) {
+    /// Pulls towards `center` (negative `strength` repels), fading linearly to
+    /// nothing at `radius`; a radius of 0 reaches everywhere.
+    SSKParticleForceFieldTypePoint,
+    /// Swirls around `center`, counter-clockwise for positive `strength`, with
+    /// the same falloff as a point field.
+    SSKParticleForceFieldTypeVortex,
+    /// Divergence-free flow from curl noise at `frequency` cycles per point,
+    /// drifting by `center` points per second.
+    SSKParticleForceFieldTypeCurlNoise,
+    /// Extra per-second damping (`strength`) inside `center` ± `extent`.
+    SSKParticleForceFieldTypeDrag,
+    /// Keeps particles inside `center` ± `extent`, bouncing with `strength` as restitution.
+    SSKParticleForceFieldTypeBounds,
+};
+
+/// Built-in force field evaluated by the system itself, see `addForceField:`.
+/// Use the constructors below rather than filling one in by hand.
+typedef struct {
+    SSKParticleForceFieldType type;
+    NSPoint center;
+    NSSize extent;
+    CGFloat strength;           ///< Points per second² for point, vortex and curl noise fields.
+    CGFloat radius;
+    CGFloat frequency;
+} SSKParticleForceField;
+
+NS_INLINE SSKParticleForceField SSKParticleForceFieldPoint(NSPoint center, CGFloat strength, CGFloat radius) {
+    SSKParticleForceField field = {SSKParticleForceFieldTypePoint, center, NSZeroSize, strength, radius, 0.0};
+    return field;
+}
+
+NS_INLINE SSKParticleForceField SSKParticleForceFieldVortex(NSPoint center, CGFloat strength, CGFloat radius) {
+    SSKParticleForceField field = {SSKParticleForceFieldTypeVortex, center, NSZeroSize, strength, radius, 0.0};
+    return field;
+}
+
+NS_INLINE SSKParticleForceField SSKParticleForceFieldCurlNoise(CGFloat frequency, CGFloat strength, NSPoint drift) {
+    SSKParticleForceField field = {SSKParticleForceFieldTypeCurlNoise, drift, NSZeroSize, strength, 0.0, frequency};
+    return field;
+}
+
+NS_INLINE SSKParticleForceField SSKParticleForceFieldDrag(NSRect zone, CGFloat damping) {
+    SSKParticleForceField field = {SSKParticleForceFieldTypeDrag, NSMakePoint(NSMidX(zone), NSMidY(zone)),
+                                   NSMakeSize(NSWidth(zone) * 0.5, NSHeight(zone) * 0.5), damping, 0.0, 0.0};
+    return field;
+}
+
+NS_INLINE SSKParticleForceField SSKParticleForceFieldBounds(NSRect rect, CGFloat restitution) {
+    SSKParticleForceField field = {SSKParticleForceFieldTypeBounds, NSMakePoint(NSMidX(rect), NSMidY(rect)),
+                                   NSMakeSize(NSWidth(rect) * 0.5, NSHeight(rect) * 0.5), restitution, 0.0, 0.0};
+    return field;
+}
+
+/// Size in bytes of one entry written by `-[SSKParticleSystem writeInstances:maxCount:]`.
+FOUNDATION_EXPORT const NSUInteger SSKParticleInstanceStride;
+
+/// Converts `color` to the extended sRGB components particles store. Convert
+/// once per burst and reuse the result rather than per particle.
+FOUNDATION_EXPORT vector_float4 SSKParticleColorVector(NSColor *color);
+
 @class SSKParticle;
 @class SSKMetalParticleRenderer;
 
@@ -83,12 +190,60 @@ typedef void (^SSKParticleRenderer)(CGContextRef ctx, SSKParticle *particle);
 /// Setting this property disables the Metal simulation path and forces CPU updates.
 @property (nonatomic, copy, nullable) SSKParticleUpdater updateHandler;
 
-/// Optional custom renderer used for drawing particles. When nil, a default blur disc is drawn.
+/// Optional custom renderer used for drawing particles. When nil, `drawInContext:` rasterizes
+/// the same quads as the Metal renderer in software.
 @property (nonatomic, copy, nullable) SSKParticleRenderer renderHandler;
 
+/// Cell size of the neighbour index used by `enumerateNeighborsOfPoint:radius:usingBlock:`.
+/// 0 (the default) disables the index. Otherwise every update starts by binning
+/// the live particles into a uniform grid with a counting sort, which makes a
+/// neighbour query cost roughly the number of particles in the cells it covers.
+/// Pick a size close to your usual query radius. Like `updateHandler`, the
+/// index forces CPU updates.
+@property (nonatomic) CGFloat neighborCellSize;
+
+/// Separation/cohesion steering applied to every live particle at the start of
+/// each update. Zero strengths (the default) disable it. Enabling it turns the
+/// neighbour index on, using the larger of the two radii as the cell size
+/// unless `neighborCellSize` is set.
+@property (nonatomic) SSKParticleFlocking flocking;
+
+/// Calls `block` for every live particle within `radius` of `point`, with its
+/// distance from `point`. Positions are those at the start of the current update
+/// (or of the last one, between updates), so the call is safe from inside
+/// `updateHandler`; particles spawned since are not seen. Returns NO without
+/// calling `block` when the neighbour index is disabled.
+- (BOOL)enumerateNeighborsOfPoint:(NSPoint)point
+                           radius:(CGFloat)radius
+                       usingBlock:(void (NS_NOESCAPE ^)(SSKParticle *particle, CGFloat distance, BOOL *stop))block;
+
+/// Appends a built-in force field and returns its index. Fields are applied in
+/// order to every live particle before integration (bounds fields after it),
+/// in batched sweeps over the particle streams on the CPU and in the compute
+/// kernel on the GPU, so they cost far less than an `updateHandler` and keep
+/// the fast paths enabled.
+- (NSUInteger)addForceField:(SSKParticleForceField)field;
+
+/// Replaces the field at `index`, e.g. to move an attractor each frame.
+- (void)replaceForceFieldAtIndex:(NSUInteger)index withForceField:(SSKParticleForceField)field;
+
+- (void)removeAllForceFields;
+
+@property (nonatomic, readonly) NSUInteger forceFieldCount;
+
 /// Emits `count` particles, initialising each with `initializer`.
 - (void)spawnParticles:(NSUInteger)count initializer:(SSKParticleInitializer)initializer;
 
+/// Emits up to `count` particles described by `emission` and returns how many
+/// were spawned. Values are written straight into the particle streams with a
+/// seeded generator: no per-particle objects, blocks or colour conversion.
+/// Prefer this over `spawnParticles:initializer:` for bursts.
+- (NSUInteger)emitParticles:(NSUInteger)count emission:(SSKParticleEmission)emission;
+
+/// Seed of the generator used by `emitParticles:emission:`. Setting it restarts
+/// the sequence, so the same seed and calls reproduce the same particles.
+@property (nonatomic) uint64_t emissionSeed;
+
 /// Advances the simulation by `dt` seconds, removing expired particles.
 - (void)advanceBy:(NSTimeInterval)dt;
 
@@ -98,6 +253,13 @@ typedef void (^SSKParticleRenderer)(CGContextRef ctx, SSKParticle *particle);
 /// Returns a snapshot of all alive particles for external rendering.
 - (NSArray<SSKParticle *> *)aliveParticlesSnapshot;
 
+/// Writes one packed quad instance per live particle (in slot order) to
+/// `destination` and returns how many were written, at most `maxCount`. Each
+/// entry is `SSKParticleInstanceStride` bytes and matches `InstanceData` in
+/// `SSKParticleShaders.metal`, so `destination` can be a mapped `MTLBuffer`.
+/// Reads the particle streams directly; no `SSKParticle` objects are touched.
+- (NSUInteger)writeInstances:(void *)destination maxCount:(NSUInteger)maxCount;
+
 /// Convenience helper that pushes particle data through a Metal-backed renderer.
 - (BOOL)renderWithMetalRenderer:(SSKMetalParticleRenderer *)renderer
                        blendMode:(SSKParticleBlendMode)blendMode
@@ -107,12 +269,69 @@ typedef void (^SSKParticleRenderer)(CGContextRef ctx, SSKParticle *particle);
 /// Defaults to YES when a Metal device and compute pipeline can be created.
 @property (nonatomic, getter=isMetalSimulationEnabled) BOOL metalSimulationEnabled;
 
+/// How many Metal simulation steps may be queued on the GPU at once (default 3).
+/// Each step reads its uniforms and writes its dead list in a persistently
+/// mapped frame ring, so `advanceBy:` only blocks when this many are pending.
+/// The particle streams themselves are not buffered: every method that reads
+/// or writes particles on the CPU (`spawnParticles:initializer:`,
+/// `emitParticles:emission:`, `drawInContext:`, `aliveParticlesSnapshot`,
+/// `writeInstances:maxCount:`) first waits for the steps already committed.
+/// `SSKParticle` objects from a snapshot are only safe to touch until the
+/// next `advanceBy:`.
+@property (nonatomic) NSUInteger maxFramesInFlight;
+
+/// Keeps the particle lifecycle on the GPU (default NO). Emission, expiry and
+/// instance packing all run in the Metal step: the kernels keep the alive and
+/// free slot lists, size the simulate dispatch and the particle draw with
+/// indirect arguments, and nothing per particle is read back. Only takes
+/// effect while Metal simulation is active and no `updateHandler` or
+/// neighbour index forces the CPU path.
+///
+/// While resident, `emitParticles:emission:` queues the emission for the next
+/// step and returns the requested count clamped to the capacity (the GPU
+/// emits fewer when it runs out of free slots), and `aliveParticleCount` lags
+/// the GPU by the steps in flight. Anything that needs particles on the CPU
+/// (`spawnParticles:initializer:`, `drawInContext:`, snapshots, `writeInstances:`)
+/// first waits for the GPU and hands the lifecycle back, so keep those out of
+/// the frame loop; `SSKMetalParticlePass` draws resident particles directly.
+@property (nonatomic, getter=isResidentSimulationEnabled) BOOL residentSimulationEnabled;
+
+/// Prepares a draw of the resident instances in `commandBuffer`: encodes a
+/// wait for the latest step and returns the instance buffer plus the
+/// `MTLDrawPrimitivesIndirectArguments` for a four-vertex triangle strip. Returns
+/// NO when there is nothing resident to draw or the command buffer belongs to
+/// another device. Every successful call must be matched by
+/// `endResidentDrawWithCommandBuffer:` on the same command buffer, after the draw.
+- (BOOL)beginResidentDrawWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                            instanceBuffer:(id<MTLBuffer> _Nullable * _Nonnull)instanceBuffer
+                           argumentsBuffer:(id<MTLBuffer> _Nullable * _Nonnull)argumentsBuffer
+                           argumentsOffset:(NSUInteger *)argumentsOffset;
+
+/// Signals that the draw encoded after `beginResidentDrawWithCommandBuffer:`
+/// is done with the instances, so the next step may overwrite them.
+- (void)endResidentDrawWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer;
+
+/// Number of threads (including the caller) used for CPU updates. Defaults to 1,
+/// which keeps every update on the calling thread; 0 uses one per CPU. Every
+/// update runs the same fixed slot chunks and releases dead slots in slot
+/// order, so particle state and slot reuse do not depend on the value. Ignored
+/// while an `updateHandler` is installed.
+@property (nonatomic) NSUInteger workerCount;
+
+/// Live-particle count below which CPU updates stay serial even when
+/// `workerCount` allows more threads. Defaults to 16384.
+@property (nonatomic) NSUInteger parallelThreshold;
+
 /// Returns the number of live particles currently managed by the system.
 @property (nonatomic, readonly) NSUInteger aliveParticleCount;
 
 /// Resets and removes all particles.
 - (void)reset;
 
+/// Extends `hash` (see `SSKReplayChecksum`) with the positions, velocities and
+/// lives of the particles, for `-[SSKScreenSaverView simulationChecksum]`.
+- (uint64_t)stateChecksumWithHash:(uint64_t)hash;
+
 @end
 
 NS_ASSUME_NONNULL_END
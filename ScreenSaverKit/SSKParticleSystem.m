@@ -4,123 +4,90 @@
 #import <simd/simd.h>
 #import <math.h>
 
+#import "SSKMetalFrameRing.h"
 #import "SSKMetalParticleRenderer.h"
+#import "SSKMetalShaderLibrary.h"
 #import "SSKVectorMath.h"
-
-// Behaviour flag values mirrored in the Metal shader.
-static const uint32_t kSSKParticleBehaviorFadeAlpha = (uint32_t)SSKParticleBehaviorOptionFadeAlpha;
-static const uint32_t kSSKParticleBehaviorFadeSize  = (uint32_t)SSKParticleBehaviorOptionFadeSize;
-
-typedef struct __attribute__((aligned(16))) {
-    vector_float2 position;
-    vector_float2 velocity;
-    vector_float2 userVector;
-    vector_float2 sizeRange;    // start, end multipliers
-    vector_float4 color;
-    vector_float4 baseColor;
-    float life;
-    float maxLife;
-    float size;
-    float baseSize;
-    float sizeVelocity;
-    float rotation;
-    float rotationVelocity;
-    float damping;
-    float userScalar;
-    uint32_t behaviorFlags;
-    uint32_t alive;
-    uint32_t padding[2];
-} SSKParticleState;
+#import "Core/SSKParticleCore.h"
+#import "Core/SSKForceField.h"
+#import "Core/SSKParticleEmitter.h"
+#import "Core/SSKParticleInstances.h"
+#import "Core/SSKParticleKernelVariant.h"
+#import "Core/SSKParticleLifecycle.h"
+#import "Core/SSKParticleParallel.h"
+#import "Core/SSKParticleRaster.h"
+#import "Core/SSKReplay.h"
+#import "Core/SSKSpatialGrid.h"
+
+// Behaviour flag values are mirrored in the Metal shader.
+_Static_assert((uint32_t)SSKParticleBehaviorOptionFadeAlpha == SSKParticleCoreBehaviorFadeAlpha, "behaviour flags must match the core");
+_Static_assert((uint32_t)SSKParticleBehaviorOptionFadeSize == SSKParticleCoreBehaviorFadeSize, "behaviour flags must match the core");
 
 typedef struct {
     vector_float2 gravity;
     float dt;
     float globalDamping;
-    float padding;
+    uint32_t capacity;
+    uint32_t fieldCount;
+    float time;
 } SSKParticleSimulationUniforms;
 
-static NSString * const kSSKParticleComputeTemplate =
-@"#include <metal_stdlib>\\n"
-"using namespace metal;\\n"
-"struct ParticleState {\\n"
-"    float2 position;\\n"
-"    float2 velocity;\\n"
-"    float2 userVector;\\n"
-"    float2 sizeRange;\\n"
-"    float4 color;\\n"
-"    float4 baseColor;\\n"
-"    float life;\\n"
-"    float maxLife;\\n"
-"    float size;\\n"
-"    float baseSize;\\n"
-"    float sizeVelocity;\\n"
-"    float rotation;\\n"
-"    float rotationVelocity;\\n"
-"    float damping;\\n"
-"    float userScalar;\\n"
-"    uint behaviorFlags;\\n"
-"    uint alive;\\n"
-"    uint padding0;\\n"
-"    uint padding1;\\n"
-"};\\n"
-"struct SimulationUniforms {\\n"
-"    float2 gravity;\\n"
-"    float dt;\\n"
-"    float globalDamping;\\n"
-"    float padding;\\n"
-"};\\n"
-"constant uint kBehaviorFadeAlpha = %u;\\n"
-"constant uint kBehaviorFadeSize  = %u;\\n"
-"kernel void simulateParticles(device ParticleState *particles [[buffer(0)]],\\n"
-"                             constant SimulationUniforms &uniforms [[buffer(1)]],\\n"
-"                             uint id [[thread_position_in_grid]]) {\\n"
-"    ParticleState state = particles[id];\\n"
-"    if (state.alive == 0u) { return; }\\n"
-"    float dt = uniforms.dt;\\n"
-"    state.life += dt;\\n"
-"    if (state.life >= state.maxLife) {\\n"
-"        state.alive = 0u;\\n"
-"        particles[id] = state;\\n"
-"        return;\\n"
-"    }\\n"
-"    if (any(uniforms.gravity)) {\\n"
-"        state.velocity += uniforms.gravity * dt;\\n"
-"    }\\n"
-"    float damping = max(0.0f, state.damping + uniforms.globalDamping);\\n"
-"    if (damping > 0.0f) {\\n"
-"        float factor = pow(max(0.0f, 1.0f - damping), dt);\\n"
-"        state.velocity *= factor;\\n"
-"    }\\n"
-"    state.position += state.velocity * dt;\\n"
-"    state.rotation += state.rotationVelocity * dt;\\n"
-"    if (fabs(state.sizeVelocity) > 0.0001f) {\\n"
-"        state.size = max(0.0f, state.size + state.sizeVelocity * dt);\\n"
-"    }\\n"
-"    float normalized = (state.maxLife > 0.0f) ? clamp(state.life / state.maxLife, 0.0f, 1.0f) : 0.0f;\\n"
-"    if ((state.behaviorFlags & kBehaviorFadeAlpha) != 0u) {\\n"
-"        float fade = 1.0f - normalized;\\n"
-"        state.color = float4(state.baseColor.rgb, state.baseColor.a * fade);\\n"
-"    } else {\\n"
-"        state.color = float4(state.color.rgb, state.color.a);\\n"
-"    }\\n"
-"    if ((state.behaviorFlags & kBehaviorFadeSize) != 0u) {\\n"
-"        float multiplier = mix(state.sizeRange.x, state.sizeRange.y, normalized);\\n"
-"        state.size = max(0.0f, state.baseSize * multiplier);\\n"
-"    }\\n"
-"    float velLenSq = length_squared(state.velocity);\\n"
-"    if (velLenSq > 0.0001f) {\\n"
-"        state.userVector = state.velocity * rsqrt(velLenSq);\\n"
-"    }\\n"
-"    particles[id] = state;\\n"
-"}\\n";
-
-static inline vector_float2 SSKVectorFromPoint(NSPoint point) {
-    return (vector_float2){(float)point.x, (float)point.y};
-}
-
-static inline NSPoint SSKPointFromVector(vector_float2 v) {
-    return NSMakePoint(v.x, v.y);
-}
+_Static_assert(sizeof(SSKForceField) == 32, "force fields are uploaded to the kernel as-is");
+
+// Each simulated stream of `SSKParticleCore` is bound at the buffer index equal
+// to its `SSKParticleStream` value; the uniforms and dead list follow the last stream.
+static const NSUInteger kSSKParticleUniformsBufferIndex = SSKParticleStreamSimulatedCount;
+static const NSUInteger kSSKParticleDeadCountBufferIndex = SSKParticleStreamSimulatedCount + 1;
+static const NSUInteger kSSKParticleDeadSlotsBufferIndex = SSKParticleStreamSimulatedCount + 2;
+static const NSUInteger kSSKParticleForceFieldsBufferIndex = SSKParticleStreamSimulatedCount + 3;
+
+// Resident lifecycle bindings (see `SSKParticleLifecycle.h`). The emitter
+// takes the uniforms' index in the emit kernel.
+static const NSUInteger kSSKParticleLifecycleStateBufferIndex = SSKParticleStreamSimulatedCount + 1;
+static const NSUInteger kSSKParticleAliveInBufferIndex = SSKParticleStreamSimulatedCount + 2;
+static const NSUInteger kSSKParticleAliveOutBufferIndex = SSKParticleStreamSimulatedCount + 4;
+static const NSUInteger kSSKParticleFreeSlotsBufferIndex = SSKParticleStreamSimulatedCount + 5;
+static const NSUInteger kSSKParticleInstancesBufferIndex = SSKParticleStreamSimulatedCount + 6;
+static const NSUInteger kSSKParticleUserScalarBufferIndex = SSKParticleStreamSimulatedCount + 7;
+static const NSUInteger kSSKParticleLifecycleParamsBufferIndex = SSKParticleStreamSimulatedCount + 8;
+
+/// `LifecycleParams` in `SSKParticleShaders.metal`.
+typedef struct {
+    uint32_t count;
+    uint32_t list;
+    uint32_t seedLow;
+    uint32_t seedHigh;
+} SSKParticleLifecycleParams;
+
+_Static_assert(sizeof(SSKParticleEmitter) == 160, "emitters are uploaded to the emit kernel as-is");
+
+/// Step kernels built in every `SSKParticleKernelFeature` variant.
+typedef NS_ENUM(NSUInteger, SSKParticleStepKernel) {
+    SSKParticleStepKernelSimulate,
+    SSKParticleStepKernelResident,
+    SSKParticleStepKernelCount,
+};
+
+static NSString * const kSSKParticleStepKernelNames[SSKParticleStepKernelCount] = {
+    @"simulateParticles",
+    @"simulateResidentParticles",
+};
+
+_Static_assert(SSKParticleLifecycleThreadgroupWidth == 64, "kLifecycleThreadgroupWidth in SSKParticleShaders.metal");
+
+/// An `emitParticles:emission:` call waiting for the next resident step.
+typedef struct {
+    SSKParticleEmitter emitter;
+    uint32_t count;
+    uint64_t seed;
+} SSKParticlePendingEmission;
+
+// Each step takes its uniforms and dead list (a count followed by the retired
+// slots) from a frame ring, so the CPU never overwrites data a step still in
+// flight is using and the completion handler can read one dead list while the
+// next step fills another.
+static const NSUInteger kSSKParticleDeadListHeaderLength = 16;
+static const size_t kSSKParticleFrameAlignment = 256;
 
 static inline vector_float4 SSKVectorFromColor(NSColor *color) {
     NSColor *srgb = [color colorUsingColorSpace:[NSColorSpace extendedSRGBColorSpace]] ?: color;
@@ -137,206 +104,326 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
                                    count:4];
 }
 
+const NSUInteger SSKParticleInstanceStride = sizeof(SSKParticleInstance);
+
+SSKParticleEmission SSKParticleEmissionMake(NSPoint origin) {
+    SSKParticleEmission emission;
+    memset(&emission, 0, sizeof(emission));
+    emission.origin = origin;
+    emission.maxLife = SSKScalarRangeMake(1.0, 1.0);
+    emission.size = SSKScalarRangeMake(1.0, 1.0);
+    emission.sizeOverLifeRange = SSKScalarRangeMake(1.0, 1.0);
+    emission.colorStart = (vector_float4){1.0f, 1.0f, 1.0f, 1.0f};
+    emission.colorEnd = emission.colorStart;
+    return emission;
+}
+
+vector_float4 SSKParticleColorVector(NSColor *color) {
+    return SSKVectorFromColor(color ?: [NSColor whiteColor]);
+}
+
+_Static_assert((uint32_t)SSKParticleForceFieldTypePoint == SSKForceFieldTypePoint &&
+               (uint32_t)SSKParticleForceFieldTypeVortex == SSKForceFieldTypeVortex &&
+               (uint32_t)SSKParticleForceFieldTypeCurlNoise == SSKForceFieldTypeCurlNoise &&
+               (uint32_t)SSKParticleForceFieldTypeDrag == SSKForceFieldTypeDrag &&
+               (uint32_t)SSKParticleForceFieldTypeBounds == SSKForceFieldTypeBounds,
+               "force field types must match the core");
+
+static SSKForceField SSKForceFieldFromParticleForceField(SSKParticleForceField field) {
+    SSKForceField coreField = SSKForceFieldMake((SSKForceFieldType)field.type, (float)field.strength);
+    coreField.radius = (float)field.radius;
+    coreField.frequency = (float)field.frequency;
+    coreField.center = SSKFloat2Make((float)field.center.x, (float)field.center.y);
+    coreField.extent = SSKFloat2Make((float)field.extent.width, (float)field.extent.height);
+    return coreField;
+}
+
+static inline SSKFloatRange SSKFloatRangeFromScalarRange(SSKScalarRange range) {
+    return SSKFloatRangeMake((float)range.start, (float)range.end);
+}
+
+static inline SSKFloat4 SSKFloat4FromVector(vector_float4 v) {
+    return SSKFloat4Make(v.x, v.y, v.z, v.w);
+}
+
+static SSKParticleEmitter SSKParticleEmitterFromEmission(const SSKParticleEmission *emission) {
+    SSKParticleEmitter emitter;
+    emitter.origin = SSKFloat2Make((float)emission->origin.x, (float)emission->origin.y);
+    emitter.originJitter = SSKFloat2Make((float)emission->originJitter.width, (float)emission->originJitter.height);
+    emitter.radius = SSKFloatRangeFromScalarRange(emission->radius);
+    emitter.angle = SSKFloatRangeFromScalarRange(emission->angle);
+    emitter.speed = SSKFloatRangeFromScalarRange(emission->speed);
+    emitter.baseVelocity = SSKFloat2Make((float)emission->baseVelocity.x, (float)emission->baseVelocity.y);
+    emitter.maxLife = SSKFloatRangeFromScalarRange(emission->maxLife);
+    emitter.size = SSKFloatRangeFromScalarRange(emission->size);
+    emitter.sizeVelocity = SSKFloatRangeFromScalarRange(emission->sizeVelocity);
+    emitter.sizeOverLife = SSKFloat2Make((float)emission->sizeOverLifeRange.start, (float)emission->sizeOverLifeRange.end);
+    emitter.rotation = SSKFloatRangeFromScalarRange(emission->rotation);
+    emitter.rotationVelocity = SSKFloatRangeFromScalarRange(emission->rotationVelocity);
+    emitter.damping = (float)emission->damping;
+    emitter.colorStart = SSKFloat4FromVector(emission->colorStart);
+    emitter.colorEnd = SSKFloat4FromVector(emission->colorEnd);
+    emitter.userScalar = (float)emission->userScalar;
+    emitter.behaviorFlags = (uint32_t)emission->behaviorOptions;
+    return emitter;
+}
+
 @interface SSKParticle ()
-- (instancetype)initWithState:(SSKParticleState *)state index:(NSUInteger)index;
-@property (nonatomic, readonly) NSUInteger index;
-@property (nonatomic, assign) SSKParticleState *state;
+- (instancetype)initWithCore:(SSKParticleCore *)core index:(uint32_t)index;
+@property (nonatomic, readonly) uint32_t index;
+@property (nonatomic, readonly) SSKParticleCore *core;
 @property (nonatomic, getter=isAlive) BOOL alive;
 @end
 
 @implementation SSKParticle
 
-- (instancetype)initWithState:(SSKParticleState *)state index:(NSUInteger)index {
+- (instancetype)initWithCore:(SSKParticleCore *)core index:(uint32_t)index {
     if ((self = [super init])) {
-        _state = state;
+        _core = core;
         _index = index;
     }
     return self;
 }
 
 - (BOOL)isAlive {
-    return self.state->alive != 0;
+    return self.core->alive[self.index] != 0;
 }
 
 - (void)setAlive:(BOOL)alive {
-    self.state->alive = alive ? 1u : 0u;
+    self.core->alive[self.index] = alive ? 1u : 0u;
 }
 
 - (NSPoint)position {
-    return SSKPointFromVector(self.state->position);
+    SSKFloat2 value = self.core->position[self.index];
+    return NSMakePoint(value.x, value.y);
 }
 
 - (void)setPosition:(NSPoint)position {
-    self.state->position = SSKVectorFromPoint(position);
+    self.core->position[self.index] = SSKFloat2Make((float)position.x, (float)position.y);
 }
 
 - (NSPoint)velocity {
-    return SSKPointFromVector(self.state->velocity);
+    SSKFloat2 value = self.core->velocity[self.index];
+    return NSMakePoint(value.x, value.y);
 }
 
 - (void)setVelocity:(NSPoint)velocity {
-    self.state->velocity = SSKVectorFromPoint(velocity);
+    self.core->velocity[self.index] = SSKFloat2Make((float)velocity.x, (float)velocity.y);
 }
 
 - (CGFloat)life {
-    return self.state->life;
+    return self.core->life[self.index];
 }
 
 - (void)setLife:(CGFloat)life {
-    self.state->life = life;
+    self.core->life[self.index] = (float)life;
 }
 
 - (CGFloat)maxLife {
-    return self.state->maxLife;
+    return self.core->maxLife[self.index];
 }
 
 - (void)setMaxLife:(CGFloat)maxLife {
-    self.state->maxLife = maxLife;
+    self.core->maxLife[self.index] = (float)maxLife;
 }
 
 - (CGFloat)size {
-    return self.state->size;
+    return self.core->size[self.index];
 }
 
 - (void)setSize:(CGFloat)size {
-    self.state->size = size;
-    if (self.state->baseSize <= 0.0f) {
-        self.state->baseSize = size;
+    self.core->size[self.index] = (float)size;
+    if (self.core->baseSize[self.index] <= 0.0f) {
+        self.core->baseSize[self.index] = (float)size;
     }
 }
 
 - (NSColor *)color {
-    return SSKColorFromVector(self.state->color);
+    return SSKColorFromVector(self.metalColorVector);
 }
 
 - (void)setColor:(NSColor *)color {
     vector_float4 value = SSKVectorFromColor(color ?: [NSColor whiteColor]);
-    self.state->color = value;
-    self.state->baseColor = value;
+    SSKFloat4 stored = SSKFloat4Make(value.x, value.y, value.z, value.w);
+    self.core->color[self.index] = stored;
+    self.core->baseColor[self.index] = stored;
 }
 
 - (vector_float4)metalColorVector {
-    return self.state->color;
+    SSKFloat4 value = self.core->color[self.index];
+    return (vector_float4){value.x, value.y, value.z, value.w};
 }
 
 - (CGFloat)rotation {
-    return self.state->rotation;
+    return self.core->rotation[self.index];
 }
 
 - (void)setRotation:(CGFloat)rotation {
-    self.state->rotation = rotation;
+    self.core->rotation[self.index] = (float)rotation;
 }
 
 - (CGFloat)rotationVelocity {
-    return self.state->rotationVelocity;
+    return self.core->rotationVelocity[self.index];
 }
 
 - (void)setRotationVelocity:(CGFloat)rotationVelocity {
-    self.state->rotationVelocity = rotationVelocity;
+    self.core->rotationVelocity[self.index] = (float)rotationVelocity;
 }
 
 - (CGFloat)damping {
-    return self.state->damping;
+    return self.core->damping[self.index];
 }
 
 - (void)setDamping:(CGFloat)damping {
-    self.state->damping = damping;
+    self.core->damping[self.index] = (float)damping;
+    self.core->usedDamping |= damping != 0.0;
 }
 
 - (CGFloat)userScalar {
-    return self.state->userScalar;
+    return self.core->userScalar[self.index];
 }
 
 - (void)setUserScalar:(CGFloat)userScalar {
-    self.state->userScalar = userScalar;
+    self.core->userScalar[self.index] = (float)userScalar;
 }
 
 - (NSPoint)userVector {
-    return SSKPointFromVector(self.state->userVector);
+    SSKFloat2 value = self.core->userVector[self.index];
+    return NSMakePoint(value.x, value.y);
 }
 
 - (void)setUserVector:(NSPoint)userVector {
-    self.state->userVector = SSKVectorFromPoint(userVector);
+    self.core->userVector[self.index] = SSKFloat2Make((float)userVector.x, (float)userVector.y);
 }
 
 - (CGFloat)baseSize {
-    return self.state->baseSize;
+    return self.core->baseSize[self.index];
 }
 
 - (void)setBaseSize:(CGFloat)baseSize {
-    self.state->baseSize = baseSize;
+    self.core->baseSize[self.index] = (float)baseSize;
 }
 
 - (CGFloat)sizeVelocity {
-    return self.state->sizeVelocity;
+    return self.core->sizeVelocity[self.index];
 }
 
 - (void)setSizeVelocity:(CGFloat)sizeVelocity {
-    self.state->sizeVelocity = sizeVelocity;
+    self.core->sizeVelocity[self.index] = (float)sizeVelocity;
 }
 
 - (SSKScalarRange)sizeOverLifeRange {
-    return SSKScalarRangeMake(self.state->sizeRange.x, self.state->sizeRange.y);
+    SSKFloat2 range = self.core->sizeRange[self.index];
+    return SSKScalarRangeMake(range.x, range.y);
 }
 
 - (void)setSizeOverLifeRange:(SSKScalarRange)sizeOverLifeRange {
-    self.state->sizeRange = (vector_float2){(float)sizeOverLifeRange.start, (float)sizeOverLifeRange.end};
+    self.core->sizeRange[self.index] = SSKFloat2Make((float)sizeOverLifeRange.start, (float)sizeOverLifeRange.end);
 }
 
 - (SSKParticleBehaviorOptions)behaviorOptions {
-    return (SSKParticleBehaviorOptions)self.state->behaviorFlags;
+    return (SSKParticleBehaviorOptions)self.core->behaviorFlags[self.index];
 }
 
 - (void)setBehaviorOptions:(SSKParticleBehaviorOptions)behaviorOptions {
-    self.state->behaviorFlags = (uint32_t)behaviorOptions;
+    self.core->behaviorFlags[self.index] = (uint32_t)behaviorOptions;
+    self.core->usedBehaviorFlags |= (uint32_t)behaviorOptions;
 }
 
 @end
 
-@interface SSKParticleSystem ()
+@interface SSKParticleSystem () {
+    /// Per step kernel, bit `v` is set once variant `v` is in `stepPipelines`.
+    uint32_t _readyStepVariants[SSKParticleStepKernelCount];
+}
 @property (nonatomic, assign) NSUInteger capacity;
-@property (nonatomic, assign) SSKParticleState *states;
+@property (nonatomic, assign) SSKParticleCore *core;
+@property (nonatomic, assign) SSKParticleParallel *parallel;
 @property (nonatomic, strong) NSMutableArray<SSKParticle *> *particles;
 @property (nonatomic, strong) NSMutableArray<SSKParticle *> *aliveScratch;
-@property (nonatomic, strong) NSMutableIndexSet *availableIndices;
 @property (nonatomic, strong) id<MTLDevice> metalDevice;
 @property (nonatomic, strong) id<MTLCommandQueue> commandQueue;
-@property (nonatomic, strong) id<MTLComputePipelineState> computePipeline;
+/// Specialised step pipelines from `SSKMetalShaderLibrary`, keyed by kernel and variant.
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, id<MTLComputePipelineState>> *stepPipelines;
 @property (nonatomic, strong) id<MTLBuffer> particleBuffer;
-@property (nonatomic, strong) id<MTLBuffer> uniformsBuffer;
+@property (nonatomic, assign) SSKFrameRing *frameRing;
+/// Resident lifecycle state, created the first time the mode is used.
+@property (nonatomic, strong) id<MTLComputePipelineState> emitPipeline;
+@property (nonatomic, strong) id<MTLComputePipelineState> commitEmissionPipeline;
+@property (nonatomic, strong) id<MTLComputePipelineState> preparePipeline;
+@property (nonatomic, strong) id<MTLComputePipelineState> finalizePipeline;
+@property (nonatomic) BOOL residentSetUp;
+@property (nonatomic, strong) id<MTLBuffer> lifecycleStateBuffer;
+/// Both alive lists followed by the free stack, `capacity` slots each.
+@property (nonatomic, strong) id<MTLBuffer> lifecycleListBuffer;
+@property (nonatomic, strong) id<MTLBuffer> residentInstanceBuffer;
+/// Orders resident steps and the draws reading their output across queues.
+@property (nonatomic, strong) id<MTLEvent> residentEvent;
+@property (nonatomic) uint64_t residentEventValue;
+@property (nonatomic) BOOL residentSetUpFailed;
+/// The GPU owns liveness; the core's alive list and allocator are stale.
+@property (nonatomic) BOOL residentLoaded;
+/// At least one step ran since loading, so the instance buffer is valid.
+@property (nonatomic) BOOL residentInstancesReady;
+/// Alive list the next resident step reads.
+@property (nonatomic) uint32_t residentList;
+/// `SSKParticlePendingEmission` entries for the next resident step.
+@property (nonatomic, strong) NSMutableData *pendingEmissions;
+/// Bumped whenever the slot allocator is rebuilt, so dead lists from steps
+/// committed before the rebuild are dropped instead of released twice.
+@property (nonatomic) uint64_t slotGeneration;
+/// Non-resident Metal steps were committed since the CPU last owned liveness.
+@property (nonatomic) BOOL metalStepsOutstanding;
+/// Non-resident Metal steps may still be writing the particle streams.
+@property (nonatomic) BOOL metalStepsInFlight;
 @property (nonatomic) BOOL supportsMetalSimulation;
-@property (nonatomic) BOOL updateHandlerForcesCPU;
-@property (nonatomic, readonly) NSUInteger stateStride;
-- (void)markStateDirtyAtIndex:(NSUInteger)index;
+@property (nonatomic, assign) SSKSpatialGrid *spatialGrid;
+/// `SSKForceField` entries in evaluation order.
+@property (nonatomic, strong) NSMutableData *forceFieldData;
+/// Seconds simulated so far; drives animated force fields.
+@property (nonatomic) double simulationTime;
+@property (nonatomic) BOOL simulationForcesCPU;
+/// Software rasterizer and buffers behind the default `drawInContext:` path.
+@property (nonatomic, assign) SSKParticleRasterizer *rasterizer;
+@property (nonatomic, strong) NSMutableData *rasterInstances;
+@property (nonatomic, strong) NSMutableData *rasterPixels;
+@property (nonatomic, readonly) BOOL neighborIndexEnabled;
+@property (nonatomic) SSKRandom emissionRandom;
 - (void)markAllStatesDirty;
 @end
 
 @implementation SSKParticleSystem
 
 - (instancetype)initWithCapacity:(NSUInteger)capacity {
-    NSParameterAssert(capacity > 0);
+    NSParameterAssert(capacity > 0 && capacity <= UINT32_MAX);
     if ((self = [super init])) {
         _capacity = capacity;
         _particles = [NSMutableArray arrayWithCapacity:capacity];
-        _availableIndices = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, capacity)];
         _blendMode = SSKParticleBlendModeAlpha;
         _gravity = NSZeroPoint;
         _globalDamping = 0.0;
+        _workerCount = 1;
+        _parallelThreshold = SSKParticleParallelDefaultSerialThreshold;
+        _emissionSeed = (uint64_t)arc4random() << 32 | arc4random();
+        _emissionRandom = SSKRandomMake(_emissionSeed);
+        _maxFramesInFlight = SSKFrameRingDefaultFrameCount;
 
         [self setUpMetalResourcesWithCapacity:capacity];
-        if (!_states) {
-            _states = calloc(capacity, sizeof(SSKParticleState));
+        if (!_core) {
+            _core = SSKParticleCoreCreate((uint32_t)capacity);
+        }
+        if (!_core) {
+            return nil;
+        }
+        // One participant still steps through the scheduler, so the result
+        // is the same for every `workerCount`.
+        _parallel = SSKParticleParallelCreate((uint32_t)capacity, 1);
+        if (_parallel) {
+            _parallel->serialThreshold = (uint32_t)MIN(_parallelThreshold, (NSUInteger)UINT32_MAX);
         }
 
         for (NSUInteger i = 0; i < capacity; i++) {
-            _states[i] = (SSKParticleState){0};
-            _states[i].size = 1.0f;
-            _states[i].baseSize = 1.0f;
-            _states[i].maxLife = 1.0f;
-            _states[i].color = (vector_float4){1,1,1,1};
-            _states[i].baseColor = (vector_float4){1,1,1,1};
-            _states[i].sizeRange = (vector_float2){1,1};
-            SSKParticle *particle = [[SSKParticle alloc] initWithState:&_states[i] index:i];
+            SSKParticle *particle = [[SSKParticle alloc] initWithCore:_core index:(uint32_t)i];
             [_particles addObject:particle];
         }
 
@@ -349,11 +436,50 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
 }
 
 - (void)dealloc {
-    if (!self.particleBuffer && self.states) {
-        free(self.states);
+    SSKFrameRingDestroy(_frameRing);
+    SSKParticleParallelDestroy(_parallel);
+    SSKSpatialGridDestroy(_spatialGrid);
+    free(_spatialGrid);
+    SSKParticleRasterizerDestroy(_rasterizer);
+    free(_rasterizer);
+    SSKParticleCoreDestroy(_core);
+}
+
+- (void)setWorkerCount:(NSUInteger)workerCount {
+    if (_workerCount == workerCount) { return; }
+    _workerCount = workerCount;
+    SSKParticleParallelDestroy(_parallel);
+    _parallel = SSKParticleParallelCreate((uint32_t)self.capacity, (uint32_t)MIN(workerCount, (NSUInteger)UINT32_MAX));
+    if (_parallel) {
+        _parallel->serialThreshold = (uint32_t)MIN(self.parallelThreshold, (NSUInteger)UINT32_MAX);
+    }
+}
+
+- (void)setParallelThreshold:(NSUInteger)parallelThreshold {
+    _parallelThreshold = parallelThreshold;
+    if (_parallel) {
+        _parallel->serialThreshold = (uint32_t)MIN(parallelThreshold, (NSUInteger)UINT32_MAX);
     }
 }
 
+- (void)setMaxFramesInFlight:(NSUInteger)maxFramesInFlight {
+    maxFramesInFlight = MAX(maxFramesInFlight, (NSUInteger)1);
+    if (_maxFramesInFlight == maxFramesInFlight) { return; }
+    _maxFramesInFlight = maxFramesInFlight;
+    if (!_frameRing) { return; }
+    // Destroying the ring waits for every step still on the GPU.
+    SSKFrameRingDestroy(_frameRing);
+    _frameRing = SSKMetalFrameRingCreate(self.metalDevice, maxFramesInFlight, [self frameArenaLength]);
+}
+
+/// Bytes one simulation step takes from the frame ring.
+- (size_t)frameArenaLength {
+    // Uniforms, dead list and a small force-field list; longer lists make the
+    // ring grow its arena on demand.
+    return 2 * kSSKParticleFrameAlignment + kSSKParticleDeadListHeaderLength + sizeof(uint32_t) * self.capacity +
+           sizeof(SSKForceField) * 8;
+}
+
 - (void)setUpMetalResourcesWithCapacity:(NSUInteger)capacity {
     id<MTLDevice> device = MTLCreateSystemDefaultDevice();
     if (!device) { return; }
@@ -361,115 +487,293 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
     id<MTLCommandQueue> queue = [device newCommandQueue];
     if (!queue) { return; }
 
-    NSError *error = nil;
-    NSString *source = [NSString stringWithFormat:kSSKParticleComputeTemplate,
-                        kSSKParticleBehaviorFadeAlpha,
-                        kSSKParticleBehaviorFadeSize];
-    id<MTLLibrary> library = [device newLibraryWithSource:source options:nil error:&error];
-    if (!library) {
-        NSLog(@"SSKParticleSystem: failed to compile Metal compute shaders: %@", error);
-        return;
-    }
-
-    id<MTLFunction> kernel = [library newFunctionWithName:@"simulateParticles"];
-    if (!kernel) { return; }
-
-    id<MTLComputePipelineState> pipeline = [device newComputePipelineStateWithFunction:kernel error:&error];
+    // The generic variant is always valid, so it is the only one built up
+    // front; systems created after the first reuse it from the shared cache.
+    id<MTLComputePipelineState> pipeline =
+        [SSKMetalShaderLibrary computePipelineForDevice:device
+                                           functionName:kSSKParticleStepKernelNames[SSKParticleStepKernelSimulate]
+                                          boolConstants:SSKParticleKernelFeatureAll
+                                          constantCount:SSKParticleKernelFeatureCount
+                                                   wait:YES];
     if (!pipeline) {
-        NSLog(@"SSKParticleSystem: failed to create compute pipeline: %@", error);
+        NSLog(@"SSKParticleSystem: no Metal simulation pipeline; is SSKParticleShaders.metallib in the bundle?");
         return;
     }
 
-    id<MTLBuffer> particleBuffer = [device newBufferWithLength:capacity * sizeof(SSKParticleState)
+    // All streams share one buffer; the core carves it up and the kernel binds
+    // each stream at its own offset.
+    size_t storageLength = SSKParticleCoreStorageSize((uint32_t)capacity);
+    id<MTLBuffer> particleBuffer = [device newBufferWithLength:storageLength
                                                        options:MTLResourceStorageModeShared];
     if (!particleBuffer) { return; }
 
-    id<MTLBuffer> uniformsBuffer = [device newBufferWithLength:sizeof(SSKParticleSimulationUniforms)
-                                                       options:MTLResourceStorageModeShared];
-    if (!uniformsBuffer) { return; }
+    SSKFrameRing *frameRing = SSKMetalFrameRingCreate(device, self.maxFramesInFlight, [self frameArenaLength]);
+    if (!frameRing) { return; }
+
+    SSKParticleCore *core = SSKParticleCoreCreateWithStorage((uint32_t)capacity, particleBuffer.contents, storageLength);
+    if (!core) {
+        SSKFrameRingDestroy(frameRing);
+        return;
+    }
 
     self.metalDevice = device;
     self.commandQueue = queue;
-    self.computePipeline = pipeline;
+    self.stepPipelines = [NSMutableDictionary dictionary];
+    [self storeStepPipeline:pipeline kernel:SSKParticleStepKernelSimulate variant:SSKParticleKernelFeatureAll];
     self.particleBuffer = particleBuffer;
-    self.uniformsBuffer = uniformsBuffer;
-    self.states = particleBuffer.contents;
+    self.frameRing = frameRing;
+    self.core = core;
     self.supportsMetalSimulation = YES;
 }
 
+- (void)storeStepPipeline:(id<MTLComputePipelineState>)pipeline
+                   kernel:(SSKParticleStepKernel)kernel
+                  variant:(uint32_t)variant {
+    self.stepPipelines[@(kernel * SSKParticleKernelVariantCount + variant)] = pipeline;
+    _readyStepVariants[kernel] |= 1u << variant;
+}
+
+/// Pipeline for one step of `kernel` with `params`: the variant specialised for
+/// what the particles and the step use once it is built, and the closest more
+/// general one until then. Building runs in the background, so a step never
+/// waits for a compile.
+- (nullable id<MTLComputePipelineState>)stepPipelineForKernel:(SSKParticleStepKernel)kernel
+                                                       params:(const SSKParticleSimParams *)params {
+    uint32_t features = SSKParticleKernelFeaturesForStep(self.core, params);
+    if (!(_readyStepVariants[kernel] & (1u << features))) {
+        id<MTLComputePipelineState> pipeline =
+            [SSKMetalShaderLibrary computePipelineForDevice:self.metalDevice
+                                               functionName:kSSKParticleStepKernelNames[kernel]
+                                              boolConstants:features
+                                              constantCount:SSKParticleKernelFeatureCount
+                                                       wait:NO];
+        if (pipeline) {
+            [self storeStepPipeline:pipeline kernel:kernel variant:features];
+        }
+    }
+    uint32_t variant = SSKParticleKernelSelectVariant(features, _readyStepVariants[kernel]);
+    if (variant == SSKParticleKernelNoVariant) { return nil; }
+    return self.stepPipelines[@(kernel * SSKParticleKernelVariantCount + variant)];
+}
+
 - (void)setUpdateHandler:(SSKParticleUpdater)updateHandler {
     _updateHandler = [updateHandler copy];
-    self.updateHandlerForcesCPU = (_updateHandler != nil);
-    if (self.updateHandlerForcesCPU) {
-        _metalSimulationEnabled = NO;
+    [self updateSimulationPath];
+}
+
+/// Custom updaters and the neighbour index both need the particles on the CPU
+/// every step, so either one turns Metal simulation off.
+- (void)updateSimulationPath {
+    self.simulationForcesCPU = (_updateHandler != nil || self.neighborIndexEnabled);
+    if (self.simulationForcesCPU) {
+        [self setMetalSimulationEnabled:NO];
     } else if (self.supportsMetalSimulation) {
         _metalSimulationEnabled = YES;
         [self markAllStatesDirty];
     }
 }
 
+- (BOOL)isFlockingEnabled {
+    SSKParticleFlocking flocking = self.flocking;
+    return (flocking.radius > 0.0 && flocking.cohesion != 0.0) ||
+           (flocking.separationRadius > 0.0 && flocking.separation != 0.0);
+}
+
+- (BOOL)neighborIndexEnabled {
+    return self.neighborCellSize > 0.0 || [self isFlockingEnabled];
+}
+
+- (void)setNeighborCellSize:(CGFloat)neighborCellSize {
+    BOOL wasEnabled = self.neighborIndexEnabled;
+    _neighborCellSize = MAX(neighborCellSize, 0.0);
+    if (self.neighborIndexEnabled != wasEnabled) {
+        [self updateSimulationPath];
+    }
+}
+
+- (void)setFlocking:(SSKParticleFlocking)flocking {
+    BOOL wasEnabled = self.neighborIndexEnabled;
+    _flocking = flocking;
+    if (self.neighborIndexEnabled != wasEnabled) {
+        [self updateSimulationPath];
+    }
+}
+
+/// Rebins the live particles, or returns NULL when the index is disabled.
+- (SSKSpatialGrid *)rebuildNeighborIndex {
+    if (!self.neighborIndexEnabled) { return NULL; }
+    if (!_spatialGrid) {
+        SSKSpatialGrid *grid = calloc(1, sizeof(SSKSpatialGrid));
+        if (!grid || !SSKSpatialGridInit(grid, (uint32_t)self.capacity)) {
+            SSKSpatialGridDestroy(grid);
+            free(grid);
+            return NULL;
+        }
+        _spatialGrid = grid;
+    }
+    CGFloat cellSize = self.neighborCellSize;
+    if (cellSize <= 0.0) {
+        cellSize = MAX(self.flocking.radius, self.flocking.separationRadius);
+    }
+    SSKSpatialGridBuild(_spatialGrid, self.core, (float)cellSize);
+    return _spatialGrid;
+}
+
+typedef struct {
+    const SSKParticleCore *core;
+    __unsafe_unretained NSArray<SSKParticle *> *particles;
+    __unsafe_unretained void (^block)(SSKParticle *particle, CGFloat distance, BOOL *stop);
+} SSKParticleNeighborVisit;
+
+static bool SSKParticleSystemVisitNeighbor(void *context, uint32_t slot, SSKFloat2 offset, float distanceSquared) {
+    (void)offset;
+    SSKParticleNeighborVisit *visit = context;
+    // The index is a snapshot; skip particles that have died since.
+    if (!visit->core->alive[slot]) { return true; }
+    BOOL stop = NO;
+    visit->block(visit->particles[slot], sqrt((CGFloat)distanceSquared), &stop);
+    return !stop;
+}
+
+- (BOOL)enumerateNeighborsOfPoint:(NSPoint)point
+                           radius:(CGFloat)radius
+                       usingBlock:(void (NS_NOESCAPE ^)(SSKParticle *particle, CGFloat distance, BOOL *stop))block {
+    if (!block || !self.neighborIndexEnabled) { return NO; }
+    if (!self.spatialGrid) { return YES; }
+    SSKParticleNeighborVisit visit = {self.core, self.particles, block};
+    SSKSpatialGridForEachNeighbour(self.spatialGrid, SSKFloat2Make((float)point.x, (float)point.y), (float)radius,
+                                   SSKParticleSystemVisitNeighbor, &visit);
+    return YES;
+}
+
+- (NSUInteger)addForceField:(SSKParticleForceField)field {
+    if (!self.forceFieldData) {
+        self.forceFieldData = [NSMutableData data];
+    }
+    SSKForceField coreField = SSKForceFieldFromParticleForceField(field);
+    [self.forceFieldData appendBytes:&coreField length:sizeof(coreField)];
+    return self.forceFieldCount - 1;
+}
+
+- (void)replaceForceFieldAtIndex:(NSUInteger)index withForceField:(SSKParticleForceField)field {
+    NSParameterAssert(index < self.forceFieldCount);
+    if (index >= self.forceFieldCount) { return; }
+    SSKForceField coreField = SSKForceFieldFromParticleForceField(field);
+    [self.forceFieldData replaceBytesInRange:NSMakeRange(index * sizeof(coreField), sizeof(coreField))
+                                   withBytes:&coreField];
+}
+
+- (void)removeAllForceFields {
+    self.forceFieldData.length = 0;
+}
+
+- (NSUInteger)forceFieldCount {
+    return self.forceFieldData.length / sizeof(SSKForceField);
+}
+
+- (SSKForceFieldParams)forceFieldParamsForDelta:(NSTimeInterval)dt {
+    SSKForceFieldParams params;
+    params.fields = self.forceFieldData.bytes;
+    params.count = (uint32_t)self.forceFieldCount;
+    params.time = (float)self.simulationTime;
+    params.dt = (float)dt;
+    return params;
+}
+
 - (void)setMetalSimulationEnabled:(BOOL)metalSimulationEnabled {
-    if (!self.supportsMetalSimulation || self.updateHandlerForcesCPU) {
+    BOOL wasEnabled = _metalSimulationEnabled;
+    if (!self.supportsMetalSimulation || self.simulationForcesCPU) {
         _metalSimulationEnabled = NO;
-        return;
+    } else {
+        _metalSimulationEnabled = metalSimulationEnabled;
     }
-    _metalSimulationEnabled = metalSimulationEnabled;
     if (_metalSimulationEnabled) {
         [self markAllStatesDirty];
+    } else if (wasEnabled) {
+        [self synchronizeResidentState];
+        [self finishMetalSteps];
+    }
+}
+
+- (void)setResidentSimulationEnabled:(BOOL)residentSimulationEnabled {
+    _residentSimulationEnabled = residentSimulationEnabled;
+    if (!residentSimulationEnabled) {
+        [self synchronizeResidentState];
     }
 }
 
+- (BOOL)isResidentSimulationActive {
+    return self.residentSimulationEnabled && self.isMetalSimulationEnabled && self.supportsMetalSimulation &&
+           !self.residentSetUpFailed;
+}
+
 - (NSUInteger)aliveParticleCount {
-    NSUInteger count = 0;
-    for (NSUInteger i = 0; i < self.capacity; i++) {
-        if (self.states[i].alive) { count++; }
+    if (self.residentLoaded) {
+        // Written by the last finished step; a single aligned word, so never torn.
+        const SSKParticleLifecycleState *state = self.lifecycleStateBuffer.contents;
+        return state->drawArgs[1];
     }
-    return count;
+    return self.core->aliveCount;
 }
 
 - (void)spawnParticles:(NSUInteger)count initializer:(SSKParticleInitializer)initializer {
     if (count == 0 || !initializer) { return; }
-    NSUInteger emitted = 0;
-    while (emitted < count) {
-        NSUInteger index = [self.availableIndices firstIndex];
-        if (index == NSNotFound) { break; }
-        [self.availableIndices removeIndex:index];
-
-        SSKParticleState *state = &self.states[index];
-        *state = (SSKParticleState){0};
-        state->alive = 1u;
-        state->size = 1.0f;
-        state->baseSize = 1.0f;
-        state->maxLife = 1.0f;
-        state->color = (vector_float4){1,1,1,1};
-        state->baseColor = (vector_float4){1,1,1,1};
-        state->sizeRange = (vector_float2){1,1};
-
-        SSKParticle *particle = self.particles[index];
-        particle.state = state;
-        particle.life = 0.0;
-        particle.position = NSZeroPoint;
-        particle.velocity = NSZeroPoint;
-        particle.color = [NSColor whiteColor];
-        particle.rotation = 0.0;
-        particle.rotationVelocity = 0.0;
-        particle.damping = 0.0;
-        particle.userScalar = 0.0;
-        particle.userVector = NSZeroPoint;
-        particle.baseSize = 1.0;
-        particle.sizeVelocity = 0.0;
-        particle.sizeOverLifeRange = SSKScalarRangeMake(1.0, 1.0);
-        particle.behaviorOptions = SSKParticleBehaviorOptionNone;
-
+    // Initializers run on the CPU, so resident mode hands liveness back first.
+    [self synchronizeResidentState];
+    [self waitForMetalSteps];
+    SSKParticleCore *core = self.core;
+    uint32_t request = (uint32_t)MIN(count, (NSUInteger)core->slots.freeCount);
+    if (request == 0) { return; }
+
+    uint32_t firstListIndex = core->aliveCount;
+    uint32_t emitted = SSKParticleCoreSpawn(core, request, NULL);
+    for (uint32_t i = 0; i < emitted; i++) {
+        uint32_t slot = core->aliveList[firstListIndex + i];
+        SSKParticle *particle = self.particles[slot];
         initializer(particle);
-        if (particle.baseSize <= 0.0) {
-            particle.baseSize = particle.size;
+        if (core->baseSize[slot] <= 0.0f) {
+            core->baseSize[slot] = core->size[slot];
         }
-        [self markStateDirtyAtIndex:index];
-        emitted++;
+    }
+    if (emitted > 0) {
+        [self markAllStatesDirty];
     }
 }
 
+- (NSUInteger)emitParticles:(NSUInteger)count emission:(SSKParticleEmission)emission {
+    if (count == 0) { return 0; }
+    SSKParticleEmitter emitter = SSKParticleEmitterFromEmission(&emission);
+    SSKRandom random = self.emissionRandom;
+    uint32_t request = (uint32_t)MIN(count, (NSUInteger)UINT32_MAX);
+    if (self.isResidentSimulationActive) {
+        // The emit kernel of the next step claims the slots; it seeds one
+        // generator per particle from this.
+        uint64_t seed = (uint64_t)SSKRandomNext(&random) << 32 | SSKRandomNext(&random);
+        self.emissionRandom = random;
+        if (!self.pendingEmissions) {
+            self.pendingEmissions = [NSMutableData data];
+        }
+        // The kernel writes these particles, so record what they use here.
+        self.core->usedBehaviorFlags |= emitter.behaviorFlags;
+        self.core->usedDamping |= emitter.damping != 0.0f;
+        SSKParticlePendingEmission pending = {emitter, request, seed};
+        [self.pendingEmissions appendBytes:&pending length:sizeof(pending)];
+        return MIN(request, (uint32_t)self.capacity);
+    }
+    [self waitForMetalSteps];
+    uint32_t emitted = SSKParticleCoreEmit(self.core, &emitter, request, &random, NULL);
+    self.emissionRandom = random;
+    if (emitted > 0) {
+        [self markAllStatesDirty];
+    }
+    return emitted;
+}
+
+- (void)setEmissionSeed:(uint64_t)emissionSeed {
+    _emissionSeed = emissionSeed;
+    self.emissionRandom = SSKRandomMake(emissionSeed);
+}
+
 - (void)advanceBy:(NSTimeInterval)dt {
     if (dt <= 0.0) { return; }
     if (self.isMetalSimulationEnabled && self.supportsMetalSimulation) {
@@ -477,69 +781,134 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
     } else {
         [self advanceOnCPU:dt];
     }
+    self.simulationTime += dt;
 }
 
-- (void)advanceOnCPU:(NSTimeInterval)dt {
-    vector_float2 gravityVec = SSKVectorFromPoint(self.gravity);
-    BOOL hasGravity = !simd_equal(gravityVec, (vector_float2){0, 0});
-
-    for (NSUInteger idx = 0; idx < self.capacity; idx++) {
-        SSKParticleState *state = &self.states[idx];
-        if (!state->alive) { continue; }
-
-        state->life += (float)dt;
-        if (state->life >= state->maxLife) {
-            state->alive = 0u;
-            [self.availableIndices addIndex:idx];
-            continue;
-        }
-
-        if (hasGravity) {
-            state->velocity += gravityVec * (float)dt;
-        }
-
-        float damping = fmaxf(0.0f, state->damping + (float)self.globalDamping);
-        if (damping > 0.0f) {
-            float factor = powf(fmaxf(0.0f, 1.0f - damping), (float)dt);
-            state->velocity *= factor;
-        }
+- (SSKParticleSimParams)simulationParamsForDelta:(NSTimeInterval)dt {
+    SSKParticleSimParams params;
+    params.gravity = SSKFloat2Make((float)self.gravity.x, (float)self.gravity.y);
+    params.dt = (float)dt;
+    params.globalDamping = (float)self.globalDamping;
+    return params;
+}
 
-        if (self.updateHandler) {
-            self.updateHandler(self.particles[idx], dt);
+- (void)advanceOnCPU:(NSTimeInterval)dt {
+    SSKParticleCore *core = self.core;
+    SSKParticleSimParams params = [self simulationParamsForDelta:dt];
+    SSKSpatialGrid *grid = [self rebuildNeighborIndex];
+    if (grid && [self isFlockingEnabled]) {
+        SSKParticleFlocking flocking = self.flocking;
+        SSKParticleFlockingParams flockingParams = {
+            (float)flocking.radius, (float)flocking.separationRadius,
+            (float)flocking.separation, (float)flocking.cohesion
+        };
+        SSKParticleCoreApplyFlocking(core, grid, &flockingParams, params.dt);
+    }
+    // Fields run as their own sweeps around the step, so every step kernel
+    // (scalar, vector or parallel) stays unchanged.
+    SSKForceFieldParams fieldParams = [self forceFieldParamsForDelta:dt];
+    if (fieldParams.count > 0) {
+        SSKParticleParallelApplyForceFields(self.parallel, core, &fieldParams);
+    }
+    SSKParticleUpdater updateHandler = self.updateHandler;
+    if (!updateHandler) {
+        SSKParticleParallelAdvance(self.parallel, core, &params);
+        if (fieldParams.count > 0) {
+            SSKParticleParallelResolveForceFieldBounds(self.parallel, core, &fieldParams);
         }
+        return;
+    }
 
-        [self applyAutomaticBehavioursToState:state delta:dt];
-
-        state->position += state->velocity * (float)dt;
-        state->rotation += state->rotationVelocity * (float)dt;
-
-        float velocityLengthSquared = simd_length_squared(state->velocity);
-        if (velocityLengthSquared > 0.0001f) {
-            state->userVector = simd_normalize(state->velocity);
-        }
+    // Custom updaters run between the force and behaviour phases, matching the
+    // order the per-particle loop used before the core was split into phases.
+    SSKParticleCoreExpire(core, params.dt);
+    SSKParticleCoreApplyForces(core, &params);
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        updateHandler(self.particles[core->aliveList[i]], dt);
+    }
+    SSKParticleCoreApplyBehaviours(core, params.dt);
+    SSKParticleCoreIntegrate(core, params.dt);
+    SSKParticleCoreUpdateDirections(core);
+    if (fieldParams.count > 0) {
+        SSKParticleParallelResolveForceFieldBounds(self.parallel, core, &fieldParams);
     }
 }
 
 - (void)advanceWithMetal:(NSTimeInterval)dt {
-    if (!self.computePipeline || !self.commandQueue || !self.particleBuffer || !self.uniformsBuffer) {
+    if (self.stepPipelines.count == 0 || !self.commandQueue || !self.particleBuffer || !self.frameRing) {
+        [self advanceOnCPU:dt];
+        return;
+    }
+    if (self.isResidentSimulationActive && [self loadResidentState]) {
+        [self advanceResident:dt];
+        return;
+    }
+    SSKParticleSimParams params = [self simulationParamsForDelta:dt];
+    id<MTLComputePipelineState> pipeline = [self stepPipelineForKernel:SSKParticleStepKernelSimulate params:&params];
+    if (!pipeline) {
+        if (self.metalStepsOutstanding) { [self finishMetalSteps]; }
+        [self advanceOnCPU:dt];
+        return;
+    }
+
+    // Waits while `maxFramesInFlight` earlier steps are still on the GPU.
+    id<MTLCommandBuffer> commandBuffer = [self.commandQueue commandBuffer];
+    SSKFrameRing *frameRing = self.frameRing;
+    uint64_t frame = SSKFrameRingBeginFrame(frameRing);
+    uint32_t capacity = (uint32_t)self.capacity;
+    SSKForceFieldParams fieldParams = [self forceFieldParamsForDelta:dt];
+    SSKFrameAllocation uniformsAllocation;
+    SSKFrameAllocation deadListAllocation;
+    SSKFrameAllocation fieldsAllocation;
+    BOOL allocated = SSKFrameRingAllocate(frameRing, sizeof(SSKParticleSimulationUniforms),
+                                          kSSKParticleFrameAlignment, &uniformsAllocation) &&
+                     SSKFrameRingAllocate(frameRing, kSSKParticleDeadListHeaderLength + sizeof(uint32_t) * capacity,
+                                          kSSKParticleFrameAlignment, &deadListAllocation) &&
+                     SSKFrameRingAllocate(frameRing, sizeof(SSKForceField) * MAX(fieldParams.count, 1u),
+                                          kSSKParticleFrameAlignment, &fieldsAllocation);
+    SSKFrameRingEndFrame(frameRing);
+    if (!allocated) {
+        // Frames retire in order, so the empty frame still goes through the queue.
+        SSKMetalFrameRingRetireOnCompletion(frameRing, frame, commandBuffer);
+        [commandBuffer commit];
+        if (self.metalStepsOutstanding) { [self finishMetalSteps]; }
         [self advanceOnCPU:dt];
         return;
     }
 
-    SSKParticleSimulationUniforms *uniforms = self.uniformsBuffer.contents;
-    uniforms->gravity = SSKVectorFromPoint(self.gravity);
+    SSKParticleSimulationUniforms *uniforms = uniformsAllocation.contents;
+    uniforms->gravity = (vector_float2){(float)self.gravity.x, (float)self.gravity.y};
     uniforms->dt = (float)dt;
     uniforms->globalDamping = (float)self.globalDamping;
-    uniforms->padding = 0.0f;
+    uniforms->capacity = capacity;
+    uniforms->fieldCount = fieldParams.count;
+    uniforms->time = fieldParams.time;
+    *(uint32_t *)deadListAllocation.contents = 0u;
+    if (fieldParams.count > 0) {
+        memcpy(fieldsAllocation.contents, fieldParams.fields, sizeof(SSKForceField) * fieldParams.count);
+    }
 
-    id<MTLCommandBuffer> commandBuffer = [self.commandQueue commandBuffer];
     id<MTLComputeCommandEncoder> encoder = [commandBuffer computeCommandEncoder];
-    [encoder setComputePipelineState:self.computePipeline];
-    [encoder setBuffer:self.particleBuffer offset:0 atIndex:0];
-    [encoder setBuffer:self.uniformsBuffer offset:0 atIndex:1];
+    [encoder setComputePipelineState:pipeline];
+    for (NSUInteger stream = 0; stream < SSKParticleStreamSimulatedCount; stream++) {
+        NSUInteger offset = SSKParticleCoreStreamOffset((uint32_t)self.capacity, (SSKParticleStream)stream);
+        [encoder setBuffer:self.particleBuffer offset:offset atIndex:stream];
+    }
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(uniformsAllocation)
+                offset:uniformsAllocation.offset
+               atIndex:kSSKParticleUniformsBufferIndex];
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(deadListAllocation)
+                offset:deadListAllocation.offset
+               atIndex:kSSKParticleDeadCountBufferIndex];
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(deadListAllocation)
+                offset:deadListAllocation.offset + kSSKParticleDeadListHeaderLength
+               atIndex:kSSKParticleDeadSlotsBufferIndex];
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(fieldsAllocation)
+                offset:fieldsAllocation.offset
+               atIndex:kSSKParticleForceFieldsBufferIndex];
 
     NSUInteger threadCount = self.capacity;
-    NSUInteger threadGroupSize = MIN(self.computePipeline.maxTotalThreadsPerThreadgroup, 128);
+    NSUInteger threadGroupSize = MIN(pipeline.maxTotalThreadsPerThreadgroup, 128);
     if (threadGroupSize == 0) {
         threadGroupSize = 1;
     }
@@ -549,47 +918,291 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
     [encoder dispatchThreadgroups:threadgroupCount threadsPerThreadgroup:threadsPerGroup];
     [encoder endEncoding];
 
+    // Copy the dead list out before retiring its frame, then hand it to the
+    // allocator on the main queue where spawning happens. Only the slots that
+    // actually died are touched; nothing rescans the capacity. The ring outlives
+    // this handler because destroying it waits for the frame to retire.
     __weak typeof(self) weakSelf = self;
+    const char *entry = deadListAllocation.contents;
+    uint64_t generation = self.slotGeneration;
     [commandBuffer addCompletedHandler:^(__unused id<MTLCommandBuffer> buffer) {
-        __strong typeof(self) strongSelf = weakSelf;
-        if (!strongSelf) { return; }
+        uint32_t deadCount = MIN(*(const uint32_t *)entry, capacity);
+        NSData *deadSlots = nil;
+        if (deadCount > 0) {
+            deadSlots = [NSData dataWithBytes:entry + kSSKParticleDeadListHeaderLength
+                                       length:sizeof(uint32_t) * deadCount];
+        }
+        SSKFrameRingRetire(frameRing, frame);
+        if (!deadSlots) { return; }
         dispatch_async(dispatch_get_main_queue(), ^{
-            for (NSUInteger idx = 0; idx < strongSelf.capacity; idx++) {
-                if (!strongSelf.states[idx].alive) {
-                    [strongSelf.availableIndices addIndex:idx];
-                }
-            }
+            __strong typeof(self) strongSelf = weakSelf;
+            if (!strongSelf || strongSelf.slotGeneration != generation) { return; }
+            SSKParticleCoreRetireSlots(strongSelf.core, deadSlots.bytes, deadCount);
         });
     }];
 
     [commandBuffer commit];
+    self.metalStepsOutstanding = YES;
+    self.metalStepsInFlight = YES;
+}
+
+/// Blocks until the non-resident Metal steps already committed have finished,
+/// so the CPU can read or write the particle streams they update. Liveness
+/// stays with them: their dead lists still reach the allocator through the
+/// main queue.
+- (void)waitForMetalSteps {
+    if (!self.metalStepsInFlight) { return; }
+    SSKFrameRingWaitIdle(self.frameRing);
+    self.metalStepsInFlight = NO;
 }
 
-- (void)applyAutomaticBehavioursToState:(SSKParticleState *)state delta:(NSTimeInterval)dt {
-    if (fabsf(state->sizeVelocity) > 0.0001f) {
-        state->size = fmaxf(0.0f, state->size + state->sizeVelocity * (float)dt);
+/// Hands liveness back to the CPU after non-resident Metal steps: waits for
+/// the steps in flight, which still write the particle streams, then rebuilds
+/// the alive list and allocator from the `alive` stream. Dead lists those steps
+/// queued for the main thread are dropped; the rebuild already covers them.
+- (void)finishMetalSteps {
+    if (self.frameRing) {
+        SSKFrameRingWaitIdle(self.frameRing);
     }
+    self.metalStepsOutstanding = NO;
+    self.metalStepsInFlight = NO;
+    self.slotGeneration++;
+    SSKParticleCoreRebuildAliveList(self.core);
+}
 
-    if (state->behaviorFlags == 0u) { return; }
+/// Creates the resident pipelines and buffers the first time the mode is used.
+/// Returns NO, and turns the mode off for good, when the device cannot run it.
+- (BOOL)setUpResidentResources {
+    if (self.residentSetUp) { return YES; }
+    if (self.residentSetUpFailed) { return NO; }
+    id<MTLDevice> device = self.metalDevice;
+    uint32_t capacity = (uint32_t)self.capacity;
+    NSArray<NSString *> *names = @[@"emitParticles", @"commitEmission", @"prepareSimulation",
+                                   kSSKParticleStepKernelNames[SSKParticleStepKernelResident], @"finalizeSimulation"];
+    NSMutableArray<id<MTLComputePipelineState>> *pipelines = [NSMutableArray arrayWithCapacity:names.count];
+    for (NSString *name in names) {
+        BOOL step = [name isEqualToString:kSSKParticleStepKernelNames[SSKParticleStepKernelResident]];
+        id<MTLComputePipelineState> pipeline =
+            [SSKMetalShaderLibrary computePipelineForDevice:device
+                                               functionName:name
+                                              boolConstants:step ? SSKParticleKernelFeatureAll : 0
+                                              constantCount:step ? SSKParticleKernelFeatureCount : 0
+                                                       wait:YES];
+        if (!pipeline || pipeline.maxTotalThreadsPerThreadgroup < SSKParticleLifecycleThreadgroupWidth) {
+            NSLog(@"SSKParticleSystem: resident simulation unavailable (%@).", name);
+            self.residentSetUpFailed = YES;
+            return NO;
+        }
+        [pipelines addObject:pipeline];
+    }
+    // The CPU loads the lists and reads the counters, so both stay shared; the
+    // instances are only ever touched by the GPU.
+    id<MTLBuffer> stateBuffer = [device newBufferWithLength:sizeof(SSKParticleLifecycleState)
+                                                    options:MTLResourceStorageModeShared];
+    id<MTLBuffer> listBuffer = [device newBufferWithLength:3 * sizeof(uint32_t) * capacity
+                                                   options:MTLResourceStorageModeShared];
+    id<MTLBuffer> instanceBuffer = [device newBufferWithLength:sizeof(SSKParticleInstance) * capacity
+                                                       options:MTLResourceStorageModePrivate];
+    id<MTLEvent> event = [device newEvent];
+    if (!stateBuffer || !listBuffer || !instanceBuffer || !event) {
+        NSLog(@"SSKParticleSystem: failed to allocate resident simulation buffers.");
+        self.residentSetUpFailed = YES;
+        return NO;
+    }
+    self.emitPipeline = pipelines[0];
+    self.commitEmissionPipeline = pipelines[1];
+    self.preparePipeline = pipelines[2];
+    [self storeStepPipeline:pipelines[3] kernel:SSKParticleStepKernelResident variant:SSKParticleKernelFeatureAll];
+    self.finalizePipeline = pipelines[4];
+    self.lifecycleStateBuffer = stateBuffer;
+    self.lifecycleListBuffer = listBuffer;
+    self.residentInstanceBuffer = instanceBuffer;
+    self.residentEvent = event;
+    self.residentEventValue = 0;
+    self.residentSetUp = YES;
+    return YES;
+}
 
-    float normalized = (state->maxLife > 0.0f) ? fminf(fmaxf(state->life / state->maxLife, 0.0f), 1.0f) : 0.0f;
+/// Hands liveness to the GPU: waits for the steps in flight (whose dead lists
+/// would otherwise be retired into the allocator later) and fills the lists
+/// from the `alive` stream.
+- (BOOL)loadResidentState {
+    if (self.residentLoaded) { return YES; }
+    if (![self setUpResidentResources]) {
+        // Emissions queued before the set-up failed go out on the CPU.
+        [self synchronizeResidentState];
+        return NO;
+    }
+    SSKFrameRingWaitIdle(self.frameRing);
+    self.metalStepsOutstanding = NO;
+    self.metalStepsInFlight = NO;
+    self.slotGeneration++;
+    uint32_t capacity = (uint32_t)self.capacity;
+    uint32_t *lists = self.lifecycleListBuffer.contents;
+    SSKParticleLifecycle lifecycle = {
+        self.lifecycleStateBuffer.contents, {lists, lists + capacity}, lists + 2 * capacity, capacity,
+    };
+    SSKParticleLifecycleLoad(&lifecycle, self.core->alive);
+    self.residentList = 0;
+    self.residentInstancesReady = NO;
+    self.residentLoaded = YES;
+    return YES;
+}
 
-    if ((state->behaviorFlags & kSSKParticleBehaviorFadeAlpha) != 0u) {
-        float fade = 1.0f - normalized;
-        state->color = (vector_float4){state->baseColor.x,
-                                       state->baseColor.y,
-                                       state->baseColor.z,
-                                       state->baseColor.w * fade};
+/// One resident step: the queued emissions, then prepare, the indirect simulate
+/// dispatch and finalize, all in one encoder. Nothing is read back.
+- (void)advanceResident:(NSTimeInterval)dt {
+    SSKParticleSimParams stepParams = [self simulationParamsForDelta:dt];
+    id<MTLComputePipelineState> stepPipeline = [self stepPipelineForKernel:SSKParticleStepKernelResident
+                                                                    params:&stepParams];
+    id<MTLCommandBuffer> commandBuffer = [self.commandQueue commandBuffer];
+    SSKFrameRing *frameRing = self.frameRing;
+    uint64_t frame = SSKFrameRingBeginFrame(frameRing);
+    uint32_t capacity = (uint32_t)self.capacity;
+    SSKForceFieldParams fieldParams = [self forceFieldParamsForDelta:dt];
+    SSKFrameAllocation uniformsAllocation;
+    SSKFrameAllocation fieldsAllocation;
+    BOOL allocated = SSKFrameRingAllocate(frameRing, sizeof(SSKParticleSimulationUniforms),
+                                          kSSKParticleFrameAlignment, &uniformsAllocation) &&
+                     SSKFrameRingAllocate(frameRing, sizeof(SSKForceField) * MAX(fieldParams.count, 1u),
+                                          kSSKParticleFrameAlignment, &fieldsAllocation);
+    SSKFrameRingEndFrame(frameRing);
+    SSKMetalFrameRingRetireOnCompletion(frameRing, frame, commandBuffer);
+    if (!allocated) {
+        // The CPU cannot step particles the GPU owns; skip the step instead.
+        [commandBuffer commit];
+        return;
     }
 
-    if ((state->behaviorFlags & kSSKParticleBehaviorFadeSize) != 0u) {
-        float multiplier = state->sizeRange.x + (state->sizeRange.y - state->sizeRange.x) * normalized;
-        state->size = fmaxf(0.0f, state->baseSize * multiplier);
+    SSKParticleSimulationUniforms *uniforms = uniformsAllocation.contents;
+    uniforms->gravity = (vector_float2){(float)self.gravity.x, (float)self.gravity.y};
+    uniforms->dt = (float)dt;
+    uniforms->globalDamping = (float)self.globalDamping;
+    uniforms->capacity = capacity;
+    uniforms->fieldCount = fieldParams.count;
+    uniforms->time = fieldParams.time;
+    if (fieldParams.count > 0) {
+        memcpy(fieldsAllocation.contents, fieldParams.fields, sizeof(SSKForceField) * fieldParams.count);
     }
+
+    // The previous draw of the instances must finish before they are rewritten.
+    if (self.residentEventValue > 0) {
+        [commandBuffer encodeWaitForEvent:self.residentEvent value:self.residentEventValue];
+    }
+
+    uint32_t list = self.residentList;
+    NSUInteger listLength = sizeof(uint32_t) * capacity;
+    id<MTLComputeCommandEncoder> encoder = [commandBuffer computeCommandEncoder];
+    for (NSUInteger stream = 0; stream < SSKParticleStreamSimulatedCount; stream++) {
+        NSUInteger offset = SSKParticleCoreStreamOffset(capacity, (SSKParticleStream)stream);
+        [encoder setBuffer:self.particleBuffer offset:offset atIndex:stream];
+    }
+    [encoder setBuffer:self.particleBuffer
+                offset:SSKParticleCoreStreamOffset(capacity, SSKParticleStreamUserScalar)
+               atIndex:kSSKParticleUserScalarBufferIndex];
+    [encoder setBuffer:self.lifecycleStateBuffer offset:0 atIndex:kSSKParticleLifecycleStateBufferIndex];
+    [encoder setBuffer:self.lifecycleListBuffer offset:list * listLength atIndex:kSSKParticleAliveInBufferIndex];
+    [encoder setBuffer:self.lifecycleListBuffer
+                offset:(list ^ 1u) * listLength
+               atIndex:kSSKParticleAliveOutBufferIndex];
+    [encoder setBuffer:self.lifecycleListBuffer offset:2 * listLength atIndex:kSSKParticleFreeSlotsBufferIndex];
+    [encoder setBuffer:self.residentInstanceBuffer offset:0 atIndex:kSSKParticleInstancesBufferIndex];
+
+    MTLSize single = MTLSizeMake(1, 1, 1);
+    MTLSize threadsPerGroup = MTLSizeMake(SSKParticleLifecycleThreadgroupWidth, 1, 1);
+    const SSKParticlePendingEmission *pending = self.pendingEmissions.bytes;
+    NSUInteger pendingCount = self.pendingEmissions.length / sizeof(SSKParticlePendingEmission);
+    for (NSUInteger i = 0; i < pendingCount; i++) {
+        uint32_t count = MIN(pending[i].count, capacity);
+        SSKParticleLifecycleParams params = {
+            count, list, (uint32_t)pending[i].seed, (uint32_t)(pending[i].seed >> 32),
+        };
+        [encoder setComputePipelineState:self.emitPipeline];
+        [encoder setBytes:&pending[i].emitter length:sizeof(SSKParticleEmitter) atIndex:kSSKParticleUniformsBufferIndex];
+        [encoder setBytes:&params length:sizeof(params) atIndex:kSSKParticleLifecycleParamsBufferIndex];
+        NSUInteger groups = (count + SSKParticleLifecycleThreadgroupWidth - 1) / SSKParticleLifecycleThreadgroupWidth;
+        [encoder dispatchThreadgroups:MTLSizeMake(groups, 1, 1) threadsPerThreadgroup:threadsPerGroup];
+        [encoder setComputePipelineState:self.commitEmissionPipeline];
+        [encoder dispatchThreadgroups:single threadsPerThreadgroup:single];
+    }
+    self.pendingEmissions.length = 0;
+
+    SSKParticleLifecycleParams params = {0, list, 0, 0};
+    [encoder setBytes:&params length:sizeof(params) atIndex:kSSKParticleLifecycleParamsBufferIndex];
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(uniformsAllocation)
+                offset:uniformsAllocation.offset
+               atIndex:kSSKParticleUniformsBufferIndex];
+    [encoder setBuffer:SSKMetalFrameAllocationBuffer(fieldsAllocation)
+                offset:fieldsAllocation.offset
+               atIndex:kSSKParticleForceFieldsBufferIndex];
+    [encoder setComputePipelineState:self.preparePipeline];
+    [encoder dispatchThreadgroups:single threadsPerThreadgroup:single];
+    [encoder setComputePipelineState:stepPipeline];
+    [encoder dispatchThreadgroupsWithIndirectBuffer:self.lifecycleStateBuffer
+                               indirectBufferOffset:offsetof(SSKParticleLifecycleState, dispatchArgs)
+                              threadsPerThreadgroup:threadsPerGroup];
+    [encoder setComputePipelineState:self.finalizePipeline];
+    [encoder dispatchThreadgroups:single threadsPerThreadgroup:single];
+    [encoder endEncoding];
+
+    self.residentEventValue += 1;
+    [commandBuffer encodeSignalEvent:self.residentEvent value:self.residentEventValue];
+    [commandBuffer commit];
+    self.residentList = list ^ 1u;
+    self.residentInstancesReady = YES;
+}
+
+/// Hands liveness back to the CPU after resident steps: waits for every step
+/// in flight, rebuilds the alive list and allocator from the `alive` stream and
+/// emits any queued emissions on the CPU. The next resident step reloads.
+- (void)synchronizeResidentState {
+    if (self.residentLoaded) {
+        SSKFrameRingWaitIdle(self.frameRing);
+        self.residentLoaded = NO;
+        self.residentInstancesReady = NO;
+        self.slotGeneration++;
+        SSKParticleCoreRebuildAliveList(self.core);
+    }
+    NSUInteger pendingCount = self.pendingEmissions.length / sizeof(SSKParticlePendingEmission);
+    if (pendingCount == 0) { return; }
+    const SSKParticlePendingEmission *pending = self.pendingEmissions.bytes;
+    for (NSUInteger i = 0; i < pendingCount; i++) {
+        SSKRandom random = SSKRandomMake(pending[i].seed);
+        SSKParticleCoreEmit(self.core, &pending[i].emitter, pending[i].count, &random, NULL);
+    }
+    self.pendingEmissions.length = 0;
+    [self markAllStatesDirty];
+}
+
+- (BOOL)beginResidentDrawWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer
+                            instanceBuffer:(id<MTLBuffer> _Nullable __autoreleasing *)instanceBuffer
+                           argumentsBuffer:(id<MTLBuffer> _Nullable __autoreleasing *)argumentsBuffer
+                           argumentsOffset:(NSUInteger *)argumentsOffset {
+    if (!commandBuffer || !instanceBuffer || !argumentsBuffer || !argumentsOffset) { return NO; }
+    if (!self.residentLoaded || !self.residentInstancesReady || commandBuffer.device != self.metalDevice) {
+        return NO;
+    }
+    [commandBuffer encodeWaitForEvent:self.residentEvent value:self.residentEventValue];
+    *instanceBuffer = self.residentInstanceBuffer;
+    *argumentsBuffer = self.lifecycleStateBuffer;
+    *argumentsOffset = offsetof(SSKParticleLifecycleState, drawArgs);
+    return YES;
+}
+
+- (void)endResidentDrawWithCommandBuffer:(id<MTLCommandBuffer>)commandBuffer {
+    if (!commandBuffer || !self.residentEvent) { return; }
+    self.residentEventValue += 1;
+    [commandBuffer encodeSignalEvent:self.residentEvent value:self.residentEventValue];
 }
 
 - (void)drawInContext:(CGContextRef)ctx {
     if (!ctx) { return; }
+    [self synchronizeResidentState];
+    [self waitForMetalSteps];
+    if (!self.renderHandler) {
+        [self rasterizeIntoContext:ctx];
+        return;
+    }
 
     CGContextSaveGState(ctx);
     if (self.blendMode == SSKParticleBlendModeAdditive) {
@@ -598,68 +1211,115 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
         CGContextSetBlendMode(ctx, kCGBlendModeNormal);
     }
 
-    for (NSUInteger idx = 0; idx < self.capacity; idx++) {
-        SSKParticleState *state = &self.states[idx];
-        if (!state->alive) { continue; }
-
-        SSKParticle *particle = self.particles[idx];
-        if (self.renderHandler) {
-            self.renderHandler(ctx, particle);
-            continue;
-        }
-
-        CGFloat size = MAX(0.0, particle.size);
-        CGRect rect = CGRectMake(particle.position.x - size * 0.5,
-                                 particle.position.y - size * 0.5,
-                                 size,
-                                 size);
-
-        NSColor *renderColor = particle.color ?: [NSColor whiteColor];
-        CGFloat blurScale = (self.blendMode == SSKParticleBlendModeAdditive) ? 0.9 : 0.6;
-        CGFloat blurRadius = size * blurScale;
-        CGColorRef blurColor = CGColorCreateCopyWithAlpha(renderColor.CGColor, renderColor.alphaComponent * 0.85);
-
-        CGContextSetFillColorWithColor(ctx, renderColor.CGColor);
-        if (blurColor) {
-            CGContextSetShadowWithColor(ctx, CGSizeZero, blurRadius, blurColor);
-        }
+    SSKParticleCore *core = self.core;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t idx = core->aliveList[i];
+        if (!core->alive[idx]) { continue; }
+        self.renderHandler(ctx, self.particles[idx]);
+    }
 
-        if (fabs(particle.rotation) > 0.001) {
-            CGContextSaveGState(ctx);
-            CGContextTranslateCTM(ctx, particle.position.x, particle.position.y);
-            CGContextRotateCTM(ctx, particle.rotation);
-            CGContextTranslateCTM(ctx, -particle.position.x, -particle.position.y);
-            CGContextFillEllipseInRect(ctx, rect);
-            CGContextRestoreGState(ctx);
-        } else {
-            CGContextFillEllipseInRect(ctx, rect);
-        }
+    CGContextRestoreGState(ctx);
+}
 
-        if (blurColor) {
-            CGContextSetShadowWithColor(ctx, CGSizeZero, 0.0, NULL);
-            CGColorRelease(blurColor);
-        }
+/// Default CPU path: the quads the Metal particle pass would draw, rendered by
+/// `SSKParticleRasterizer` over the clip bounds at device resolution and drawn
+/// into `ctx` as one premultiplied image.
+- (void)rasterizeIntoContext:(CGContextRef)ctx {
+    SSKParticleCore *core = self.core;
+    if (core->aliveCount == 0) { return; }
+    CGRect bounds = CGRectIntegral(CGContextGetClipBoundingBox(ctx));
+    if (CGRectIsEmpty(bounds) || CGRectIsInfinite(bounds)) { return; }
+    CGSize deviceUnit = CGContextConvertSizeToDeviceSpace(ctx, CGSizeMake(1.0, 1.0));
+    CGFloat scale = MAX(1.0, MAX(fabs(deviceUnit.width), fabs(deviceUnit.height)));
+    size_t width = (size_t)ceil(bounds.size.width * scale);
+    size_t height = (size_t)ceil(bounds.size.height * scale);
+    if (width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX) { return; }
+
+    if (!_rasterizer) {
+        SSKParticleRasterizer *rasterizer = calloc(1, sizeof(SSKParticleRasterizer));
+        if (!rasterizer) { return; }
+        SSKParticleRasterizerInit(rasterizer, 0);
+        _rasterizer = rasterizer;
     }
 
-    CGContextRestoreGState(ctx);
+    NSUInteger instanceLength = (NSUInteger)core->aliveCount * sizeof(SSKParticleInstance);
+    if (!self.rasterInstances) {
+        self.rasterInstances = [NSMutableData dataWithLength:instanceLength];
+    } else if (self.rasterInstances.length < instanceLength) {
+        self.rasterInstances.length = instanceLength;
+    }
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    SSKParticleInstance *instances = self.rasterInstances.mutableBytes;
+    uint32_t count = SSKParticleCoreWriteInstances(core, &style, instances, core->aliveCount);
+    if (count == 0) { return; }
+
+    size_t rowBytes = width * 4;
+    NSUInteger pixelLength = rowBytes * height;
+    if (!self.rasterPixels) {
+        self.rasterPixels = [NSMutableData dataWithLength:pixelLength];
+    } else if (self.rasterPixels.length < pixelLength) {
+        self.rasterPixels.length = pixelLength;
+    }
+    SSKRasterTarget target = {self.rasterPixels.mutableBytes, (uint32_t)width, (uint32_t)height, rowBytes, SSKRasterFormatRGBA8};
+    SSKRasterTargetClear(&target, (SSKFloat4){0.0f, 0.0f, 0.0f, 0.0f});
+    SSKParticleRasterParams params = {
+        SSKFloat2Make((float)bounds.origin.x, (float)bounds.origin.y),
+        SSKFloat2Make((float)bounds.size.width, (float)bounds.size.height),
+        self.blendMode == SSKParticleBlendModeAdditive ? SSKRasterBlendAdditive : SSKRasterBlendAlpha,
+    };
+    SSKTaskPool *pool = self.parallel ? self.parallel->pool : NULL;
+    if (!SSKParticleRasterizerDraw(_rasterizer, pool, &target, &params, instances, count)) { return; }
+
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    // The image gets its own copy: contexts that defer drawing (PDF, printing,
+    // asynchronous layers) can keep it past this call, and the next frame
+    // clears or reallocates the raster buffer.
+    NSData *pixels = [NSData dataWithBytes:target.pixels length:pixelLength];
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)pixels);
+    CGImageRef image = NULL;
+    if (colorSpace && provider) {
+        image = CGImageCreate(width, height, 8, 32, rowBytes, colorSpace,
+                              kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast,
+                              provider, NULL, false, kCGRenderingIntentDefault);
+    }
+    if (image) {
+        CGContextSaveGState(ctx);
+        CGContextSetBlendMode(ctx, self.blendMode == SSKParticleBlendModeAdditive ? kCGBlendModePlusLighter : kCGBlendModeNormal);
+        // Row 0 of the target maps to `bounds.origin.y`; flip so it is not drawn upside down.
+        CGContextTranslateCTM(ctx, 0.0, CGRectGetMinY(bounds) + CGRectGetMaxY(bounds));
+        CGContextScaleCTM(ctx, 1.0, -1.0);
+        CGContextSetInterpolationQuality(ctx, kCGInterpolationNone);
+        CGContextDrawImage(ctx, bounds, image);
+        CGContextRestoreGState(ctx);
+        CGImageRelease(image);
+    }
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
 }
 
 - (void)reset {
-    for (NSUInteger idx = 0; idx < self.capacity; idx++) {
-        SSKParticleState *state = &self.states[idx];
-        *state = (SSKParticleState){0};
-        state->size = 1.0f;
-        state->baseSize = 1.0f;
-        state->maxLife = 1.0f;
-        state->color = (vector_float4){1,1,1,1};
-        state->baseColor = (vector_float4){1,1,1,1};
-        state->sizeRange = (vector_float2){1,1};
-    }
-    [self.availableIndices removeAllIndexes];
-    [self.availableIndices addIndexesInRange:NSMakeRange(0, self.capacity)];
+    self.pendingEmissions.length = 0;
+    [self synchronizeResidentState];
+    if (self.metalStepsOutstanding) { [self finishMetalSteps]; }
+    self.slotGeneration++;
+    SSKParticleCoreReset(self.core);
+    if (self.spatialGrid) {
+        self.spatialGrid->count = 0;
+    }
     [self markAllStatesDirty];
 }
 
+- (uint64_t)stateChecksumWithHash:(uint64_t)hash {
+    [self synchronizeResidentState];
+    [self waitForMetalSteps];
+    SSKParticleCore *core = self.core;
+    size_t count = core->highWater;
+    hash = SSKReplayChecksum(hash, core->alive, count * sizeof(*core->alive));
+    hash = SSKReplayChecksum(hash, core->position, count * sizeof(*core->position));
+    hash = SSKReplayChecksum(hash, core->velocity, count * sizeof(*core->velocity));
+    return SSKReplayChecksum(hash, core->life, count * sizeof(*core->life));
+}
+
 - (NSArray<SSKParticle *> *)aliveParticlesSnapshot {
     NSMutableArray<SSKParticle *> *alive = self.aliveScratch;
     if (!alive) {
@@ -669,40 +1329,37 @@ static inline NSColor *SSKColorFromVector(vector_float4 v) {
     if (alive.count > 0) {
         [alive removeAllObjects];
     }
-    for (SSKParticle *particle in self.particles) {
-        if (particle.isAlive) {
-            [alive addObject:particle];
+    [self synchronizeResidentState];
+    [self waitForMetalSteps];
+    SSKParticleCore *core = self.core;
+    for (uint32_t i = 0; i < core->aliveCount; i++) {
+        uint32_t idx = core->aliveList[i];
+        if (core->alive[idx]) {
+            [alive addObject:self.particles[idx]];
         }
     }
     return alive;
 }
 
+- (NSUInteger)writeInstances:(void *)destination maxCount:(NSUInteger)maxCount {
+    if (!destination || maxCount == 0) { return 0; }
+    [self synchronizeResidentState];
+    [self waitForMetalSteps];
+    SSKParticleInstanceStyle style = SSKParticleInstanceStyleDefault();
+    uint32_t limit = (uint32_t)MIN(maxCount, (NSUInteger)UINT32_MAX);
+    return SSKParticleCoreWriteInstances(self.core, &style, destination, limit);
+}
+
 - (BOOL)renderWithMetalRenderer:(SSKMetalParticleRenderer *)renderer
                        blendMode:(SSKParticleBlendMode)blendMode
                     viewportSize:(CGSize)viewportSize {
     if (!renderer) { return NO; }
-
-    NSArray<SSKParticle *> *snapshot = [self aliveParticlesSnapshot];
-    return [renderer renderParticles:snapshot blendMode:blendMode viewportSize:viewportSize];
-}
-
-- (NSUInteger)stateStride {
-    return sizeof(SSKParticleState);
-}
-
-- (void)markStateDirtyAtIndex:(NSUInteger)index {
-    if (!self.particleBuffer) { return; }
-    NSUInteger stride = self.stateStride;
-    NSUInteger offset = index * stride;
-    if (offset + stride > self.particleBuffer.length) { return; }
-    [self.particleBuffer didModifyRange:NSMakeRange(offset, stride)];
+    return [renderer renderParticleSystem:self blendMode:blendMode viewportSize:viewportSize];
 }
 
 - (void)markAllStatesDirty {
     if (!self.particleBuffer) { return; }
-    NSUInteger stride = self.stateStride;
-    NSUInteger length = stride * self.capacity;
-    length = MIN(length, self.particleBuffer.length);
+    NSUInteger length = MIN((NSUInteger)SSKParticleCoreStorageSize((uint32_t)self.capacity), self.particleBuffer.length);
     if (length == 0) { return; }
     [self.particleBuffer didModifyRange:NSMakeRange(0, length)];
 }
@@ -187,12 +187,22 @@
     }
 }
 
+/// Writes `value` unless the store already holds it. Continuous sliders fire
+/// for every pixel of a drag and checkbox clicks re-send the same state, and
+/// each real write wakes every running instance to re-read its preferences.
+- (BOOL)storeValue:(id)value forKey:(NSString *)key {
+    if ([[self.defaults objectForKey:key] isEqual:value]) { return NO; }
+    [self.defaults setObject:value forKey:key];
+    return YES;
+}
+
 - (void)updatePreferenceForBinding:(SSKPreferenceBinding *)binding {
     if (!binding.control) { return; }
+    BOOL stored = NO;
     switch (binding.kind) {
         case SSKPreferenceControlKindSlider: {
             double value = [(NSSlider *)binding.control doubleValue];
-            [self.defaults setDouble:value forKey:binding.key];
+            stored = [self storeValue:@(value) forKey:binding.key];
             if (binding.valueLabel) {
                 binding.valueLabel.stringValue = [NSString stringWithFormat:binding.format ?: @"%.0f", value];
             }
@@ -200,7 +210,7 @@
         }
         case SSKPreferenceControlKindCheckbox: {
             BOOL state = ([(NSButton *)binding.control state] == NSControlStateValueOn);
-            [self.defaults setBool:state forKey:binding.key];
+            stored = [self storeValue:@(state) forKey:binding.key];
             break;
         }
         case SSKPreferenceControlKindColorWell: {
@@ -217,7 +227,7 @@
                 #pragma clang diagnostic pop
             }
             if (data) {
-                [self.defaults setObject:data forKey:binding.key];
+                stored = [self storeValue:data forKey:binding.key];
             }
             break;
         }
@@ -231,12 +241,14 @@
                 value = selected.title;
             }
             if (value) {
-                [self.defaults setObject:value forKey:binding.key];
+                stored = [self storeValue:value forKey:binding.key];
             }
             break;
         }
     }
-    [self.defaults synchronize];
+    if (stored) {
+        [self.defaults synchronize];
+    }
 }
 
 @end
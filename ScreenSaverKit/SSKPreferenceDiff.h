@@ -0,0 +1,13 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Keys whose values differ between two preference snapshots, including keys
+/// present in only one of them; empty when they match. A nil `previous` counts
+/// as empty, so every key of `current` is returned. The comparison is the
+/// portable `SSKKeyDiffRun` (Core/SSKKeyDiff.h), with `isEqual:` as its
+/// value equality.
+FOUNDATION_EXPORT NSSet<NSString *> *SSKPreferenceChangedKeys(NSDictionary<NSString *, id> * _Nullable previous,
+                                                              NSDictionary<NSString *, id> *current);
+
+NS_ASSUME_NONNULL_END
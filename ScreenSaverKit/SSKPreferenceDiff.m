@@ -0,0 +1,67 @@
+#import "SSKPreferenceDiff.h"
+
+#import "Core/SSKKeyDiff.h"
+
+typedef struct {
+    __unsafe_unretained NSDictionary<NSString *, id> *previous;
+    __unsafe_unretained NSDictionary<NSString *, id> *current;
+    __unsafe_unretained NSMutableSet<NSString *> *changed;
+    /// Filled on demand for the removal pass.
+    __unsafe_unretained id *previousKeys;
+} SSKPreferenceDiffContext;
+
+static const void *SSKPreferenceDiffPreviousValue(void *context, const void *key) {
+    SSKPreferenceDiffContext *diff = context;
+    return (__bridge const void *)diff->previous[(__bridge NSString *)key];
+}
+
+static bool SSKPreferenceDiffCurrentContains(void *context, const void *key) {
+    SSKPreferenceDiffContext *diff = context;
+    return diff->current[(__bridge NSString *)key] != nil;
+}
+
+static bool SSKPreferenceDiffEqual(void *context, const void *a, const void *b) {
+    (void)context;
+    return [(__bridge id)a isEqual:(__bridge id)b];
+}
+
+static const void *const *SSKPreferenceDiffPreviousKeys(void *context) {
+    SSKPreferenceDiffContext *diff = context;
+    NSUInteger count = diff->previous.count;
+    diff->previousKeys = (__unsafe_unretained id *)calloc(count, sizeof(id));
+    if (!diff->previousKeys) { return NULL; }
+    [diff->previous getObjects:NULL andKeys:diff->previousKeys count:count];
+    return (const void *const *)diff->previousKeys;
+}
+
+static void SSKPreferenceDiffChanged(void *context, const void *key) {
+    SSKPreferenceDiffContext *diff = context;
+    [diff->changed addObject:(__bridge NSString *)key];
+}
+
+NSSet<NSString *> *SSKPreferenceChangedKeys(NSDictionary<NSString *, id> *previous,
+                                            NSDictionary<NSString *, id> *current) {
+    if (previous == current) { return [NSSet set]; }
+    if (previous.count == 0) { return [NSSet setWithArray:current.allKeys]; }
+
+    NSUInteger count = current.count;
+    __unsafe_unretained id *keys = (__unsafe_unretained id *)calloc(count * 2 + 1, sizeof(id));
+    if (!keys) { return [NSSet setWithArray:current.allKeys]; }
+    __unsafe_unretained id *values = keys + count;
+    [current getObjects:values andKeys:keys count:count];
+
+    NSMutableSet<NSString *> *changed = [NSMutableSet set];
+    SSKPreferenceDiffContext context = {previous, current, changed, NULL};
+    static const SSKKeyDiffCallbacks callbacks = {
+        SSKPreferenceDiffPreviousValue,
+        SSKPreferenceDiffCurrentContains,
+        SSKPreferenceDiffEqual,
+        SSKPreferenceDiffPreviousKeys,
+        SSKPreferenceDiffChanged,
+    };
+    SSKKeyDiffRun((const void *const *)keys, (const void *const *)values, (uint32_t)count,
+                  (uint32_t)previous.count, &callbacks, &context);
+    free(context.previousKeys);
+    free(keys);
+    return changed;
+}
@@ -0,0 +1,88 @@
+#import <Foundation/Foundation.h>
+
+#import "Core/SSKPreferenceSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A saver's preference keys, declared once with their type, default and range.
+
+ Each `add…` call appends a key and returns its index, which is how the view
+ reads it back from `-[SSKScreenSaverView preferenceSnapshot]`. Declare keys
+ in the order of an enum so the indices are compile-time constants:
+
+ ```
+ enum { MyPrefSpeed, MyPrefTrails };
+
+ - (SSKPreferenceSchema *)preferenceSchema {
+     SSKPreferenceSchema *schema = [SSKPreferenceSchema new];
+     [schema addDoubleKey:@"speed" defaultValue:1.0 minimum:0.1 maximum:4.0];
+     [schema addBoolKey:@"trails" defaultValue:YES];
+     return schema;
+ }
+
+ // Per frame: no dictionary lookups, no unboxing, no clamping.
+ double speed = SSKPreferenceSnapshotDouble(self.preferenceSnapshot, MyPrefSpeed);
+ ```
+
+ Stored values are validated once, when they are ingested: numbers are
+ clamped to the range, integers rounded, missing or mistyped values replaced
+ by the default. A schema holds at most `SSKPreferenceSnapshotMaxKeys` keys and
+ should not change after the view has asked for it.
+ */
+@interface SSKPreferenceSchema : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;
+
+/// Every key at its default, suitable for `-defaultPreferences`. Choice keys
+/// hold their choice string.
+@property (nonatomic, readonly, copy) NSDictionary<NSString *, id> *defaultPreferences;
+
+- (NSUInteger)addBoolKey:(NSString *)key defaultValue:(BOOL)value;
+
+- (NSUInteger)addIntegerKey:(NSString *)key
+               defaultValue:(NSInteger)value
+                    minimum:(NSInteger)minimum
+                    maximum:(NSInteger)maximum;
+
+- (NSUInteger)addDoubleKey:(NSString *)key
+              defaultValue:(double)value
+                   minimum:(double)minimum
+                   maximum:(double)maximum;
+
+/// A string from `choices`, stored in the snapshot as its index. Stored
+/// strings not in the list fall back to the default.
+- (NSUInteger)addChoiceKey:(NSString *)key
+              defaultValue:(NSString *)value
+                   choices:(NSArray<NSString *> *)choices;
+
+/// Any other property-list value (a colour archive, a palette name). The
+/// snapshot only tracks whether it changed; read it with
+/// `-[SSKScreenSaverView preferenceObjectAtIndex:]`.
+- (NSUInteger)addObjectKey:(NSString *)key defaultValue:(id)value;
+
+- (NSString *)keyAtIndex:(NSUInteger)index;
+
+/// `NSNotFound` for keys the schema does not declare.
+- (NSUInteger)indexOfKey:(NSString *)key;
+
+/// The choices of a choice key; nil for other keys.
+- (nullable NSArray<NSString *> *)choicesAtIndex:(NSUInteger)index;
+
+/// Fills `snapshot` with every key at its default, all dirty, and `objects`
+/// with the object keys' defaults (`NSNull` for the other keys).
+- (void)initializeSnapshot:(SSKPreferenceSnapshot *)snapshot objects:(NSMutableArray *)objects;
+
+/// Validates the values of `changedKeys` (every declared key when nil) from
+/// `preferences` into `snapshot` and `objects` as one ingest batch. Keys the
+/// schema does not declare are ignored. Returns the snapshot's dirty bits:
+/// every declared key in `changedKeys`, or with nil, the keys whose validated
+/// value changed.
+- (uint64_t)ingestPreferences:(NSDictionary<NSString *, id> *)preferences
+                  changedKeys:(nullable NSSet<NSString *> *)changedKeys
+                 intoSnapshot:(SSKPreferenceSnapshot *)snapshot
+                      objects:(NSMutableArray *)objects;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,193 @@
+#import "SSKPreferenceSchema.h"
+
+#import "SSKDiagnostics.h"
+
+@implementation SSKPreferenceSchema {
+    /// Specs and defaults; copied into each view's snapshot.
+    SSKPreferenceSnapshot _template;
+    NSMutableArray<NSString *> *_keys;
+    NSMutableDictionary<NSString *, NSNumber *> *_indexByKey;
+    NSMutableDictionary<NSNumber *, NSArray<NSString *> *> *_choicesByIndex;
+    NSMutableArray *_defaultObjects;
+    NSMutableDictionary<NSString *, id> *_defaultPreferences;
+}
+
+- (instancetype)init {
+    if ((self = [super init])) {
+        SSKPreferenceSnapshotInit(&_template);
+        _keys = [NSMutableArray array];
+        _indexByKey = [NSMutableDictionary dictionary];
+        _choicesByIndex = [NSMutableDictionary dictionary];
+        _defaultObjects = [NSMutableArray array];
+        _defaultPreferences = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return _keys.count;
+}
+
+- (NSDictionary<NSString *,id> *)defaultPreferences {
+    return [_defaultPreferences copy];
+}
+
+- (NSUInteger)ssk_addKey:(NSString *)key
+                    spec:(SSKPreferenceKeySpec)spec
+           defaultObject:(id)defaultObject {
+    NSParameterAssert(key.length > 0);
+    NSParameterAssert(defaultObject);
+    if (_indexByKey[key]) {
+        [SSKDiagnostics log:@"SSKPreferenceSchema: %@ declared twice", key];
+        return _indexByKey[key].unsignedIntegerValue;
+    }
+    int32_t index = SSKPreferenceSnapshotAddKey(&_template, &spec);
+    if (index < 0) {
+        [SSKDiagnostics log:@"SSKPreferenceSchema: no room for %@ (at most %d keys)", key, SSKPreferenceSnapshotMaxKeys];
+        return NSNotFound;
+    }
+    [_keys addObject:key];
+    _indexByKey[key] = @(index);
+    [_defaultObjects addObject:spec.type == SSKPreferenceTypeObject ? defaultObject : [NSNull null]];
+    _defaultPreferences[key] = defaultObject;
+    return (NSUInteger)index;
+}
+
+- (NSUInteger)addBoolKey:(NSString *)key defaultValue:(BOOL)value {
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeBool, value ? 1.0 : 0.0, 0.0, 1.0};
+    return [self ssk_addKey:key spec:spec defaultObject:@(value)];
+}
+
+- (NSUInteger)addIntegerKey:(NSString *)key
+               defaultValue:(NSInteger)value
+                    minimum:(NSInteger)minimum
+                    maximum:(NSInteger)maximum {
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeInteger, (double)value, (double)minimum, (double)maximum};
+    NSUInteger index = [self ssk_addKey:key spec:spec defaultObject:@(value)];
+    [self ssk_storeClampedDefaultAtIndex:index];
+    return index;
+}
+
+- (NSUInteger)addDoubleKey:(NSString *)key
+              defaultValue:(double)value
+                   minimum:(double)minimum
+                   maximum:(double)maximum {
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeDouble, value, minimum, maximum};
+    NSUInteger index = [self ssk_addKey:key spec:spec defaultObject:@(value)];
+    [self ssk_storeClampedDefaultAtIndex:index];
+    return index;
+}
+
+- (NSUInteger)addChoiceKey:(NSString *)key
+              defaultValue:(NSString *)value
+                   choices:(NSArray<NSString *> *)choices {
+    NSParameterAssert(choices.count > 0);
+    NSUInteger defaultIndex = [choices indexOfObject:value];
+    if (defaultIndex == NSNotFound) {
+        defaultIndex = 0;
+        value = choices.firstObject;
+    }
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeChoice, (double)defaultIndex, 0.0, (double)choices.count - 1.0};
+    NSUInteger index = [self ssk_addKey:key spec:spec defaultObject:value];
+    if (index != NSNotFound) {
+        _choicesByIndex[@(index)] = [choices copy];
+    }
+    return index;
+}
+
+- (NSUInteger)addObjectKey:(NSString *)key defaultValue:(id)value {
+    SSKPreferenceKeySpec spec = {SSKPreferenceTypeObject, 0.0, 0.0, 0.0};
+    return [self ssk_addKey:key spec:spec defaultObject:value];
+}
+
+/// Registered defaults should already be in range so the stored value and
+/// the snapshot agree.
+- (void)ssk_storeClampedDefaultAtIndex:(NSUInteger)index {
+    if (index == NSNotFound) { return; }
+    const SSKPreferenceKeySpec *spec = &_template.specs[index];
+    _defaultPreferences[_keys[index]] = spec->type == SSKPreferenceTypeInteger
+        ? @((NSInteger)spec->defaultValue)
+        : @(spec->defaultValue);
+}
+
+- (NSString *)keyAtIndex:(NSUInteger)index {
+    return _keys[index];
+}
+
+- (NSUInteger)indexOfKey:(NSString *)key {
+    NSNumber *index = key ? _indexByKey[key] : nil;
+    return index ? index.unsignedIntegerValue : NSNotFound;
+}
+
+- (NSArray<NSString *> *)choicesAtIndex:(NSUInteger)index {
+    return _choicesByIndex[@(index)];
+}
+
+- (void)initializeSnapshot:(SSKPreferenceSnapshot *)snapshot objects:(NSMutableArray *)objects {
+    *snapshot = _template;
+    [objects setArray:_defaultObjects];
+}
+
+- (uint64_t)ingestPreferences:(NSDictionary<NSString *,id> *)preferences
+                  changedKeys:(NSSet<NSString *> *)changedKeys
+                 intoSnapshot:(SSKPreferenceSnapshot *)snapshot
+                      objects:(NSMutableArray *)objects {
+    SSKPreferenceSnapshotBeginIngest(snapshot);
+    if (changedKeys) {
+        for (NSString *key in changedKeys) {
+            NSNumber *index = _indexByKey[key];
+            if (index) {
+                [self ssk_ingestValue:preferences[key] atIndex:index.unsignedIntValue snapshot:snapshot objects:objects];
+                // Listed keys are reported even when validation leaves the
+                // value as it was, matching `changedKeys`.
+                SSKPreferenceSnapshotMarkDirty(snapshot, index.unsignedIntValue);
+            }
+        }
+    } else {
+        for (uint32_t index = 0; index < (uint32_t)_keys.count; index++) {
+            [self ssk_ingestValue:preferences[_keys[index]] atIndex:index snapshot:snapshot objects:objects];
+        }
+    }
+    return SSKPreferenceSnapshotEndIngest(snapshot);
+}
+
+- (void)ssk_ingestValue:(id)value
+                atIndex:(uint32_t)index
+               snapshot:(SSKPreferenceSnapshot *)snapshot
+                objects:(NSMutableArray *)objects {
+    switch (snapshot->specs[index].type) {
+        case SSKPreferenceTypeBool:
+            if ([value respondsToSelector:@selector(boolValue)]) {
+                SSKPreferenceSnapshotSet(snapshot, index, [value boolValue] ? 1.0 : 0.0);
+                return;
+            }
+            break;
+        case SSKPreferenceTypeInteger:
+        case SSKPreferenceTypeDouble:
+            if ([value respondsToSelector:@selector(doubleValue)]) {
+                SSKPreferenceSnapshotSet(snapshot, index, [value doubleValue]);
+                return;
+            }
+            break;
+        case SSKPreferenceTypeChoice:
+            if ([value isKindOfClass:[NSString class]]) {
+                NSUInteger choice = [_choicesByIndex[@(index)] indexOfObject:value];
+                if (choice != NSNotFound) {
+                    SSKPreferenceSnapshotSet(snapshot, index, (double)choice);
+                    return;
+                }
+            }
+            break;
+        case SSKPreferenceTypeObject: {
+            id object = value ?: _defaultObjects[index];
+            if (![objects[index] isEqual:object]) {
+                objects[index] = object;
+                SSKPreferenceSnapshotMarkDirty(snapshot, index);
+            }
+            return;
+        }
+    }
+    SSKPreferenceSnapshotSetDefault(snapshot, index);
+}
+
+@end
@@ -0,0 +1,51 @@
+#import <Foundation/Foundation.h>
+
+#import "Core/SSKReplay.h"
+
+@class SSKScreenSaverView;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Replays a log written by `-[SSKScreenSaverView startRecordingToURL:seed:]`
+/// against a view without drawing: the view is reseeded, handed the recorded
+/// preferences and stepped through `stepSimulationWithDeltaTime:` with the
+/// deltas its clock produced during the recording. Each frame's step cost and
+/// `simulationChecksum` end up in `trace`, which can be saved and compared
+/// against the trace of another build.
+///
+/// Savers with fixed-timestep clocks are stepped once per pending tick, the
+/// same way `runPendingStepsUsingBlock:` steps them live.
+@interface SSKReplayDriver : NSObject
+
+/// Loads the log at `url`. Returns nil (and logs) if it is missing or not a
+/// replay log.
+- (nullable instancetype)initWithContentsOfURL:(NSURL *)url NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) uint64_t seed;
+/// View size at the time of recording.
+@property (nonatomic, readonly) NSSize viewSize;
+
+/// Creates a preview instance of `viewClass` at `viewSize`, seeded with
+/// `seed` from init on, and replays onto it.
+- (BOOL)replayWithViewClass:(Class)viewClass;
+
+/// Replays onto `view`, which should be freshly created (with `seed` in
+/// `SSK_RANDOM_SEED` if its init draws random numbers) and not animating.
+/// Returns NO if the log turns out to be damaged part way; `trace` then holds
+/// the frames before the damage.
+- (BOOL)replayWithView:(SSKScreenSaverView *)view;
+
+/// Frames of the last replay. Owned by the driver.
+@property (nonatomic, readonly) const SSKReplayTrace *trace NS_RETURNS_INNER_POINTER;
+
+- (BOOL)writeTraceToURL:(NSURL *)url;
+
+/// Compares `trace` against a trace saved by `writeTraceToURL:`. Returns NO
+/// if that file cannot be read.
+- (BOOL)compareWithTraceAtURL:(NSURL *)url comparison:(SSKReplayComparison *)comparison;
+
+@end
+
+NS_ASSUME_NONNULL_END
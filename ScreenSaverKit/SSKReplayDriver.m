@@ -0,0 +1,146 @@
+#import "SSKReplayDriver.h"
+
+#import <stdlib.h>
+
+#import "Core/SSKProfiler.h"
+#import "SSKDiagnostics.h"
+#import "SSKReplayRecorder.h"
+#import "SSKScreenSaverView.h"
+
+@implementation SSKReplayDriver {
+    NSData *_log;
+    SSKReplayHeader _header;
+    SSKReplayTrace _trace;
+}
+
+- (instancetype)initWithContentsOfURL:(NSURL *)url {
+    if ((self = [super init])) {
+        _log = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:NULL];
+        SSKReplayReader reader;
+        if (!_log || !SSKReplayReaderInit(&reader, _log.bytes, _log.length)) {
+            [SSKDiagnostics log:@"SSKReplayDriver: %@ is not a replay log", url.path];
+            return nil;
+        }
+        _header = reader.header;
+        SSKReplayTraceInit(&_trace);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    SSKReplayTraceDestroy(&_trace);
+}
+
+- (uint64_t)seed {
+    return _header.seed;
+}
+
+- (NSSize)viewSize {
+    return NSMakeSize(_header.viewWidth, _header.viewHeight);
+}
+
+- (const SSKReplayTrace *)trace {
+    return &_trace;
+}
+
+- (BOOL)replayWithViewClass:(Class)viewClass {
+    if (![viewClass isSubclassOfClass:[SSKScreenSaverView class]]) {
+        [SSKDiagnostics log:@"SSKReplayDriver: %@ is not an SSKScreenSaverView", NSStringFromClass(viewClass)];
+        return NO;
+    }
+    // Init draws from `random` too, so it has to see the recorded seed.
+    const char *previousSeed = getenv("SSK_RANDOM_SEED");
+    NSString *savedSeed = previousSeed ? @(previousSeed) : nil;
+    setenv("SSK_RANDOM_SEED", [NSString stringWithFormat:@"%llu", (unsigned long long)_header.seed].UTF8String, 1);
+    NSRect frame = NSMakeRect(0.0, 0.0, _header.viewWidth, _header.viewHeight);
+    SSKScreenSaverView *view = [[viewClass alloc] initWithFrame:frame isPreview:YES];
+    if (savedSeed) {
+        setenv("SSK_RANDOM_SEED", savedSeed.UTF8String, 1);
+    } else {
+        unsetenv("SSK_RANDOM_SEED");
+    }
+    return view ? [self replayWithView:view] : NO;
+}
+
+- (BOOL)replayWithView:(SSKScreenSaverView *)view {
+    SSKReplayTraceDestroy(&_trace);
+    SSKReplayTraceInit(&_trace);
+
+    SSKReplayReader reader;
+    SSKReplayReaderInit(&reader, _log.bytes, _log.length);
+    [view reseedRandomWithSeed:_header.seed];
+
+    SSKAnimationClock *animationClock = view.animationClock;
+    NSMutableDictionary<NSString *, id> *preferences = [NSMutableDictionary dictionary];
+    SSKReplayEvent event;
+    while (SSKReplayReaderNext(&reader, &event)) {
+        switch (event.type) {
+            case SSKReplayEventClockReset:
+                [animationClock resetWithTimestamp:event.timestamp];
+                animationClock.paused = NO;
+                break;
+            case SSKReplayEventPreferences: {
+                NSData *payload = [NSData dataWithBytesNoCopy:(void *)event.payload
+                                                       length:event.payloadLength
+                                                 freeWhenDone:NO];
+                NSSet<NSString *> *changed = [SSKReplayRecorder applyPayload:payload toPreferences:preferences];
+                if (!changed) {
+                    [SSKDiagnostics log:@"SSKReplayDriver: malformed preferences after frame %u", _trace.count];
+                    return NO;
+                }
+                [view deliverPreferences:[preferences copy] changedKeys:changed];
+                break;
+            }
+            case SSKReplayEventFrame: {
+                SSKReplayFrame frame = { 0, 0, 0 };
+                uint64_t start = SSKProfilerNow();
+                NSTimeInterval dt = [animationClock stepWithTimestamp:event.timestamp];
+                if (animationClock.isFixedTimestepEnabled) {
+                    __block uint32_t steps = 0;
+                    [animationClock runPendingStepsUsingBlock:^(NSTimeInterval stepDelta) {
+                        [view stepSimulationWithDeltaTime:stepDelta];
+                        steps++;
+                    }];
+                    frame.steps = steps;
+                } else {
+                    [view stepSimulationWithDeltaTime:dt];
+                    frame.steps = 1;
+                }
+                frame.costNs = SSKProfilerNow() - start;
+                frame.checksum = view.simulationChecksum;
+                if (!SSKReplayTraceAppend(&_trace, &frame)) {
+                    return NO;
+                }
+                break;
+            }
+        }
+    }
+    if (reader.failed) {
+        [SSKDiagnostics log:@"SSKReplayDriver: log is damaged after frame %u", _trace.count];
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL)writeTraceToURL:(NSURL *)url {
+    FILE *file = fopen(url.fileSystemRepresentation, "w");
+    if (!file) { return NO; }
+    BOOL ok = SSKReplayTraceWrite(&_trace, file);
+    return (fclose(file) == 0) && ok;
+}
+
+- (BOOL)compareWithTraceAtURL:(NSURL *)url comparison:(SSKReplayComparison *)comparison {
+    FILE *file = fopen(url.fileSystemRepresentation, "r");
+    if (!file) { return NO; }
+    SSKReplayTrace baseline;
+    SSKReplayTraceInit(&baseline);
+    BOOL ok = SSKReplayTraceRead(&baseline, file);
+    fclose(file);
+    if (ok && comparison) {
+        *comparison = SSKReplayTraceCompare(&baseline, &_trace);
+    }
+    SSKReplayTraceDestroy(&baseline);
+    return ok;
+}
+
+@end
@@ -0,0 +1,44 @@
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Writes a replay log (see `Core/SSKReplay.h`) for one saver run. Normally
+/// driven by `SSKScreenSaverView` via `startRecordingToURL:seed:`; exposed so
+/// tools can build logs by hand.
+@interface SSKReplayRecorder : NSObject
+
+/// Creates the file at `url` and writes the header. Returns nil (and logs) if
+/// the file cannot be created.
+- (nullable instancetype)initWithURL:(NSURL *)url seed:(uint64_t)seed viewSize:(NSSize)viewSize NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) NSURL *URL;
+@property (nonatomic, readonly) uint64_t seed;
+@property (nonatomic, readonly) NSUInteger frameCount;
+
+- (void)recordClockResetAtTimestamp:(NSTimeInterval)timestamp;
+- (void)recordFrameAtTimestamp:(NSTimeInterval)timestamp;
+
+/// Logs the values of `changedKeys` in `preferences`; keys missing from
+/// `preferences` are logged as removed.
+- (void)recordPreferences:(NSDictionary<NSString *, id> *)preferences
+              changedKeys:(NSSet<NSString *> *)changedKeys;
+
+/// Flushes and closes the file. Returns NO if any write failed. Later records
+/// are ignored.
+- (BOOL)close;
+
+/// Encoding of a preference event: a binary property list of the changed
+/// values and the removed keys.
++ (nullable NSData *)payloadForPreferences:(NSDictionary<NSString *, id> *)preferences
+                               changedKeys:(NSSet<NSString *> *)changedKeys;
+
+/// Applies a payload from `payloadForPreferences:changedKeys:` to
+/// `preferences` and returns the keys it touched, or nil if it is malformed.
++ (nullable NSSet<NSString *> *)applyPayload:(NSData *)payload
+                               toPreferences:(NSMutableDictionary<NSString *, id> *)preferences;
+
+@end
+
+NS_ASSUME_NONNULL_END
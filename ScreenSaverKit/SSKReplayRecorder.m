@@ -0,0 +1,115 @@
+#import "SSKReplayRecorder.h"
+
+#import "Core/SSKReplay.h"
+#import "SSKDiagnostics.h"
+
+static NSString * const kSSKReplayValuesKey = @"values";
+static NSString * const kSSKReplayRemovedKey = @"removed";
+
+@implementation SSKReplayRecorder {
+    FILE *_file;
+    SSKReplayWriter *_writer;
+}
+
+- (instancetype)initWithURL:(NSURL *)url seed:(uint64_t)seed viewSize:(NSSize)viewSize {
+    if ((self = [super init])) {
+        _URL = [url copy];
+        _seed = seed;
+        _file = fopen(url.fileSystemRepresentation, "wb");
+        if (!_file) {
+            [SSKDiagnostics log:@"SSKReplayRecorder: cannot create %@", url.path];
+            return nil;
+        }
+        SSKReplayHeader header = { seed, viewSize.width, viewSize.height };
+        _writer = SSKReplayWriterCreate(_file, &header);
+        if (!_writer) {
+            [SSKDiagnostics log:@"SSKReplayRecorder: cannot write header to %@", url.path];
+            fclose(_file);
+            _file = NULL;
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (NSUInteger)frameCount {
+    return _writer ? (NSUInteger)SSKReplayWriterFrameCount(_writer) : 0;
+}
+
+- (void)recordClockResetAtTimestamp:(NSTimeInterval)timestamp {
+    if (!_writer) { return; }
+    SSKReplayWriterClockReset(_writer, timestamp);
+}
+
+- (void)recordFrameAtTimestamp:(NSTimeInterval)timestamp {
+    if (!_writer) { return; }
+    SSKReplayWriterFrame(_writer, timestamp);
+}
+
+- (void)recordPreferences:(NSDictionary<NSString *, id> *)preferences
+              changedKeys:(NSSet<NSString *> *)changedKeys {
+    if (!_writer || changedKeys.count == 0) { return; }
+    NSData *payload = [SSKReplayRecorder payloadForPreferences:preferences changedKeys:changedKeys];
+    if (!payload || payload.length > UINT32_MAX) {
+        [SSKDiagnostics log:@"SSKReplayRecorder: preferences are not property-list values; replay will diverge."];
+        return;
+    }
+    SSKReplayWriterPreferences(_writer, payload.bytes, (uint32_t)payload.length);
+}
+
+- (BOOL)close {
+    if (!_writer) { return YES; }
+    BOOL ok = SSKReplayWriterDestroy(_writer);
+    _writer = NULL;
+    if (fclose(_file) != 0) {
+        ok = NO;
+    }
+    _file = NULL;
+    if (!ok) {
+        [SSKDiagnostics log:@"SSKReplayRecorder: failed writing %@", self.URL.path];
+    }
+    return ok;
+}
+
++ (NSData *)payloadForPreferences:(NSDictionary<NSString *, id> *)preferences
+                      changedKeys:(NSSet<NSString *> *)changedKeys {
+    NSMutableDictionary<NSString *, id> *values = [NSMutableDictionary dictionaryWithCapacity:changedKeys.count];
+    NSMutableArray<NSString *> *removed = [NSMutableArray array];
+    for (NSString *key in changedKeys) {
+        id value = preferences[key];
+        if (value) {
+            values[key] = value;
+        } else {
+            [removed addObject:key];
+        }
+    }
+    NSDictionary *plist = @{ kSSKReplayValuesKey : values, kSSKReplayRemovedKey : removed };
+    return [NSPropertyListSerialization dataWithPropertyList:plist
+                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                     options:0
+                                                       error:NULL];
+}
+
++ (NSSet<NSString *> *)applyPayload:(NSData *)payload
+                      toPreferences:(NSMutableDictionary<NSString *, id> *)preferences {
+    id plist = [NSPropertyListSerialization propertyListWithData:payload options:0 format:NULL error:NULL];
+    if (![plist isKindOfClass:[NSDictionary class]]) { return nil; }
+    NSDictionary *values = plist[kSSKReplayValuesKey];
+    NSArray *removed = plist[kSSKReplayRemovedKey];
+    if (![values isKindOfClass:[NSDictionary class]] || ![removed isKindOfClass:[NSArray class]]) { return nil; }
+
+    NSMutableSet<NSString *> *changed = [NSMutableSet setWithArray:values.allKeys];
+    [preferences addEntriesFromDictionary:values];
+    for (NSString *key in removed) {
+        if (![key isKindOfClass:[NSString class]]) { return nil; }
+        [preferences removeObjectForKey:key];
+        [changed addObject:key];
+    }
+    return changed;
+}
+
+@end
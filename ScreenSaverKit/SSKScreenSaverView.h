@@ -2,25 +2,37 @@
 #import "SSKAssetManager.h"
 #import "SSKAnimationClock.h"
 #import "SSKEntityPool.h"
+#import "SSKPreferenceSchema.h"
+#import "Core/SSKPreferenceSnapshot.h"
+#import "Core/SSKRandom.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 /**
  ScreenSaverKit base view that folds common macOS ScreenSaver boilerplate into a
- single subclass. It registers defaults, polls for preference changes, exposes
+ single subclass. It registers defaults, watches for preference changes, exposes
  helper utilities, and handles host lifecycle differences (preview, wallpaper,
  ScreenSaverEngine).
 
  ## Lifecycle highlights
- - Preferences are registered from `-defaultPreferences` during init.
+ - Preferences are registered from `-defaultPreferences` during init. Savers
+   that declare a `-preferenceSchema` instead get validated, typed values in
+   `preferenceSnapshot`, with a dirty bit per key that changed.
  - `-preferencesDidChange:changedKeys:` is called immediately after init with
    all keys (initial `changedKeys` contains every registered key) and thereafter
-   only when a value actually differs. Preferences are polled every 0.5s on the
-   main run loop, so no custom observers are required.
+   only when a value actually differs. Changes are picked up on the main run
+   loop as soon as a defaults-change notification arrives (from this view's
+   `preferences`, or from another saver instance via
+   `notifyPreferencesChanged`); writers that post nothing are caught by a poll
+   that backs off from 2 s to a minute while nothing changes. No custom
+   observers are required.
  - Animation helpers (`advanceAnimationClock`, `deltaTime`) are paused/resumed
    automatically when the saver starts and stops animating.
  - Entity pools created via `makeEntityPoolWithCapacity:factory:` are owned by
    the saver and drained when the view is deallocated.
+ - Randomness should come from `random`/`randomUnit`, which are seeded once per
+   view. Together with `stepSimulationWithDeltaTime:` this lets a run be
+   recorded (`startRecordingToURL:seed:`) and replayed with `SSKReplayDriver`.
 
  The class assumes you interact with it on the main thread, matching AppKit’s
  drawing model. Preference helpers, timers, and utilities are not thread-safe.
@@ -60,8 +72,23 @@ NS_ASSUME_NONNULL_BEGIN
 + (NSString *)preferencesDomain;
 
 /// Register default key/value pairs here. Called once during init before any reads.
+/// The default returns the schema's defaults, or an empty dictionary.
 - (NSDictionary<NSString *, id> *)defaultPreferences;
 
+/// Declares typed preference keys (see `SSKPreferenceSchema`). Called once,
+/// early in init, so it must not depend on the subclass's own state. The
+/// default is nil.
+- (nullable SSKPreferenceSchema *)preferenceSchema;
+
+/// Validated values of the schema's keys, indexed in declaration order.
+/// Updated before each `preferencesDidChange:changedKeys:` call, whose dirty
+/// bits name the keys that call is about. Safe to read every frame; the
+/// pointer stays valid for the life of the view. Empty without a schema.
+@property (nonatomic, readonly) const SSKPreferenceSnapshot *preferenceSnapshot NS_RETURNS_INNER_POINTER;
+
+/// Current value of an object key of the schema.
+- (nullable id)preferenceObjectAtIndex:(NSUInteger)index;
+
 /// Called whenever persisted preferences change (including initial load).
 /// `changedKeys` contains the keys whose values differ from the previous call.
 /// - First invocation happens immediately after init and includes all registered keys.
@@ -70,7 +97,8 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)preferencesDidChange:(NSDictionary<NSString *, id> *)preferences
                  changedKeys:(NSSet<NSString *> *)changedKeys;
 
-/// Returns the current ScreenSaverDefaults for this module.
+/// Returns the current ScreenSaverDefaults for this module; the same instance
+/// for the life of the view, so writes through it are seen immediately.
 /// Caller is responsible for any subsequent `synchronize` calls after modifying values.
 - (ScreenSaverDefaults *)preferences;
 
@@ -79,12 +107,24 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSDictionary<NSString *, id> *)currentPreferences;
 
 /// Persist a value to ScreenSaverDefaults and synchronise immediately. Values are written on the
-/// main thread and become visible to other processes via the polling cycle.
+/// main thread, and instances in other processes are told to re-read them.
 - (void)setPreferenceValue:(nullable id)value forKey:(NSString *)key;
 
 /// Removes the stored value for a key and synchronises immediately.
 - (void)removePreferenceForKey:(NSString *)key;
 
+/// Tells running instances of this saver, in any process, that its preferences
+/// changed. The setters here call it; call it after writing to `preferences`
+/// directly.
+- (void)notifyPreferencesChanged;
+
+/// Hands `preferences` to the view as if they had just been read from the
+/// defaults: updates `preferenceSnapshot`, logs them to a recording in progress
+/// and calls `preferencesDidChange:changedKeys:`. Replays use it to drive a
+/// view without touching the stored preferences.
+- (void)deliverPreferences:(NSDictionary<NSString *, id> *)preferences
+               changedKeys:(NSSet<NSString *> *)changedKeys;
+
 /// Resets preferences to the registered defaults and immediately invokes
 /// `preferencesDidChange:changedKeys:` with all keys.
 - (void)resetPreferencesToDefaults;
@@ -103,6 +143,62 @@ NS_ASSUME_NONNULL_BEGIN
 - (SSKEntityPool *)makeEntityPoolWithCapacity:(NSUInteger)capacity
                                       factory:(SSKEntityFactoryBlock)factory;
 
+#pragma mark - Deterministic simulation
+
+/// Seed of `random`. Chosen before the first `preferencesDidChange:changedKeys:`
+/// call: `SSK_RANDOM_SEED` from the environment (decimal or 0x hex) when set,
+/// otherwise a fresh random value.
+@property (nonatomic, readonly) uint64_t randomSeed;
+
+/// The view's random stream. Draw every random number the simulation uses from
+/// here (directly or via the helpers below) so a recorded run replays exactly.
+@property (nonatomic, readonly) SSKRandom *random NS_RETURNS_INNER_POINTER;
+
+/// Restarts `random` from `seed`. Savers that seed generators of their own
+/// from `random` (e.g. `SSKParticleSystem.emissionSeed`) override this, call
+/// super and reseed them; the override also runs during init, before the
+/// subclass has created them.
+- (void)reseedRandomWithSeed:(uint64_t)seed;
+
+/// Uniform value in [0, 1).
+- (double)randomUnit;
+
+/// Uniform value in [`lo`, `hi`).
+- (double)randomValueFrom:(double)lo to:(double)hi;
+
+/// Uniform index in [0, `bound`); 0 when `bound` is 0.
+- (uint32_t)randomIndexBelow:(uint32_t)bound;
+
+/// 64 bits from `random`, for seeding a subsystem with its own generator
+/// (particle emission, star fields).
+- (uint64_t)nextRandomSeed;
+
+/// Advances the simulation by `deltaTime` seconds without drawing anything.
+/// Savers that split their per-frame update out of `animateOneFrame` into this
+/// method can be replayed headlessly. The default does nothing.
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)deltaTime;
+
+/// Hash of the simulation state, compared frame by frame between replays to
+/// find where two builds diverge (see `SSKReplayChecksum`). The default is 0.
+- (uint64_t)simulationChecksum;
+
+#pragma mark - Recording
+
+/// Starts writing a replay log to `url`: reseeds `random` with `seed`,
+/// re-delivers every preference, restarts the animation clock and then logs
+/// each clock read and preference change until `stopRecording` or
+/// `stopAnimation`. A replay starts from a fresh view created with `seed`, so
+/// state from frames run before recording started is not reproduced; setting
+/// `SSK_RECORD_DIRECTORY` in the environment records each animation run from
+/// its first frame into that directory. Returns NO if the file cannot be
+/// created.
+- (BOOL)startRecordingToURL:(NSURL *)url seed:(uint64_t)seed;
+
+/// Closes the current log, if any.
+- (void)stopRecording;
+
+@property (nonatomic, readonly, getter=isRecording) BOOL recording;
+
 @end
 
 NS_ASSUME_NONNULL_END
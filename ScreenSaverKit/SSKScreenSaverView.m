@@ -2,8 +2,22 @@
 
 #import <AppKit/AppKit.h>
 #import <CoreFoundation/CoreFoundation.h>
+#import <stdlib.h>
 
-static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
+#import "Core/SSKChangeMonitor.h"
+#import "SSKDiagnostics.h"
+#import "SSKPreferenceDiff.h"
+#import "SSKReplayRecorder.h"
+
+/// Fallback poll for writers that post nothing (e.g. `defaults write`): 2 s
+/// after a change, backing off to a minute while nothing changes.
+static const NSTimeInterval kSSKPreferencePollMinInterval = 2.0;
+static const NSTimeInterval kSSKPreferencePollMaxInterval = 60.0;
+
+/// Posted to the distributed center, with the preferences domain as object,
+/// whenever a saver writes its preferences, so instances in other processes
+/// (the full-screen saver while System Settings shows the sheet) re-read them.
+static NSString * const kSSKPreferencesDidChangeNotification = @"SSKScreenSaverPreferencesDidChange";
 
 @interface SSKScreenSaverView ()
 @property (nonatomic, strong) NSTimer *ssk_preferenceWatchTimer;
@@ -11,11 +25,36 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
 @property (nonatomic, strong) SSKAssetManager *ssk_assetManager;
 @property (nonatomic, strong) SSKAnimationClock *ssk_animationClock;
 @property (nonatomic, strong) NSMutableArray<SSKEntityPool *> *ssk_ownedPools;
+@property (nonatomic, strong) ScreenSaverDefaults *ssk_defaults;
 @property (nonatomic, strong) id ssk_defaultsObserver;
-- (void)ssk_checkPreferenceChanges:(id)sender;
+@property (nonatomic, strong) id ssk_distributedObserver;
+@property (nonatomic, strong, nullable) SSKReplayRecorder *ssk_recorder;
 @end
 
-@implementation SSKScreenSaverView
+/// `SSK_RANDOM_SEED` when set (strtoull accepts decimal and 0x hex), otherwise
+/// a fresh seed.
+static uint64_t SSKInitialRandomSeed(void) {
+    const char *value = getenv("SSK_RANDOM_SEED");
+    if (value && value[0]) {
+        char *end = NULL;
+        unsigned long long seed = strtoull(value, &end, 0);
+        if (end && *end == '\0') {
+            return (uint64_t)seed;
+        }
+    }
+    uint64_t seed = 0;
+    arc4random_buf(&seed, sizeof seed);
+    return seed;
+}
+
+@implementation SSKScreenSaverView {
+    SSKRandom _random;
+    uint64_t _randomSeed;
+    SSKChangeMonitor _preferenceMonitor;
+    SSKPreferenceSchema *_preferenceSchema;
+    SSKPreferenceSnapshot _preferenceSnapshot;
+    NSMutableArray *_preferenceObjects;
+}
 
 + (NSString *)preferencesDomain {
     static NSString *resolvedDomain = nil;
@@ -79,11 +118,16 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
         _ssk_assetManager = [[SSKAssetManager alloc] initWithBundle:[NSBundle bundleForClass:self.class]];
         _ssk_animationClock = [SSKAnimationClock new];
         _ssk_ownedPools = [NSMutableArray array];
+        [self reseedRandomWithSeed:SSKInitialRandomSeed()];
+        _preferenceSchema = [self preferenceSchema];
+        _preferenceObjects = [NSMutableArray array];
+        SSKPreferenceSnapshotInit(&_preferenceSnapshot);
+        [_preferenceSchema initializeSnapshot:&_preferenceSnapshot objects:_preferenceObjects];
         [self ssk_registerDefaultsIfNeeded];
         NSDictionary *prefs = [self currentPreferences];
         self.ssk_lastKnownPreferences = prefs;
         if (prefs.count > 0) {
-            [self preferencesDidChange:prefs changedKeys:[NSSet setWithArray:prefs.allKeys]];
+            [self deliverPreferences:prefs changedKeys:[NSSet setWithArray:prefs.allKeys]];
         }
     }
     return self;
@@ -91,18 +135,20 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
 
 - (void)dealloc {
     [self ssk_stopPreferenceMonitoring];
+    [self.ssk_recorder close];
     [self.ssk_ownedPools makeObjectsPerformSelector:@selector(drain)];
 }
 
 - (void)startAnimation {
     [super startAnimation];
-    [self.animationClock resetWithTimestamp:[NSDate timeIntervalSinceReferenceDate]];
-    self.animationClock.paused = NO;
+    [self ssk_resetAnimationClock];
     [self ssk_startPreferenceMonitoring];
+    [self ssk_startRecordingFromEnvironmentIfNeeded];
 }
 
 - (void)stopAnimation {
     [self ssk_stopPreferenceMonitoring];
+    [self stopRecording];
     [self.animationClock pause];
     [super stopAnimation];
 }
@@ -119,26 +165,27 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
 
 - (void)ssk_startPreferenceMonitoring {
     if (!self.ssk_defaultsObserver) {
-        ScreenSaverDefaults *defaults = [self preferences];
         __weak typeof(self) weakSelf = self;
+        void (^preferencesMayHaveChanged)(NSNotification *) = ^(NSNotification *note) {
+            (void)note;
+            [weakSelf ssk_preferencesMayHaveChanged];
+        };
+        // Only this view's defaults: the configuration sheet writes through
+        // them, and other writers post the distributed notification below,
+        // which this process receives too.
         self.ssk_defaultsObserver = [[NSNotificationCenter defaultCenter] addObserverForName:NSUserDefaultsDidChangeNotification
-                                                                                      object:defaults
+                                                                                      object:[self preferences]
                                                                                        queue:[NSOperationQueue mainQueue]
-                                                                                  usingBlock:^(NSNotification *note) {
-            (void)note;
-            [weakSelf ssk_checkPreferenceChanges:nil];
-        }];
+                                                                                  usingBlock:preferencesMayHaveChanged];
+        self.ssk_distributedObserver = [[NSDistributedNotificationCenter defaultCenter] addObserverForName:kSSKPreferencesDidChangeNotification
+                                                                                                    object:self.class.preferencesDomain
+                                                                                                     queue:[NSOperationQueue mainQueue]
+                                                                                                usingBlock:preferencesMayHaveChanged];
     }
-    if (!self.ssk_preferenceWatchTimer) {
-        NSTimer *timer = [NSTimer timerWithTimeInterval:kSSKPreferencePollInterval
-                                                 target:self
-                                               selector:@selector(ssk_checkPreferenceChanges:)
-                                               userInfo:nil
-                                                repeats:YES];
-        self.ssk_preferenceWatchTimer = timer;
-        [[NSRunLoop currentRunLoop] addTimer:timer forMode:NSRunLoopCommonModes];
-    }
-    [self ssk_checkPreferenceChanges:nil];
+    SSKChangeMonitorParams params = {kSSKPreferencePollMinInterval, kSSKPreferencePollMaxInterval, 2.0};
+    SSKChangeMonitorInit(&_preferenceMonitor, &params, [NSDate timeIntervalSinceReferenceDate]);
+    [self ssk_checkPreferenceChanges];
+    [self ssk_schedulePreferencePoll];
 }
 
 - (void)ssk_stopPreferenceMonitoring {
@@ -146,50 +193,107 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
         [[NSNotificationCenter defaultCenter] removeObserver:self.ssk_defaultsObserver];
         self.ssk_defaultsObserver = nil;
     }
+    if (self.ssk_distributedObserver) {
+        [[NSDistributedNotificationCenter defaultCenter] removeObserver:self.ssk_distributedObserver];
+        self.ssk_distributedObserver = nil;
+    }
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(ssk_pollPreferences:) object:nil];
     [self.ssk_preferenceWatchTimer invalidate];
     self.ssk_preferenceWatchTimer = nil;
 }
 
-- (void)ssk_checkPreferenceChanges:(id)sender {
-    NSDictionary *current = [self currentPreferences];
-    if (!self.ssk_lastKnownPreferences) {
-        self.ssk_lastKnownPreferences = current;
-        [self preferencesDidChange:current changedKeys:[NSSet setWithArray:current.allKeys]];
-        return;
+/// Notifications arrive in bursts (one per key written); the check runs once
+/// on the next run loop pass.
+- (void)ssk_preferencesMayHaveChanged {
+    if (!self.ssk_defaultsObserver) { return; }
+    SSKChangeMonitorNotify(&_preferenceMonitor);
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(ssk_pollPreferences:) object:nil];
+    [self performSelector:@selector(ssk_pollPreferences:) withObject:nil afterDelay:0.0 inModes:@[NSRunLoopCommonModes]];
+}
+
+- (void)ssk_pollPreferences:(id)sender {
+    (void)sender;
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    if (SSKChangeMonitorIsCheckDue(&_preferenceMonitor, now)) {
+        SSKChangeMonitorDidCheck(&_preferenceMonitor, now, [self ssk_checkPreferenceChanges]);
     }
-    
-    if ([current isEqualToDictionary:self.ssk_lastKnownPreferences]) {
-        return;
+    [self ssk_schedulePreferencePoll];
+}
+
+- (void)ssk_schedulePreferencePoll {
+    [self.ssk_preferenceWatchTimer invalidate];
+    self.ssk_preferenceWatchTimer = nil;
+    if (!self.ssk_defaultsObserver) { return; }
+    NSTimeInterval delay = SSKChangeMonitorDelay(&_preferenceMonitor, [NSDate timeIntervalSinceReferenceDate]);
+    NSTimer *timer = [NSTimer timerWithTimeInterval:delay
+                                             target:self
+                                           selector:@selector(ssk_pollPreferences:)
+                                           userInfo:nil
+                                            repeats:NO];
+    // Polls are housekeeping; let the system batch the wake-up.
+    timer.tolerance = delay * 0.1;
+    self.ssk_preferenceWatchTimer = timer;
+    [[NSRunLoop currentRunLoop] addTimer:timer forMode:NSRunLoopCommonModes];
+}
+
+/// Re-reads the preferences and delivers what changed. Returns whether
+/// anything did.
+- (BOOL)ssk_checkPreferenceChanges {
+    NSDictionary *current = [self currentPreferences];
+    NSDictionary *previous = self.ssk_lastKnownPreferences;
+    NSSet<NSString *> *changed = SSKPreferenceChangedKeys(previous, current);
+    if (previous && changed.count == 0) {
+        return NO;
     }
-    
-    NSMutableSet *changed = [NSMutableSet set];
-    [current enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
-        (void)stop;
-        id previous = self.ssk_lastKnownPreferences[key];
-        if ((obj && ![obj isEqual:previous]) || (previous && ![previous isEqual:obj])) {
-            [changed addObject:key];
-        }
-    }];
-    
-    // Include keys that were removed.
-    [self.ssk_lastKnownPreferences enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
-        (void)obj;
-        (void)stop;
-        if (!current[key]) {
-            [changed addObject:key];
-        }
-    }];
-    
     self.ssk_lastKnownPreferences = current;
-    [self preferencesDidChange:current changedKeys:changed];
+    [self deliverPreferences:current changedKeys:changed];
+    return YES;
+}
+
+- (void)notifyPreferencesChanged {
+    NSString *domain = self.class.preferencesDomain;
+    if (!domain.length) { return; }
+    [[NSDistributedNotificationCenter defaultCenter] postNotificationName:kSSKPreferencesDidChangeNotification
+                                                                   object:domain
+                                                                 userInfo:nil
+                                                       deliverImmediately:YES];
+}
+
+/// Every change the base class hands to `preferencesDidChange:changedKeys:`
+/// goes through here so the snapshot is current and a recording sees it.
+- (void)deliverPreferences:(NSDictionary<NSString *, id> *)preferences
+               changedKeys:(NSSet<NSString *> *)changedKeys {
+    [_preferenceSchema ingestPreferences:preferences
+                             changedKeys:changedKeys
+                            intoSnapshot:&_preferenceSnapshot
+                                 objects:_preferenceObjects];
+    [self.ssk_recorder recordPreferences:preferences changedKeys:changedKeys];
+    [self preferencesDidChange:preferences changedKeys:changedKeys];
 }
 
 - (ScreenSaverDefaults *)preferences {
-    return [ScreenSaverDefaults defaultsForModuleWithName:self.class.preferencesDomain];
+    if (!self.ssk_defaults) {
+        self.ssk_defaults = [ScreenSaverDefaults defaultsForModuleWithName:self.class.preferencesDomain];
+    }
+    return self.ssk_defaults;
 }
 
 - (NSDictionary<NSString *,id> *)defaultPreferences {
-    return @{};
+    return _preferenceSchema.defaultPreferences ?: @{};
+}
+
+- (SSKPreferenceSchema *)preferenceSchema {
+    return nil;
+}
+
+- (const SSKPreferenceSnapshot *)preferenceSnapshot {
+    return &_preferenceSnapshot;
+}
+
+- (id)preferenceObjectAtIndex:(NSUInteger)index {
+    if (index >= _preferenceObjects.count) { return nil; }
+    id object = _preferenceObjects[index];
+    return object == [NSNull null] ? nil : object;
 }
 
 - (NSDictionary<NSString *,id> *)currentPreferences {
@@ -224,6 +328,7 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
         [prefs removeObjectForKey:key];
     }
     [prefs synchronize];
+    [self notifyPreferencesChanged];
 }
 
 - (void)removePreferenceForKey:(NSString *)key {
@@ -231,6 +336,7 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
     ScreenSaverDefaults *prefs = [self preferences];
     [prefs removeObjectForKey:key];
     [prefs synchronize];
+    [self notifyPreferencesChanged];
 }
 
 - (void)resetPreferencesToDefaults {
@@ -242,7 +348,8 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
     [self ssk_registerDefaultsIfNeeded];
     NSDictionary *current = [self currentPreferences];
     self.ssk_lastKnownPreferences = current;
-    [self preferencesDidChange:current changedKeys:[NSSet setWithArray:current.allKeys]];
+    [self deliverPreferences:current changedKeys:[NSSet setWithArray:current.allKeys]];
+    [self notifyPreferencesChanged];
 }
 
 - (SSKAssetManager *)assetManager {
@@ -254,7 +361,16 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
 }
 
 - (NSTimeInterval)advanceAnimationClock {
-    return [self.animationClock stepWithTimestamp:[NSDate timeIntervalSinceReferenceDate]];
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    [self.ssk_recorder recordFrameAtTimestamp:now];
+    return [self.animationClock stepWithTimestamp:now];
+}
+
+- (void)ssk_resetAnimationClock {
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    [self.ssk_recorder recordClockResetAtTimestamp:now];
+    [self.animationClock resetWithTimestamp:now];
+    self.animationClock.paused = NO;
 }
 
 - (NSTimeInterval)deltaTime {
@@ -267,4 +383,88 @@ static const NSTimeInterval kSSKPreferencePollInterval = 2.0;
     return pool;
 }
 
+#pragma mark - Deterministic simulation
+
+- (uint64_t)randomSeed {
+    return _randomSeed;
+}
+
+- (SSKRandom *)random {
+    return &_random;
+}
+
+- (void)reseedRandomWithSeed:(uint64_t)seed {
+    _randomSeed = seed;
+    _random = SSKRandomMake(seed);
+}
+
+- (double)randomUnit {
+    // 53 bits: all a double's mantissa holds.
+    uint64_t bits = [self nextRandomSeed] >> 11;
+    return (double)bits * (1.0 / 9007199254740992.0);
+}
+
+- (double)randomValueFrom:(double)lo to:(double)hi {
+    return lo + (hi - lo) * [self randomUnit];
+}
+
+- (uint32_t)randomIndexBelow:(uint32_t)bound {
+    return (uint32_t)(((uint64_t)SSKRandomNext(&_random) * bound) >> 32);
+}
+
+- (uint64_t)nextRandomSeed {
+    uint64_t high = SSKRandomNext(&_random);
+    return (high << 32) | SSKRandomNext(&_random);
+}
+
+- (void)stepSimulationWithDeltaTime:(NSTimeInterval)deltaTime {
+    (void)deltaTime;
+}
+
+- (uint64_t)simulationChecksum {
+    return 0;
+}
+
+#pragma mark - Recording
+
+- (BOOL)isRecording {
+    return self.ssk_recorder != nil;
+}
+
+- (BOOL)startRecordingToURL:(NSURL *)url seed:(uint64_t)seed {
+    [self stopRecording];
+    SSKReplayRecorder *recorder = [[SSKReplayRecorder alloc] initWithURL:url seed:seed viewSize:self.bounds.size];
+    if (!recorder) { return NO; }
+    self.ssk_recorder = recorder;
+
+    // Replays start from the same place: seed, full preference set, clock.
+    [self reseedRandomWithSeed:seed];
+    NSDictionary *current = [self currentPreferences];
+    self.ssk_lastKnownPreferences = current;
+    [self deliverPreferences:current changedKeys:[NSSet setWithArray:current.allKeys]];
+    [self ssk_resetAnimationClock];
+    return YES;
+}
+
+- (void)stopRecording {
+    SSKReplayRecorder *recorder = self.ssk_recorder;
+    if (!recorder) { return; }
+    self.ssk_recorder = nil;
+    if ([recorder close]) {
+        [SSKDiagnostics log:@"%@: recorded %lu frames to %@",
+         NSStringFromClass(self.class), (unsigned long)recorder.frameCount, recorder.URL.path];
+    }
+}
+
+- (void)ssk_startRecordingFromEnvironmentIfNeeded {
+    const char *directory = getenv("SSK_RECORD_DIRECTORY");
+    if (!directory || !directory[0] || self.ssk_recorder) { return; }
+    NSString *name = [NSString stringWithFormat:@"%@-%.0f-%p.sskreplay",
+                      NSStringFromClass(self.class), [NSDate timeIntervalSinceReferenceDate], (__bridge void *)self];
+    NSURL *url = [[NSURL fileURLWithPath:@(directory) isDirectory:YES] URLByAppendingPathComponent:name];
+    // The init seed: a replay creates its view with it, so state built during
+    // init matches too.
+    [self startRecordingToURL:url seed:self.randomSeed];
+}
+
 @end
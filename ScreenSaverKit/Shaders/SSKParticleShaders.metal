@@ -6,6 +6,7 @@ struct InstanceData {
     float2 direction;
     float width;
     float length;
+    float2 reserved;
     float4 color;
     float softness;
 };
@@ -57,6 +58,51 @@ fragment float4 particleFragment(ParticleVertexOut in [[stage_in]]) {
     return float4(in.color.rgb, alpha);
 }
 
+// --- Trail strips ---
+
+// Matches SSKTrailVertex in Core/SSKTrail.h.
+struct TrailVertex {
+    float2 position;
+    float edge;
+    float halfWidth;
+    float4 color;
+};
+
+struct TrailVertexOut {
+    float4 position [[position]];
+    float4 color;
+    float edge;
+    float halfWidth;
+};
+
+vertex TrailVertexOut trailVertex(uint vertexID [[vertex_id]],
+                                  const device TrailVertex *vertices [[buffer(0)]],
+                                  constant float2 &viewport [[buffer(1)]]) {
+    TrailVertex data = vertices[vertexID];
+    float2 clip = float2((data.position.x / viewport.x) * 2.0 - 1.0,
+                         (data.position.y / viewport.y) * 2.0 - 1.0);
+    clip.y = -clip.y;
+    TrailVertexOut out;
+    out.position = float4(clip, 0.0, 1.0);
+    out.color = data.color;
+    out.edge = data.edge;
+    out.halfWidth = data.halfWidth;
+    return out;
+}
+
+// Fades the strip across its visible edge over `softness` points, or over one
+// pixel (measured with the screen-space derivative of the interpolated
+// distance) when that is wider. Returns premultiplied colour;
+// SSKTrailRasterize is the CPU twin.
+fragment float4 trailFragment(TrailVertexOut in [[stage_in]],
+                              constant float &softness [[buffer(0)]]) {
+    float pixel = length(float2(dfdx(in.edge), dfdy(in.edge)));
+    float ramp = max(max(pixel, softness), 0.0001);
+    float coverage = saturate((in.halfWidth - abs(in.edge)) / ramp + 0.5);
+    float alpha = in.color.a * coverage;
+    return float4(in.color.rgb * alpha, alpha);
+}
+
 // --- Gaussian blur compute kernels ---
 
 #define SSK_MAX_BLUR_RADIUS 32u
@@ -113,6 +159,13 @@ static inline float bloomLuminance(float3 color) {
     return dot(color, float3(0.2126f, 0.7152f, 0.0722f));
 }
 
+static inline float4 bloomPrefilter(float4 color, float threshold) {
+    float lum = bloomLuminance(color.rgb);
+    float bloomFactor = max(lum - threshold, 0.0f);
+    float scale = bloomFactor > 0.0f ? bloomFactor / max(lum, 0.0001f) : 0.0f;
+    return float4(color.rgb * scale, bloomFactor);
+}
+
 kernel void bloomThresholdKernel(texture2d<float, access::sample> source [[texture(0)]],
                                  texture2d<float, access::write> bright [[texture(1)]],
                                  constant float &threshold [[buffer(0)]],
@@ -122,11 +175,7 @@ kernel void bloomThresholdKernel(texture2d<float, access::sample> source [[textu
     }
     constexpr sampler s(address::clamp_to_edge, filter::nearest);
     float4 srcColor = source.sample(s, (float2(gid) + 0.5f) / float2(source.get_width(), source.get_height()));
-    float lum = bloomLuminance(srcColor.rgb);
-    float bloomFactor = max(lum - threshold, 0.0f);
-    float scale = bloomFactor > 0.0f ? bloomFactor / max(lum, 0.0001f) : 0.0f;
-    float3 bloomColor = srcColor.rgb * scale;
-    bright.write(float4(bloomColor, bloomFactor), gid);
+    bright.write(bloomPrefilter(srcColor, threshold), gid);
 }
 
 kernel void bloomCompositeKernel(texture2d<float, access::sample> bloomTex [[texture(0)]],
@@ -145,3 +194,466 @@ kernel void bloomCompositeKernel(texture2d<float, access::sample> bloomTex [[tex
     }
     destination.write(dest, gid);
 }
+
+// --- Dual Kawase mip-chain bloom ---
+// Each level is a half-resolution texture. The bilinear taps average 4 texels
+// apiece, so a handful of samples per pixel doubles the glow radius per level.
+// SSKBlur.c mirrors these kernels for headless validation.
+
+static inline float4 bloomKawaseUpsampleAt(texture2d<float, access::sample> source, float2 uv) {
+    constexpr sampler s(address::clamp_to_edge, filter::linear);
+    float2 texel = 1.0f / float2(source.get_width(), source.get_height());
+    float4 sum = source.sample(s, uv + float2(-texel.x, 0.0f));
+    sum += source.sample(s, uv + float2(texel.x, 0.0f));
+    sum += source.sample(s, uv + float2(0.0f, -texel.y));
+    sum += source.sample(s, uv + float2(0.0f, texel.y));
+    sum += source.sample(s, uv + float2(-0.5f, -0.5f) * texel) * 2.0f;
+    sum += source.sample(s, uv + float2(0.5f, -0.5f) * texel) * 2.0f;
+    sum += source.sample(s, uv + float2(-0.5f, 0.5f) * texel) * 2.0f;
+    sum += source.sample(s, uv + float2(0.5f, 0.5f) * texel) * 2.0f;
+    return sum / 12.0f;
+}
+
+// A threshold below zero skips the bright pass (every level after the first).
+kernel void bloomKawaseDownsample(texture2d<float, access::sample> source [[texture(0)]],
+                                  texture2d<float, access::write> destination [[texture(1)]],
+                                  constant float &threshold [[buffer(0)]],
+                                  uint2 gid [[thread_position_in_grid]]) {
+    if (gid.x >= destination.get_width() || gid.y >= destination.get_height()) {
+        return;
+    }
+    constexpr sampler s(address::clamp_to_edge, filter::linear);
+    float2 uv = (float2(gid) + 0.5f) / float2(destination.get_width(), destination.get_height());
+    float2 texel = 1.0f / float2(source.get_width(), source.get_height());
+    float4 taps[5] = {
+        source.sample(s, uv),
+        source.sample(s, uv + float2(-1.0f, -1.0f) * texel),
+        source.sample(s, uv + float2(1.0f, -1.0f) * texel),
+        source.sample(s, uv + float2(-1.0f, 1.0f) * texel),
+        source.sample(s, uv + float2(1.0f, 1.0f) * texel),
+    };
+    if (threshold >= 0.0f) {
+        for (uint i = 0u; i < 5u; ++i) {
+            taps[i] = bloomPrefilter(taps[i], threshold);
+        }
+    }
+    float4 sum = taps[0] * 4.0f + taps[1] + taps[2] + taps[3] + taps[4];
+    destination.write(sum * 0.125f, gid);
+}
+
+kernel void bloomKawaseUpsample(texture2d<float, access::sample> source [[texture(0)]],
+                                texture2d<float, access::write> destination [[texture(1)]],
+                                uint2 gid [[thread_position_in_grid]]) {
+    if (gid.x >= destination.get_width() || gid.y >= destination.get_height()) {
+        return;
+    }
+    float2 uv = (float2(gid) + 0.5f) / float2(destination.get_width(), destination.get_height());
+    destination.write(bloomKawaseUpsampleAt(source, uv), gid);
+}
+
+kernel void bloomKawaseComposite(texture2d<float, access::sample> source [[texture(0)]],
+                                 texture2d<float, access::read_write> destination [[texture(1)]],
+                                 constant float &intensity [[buffer(0)]],
+                                 uint2 gid [[thread_position_in_grid]]) {
+    if (gid.x >= destination.get_width() || gid.y >= destination.get_height()) {
+        return;
+    }
+    float2 uv = (float2(gid) + 0.5f) / float2(destination.get_width(), destination.get_height());
+    float4 bloom = bloomKawaseUpsampleAt(source, uv);
+    float4 dest = destination.read(gid);
+    float glow = bloom.a * intensity;
+    if (glow > 0.0001f) {
+        dest.rgb = clamp(dest.rgb + bloom.rgb * glow, float3(0.0f), float3(1.0f));
+    }
+    destination.write(dest, gid);
+}
+
+// --- Particle simulation kernels ---
+// Built into the metallib with the rest, so a particle system only creates
+// pipelines at start-up. The step kernels are specialised with the function
+// constants below and cached process-wide by `SSKMetalShaderLibrary`.
+
+struct SimulationUniforms {
+    float2 gravity;
+    float dt;
+    float globalDamping;
+    uint capacity;
+    uint fieldCount;
+    float time;
+};
+
+// `SSKParticleCoreBehaviorFadeAlpha` and `SSKParticleCoreBehaviorFadeSize`.
+constant uint kBehaviorFadeAlpha = 1u;
+constant uint kBehaviorFadeSize  = 2u;
+
+// Step specialisations, one per `SSKParticleKernelFeature` bit in
+// Core/SSKParticleKernelVariant.h. A variant with a feature off compiles that
+// work out entirely; the host only picks it while nothing needs the feature.
+constant bool kStepFadeAlpha [[function_constant(0)]];
+constant bool kStepFadeSize [[function_constant(1)]];
+constant bool kStepGravity [[function_constant(2)]];
+constant bool kStepDamping [[function_constant(3)]];
+
+// Mirrors Core/SSKForceField.c; keep the two in sync.
+struct ForceField {
+    uint type;
+    float strength;
+    float radius;
+    float frequency;
+    float2 center;
+    float2 extent;
+};
+
+constant uint kFieldPoint = 0u;
+constant uint kFieldVortex = 1u;
+constant uint kFieldCurlNoise = 2u;
+constant uint kFieldDrag = 3u;
+constant uint kFieldBounds = 4u;
+
+static float fieldLattice(int x, int y) {
+    uint h = uint(x) * 0x8da6b343u ^ uint(y) * 0xd8163841u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return float(h >> 8) * (2.0f / 16777215.0f) - 1.0f;
+}
+
+static float2 noiseGradient(float2 q) {
+    float2 f = floor(q);
+    int2 i = int2(f);
+    float2 t = q - f;
+    float2 u = t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    float2 du = 30.0f * t * t * (t * (t - 2.0f) + 1.0f);
+    float a = fieldLattice(i.x, i.y);
+    float b = fieldLattice(i.x + 1, i.y);
+    float c = fieldLattice(i.x, i.y + 1);
+    float d = fieldLattice(i.x + 1, i.y + 1);
+    float k = a - b - c + d;
+    return float2(du.x * ((b - a) + k * u.y), du.y * ((c - a) + k * u.x));
+}
+
+static float2 applyField(constant ForceField &field, float2 p, float2 v, float time, float dt) {
+    if (field.type == kFieldPoint || field.type == kFieldVortex) {
+        float2 d = field.center - p;
+        float distance = length(d);
+        float inverse = distance > 1e-4f ? 1.0f / distance : 0.0f;
+        float inverseRadius = field.radius > 0.0f ? 1.0f / field.radius : 0.0f;
+        float falloff = max(0.0f, 1.0f - distance * inverseRadius);
+        float2 direction = field.type == kFieldVortex ? float2(d.y, -d.x) : d;
+        return v + direction * (field.strength * dt * falloff * inverse);
+    }
+    if (field.type == kFieldCurlNoise) {
+        float2 g = noiseGradient((p - field.center * time) * field.frequency);
+        return v + float2(g.y, -g.x) * (0.5f * field.strength) * dt;
+    }
+    if (field.type == kFieldDrag && all(abs(p - field.center) <= field.extent)) {
+        return v * pow(max(0.0f, 1.0f - field.strength), dt);
+    }
+    return v;
+}
+
+static void bounceAxis(thread float &p, thread float &v, float low, float high, float restitution) {
+    if (p < low) {
+        p = low;
+        if (v < 0.0f) { v = -v * restitution; }
+    } else if (p > high) {
+        p = high;
+        if (v > 0.0f) { v = -v * restitution; }
+    }
+}
+
+// Stream parameters shared by every kernel that touches particles, bound at
+// their `SSKParticleStream` indices.
+#define STREAM_PARAMETERS \
+    device float2 *position [[buffer(0)]], \
+    device float2 *velocity [[buffer(1)]], \
+    device float2 *userVector [[buffer(2)]], \
+    device float2 *sizeRange [[buffer(3)]], \
+    device float4 *color [[buffer(4)]], \
+    device float4 *baseColor [[buffer(5)]], \
+    device float *life [[buffer(6)]], \
+    device float *maxLife [[buffer(7)]], \
+    device float *size [[buffer(8)]], \
+    device float *baseSize [[buffer(9)]], \
+    device float *sizeVelocity [[buffer(10)]], \
+    device float *rotation [[buffer(11)]], \
+    device float *rotationVelocity [[buffer(12)]], \
+    device float *damping [[buffer(13)]], \
+    device uint *behaviorFlags [[buffer(14)]], \
+    device uint *alive [[buffer(15)]]
+#define STREAMS {position, velocity, userVector, sizeRange, color, baseColor, life, maxLife, size, baseSize, \
+    sizeVelocity, rotation, rotationVelocity, damping, behaviorFlags, alive}
+struct Streams {
+    device float2 *position;
+    device float2 *velocity;
+    device float2 *userVector;
+    device float2 *sizeRange;
+    device float4 *color;
+    device float4 *baseColor;
+    device float *life;
+    device float *maxLife;
+    device float *size;
+    device float *baseSize;
+    device float *sizeVelocity;
+    device float *rotation;
+    device float *rotationVelocity;
+    device float *damping;
+    device uint *behaviorFlags;
+    device uint *alive;
+};
+
+// Steps one live slot. Returns false, with its flag cleared, when it expired.
+static bool stepParticle(Streams s, uint id, constant SimulationUniforms &uniforms, constant ForceField *fields) {
+    float dt = uniforms.dt;
+    float age = s.life[id] + dt;
+    s.life[id] = age;
+    if (age >= s.maxLife[id]) {
+        s.alive[id] = 0u;
+        return false;
+    }
+    float2 v = s.velocity[id];
+    for (uint f = 0u; f < uniforms.fieldCount; f++) {
+        v = applyField(fields[f], s.position[id], v, uniforms.time, dt);
+    }
+    if (kStepGravity && any(uniforms.gravity)) {
+        v += uniforms.gravity * dt;
+    }
+    if (kStepDamping) {
+        float damp = max(0.0f, s.damping[id] + uniforms.globalDamping);
+        if (damp > 0.0f) {
+            v *= pow(max(0.0f, 1.0f - damp), dt);
+        }
+    }
+    s.velocity[id] = v;
+    s.position[id] += v * dt;
+    s.rotation[id] += s.rotationVelocity[id] * dt;
+    float sizeValue = s.size[id];
+    if (fabs(s.sizeVelocity[id]) > 0.0001f) {
+        sizeValue = max(0.0f, sizeValue + s.sizeVelocity[id] * dt);
+    }
+    uint flags = s.behaviorFlags[id];
+    float normalized = (s.maxLife[id] > 0.0f) ? clamp(age / s.maxLife[id], 0.0f, 1.0f) : 0.0f;
+    if (kStepFadeAlpha && (flags & kBehaviorFadeAlpha) != 0u) {
+        float4 base = s.baseColor[id];
+        s.color[id] = float4(base.rgb, base.a * (1.0f - normalized));
+    }
+    if (kStepFadeSize && (flags & kBehaviorFadeSize) != 0u) {
+        float2 range = s.sizeRange[id];
+        sizeValue = max(0.0f, s.baseSize[id] * mix(range.x, range.y, normalized));
+    }
+    s.size[id] = sizeValue;
+    float velLenSq = length_squared(v);
+    if (velLenSq > 0.0001f) {
+        s.userVector[id] = v * rsqrt(velLenSq);
+    }
+    for (uint f = 0u; f < uniforms.fieldCount; f++) {
+        constant ForceField &field = fields[f];
+        if (field.type != kFieldBounds) { continue; }
+        float2 p = s.position[id];
+        float2 low = field.center - field.extent;
+        float2 high = field.center + field.extent;
+        float restitution = max(0.0f, field.strength);
+        bounceAxis(p.x, v.x, low.x, high.x, restitution);
+        bounceAxis(p.y, v.y, low.y, high.y, restitution);
+        s.position[id] = p;
+        s.velocity[id] = v;
+    }
+    return true;
+}
+
+kernel void simulateParticles(STREAM_PARAMETERS,
+                              constant SimulationUniforms &uniforms [[buffer(16)]],
+                              device atomic_uint *deadCount [[buffer(17)]],
+                              device uint *deadSlots [[buffer(18)]],
+                              constant ForceField *fields [[buffer(19)]],
+                              uint id [[thread_position_in_grid]]) {
+    if (id >= uniforms.capacity || alive[id] == 0u) { return; }
+    Streams streams = STREAMS;
+    if (!stepParticle(streams, id, uniforms, fields)) {
+        deadSlots[atomic_fetch_add_explicit(deadCount, 1u, memory_order_relaxed)] = id;
+    }
+}
+
+// GPU-resident lifecycle; Core/SSKParticleLifecycle.c mirrors these kernels
+// thread by thread, keep the two in sync.
+struct LifecycleState {
+    atomic_uint freeCount;
+    atomic_uint aliveCount[2];
+    uint padding0;
+    uint dispatchArgs[3];
+    uint padding1;
+    uint drawArgs[4];
+};
+
+struct LifecycleParams {
+    uint count;
+    uint list;
+    uint seedLow;
+    uint seedHigh;
+};
+
+// Same layout as `SSKParticleEmitter`.
+struct Emitter {
+    float2 origin;
+    float2 originJitter;
+    float2 radius;
+    float2 angle;
+    float2 speed;
+    float2 baseVelocity;
+    float2 maxLife;
+    float2 size;
+    float2 sizeVelocity;
+    float2 sizeOverLife;
+    float2 rotation;
+    float2 rotationVelocity;
+    float damping;
+    float4 colorStart;
+    float4 colorEnd;
+    float userScalar;
+    uint behaviorFlags;
+};
+
+// `SSKParticleLifecycleThreadgroupWidth` and `SSKParticleInstanceStyleDefault()`.
+constant uint kLifecycleThreadgroupWidth = 64u;
+constant float kInstanceMinWidth = 1.0f;
+constant float kInstanceLengthScale = 12.0f;
+
+// `SSKRandomMake` and friends, one generator per emit thread.
+struct Random {
+    ulong state;
+};
+
+static Random makeRandom(ulong seed) {
+    ulong z = seed + 0x9E3779B97F4A7C15ul;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ul;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBul;
+    z ^= z >> 31;
+    Random random = { z != 0ul ? z : 0x9E3779B97F4A7C15ul };
+    return random;
+}
+
+static float nextUnit(thread Random &random) {
+    ulong x = random.state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    random.state = x;
+    uint bits = uint((x * 0x2545F4914F6CDD1Dul) >> 32);
+    return float(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+static float nextRange(thread Random &random, float lo, float hi) {
+    return lo + (hi - lo) * nextUnit(random);
+}
+
+static float sampleRange(thread Random &random, float2 range) {
+    return range.x == range.y ? range.x : nextRange(random, range.x, range.y);
+}
+
+kernel void emitParticles(STREAM_PARAMETERS,
+                          constant Emitter &e [[buffer(16)]],
+                          device LifecycleState &state [[buffer(17)]],
+                          device uint *aliveIn [[buffer(18)]],
+                          device const uint *freeSlots [[buffer(21)]],
+                          device float *userScalar [[buffer(23)]],
+                          constant LifecycleParams &params [[buffer(24)]],
+                          uint id [[thread_position_in_grid]]) {
+    uint freeCount = atomic_load_explicit(&state.freeCount, memory_order_relaxed);
+    if (id >= params.count || id >= freeCount) { return; }
+    uint slot = freeSlots[freeCount - 1u - id];
+    aliveIn[atomic_load_explicit(&state.aliveCount[params.list], memory_order_relaxed) + id] = slot;
+    Random random = makeRandom((ulong(params.seedHigh) << 32 | ulong(params.seedLow)) + ulong(id));
+    float angle = sampleRange(random, e.angle);
+    float2 direction = float2(cos(angle), sin(angle));
+    float radius = sampleRange(random, e.radius);
+    float speed = sampleRange(random, e.speed);
+    float2 p = e.origin + direction * radius;
+    if (e.originJitter.x != 0.0f) { p.x += nextRange(random, -e.originJitter.x, e.originJitter.x); }
+    if (e.originJitter.y != 0.0f) { p.y += nextRange(random, -e.originJitter.y, e.originJitter.y); }
+    float2 v = e.baseVelocity + direction * speed;
+    float lengthSquared = length_squared(v);
+    float4 c = e.colorStart;
+    if (any(e.colorStart != e.colorEnd)) {
+        c += (e.colorEnd - e.colorStart) * nextUnit(random);
+    }
+    float sizeValue = sampleRange(random, e.size);
+    position[slot] = p;
+    velocity[slot] = v;
+    userVector[slot] = lengthSquared > 0.0001f ? v * rsqrt(lengthSquared) : float2(0.0f);
+    sizeRange[slot] = e.sizeOverLife;
+    color[slot] = c;
+    baseColor[slot] = c;
+    life[slot] = 0.0f;
+    maxLife[slot] = sampleRange(random, e.maxLife);
+    size[slot] = sizeValue;
+    baseSize[slot] = sizeValue;
+    sizeVelocity[slot] = sampleRange(random, e.sizeVelocity);
+    rotation[slot] = sampleRange(random, e.rotation);
+    rotationVelocity[slot] = sampleRange(random, e.rotationVelocity);
+    damping[slot] = e.damping;
+    behaviorFlags[slot] = e.behaviorFlags;
+    alive[slot] = 1u;
+    userScalar[slot] = e.userScalar;
+}
+
+kernel void commitEmission(device LifecycleState &state [[buffer(17)]],
+                           constant LifecycleParams &params [[buffer(24)]]) {
+    uint freeCount = atomic_load_explicit(&state.freeCount, memory_order_relaxed);
+    uint emitted = min(params.count, freeCount);
+    atomic_store_explicit(&state.freeCount, freeCount - emitted, memory_order_relaxed);
+    atomic_fetch_add_explicit(&state.aliveCount[params.list], emitted, memory_order_relaxed);
+}
+
+kernel void prepareSimulation(device LifecycleState &state [[buffer(17)]],
+                              constant LifecycleParams &params [[buffer(24)]]) {
+    atomic_store_explicit(&state.aliveCount[params.list ^ 1u], 0u, memory_order_relaxed);
+    uint count = atomic_load_explicit(&state.aliveCount[params.list], memory_order_relaxed);
+    state.dispatchArgs[0] = (count + kLifecycleThreadgroupWidth - 1u) / kLifecycleThreadgroupWidth;
+    state.dispatchArgs[1] = 1u;
+    state.dispatchArgs[2] = 1u;
+}
+
+kernel void simulateResidentParticles(STREAM_PARAMETERS,
+                                      constant SimulationUniforms &uniforms [[buffer(16)]],
+                                      device LifecycleState &state [[buffer(17)]],
+                                      device const uint *aliveIn [[buffer(18)]],
+                                      constant ForceField *fields [[buffer(19)]],
+                                      device uint *aliveOut [[buffer(20)]],
+                                      device uint *freeSlots [[buffer(21)]],
+                                      device InstanceData *instances [[buffer(22)]],
+                                      device const float *userScalar [[buffer(23)]],
+                                      constant LifecycleParams &params [[buffer(24)]],
+                                      uint id [[thread_position_in_grid]]) {
+    if (id >= atomic_load_explicit(&state.aliveCount[params.list], memory_order_relaxed)) { return; }
+    uint slot = aliveIn[id];
+    Streams streams = STREAMS;
+    if (!stepParticle(streams, slot, uniforms, fields)) {
+        freeSlots[atomic_fetch_add_explicit(&state.freeCount, 1u, memory_order_relaxed)] = slot;
+        return;
+    }
+    uint index = atomic_fetch_add_explicit(&state.aliveCount[params.list ^ 1u], 1u, memory_order_relaxed);
+    aliveOut[index] = slot;
+    float2 direction = userVector[slot];
+    float directionLength = length(direction);
+    direction = directionLength >= 0.0001f ? direction / directionLength : float2(1.0f, 0.0f);
+    float width = max(kInstanceMinWidth, size[slot]);
+    float softness = userScalar[slot];
+    InstanceData instance;
+    instance.position = position[slot];
+    instance.direction = direction;
+    instance.width = width;
+    instance.length = width * kInstanceLengthScale;
+    instance.reserved = float2(0.0f);
+    instance.color = color[slot];
+    instance.softness = isfinite(softness) && softness > 0.0f ? softness : 0.0f;
+    instances[index] = instance;
+}
+
+kernel void finalizeSimulation(device LifecycleState &state [[buffer(17)]],
+                               constant LifecycleParams &params [[buffer(24)]]) {
+    state.drawArgs[0] = 4u;
+    state.drawArgs[1] = atomic_load_explicit(&state.aliveCount[params.list ^ 1u], memory_order_relaxed);
+    state.drawArgs[2] = 0u;
+    state.drawArgs[3] = 0u;
+}
+
@@ -0,0 +1,99 @@
+// ssk-replay: replays a recorded run against a built saver bundle and reports
+// per-frame step cost and state checksums.
+//
+//   ssk-replay <Saver.saver> <run.sskreplay> [--trace out.txt]
+//              [--baseline trace.txt] [--threshold percent]
+//
+// Exits 1 when the replay diverges from the baseline or its median frame cost
+// rises by more than the threshold (10% by default), 2 on usage or I/O errors.
+// Driver classes come from the bundle itself so the replay runs exactly the
+// kit code the saver ships with.
+
+#import <Cocoa/Cocoa.h>
+
+#import "SSKReplayDriver.h"
+
+static int SSKReplayUsage(void) {
+    fprintf(stderr, "usage: ssk-replay <Saver.saver> <run.sskreplay> [--trace out.txt] "
+                    "[--baseline trace.txt] [--threshold percent]\n");
+    return 2;
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        if (argc < 3) { return SSKReplayUsage(); }
+        NSString *bundlePath = @(argv[1]);
+        NSURL *logURL = [NSURL fileURLWithPath:@(argv[2])];
+        NSURL *traceURL = nil;
+        NSURL *baselineURL = nil;
+        double threshold = 10.0;
+        for (int i = 3; i < argc; i++) {
+            if (i + 1 >= argc) { return SSKReplayUsage(); }
+            if (strcmp(argv[i], "--trace") == 0) {
+                traceURL = [NSURL fileURLWithPath:@(argv[++i])];
+            } else if (strcmp(argv[i], "--baseline") == 0) {
+                baselineURL = [NSURL fileURLWithPath:@(argv[++i])];
+            } else if (strcmp(argv[i], "--threshold") == 0) {
+                threshold = atof(argv[++i]);
+            } else {
+                return SSKReplayUsage();
+            }
+        }
+
+        [NSApplication sharedApplication];
+        NSBundle *bundle = [NSBundle bundleWithPath:bundlePath];
+        if (![bundle load]) {
+            fprintf(stderr, "ssk-replay: cannot load %s\n", argv[1]);
+            return 2;
+        }
+        Class viewClass = bundle.principalClass;
+        Class driverClass = [bundle classNamed:@"SSKReplayDriver"];
+        if (!viewClass || !driverClass) {
+            fprintf(stderr, "ssk-replay: %s is not a ScreenSaverKit saver\n", argv[1]);
+            return 2;
+        }
+
+        SSKReplayDriver *driver = [(SSKReplayDriver *)[driverClass alloc] initWithContentsOfURL:logURL];
+        if (!driver) {
+            fprintf(stderr, "ssk-replay: %s is not a replay log\n", argv[2]);
+            return 2;
+        }
+        BOOL complete = [driver replayWithViewClass:viewClass];
+        const SSKReplayTrace *trace = driver.trace;
+        SSKReplayComparison summary = SSKReplayTraceCompare(trace, trace);
+        printf("%s: %u frames, seed 0x%016llx, step median %.0f ns, p95 %.0f ns\n",
+               NSStringFromClass(viewClass).UTF8String, trace->count, (unsigned long long)driver.seed,
+               summary.currentMedianNs, summary.currentP95Ns);
+        if (!complete) {
+            fprintf(stderr, "ssk-replay: replay stopped early; the log is damaged\n");
+        }
+
+        if (traceURL && ![driver writeTraceToURL:traceURL]) {
+            fprintf(stderr, "ssk-replay: cannot write %s\n", traceURL.fileSystemRepresentation);
+            return 2;
+        }
+
+        int status = complete ? 0 : 2;
+        if (baselineURL) {
+            SSKReplayComparison comparison;
+            if (![driver compareWithTraceAtURL:baselineURL comparison:&comparison]) {
+                fprintf(stderr, "ssk-replay: cannot read %s\n", baselineURL.fileSystemRepresentation);
+                return 2;
+            }
+            if (comparison.firstDivergentFrame != UINT32_MAX) {
+                printf("diverged at frame %u\n", comparison.firstDivergentFrame);
+                status = 1;
+            } else {
+                printf("matches baseline over %u frames\n", comparison.comparedFrames);
+            }
+            printf("step median %.0f -> %.0f ns (%+.1f%%), p95 %.0f -> %.0f ns\n",
+                   comparison.baselineMedianNs, comparison.currentMedianNs, comparison.change,
+                   comparison.baselineP95Ns, comparison.currentP95Ns);
+            if (comparison.change > threshold) {
+                printf("slower than baseline by more than %.1f%%\n", threshold);
+                status = 1;
+            }
+        }
+        return status;
+    }
+}